@@ -8,6 +8,7 @@
 
 #include <future>
 #include <memory>
+#include <set>
 #include <string>
 #include <string_view>
 #include <utility>
@@ -87,8 +88,11 @@ bool PersistentCache::Purge() {
   FML_CHECK(GetWorkerTaskRunner());
 
   std::promise<bool> removed;
-  GetWorkerTaskRunner()->PostTask([&removed,
-                                   cache_directory = cache_directory_]() {
+  GetWorkerTaskRunner()->PostTask([&removed,                            //
+                                   cache_directory = cache_directory_,  //
+                                   cache_pack = cache_pack_,            //
+                                   sksl_cache_pack = sksl_cache_pack_   //
+  ]() {
     if (cache_directory->is_valid()) {
       // Only remove files but not directories.
       FML_LOG(INFO) << "Purge persistent cache.";
@@ -100,7 +104,10 @@ bool PersistentCache::Purge() {
         }
         return fml::UnlinkFile(directory, filename.c_str());
       };
-      removed.set_value(VisitFilesRecursively(*cache_directory, delete_file));
+      bool result = VisitFilesRecursively(*cache_directory, delete_file);
+      cache_pack->Reset();
+      sksl_cache_pack->Reset();
+      removed.set_value(result);
     } else {
       removed.set_value(false);
     }
@@ -112,6 +119,10 @@ namespace {
 
 constexpr char kEngineComponent[] = "flutter_engine";
 
+void MappingReleaseProc(const void* ptr, void* context) {
+  delete reinterpret_cast<fml::Mapping*>(context);
+}
+
 static void FreeOldCacheDirectory(const fml::UniqueFD& cache_base_dir) {
   fml::UniqueFD engine_dir =
       fml::OpenDirectoryReadOnly(cache_base_dir, kEngineComponent);
@@ -223,10 +234,19 @@ size_t PersistentCache::PrecompileKnownSkSLs(GrDirectContext* context) const {
 std::vector<PersistentCache::SkSLCache> PersistentCache::LoadSkSLs() const {
   TRACE_EVENT0("flutter", "PersistentCache::LoadSkSLs");
   std::vector<PersistentCache::SkSLCache> result;
-  fml::FileVisitor visitor = [&result](const fml::UniqueFD& directory,
-                                       const std::string& filename) {
+  // Keys loaded from individual files. A file may be moved into the pack
+  // while it is being visited, in which case it must not be loaded twice.
+  std::set<std::string> file_keys;
+  fml::FileVisitor visitor = [&result, &file_keys](
+                                 const fml::UniqueFD& directory,
+                                 const std::string& filename) {
+    if (ShaderCachePack::IsPackFile(filename)) {
+      return true;
+    }
     SkSLCache cache = LoadFile(directory, filename, true);
     if (cache.key != nullptr && cache.value != nullptr) {
+      file_keys.emplace(static_cast<const char*>(cache.key->data()),
+                        cache.key->size());
       result.push_back(cache);
     } else {
       FML_LOG(ERROR) << "Failed to load: " << filename;
@@ -238,13 +258,27 @@ std::vector<PersistentCache::SkSLCache> PersistentCache::LoadSkSLs() const {
   // However, we'd like to continue visit the asset dir even if this persistent
   // cache is invalid.
   if (IsValid()) {
-    // In case `rewinddir` doesn't work reliably, load SkSLs from a freshly
-    // opened directory (https://github.com/flutter/flutter/issues/65258).
-    fml::UniqueFD fresh_dir =
-        fml::OpenDirectoryReadOnly(*cache_directory_, kSkSLSubdirName);
-    if (fresh_dir.is_valid()) {
-      fml::VisitFiles(fresh_dir, visitor);
+    // Once the individual files have been moved into the pack, loading the
+    // pack requires no file system access at all.
+    if (!sksl_cache_pack_->HasMigratedLegacyFiles()) {
+      // In case `rewinddir` doesn't work reliably, load SkSLs from a freshly
+      // opened directory (https://github.com/flutter/flutter/issues/65258).
+      fml::UniqueFD fresh_dir =
+          fml::OpenDirectoryReadOnly(*cache_directory_, kSkSLSubdirName);
+      if (fresh_dir.is_valid()) {
+        fml::VisitFiles(fresh_dir, visitor);
+      }
     }
+    sksl_cache_pack_->VisitEntries([&result, &file_keys](
+                                       std::string_view key,
+                                       const uint8_t* value,
+                                       size_t value_size) {
+      if (file_keys.count(std::string(key)) > 0) {
+        return;
+      }
+      result.push_back({SkData::MakeWithCopy(key.data(), key.size()),
+                        SkData::MakeWithCopy(value, value_size)});
+    });
   }
 
   std::unique_ptr<fml::Mapping> mapping = nullptr;
@@ -281,7 +315,11 @@ PersistentCache::PersistentCache(bool read_only)
     : is_read_only_(read_only),
       cache_directory_(MakeCacheDirectory(cache_base_path_, read_only, false)),
       sksl_cache_directory_(
-          MakeCacheDirectory(cache_base_path_, read_only, true)) {
+          MakeCacheDirectory(cache_base_path_, read_only, true)),
+      cache_pack_(
+          std::make_shared<ShaderCachePack>(cache_directory_, read_only)),
+      sksl_cache_pack_(
+          std::make_shared<ShaderCachePack>(sksl_cache_directory_, read_only)) {
   if (!IsValid()) {
     FML_LOG(WARNING) << "Could not acquire the persistent cache directory. "
                         "Caching of GPU resources on disk is disabled.";
@@ -304,48 +342,83 @@ PersistentCache::SkSLCache PersistentCache::LoadFile(
     return result;
   }
   auto mapping = std::make_unique<fml::FileMapping>(file);
-  if (mapping->GetSize() < sizeof(CacheObjectHeader)) {
-    return result;
-  }
-  const CacheObjectHeader* header =
-      reinterpret_cast<const CacheObjectHeader*>(mapping->GetMapping());
-  if (header->signature != CacheObjectHeader::kSignature ||
-      header->version != CacheObjectHeader::kVersion1) {
-    FML_LOG(INFO) << "Persistent cache header is corrupt: " << file_name;
-    return result;
-  }
-  if (mapping->GetSize() < sizeof(CacheObjectHeader) + header->key_size) {
-    FML_LOG(INFO) << "Persistent cache size is corrupt: " << file_name;
+  size_t key_offset = 0;
+  size_t key_size = 0;
+  if (!ParseCacheObject(*mapping, &key_offset, &key_size)) {
+    FML_LOG(INFO) << "Persistent cache file is corrupt: " << file_name;
     return result;
   }
   if (need_key) {
-    result.key = SkData::MakeWithCopy(
-        mapping->GetMapping() + sizeof(CacheObjectHeader), header->key_size);
+    result.key =
+        SkData::MakeWithCopy(mapping->GetMapping() + key_offset, key_size);
   }
-  size_t value_offset = sizeof(CacheObjectHeader) + header->key_size;
+  size_t value_offset = key_offset + key_size;
   result.value = SkData::MakeWithCopy(mapping->GetMapping() + value_offset,
                                       mapping->GetSize() - value_offset);
   return result;
 }
 
+bool PersistentCache::ParseCacheObject(const fml::Mapping& mapping,
+                                       size_t* key_offset,
+                                       size_t* key_size) {
+  if (mapping.GetSize() < sizeof(CacheObjectHeader)) {
+    return false;
+  }
+  const CacheObjectHeader* header =
+      reinterpret_cast<const CacheObjectHeader*>(mapping.GetMapping());
+  if (header->signature != CacheObjectHeader::kSignature ||
+      header->version != CacheObjectHeader::kVersion1 ||
+      mapping.GetSize() < sizeof(CacheObjectHeader) + header->key_size) {
+    return false;
+  }
+  *key_offset = sizeof(CacheObjectHeader);
+  *key_size = header->key_size;
+  return true;
+}
+
 // |GrContextOptions::PersistentCache|
 sk_sp<SkData> PersistentCache::load(const SkData& key) {
   TRACE_EVENT0("flutter", "PersistentCacheLoad");
   if (!IsValid()) {
     return nullptr;
   }
-  auto file_name = SkKeyToFilePath(key);
-  if (file_name.empty()) {
+  if (key.data() == nullptr || key.size() == 0) {
     return nullptr;
   }
-  auto result =
-      PersistentCache::LoadFile(*cache_directory_, file_name, false).value;
+  sk_sp<SkData> result;
+  std::unique_ptr<fml::Mapping> value = cache_pack_->Find(
+      std::string_view(static_cast<const char*>(key.data()), key.size()));
+  if (value) {
+    // The value stays in the mapping of the pack file instead of being
+    // copied.
+    fml::Mapping* value_ptr = value.release();
+    result = SkData::MakeWithProc(value_ptr->GetMapping(),
+                                  value_ptr->GetSize(), MappingReleaseProc,
+                                  value_ptr);
+  } else if (!cache_pack_->HasMigratedLegacyFiles()) {
+    result = PersistentCache::LoadFile(*cache_directory_, SkKeyToFilePath(key),
+                                       false)
+                 .value;
+  }
   if (result != nullptr) {
     TRACE_EVENT0("flutter", "PersistentCacheLoadHit");
   }
   return result;
 }
 
+static void RunOnWorker(const fml::RefPtr<fml::TaskRunner>& worker,
+                        const fml::closure& task) {
+  if (!worker) {
+    FML_LOG(WARNING)
+        << "The persistent cache has no available workers. Performing the task "
+           "on the current thread. This slow operation is going to occur on a "
+           "frame workload.";
+    task();
+  } else {
+    worker->PostTask(task);
+  }
+}
+
 static void PersistentCacheStore(
     const fml::RefPtr<fml::TaskRunner>& worker,
     const std::shared_ptr<fml::UniqueFD>& cache_directory,
@@ -365,16 +438,23 @@ static void PersistentCacheStore(
       FML_LOG(WARNING) << "Could not write cache contents to persistent store.";
     }
   });
+  RunOnWorker(worker, task);
+}
 
-  if (!worker) {
-    FML_LOG(WARNING)
-        << "The persistent cache has no available workers. Performing the task "
-           "on the current thread. This slow operation is going to occur on a "
-           "frame workload.";
-    task();
-  } else {
-    worker->PostTask(std::move(task));
-  }
+static void PersistentCachePackStore(
+    const fml::RefPtr<fml::TaskRunner>& worker,
+    const std::shared_ptr<ShaderCachePack>& pack,
+    std::shared_ptr<const fml::Mapping> record) {
+  RunOnWorker(worker, [pack, record = std::move(record)]() {
+    TRACE_EVENT0("flutter", "PersistentCacheStore");
+    if (!pack->Append({record})) {
+      FML_LOG(WARNING) << "Could not write cache contents to persistent store.";
+      return;
+    }
+    if (pack->NeedsCompaction()) {
+      pack->Compact();
+    }
+  });
 }
 
 std::unique_ptr<fml::MallocMapping> PersistentCache::BuildCacheObject(
@@ -409,20 +489,20 @@ void PersistentCache::store(const SkData& key, const SkData& data) {
     return;
   }
 
-  auto file_name = SkKeyToFilePath(key);
-
-  if (file_name.empty()) {
+  if (key.data() == nullptr || key.size() == 0) {
     return;
   }
 
-  std::unique_ptr<fml::MallocMapping> mapping = BuildCacheObject(key, data);
-  if (!mapping) {
+  std::shared_ptr<const fml::Mapping> record = ShaderCachePack::BuildRecord(
+      std::string_view(static_cast<const char*>(key.data()), key.size()),
+      data.bytes(), data.size());
+  if (!record) {
     return;
   }
 
-  PersistentCacheStore(GetWorkerTaskRunner(),
-                       cache_sksl_ ? sksl_cache_directory_ : cache_directory_,
-                       std::move(file_name), std::move(mapping));
+  PersistentCachePackStore(GetWorkerTaskRunner(),
+                           cache_sksl_ ? sksl_cache_pack_ : cache_pack_,
+                           std::move(record));
 }
 
 void PersistentCache::DumpSkp(const SkData& data) {
@@ -447,6 +527,20 @@ void PersistentCache::AddWorkerTaskRunner(
     const fml::RefPtr<fml::TaskRunner>& task_runner) {
   std::scoped_lock lock(worker_task_runners_mutex_);
   worker_task_runners_.insert(task_runner);
+
+  if (legacy_files_migration_scheduled_ || is_read_only_ || !IsValid()) {
+    return;
+  }
+  legacy_files_migration_scheduled_ = true;
+  task_runner->PostTask([cache_pack = cache_pack_,
+                         sksl_cache_pack = sksl_cache_pack_]() {
+    for (const auto& pack : {cache_pack, sksl_cache_pack}) {
+      pack->MigrateLegacyFiles(&PersistentCache::ParseCacheObject);
+      if (pack->NeedsCompaction()) {
+        pack->Compact();
+      }
+    }
+  });
 }
 
 void PersistentCache::RemoveWorkerTaskRunner(
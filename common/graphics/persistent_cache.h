@@ -12,6 +12,7 @@
 #include <set>
 
 #include "flutter/assets/asset_manager.h"
+#include "flutter/common/graphics/shader_cache_pack.h"
 #include "flutter/fml/macros.h"
 #include "flutter/fml/task_runner.h"
 #include "flutter/fml/unique_fd.h"
@@ -85,7 +86,17 @@ class PersistentCache : public GrContextOptions::PersistentCache {
   bool IsDumpingSkp() const { return is_dumping_skp_; }
   void SetIsDumpingSkp(bool value) { is_dumping_skp_ = value; }
 
-  // Remove all files inside the persistent cache directory.
+  // The directory, specific to this engine version, that holds the cache.
+  // Other caches whose contents depend on the engine may be kept there too.
+  // The file descriptor is invalid if the directory could not be opened.
+  const std::shared_ptr<fml::UniqueFD>& GetCacheDirectory() const {
+    return cache_directory_;
+  }
+
+  bool IsReadOnly() const { return is_read_only_; }
+
+  // Remove all files inside the persistent cache directory, including the
+  // shader cache packs.
   // Return whether the purge is successful.
   bool Purge();
 
@@ -155,8 +166,14 @@ class PersistentCache : public GrContextOptions::PersistentCache {
   const bool is_read_only_;
   const std::shared_ptr<fml::UniqueFD> cache_directory_;
   const std::shared_ptr<fml::UniqueFD> sksl_cache_directory_;
+  // Entries are stored in a single pack file per directory. Caches written
+  // by earlier versions as one file per entry are moved into the packs on
+  // the worker task runner once one is available.
+  const std::shared_ptr<ShaderCachePack> cache_pack_;
+  const std::shared_ptr<ShaderCachePack> sksl_cache_pack_;
   mutable std::mutex worker_task_runners_mutex_;
   std::multiset<fml::RefPtr<fml::TaskRunner>> worker_task_runners_;
+  bool legacy_files_migration_scheduled_ = false;
 
   bool stored_new_shaders_ = false;
   bool is_dumping_skp_ = false;
@@ -165,6 +182,12 @@ class PersistentCache : public GrContextOptions::PersistentCache {
                             const std::string& file_name,
                             bool need_key);
 
+  // Locate the key in a cache object built by |BuildCacheObject|. Used to
+  // move cache objects written as individual files into the packs.
+  static bool ParseCacheObject(const fml::Mapping& mapping,
+                               size_t* key_offset,
+                               size_t* key_size);
+
   bool IsValid() const;
 
   explicit PersistentCache(bool read_only = false);
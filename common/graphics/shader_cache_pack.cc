@@ -0,0 +1,495 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/common/graphics/shader_cache_pack.h"
+
+#include <cstring>
+#include <limits>
+#include <utility>
+
+#include "flutter/fml/build_config.h"
+#include "flutter/fml/file.h"
+#include "flutter/fml/logging.h"
+#include "flutter/fml/trace_event.h"
+
+namespace flutter {
+
+namespace {
+
+// A prefix used to identify each record in the pack file.
+constexpr uint32_t kRecordSignature = 0x52504353;
+
+// Records are padded so that every record header is aligned.
+constexpr size_t kRecordAlignment = 4u;
+
+struct PackHeader {
+  uint32_t signature = ShaderCachePack::kSignature;
+  uint32_t version = ShaderCachePack::kVersion1;
+};
+
+struct RecordHeader {
+  uint32_t signature;
+  uint32_t key_size;
+  uint32_t value_size;
+  // FNV-1a hash of the key followed by the value.
+  uint32_t checksum;
+};
+
+uint32_t Checksum(const uint8_t* key,
+                  size_t key_size,
+                  const uint8_t* value,
+                  size_t value_size) {
+  uint32_t hash = 2166136261u;
+  for (size_t i = 0; i < key_size; i++) {
+    hash = (hash ^ key[i]) * 16777619u;
+  }
+  for (size_t i = 0; i < value_size; i++) {
+    hash = (hash ^ value[i]) * 16777619u;
+  }
+  return hash;
+}
+
+uint64_t RecordSize(uint64_t key_size, uint64_t value_size) {
+  uint64_t size = sizeof(RecordHeader) + key_size + value_size;
+  return (size + kRecordAlignment - 1) & ~uint64_t{kRecordAlignment - 1};
+}
+
+// Opens and locks the file that serializes writes to the pack between all
+// of the processes that share the cache directory. The pack file itself
+// cannot be locked, as compaction replaces it with a new file. The lock is
+// released when the returned file is closed.
+fml::UniqueFD LockPackFiles(const fml::UniqueFD& directory) {
+  fml::UniqueFD lock_file =
+      fml::OpenFile(directory, ShaderCachePack::kLockFileName, true,
+                    fml::FilePermission::kReadWrite);
+  if (!lock_file.is_valid() || !fml::AcquireFileLock(lock_file)) {
+    return fml::UniqueFD();
+  }
+  return lock_file;
+}
+
+// Maps the pack file for indexing. Windows cannot truncate, rewrite or
+// delete a file while a view of it is mapped, so there the records are
+// copied out and the view is released before returning.
+std::shared_ptr<const fml::Mapping> MapPackFile(const fml::UniqueFD& file) {
+  if (!file.is_valid()) {
+    return nullptr;
+  }
+  auto mapping = std::make_shared<fml::FileMapping>(file);
+  if (!mapping->IsValid()) {
+    return nullptr;
+  }
+#if FML_OS_WIN
+  return std::make_shared<fml::MallocMapping>(
+      fml::MallocMapping::Copy(mapping->GetMapping(), mapping->GetSize()));
+#else
+  return mapping;
+#endif  // FML_OS_WIN
+}
+
+}  // namespace
+
+ShaderCachePack::ShaderCachePack(std::shared_ptr<fml::UniqueFD> directory,
+                                 bool read_only)
+    : directory_(std::move(directory)), read_only_(read_only) {
+  if (!IsValid()) {
+    return;
+  }
+  TRACE_EVENT0("flutter", "ShaderCachePack::Open");
+  std::shared_ptr<const fml::Mapping> mapping = MapPackFile(fml::OpenFile(
+      *directory_, kFileName, false, fml::FilePermission::kRead));
+  if (mapping) {
+    file_size_ = IndexRecords(mapping, &index_, &replaced_byte_size_);
+  }
+}
+
+ShaderCachePack::~ShaderCachePack() = default;
+
+bool ShaderCachePack::IsPackFile(const std::string& file_name) {
+  // On POSIX, |fml::WriteAtomically| writes to a temporary file next to the
+  // pack and renames it over the pack. On Windows it rewrites the pack in
+  // place.
+  return file_name == kFileName || file_name == kLockFileName ||
+         file_name == std::string(kFileName) + ".temp";
+}
+
+std::shared_ptr<const fml::Mapping> ShaderCachePack::BuildRecord(
+    std::string_view key,
+    const uint8_t* value,
+    size_t value_size) {
+  if (key.size() > std::numeric_limits<uint32_t>::max() ||
+      value_size > std::numeric_limits<uint32_t>::max()) {
+    return nullptr;
+  }
+  size_t record_size = RecordSize(key.size(), value_size);
+  uint8_t* buffer = static_cast<uint8_t*>(calloc(1, record_size));
+  if (buffer == nullptr) {
+    return nullptr;
+  }
+  auto record = std::make_shared<fml::MallocMapping>(buffer, record_size);
+
+  const uint8_t* key_data = reinterpret_cast<const uint8_t*>(key.data());
+  RecordHeader header = {
+      .signature = kRecordSignature,
+      .key_size = static_cast<uint32_t>(key.size()),
+      .value_size = static_cast<uint32_t>(value_size),
+      .checksum = Checksum(key_data, key.size(), value, value_size),
+  };
+  memcpy(buffer, &header, sizeof(RecordHeader));
+  buffer += sizeof(RecordHeader);
+  memcpy(buffer, key_data, key.size());
+  buffer += key.size();
+  if (value_size > 0u) {
+    memcpy(buffer, value, value_size);
+  }
+  return record;
+}
+
+bool ShaderCachePack::IsValid() const {
+  return directory_ && directory_->is_valid();
+}
+
+size_t ShaderCachePack::InsertEntry(
+    std::unordered_map<std::string, Entry>* index,
+    std::string key,
+    Entry entry) {
+  auto [it, inserted] = index->try_emplace(std::move(key), entry);
+  if (inserted) {
+    return 0u;
+  }
+  size_t replaced_size = it->second.record_size;
+  it->second = std::move(entry);
+  return replaced_size;
+}
+
+size_t ShaderCachePack::IndexRecords(
+    const std::shared_ptr<const fml::Mapping>& mapping,
+    std::unordered_map<std::string, Entry>* index,
+    size_t* replaced_byte_size) {
+  const uint8_t* data = mapping->GetMapping();
+  const size_t size = mapping->GetSize();
+  PackHeader pack_header;
+  if (size < sizeof(PackHeader)) {
+    return 0u;
+  }
+  memcpy(&pack_header, data, sizeof(PackHeader));
+  if (pack_header.signature != kSignature ||
+      pack_header.version != kVersion1) {
+    FML_LOG(INFO) << "Shader cache pack header is corrupt.";
+    return 0u;
+  }
+
+  size_t offset = sizeof(PackHeader);
+  while (size - offset >= sizeof(RecordHeader)) {
+    RecordHeader header;
+    memcpy(&header, data + offset, sizeof(RecordHeader));
+    if (header.signature != kRecordSignature) {
+      break;
+    }
+    uint64_t record_size = RecordSize(header.key_size, header.value_size);
+    if (record_size > size - offset) {
+      break;
+    }
+    const uint8_t* key = data + offset + sizeof(RecordHeader);
+    const uint8_t* value = key + header.key_size;
+    if (Checksum(key, header.key_size, value, header.value_size) !=
+        header.checksum) {
+      break;
+    }
+    *replaced_byte_size += InsertEntry(
+        index,
+        std::string(reinterpret_cast<const char*>(key), header.key_size),
+        Entry{
+            .storage = mapping,
+            .record_offset = offset,
+            .record_size = static_cast<size_t>(record_size),
+            .key_size = header.key_size,
+            .value_size = header.value_size,
+        });
+    offset += record_size;
+  }
+  if (offset < size) {
+    FML_LOG(INFO) << "Discarding " << size - offset
+                  << " bytes of incomplete records in the shader cache pack.";
+  }
+  return offset;
+}
+
+std::unique_ptr<fml::Mapping> ShaderCachePack::Find(
+    std::string_view key) const {
+  std::scoped_lock lock(mutex_);
+  auto found = index_.find(std::string(key));
+  if (found == index_.end()) {
+    return nullptr;
+  }
+  const Entry& entry = found->second;
+  const uint8_t* value = entry.storage->GetMapping() + entry.record_offset +
+                         sizeof(RecordHeader) + entry.key_size;
+  return std::make_unique<fml::NonOwnedMapping>(
+      value, entry.value_size,
+      [storage = entry.storage](const uint8_t* data, size_t size) {});
+}
+
+void ShaderCachePack::VisitEntries(const EntryVisitor& visitor) const {
+  std::vector<Entry> entries;
+  {
+    std::scoped_lock lock(mutex_);
+    entries.reserve(index_.size());
+    for (const auto& [key, entry] : index_) {
+      entries.push_back(entry);
+    }
+  }
+  for (const Entry& entry : entries) {
+    const uint8_t* key = entry.storage->GetMapping() + entry.record_offset +
+                         sizeof(RecordHeader);
+    visitor(std::string_view(reinterpret_cast<const char*>(key),
+                             entry.key_size),
+            key + entry.key_size, entry.value_size);
+  }
+}
+
+size_t ShaderCachePack::GetEntryCount() const {
+  std::scoped_lock lock(mutex_);
+  return index_.size();
+}
+
+bool ShaderCachePack::Append(
+    const std::vector<std::shared_ptr<const fml::Mapping>>& records) {
+  if (read_only_ || !IsValid()) {
+    return false;
+  }
+  TRACE_EVENT0("flutter", "ShaderCachePack::Append");
+  std::scoped_lock write_lock(write_mutex_);
+
+  size_t appended_size = 0u;
+  for (const auto& record : records) {
+    FML_DCHECK(record && record->GetSize() >= sizeof(RecordHeader));
+    appended_size += record->GetSize();
+  }
+  if (appended_size == 0u) {
+    return true;
+  }
+
+  fml::UniqueFD lock_file = LockPackFiles(*directory_);
+  if (!lock_file.is_valid()) {
+    return false;
+  }
+  fml::UniqueFD file = fml::OpenFile(*directory_, kFileName, true,
+                                     fml::FilePermission::kReadWrite);
+  if (!file.is_valid()) {
+    return false;
+  }
+
+  size_t disk_size = 0u;
+  if (!fml::GetFileSize(file, &disk_size)) {
+    return false;
+  }
+  if (disk_size != file_size_ && !ReindexFile(file, disk_size)) {
+    return false;
+  }
+
+  size_t offset = file_size_;
+  if (offset == 0u) {
+    PackHeader pack_header;
+    if (!fml::WriteFileAt(file, 0u,
+                          reinterpret_cast<const uint8_t*>(&pack_header),
+                          sizeof(PackHeader))) {
+      return false;
+    }
+    offset = sizeof(PackHeader);
+  }
+  for (const auto& record : records) {
+    if (!fml::WriteFileAt(file, offset, record->GetMapping(),
+                          record->GetSize())) {
+      // The next append finds the incomplete record and overwrites it.
+      return false;
+    }
+    offset += record->GetSize();
+  }
+
+  std::scoped_lock lock(mutex_);
+  for (const auto& record : records) {
+    RecordHeader header;
+    memcpy(&header, record->GetMapping(), sizeof(RecordHeader));
+    const char* key =
+        reinterpret_cast<const char*>(record->GetMapping()) +
+        sizeof(RecordHeader);
+    replaced_byte_size_ += InsertEntry(&index_,
+                                       std::string(key, header.key_size),
+                                       Entry{
+                                           .storage = record,
+                                           .record_offset = 0u,
+                                           .record_size = record->GetSize(),
+                                           .key_size = header.key_size,
+                                           .value_size = header.value_size,
+                                       });
+  }
+  unmapped_byte_size_ += appended_size;
+  file_size_ = offset;
+  return true;
+}
+
+bool ShaderCachePack::ReindexFile(const fml::UniqueFD& file,
+                                  size_t disk_size) {
+  std::unordered_map<std::string, Entry> index;
+  size_t replaced_byte_size = 0u;
+  size_t file_size = 0u;
+  if (disk_size > 0u) {
+    std::shared_ptr<const fml::Mapping> mapping = MapPackFile(file);
+    if (!mapping) {
+      return false;
+    }
+    file_size = IndexRecords(mapping, &index, &replaced_byte_size);
+  }
+  // Only a write that was interrupted leaves bytes after the last valid
+  // record, as writers hold the lock until their records are complete.
+  if (file_size < disk_size && !fml::TruncateFile(file, file_size)) {
+    return false;
+  }
+
+  std::scoped_lock lock(mutex_);
+  index_.swap(index);
+  file_size_ = file_size;
+  replaced_byte_size_ = replaced_byte_size;
+  unmapped_byte_size_ = 0u;
+  return true;
+}
+
+size_t ShaderCachePack::MigrateLegacyFiles(const LegacyFileParser& parser) {
+  if (read_only_ || !IsValid()) {
+    return 0u;
+  }
+  TRACE_EVENT0("flutter", "ShaderCachePack::MigrateLegacyFiles");
+  std::vector<std::shared_ptr<const fml::Mapping>> records;
+  std::vector<std::string> file_names;
+  fml::VisitFiles(*directory_, [&](const fml::UniqueFD& directory,
+                                   const std::string& file_name) {
+    if (IsPackFile(file_name) ||
+        fml::IsDirectory(directory, file_name.c_str())) {
+      return true;
+    }
+    auto contents = fml::FileMapping::CreateReadOnly(directory, file_name);
+    size_t key_offset = 0u;
+    size_t key_size = 0u;
+    if (!contents || !parser(*contents, &key_offset, &key_size)) {
+      return true;
+    }
+    const uint8_t* key = contents->GetMapping() + key_offset;
+    size_t value_offset = key_offset + key_size;
+    auto record = BuildRecord(
+        std::string_view(reinterpret_cast<const char*>(key), key_size),
+        contents->GetMapping() + value_offset,
+        contents->GetSize() - value_offset);
+    if (record) {
+      records.push_back(std::move(record));
+      file_names.push_back(file_name);
+    }
+    return true;
+  });
+
+  if (!records.empty() && !Append(records)) {
+    FML_LOG(WARNING) << "Could not move persistent cache files into the "
+                        "shader cache pack.";
+    return 0u;
+  }
+  for (const std::string& file_name : file_names) {
+    fml::UnlinkFile(*directory_, file_name.c_str());
+  }
+  migrated_legacy_files_ = true;
+  return file_names.size();
+}
+
+bool ShaderCachePack::NeedsCompaction() const {
+  if (read_only_) {
+    return false;
+  }
+  std::scoped_lock lock(mutex_);
+  return unmapped_byte_size_ > kMaxUnmappedByteSize ||
+         (replaced_byte_size_ >= kMinCompactionByteSize &&
+          replaced_byte_size_ * 2u >= file_size_);
+}
+
+bool ShaderCachePack::Compact() {
+  if (read_only_ || !IsValid()) {
+    return false;
+  }
+  TRACE_EVENT0("flutter", "ShaderCachePack::Compact");
+  std::scoped_lock write_lock(write_mutex_);
+
+  fml::UniqueFD lock_file = LockPackFiles(*directory_);
+  if (!lock_file.is_valid()) {
+    return false;
+  }
+
+  // Other processes may have appended to the pack since it was indexed, so
+  // the live entries are read from the file rather than from |index_|.
+  std::unordered_map<std::string, Entry> disk_index;
+  std::shared_ptr<const fml::Mapping> disk_mapping = MapPackFile(fml::OpenFile(
+      *directory_, kFileName, false, fml::FilePermission::kRead));
+  if (disk_mapping) {
+    size_t disk_replaced_byte_size = 0u;
+    IndexRecords(disk_mapping, &disk_index, &disk_replaced_byte_size);
+  }
+
+  size_t packed_size = sizeof(PackHeader);
+  for (const auto& [key, entry] : disk_index) {
+    packed_size += entry.record_size;
+  }
+  uint8_t* buffer = static_cast<uint8_t*>(malloc(packed_size));
+  if (buffer == nullptr) {
+    return false;
+  }
+  auto packed = std::make_shared<fml::MallocMapping>(buffer, packed_size);
+  PackHeader pack_header;
+  memcpy(buffer, &pack_header, sizeof(PackHeader));
+  size_t offset = sizeof(PackHeader);
+  for (const auto& [key, entry] : disk_index) {
+    memcpy(buffer + offset, entry.storage->GetMapping() + entry.record_offset,
+           entry.record_size);
+    offset += entry.record_size;
+  }
+
+  disk_index.clear();
+  disk_mapping.reset();
+
+  if (!fml::WriteAtomically(*directory_, kFileName, *packed)) {
+    FML_LOG(WARNING) << "Could not compact the shader cache pack.";
+    return false;
+  }
+
+  std::shared_ptr<const fml::Mapping> mapping = MapPackFile(fml::OpenFile(
+      *directory_, kFileName, false, fml::FilePermission::kRead));
+  const bool mapped = mapping != nullptr;
+  if (!mapped) {
+    // The packed copy holds exactly what the file holds, so the entries
+    // are served from it and later appends continue after them.
+    mapping = packed;
+  }
+
+  std::unordered_map<std::string, Entry> index;
+  size_t replaced_byte_size = 0u;
+  size_t file_size = IndexRecords(mapping, &index, &replaced_byte_size);
+
+  std::scoped_lock lock(mutex_);
+  index_.swap(index);
+  file_size_ = file_size;
+  replaced_byte_size_ = replaced_byte_size;
+  unmapped_byte_size_ = 0u;
+  return mapped;
+}
+
+void ShaderCachePack::Reset() {
+  std::scoped_lock write_lock(write_mutex_);
+  std::scoped_lock lock(mutex_);
+  ResetLocked();
+}
+
+void ShaderCachePack::ResetLocked() {
+  index_.clear();
+  file_size_ = 0u;
+  replaced_byte_size_ = 0u;
+  unmapped_byte_size_ = 0u;
+}
+
+}  // namespace flutter
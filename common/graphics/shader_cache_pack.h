@@ -0,0 +1,215 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_COMMON_GRAPHICS_SHADER_CACHE_PACK_H_
+#define FLUTTER_COMMON_GRAPHICS_SHADER_CACHE_PACK_H_
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "flutter/fml/macros.h"
+#include "flutter/fml/mapping.h"
+#include "flutter/fml/unique_fd.h"
+
+namespace flutter {
+
+//------------------------------------------------------------------------------
+/// @brief      An append-only file of key/value records that replaces the
+///             one-file-per-entry layout of the persistent cache.
+///
+///             The pack file is memory mapped once when the pack is opened
+///             and its records are indexed by key in a hash map, so looking
+///             up or enumerating entries costs no system calls. On Windows,
+///             where a mapped file cannot be truncated or rewritten, the
+///             records are copied out of the mapping instead. Entries
+///             appended after the pack was opened are kept in memory until
+///             the next compaction, which rewrites the pack with only the
+///             live entries and maps the result.
+///
+///             A record is only considered valid if its checksum matches, so
+///             a write that was interrupted (for example because the process
+///             was killed) is discarded when the pack is next opened and
+///             overwritten by the next append.
+///
+///             Lookups may happen on any thread. Appends, migration and
+///             compaction do file I/O and should be performed on a worker
+///             thread. They are serialized with each other, and through a
+///             lock file with those of other processes that share the
+///             cache directory. Records are always appended after the last
+///             valid record on disk, and compaction keeps the records that
+///             other processes appended.
+///
+class ShaderCachePack {
+ public:
+  static constexpr char kFileName[] = "shaders.pack";
+  static constexpr char kLockFileName[] = "shaders.pack.lock";
+
+  // A prefix used to identify the pack file format.
+  static constexpr uint32_t kSignature = 0x4B504353;
+  static constexpr uint32_t kVersion1 = 1;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Extracts the key of a cache entry from the contents of a
+  ///             file written in the legacy one-file-per-entry layout. The
+  ///             value is everything that follows the key.
+  ///
+  /// @return     false if the file is not a cache entry.
+  ///
+  using LegacyFileParser = std::function<
+      bool(const fml::Mapping& contents, size_t* key_offset, size_t* key_size)>;
+
+  using EntryVisitor = std::function<
+      void(std::string_view key, const uint8_t* value, size_t value_size)>;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Open the pack in the given directory. The pack file is not
+  ///             created until the first entry is appended.
+  ///
+  ShaderCachePack(std::shared_ptr<fml::UniqueFD> directory, bool read_only);
+
+  ~ShaderCachePack();
+
+  //----------------------------------------------------------------------------
+  /// @brief      Whether the given file name belongs to the pack and must
+  ///             not be treated as a cache entry.
+  ///
+  static bool IsPackFile(const std::string& file_name);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Allocate a record holding the given key and value in the
+  ///             format used by the pack file. Records may be built on any
+  ///             thread and then passed to |Append|.
+  ///
+  static std::shared_ptr<const fml::Mapping> BuildRecord(std::string_view key,
+                                                         const uint8_t* value,
+                                                         size_t value_size);
+
+  bool IsValid() const;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Find the value stored for the key. The returned mapping
+  ///             keeps the memory backing it alive and stays valid across
+  ///             later appends and compactions.
+  ///
+  /// @return     nullptr if the pack has no entry for the key.
+  ///
+  std::unique_ptr<fml::Mapping> Find(std::string_view key) const;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Invoke the visitor for every entry in the pack. The visitor
+  ///             is called without holding the pack's lock.
+  ///
+  void VisitEntries(const EntryVisitor& visitor) const;
+
+  size_t GetEntryCount() const;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Write records built by |BuildRecord| to the end of the pack
+  ///             file. Entries replace any earlier entry with the same key.
+  ///
+  /// @return     Whether the records were written.
+  ///
+  bool Append(const std::vector<std::shared_ptr<const fml::Mapping>>& records);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Move the cache entries that were written as individual
+  ///             files into the pack and delete the files. Files that the
+  ///             parser does not recognize are left in place.
+  ///
+  ///             Once this returns, |HasMigratedLegacyFiles| is true and
+  ///             callers no longer need to look for individual files.
+  ///
+  /// @return     The number of files that were moved into the pack.
+  ///
+  size_t MigrateLegacyFiles(const LegacyFileParser& parser);
+
+  bool HasMigratedLegacyFiles() const { return migrated_legacy_files_; }
+
+  //----------------------------------------------------------------------------
+  /// @brief      Whether enough of the pack is made of replaced records, or
+  ///             of records that are only held in memory, that it should be
+  ///             rewritten by |Compact|.
+  ///
+  bool NeedsCompaction() const;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Rewrite the pack file with only the live entries and map the
+  ///             new file in place of the old one.
+  ///
+  bool Compact();
+
+  //----------------------------------------------------------------------------
+  /// @brief      Forget all entries. This must be called after the pack file
+  ///             has been deleted from the directory.
+  ///
+  void Reset();
+
+  /// Entries appended since the pack file was last mapped are held in
+  /// memory. Once they total more than this many bytes the pack is compacted
+  /// so that they are served from the mapping instead.
+  static constexpr size_t kMaxUnmappedByteSize = 256u * 1024u;
+
+  /// Replaced records are only reclaimed once they make up at least this
+  /// many bytes and half of the file.
+  static constexpr size_t kMinCompactionByteSize = 16u * 1024u;
+
+ private:
+  struct Entry {
+    /// Either the mapping of the pack file or, for entries appended since the
+    /// file was mapped, the record built by |BuildRecord|.
+    std::shared_ptr<const fml::Mapping> storage;
+    size_t record_offset = 0u;
+    size_t record_size = 0u;
+    size_t key_size = 0u;
+    size_t value_size = 0u;
+  };
+
+  const std::shared_ptr<fml::UniqueFD> directory_;
+  const bool read_only_;
+  std::atomic<bool> migrated_legacy_files_ = false;
+
+  // Serializes the operations that modify the pack file. Held without
+  // |mutex_| while doing file I/O so that lookups are never blocked on it.
+  std::mutex write_mutex_;
+
+  mutable std::mutex mutex_;
+  std::unordered_map<std::string, Entry> index_;
+  // The size of the valid prefix of the pack file, where the next record
+  // will be written. Zero if the file has no header yet.
+  size_t file_size_ = 0u;
+  size_t replaced_byte_size_ = 0u;
+  size_t unmapped_byte_size_ = 0u;
+
+  // Index the records in the mapping of a pack file. Stops at the first
+  // record that is not valid.
+  static size_t IndexRecords(
+      const std::shared_ptr<const fml::Mapping>& mapping,
+      std::unordered_map<std::string, Entry>* index,
+      size_t* replaced_byte_size);
+
+  // Insert an entry into the index and return the size of the record it
+  // replaced, if any.
+  static size_t InsertEntry(std::unordered_map<std::string, Entry>* index,
+                            std::string key,
+                            Entry entry);
+
+  // Replace the index with the records in the pack file, whose size on
+  // disk no longer matches |file_size_|, and truncate any incomplete record
+  // at its end. Must be called with the lock file held.
+  bool ReindexFile(const fml::UniqueFD& file, size_t disk_size);
+
+  void ResetLocked();
+
+  FML_DISALLOW_COPY_AND_ASSIGN(ShaderCachePack);
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_COMMON_GRAPHICS_SHADER_CACHE_PACK_H_
@@ -354,6 +354,16 @@ struct Settings {
   // Max bytes threshold of resource cache, or 0 for unlimited.
   size_t resource_cache_max_bytes_threshold = 0;
 
+  // Max bytes of images held by the raster cache, or 0 for unlimited. When
+  // the cache is full, the images that are cheapest to re-rasterize for the
+  // memory they occupy are evicted first.
+  size_t raster_cache_max_bytes = 0;
+
+  // The number of times per second the CPU usage of the threads of the engine
+  // and the memory usage of the process are sampled into the timeline, or 0
+  // to not sample them. Only used on the platforms that have a sampler.
+  int profiler_samples_per_second = 0;
+
   /// Enable embedder api on the embedder.
   ///
   /// This is currently only used by iOS.
@@ -367,6 +377,16 @@ struct Settings {
   // If true, the UI thread is the platform thread on supported
   // platforms.
   bool merged_platform_ui_thread = true;
+
+  /// Preroll and record the layer trees of the views of a frame concurrently
+  /// on the worker threads. Only the submission to the surface remains on
+  /// the raster thread.
+  ///
+  /// This only applies to Impeller surfaces without the raster cache. Views
+  /// with texture layers or platform views, and views whose scenes share
+  /// retained layers with the scene of another view, are always prerolled
+  /// and painted on the raster thread.
+  bool enable_concurrent_view_rasterization = false;
 };
 
 }  // namespace flutter
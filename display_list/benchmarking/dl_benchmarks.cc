@@ -7,6 +7,7 @@
 #include "flutter/display_list/dl_op_flags.h"
 #include "flutter/display_list/skia/dl_sk_canvas.h"
 #include "flutter/display_list/testing/dl_test_snippets.h"
+#include "flutter/display_list/utils/dl_optimizer.h"
 
 #include "third_party/skia/include/core/SkBitmap.h"
 #include "third_party/skia/include/core/SkImage.h"
@@ -1339,6 +1340,67 @@ void BM_SaveLayer(benchmark::State& state,
   surface_provider->Snapshot(filename);
 }
 
+// Draws N frames of content on top of each other, where each frame is a
+// grid of rects under a save/restore pair with a transform, preceded by an
+// opaque fill of the whole canvas. Only the last frame is visible.
+//
+// If |optimize| is true, the DisplayList is passed through the
+// DisplayListOptimizer before it is rasterized, which culls the rects of
+// all but the last frame along with their transforms and attributes.
+void BM_DrawOverdrawnFrames(benchmark::State& state,
+                            BackendType backend_type,
+                            unsigned attributes,
+                            bool optimize) {
+  auto surface_provider = DlSurfaceProvider::Create(backend_type);
+  DisplayListBuilder builder;
+  DlPaint paint = GetPaintForRun(attributes);
+
+  AnnotateAttributes(attributes, state, DisplayListOpFlags::kDrawRectFlags);
+
+  size_t length = kFixedCanvasSize;
+  surface_provider->InitializeSurface(length, length);
+  auto surface = surface_provider->GetPrimarySurface()->sk_surface();
+  auto canvas = DlSkCanvasAdapter(surface->getCanvas());
+
+  size_t frames = state.range(0);
+  const size_t kRectsPerSide = 16;
+  const SkScalar rect_size = static_cast<SkScalar>(length) / kRectsPerSide;
+  SkRect rect = SkRect::MakeWH(rect_size * 0.75f, rect_size * 0.75f);
+
+  for (size_t i = 0; i < frames; i++) {
+    builder.DrawRect(SkRect::MakeWH(length, length),
+                     DlPaint(DlColor::kWhite()));
+    for (size_t y = 0; y < kRectsPerSide; y++) {
+      for (size_t x = 0; x < kRectsPerSide; x++) {
+        builder.Save();
+        builder.Translate(x * rect_size, y * rect_size);
+        paint.setColor(DlColor(0xFF000000 | ((x * 16) << 16) | (y * 16)));
+        builder.DrawRect(rect, paint);
+        builder.Restore();
+      }
+    }
+  }
+  auto display_list = builder.Build();
+  if (optimize) {
+    display_list = DisplayListOptimizer::Optimize(display_list);
+  }
+
+  state.counters["DrawCallCount_Varies"] =
+      frames * kRectsPerSide * kRectsPerSide;
+  state.counters["OpCount"] = display_list->op_count();
+
+  // We only want to time the actual rasterization.
+  for ([[maybe_unused]] auto _ : state) {
+    canvas.DrawDisplayList(display_list);
+    FlushSubmitCpuSync(surface);
+  }
+
+  auto filename = surface_provider->backend_name() + "-OverdrawnFrames-" +
+                  (optimize ? "Optimized-" : "") + std::to_string(frames) +
+                  ".png";
+  surface_provider->Snapshot(filename);
+}
+
 #ifdef ENABLE_SOFTWARE_BENCHMARKS
 RUN_DISPLAYLIST_BENCHMARKS(Software)
 #endif
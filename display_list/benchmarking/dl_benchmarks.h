@@ -97,6 +97,10 @@ void BM_SaveLayer(benchmark::State& state,
                   BackendType backend_type,
                   unsigned attributes,
                   size_t save_depth);
+void BM_DrawOverdrawnFrames(benchmark::State& state,
+                            BackendType backend_type,
+                            unsigned attributes,
+                            bool optimize);
 // clang-format off
 
 // DrawLine
@@ -534,6 +538,26 @@ void BM_SaveLayer(benchmark::State& state,
       ->UseRealTime()                                                   \
       ->Unit(benchmark::kMillisecond);
 
+// DisplayListOptimizer
+#define OPTIMIZER_BENCHMARKS(BACKEND, ATTRIBUTES)                       \
+  BENCHMARK_CAPTURE(BM_DrawOverdrawnFrames, Unoptimized/BACKEND,        \
+                    BackendType::k##BACKEND##Backend,                  \
+                    ATTRIBUTES,                                         \
+                    false)                                              \
+      ->RangeMultiplier(2)                                              \
+      ->Range(1, 16)                                                    \
+      ->UseRealTime()                                                   \
+      ->Unit(benchmark::kMillisecond);                                  \
+                                                                        \
+  BENCHMARK_CAPTURE(BM_DrawOverdrawnFrames, Optimized/BACKEND,          \
+                    BackendType::k##BACKEND##Backend,                  \
+                    ATTRIBUTES,                                         \
+                    true)                                               \
+      ->RangeMultiplier(2)                                              \
+      ->Range(1, 16)                                                    \
+      ->UseRealTime()                                                   \
+      ->Unit(benchmark::kMillisecond);
+
 // Applies stroke style and antialiasing
 #define STROKE_BENCHMARKS(BACKEND, ATTRIBUTES)                           \
   DRAW_LINE_BENCHMARKS(BACKEND, ATTRIBUTES)                              \
@@ -568,7 +592,8 @@ void BM_SaveLayer(benchmark::State& state,
   DRAW_IMAGE_NINE_BENCHMARKS(BACKEND, ATTRIBUTES)                        \
   DRAW_VERTICES_BENCHMARKS(BACKEND, ATTRIBUTES)                          \
   DRAW_SHADOW_BENCHMARKS(BACKEND, ATTRIBUTES)                            \
-  SAVE_LAYER_BENCHMARKS(BACKEND, ATTRIBUTES)
+  SAVE_LAYER_BENCHMARKS(BACKEND, ATTRIBUTES)                             \
+  OPTIMIZER_BENCHMARKS(BACKEND, ATTRIBUTES)
 
 #define RUN_DISPLAYLIST_BENCHMARKS(BACKEND)                        \
   STROKE_BENCHMARKS(BACKEND, kStrokedStyle)                        \
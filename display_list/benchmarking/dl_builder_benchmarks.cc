@@ -3,6 +3,7 @@
 // found in the LICENSE file.
 
 #include "flutter/benchmarking/benchmarking.h"
+#include "flutter/display_list/dl_serializer.h"
 #include "flutter/display_list/testing/dl_test_snippets.h"
 #include "flutter/display_list/utils/dl_receiver_utils.h"
 
@@ -310,6 +311,63 @@ static void BM_DisplayListDispatchByVectorCull(
   }
 }
 
+static sk_sp<DisplayList> MakeSerializationDisplayList(
+    DisplayListDispatchBenchmarkType type) {
+  DisplayListBuilder builder(NeedPrepareRTree(type));
+  for (int i = 0; i < 5; i++) {
+    InvokeAllOps(builder);
+  }
+  return builder.Build();
+}
+
+static void BM_DisplayListSerialize(benchmark::State& state,
+                                    DisplayListDispatchBenchmarkType type) {
+  auto display_list = MakeSerializationDisplayList(type);
+  size_t bytes = 0u;
+  while (state.KeepRunning()) {
+    auto mapping = DisplayListSerializer::Serialize(*display_list);
+    bytes = mapping->GetSize();
+    benchmark::DoNotOptimize(mapping);
+  }
+  state.counters["SerializedBytes"] = bytes;
+}
+
+static void BM_DisplayListDeserialize(benchmark::State& state,
+                                      DisplayListDispatchBenchmarkType type) {
+  auto display_list = MakeSerializationDisplayList(type);
+  std::shared_ptr<const fml::Mapping> mapping =
+      DisplayListSerializer::Serialize(*display_list);
+  while (state.KeepRunning()) {
+    auto copy = DisplayListSerializer::Deserialize(mapping);
+    benchmark::DoNotOptimize(copy);
+  }
+}
+
+// The baseline that deserialization replaces: reconstructing the same
+// DisplayList by replaying it through a DisplayListBuilder.
+static void BM_DisplayListRebuild(benchmark::State& state,
+                                  DisplayListDispatchBenchmarkType type) {
+  auto display_list = MakeSerializationDisplayList(type);
+  while (state.KeepRunning()) {
+    DisplayListBuilder builder(NeedPrepareRTree(type));
+    display_list->Dispatch(DisplayListBuilderBenchmarkAccessor(builder));
+    auto copy = builder.Build();
+    benchmark::DoNotOptimize(copy);
+  }
+}
+
+static void BM_DisplayListDispatchDeserialized(
+    benchmark::State& state,
+    DisplayListDispatchBenchmarkType type) {
+  auto display_list = MakeSerializationDisplayList(type);
+  auto copy = DisplayListSerializer::Deserialize(
+      DisplayListSerializer::Serialize(*display_list));
+  DlOpReceiverIgnore receiver;
+  while (state.KeepRunning()) {
+    copy->Dispatch(receiver);
+  }
+}
+
 BENCHMARK_CAPTURE(BM_DisplayListBuilderDefault,
                   kDefault,
                   DisplayListBuilderBenchmarkType::kDefault)
@@ -464,4 +522,39 @@ BENCHMARK_CAPTURE(BM_DisplayListDispatchByVectorCull,
                   DisplayListDispatchBenchmarkType::kCulledWithRtree)
     ->Unit(benchmark::kMicrosecond);
 
+BENCHMARK_CAPTURE(BM_DisplayListSerialize,
+                  kDefaultNoRtree,
+                  DisplayListDispatchBenchmarkType::kDefaultNoRtree)
+    ->Unit(benchmark::kMicrosecond);
+
+BENCHMARK_CAPTURE(BM_DisplayListSerialize,
+                  kDefaultWithRtree,
+                  DisplayListDispatchBenchmarkType::kDefaultWithRtree)
+    ->Unit(benchmark::kMicrosecond);
+
+BENCHMARK_CAPTURE(BM_DisplayListDeserialize,
+                  kDefaultNoRtree,
+                  DisplayListDispatchBenchmarkType::kDefaultNoRtree)
+    ->Unit(benchmark::kMicrosecond);
+
+BENCHMARK_CAPTURE(BM_DisplayListDeserialize,
+                  kDefaultWithRtree,
+                  DisplayListDispatchBenchmarkType::kDefaultWithRtree)
+    ->Unit(benchmark::kMicrosecond);
+
+BENCHMARK_CAPTURE(BM_DisplayListRebuild,
+                  kDefaultNoRtree,
+                  DisplayListDispatchBenchmarkType::kDefaultNoRtree)
+    ->Unit(benchmark::kMicrosecond);
+
+BENCHMARK_CAPTURE(BM_DisplayListRebuild,
+                  kDefaultWithRtree,
+                  DisplayListDispatchBenchmarkType::kDefaultWithRtree)
+    ->Unit(benchmark::kMicrosecond);
+
+BENCHMARK_CAPTURE(BM_DisplayListDispatchDeserialized,
+                  kDefaultNoRtree,
+                  DisplayListDispatchBenchmarkType::kDefaultNoRtree)
+    ->Unit(benchmark::kMicrosecond);
+
 }  // namespace flutter
@@ -2,6 +2,7 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file.
 
+#include <cstring>
 #include <type_traits>
 
 #include "flutter/display_list/display_list.h"
@@ -20,6 +21,7 @@ DisplayList::DisplayList()
       nested_op_count_(0),
       total_depth_(0),
       unique_id_(0),
+      content_hash_(ComputeContentHash(storage_)),
       bounds_({0, 0, 0, 0}),
       can_apply_group_opacity_(true),
       is_ui_thread_safe_(true),
@@ -52,6 +54,7 @@ DisplayList::DisplayList(DisplayListStorage&& storage,
       nested_op_count_(nested_op_count),
       total_depth_(total_depth),
       unique_id_(next_unique_id()),
+      content_hash_(ComputeContentHash(storage_)),
       bounds_(bounds),
       can_apply_group_opacity_(can_apply_group_opacity),
       is_ui_thread_safe_(is_ui_thread_safe),
@@ -76,6 +79,54 @@ uint32_t DisplayList::next_unique_id() {
   return id;
 }
 
+namespace {
+
+// Mixes 8 bytes of record data into |hash|, based on the body of
+// MurmurHash3.
+uint64_t MixWord(uint64_t hash, uint64_t word) {
+  constexpr uint64_t kMultiplier1 = 0x87c37b91114253d5ull;
+  constexpr uint64_t kMultiplier2 = 0x4cf5ad432745937full;
+  word *= kMultiplier1;
+  word = (word << 31) | (word >> 33);
+  word *= kMultiplier2;
+  hash ^= word;
+  hash = (hash << 27) | (hash >> 37);
+  return hash * 5 + 0x52dce729;
+}
+
+// The finalization step of MurmurHash3 so that every input bit affects
+// every output bit.
+uint64_t FinalizeHash(uint64_t hash) {
+  hash ^= hash >> 33;
+  hash *= 0xff51afd7ed558ccdull;
+  hash ^= hash >> 33;
+  hash *= 0xc4ceb9fe1a85ec53ull;
+  hash ^= hash >> 33;
+  return hash;
+}
+
+}  // namespace
+
+uint64_t DisplayList::ComputeContentHash(const DisplayListStorage& storage) {
+  const uint8_t* bytes = storage.base();
+  size_t size = storage.size();
+  uint64_t hash = size;
+  // The records are pointer aligned, so there is at most a 4 byte tail on
+  // 32-bit platforms.
+  size_t offset = 0;
+  for (; offset + sizeof(uint64_t) <= size; offset += sizeof(uint64_t)) {
+    uint64_t word;
+    memcpy(&word, bytes + offset, sizeof(word));
+    hash = MixWord(hash, word);
+  }
+  if (offset < size) {
+    uint64_t word = 0;
+    memcpy(&word, bytes + offset, size - offset);
+    hash = MixWord(hash, word);
+  }
+  return FinalizeHash(hash);
+}
+
 struct SaveInfo {
   SaveInfo(DlIndex previous_restore_index, bool save_was_needed)
       : previous_restore_index(previous_restore_index),
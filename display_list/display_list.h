@@ -290,6 +290,18 @@ class DisplayList : public SkRefCnt {
 
   uint32_t unique_id() const { return unique_id_; }
 
+  // A 64-bit hash of the raw bytes of all of the records, computed once
+  // when the DisplayList is built. Objects referenced by the records, such
+  // as images, paths and shared filters, contribute their identity rather
+  // than their contents.
+  //
+  // Two DisplayLists with the same content hash are |Equals| (barring a
+  // 64-bit hash collision), so it can be used as a constant time equality
+  // check. The reverse is not true, two DisplayLists that reference
+  // distinct but equivalent objects are |Equals| but will usually have
+  // different content hashes.
+  uint64_t content_hash() const { return content_hash_; }
+
   const SkRect& bounds() const { return bounds_; }
   const DlRect& GetBounds() const { return ToDlRect(bounds_); }
 
@@ -520,6 +532,8 @@ class DisplayList : public SkRefCnt {
 
   static uint32_t next_unique_id();
 
+  static uint64_t ComputeContentHash(const DisplayListStorage& storage);
+
   static void DisposeOps(const DisplayListStorage& storage,
                          const std::vector<size_t>& offsets);
 
@@ -533,6 +547,7 @@ class DisplayList : public SkRefCnt {
   const uint32_t total_depth_;
 
   const uint32_t unique_id_;
+  const uint64_t content_hash_;
   const SkRect bounds_;
 
   const bool can_apply_group_opacity_;
@@ -550,6 +565,7 @@ class DisplayList : public SkRefCnt {
                                  const std::vector<int>& rtree_results) const;
 
   friend class DisplayListBuilder;
+  friend class DisplayListSerializer;
 };
 
 }  // namespace flutter
@@ -748,6 +748,46 @@ TEST_F(DisplayListTest, SingleOpDisplayListsNotEqualEmpty) {
   }
 }
 
+TEST_F(DisplayListTest, ContentHashOfIdenticalRecordsIsEqual) {
+  auto build = [](DlColor color) {
+    DisplayListBuilder builder;
+    builder.Translate(10.0f, 10.0f);
+    builder.DrawRect(DlRect::MakeLTRB(0, 0, 50, 50), DlPaint(color));
+    builder.DrawImage(TestImage1, DlPoint(20, 20), kNearestSampling);
+    return builder.Build();
+  };
+  sk_sp<DisplayList> dl1 = build(DlColor::kBlue());
+  sk_sp<DisplayList> dl2 = build(DlColor::kBlue());
+  sk_sp<DisplayList> dl3 = build(DlColor::kRed());
+
+  EXPECT_EQ(dl1->content_hash(), dl2->content_hash());
+  EXPECT_NE(dl1->content_hash(), dl3->content_hash());
+  EXPECT_NE(dl1->content_hash(), DisplayListBuilder().Build()->content_hash());
+  EXPECT_EQ(DisplayListBuilder().Build()->content_hash(),
+            sk_make_sp<DisplayList>()->content_hash());
+}
+
+TEST_F(DisplayListTest, EqualContentHashImpliesEquals) {
+  std::vector<sk_sp<DisplayList>> display_lists;
+  std::vector<std::string> descriptions;
+  for (auto& group : allGroups) {
+    for (size_t i = 0; i < group.variants.size(); i++) {
+      display_lists.push_back(Build(group.variants[i]));
+      descriptions.push_back(group.op_name + "(variant " +
+                             std::to_string(i + 1) + ")");
+    }
+  }
+  for (size_t i = 0; i < display_lists.size(); i++) {
+    for (size_t j = i + 1; j < display_lists.size(); j++) {
+      if (display_lists[i]->content_hash() ==
+          display_lists[j]->content_hash()) {
+        ASSERT_TRUE(display_lists[i]->Equals(display_lists[j]))
+            << descriptions[i] << " == " << descriptions[j];
+      }
+    }
+  }
+}
+
 TEST_F(DisplayListTest, SingleOpDisplayListsRecapturedAreEqual) {
   for (auto& group : allGroups) {
     for (size_t i = 0; i < group.variants.size(); i++) {
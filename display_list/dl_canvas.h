@@ -53,6 +53,8 @@ class DlCanvas {
   enum class SrcRectConstraint {
     kStrict,
     kFast,
+
+    kLast = kFast,
   };
 
   virtual ~DlCanvas() = default;
@@ -19,6 +19,8 @@ enum class DlImageSampling {
   kLinear,
   kMipmapLinear,
   kCubic,
+
+  kLast = kCubic,
 };
 
 }  // namespace flutter
@@ -0,0 +1,1840 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/display_list/dl_serializer.h"
+
+#include <type_traits>
+#include <unordered_map>
+
+#include "flutter/display_list/dl_op_records.h"
+#include "flutter/display_list/effects/dl_color_filters.h"
+#include "flutter/display_list/effects/dl_color_sources.h"
+#include "flutter/display_list/effects/dl_image_filters.h"
+#include "flutter/fml/file.h"
+#include "flutter/fml/trace_event.h"
+
+#include "third_party/skia/include/core/SkColorSpace.h"
+#include "third_party/skia/include/core/SkData.h"
+#include "third_party/skia/include/core/SkImage.h"
+#include "third_party/skia/include/core/SkPixmap.h"
+#include "third_party/skia/include/core/SkSerialProcs.h"
+#include "third_party/skia/include/core/SkTextBlob.h"
+#include "third_party/skia/include/core/SkTypeface.h"
+
+namespace flutter {
+
+namespace {
+
+// All offsets in the header are relative to the start of the header,
+// which is also the start of the (possibly nested) serialized DisplayList.
+struct SerializedHeader {
+  uint32_t magic;
+  uint32_t version;
+  uint32_t layout_signature;
+  uint32_t flags;
+  uint64_t total_size;
+  uint64_t storage_size;
+  uint64_t nested_byte_count;
+  uint64_t images_offset;
+  uint64_t rtree_offset;
+  uint32_t record_count;
+  uint32_t op_count;
+  uint32_t nested_op_count;
+  uint32_t total_depth;
+  uint32_t image_count;
+  uint32_t rtree_leaf_count;
+  uint32_t max_root_blend_mode;
+  uint32_t reserved;
+  SkRect bounds;
+};
+
+enum SerializedHeaderFlags : uint32_t {
+  kCanApplyGroupOpacity = 1 << 0,
+  kIsUIThreadSafe = 1 << 1,
+  kModifiesTransparentBlack = 1 << 2,
+  kRootHasBackdropFilter = 1 << 3,
+  kRootIsUnbounded = 1 << 4,
+  kHasRTree = 1 << 5,
+};
+
+struct SerializedRecordHeader {
+  uint32_t type;
+  uint32_t payload_size;
+};
+
+struct SerializedImageHeader {
+  uint64_t pixels_offset;
+  uint64_t row_bytes;
+  int32_t width;
+  int32_t height;
+  uint32_t color_type;
+  uint32_t alpha_type;
+  uint32_t color_space_size;
+  uint32_t reserved;
+};
+
+// Records are laid out on the same alignment that the DisplayListBuilder
+// uses for its storage. Pixel data is aligned more strictly so that it
+// can be handed to Skia directly from the mapping.
+static constexpr size_t kRecordAlignment = alignof(void*);
+static constexpr size_t kPixelAlignment = 16u;
+
+// Used as the "type" of a null color source or image filter reference.
+static constexpr uint32_t kNullAttribute = ~0u;
+
+// Records whose in-memory representation contains only numeric data
+// can be stored and restored with a simple memcpy. The SetPod ops are
+// trivial themselves, but they are followed by an attribute object
+// that contains a vtable pointer and so must be encoded by hand.
+template <typename T>
+constexpr bool kIsVerbatim =
+    std::is_trivially_destructible_v<T> && std::is_trivially_copyable_v<T>;
+template <>
+constexpr bool kIsVerbatim<SetPodColorFilterOp> = false;
+template <>
+constexpr bool kIsVerbatim<SetPodColorSourceOp> = false;
+template <>
+constexpr bool kIsVerbatim<SetPodImageFilterOp> = false;
+template <>
+constexpr bool kIsVerbatim<SetPodMaskFilterOp> = false;
+
+// The last value that each enum stored in a serialized DisplayList can
+// take. Values past it are rejected on load so that they never reach the
+// switches and tables that assume a defined value.
+static constexpr DlBlendMode LastValue(DlBlendMode) {
+  return DlBlendMode::kLastMode;
+}
+static constexpr DlDrawStyle LastValue(DlDrawStyle) {
+  return DlDrawStyle::kLastStyle;
+}
+static constexpr DlStrokeCap LastValue(DlStrokeCap) {
+  return DlStrokeCap::kLastCap;
+}
+static constexpr DlStrokeJoin LastValue(DlStrokeJoin) {
+  return DlStrokeJoin::kLastJoin;
+}
+static constexpr DlBlurStyle LastValue(DlBlurStyle) {
+  return DlBlurStyle::kLast;
+}
+static constexpr DlTileMode LastValue(DlTileMode) {
+  return DlTileMode::kLast;
+}
+static constexpr DlFilterMode LastValue(DlFilterMode) {
+  return DlFilterMode::kLast;
+}
+static constexpr DlImageSampling LastValue(DlImageSampling) {
+  return DlImageSampling::kLast;
+}
+static constexpr DlVertexMode LastValue(DlVertexMode) {
+  return DlVertexMode::kLast;
+}
+static constexpr DlCanvas::SrcRectConstraint LastValue(
+    DlCanvas::SrcRectConstraint) {
+  return DlCanvas::SrcRectConstraint::kLast;
+}
+
+template <typename T>
+static bool IsValidEnum(T value) {
+  static_assert(std::is_enum_v<T>);
+  using Underlying = std::underlying_type_t<T>;
+  return static_cast<Underlying>(value) >= 0 &&
+         static_cast<Underlying>(value) <=
+             static_cast<Underlying>(LastValue(T{}));
+}
+
+static bool IsVerbatim(DisplayListOpType type) {
+  switch (type) {
+#define DL_OP_IS_VERBATIM(name) \
+  case DisplayListOpType::k##name: \
+    return kIsVerbatim<name##Op>;
+
+    FOR_EACH_DISPLAY_LIST_OP(DL_OP_IS_VERBATIM)
+
+#undef DL_OP_IS_VERBATIM
+
+    case DisplayListOpType::kInvalidOp:
+      return false;
+  }
+}
+
+static size_t RecordSize(DisplayListOpType type) {
+  switch (type) {
+#define DL_OP_RECORD_SIZE(name)    \
+  case DisplayListOpType::k##name: \
+    return sizeof(name##Op);
+
+    FOR_EACH_DISPLAY_LIST_OP(DL_OP_RECORD_SIZE)
+
+#undef DL_OP_RECORD_SIZE
+
+    case DisplayListOpType::kInvalidOp:
+      return 0u;
+  }
+}
+
+static size_t AlignUp(size_t value, size_t alignment) {
+  return (value + alignment - 1) & ~(alignment - 1);
+}
+
+}  // namespace
+
+//------------------------------------------------------------------------------
+/// Accumulates the serialized bytes for a single DisplayList along with
+/// the table of images referenced by its records.
+class DisplayListSerializer::Writer {
+ public:
+  size_t position() const { return buffer_.size(); }
+
+  template <typename T>
+  void Write(const T& value) {
+    static_assert(std::is_trivially_copyable_v<T>);
+    WriteBytes(&value, sizeof(T));
+  }
+
+  void WriteBytes(const void* data, size_t length) {
+    auto bytes = static_cast<const uint8_t*>(data);
+    buffer_.insert(buffer_.end(), bytes, bytes + length);
+  }
+
+  template <typename T>
+  void Patch(size_t position, const T& value) {
+    static_assert(std::is_trivially_copyable_v<T>);
+    FML_DCHECK(position + sizeof(T) <= buffer_.size());
+    memcpy(buffer_.data() + position, &value, sizeof(T));
+  }
+
+  void Align(size_t alignment) {
+    buffer_.resize(AlignUp(buffer_.size(), alignment), 0u);
+  }
+
+  std::vector<uint8_t> Take() { return std::move(buffer_); }
+
+  void WritePath(const DlPath& path) {
+    const SkPath& sk_path = path.GetSkPath();
+    size_t size = sk_path.writeToMemory(nullptr);
+    Write<uint32_t>(size);
+    size_t start = buffer_.size();
+    buffer_.resize(start + size);
+    sk_path.writeToMemory(buffer_.data() + start);
+  }
+
+  bool WriteImage(const DlImage* image) {
+    if (!image) {
+      Write<uint32_t>(kNullAttribute);
+      return true;
+    }
+    auto found = image_indices_.find(image);
+    if (found != image_indices_.end()) {
+      Write<uint32_t>(found->second);
+      return true;
+    }
+    sk_sp<SkImage> sk_image = image->skia_image();
+    if (!sk_image || sk_image->isTextureBacked()) {
+      FML_LOG(ERROR) << "DisplayList serialization only supports raster images";
+      return false;
+    }
+    sk_sp<SkImage> raster = sk_image->makeRasterImage();
+    if (!raster) {
+      return false;
+    }
+    uint32_t index = images_.size();
+    image_indices_[image] = index;
+    images_.push_back(std::move(raster));
+    Write<uint32_t>(index);
+    return true;
+  }
+
+  bool WriteImages() {
+    for (const sk_sp<SkImage>& image : images_) {
+      SkPixmap pixmap;
+      if (!image->peekPixels(&pixmap)) {
+        return false;
+      }
+      sk_sp<SkData> color_space;
+      if (pixmap.colorSpace()) {
+        color_space = pixmap.colorSpace()->serialize();
+      }
+      Align(kRecordAlignment);
+      size_t header_position = position();
+      SerializedImageHeader header = {
+          .pixels_offset = 0u,
+          .row_bytes = pixmap.rowBytes(),
+          .width = pixmap.width(),
+          .height = pixmap.height(),
+          .color_type = static_cast<uint32_t>(pixmap.colorType()),
+          .alpha_type = static_cast<uint32_t>(pixmap.alphaType()),
+          .color_space_size =
+              color_space ? static_cast<uint32_t>(color_space->size()) : 0u,
+          .reserved = 0u,
+      };
+      Write(header);
+      if (color_space) {
+        WriteBytes(color_space->data(), color_space->size());
+      }
+      Align(kPixelAlignment);
+      header.pixels_offset = position();
+      Patch(header_position, header);
+      WriteBytes(pixmap.addr(), pixmap.computeByteSize());
+    }
+    return true;
+  }
+
+  size_t image_count() const { return images_.size(); }
+
+  void WriteColorFilter(const DlColorFilter* filter) {
+    if (!filter) {
+      Write<uint32_t>(kNullAttribute);
+      return;
+    }
+    Write<uint32_t>(static_cast<uint32_t>(filter->type()));
+    switch (filter->type()) {
+      case DlColorFilterType::kBlend: {
+        const DlBlendColorFilter* blend = filter->asBlend();
+        Write(blend->color());
+        Write(blend->mode());
+        break;
+      }
+      case DlColorFilterType::kMatrix: {
+        float matrix[20];
+        filter->asMatrix()->get_matrix(matrix);
+        WriteBytes(matrix, sizeof(matrix));
+        break;
+      }
+      case DlColorFilterType::kSrgbToLinearGamma:
+      case DlColorFilterType::kLinearToSrgbGamma:
+        break;
+    }
+  }
+
+  void WriteMaskFilter(const DlMaskFilter* filter) {
+    FML_DCHECK(filter && filter->type() == DlMaskFilterType::kBlur);
+    const DlBlurMaskFilter* blur = filter->asBlur();
+    Write(blur->style());
+    Write(blur->sigma());
+    Write<uint8_t>(blur->respectCTM());
+  }
+
+  bool WriteColorSource(const DlColorSource* source) {
+    if (!source) {
+      Write<uint32_t>(kNullAttribute);
+      return true;
+    }
+    Write<uint32_t>(static_cast<uint32_t>(source->type()));
+    switch (source->type()) {
+      case DlColorSourceType::kImage: {
+        const DlImageColorSource* image_source = source->asImage();
+        Write(image_source->horizontal_tile_mode());
+        Write(image_source->vertical_tile_mode());
+        Write(image_source->sampling());
+        Write(image_source->matrix());
+        return WriteImage(image_source->image().get());
+      }
+      case DlColorSourceType::kLinearGradient: {
+        const DlLinearGradientColorSource* linear = source->asLinearGradient();
+        Write(linear->start_point());
+        Write(linear->end_point());
+        WriteGradient(linear);
+        return true;
+      }
+      case DlColorSourceType::kRadialGradient: {
+        const DlRadialGradientColorSource* radial = source->asRadialGradient();
+        Write(radial->center());
+        Write(radial->radius());
+        WriteGradient(radial);
+        return true;
+      }
+      case DlColorSourceType::kConicalGradient: {
+        const DlConicalGradientColorSource* conical =
+            source->asConicalGradient();
+        Write(conical->start_center());
+        Write(conical->start_radius());
+        Write(conical->end_center());
+        Write(conical->end_radius());
+        WriteGradient(conical);
+        return true;
+      }
+      case DlColorSourceType::kSweepGradient: {
+        const DlSweepGradientColorSource* sweep = source->asSweepGradient();
+        Write(sweep->center());
+        Write(sweep->start());
+        Write(sweep->end());
+        WriteGradient(sweep);
+        return true;
+      }
+      case DlColorSourceType::kRuntimeEffect: {
+        const DlRuntimeEffectColorSource* effect = source->asRuntimeEffect();
+        return WriteRuntimeEffect(effect->runtime_effect(), effect->samplers(),
+                                  effect->uniform_data());
+      }
+    }
+  }
+
+  bool WriteImageFilter(const DlImageFilter* filter) {
+    if (!filter) {
+      Write<uint32_t>(kNullAttribute);
+      return true;
+    }
+    Write<uint32_t>(static_cast<uint32_t>(filter->type()));
+    switch (filter->type()) {
+      case DlImageFilterType::kBlur: {
+        const DlBlurImageFilter* blur = filter->asBlur();
+        Write(blur->sigma_x());
+        Write(blur->sigma_y());
+        Write(blur->tile_mode());
+        return true;
+      }
+      case DlImageFilterType::kDilate: {
+        const DlDilateImageFilter* dilate = filter->asDilate();
+        Write(dilate->radius_x());
+        Write(dilate->radius_y());
+        return true;
+      }
+      case DlImageFilterType::kErode: {
+        const DlErodeImageFilter* erode = filter->asErode();
+        Write(erode->radius_x());
+        Write(erode->radius_y());
+        return true;
+      }
+      case DlImageFilterType::kMatrix: {
+        const DlMatrixImageFilter* matrix = filter->asMatrix();
+        Write(matrix->matrix());
+        Write(matrix->sampling());
+        return true;
+      }
+      case DlImageFilterType::kColorFilter: {
+        WriteColorFilter(filter->asColorFilter()->color_filter().get());
+        return true;
+      }
+      case DlImageFilterType::kCompose: {
+        const DlComposeImageFilter* compose = filter->asCompose();
+        return WriteImageFilter(compose->outer().get()) &&
+               WriteImageFilter(compose->inner().get());
+      }
+      case DlImageFilterType::kLocalMatrix: {
+        const DlLocalMatrixImageFilter* local = filter->asLocalMatrix();
+        Write(local->matrix());
+        return WriteImageFilter(local->image_filter().get());
+      }
+      case DlImageFilterType::kRuntimeEffect: {
+        const DlRuntimeEffectImageFilter* effect =
+            filter->asRuntimeEffectFilter();
+        return WriteRuntimeEffect(effect->runtime_effect(), effect->samplers(),
+                                  effect->uniform_data());
+      }
+    }
+  }
+
+  void WriteVertices(const DlVertices* vertices) {
+    int vertex_count = vertices->vertex_count();
+    int index_count = vertices->index_count();
+    Write(vertices->mode());
+    Write<int32_t>(vertex_count);
+    Write<int32_t>(index_count);
+    Write<uint8_t>(vertices->texture_coordinates() != nullptr);
+    Write<uint8_t>(vertices->colors() != nullptr);
+    WriteBytes(vertices->vertices(), vertex_count * sizeof(SkPoint));
+    if (vertices->texture_coordinates()) {
+      WriteBytes(vertices->texture_coordinates(),
+                 vertex_count * sizeof(SkPoint));
+    }
+    if (vertices->colors()) {
+      WriteBytes(vertices->colors(), vertex_count * sizeof(DlColor));
+    }
+    if (index_count > 0) {
+      WriteBytes(vertices->indices(), index_count * sizeof(uint16_t));
+    }
+  }
+
+  void WriteTextBlob(const SkTextBlob* blob) {
+    SkSerialProcs procs;
+    procs.fTypefaceProc = [](SkTypeface* typeface, void* ctx) {
+      return typeface->serialize(SkTypeface::SerializeBehavior::kDoIncludeData);
+    };
+    sk_sp<SkData> data = blob->serialize(procs);
+    Write<uint32_t>(data->size());
+    WriteBytes(data->data(), data->size());
+  }
+
+ private:
+  std::vector<uint8_t> buffer_;
+  std::vector<sk_sp<SkImage>> images_;
+  std::unordered_map<const DlImage*, uint32_t> image_indices_;
+
+  void WriteGradient(const DlGradientColorSourceBase* gradient) {
+    Write(gradient->tile_mode());
+    Write(gradient->matrix());
+    Write<uint32_t>(gradient->stop_count());
+    WriteBytes(gradient->colors(), gradient->stop_count() * sizeof(DlColor));
+    WriteBytes(gradient->stops(), gradient->stop_count() * sizeof(float));
+  }
+
+  bool WriteRuntimeEffect(
+      const sk_sp<DlRuntimeEffect>& runtime_effect,
+      const std::vector<std::shared_ptr<DlColorSource>>& samplers,
+      const std::shared_ptr<std::vector<uint8_t>>& uniform_data) {
+    sk_sp<SkRuntimeEffect> sk_effect =
+        runtime_effect ? runtime_effect->skia_runtime_effect() : nullptr;
+    if (!sk_effect) {
+      FML_LOG(ERROR) << "DisplayList serialization only supports runtime "
+                        "effects compiled from SkSL";
+      return false;
+    }
+    const std::string& source = sk_effect->source();
+    Write<uint32_t>(source.size());
+    WriteBytes(source.data(), source.size());
+    Write<uint32_t>(samplers.size());
+    for (const std::shared_ptr<DlColorSource>& sampler : samplers) {
+      if (!WriteColorSource(sampler.get())) {
+        return false;
+      }
+    }
+    size_t uniform_size = uniform_data ? uniform_data->size() : 0u;
+    Write<uint32_t>(uniform_size);
+    if (uniform_size > 0u) {
+      WriteBytes(uniform_data->data(), uniform_size);
+    }
+    return true;
+  }
+};
+
+//------------------------------------------------------------------------------
+/// Reads the serialized bytes of a single DisplayList with bounds checking
+/// and holds the images decoded from its image table.
+class DisplayListSerializer::Reader {
+ public:
+  Reader(const uint8_t* data,
+         size_t size,
+         const std::shared_ptr<const fml::Mapping>& mapping)
+      : data_(data), size_(size), mapping_(mapping) {}
+
+  const uint8_t* data() const { return data_; }
+  size_t size() const { return size_; }
+  size_t position() const { return position_; }
+  const std::shared_ptr<const fml::Mapping>& mapping() const {
+    return mapping_;
+  }
+
+  bool Seek(size_t position) {
+    if (position > size_) {
+      return false;
+    }
+    position_ = position;
+    return true;
+  }
+
+  bool Align(size_t alignment) {
+    return Seek(AlignUp(position_, alignment));
+  }
+
+  template <typename T>
+  bool Read(T* value) {
+    static_assert(std::is_trivially_copyable_v<T>);
+    const uint8_t* bytes = ReadBytes(sizeof(T));
+    if (!bytes) {
+      return false;
+    }
+    memcpy(value, bytes, sizeof(T));
+    if constexpr (std::is_enum_v<T>) {
+      return IsValidEnum(*value);
+    }
+    return true;
+  }
+
+  const uint8_t* ReadBytes(size_t length) {
+    if (length > size_ - position_) {
+      return nullptr;
+    }
+    const uint8_t* bytes = data_ + position_;
+    position_ += length;
+    return bytes;
+  }
+
+  template <typename T>
+  bool ReadArray(std::vector<T>& values, size_t count) {
+    static_assert(std::is_trivially_copyable_v<T>);
+    if (count > (size_ - position_) / sizeof(T)) {
+      return false;
+    }
+    values.resize(count);
+    memcpy(values.data(), ReadBytes(count * sizeof(T)), count * sizeof(T));
+    return true;
+  }
+
+  bool ReadPath(DlPath* path) {
+    uint32_t size;
+    if (!Read(&size)) {
+      return false;
+    }
+    const uint8_t* bytes = ReadBytes(size);
+    if (!bytes) {
+      return false;
+    }
+    SkPath sk_path;
+    if (sk_path.readFromMemory(bytes, size) != size) {
+      return false;
+    }
+    *path = DlPath(sk_path);
+    return true;
+  }
+
+  bool ReadImages(size_t count) {
+    images_.reserve(count);
+    for (size_t i = 0; i < count; i++) {
+      SerializedImageHeader header;
+      if (!Align(kRecordAlignment) || !Read(&header)) {
+        return false;
+      }
+      sk_sp<SkColorSpace> color_space;
+      if (header.color_space_size > 0u) {
+        const uint8_t* bytes = ReadBytes(header.color_space_size);
+        if (!bytes) {
+          return false;
+        }
+        color_space = SkColorSpace::Deserialize(bytes, header.color_space_size);
+      }
+      SkImageInfo info = SkImageInfo::Make(
+          header.width, header.height,
+          static_cast<SkColorType>(header.color_type),
+          static_cast<SkAlphaType>(header.alpha_type), std::move(color_space));
+      size_t byte_size = info.computeByteSize(header.row_bytes);
+      if (!info.validRowBytes(header.row_bytes) ||
+          SkImageInfo::ByteSizeOverflowed(byte_size) ||
+          !Seek(header.pixels_offset)) {
+        return false;
+      }
+      const uint8_t* pixels = ReadBytes(byte_size);
+      if (!pixels) {
+        return false;
+      }
+      sk_sp<SkImage> image = SkImages::RasterFromData(
+          info, WrapPixels(pixels, byte_size), header.row_bytes);
+      if (!image) {
+        return false;
+      }
+      images_.push_back(DlImage::Make(std::move(image)));
+    }
+    return true;
+  }
+
+  bool ReadImage(sk_sp<DlImage>* image) {
+    uint32_t index;
+    if (!Read(&index)) {
+      return false;
+    }
+    if (index == kNullAttribute) {
+      *image = nullptr;
+      return true;
+    }
+    if (index >= images_.size()) {
+      return false;
+    }
+    *image = images_[index];
+    return true;
+  }
+
+  bool ReadColorFilter(std::shared_ptr<const DlColorFilter>* filter) {
+    uint32_t type;
+    if (!Read(&type)) {
+      return false;
+    }
+    if (type == kNullAttribute) {
+      *filter = nullptr;
+      return true;
+    }
+    switch (static_cast<DlColorFilterType>(type)) {
+      case DlColorFilterType::kBlend: {
+        DlColor color;
+        DlBlendMode mode;
+        if (!Read(&color) || !Read(&mode)) {
+          return false;
+        }
+        *filter = std::make_shared<DlBlendColorFilter>(color, mode);
+        return true;
+      }
+      case DlColorFilterType::kMatrix: {
+        float matrix[20];
+        if (!Read(&matrix)) {
+          return false;
+        }
+        *filter = std::make_shared<DlMatrixColorFilter>(matrix);
+        return true;
+      }
+      case DlColorFilterType::kSrgbToLinearGamma:
+        *filter = DlColorFilter::MakeSrgbToLinearGamma();
+        return true;
+      case DlColorFilterType::kLinearToSrgbGamma:
+        *filter = DlColorFilter::MakeLinearToSrgbGamma();
+        return true;
+    }
+    return false;
+  }
+
+  bool ReadMaskFilter(std::shared_ptr<DlBlurMaskFilter>* filter) {
+    DlBlurStyle style;
+    SkScalar sigma;
+    uint8_t respect_ctm;
+    if (!Read(&style) || !Read(&sigma) || !Read(&respect_ctm)) {
+      return false;
+    }
+    *filter = std::make_shared<DlBlurMaskFilter>(style, sigma, respect_ctm);
+    return true;
+  }
+
+  bool ReadColorSource(std::shared_ptr<DlColorSource>* source) {
+    uint32_t type;
+    if (!Read(&type)) {
+      return false;
+    }
+    if (type == kNullAttribute) {
+      *source = nullptr;
+      return true;
+    }
+    switch (static_cast<DlColorSourceType>(type)) {
+      case DlColorSourceType::kImage: {
+        DlTileMode horizontal_tile_mode;
+        DlTileMode vertical_tile_mode;
+        DlImageSampling sampling;
+        DlMatrix matrix;
+        sk_sp<DlImage> image;
+        if (!Read(&horizontal_tile_mode) || !Read(&vertical_tile_mode) ||
+            !Read(&sampling) || !Read(&matrix) || !ReadImage(&image)) {
+          return false;
+        }
+        *source = DlColorSource::MakeImage(image, horizontal_tile_mode,
+                                           vertical_tile_mode, sampling,
+                                           MatrixPtr(matrix));
+        return true;
+      }
+      case DlColorSourceType::kLinearGradient: {
+        DlPoint start_point;
+        DlPoint end_point;
+        if (!Read(&start_point) || !Read(&end_point) || !ReadGradient()) {
+          return false;
+        }
+        *source = DlColorSource::MakeLinear(
+            start_point, end_point, colors_.size(), colors_.data(),
+            stops_.data(), tile_mode_, MatrixPtr(matrix_));
+        return true;
+      }
+      case DlColorSourceType::kRadialGradient: {
+        DlPoint center;
+        DlScalar radius;
+        if (!Read(&center) || !Read(&radius) || !ReadGradient()) {
+          return false;
+        }
+        *source = DlColorSource::MakeRadial(center, radius, colors_.size(),
+                                            colors_.data(), stops_.data(),
+                                            tile_mode_, MatrixPtr(matrix_));
+        return true;
+      }
+      case DlColorSourceType::kConicalGradient: {
+        DlPoint start_center;
+        DlScalar start_radius;
+        DlPoint end_center;
+        DlScalar end_radius;
+        if (!Read(&start_center) || !Read(&start_radius) ||
+            !Read(&end_center) || !Read(&end_radius) || !ReadGradient()) {
+          return false;
+        }
+        *source = DlColorSource::MakeConical(
+            start_center, start_radius, end_center, end_radius, colors_.size(),
+            colors_.data(), stops_.data(), tile_mode_, MatrixPtr(matrix_));
+        return true;
+      }
+      case DlColorSourceType::kSweepGradient: {
+        DlPoint center;
+        DlScalar start;
+        DlScalar end;
+        if (!Read(&center) || !Read(&start) || !Read(&end) || !ReadGradient()) {
+          return false;
+        }
+        *source = DlColorSource::MakeSweep(center, start, end, colors_.size(),
+                                           colors_.data(), stops_.data(),
+                                           tile_mode_, MatrixPtr(matrix_));
+        return true;
+      }
+      case DlColorSourceType::kRuntimeEffect: {
+        sk_sp<DlRuntimeEffect> runtime_effect;
+        std::vector<std::shared_ptr<DlColorSource>> samplers;
+        std::shared_ptr<std::vector<uint8_t>> uniform_data;
+        if (!ReadRuntimeEffect(&runtime_effect, &samplers, &uniform_data)) {
+          return false;
+        }
+        *source = DlColorSource::MakeRuntimeEffect(
+            std::move(runtime_effect), std::move(samplers),
+            std::move(uniform_data));
+        return true;
+      }
+    }
+    return false;
+  }
+
+  bool ReadImageFilter(std::shared_ptr<DlImageFilter>* filter) {
+    uint32_t type;
+    if (!Read(&type)) {
+      return false;
+    }
+    if (type == kNullAttribute) {
+      *filter = nullptr;
+      return true;
+    }
+    switch (static_cast<DlImageFilterType>(type)) {
+      case DlImageFilterType::kBlur: {
+        DlScalar sigma_x;
+        DlScalar sigma_y;
+        DlTileMode tile_mode;
+        if (!Read(&sigma_x) || !Read(&sigma_y) || !Read(&tile_mode)) {
+          return false;
+        }
+        *filter = std::make_shared<DlBlurImageFilter>(sigma_x, sigma_y,
+                                                      tile_mode);
+        return true;
+      }
+      case DlImageFilterType::kDilate: {
+        DlScalar radius_x;
+        DlScalar radius_y;
+        if (!Read(&radius_x) || !Read(&radius_y)) {
+          return false;
+        }
+        *filter = std::make_shared<DlDilateImageFilter>(radius_x, radius_y);
+        return true;
+      }
+      case DlImageFilterType::kErode: {
+        DlScalar radius_x;
+        DlScalar radius_y;
+        if (!Read(&radius_x) || !Read(&radius_y)) {
+          return false;
+        }
+        *filter = std::make_shared<DlErodeImageFilter>(radius_x, radius_y);
+        return true;
+      }
+      case DlImageFilterType::kMatrix: {
+        DlMatrix matrix;
+        DlImageSampling sampling;
+        if (!Read(&matrix) || !Read(&sampling)) {
+          return false;
+        }
+        *filter = std::make_shared<DlMatrixImageFilter>(matrix, sampling);
+        return true;
+      }
+      case DlImageFilterType::kColorFilter: {
+        std::shared_ptr<const DlColorFilter> color_filter;
+        if (!ReadColorFilter(&color_filter) || !color_filter) {
+          return false;
+        }
+        *filter = DlImageFilter::MakeColorFilter(color_filter);
+        return true;
+      }
+      case DlImageFilterType::kCompose: {
+        std::shared_ptr<DlImageFilter> outer;
+        std::shared_ptr<DlImageFilter> inner;
+        if (!ReadImageFilter(&outer) || !ReadImageFilter(&inner)) {
+          return false;
+        }
+        *filter = std::make_shared<DlComposeImageFilter>(outer, inner);
+        return true;
+      }
+      case DlImageFilterType::kLocalMatrix: {
+        DlMatrix matrix;
+        std::shared_ptr<DlImageFilter> inner;
+        if (!Read(&matrix) || !ReadImageFilter(&inner) || !inner) {
+          return false;
+        }
+        *filter = std::make_shared<DlLocalMatrixImageFilter>(matrix, inner);
+        return true;
+      }
+      case DlImageFilterType::kRuntimeEffect: {
+        sk_sp<DlRuntimeEffect> runtime_effect;
+        std::vector<std::shared_ptr<DlColorSource>> samplers;
+        std::shared_ptr<std::vector<uint8_t>> uniform_data;
+        if (!ReadRuntimeEffect(&runtime_effect, &samplers, &uniform_data)) {
+          return false;
+        }
+        *filter = DlImageFilter::MakeRuntimeEffect(std::move(runtime_effect),
+                                                   std::move(samplers),
+                                                   std::move(uniform_data));
+        return true;
+      }
+    }
+    return false;
+  }
+
+  bool ReadVertices(std::shared_ptr<DlVertices>* vertices) {
+    DlVertexMode mode;
+    int32_t vertex_count;
+    int32_t index_count;
+    uint8_t has_texture_coordinates;
+    uint8_t has_colors;
+    if (!Read(&mode) || !Read(&vertex_count) || !Read(&index_count) ||
+        !Read(&has_texture_coordinates) || !Read(&has_colors) ||
+        vertex_count < 0 || index_count < 0) {
+      return false;
+    }
+    std::vector<SkPoint> points;
+    std::vector<SkPoint> texture_coordinates;
+    std::vector<DlColor> colors;
+    std::vector<uint16_t> indices;
+    if (!ReadArray(points, vertex_count) ||
+        (has_texture_coordinates &&
+         !ReadArray(texture_coordinates, vertex_count)) ||
+        (has_colors && !ReadArray(colors, vertex_count)) ||
+        !ReadArray(indices, index_count)) {
+      return false;
+    }
+    *vertices = DlVertices::Make(
+        mode, vertex_count, points.data(),
+        has_texture_coordinates ? texture_coordinates.data() : nullptr,
+        has_colors ? colors.data() : nullptr, index_count,
+        index_count > 0 ? indices.data() : nullptr);
+    return true;
+  }
+
+  bool ReadTextBlob(sk_sp<SkTextBlob>* blob) {
+    uint32_t size;
+    if (!Read(&size)) {
+      return false;
+    }
+    const uint8_t* bytes = ReadBytes(size);
+    if (!bytes) {
+      return false;
+    }
+    *blob = SkTextBlob::Deserialize(bytes, size, SkDeserialProcs());
+    return *blob != nullptr;
+  }
+
+ private:
+  const uint8_t* data_;
+  size_t size_;
+  size_t position_ = 0u;
+  std::shared_ptr<const fml::Mapping> mapping_;
+  std::vector<sk_sp<DlImage>> images_;
+
+  // Scratch space for the most recently read gradient.
+  DlTileMode tile_mode_;
+  DlMatrix matrix_;
+  std::vector<DlColor> colors_;
+  std::vector<float> stops_;
+
+  static const DlMatrix* MatrixPtr(const DlMatrix& matrix) {
+    return matrix.IsIdentity() ? nullptr : &matrix;
+  }
+
+  bool ReadGradient() {
+    uint32_t stop_count;
+    return Read(&tile_mode_) && Read(&matrix_) && Read(&stop_count) &&
+           ReadArray(colors_, stop_count) && ReadArray(stops_, stop_count);
+  }
+
+  bool ReadRuntimeEffect(
+      sk_sp<DlRuntimeEffect>* runtime_effect,
+      std::vector<std::shared_ptr<DlColorSource>>* samplers,
+      std::shared_ptr<std::vector<uint8_t>>* uniform_data) {
+    uint32_t source_size;
+    if (!Read(&source_size)) {
+      return false;
+    }
+    const uint8_t* source = ReadBytes(source_size);
+    if (!source) {
+      return false;
+    }
+    auto result = SkRuntimeEffect::MakeForShader(
+        SkString(reinterpret_cast<const char*>(source), source_size));
+    if (!result.effect) {
+      FML_LOG(ERROR) << "Could not compile serialized runtime effect: "
+                     << result.errorText.c_str();
+      return false;
+    }
+    *runtime_effect = DlRuntimeEffect::MakeSkia(result.effect);
+
+    uint32_t sampler_count;
+    if (!Read(&sampler_count)) {
+      return false;
+    }
+    for (uint32_t i = 0; i < sampler_count; i++) {
+      std::shared_ptr<DlColorSource> sampler;
+      if (!ReadColorSource(&sampler)) {
+        return false;
+      }
+      samplers->push_back(std::move(sampler));
+    }
+
+    uint32_t uniform_size;
+    if (!Read(&uniform_size)) {
+      return false;
+    }
+    auto uniforms = std::make_shared<std::vector<uint8_t>>();
+    if (!ReadArray(*uniforms, uniform_size)) {
+      return false;
+    }
+    *uniform_data = std::move(uniforms);
+    return true;
+  }
+
+  sk_sp<SkData> WrapPixels(const uint8_t* pixels, size_t size) {
+    if (!mapping_) {
+      return SkData::MakeWithCopy(pixels, size);
+    }
+    auto context = new std::shared_ptr<const fml::Mapping>(mapping_);
+    return SkData::MakeWithProc(
+        pixels, size,
+        [](const void* ptr, void* context) {
+          delete reinterpret_cast<std::shared_ptr<const fml::Mapping>*>(
+              context);
+        },
+        context);
+  }
+};
+
+//------------------------------------------------------------------------------
+/// Constructs op records in a |DisplayListStorage| the same way that the
+/// |DisplayListBuilder| does, but without any of the bounds or attribute
+/// tracking.
+class DisplayListSerializer::RecordSink {
+ public:
+  explicit RecordSink(size_t expected_record_count)
+      : expected_record_count_(expected_record_count) {}
+
+  ~RecordSink() { DisplayList::DisposeOps(storage_, offsets_); }
+
+  template <typename T, typename... Args>
+  void* Push(size_t pod, Args&&... args) {
+    size_t size = SkAlignPtr(sizeof(T) + pod);
+    offsets_.push_back(storage_.size());
+    auto op = reinterpret_cast<T*>(storage_.allocate(size));
+    new (op) T{std::forward<Args>(args)...};
+    return op + 1;
+  }
+
+  uint8_t* PushVerbatim(const uint8_t* record, size_t size) {
+    offsets_.push_back(storage_.size());
+    uint8_t* ptr = storage_.allocate(size);
+    memcpy(ptr, record, size);
+    return ptr;
+  }
+
+  // The restore index of a save record that is about to be pushed must
+  // refer to a later record in the same DisplayList.
+  bool CheckRestoreIndex(DlIndex restore_index) const {
+    return restore_index > offsets_.size() &&
+           restore_index < expected_record_count_;
+  }
+
+  DisplayListStorage TakeStorage() {
+    storage_.trim();
+    return std::move(storage_);
+  }
+
+  std::vector<size_t> TakeOffsets() { return std::move(offsets_); }
+
+ private:
+  const size_t expected_record_count_;
+  DisplayListStorage storage_;
+  std::vector<size_t> offsets_;
+};
+
+uint32_t DisplayListSerializer::LayoutSignature() {
+  // FNV-1a over the size and alignment of every op record so that any
+  // change to the layout of the records invalidates previously written
+  // files.
+  uint32_t hash = 2166136261u;
+  auto mix = [&hash](uint32_t value) {
+    hash = (hash ^ value) * 16777619u;
+  };
+  mix(sizeof(void*));
+  mix(kVersion);
+#define DL_OP_LAYOUT(name)                                  \
+  mix(static_cast<uint32_t>(DisplayListOpType::k##name));   \
+  mix(sizeof(name##Op));                                    \
+  mix(alignof(name##Op));
+
+  FOR_EACH_DISPLAY_LIST_OP(DL_OP_LAYOUT)
+
+#undef DL_OP_LAYOUT
+  return hash;
+}
+
+std::unique_ptr<fml::Mapping> DisplayListSerializer::Serialize(
+    const DisplayList& display_list) {
+  TRACE_EVENT0("flutter", "DisplayListSerializer::Serialize");
+  Writer writer;
+  if (!Encode(writer, display_list)) {
+    return nullptr;
+  }
+  return std::make_unique<fml::DataMapping>(writer.Take());
+}
+
+bool DisplayListSerializer::Encode(Writer& writer,
+                                   const DisplayList& display_list) {
+  size_t header_position = writer.position();
+  FML_DCHECK(header_position == 0u);
+  writer.Write(SerializedHeader{});
+
+  const DisplayListStorage& storage = display_list.storage_;
+  const std::vector<size_t>& offsets = display_list.offsets_;
+  for (size_t i = 0; i < offsets.size(); i++) {
+    size_t start = offsets[i];
+    size_t end = i + 1 < offsets.size() ? offsets[i + 1] : storage.size();
+    if (!EncodeRecord(writer, storage.base() + start, end - start)) {
+      return false;
+    }
+  }
+
+  writer.Align(kRecordAlignment);
+  uint64_t images_offset = writer.position();
+  if (!writer.WriteImages()) {
+    return false;
+  }
+
+  writer.Align(kRecordAlignment);
+  uint64_t rtree_offset = writer.position();
+  uint32_t rtree_leaf_count = 0u;
+  const sk_sp<const DlRTree>& rtree = display_list.rtree_;
+  if (rtree) {
+    rtree_leaf_count = rtree->leaf_count();
+    for (int i = 0; i < rtree->leaf_count(); i++) {
+      writer.Write(rtree->bounds(i));
+    }
+    for (int i = 0; i < rtree->leaf_count(); i++) {
+      writer.Write<int32_t>(rtree->id(i));
+    }
+  }
+
+  uint32_t flags = 0u;
+  flags |= display_list.can_apply_group_opacity_ ? kCanApplyGroupOpacity : 0u;
+  flags |= display_list.is_ui_thread_safe_ ? kIsUIThreadSafe : 0u;
+  flags |= display_list.modifies_transparent_black_ ? kModifiesTransparentBlack
+                                                    : 0u;
+  flags |= display_list.root_has_backdrop_filter_ ? kRootHasBackdropFilter : 0u;
+  flags |= display_list.root_is_unbounded_ ? kRootIsUnbounded : 0u;
+  flags |= rtree ? kHasRTree : 0u;
+
+  writer.Align(kPixelAlignment);
+  SerializedHeader header = {
+      .magic = kMagic,
+      .version = kVersion,
+      .layout_signature = LayoutSignature(),
+      .flags = flags,
+      .total_size = writer.position(),
+      .storage_size = storage.size(),
+      .nested_byte_count = display_list.nested_byte_count_,
+      .images_offset = images_offset,
+      .rtree_offset = rtree_offset,
+      .record_count = static_cast<uint32_t>(offsets.size()),
+      .op_count = display_list.op_count_,
+      .nested_op_count = display_list.nested_op_count_,
+      .total_depth = display_list.total_depth_,
+      .image_count = static_cast<uint32_t>(writer.image_count()),
+      .rtree_leaf_count = rtree_leaf_count,
+      .max_root_blend_mode =
+          static_cast<uint32_t>(display_list.max_root_blend_mode_),
+      .reserved = 0u,
+      .bounds = display_list.bounds_,
+  };
+  writer.Patch(header_position, header);
+  return true;
+}
+
+bool DisplayListSerializer::EncodeRecord(Writer& writer,
+                                         const uint8_t* record,
+                                         size_t record_size) {
+  auto op = reinterpret_cast<const DLOp*>(record);
+
+  writer.Align(kRecordAlignment);
+  size_t header_position = writer.position();
+  writer.Write(SerializedRecordHeader{static_cast<uint32_t>(op->type), 0u});
+  size_t payload_start = writer.position();
+
+  if (IsVerbatim(op->type)) {
+    writer.WriteBytes(record, record_size);
+  } else {
+    switch (op->type) {
+      case DisplayListOpType::kSetPodColorFilter: {
+        auto filter = reinterpret_cast<const DlColorFilter*>(
+            static_cast<const SetPodColorFilterOp*>(op) + 1);
+        writer.WriteColorFilter(filter);
+        break;
+      }
+      case DisplayListOpType::kSetPodColorSource: {
+        auto source = reinterpret_cast<const DlColorSource*>(
+            static_cast<const SetPodColorSourceOp*>(op) + 1);
+        if (!writer.WriteColorSource(source)) {
+          return false;
+        }
+        break;
+      }
+      case DisplayListOpType::kSetImageColorSource: {
+        auto set_op = static_cast<const SetImageColorSourceOp*>(op);
+        if (!writer.WriteColorSource(&set_op->source)) {
+          return false;
+        }
+        break;
+      }
+      case DisplayListOpType::kSetRuntimeEffectColorSource: {
+        auto set_op = static_cast<const SetRuntimeEffectColorSourceOp*>(op);
+        if (!writer.WriteColorSource(&set_op->source)) {
+          return false;
+        }
+        break;
+      }
+      case DisplayListOpType::kSetPodImageFilter: {
+        auto filter = reinterpret_cast<const DlImageFilter*>(
+            static_cast<const SetPodImageFilterOp*>(op) + 1);
+        if (!writer.WriteImageFilter(filter)) {
+          return false;
+        }
+        break;
+      }
+      case DisplayListOpType::kSetSharedImageFilter: {
+        auto set_op = static_cast<const SetSharedImageFilterOp*>(op);
+        if (!writer.WriteImageFilter(set_op->filter.get())) {
+          return false;
+        }
+        break;
+      }
+      case DisplayListOpType::kSetPodMaskFilter: {
+        auto filter = reinterpret_cast<const DlMaskFilter*>(
+            static_cast<const SetPodMaskFilterOp*>(op) + 1);
+        writer.WriteMaskFilter(filter);
+        break;
+      }
+      case DisplayListOpType::kSaveLayerBackdrop: {
+        auto save_op = static_cast<const SaveLayerBackdropOp*>(op);
+        writer.Write(save_op->options);
+        writer.Write(save_op->restore_index);
+        writer.Write(save_op->total_content_depth);
+        writer.Write(save_op->rect);
+        writer.Write(save_op->max_blend_mode);
+        writer.Write<uint8_t>(save_op->backdrop_id_.has_value());
+        writer.Write<int64_t>(save_op->backdrop_id_.value_or(0));
+        if (!writer.WriteImageFilter(save_op->backdrop.get())) {
+          return false;
+        }
+        break;
+      }
+      case DisplayListOpType::kClipIntersectPath: {
+        auto clip_op = static_cast<const ClipIntersectPathOp*>(op);
+        writer.Write<uint8_t>(clip_op->is_aa);
+        writer.WritePath(clip_op->path);
+        break;
+      }
+      case DisplayListOpType::kClipDifferencePath: {
+        auto clip_op = static_cast<const ClipDifferencePathOp*>(op);
+        writer.Write<uint8_t>(clip_op->is_aa);
+        writer.WritePath(clip_op->path);
+        break;
+      }
+      case DisplayListOpType::kDrawPath: {
+        writer.WritePath(static_cast<const DrawPathOp*>(op)->path);
+        break;
+      }
+      case DisplayListOpType::kDrawVertices: {
+        auto draw_op = static_cast<const DrawVerticesOp*>(op);
+        writer.Write(draw_op->mode);
+        writer.WriteVertices(draw_op->vertices.get());
+        break;
+      }
+      case DisplayListOpType::kDrawImage:
+      case DisplayListOpType::kDrawImageWithAttr: {
+        // Both variants share the same layout.
+        static_assert(sizeof(DrawImageOp) == sizeof(DrawImageWithAttrOp));
+        auto draw_op = reinterpret_cast<const DrawImageOp*>(op);
+        writer.Write(draw_op->point);
+        writer.Write(draw_op->sampling);
+        if (!writer.WriteImage(draw_op->image.get())) {
+          return false;
+        }
+        break;
+      }
+      case DisplayListOpType::kDrawImageRect: {
+        auto draw_op = static_cast<const DrawImageRectOp*>(op);
+        writer.Write(draw_op->src);
+        writer.Write(draw_op->dst);
+        writer.Write(draw_op->sampling);
+        writer.Write<uint8_t>(draw_op->render_with_attributes);
+        writer.Write(draw_op->constraint);
+        if (!writer.WriteImage(draw_op->image.get())) {
+          return false;
+        }
+        break;
+      }
+      case DisplayListOpType::kDrawImageNine:
+      case DisplayListOpType::kDrawImageNineWithAttr: {
+        static_assert(sizeof(DrawImageNineOp) ==
+                      sizeof(DrawImageNineWithAttrOp));
+        auto draw_op = reinterpret_cast<const DrawImageNineOp*>(op);
+        writer.Write(draw_op->center);
+        writer.Write(draw_op->dst);
+        writer.Write(draw_op->mode);
+        if (!writer.WriteImage(draw_op->image.get())) {
+          return false;
+        }
+        break;
+      }
+      case DisplayListOpType::kDrawAtlas:
+      case DisplayListOpType::kDrawAtlasCulled: {
+        auto draw_op = static_cast<const DrawAtlasBaseOp*>(op);
+        size_t op_size;
+        if (op->type == DisplayListOpType::kDrawAtlasCulled) {
+          writer.Write(static_cast<const DrawAtlasCulledOp*>(op)->cull_rect);
+          op_size = sizeof(DrawAtlasCulledOp);
+        } else {
+          op_size = sizeof(DrawAtlasOp);
+        }
+        writer.Write<int32_t>(draw_op->count);
+        writer.Write(draw_op->mode_index);
+        writer.Write(draw_op->has_colors);
+        writer.Write(draw_op->render_with_attributes);
+        writer.Write(draw_op->sampling);
+        if (!writer.WriteImage(draw_op->atlas.get())) {
+          return false;
+        }
+        // The xform, tex, and color arrays follow the op in the record.
+        size_t array_bytes =
+            draw_op->count * (sizeof(SkRSXform) + sizeof(DlRect));
+        if (draw_op->has_colors) {
+          array_bytes += draw_op->count * sizeof(DlColor);
+        }
+        FML_DCHECK(op_size + array_bytes <= record_size);
+        writer.Write<uint32_t>(array_bytes);
+        writer.WriteBytes(record + op_size, array_bytes);
+        break;
+      }
+      case DisplayListOpType::kDrawDisplayList: {
+        auto draw_op = static_cast<const DrawDisplayListOp*>(op);
+        writer.Write(draw_op->opacity);
+        Writer nested_writer;
+        if (!Encode(nested_writer, *draw_op->display_list)) {
+          return false;
+        }
+        std::vector<uint8_t> nested = nested_writer.Take();
+        writer.Write<uint64_t>(nested.size());
+        // Keep the nested image data aligned for zero-copy loading.
+        writer.Align(kPixelAlignment);
+        writer.WriteBytes(nested.data(), nested.size());
+        break;
+      }
+      case DisplayListOpType::kDrawTextBlob: {
+        auto draw_op = static_cast<const DrawTextBlobOp*>(op);
+        writer.Write(draw_op->x);
+        writer.Write(draw_op->y);
+        writer.WriteTextBlob(draw_op->blob.get());
+        break;
+      }
+      case DisplayListOpType::kDrawShadow:
+      case DisplayListOpType::kDrawShadowTransparentOccluder: {
+        static_assert(sizeof(DrawShadowOp) ==
+                      sizeof(DrawShadowTransparentOccluderOp));
+        auto draw_op = reinterpret_cast<const DrawShadowOp*>(op);
+        writer.Write(draw_op->color);
+        writer.Write(draw_op->elevation);
+        writer.Write(draw_op->dpr);
+        writer.WritePath(draw_op->path);
+        break;
+      }
+      case DisplayListOpType::kDrawTextFrame:
+        FML_LOG(ERROR) << "DisplayList serialization does not support "
+                          "Impeller text frames";
+        return false;
+      default:
+        FML_DCHECK(false) << "Unexpected op type in serialization: "
+                          << static_cast<int>(op->type);
+        return false;
+    }
+  }
+
+  size_t payload_size = writer.position() - payload_start;
+  writer.Patch(header_position,
+               SerializedRecordHeader{static_cast<uint32_t>(op->type),
+                                      static_cast<uint32_t>(payload_size)});
+  return true;
+}
+
+sk_sp<DisplayList> DisplayListSerializer::Deserialize(
+    const std::shared_ptr<const fml::Mapping>& mapping) {
+  TRACE_EVENT0("flutter", "DisplayListSerializer::Deserialize");
+  if (!mapping || !mapping->GetMapping()) {
+    return nullptr;
+  }
+  Reader reader(mapping->GetMapping(), mapping->GetSize(), mapping);
+  return Decode(reader);
+}
+
+sk_sp<DisplayList> DisplayListSerializer::Decode(Reader& reader) {
+  SerializedHeader header;
+  if (!reader.Read(&header) || header.magic != kMagic) {
+    return nullptr;
+  }
+  if (header.version != kVersion ||
+      header.layout_signature != LayoutSignature()) {
+    FML_LOG(ERROR) << "Serialized DisplayList was written by an incompatible "
+                      "engine";
+    return nullptr;
+  }
+  if (header.total_size > reader.size() ||
+      header.max_root_blend_mode >
+          static_cast<uint32_t>(DlBlendMode::kLastMode)) {
+    return nullptr;
+  }
+
+  // The image table must be loaded before any record that refers to it.
+  size_t records_start = reader.position();
+  if (!reader.Seek(header.images_offset) ||
+      !reader.ReadImages(header.image_count) || !reader.Seek(records_start)) {
+    return nullptr;
+  }
+
+  RecordSink sink(header.record_count);
+  for (uint32_t i = 0; i < header.record_count; i++) {
+    SerializedRecordHeader record;
+    if (!reader.Align(kRecordAlignment) || !reader.Read(&record) ||
+        record.type >= static_cast<uint32_t>(DisplayListOpType::kMaxOp)) {
+      return nullptr;
+    }
+    size_t payload_start = reader.position();
+    if (record.payload_size > reader.size() - payload_start ||
+        !DecodeRecord(reader, sink,
+                      static_cast<DisplayListOpType>(record.type),
+                      record.payload_size) ||
+        reader.position() > payload_start + record.payload_size ||
+        !reader.Seek(payload_start + record.payload_size)) {
+      return nullptr;
+    }
+  }
+
+  sk_sp<DlRTree> rtree;
+  if (header.flags & kHasRTree) {
+    std::vector<SkRect> rects;
+    std::vector<int32_t> ids;
+    if (!reader.Seek(header.rtree_offset) ||
+        !reader.ReadArray(rects, header.rtree_leaf_count) ||
+        !reader.ReadArray(ids, header.rtree_leaf_count)) {
+      return nullptr;
+    }
+    for (int32_t id : ids) {
+      if (id < 0 || static_cast<uint32_t>(id) >= header.record_count) {
+        return nullptr;
+      }
+    }
+    rtree = sk_make_sp<DlRTree>(rects.data(), rects.size(), ids.data(),
+                                [](int id) { return id >= 0; });
+  }
+
+  if (!reader.Seek(header.total_size)) {
+    return nullptr;
+  }
+
+  return sk_sp<DisplayList>(new DisplayList(
+      sink.TakeStorage(), sink.TakeOffsets(), header.op_count,
+      header.nested_byte_count, header.nested_op_count, header.total_depth,
+      header.bounds, header.flags & kCanApplyGroupOpacity,
+      header.flags & kIsUIThreadSafe, header.flags & kModifiesTransparentBlack,
+      static_cast<DlBlendMode>(header.max_root_blend_mode),
+      header.flags & kRootHasBackdropFilter, header.flags & kRootIsUnbounded,
+      std::move(rtree)));
+}
+
+bool DisplayListSerializer::DecodeRecord(Reader& reader,
+                                         RecordSink& sink,
+                                         DisplayListOpType type,
+                                         size_t payload_size) {
+  if (IsVerbatim(type)) {
+    if (payload_size < RecordSize(type) ||
+        payload_size % kRecordAlignment != 0u) {
+      return false;
+    }
+    // The record is validated before it is copied into the storage so
+    // that a malformed record is never seen by |DisplayList::DisposeOps|.
+    // Records are aligned relative to the start of the data, which is
+    // itself at least pointer aligned, so they can be inspected in place.
+    const uint8_t* record = reader.ReadBytes(payload_size);
+    auto op = reinterpret_cast<const DLOp*>(record);
+    if (op->type != type) {
+      return false;
+    }
+    switch (type) {
+      case DisplayListOpType::kDrawPoints:
+      case DisplayListOpType::kDrawLines:
+      case DisplayListOpType::kDrawPolygon: {
+        // All three point ops share the same layout.
+        uint32_t count = reinterpret_cast<const DrawPointsOp*>(op)->count;
+        if (count > (payload_size - sizeof(DrawPointsOp)) / sizeof(DlPoint)) {
+          return false;
+        }
+        break;
+      }
+      case DisplayListOpType::kSave:
+      case DisplayListOpType::kSaveLayer: {
+        DlIndex restore_index =
+            static_cast<const SaveOpBase*>(op)->restore_index;
+        if (!sink.CheckRestoreIndex(restore_index)) {
+          return false;
+        }
+        break;
+      }
+      case DisplayListOpType::kSetStyle:
+        if (!IsValidEnum(static_cast<const SetStyleOp*>(op)->style)) {
+          return false;
+        }
+        break;
+      case DisplayListOpType::kSetStrokeCap:
+        if (!IsValidEnum(static_cast<const SetStrokeCapOp*>(op)->value)) {
+          return false;
+        }
+        break;
+      case DisplayListOpType::kSetStrokeJoin:
+        if (!IsValidEnum(static_cast<const SetStrokeJoinOp*>(op)->value)) {
+          return false;
+        }
+        break;
+      case DisplayListOpType::kSetBlendMode:
+        if (!IsValidEnum(static_cast<const SetBlendModeOp*>(op)->mode)) {
+          return false;
+        }
+        break;
+      case DisplayListOpType::kDrawColor:
+        if (!IsValidEnum(static_cast<const DrawColorOp*>(op)->mode)) {
+          return false;
+        }
+        break;
+      default:
+        break;
+    }
+    sink.PushVerbatim(record, payload_size);
+    return true;
+  }
+
+  switch (type) {
+    case DisplayListOpType::kSetPodColorFilter: {
+      std::shared_ptr<const DlColorFilter> filter;
+      if (!reader.ReadColorFilter(&filter) || !filter) {
+        return false;
+      }
+      void* pod = sink.Push<SetPodColorFilterOp>(filter->size());
+      switch (filter->type()) {
+        case DlColorFilterType::kBlend:
+          new (pod) DlBlendColorFilter(filter->asBlend());
+          break;
+        case DlColorFilterType::kMatrix:
+          new (pod) DlMatrixColorFilter(filter->asMatrix());
+          break;
+        case DlColorFilterType::kSrgbToLinearGamma:
+          new (pod) DlSrgbToLinearGammaColorFilter();
+          break;
+        case DlColorFilterType::kLinearToSrgbGamma:
+          new (pod) DlLinearToSrgbGammaColorFilter();
+          break;
+      }
+      return true;
+    }
+    case DisplayListOpType::kSetPodColorSource: {
+      std::shared_ptr<DlColorSource> source;
+      if (!reader.ReadColorSource(&source) || !source) {
+        return false;
+      }
+      switch (source->type()) {
+        case DlColorSourceType::kLinearGradient:
+          new (sink.Push<SetPodColorSourceOp>(source->size()))
+              DlLinearGradientColorSource(source->asLinearGradient());
+          return true;
+        case DlColorSourceType::kRadialGradient:
+          new (sink.Push<SetPodColorSourceOp>(source->size()))
+              DlRadialGradientColorSource(source->asRadialGradient());
+          return true;
+        case DlColorSourceType::kConicalGradient:
+          new (sink.Push<SetPodColorSourceOp>(source->size()))
+              DlConicalGradientColorSource(source->asConicalGradient());
+          return true;
+        case DlColorSourceType::kSweepGradient:
+          new (sink.Push<SetPodColorSourceOp>(source->size()))
+              DlSweepGradientColorSource(source->asSweepGradient());
+          return true;
+        case DlColorSourceType::kImage:
+        case DlColorSourceType::kRuntimeEffect:
+          return false;
+      }
+      return false;
+    }
+    case DisplayListOpType::kSetImageColorSource: {
+      std::shared_ptr<DlColorSource> source;
+      if (!reader.ReadColorSource(&source) || !source || !source->asImage()) {
+        return false;
+      }
+      sink.Push<SetImageColorSourceOp>(0, source->asImage());
+      return true;
+    }
+    case DisplayListOpType::kSetRuntimeEffectColorSource: {
+      std::shared_ptr<DlColorSource> source;
+      if (!reader.ReadColorSource(&source) || !source ||
+          !source->asRuntimeEffect()) {
+        return false;
+      }
+      sink.Push<SetRuntimeEffectColorSourceOp>(0, source->asRuntimeEffect());
+      return true;
+    }
+    case DisplayListOpType::kSetPodImageFilter: {
+      std::shared_ptr<DlImageFilter> filter;
+      if (!reader.ReadImageFilter(&filter) || !filter) {
+        return false;
+      }
+      switch (filter->type()) {
+        case DlImageFilterType::kBlur:
+          new (sink.Push<SetPodImageFilterOp>(filter->size()))
+              DlBlurImageFilter(filter->asBlur());
+          return true;
+        case DlImageFilterType::kDilate:
+          new (sink.Push<SetPodImageFilterOp>(filter->size()))
+              DlDilateImageFilter(filter->asDilate());
+          return true;
+        case DlImageFilterType::kErode:
+          new (sink.Push<SetPodImageFilterOp>(filter->size()))
+              DlErodeImageFilter(filter->asErode());
+          return true;
+        case DlImageFilterType::kMatrix:
+          new (sink.Push<SetPodImageFilterOp>(filter->size()))
+              DlMatrixImageFilter(filter->asMatrix());
+          return true;
+        default:
+          return false;
+      }
+    }
+    case DisplayListOpType::kSetSharedImageFilter: {
+      std::shared_ptr<DlImageFilter> filter;
+      if (!reader.ReadImageFilter(&filter) || !filter) {
+        return false;
+      }
+      sink.Push<SetSharedImageFilterOp>(0, filter.get());
+      return true;
+    }
+    case DisplayListOpType::kSetPodMaskFilter: {
+      std::shared_ptr<DlBlurMaskFilter> filter;
+      if (!reader.ReadMaskFilter(&filter)) {
+        return false;
+      }
+      new (sink.Push<SetPodMaskFilterOp>(filter->size()))
+          DlBlurMaskFilter(filter.get());
+      return true;
+    }
+    case DisplayListOpType::kSaveLayerBackdrop: {
+      SaveLayerOptions options;
+      DlIndex restore_index;
+      uint32_t total_content_depth;
+      DlRect rect;
+      DlBlendMode max_blend_mode;
+      uint8_t has_backdrop_id;
+      int64_t backdrop_id;
+      std::shared_ptr<DlImageFilter> backdrop;
+      if (!reader.Read(&options) || !reader.Read(&restore_index) ||
+          !reader.Read(&total_content_depth) || !reader.Read(&rect) ||
+          !reader.Read(&max_blend_mode) || !reader.Read(&has_backdrop_id) ||
+          !reader.Read(&backdrop_id) || !reader.ReadImageFilter(&backdrop) ||
+          !backdrop || !sink.CheckRestoreIndex(restore_index)) {
+        return false;
+      }
+      auto op = reinterpret_cast<SaveLayerBackdropOp*>(
+                    sink.Push<SaveLayerBackdropOp>(
+                        0, options, rect, backdrop.get(),
+                        has_backdrop_id ? std::optional<int64_t>(backdrop_id)
+                                        : std::nullopt)) -
+                1;
+      op->restore_index = restore_index;
+      op->total_content_depth = total_content_depth;
+      op->max_blend_mode = max_blend_mode;
+      return true;
+    }
+    case DisplayListOpType::kClipIntersectPath:
+    case DisplayListOpType::kClipDifferencePath: {
+      uint8_t is_aa;
+      DlPath path;
+      if (!reader.Read(&is_aa) || !reader.ReadPath(&path)) {
+        return false;
+      }
+      if (type == DisplayListOpType::kClipIntersectPath) {
+        sink.Push<ClipIntersectPathOp>(0, path, is_aa != 0);
+      } else {
+        sink.Push<ClipDifferencePathOp>(0, path, is_aa != 0);
+      }
+      return true;
+    }
+    case DisplayListOpType::kDrawPath: {
+      DlPath path;
+      if (!reader.ReadPath(&path)) {
+        return false;
+      }
+      sink.Push<DrawPathOp>(0, path);
+      return true;
+    }
+    case DisplayListOpType::kDrawVertices: {
+      DlBlendMode mode;
+      std::shared_ptr<DlVertices> vertices;
+      if (!reader.Read(&mode) || !reader.ReadVertices(&vertices)) {
+        return false;
+      }
+      sink.Push<DrawVerticesOp>(0, vertices, mode);
+      return true;
+    }
+    case DisplayListOpType::kDrawImage:
+    case DisplayListOpType::kDrawImageWithAttr: {
+      DlPoint point;
+      DlImageSampling sampling;
+      sk_sp<DlImage> image;
+      if (!reader.Read(&point) || !reader.Read(&sampling) ||
+          !reader.ReadImage(&image) || !image) {
+        return false;
+      }
+      if (type == DisplayListOpType::kDrawImageWithAttr) {
+        sink.Push<DrawImageWithAttrOp>(0, image, point, sampling);
+      } else {
+        sink.Push<DrawImageOp>(0, image, point, sampling);
+      }
+      return true;
+    }
+    case DisplayListOpType::kDrawImageRect: {
+      DlRect src;
+      DlRect dst;
+      DlImageSampling sampling;
+      uint8_t render_with_attributes;
+      DlCanvas::SrcRectConstraint constraint;
+      sk_sp<DlImage> image;
+      if (!reader.Read(&src) || !reader.Read(&dst) || !reader.Read(&sampling) ||
+          !reader.Read(&render_with_attributes) || !reader.Read(&constraint) ||
+          !reader.ReadImage(&image) || !image) {
+        return false;
+      }
+      sink.Push<DrawImageRectOp>(0, image, src, dst, sampling,
+                                 render_with_attributes != 0, constraint);
+      return true;
+    }
+    case DisplayListOpType::kDrawImageNine:
+    case DisplayListOpType::kDrawImageNineWithAttr: {
+      DlIRect center;
+      DlRect dst;
+      DlFilterMode mode;
+      sk_sp<DlImage> image;
+      if (!reader.Read(&center) || !reader.Read(&dst) || !reader.Read(&mode) ||
+          !reader.ReadImage(&image) || !image) {
+        return false;
+      }
+      if (type == DisplayListOpType::kDrawImageNineWithAttr) {
+        sink.Push<DrawImageNineWithAttrOp>(0, image, center, dst, mode);
+      } else {
+        sink.Push<DrawImageNineOp>(0, image, center, dst, mode);
+      }
+      return true;
+    }
+    case DisplayListOpType::kDrawAtlas:
+    case DisplayListOpType::kDrawAtlasCulled: {
+      DlRect cull_rect;
+      int32_t count;
+      uint16_t mode_index;
+      uint8_t has_colors;
+      uint8_t render_with_attributes;
+      DlImageSampling sampling;
+      sk_sp<DlImage> atlas;
+      uint32_t array_bytes;
+      if ((type == DisplayListOpType::kDrawAtlasCulled &&
+           !reader.Read(&cull_rect)) ||
+          !reader.Read(&count) || !reader.Read(&mode_index) ||
+          !reader.Read(&has_colors) || !reader.Read(&render_with_attributes) ||
+          !reader.Read(&sampling) || !reader.ReadImage(&atlas) || !atlas ||
+          !reader.Read(&array_bytes) || count < 0 ||
+          mode_index > static_cast<uint16_t>(DlBlendMode::kLastMode)) {
+        return false;
+      }
+      size_t expected_bytes = count * (sizeof(SkRSXform) + sizeof(DlRect));
+      if (has_colors) {
+        expected_bytes += count * sizeof(DlColor);
+      }
+      const uint8_t* arrays = reader.ReadBytes(array_bytes);
+      if (!arrays || array_bytes != expected_bytes) {
+        return false;
+      }
+      DlBlendMode mode = static_cast<DlBlendMode>(mode_index);
+      void* pod;
+      if (type == DisplayListOpType::kDrawAtlasCulled) {
+        pod = sink.Push<DrawAtlasCulledOp>(array_bytes, atlas, count, mode,
+                                           sampling, has_colors != 0,
+                                           cull_rect,
+                                           render_with_attributes != 0);
+      } else {
+        pod = sink.Push<DrawAtlasOp>(array_bytes, atlas, count, mode, sampling,
+                                     has_colors != 0,
+                                     render_with_attributes != 0);
+      }
+      memcpy(pod, arrays, array_bytes);
+      return true;
+    }
+    case DisplayListOpType::kDrawDisplayList: {
+      DlScalar opacity;
+      uint64_t nested_size;
+      if (!reader.Read(&opacity) || !reader.Read(&nested_size) ||
+          !reader.Align(kPixelAlignment)) {
+        return false;
+      }
+      const uint8_t* nested_bytes = reader.ReadBytes(nested_size);
+      if (!nested_bytes) {
+        return false;
+      }
+      Reader nested_reader(nested_bytes, nested_size, reader.mapping());
+      sk_sp<DisplayList> display_list = Decode(nested_reader);
+      if (!display_list) {
+        return false;
+      }
+      sink.Push<DrawDisplayListOp>(0, display_list, opacity);
+      return true;
+    }
+    case DisplayListOpType::kDrawTextBlob: {
+      DlScalar x;
+      DlScalar y;
+      sk_sp<SkTextBlob> blob;
+      if (!reader.Read(&x) || !reader.Read(&y) || !reader.ReadTextBlob(&blob)) {
+        return false;
+      }
+      sink.Push<DrawTextBlobOp>(0, blob, x, y);
+      return true;
+    }
+    case DisplayListOpType::kDrawShadow:
+    case DisplayListOpType::kDrawShadowTransparentOccluder: {
+      DlColor color;
+      DlScalar elevation;
+      DlScalar dpr;
+      DlPath path;
+      if (!reader.Read(&color) || !reader.Read(&elevation) ||
+          !reader.Read(&dpr) || !reader.ReadPath(&path)) {
+        return false;
+      }
+      if (type == DisplayListOpType::kDrawShadowTransparentOccluder) {
+        sink.Push<DrawShadowTransparentOccluderOp>(0, path, color, elevation,
+                                                   dpr);
+      } else {
+        sink.Push<DrawShadowOp>(0, path, color, elevation, dpr);
+      }
+      return true;
+    }
+    default:
+      return false;
+  }
+}
+
+bool DisplayListSerializer::WriteToFile(const DisplayList& display_list,
+                                        const fml::UniqueFD& base_directory,
+                                        const std::string& file_name) {
+  std::unique_ptr<fml::Mapping> mapping = Serialize(display_list);
+  if (!mapping) {
+    return false;
+  }
+  return fml::WriteAtomically(base_directory, file_name.c_str(), *mapping);
+}
+
+sk_sp<DisplayList> DisplayListSerializer::ReadFromFile(
+    const fml::UniqueFD& base_directory,
+    const std::string& file_name) {
+  std::shared_ptr<const fml::Mapping> mapping =
+      fml::FileMapping::CreateReadOnly(base_directory, file_name);
+  if (!mapping) {
+    return nullptr;
+  }
+  return Deserialize(mapping);
+}
+
+}  // namespace flutter
@@ -0,0 +1,125 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_DISPLAY_LIST_DL_SERIALIZER_H_
+#define FLUTTER_DISPLAY_LIST_DL_SERIALIZER_H_
+
+#include <memory>
+#include <string>
+
+#include "flutter/display_list/display_list.h"
+#include "flutter/fml/macros.h"
+#include "flutter/fml/mapping.h"
+#include "flutter/fml/unique_fd.h"
+
+namespace flutter {
+
+//------------------------------------------------------------------------------
+/// @brief      Converts a |DisplayList| to and from a compact, relocatable
+///             binary format that can be stored on disk and memory-mapped
+///             back in through an |fml::FileMapping|.
+///
+/// The format is a header followed by the records of the DisplayList in
+/// the order in which they are stored, followed by the out-of-line data
+/// (pixel data for images and the leaf rectangles of the |DlRTree|).
+///
+/// Records that consist solely of numeric data (which is most of them)
+/// are stored as a verbatim copy of their in-memory representation and
+/// are restored with a single memcpy. Records which hold references to
+/// other objects (paths, images, filters, color sources, vertices, text
+/// blobs and nested DisplayLists) are encoded field by field and the
+/// referenced objects are rebuilt on load. Images are stored once per
+/// DisplayList regardless of how many records refer to them and their
+/// pixels are wrapped in place, without a copy, when the mapping they are
+/// loaded from is retained.
+///
+/// The DisplayList that is produced by |Deserialize| is constructed
+/// directly from the stored records and attributes (bounds, depth, group
+/// opacity, RTree, etc.) rather than being replayed through a
+/// |DisplayListBuilder|, so it dispatches exactly as the original did.
+///
+/// Since the verbatim records depend on the memory layout of the ops in
+/// the engine that wrote them, the header carries a layout signature and
+/// files written by an engine with a different layout are rejected. The
+/// format is meant for capturing and replaying frames with the same engine
+/// build (benchmark harnesses, warm-starting static scenes) and is not an
+/// interchange format.
+///
+/// The following content cannot be serialized and will cause |Serialize|
+/// to fail:
+///   - texture-backed images or images that are only available as an
+///     Impeller texture
+///   - runtime effects that were created from an Impeller |RuntimeStage|
+///   - |DrawTextFrame| records (Impeller text)
+///
+class DisplayListSerializer {
+ public:
+  static constexpr uint32_t kMagic = 0x52534c44;  // "DLSR"
+  static constexpr uint32_t kVersion = 1u;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Encode the indicated DisplayList into a mapping.
+  ///
+  /// @return     The encoded bytes or nullptr if the DisplayList contains
+  ///             content that cannot be serialized.
+  ///
+  static std::unique_ptr<fml::Mapping> Serialize(
+      const DisplayList& display_list);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Decode a DisplayList from the bytes produced by |Serialize|.
+  ///
+  ///             The mapping is retained for as long as any image that was
+  ///             decoded from it is alive so that the pixel data need not be
+  ///             copied out of it.
+  ///
+  /// @return     The decoded DisplayList or nullptr if the data is truncated,
+  ///             malformed, or was written by an incompatible engine.
+  ///
+  static sk_sp<DisplayList> Deserialize(
+      const std::shared_ptr<const fml::Mapping>& mapping);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Serialize the DisplayList and atomically write the result
+  ///             to a file in the indicated directory.
+  ///
+  static bool WriteToFile(const DisplayList& display_list,
+                          const fml::UniqueFD& base_directory,
+                          const std::string& file_name);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Memory-map the indicated file and decode a DisplayList from
+  ///             its contents.
+  ///
+  static sk_sp<DisplayList> ReadFromFile(const fml::UniqueFD& base_directory,
+                                         const std::string& file_name);
+
+  //----------------------------------------------------------------------------
+  /// @brief      A value that identifies the in-memory layout of every op
+  ///             record type used by this engine.
+  ///
+  static uint32_t LayoutSignature();
+
+ private:
+  class Writer;
+  class Reader;
+  class RecordSink;
+
+  static bool Encode(Writer& writer, const DisplayList& display_list);
+  static bool EncodeRecord(Writer& writer,
+                           const uint8_t* record,
+                           size_t record_size);
+
+  static sk_sp<DisplayList> Decode(Reader& reader);
+  static bool DecodeRecord(Reader& reader,
+                           RecordSink& sink,
+                           DisplayListOpType type,
+                           size_t payload_size);
+
+  FML_DISALLOW_IMPLICIT_CONSTRUCTORS(DisplayListSerializer);
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_DISPLAY_LIST_DL_SERIALIZER_H_
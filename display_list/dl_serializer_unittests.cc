@@ -0,0 +1,335 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/display_list/dl_serializer.h"
+
+#include <set>
+
+#include "flutter/display_list/dl_builder.h"
+#include "flutter/display_list/testing/dl_test_snippets.h"
+#include "flutter/display_list/utils/dl_receiver_utils.h"
+#include "flutter/fml/file.h"
+#include "flutter/testing/testing.h"
+
+namespace flutter {
+
+DlOpReceiver& DisplayListBuilderTestingAccessor(DisplayListBuilder& builder);
+
+namespace testing {
+
+namespace {
+
+sk_sp<DisplayList> RoundTrip(const sk_sp<DisplayList>& display_list) {
+  std::shared_ptr<const fml::Mapping> mapping =
+      DisplayListSerializer::Serialize(*display_list);
+  if (!mapping) {
+    return nullptr;
+  }
+  return DisplayListSerializer::Deserialize(mapping);
+}
+
+std::vector<uint8_t> SerializeToVector(const DisplayList& display_list) {
+  std::unique_ptr<fml::Mapping> mapping =
+      DisplayListSerializer::Serialize(display_list);
+  FML_CHECK(mapping);
+  return std::vector<uint8_t>(mapping->GetMapping(),
+                              mapping->GetMapping() + mapping->GetSize());
+}
+
+sk_sp<DisplayList> DeserializeVector(std::vector<uint8_t> data) {
+  return DisplayListSerializer::Deserialize(
+      std::make_shared<fml::DataMapping>(std::move(data)));
+}
+
+// Serializes two display lists that differ only in the value of one enum
+// and replaces that value in the first with one the enum does not define.
+// The enum is the last thing that differs between the two, and it is
+// stored little endian, so its low byte is the last byte that differs.
+std::vector<uint8_t> SerializeWithBadEnum(const DisplayList& display_list,
+                                          const DisplayList& other_value) {
+  std::vector<uint8_t> data = SerializeToVector(display_list);
+  std::vector<uint8_t> other = SerializeToVector(other_value);
+  FML_CHECK(data.size() == other.size());
+  size_t offset = data.size();
+  for (size_t i = 0; i < data.size(); i++) {
+    if (data[i] != other[i]) {
+      offset = i;
+    }
+  }
+  FML_CHECK(offset < data.size());
+  data[offset] = 0x7f;
+  return data;
+}
+
+sk_sp<DisplayList> MakeAllOpsDisplayList() {
+  DisplayListBuilder builder;
+  DlOpReceiver& receiver = DisplayListBuilderTestingAccessor(builder);
+  for (DisplayListInvocationGroup& group : CreateAllGroups()) {
+    for (DisplayListInvocation& invocation : group.variants) {
+      invocation.Invoke(receiver);
+    }
+  }
+  return builder.Build();
+}
+
+}  // namespace
+
+TEST(DisplayListSerializer, EmptyDisplayListRoundTrips) {
+  sk_sp<DisplayList> display_list = DisplayListBuilder().Build();
+  sk_sp<DisplayList> copy = RoundTrip(display_list);
+  ASSERT_NE(copy, nullptr);
+  EXPECT_TRUE(copy->Equals(*display_list));
+  EXPECT_EQ(copy->GetRecordCount(), 0u);
+}
+
+TEST(DisplayListSerializer, SingleOpDisplayListsRoundTrip) {
+  // These ops hold references to images, vertices or text blobs which are
+  // rebuilt on load and so only compare equal by value, not by identity.
+  const std::set<std::string> kRebuiltReferences = {
+      "SetColorSource", "DrawVertices", "DrawImage",    "DrawImageRect",
+      "DrawImageNine",  "DrawAtlas",    "DrawTextBlob",
+  };
+  for (DisplayListInvocationGroup& group : CreateAllGroups()) {
+    for (size_t i = 0; i < group.variants.size(); i++) {
+      DisplayListBuilder builder;
+      group.variants[i].Invoke(DisplayListBuilderTestingAccessor(builder));
+      sk_sp<DisplayList> display_list = builder.Build();
+      auto desc = group.op_name + "(variant " + std::to_string(i + 1) + ")";
+
+      sk_sp<DisplayList> copy = RoundTrip(display_list);
+      ASSERT_NE(copy, nullptr) << desc;
+      ASSERT_EQ(copy->GetRecordCount(), display_list->GetRecordCount())
+          << desc;
+      for (DlIndex index : *display_list) {
+        EXPECT_EQ(copy->GetOpType(index), display_list->GetOpType(index))
+            << desc;
+      }
+      EXPECT_EQ(copy->op_count(true), display_list->op_count(true)) << desc;
+      EXPECT_EQ(copy->total_depth(), display_list->total_depth()) << desc;
+      EXPECT_EQ(copy->bounds(), display_list->bounds()) << desc;
+      EXPECT_EQ(copy->can_apply_group_opacity(),
+                display_list->can_apply_group_opacity())
+          << desc;
+      EXPECT_EQ(copy->isUIThreadSafe(), display_list->isUIThreadSafe())
+          << desc;
+      EXPECT_EQ(copy->modifies_transparent_black(),
+                display_list->modifies_transparent_black())
+          << desc;
+      if (kRebuiltReferences.count(group.op_name) == 0) {
+        EXPECT_TRUE(copy->Equals(*display_list)) << desc;
+      }
+    }
+  }
+}
+
+TEST(DisplayListSerializer, AllOpsDisplayListRoundTrips) {
+  sk_sp<DisplayList> display_list = MakeAllOpsDisplayList();
+  sk_sp<DisplayList> copy = RoundTrip(display_list);
+  ASSERT_NE(copy, nullptr);
+  ASSERT_EQ(copy->GetRecordCount(), display_list->GetRecordCount());
+  EXPECT_EQ(copy->bytes(true), display_list->bytes(true));
+  EXPECT_EQ(copy->total_depth(), display_list->total_depth());
+  EXPECT_EQ(copy->bounds(), display_list->bounds());
+}
+
+TEST(DisplayListSerializer, RTreeIsPreserved) {
+  DisplayListBuilder builder(/*prepare_rtree=*/true);
+  DlPaint paint;
+  builder.DrawRect(DlRect::MakeLTRB(10, 10, 20, 20), paint);
+  builder.DrawRect(DlRect::MakeLTRB(50, 50, 60, 60), paint);
+  builder.DrawRect(DlRect::MakeLTRB(15, 15, 55, 55), paint);
+  sk_sp<DisplayList> display_list = builder.Build();
+  ASSERT_TRUE(display_list->has_rtree());
+
+  sk_sp<DisplayList> copy = RoundTrip(display_list);
+  ASSERT_NE(copy, nullptr);
+  ASSERT_TRUE(copy->has_rtree());
+
+  SkRect query = SkRect::MakeLTRB(12, 12, 18, 18);
+  std::vector<int> expected;
+  std::vector<int> actual;
+  display_list->rtree()->search(query, &expected);
+  copy->rtree()->search(query, &actual);
+  ASSERT_EQ(actual.size(), expected.size());
+  for (size_t i = 0; i < actual.size(); i++) {
+    EXPECT_EQ(copy->rtree()->id(actual[i]),
+              display_list->rtree()->id(expected[i]));
+    EXPECT_EQ(copy->rtree()->bounds(actual[i]),
+              display_list->rtree()->bounds(expected[i]));
+  }
+}
+
+TEST(DisplayListSerializer, ImagePixelsAreNotCopied) {
+  DisplayListBuilder builder;
+  builder.DrawImage(TestImage1, DlPoint(0, 0), DlImageSampling::kLinear);
+  builder.DrawImage(TestImage1, DlPoint(50, 50), DlImageSampling::kLinear);
+  sk_sp<DisplayList> display_list = builder.Build();
+
+  std::shared_ptr<const fml::Mapping> mapping =
+      DisplayListSerializer::Serialize(*display_list);
+  ASSERT_NE(mapping, nullptr);
+  sk_sp<DisplayList> copy = DisplayListSerializer::Deserialize(mapping);
+  ASSERT_NE(copy, nullptr);
+
+  class ImageCollector : public IgnoreAttributeDispatchHelper,
+                         public IgnoreClipDispatchHelper,
+                         public IgnoreTransformDispatchHelper,
+                         public IgnoreDrawDispatchHelper {
+   public:
+    void drawImage(const sk_sp<DlImage> image,
+                   const DlPoint& point,
+                   DlImageSampling sampling,
+                   bool render_with_attributes) override {
+      images.push_back(image);
+    }
+    std::vector<sk_sp<DlImage>> images;
+  } collector;
+  copy->Dispatch(collector);
+
+  ASSERT_EQ(collector.images.size(), 2u);
+  // Both records share one copy of the image...
+  EXPECT_EQ(collector.images[0], collector.images[1]);
+  // ...whose pixels live in the mapping itself.
+  SkPixmap pixmap;
+  ASSERT_TRUE(collector.images[0]->skia_image()->peekPixels(&pixmap));
+  auto pixels = static_cast<const uint8_t*>(pixmap.addr());
+  EXPECT_GE(pixels, mapping->GetMapping());
+  EXPECT_LE(pixels + pixmap.computeByteSize(),
+            mapping->GetMapping() + mapping->GetSize());
+}
+
+TEST(DisplayListSerializer, FileRoundTrip) {
+  fml::ScopedTemporaryDirectory temp_dir;
+  sk_sp<DisplayList> display_list = MakeAllOpsDisplayList();
+  ASSERT_TRUE(DisplayListSerializer::WriteToFile(*display_list, temp_dir.fd(),
+                                                 "frame.dls"));
+  sk_sp<DisplayList> copy =
+      DisplayListSerializer::ReadFromFile(temp_dir.fd(), "frame.dls");
+  ASSERT_NE(copy, nullptr);
+  EXPECT_EQ(copy->GetRecordCount(), display_list->GetRecordCount());
+  EXPECT_EQ(copy->bounds(), display_list->bounds());
+}
+
+TEST(DisplayListSerializer, RejectsTruncatedData) {
+  std::vector<uint8_t> data = SerializeToVector(*MakeAllOpsDisplayList());
+  ASSERT_NE(DeserializeVector(data), nullptr);
+  for (size_t size = 0; size < data.size(); size += 7) {
+    std::vector<uint8_t> truncated(data.begin(), data.begin() + size);
+    EXPECT_EQ(DeserializeVector(std::move(truncated)), nullptr) << size;
+  }
+}
+
+TEST(DisplayListSerializer, RejectsBadHeader) {
+  DisplayListBuilder builder;
+  builder.DrawRect(DlRect::MakeLTRB(10, 10, 20, 20), DlPaint());
+  std::vector<uint8_t> data = SerializeToVector(*builder.Build());
+
+  std::vector<uint8_t> bad_magic = data;
+  bad_magic[0] ^= 0xff;
+  EXPECT_EQ(DeserializeVector(std::move(bad_magic)), nullptr);
+
+  // The layout signature immediately follows the magic and version.
+  std::vector<uint8_t> bad_signature = data;
+  bad_signature[2 * sizeof(uint32_t)] ^= 0xff;
+  EXPECT_EQ(DeserializeVector(std::move(bad_signature)), nullptr);
+}
+
+TEST(DisplayListSerializer, RejectsCorruptRecordType) {
+  DisplayListBuilder builder;
+  builder.DrawRect(DlRect::MakeLTRB(10, 10, 20, 20), DlPaint());
+  sk_sp<DisplayList> display_list = builder.Build();
+  std::vector<uint8_t> data = SerializeToVector(*display_list);
+
+  // Overwrite every aligned word in turn with an out of range op type.
+  // None of the corruptions may crash and any that decode must not
+  // produce an op type that was never written.
+  for (size_t offset = 0; offset + sizeof(uint32_t) <= data.size();
+       offset += sizeof(uint32_t)) {
+    std::vector<uint8_t> corrupt = data;
+    uint32_t bad_type = static_cast<uint32_t>(DisplayListOpType::kMaxOp);
+    memcpy(corrupt.data() + offset, &bad_type, sizeof(bad_type));
+    sk_sp<DisplayList> copy = DeserializeVector(std::move(corrupt));
+    if (copy) {
+      for (DlIndex index : *copy) {
+        EXPECT_NE(copy->GetOpType(index), DisplayListOpType::kMaxOp);
+      }
+    }
+  }
+}
+
+TEST(DisplayListSerializer, RejectsBadBlendMode) {
+  auto make = [](DlBlendMode mode) {
+    DisplayListBuilder builder;
+    builder.DrawRect(DlRect::MakeLTRB(10, 10, 20, 20),
+                     DlPaint().setColorFilter(
+                         DlColorFilter::MakeBlend(DlColor::kRed(), mode)));
+    return builder.Build();
+  };
+  sk_sp<DisplayList> display_list = make(DlBlendMode::kSrcIn);
+  ASSERT_NE(RoundTrip(display_list), nullptr);
+  EXPECT_EQ(DeserializeVector(SerializeWithBadEnum(
+                *display_list, *make(DlBlendMode::kModulate))),
+            nullptr);
+}
+
+TEST(DisplayListSerializer, RejectsBadTileMode) {
+  auto make = [](DlTileMode tile_mode) {
+    DisplayListBuilder builder;
+    builder.DrawRect(DlRect::MakeLTRB(10, 10, 20, 20),
+                     DlPaint().setColorSource(DlColorSource::MakeImage(
+                         TestImage1, DlTileMode::kClamp, tile_mode)));
+    return builder.Build();
+  };
+  sk_sp<DisplayList> display_list = make(DlTileMode::kRepeat);
+  ASSERT_NE(RoundTrip(display_list), nullptr);
+  EXPECT_EQ(DeserializeVector(SerializeWithBadEnum(
+                *display_list, *make(DlTileMode::kMirror))),
+            nullptr);
+}
+
+TEST(DisplayListSerializer, RejectsBadImageSampling) {
+  auto make = [](DlImageSampling sampling) {
+    DisplayListBuilder builder;
+    builder.DrawImage(TestImage1, DlPoint(0, 0), sampling);
+    return builder.Build();
+  };
+  sk_sp<DisplayList> display_list = make(DlImageSampling::kLinear);
+  ASSERT_NE(RoundTrip(display_list), nullptr);
+  EXPECT_EQ(DeserializeVector(SerializeWithBadEnum(
+                *display_list, *make(DlImageSampling::kNearestNeighbor))),
+            nullptr);
+}
+
+TEST(DisplayListSerializer, RejectsBadBlurStyle) {
+  auto make = [](DlBlurStyle style) {
+    DisplayListBuilder builder;
+    builder.DrawRect(DlRect::MakeLTRB(10, 10, 20, 20),
+                     DlPaint().setMaskFilter(DlBlurMaskFilter::Make(style, 2)));
+    return builder.Build();
+  };
+  sk_sp<DisplayList> display_list = make(DlBlurStyle::kNormal);
+  ASSERT_NE(RoundTrip(display_list), nullptr);
+  EXPECT_EQ(DeserializeVector(SerializeWithBadEnum(
+                *display_list, *make(DlBlurStyle::kSolid))),
+            nullptr);
+}
+
+TEST(DisplayListSerializer, RejectsBadSrcRectConstraint) {
+  auto make = [](DlCanvas::SrcRectConstraint constraint) {
+    DisplayListBuilder builder;
+    builder.DrawImageRect(TestImage1, DlRect::MakeLTRB(0, 0, 10, 10),
+                          DlRect::MakeLTRB(10, 10, 20, 20),
+                          DlImageSampling::kLinear, nullptr, constraint);
+    return builder.Build();
+  };
+  sk_sp<DisplayList> display_list =
+      make(DlCanvas::SrcRectConstraint::kStrict);
+  ASSERT_NE(RoundTrip(display_list), nullptr);
+  EXPECT_EQ(DeserializeVector(SerializeWithBadEnum(
+                *display_list, *make(DlCanvas::SrcRectConstraint::kFast))),
+            nullptr);
+}
+
+}  // namespace testing
+}  // namespace flutter
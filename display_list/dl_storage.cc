@@ -28,7 +28,9 @@ uint8_t* DisplayListStorage::allocate(size_t needed) {
     FML_CHECK(allocated_ == new_size);
     FML_CHECK(allocated_ >= old_size);
     FML_CHECK(used_ + needed <= allocated_);
-    memset(ptr_.get() + used_, 0, allocated_ - old_size);
+    // Zero all of the newly allocated bytes so that any padding in the
+    // records is deterministic for bulk comparisons and hashing.
+    memset(ptr_.get() + old_size, 0, allocated_ - old_size);
   }
   uint8_t* ret = ptr_.get() + used_;
   used_ += needed;
@@ -26,6 +26,8 @@ enum class DlTileMode {
   // Only draw within the original domain, return transparent-black everywhere
   // else.
   kDecal,
+
+  kLast = kDecal,
 };
 
 }  // namespace flutter
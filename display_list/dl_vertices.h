@@ -31,6 +31,8 @@ enum class DlVertexMode {
   /// vertex to form triangles that radiate outward from the initial point.
   /// vertices [ABCDE] yield 3 triangles ABC,ACD,ADE
   kTriangleFan,
+
+  kLast = kTriangleFan,
 };
 
 //------------------------------------------------------------------------------
@@ -26,6 +26,8 @@ enum class DlBlurStyle {
   kSolid,   //!< solid inside, fuzzy outside
   kOuter,   //!< nothing inside, fuzzy outside
   kInner,   //!< fuzzy inside, nothing outside
+
+  kLast = kInner,
 };
 
 class DlMaskFilter : public DlAttribute<DlMaskFilter, DlMaskFilterType> {
@@ -4,19 +4,73 @@
 
 #include "flutter/display_list/geometry/dl_path.h"
 
+#include <atomic>
+
 #include "flutter/display_list/geometry/dl_geometry_types.h"
 #include "flutter/impeller/geometry/path_builder.h"
 #include "impeller/geometry/path.h"
 
 namespace flutter {
 
+namespace {
+
+std::atomic<uint64_t> sk_paths_created = 0u;
+std::atomic<uint64_t> impeller_paths_created = 0u;
+std::atomic<uint64_t> sk_to_impeller_conversions = 0u;
+std::atomic<uint64_t> impeller_to_sk_conversions = 0u;
+
+}  // namespace
+
+DlPath::Data::Data(const SkPath& path)
+    : sk_path(path), has_sk_path(true), is_volatile(path.isVolatile()) {
+  sk_paths_created.fetch_add(1u, std::memory_order_relaxed);
+}
+
+DlPath::Data::Data(const impeller::Path& path, bool is_volatile)
+    : path(path), has_path(true), is_volatile(is_volatile) {
+  impeller_paths_created.fetch_add(1u, std::memory_order_relaxed);
+}
+
+DlPath::Counters DlPath::GetCounters() {
+  return {
+      .sk_paths_created = sk_paths_created.load(std::memory_order_relaxed),
+      .impeller_paths_created =
+          impeller_paths_created.load(std::memory_order_relaxed),
+      .sk_to_impeller_conversions =
+          sk_to_impeller_conversions.load(std::memory_order_relaxed),
+      .impeller_to_sk_conversions =
+          impeller_to_sk_conversions.load(std::memory_order_relaxed),
+  };
+}
+
 const SkPath& DlPath::GetSkPath() const {
-  return data_->sk_path;
+  if (!data_->HasSkPath()) {
+    Data* data = data_.get();
+    std::call_once(data->sk_path_once, [data]() {
+      // Covered by the invariant of |Data|.
+      // NOLINTNEXTLINE(bugprone-unchecked-optional-access)
+      data->sk_path = ConvertToSkiaPath(data->path.value());
+      data->sk_path->setIsVolatile(data->is_volatile);
+      data->has_sk_path.store(true, std::memory_order_release);
+      impeller_to_sk_conversions.fetch_add(1u, std::memory_order_relaxed);
+    });
+  }
+
+  // Covered by check above.
+  // NOLINTNEXTLINE(bugprone-unchecked-optional-access)
+  return data_->sk_path.value();
 }
 
 impeller::Path DlPath::GetPath() const {
-  if (!data_->path.has_value()) {
-    data_->path = ConvertToImpellerPath(data_->sk_path);
+  if (!data_->HasPath()) {
+    Data* data = data_.get();
+    std::call_once(data->path_once, [data]() {
+      // Covered by the invariant of |Data|.
+      // NOLINTNEXTLINE(bugprone-unchecked-optional-access)
+      data->path = ConvertToImpellerPath(data->sk_path.value());
+      data->has_path.store(true, std::memory_order_release);
+      sk_to_impeller_conversions.fetch_add(1u, std::memory_order_relaxed);
+    });
   }
 
   // Covered by check above.
@@ -26,54 +80,75 @@ impeller::Path DlPath::GetPath() const {
 
 void DlPath::WillRenderSkPath() const {
   if (data_->render_count >= kMaxVolatileUses) {
-    data_->sk_path.setIsVolatile(false);
+    data_->is_volatile = false;
+    if (data_->HasSkPath()) {
+      data_->sk_path->setIsVolatile(false);
+    }
   } else {
     data_->render_count++;
   }
 }
 
 bool DlPath::IsInverseFillType() const {
-  return data_->sk_path.isInverseFillType();
+  // Impeller paths do not have inverse fill types.
+  return data_->HasSkPath() && data_->sk_path->isInverseFillType();
 }
 
 bool DlPath::IsRect(DlRect* rect, bool* is_closed) const {
-  return data_->sk_path.isRect(ToSkRect(rect), is_closed);
+  return data_->HasSkPath() &&
+         data_->sk_path->isRect(ToSkRect(rect), is_closed);
 }
 
 bool DlPath::IsOval(DlRect* bounds) const {
-  return data_->sk_path.isOval(ToSkRect(bounds));
+  return data_->HasSkPath() && data_->sk_path->isOval(ToSkRect(bounds));
 }
 
 bool DlPath::IsSkRect(SkRect* rect, bool* is_closed) const {
-  return data_->sk_path.isRect(rect, is_closed);
+  return data_->HasSkPath() && data_->sk_path->isRect(rect, is_closed);
 }
 
 bool DlPath::IsSkOval(SkRect* bounds) const {
-  return data_->sk_path.isOval(bounds);
+  return data_->HasSkPath() && data_->sk_path->isOval(bounds);
 }
 
 bool DlPath::IsSkRRect(SkRRect* rrect) const {
-  return data_->sk_path.isRRect(rrect);
+  return data_->HasSkPath() && data_->sk_path->isRRect(rrect);
 }
 
 SkRect DlPath::GetSkBounds() const {
-  return data_->sk_path.getBounds();
+  return ToSkRect(GetBounds());
 }
 
 DlRect DlPath::GetBounds() const {
-  return ToDlRect(data_->sk_path.getBounds());
+  if (data_->HasSkPath()) {
+    return ToDlRect(data_->sk_path->getBounds());
+  }
+  // Covered by the invariant of |Data|.
+  // NOLINTNEXTLINE(bugprone-unchecked-optional-access)
+  return data_->path->GetBoundingBox().value_or(DlRect());
 }
 
 bool DlPath::operator==(const DlPath& other) const {
-  return data_->sk_path == other.data_->sk_path;
+  if (data_ == other.data_) {
+    return true;
+  }
+  if (data_->HasSkPath() && other.data_->HasSkPath()) {
+    return data_->sk_path.value() == other.data_->sk_path.value();
+  }
+  if (data_->HasPath() && other.data_->HasPath()) {
+    // Comparing the Impeller paths avoids generating an SkPath for either
+    // of them.
+    return data_->path.value() == other.data_->path.value();
+  }
+  return GetSkPath() == other.GetSkPath();
 }
 
 bool DlPath::IsConverted() const {
-  return data_->path.has_value();
+  return data_->HasSkPath() && data_->HasPath();
 }
 
 bool DlPath::IsVolatile() const {
-  return data_->sk_path.isVolatile();
+  return data_->is_volatile;
 }
 
 using Path = impeller::Path;
@@ -168,4 +243,59 @@ Path DlPath::ConvertToImpellerPath(const SkPath& path, const DlPoint& shift) {
   return builder.TakePath(fill_type);
 }
 
+SkPath DlPath::ConvertToSkiaPath(const Path& path) {
+  SkPath sk_path;
+  switch (path.GetFillType()) {
+    case FillType::kNonZero:
+      sk_path.setFillType(SkPathFillType::kWinding);
+      break;
+    case FillType::kOdd:
+      sk_path.setFillType(SkPathFillType::kEvenOdd);
+      break;
+  }
+
+  // Impeller starts every contour with a contour component that holds its
+  // starting point and whether it is closed, even if no segments follow it.
+  // Skia only needs a move for contours that have segments.
+  DlPoint contour_start;
+  bool contour_is_closed = false;
+  bool contour_has_segments = false;
+  auto start_segment = [&sk_path, &contour_start, &contour_has_segments]() {
+    if (!contour_has_segments) {
+      sk_path.moveTo(ToSkPoint(contour_start));
+      contour_has_segments = true;
+    }
+  };
+  auto end_contour = [&sk_path, &contour_is_closed, &contour_has_segments]() {
+    if (contour_has_segments && contour_is_closed) {
+      sk_path.close();
+    }
+  };
+
+  path.EnumerateComponents(
+      [&sk_path, &start_segment](const impeller::LinearPathComponent& linear) {
+        start_segment();
+        sk_path.lineTo(ToSkPoint(linear.p2));
+      },
+      [&sk_path, &start_segment](const impeller::QuadraticPathComponent& quad) {
+        start_segment();
+        sk_path.quadTo(ToSkPoint(quad.cp), ToSkPoint(quad.p2));
+      },
+      [&sk_path, &start_segment](const impeller::CubicPathComponent& cubic) {
+        start_segment();
+        sk_path.cubicTo(ToSkPoint(cubic.cp1), ToSkPoint(cubic.cp2),
+                        ToSkPoint(cubic.p2));
+      },
+      [&contour_start, &contour_is_closed, &contour_has_segments,
+       &end_contour](const impeller::ContourComponent& contour) {
+        end_contour();
+        contour_start = contour.destination;
+        contour_is_closed = contour.IsClosed();
+        contour_has_segments = false;
+      });
+  end_contour();
+
+  return sk_path;
+}
+
 }  // namespace flutter
@@ -5,6 +5,9 @@
 #ifndef FLUTTER_DISPLAY_LIST_GEOMETRY_DL_PATH_H_
 #define FLUTTER_DISPLAY_LIST_GEOMETRY_DL_PATH_H_
 
+#include <atomic>
+#include <mutex>
+
 #include "flutter/display_list/geometry/dl_geometry_types.h"
 #include "flutter/impeller/geometry/path.h"
 #include "flutter/third_party/skia/include/core/SkPath.h"
@@ -15,9 +18,34 @@ class DlPath {
  public:
   static constexpr uint32_t kMaxVolatileUses = 2;
 
-  DlPath() : data_(std::make_shared<Data>(SkPath())) {}
+  /// Counts of the path representations created by all |DlPath| objects
+  /// since the process started.
+  struct Counters {
+    /// The paths that were constructed from an |SkPath|.
+    uint64_t sk_paths_created = 0u;
+    /// The paths that were constructed from an |impeller::Path|.
+    uint64_t impeller_paths_created = 0u;
+    /// The times an |impeller::Path| was generated from an |SkPath|.
+    uint64_t sk_to_impeller_conversions = 0u;
+    /// The times an |SkPath| was generated from an |impeller::Path|.
+    uint64_t impeller_to_sk_conversions = 0u;
+  };
+
+  static Counters GetCounters();
+
+  DlPath() : DlPath(SkPath()) {}
   explicit DlPath(const SkPath& path) : data_(std::make_shared<Data>(path)) {}
 
+  /// Wraps a path that was built directly for Impeller. The |SkPath| is
+  /// only generated if |GetSkPath| is called, i.e. when the path is rendered
+  /// by Skia or a Skia-only operation is applied to it.
+  ///
+  /// The shape of such a path is not analyzed, so |IsRect|, |IsOval| and
+  /// their variants return false and the path is rendered as a general
+  /// path until its |SkPath| has been generated.
+  explicit DlPath(const impeller::Path& path, bool is_volatile = false)
+      : data_(std::make_shared<Data>(path, is_volatile)) {}
+
   DlPath(const DlPath& path) = default;
   DlPath(DlPath&& path) = default;
 
@@ -47,22 +75,42 @@ class DlPath {
   bool operator==(const DlPath& other) const;
   bool operator!=(const DlPath& other) const { return !(*this == other); }
 
+  /// Whether both the |SkPath| and the |impeller::Path| representations
+  /// of the path exist.
   bool IsConverted() const;
   bool IsVolatile() const;
 
  private:
+  // At least one of the two representations is always present, the other
+  // one is generated on demand.
+  //
+  // The data is shared by all copies of a path, which may be used on the UI
+  // and raster threads at the same time. A representation is generated at
+  // most once, and may only be read once its |has_*| flag is set.
   struct Data {
-    explicit Data(const SkPath& path) : sk_path(path) {}
+    explicit Data(const SkPath& path);
+    Data(const impeller::Path& path, bool is_volatile);
+
+    bool HasSkPath() const {
+      return has_sk_path.load(std::memory_order_acquire);
+    }
+    bool HasPath() const { return has_path.load(std::memory_order_acquire); }
 
-    SkPath sk_path;
+    std::optional<SkPath> sk_path;
     std::optional<impeller::Path> path;
+    std::atomic<bool> has_sk_path = false;
+    std::atomic<bool> has_path = false;
+    std::once_flag sk_path_once;
+    std::once_flag path_once;
     uint32_t render_count = 0u;
+    std::atomic<bool> is_volatile = false;
   };
 
   std::shared_ptr<Data> data_;
 
   static impeller::Path ConvertToImpellerPath(const SkPath& path,
                                               const DlPoint& shift = DlPoint());
+  static SkPath ConvertToSkiaPath(const impeller::Path& path);
 };
 
 }  // namespace flutter
@@ -5,6 +5,10 @@
 #include "flutter/display_list/geometry/dl_path.h"
 #include "gtest/gtest.h"
 
+#include <thread>
+#include <vector>
+
+#include "flutter/impeller/geometry/path_builder.h"
 #include "flutter/third_party/skia/include/core/SkRRect.h"
 
 namespace flutter {
@@ -409,5 +413,143 @@ TEST(DisplayListPath, ConstructFromInversePath) {
   EXPECT_EQ(path.GetSkBounds(), SkRect::MakeLTRB(10, 10, 20, 20));
 }
 
+TEST(DisplayListPath, ConstructFromImpellerPath) {
+  DlPath::Counters before = DlPath::GetCounters();
+  impeller::Path impeller_path = impeller::PathBuilder{}
+                                     .MoveTo({10, 10})
+                                     .LineTo({20, 20})
+                                     .LineTo({20, 10})
+                                     .TakePath(impeller::FillType::kOdd);
+  DlPath path(impeller_path);
+
+  EXPECT_FALSE(path.IsConverted());
+  EXPECT_FALSE(path.IsVolatile());
+  EXPECT_EQ(path.GetPath().GetIdentity(), impeller_path.GetIdentity());
+  EXPECT_FALSE(path.IsInverseFillType());
+  EXPECT_FALSE(path.IsRect(nullptr));
+  EXPECT_FALSE(path.IsOval(nullptr));
+  EXPECT_FALSE(path.IsSkRRect(nullptr));
+  EXPECT_EQ(path.GetBounds(), DlRect::MakeLTRB(10, 10, 20, 20));
+  EXPECT_EQ(path.GetSkBounds(), SkRect::MakeLTRB(10, 10, 20, 20));
+  // None of the above needed an SkPath.
+  EXPECT_FALSE(path.IsConverted());
+
+  DlPath::Counters after = DlPath::GetCounters();
+  EXPECT_EQ(after.impeller_paths_created, before.impeller_paths_created + 1);
+  EXPECT_EQ(after.sk_paths_created, before.sk_paths_created);
+  EXPECT_EQ(after.impeller_to_sk_conversions,
+            before.impeller_to_sk_conversions);
+  EXPECT_EQ(after.sk_to_impeller_conversions,
+            before.sk_to_impeller_conversions);
+
+  SkPath sk_path;
+  sk_path.moveTo(10, 10);
+  sk_path.lineTo(20, 20);
+  sk_path.lineTo(20, 10);
+  sk_path.setFillType(SkPathFillType::kEvenOdd);
+  EXPECT_EQ(path.GetSkPath(), sk_path);
+  EXPECT_TRUE(path.IsConverted());
+  EXPECT_EQ(path, DlPath(sk_path));
+
+  // The SkPath is only generated once.
+  EXPECT_EQ(path.GetSkPath(), sk_path);
+  EXPECT_EQ(DlPath::GetCounters().impeller_to_sk_conversions,
+            before.impeller_to_sk_conversions + 1);
+}
+
+TEST(DisplayListPath, ConvertImpellerPathWithCurvesAndContours) {
+  DlPath path(impeller::PathBuilder{}
+                  .MoveTo({10, 10})
+                  .QuadraticCurveTo({20, 0}, {30, 10})
+                  .CubicCurveTo({40, 20}, {30, 30}, {20, 30})
+                  .Close()
+                  .MoveTo({50, 50})
+                  .LineTo({60, 50})
+                  .MoveTo({70, 70})
+                  .TakePath());
+
+  SkPath sk_path;
+  sk_path.moveTo(10, 10);
+  sk_path.quadTo(20, 0, 30, 10);
+  sk_path.cubicTo(40, 20, 30, 30, 20, 30);
+  // Impeller closes contours with an explicit line.
+  sk_path.lineTo(10, 10);
+  sk_path.close();
+  sk_path.moveTo(50, 50);
+  sk_path.lineTo(60, 50);
+  // The trailing contour has no segments and is dropped.
+
+  EXPECT_EQ(path.GetSkPath(), sk_path);
+}
+
+TEST(DisplayListPath, ImpellerPathVolatileBecomesNonVolatile) {
+  DlPath path(impeller::PathBuilder{}.AddLine({10, 10}, {20, 20}).TakePath(),
+              /*is_volatile=*/true);
+
+  EXPECT_TRUE(path.IsVolatile());
+  for (uint32_t i = 0; i < DlPath::kMaxVolatileUses; i++) {
+    path.WillRenderSkPath();
+    EXPECT_TRUE(path.IsVolatile());
+    EXPECT_TRUE(path.GetSkPath().isVolatile());
+  }
+
+  path.WillRenderSkPath();
+  EXPECT_FALSE(path.IsVolatile());
+  EXPECT_FALSE(path.GetSkPath().isVolatile());
+}
+
+TEST(DisplayListPath, ImpellerPathsCompareWithoutConversion) {
+  auto make_path = [](impeller::Point end) {
+    return DlPath(
+        impeller::PathBuilder{}.MoveTo({10, 10}).LineTo(end).TakePath());
+  };
+  DlPath path1 = make_path({20, 20});
+  DlPath path2 = make_path({20, 20});
+  DlPath path3 = make_path({20, 30});
+  DlPath path4 = DlPath(impeller::PathBuilder{}
+                            .MoveTo({10, 10})
+                            .LineTo({20, 20})
+                            .TakePath(impeller::FillType::kOdd));
+
+  uint64_t conversions = DlPath::GetCounters().impeller_to_sk_conversions;
+  EXPECT_EQ(path1, path1);
+  EXPECT_EQ(path1, path2);
+  EXPECT_NE(path1, path3);
+  EXPECT_NE(path1, path4);
+  EXPECT_FALSE(path1.IsConverted());
+  EXPECT_EQ(DlPath::GetCounters().impeller_to_sk_conversions, conversions);
+}
+
+TEST(DisplayListPath, ConcurrentConversionsShareOneSkPath) {
+  DlPath path(impeller::PathBuilder{}
+                  .MoveTo({10, 10})
+                  .LineTo({20, 20})
+                  .LineTo({20, 10})
+                  .TakePath());
+  uint64_t conversions = DlPath::GetCounters().impeller_to_sk_conversions;
+
+  // Copies share the data that the SkPath is generated into, as the copies
+  // held by the UI and raster threads do.
+  constexpr size_t kThreadCount = 8;
+  std::vector<const SkPath*> sk_paths(kThreadCount, nullptr);
+  std::vector<std::thread> threads;
+  for (size_t i = 0; i < kThreadCount; i++) {
+    threads.emplace_back([copy = path, &sk_paths, i]() {
+      EXPECT_FALSE(copy.IsRect(nullptr));
+      sk_paths[i] = &copy.GetSkPath();
+      EXPECT_EQ(copy.GetBounds(), DlRect::MakeLTRB(10, 10, 20, 20));
+    });
+  }
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+
+  for (const SkPath* sk_path : sk_paths) {
+    EXPECT_EQ(sk_path, &path.GetSkPath());
+  }
+  EXPECT_EQ(DlPath::GetCounters().impeller_to_sk_conversions,
+            conversions + 1);
+}
+
 }  // namespace testing
 }  // namespace flutter
@@ -0,0 +1,681 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/display_list/utils/dl_optimizer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <optional>
+#include <vector>
+
+#include "flutter/display_list/dl_builder.h"
+#include "flutter/display_list/dl_op_receiver.h"
+#include "flutter/display_list/dl_paint.h"
+#include "flutter/display_list/utils/dl_matrix_clip_tracker.h"
+#include "flutter/fml/trace_event.h"
+
+namespace flutter {
+
+namespace {
+
+// The largest rect whose pixels are all entirely inside |rect|.
+DlRect RoundIn(const DlRect& rect) {
+  return DlRect::MakeLTRB(std::ceil(rect.GetLeft()), std::ceil(rect.GetTop()),
+                          std::floor(rect.GetRight()),
+                          std::floor(rect.GetBottom()));
+}
+
+// Tracks the attributes set on a DlOpReceiver in a DlPaint. Attributes are
+// not affected by save and restore, so a single paint is enough.
+class PaintTrackingReceiver : public virtual DlOpReceiver {
+ public:
+  void setAntiAlias(bool aa) override { paint_.setAntiAlias(aa); }
+  void setInvertColors(bool invert) override { paint_.setInvertColors(invert); }
+  void setStrokeCap(DlStrokeCap cap) override { paint_.setStrokeCap(cap); }
+  void setStrokeJoin(DlStrokeJoin join) override { paint_.setStrokeJoin(join); }
+  void setDrawStyle(DlDrawStyle style) override { paint_.setDrawStyle(style); }
+  void setStrokeWidth(float width) override { paint_.setStrokeWidth(width); }
+  void setStrokeMiter(float limit) override { paint_.setStrokeMiter(limit); }
+  void setColor(DlColor color) override { paint_.setColor(color); }
+  void setBlendMode(DlBlendMode mode) override { paint_.setBlendMode(mode); }
+  void setColorSource(const DlColorSource* source) override {
+    paint_.setColorSource(source);
+  }
+  void setImageFilter(const DlImageFilter* filter) override {
+    paint_.setImageFilter(filter);
+  }
+  void setColorFilter(const DlColorFilter* filter) override {
+    paint_.setColorFilter(filter);
+  }
+  void setMaskFilter(const DlMaskFilter* filter) override {
+    paint_.setMaskFilter(filter);
+  }
+
+ protected:
+  DlPaint paint_;
+};
+
+// Finds the rendering operations that are entirely overdrawn by a later
+// opaque fill. Each record must be dispatched after a call to |SetIndex|.
+//
+// Only simple fills are considered on either side of the comparison, and
+// both are measured in the device space of the DisplayList:
+//
+//  - A candidate for culling is a filled geometry or image without image or
+//    mask filters, whose conservative device bounds are easy to compute.
+//  - An occluder is a rect, paint or color fill that ignores what is under
+//    it, drawn with an axis aligned transform inside a rectangular clip. It
+//    covers only the pixels that are entirely inside both.
+//
+// Candidates are only culled by occluders in the same layer. A backdrop
+// filter reads the content of all of the enclosing layers, so it ends the
+// search for all earlier candidates.
+class OverdrawAnalyzer final : public PaintTrackingReceiver {
+ public:
+  explicit OverdrawAnalyzer(DlIndex record_count)
+      : culled_(record_count, false) {
+    DlRect max_cull_rect = DisplayListBuilder::kMaxCullRect;
+    levels_.push_back({
+        .state = DisplayListMatrixClipState(max_cull_rect),
+        .clip_is_rect = true,
+        .clip_coverage = max_cull_rect,
+        .is_layer = false,
+    });
+    layers_.emplace_back();
+  }
+
+  void SetIndex(DlIndex index) { index_ = index; }
+
+  const std::vector<bool>& culled() const { return culled_; }
+
+  size_t culled_count() const { return culled_count_; }
+
+  void save() override { levels_.push_back(levels_.back()); }
+
+  void saveLayer(const DlRect& bounds,
+                 const SaveLayerOptions options,
+                 const DlImageFilter* backdrop,
+                 std::optional<int64_t> backdrop_id) override {
+    if (backdrop) {
+      ClearCandidates();
+    }
+    levels_.push_back(levels_.back());
+    levels_.back().is_layer = true;
+    layers_.emplace_back();
+  }
+
+  void restore() override {
+    if (levels_.size() <= 1u) {
+      return;
+    }
+    if (levels_.back().is_layer) {
+      layers_.pop_back();
+    }
+    levels_.pop_back();
+  }
+
+  void translate(DlScalar tx, DlScalar ty) override {
+    state().translate(tx, ty);
+  }
+  void scale(DlScalar sx, DlScalar sy) override { state().scale(sx, sy); }
+  void rotate(DlScalar degrees) override { state().rotate(degrees); }
+  void skew(DlScalar sx, DlScalar sy) override { state().skew(sx, sy); }
+  // clang-format off
+  void transform2DAffine(DlScalar mxx, DlScalar mxy, DlScalar mxt,
+                         DlScalar myx, DlScalar myy, DlScalar myt) override {
+    state().transform2DAffine(mxx, mxy, mxt, myx, myy, myt);
+  }
+  void transformFullPerspective(
+      DlScalar mxx, DlScalar mxy, DlScalar mxz, DlScalar mxt,
+      DlScalar myx, DlScalar myy, DlScalar myz, DlScalar myt,
+      DlScalar mzx, DlScalar mzy, DlScalar mzz, DlScalar mzt,
+      DlScalar mwx, DlScalar mwy, DlScalar mwz, DlScalar mwt) override {
+    state().transformFullPerspective(mxx, mxy, mxz, mxt,
+                                     myx, myy, myz, myt,
+                                     mzx, mzy, mzz, mzt,
+                                     mwx, mwy, mwz, mwt);
+  }
+  // clang-format on
+  void transformReset() override { state().setIdentity(); }
+
+  void clipRect(const DlRect& rect, ClipOp clip_op, bool is_aa) override {
+    state().clipRect(rect, clip_op, is_aa);
+    Level& level = levels_.back();
+    const DlMatrix& matrix = state().matrix();
+    if (clip_op == ClipOp::kIntersect && !matrix.HasPerspective() &&
+        matrix.IsAligned2D()) {
+      DlRect device_clip = RoundIn(rect.TransformAndClipBounds(matrix));
+      level.clip_coverage =
+          level.clip_coverage.IntersectionOrEmpty(device_clip);
+    } else {
+      level.clip_is_rect = false;
+    }
+  }
+  void clipOval(const DlRect& bounds, ClipOp clip_op, bool is_aa) override {
+    state().clipOval(bounds, clip_op, is_aa);
+    levels_.back().clip_is_rect = false;
+  }
+  void clipRoundRect(const DlRoundRect& rrect,
+                     ClipOp clip_op,
+                     bool is_aa) override {
+    if (rrect.IsRect()) {
+      clipRect(rrect.GetBounds(), clip_op, is_aa);
+      return;
+    }
+    state().clipRRect(rrect, clip_op, is_aa);
+    levels_.back().clip_is_rect = false;
+  }
+  void clipPath(const DlPath& path, ClipOp clip_op, bool is_aa) override {
+    state().clipPath(path, clip_op, is_aa);
+    levels_.back().clip_is_rect = false;
+  }
+
+  void drawColor(DlColor color, DlBlendMode mode) override {
+    if (mode == DlBlendMode::kSrc ||
+        (mode == DlBlendMode::kSrcOver && color.isOpaque())) {
+      Occlude(std::nullopt);
+    }
+  }
+  void drawPaint() override {
+    if (PaintIsOpaqueFill(/*needs_fill_style=*/false)) {
+      Occlude(std::nullopt);
+    }
+  }
+  void drawRect(const DlRect& rect) override {
+    if (PaintIsOpaqueFill(/*needs_fill_style=*/true)) {
+      Occlude(rect);
+    } else {
+      AddShapeCandidate(rect);
+    }
+  }
+  void drawOval(const DlRect& bounds) override { AddShapeCandidate(bounds); }
+  void drawCircle(const DlPoint& center, DlScalar radius) override {
+    AddShapeCandidate(
+        DlRect::MakeLTRB(center.x - radius, center.y - radius,
+                         center.x + radius, center.y + radius));
+  }
+  void drawRoundRect(const DlRoundRect& rrect) override {
+    AddShapeCandidate(rrect.GetBounds());
+  }
+  void drawDiffRoundRect(const DlRoundRect& outer,
+                         const DlRoundRect& inner) override {
+    AddShapeCandidate(outer.GetBounds());
+  }
+  void drawPath(const DlPath& path) override {
+    AddShapeCandidate(path.GetBounds());
+  }
+  void drawArc(const DlRect& oval_bounds,
+               DlScalar start_degrees,
+               DlScalar sweep_degrees,
+               bool use_center) override {
+    AddShapeCandidate(oval_bounds);
+  }
+  void drawImage(const sk_sp<DlImage> image,
+                 const DlPoint& point,
+                 DlImageSampling sampling,
+                 bool render_with_attributes) override {
+    DlIRect bounds = image->GetBounds();
+    AddImageCandidate(DlRect::MakeXYWH(point.x, point.y, bounds.GetWidth(),
+                                       bounds.GetHeight()),
+                      render_with_attributes);
+  }
+  void drawImageRect(const sk_sp<DlImage> image,
+                     const DlRect& src,
+                     const DlRect& dst,
+                     DlImageSampling sampling,
+                     bool render_with_attributes,
+                     SrcRectConstraint constraint) override {
+    AddImageCandidate(dst, render_with_attributes);
+  }
+  void drawImageNine(const sk_sp<DlImage> image,
+                     const DlIRect& center,
+                     const DlRect& dst,
+                     DlFilterMode filter,
+                     bool render_with_attributes) override {
+    AddImageCandidate(dst, render_with_attributes);
+  }
+  void drawDisplayList(const sk_sp<DisplayList> display_list,
+                       DlScalar opacity) override {
+    if (display_list->root_has_backdrop_filter()) {
+      ClearCandidates();
+    }
+  }
+
+  // The remaining operations are neither candidates nor occluders.
+  void drawLine(const DlPoint& p0, const DlPoint& p1) override {}
+  void drawDashedLine(const DlPoint& p0,
+                      const DlPoint& p1,
+                      DlScalar on_length,
+                      DlScalar off_length) override {}
+  void drawPoints(PointMode mode,
+                  uint32_t count,
+                  const DlPoint points[]) override {}
+  void drawVertices(const std::shared_ptr<DlVertices>& vertices,
+                    DlBlendMode mode) override {}
+  void drawAtlas(const sk_sp<DlImage> atlas,
+                 const SkRSXform xform[],
+                 const DlRect tex[],
+                 const DlColor colors[],
+                 int count,
+                 DlBlendMode mode,
+                 DlImageSampling sampling,
+                 const DlRect* cull_rect,
+                 bool render_with_attributes) override {}
+  void drawTextBlob(const sk_sp<SkTextBlob> blob,
+                    DlScalar x,
+                    DlScalar y) override {}
+  void drawTextFrame(const std::shared_ptr<impeller::TextFrame>& text_frame,
+                     DlScalar x,
+                     DlScalar y) override {}
+  void drawShadow(const DlPath& path,
+                  const DlColor color,
+                  const DlScalar elevation,
+                  bool transparent_occluder,
+                  DlScalar dpr) override {}
+
+ private:
+  struct Level {
+    DisplayListMatrixClipState state;
+    // Whether the clip is exactly a device space rect, in which case
+    // |clip_coverage| holds the pixels that are entirely inside of it.
+    bool clip_is_rect;
+    DlRect clip_coverage;
+    bool is_layer;
+  };
+
+  struct Candidate {
+    DlIndex index;
+    DlRect device_bounds;
+  };
+
+  std::vector<bool> culled_;
+  size_t culled_count_ = 0u;
+  DlIndex index_ = 0u;
+  std::vector<Level> levels_;
+  // The candidates of each layer that is currently open, innermost last.
+  std::vector<std::vector<Candidate>> layers_;
+
+  DisplayListMatrixClipState& state() { return levels_.back().state; }
+
+  bool PaintHasFilters() const {
+    return paint_.getImageFilter() || paint_.getMaskFilter();
+  }
+
+  bool PaintIsOpaqueFill(bool needs_fill_style) const {
+    if (needs_fill_style && paint_.getDrawStyle() != DlDrawStyle::kFill) {
+      return false;
+    }
+    if (PaintHasFilters() || paint_.getColorSource() ||
+        paint_.getColorFilter() || paint_.isInvertColors()) {
+      return false;
+    }
+    return paint_.getBlendMode() == DlBlendMode::kSrc ||
+           (paint_.getBlendMode() == DlBlendMode::kSrcOver &&
+            paint_.getColor().isOpaque());
+  }
+
+  void AddShapeCandidate(const DlRect& local_bounds) {
+    if (paint_.getDrawStyle() == DlDrawStyle::kFill) {
+      AddCandidate(local_bounds);
+    }
+  }
+
+  void AddImageCandidate(const DlRect& local_bounds,
+                         bool render_with_attributes) {
+    if (!render_with_attributes || !PaintHasFilters()) {
+      AddCandidate(local_bounds);
+    }
+  }
+
+  void AddCandidate(const DlRect& local_bounds) {
+    if (PaintHasFilters() || state().has_perspective()) {
+      return;
+    }
+    // Outset by a pixel to account for anti-aliasing and pixel snapping.
+    DlRect device_bounds =
+        DlRect::RoundOut(local_bounds.TransformAndClipBounds(state().matrix()))
+            .Expand(1.0f)
+            .IntersectionOrEmpty(state().GetDeviceCullCoverage());
+    if (device_bounds.IsEmpty()) {
+      return;
+    }
+    std::vector<Candidate>& candidates = layers_.back();
+    if (candidates.size() >= DisplayListOptimizer::kMaxOverdrawCandidates) {
+      candidates.erase(candidates.begin());
+    }
+    candidates.push_back({.index = index_, .device_bounds = device_bounds});
+  }
+
+  // Culls the candidates of the current layer that are covered by a fill
+  // of |local_rect|, or of the entire clip if it is not specified.
+  void Occlude(std::optional<DlRect> local_rect) {
+    const Level& level = levels_.back();
+    if (!level.clip_is_rect) {
+      return;
+    }
+    DlRect coverage = level.clip_coverage;
+    if (local_rect.has_value()) {
+      const DlMatrix& matrix = state().matrix();
+      if (matrix.HasPerspective() || !matrix.IsAligned2D()) {
+        return;
+      }
+      coverage = coverage.IntersectionOrEmpty(
+          RoundIn(local_rect->TransformAndClipBounds(matrix)));
+    }
+    if (coverage.IsEmpty()) {
+      return;
+    }
+    std::vector<Candidate>& candidates = layers_.back();
+    auto covered = [this, &coverage](const Candidate& candidate) {
+      if (!coverage.Contains(candidate.device_bounds)) {
+        return false;
+      }
+      culled_[candidate.index] = true;
+      culled_count_++;
+      return true;
+    };
+    candidates.erase(
+        std::remove_if(candidates.begin(), candidates.end(), covered),
+        candidates.end());
+  }
+
+  void ClearCandidates() {
+    for (std::vector<Candidate>& candidates : layers_) {
+      candidates.clear();
+    }
+  }
+};
+
+// Records the operations it receives into a DlCanvas, applying attributes
+// and transforms only when an operation that depends on them is recorded.
+//
+// Attributes are held in a DlPaint that is passed along with each rendering
+// operation, so the DisplayListBuilder only records the attributes that the
+// operation uses and that differ from what it recorded before.
+//
+// Transforms are accumulated per save level and flushed as a single
+// transform before the next clip, layer or rendering operation. Those that
+// are still pending at a restore are dropped, which in turn leaves the
+// builder with empty save/restore pairs that it does not record.
+class LazyStateRecorder final : public PaintTrackingReceiver {
+ public:
+  explicit LazyStateRecorder(DlCanvas& canvas) : canvas_(canvas) {
+    pending_.emplace_back();
+  }
+
+  void save() override {
+    canvas_.Save();
+    // The output matrix is unchanged by the save, so whatever was pending
+    // before it is still pending after it.
+    pending_.push_back(pending_.back());
+  }
+
+  void saveLayer(const DlRect& bounds,
+                 const SaveLayerOptions options,
+                 const DlImageFilter* backdrop,
+                 std::optional<int64_t> backdrop_id) override {
+    FlushTransform();
+    canvas_.SaveLayer(
+        options.bounds_from_caller() ? std::optional<DlRect>(bounds)
+                                     : std::nullopt,
+        options.renders_with_attributes() ? &paint_ : nullptr, backdrop,
+        backdrop_id);
+    pending_.emplace_back();
+  }
+
+  void restore() override {
+    if (pending_.size() <= 1u) {
+      return;
+    }
+    pending_.pop_back();
+    canvas_.Restore();
+  }
+
+  void translate(DlScalar tx, DlScalar ty) override {
+    Concat(DlMatrix::MakeTranslation({tx, ty}));
+  }
+  void scale(DlScalar sx, DlScalar sy) override {
+    Concat(DlMatrix::MakeScale({sx, sy, 1.0f}));
+  }
+  void rotate(DlScalar degrees) override {
+    Concat(DlMatrix::MakeRotationZ(DlDegrees(degrees)));
+  }
+  void skew(DlScalar sx, DlScalar sy) override {
+    Concat(DlMatrix::MakeSkew(sx, sy));
+  }
+  // clang-format off
+  void transform2DAffine(DlScalar mxx, DlScalar mxy, DlScalar mxt,
+                         DlScalar myx, DlScalar myy, DlScalar myt) override {
+    Concat(DlMatrix::MakeColumn(
+         mxx,  myx, 0.0f, 0.0f,
+         mxy,  myy, 0.0f, 0.0f,
+        0.0f, 0.0f, 1.0f, 0.0f,
+         mxt,  myt, 0.0f, 1.0f
+    ));
+  }
+  void transformFullPerspective(
+      DlScalar mxx, DlScalar mxy, DlScalar mxz, DlScalar mxt,
+      DlScalar myx, DlScalar myy, DlScalar myz, DlScalar myt,
+      DlScalar mzx, DlScalar mzy, DlScalar mzz, DlScalar mzt,
+      DlScalar mwx, DlScalar mwy, DlScalar mwz, DlScalar mwt) override {
+    Concat(DlMatrix::MakeColumn(
+        mxx, myx, mzx, mwx,
+        mxy, myy, mzy, mwy,
+        mxz, myz, mzz, mwz,
+        mxt, myt, mzt, mwt
+    ));
+  }
+  // clang-format on
+  void transformReset() override {
+    pending_.back() = {.reset = true, .matrix = DlMatrix()};
+  }
+
+  void clipRect(const DlRect& rect, ClipOp clip_op, bool is_aa) override {
+    FlushTransform();
+    canvas_.ClipRect(rect, clip_op, is_aa);
+  }
+  void clipOval(const DlRect& bounds, ClipOp clip_op, bool is_aa) override {
+    FlushTransform();
+    canvas_.ClipOval(bounds, clip_op, is_aa);
+  }
+  void clipRoundRect(const DlRoundRect& rrect,
+                     ClipOp clip_op,
+                     bool is_aa) override {
+    FlushTransform();
+    canvas_.ClipRoundRect(rrect, clip_op, is_aa);
+  }
+  void clipPath(const DlPath& path, ClipOp clip_op, bool is_aa) override {
+    FlushTransform();
+    canvas_.ClipPath(path, clip_op, is_aa);
+  }
+
+  void drawColor(DlColor color, DlBlendMode mode) override {
+    FlushTransform();
+    canvas_.DrawColor(color, mode);
+  }
+  void drawPaint() override {
+    FlushTransform();
+    canvas_.DrawPaint(paint_);
+  }
+  void drawLine(const DlPoint& p0, const DlPoint& p1) override {
+    FlushTransform();
+    canvas_.DrawLine(p0, p1, paint_);
+  }
+  void drawDashedLine(const DlPoint& p0,
+                      const DlPoint& p1,
+                      DlScalar on_length,
+                      DlScalar off_length) override {
+    FlushTransform();
+    canvas_.DrawDashedLine(p0, p1, on_length, off_length, paint_);
+  }
+  void drawRect(const DlRect& rect) override {
+    FlushTransform();
+    canvas_.DrawRect(rect, paint_);
+  }
+  void drawOval(const DlRect& bounds) override {
+    FlushTransform();
+    canvas_.DrawOval(bounds, paint_);
+  }
+  void drawCircle(const DlPoint& center, DlScalar radius) override {
+    FlushTransform();
+    canvas_.DrawCircle(center, radius, paint_);
+  }
+  void drawRoundRect(const DlRoundRect& rrect) override {
+    FlushTransform();
+    canvas_.DrawRoundRect(rrect, paint_);
+  }
+  void drawDiffRoundRect(const DlRoundRect& outer,
+                         const DlRoundRect& inner) override {
+    FlushTransform();
+    canvas_.DrawDiffRoundRect(outer, inner, paint_);
+  }
+  void drawPath(const DlPath& path) override {
+    FlushTransform();
+    canvas_.DrawPath(path, paint_);
+  }
+  void drawArc(const DlRect& oval_bounds,
+               DlScalar start_degrees,
+               DlScalar sweep_degrees,
+               bool use_center) override {
+    FlushTransform();
+    canvas_.DrawArc(oval_bounds, start_degrees, sweep_degrees, use_center,
+                    paint_);
+  }
+  void drawPoints(PointMode mode,
+                  uint32_t count,
+                  const DlPoint points[]) override {
+    FlushTransform();
+    canvas_.DrawPoints(mode, count, points, paint_);
+  }
+  void drawVertices(const std::shared_ptr<DlVertices>& vertices,
+                    DlBlendMode mode) override {
+    FlushTransform();
+    canvas_.DrawVertices(vertices, mode, paint_);
+  }
+  void drawImage(const sk_sp<DlImage> image,
+                 const DlPoint& point,
+                 DlImageSampling sampling,
+                 bool render_with_attributes) override {
+    FlushTransform();
+    canvas_.DrawImage(image, point, sampling,
+                      render_with_attributes ? &paint_ : nullptr);
+  }
+  void drawImageRect(const sk_sp<DlImage> image,
+                     const DlRect& src,
+                     const DlRect& dst,
+                     DlImageSampling sampling,
+                     bool render_with_attributes,
+                     SrcRectConstraint constraint) override {
+    FlushTransform();
+    canvas_.DrawImageRect(image, src, dst, sampling,
+                          render_with_attributes ? &paint_ : nullptr,
+                          constraint);
+  }
+  void drawImageNine(const sk_sp<DlImage> image,
+                     const DlIRect& center,
+                     const DlRect& dst,
+                     DlFilterMode filter,
+                     bool render_with_attributes) override {
+    FlushTransform();
+    canvas_.DrawImageNine(image, center, dst, filter,
+                          render_with_attributes ? &paint_ : nullptr);
+  }
+  void drawAtlas(const sk_sp<DlImage> atlas,
+                 const SkRSXform xform[],
+                 const DlRect tex[],
+                 const DlColor colors[],
+                 int count,
+                 DlBlendMode mode,
+                 DlImageSampling sampling,
+                 const DlRect* cull_rect,
+                 bool render_with_attributes) override {
+    FlushTransform();
+    canvas_.DrawAtlas(atlas, xform, tex, colors, count, mode, sampling,
+                      cull_rect, render_with_attributes ? &paint_ : nullptr);
+  }
+  void drawDisplayList(const sk_sp<DisplayList> display_list,
+                       DlScalar opacity) override {
+    FlushTransform();
+    canvas_.DrawDisplayList(display_list, opacity);
+  }
+  void drawTextBlob(const sk_sp<SkTextBlob> blob,
+                    DlScalar x,
+                    DlScalar y) override {
+    FlushTransform();
+    canvas_.DrawTextBlob(blob, x, y, paint_);
+  }
+  void drawTextFrame(const std::shared_ptr<impeller::TextFrame>& text_frame,
+                     DlScalar x,
+                     DlScalar y) override {
+    FlushTransform();
+    canvas_.DrawTextFrame(text_frame, x, y, paint_);
+  }
+  void drawShadow(const DlPath& path,
+                  const DlColor color,
+                  const DlScalar elevation,
+                  bool transparent_occluder,
+                  DlScalar dpr) override {
+    FlushTransform();
+    canvas_.DrawShadow(path, color, elevation, transparent_occluder, dpr);
+  }
+
+ private:
+  // The transform that still has to be applied to the canvas to reach the
+  // transform of the source at one save level.
+  struct PendingTransform {
+    // Whether the canvas transform must be reset before applying |matrix|.
+    bool reset = false;
+    DlMatrix matrix;
+  };
+
+  DlCanvas& canvas_;
+  std::vector<PendingTransform> pending_;
+
+  void Concat(const DlMatrix& matrix) {
+    pending_.back().matrix = pending_.back().matrix * matrix;
+  }
+
+  void FlushTransform() {
+    PendingTransform& pending = pending_.back();
+    const DlMatrix& matrix = pending.matrix;
+    if (pending.reset) {
+      canvas_.SetTransform(matrix);
+    } else if (matrix.IsTranslationOnly() && matrix.m[14] == 0.0f) {
+      // Keeps the smaller record for the common case of folded translates.
+      // The builder ignores a translate by 0, 0.
+      canvas_.Translate(matrix.m[12], matrix.m[13]);
+    } else {
+      canvas_.Transform(matrix);
+    }
+    pending = {};
+  }
+};
+
+}  // namespace
+
+sk_sp<DisplayList> DisplayListOptimizer::Optimize(
+    const sk_sp<DisplayList>& display_list) {
+  if (!display_list || display_list->GetRecordCount() == 0u) {
+    return display_list;
+  }
+  TRACE_EVENT0("flutter", "DisplayListOptimizer::Optimize");
+
+  OverdrawAnalyzer analyzer(display_list->GetRecordCount());
+  for (DlIndex index : *display_list) {
+    analyzer.SetIndex(index);
+    display_list->Dispatch(analyzer, index);
+  }
+  const std::vector<bool>& culled = analyzer.culled();
+
+  DisplayListBuilder builder(display_list->has_rtree());
+  LazyStateRecorder recorder(builder);
+  for (DlIndex index : *display_list) {
+    if (!culled[index]) {
+      display_list->Dispatch(recorder, index);
+    }
+  }
+  return builder.Build();
+}
+
+}  // namespace flutter
@@ -0,0 +1,46 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_DISPLAY_LIST_UTILS_DL_OPTIMIZER_H_
+#define FLUTTER_DISPLAY_LIST_UTILS_DL_OPTIMIZER_H_
+
+#include "flutter/display_list/display_list.h"
+
+namespace flutter {
+
+// Rewrites the records of a DisplayList into a new DisplayList that renders
+// the same output with less dispatch work. The DisplayListBuilder already
+// avoids recording some redundant operations as they are recorded, but it
+// cannot look ahead, so the optimizer additionally:
+//
+//  - drops attribute records whose values are never used by a rendering
+//    operation before they are changed again,
+//  - folds consecutive transform records into a single transform and drops
+//    transforms that are never used before the enclosing restore,
+//  - drops save/restore pairs that are left with nothing to restore,
+//  - culls rendering operations whose bounds are entirely overdrawn by a
+//    later opaque rect, paint or color fill in the same layer.
+//
+// Optimizing takes about as long as recording the DisplayList again, so it
+// is only worthwhile for DisplayLists that will be dispatched many times or
+// that are known to contain a lot of overdraw. It is never applied
+// implicitly, callers opt in for each DisplayList that they optimize.
+class DisplayListOptimizer {
+ public:
+  // The maximum number of earlier rendering operations per layer that are
+  // checked against each opaque fill for overdraw.
+  static constexpr size_t kMaxOverdrawCandidates = 64u;
+
+  // Returns a new DisplayList with the optimizations above applied, or the
+  // |display_list| itself if it is null or empty. The result has an RTree
+  // if and only if |display_list| has one.
+  static sk_sp<DisplayList> Optimize(const sk_sp<DisplayList>& display_list);
+
+ private:
+  DisplayListOptimizer() = delete;
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_DISPLAY_LIST_UTILS_DL_OPTIMIZER_H_
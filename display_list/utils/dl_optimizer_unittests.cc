@@ -0,0 +1,239 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/display_list/utils/dl_optimizer.h"
+
+#include "flutter/display_list/dl_builder.h"
+#include "flutter/display_list/effects/image_filters/dl_blur_image_filter.h"
+#include "flutter/display_list/testing/dl_test_snippets.h"
+#include "flutter/testing/testing.h"
+
+namespace flutter {
+
+DlOpReceiver& DisplayListBuilderTestingAccessor(DisplayListBuilder& builder);
+
+namespace testing {
+
+namespace {
+
+const DlRect kSmallRect = DlRect::MakeLTRB(10, 10, 20, 20);
+const DlRect kLargeRect = DlRect::MakeLTRB(0, 0, 100, 100);
+
+}  // namespace
+
+TEST(DisplayListOptimizer, NullAndEmptyDisplayListsAreReturned) {
+  EXPECT_EQ(DisplayListOptimizer::Optimize(nullptr), nullptr);
+
+  sk_sp<DisplayList> empty = DisplayListBuilder().Build();
+  EXPECT_EQ(DisplayListOptimizer::Optimize(empty), empty);
+}
+
+TEST(DisplayListOptimizer, DropsUnusedAttributes) {
+  DisplayListBuilder builder;
+  DlOpReceiver& receiver = DisplayListBuilderTestingAccessor(builder);
+  receiver.setColor(DlColor::kRed());
+  receiver.setStrokeWidth(5.0f);
+  receiver.setColor(DlColor::kBlue());
+  receiver.drawRect(kSmallRect);
+  sk_sp<DisplayList> display_list = builder.Build();
+  ASSERT_EQ(display_list->op_count(), 4u);
+
+  sk_sp<DisplayList> optimized = DisplayListOptimizer::Optimize(display_list);
+  // Only the blue color is used, the stroke width is ignored by fills.
+  EXPECT_EQ(optimized->op_count(), 2u);
+  EXPECT_EQ(optimized->GetBounds(), display_list->GetBounds());
+}
+
+TEST(DisplayListOptimizer, FoldsConsecutiveTransforms) {
+  DisplayListBuilder builder;
+  builder.Translate(10.0f, 10.0f);
+  builder.Scale(2.0f, 2.0f);
+  builder.Rotate(90.0f);
+  builder.DrawRect(kSmallRect, DlPaint());
+  sk_sp<DisplayList> display_list = builder.Build();
+  ASSERT_EQ(display_list->op_count(), 4u);
+
+  sk_sp<DisplayList> optimized = DisplayListOptimizer::Optimize(display_list);
+  EXPECT_EQ(optimized->op_count(), 2u);
+  EXPECT_EQ(optimized->GetBounds(), display_list->GetBounds());
+}
+
+TEST(DisplayListOptimizer, FoldsTransformsAfterReset) {
+  DisplayListBuilder builder;
+  builder.Scale(2.0f, 2.0f);
+  builder.TransformReset();
+  builder.Translate(10.0f, 10.0f);
+  builder.Translate(5.0f, 5.0f);
+  builder.DrawRect(kSmallRect, DlPaint());
+  sk_sp<DisplayList> display_list = builder.Build();
+
+  sk_sp<DisplayList> optimized = DisplayListOptimizer::Optimize(display_list);
+  EXPECT_LT(optimized->op_count(), display_list->op_count());
+  EXPECT_EQ(optimized->GetBounds(), DlRect::MakeLTRB(25, 25, 35, 35));
+}
+
+TEST(DisplayListOptimizer, DropsSaveRestoreWithUnusedTransforms) {
+  DisplayListBuilder builder;
+  builder.Save();
+  builder.Translate(10.0f, 10.0f);
+  builder.Restore();
+  builder.DrawRect(kSmallRect, DlPaint());
+  sk_sp<DisplayList> display_list = builder.Build();
+  ASSERT_EQ(display_list->op_count(), 4u);
+
+  sk_sp<DisplayList> optimized = DisplayListOptimizer::Optimize(display_list);
+  EXPECT_EQ(optimized->op_count(), 1u);
+  EXPECT_EQ(optimized->GetBounds(), kSmallRect);
+}
+
+TEST(DisplayListOptimizer, KeepsTransformsUsedInsideSave) {
+  DisplayListBuilder builder;
+  builder.Save();
+  builder.Translate(10.0f, 10.0f);
+  builder.DrawRect(kSmallRect, DlPaint());
+  builder.Restore();
+  builder.DrawRect(kSmallRect, DlPaint());
+  sk_sp<DisplayList> display_list = builder.Build();
+
+  sk_sp<DisplayList> optimized = DisplayListOptimizer::Optimize(display_list);
+  EXPECT_EQ(optimized->op_count(), display_list->op_count());
+  EXPECT_EQ(optimized->GetBounds(), DlRect::MakeLTRB(10, 10, 30, 30));
+}
+
+TEST(DisplayListOptimizer, CullsOpsCoveredByLaterOpaqueFill) {
+  DisplayListBuilder builder;
+  builder.DrawRect(kSmallRect, DlPaint(DlColor::kRed()));
+  builder.DrawOval(kSmallRect, DlPaint(DlColor::kGreen()));
+  builder.DrawRect(kLargeRect, DlPaint(DlColor::kBlue()));
+  sk_sp<DisplayList> display_list = builder.Build();
+  ASSERT_EQ(display_list->op_count(), 6u);
+
+  sk_sp<DisplayList> optimized = DisplayListOptimizer::Optimize(display_list);
+  EXPECT_EQ(optimized->op_count(), 2u);
+  EXPECT_EQ(optimized->GetBounds(), kLargeRect);
+}
+
+TEST(DisplayListOptimizer, CullsOpsCoveredByLaterClear) {
+  DisplayListBuilder builder;
+  builder.DrawRect(kSmallRect, DlPaint(DlColor::kRed()));
+  builder.Clear(DlColor::kTransparent());
+  builder.DrawRect(kLargeRect, DlPaint(DlColor::kRed()));
+  sk_sp<DisplayList> display_list = builder.Build();
+
+  sk_sp<DisplayList> optimized = DisplayListOptimizer::Optimize(display_list);
+  EXPECT_EQ(optimized->op_count(), display_list->op_count() - 1u);
+}
+
+TEST(DisplayListOptimizer, DoesNotCullPartiallyCoveredOps) {
+  DisplayListBuilder builder;
+  builder.DrawRect(kSmallRect, DlPaint(DlColor::kRed()));
+  builder.DrawRect(DlRect::MakeLTRB(0, 0, 15, 100), DlPaint(DlColor::kBlue()));
+  sk_sp<DisplayList> display_list = builder.Build();
+
+  sk_sp<DisplayList> optimized = DisplayListOptimizer::Optimize(display_list);
+  EXPECT_EQ(optimized->op_count(), display_list->op_count());
+}
+
+TEST(DisplayListOptimizer, DoesNotCullUnderTranslucentFill) {
+  DisplayListBuilder builder;
+  builder.DrawRect(kSmallRect, DlPaint(DlColor::kRed()));
+  builder.DrawRect(kLargeRect, DlPaint(DlColor::kBlue().withAlpha(0x80)));
+  sk_sp<DisplayList> display_list = builder.Build();
+
+  sk_sp<DisplayList> optimized = DisplayListOptimizer::Optimize(display_list);
+  EXPECT_EQ(optimized->op_count(), display_list->op_count());
+}
+
+TEST(DisplayListOptimizer, DoesNotCullUnderStrokedRect) {
+  DisplayListBuilder builder;
+  builder.DrawRect(kSmallRect, DlPaint(DlColor::kRed()));
+  builder.DrawRect(kLargeRect, DlPaint(DlColor::kBlue())
+                                   .setDrawStyle(DlDrawStyle::kStroke)
+                                   .setStrokeWidth(200.0f));
+  sk_sp<DisplayList> display_list = builder.Build();
+
+  sk_sp<DisplayList> optimized = DisplayListOptimizer::Optimize(display_list);
+  EXPECT_EQ(optimized->op_count(), display_list->op_count());
+}
+
+TEST(DisplayListOptimizer, DoesNotCullInsideNonRectClip) {
+  DisplayListBuilder builder;
+  builder.DrawRect(kSmallRect, DlPaint(DlColor::kRed()));
+  builder.ClipOval(kLargeRect);
+  builder.DrawRect(kLargeRect, DlPaint(DlColor::kBlue()));
+  sk_sp<DisplayList> display_list = builder.Build();
+
+  sk_sp<DisplayList> optimized = DisplayListOptimizer::Optimize(display_list);
+  EXPECT_EQ(optimized->op_count(), display_list->op_count());
+}
+
+TEST(DisplayListOptimizer, DoesNotCullUnderRotatedFill) {
+  DisplayListBuilder builder;
+  builder.DrawRect(kSmallRect, DlPaint(DlColor::kRed()));
+  builder.Rotate(45.0f);
+  builder.DrawRect(DlRect::MakeLTRB(-200, -200, 200, 200),
+                   DlPaint(DlColor::kBlue()));
+  sk_sp<DisplayList> display_list = builder.Build();
+
+  sk_sp<DisplayList> optimized = DisplayListOptimizer::Optimize(display_list);
+  EXPECT_EQ(optimized->op_count(), display_list->op_count());
+}
+
+TEST(DisplayListOptimizer, DoesNotCullAcrossBackdropFilter) {
+  DlBlurImageFilter backdrop(5.0f, 5.0f, DlTileMode::kClamp);
+  DisplayListBuilder builder;
+  builder.DrawRect(kSmallRect, DlPaint(DlColor::kRed()));
+  builder.SaveLayer(std::nullopt, nullptr, &backdrop);
+  builder.DrawRect(kLargeRect, DlPaint(DlColor::kBlue()));
+  builder.Restore();
+  builder.DrawRect(kLargeRect, DlPaint(DlColor::kBlue()));
+  sk_sp<DisplayList> display_list = builder.Build();
+
+  sk_sp<DisplayList> optimized = DisplayListOptimizer::Optimize(display_list);
+  EXPECT_EQ(optimized->op_count(), display_list->op_count());
+}
+
+TEST(DisplayListOptimizer, OnlyCullsWithinTheSameLayer) {
+  DisplayListBuilder builder;
+  builder.SaveLayer(std::nullopt, nullptr);
+  builder.DrawRect(kSmallRect, DlPaint(DlColor::kRed()));
+  builder.Restore();
+  builder.DrawRect(kLargeRect, DlPaint(DlColor::kBlue()));
+  sk_sp<DisplayList> display_list = builder.Build();
+
+  sk_sp<DisplayList> optimized = DisplayListOptimizer::Optimize(display_list);
+  EXPECT_EQ(optimized->op_count(), display_list->op_count());
+}
+
+TEST(DisplayListOptimizer, PreservesRTree) {
+  DisplayListBuilder builder(/*prepare_rtree=*/true);
+  builder.DrawRect(kSmallRect, DlPaint());
+  sk_sp<DisplayList> optimized =
+      DisplayListOptimizer::Optimize(builder.Build());
+  EXPECT_TRUE(optimized->has_rtree());
+
+  DisplayListBuilder no_rtree_builder(/*prepare_rtree=*/false);
+  no_rtree_builder.DrawRect(kSmallRect, DlPaint());
+  optimized = DisplayListOptimizer::Optimize(no_rtree_builder.Build());
+  EXPECT_FALSE(optimized->has_rtree());
+}
+
+TEST(DisplayListOptimizer, NeverGrowsAnyTestDisplayList) {
+  for (DisplayListInvocationGroup& group : CreateAllGroups()) {
+    for (DisplayListInvocation& invocation : group.variants) {
+      DisplayListBuilder builder;
+      invocation.Invoke(DisplayListBuilderTestingAccessor(builder));
+      sk_sp<DisplayList> display_list = builder.Build();
+      sk_sp<DisplayList> optimized =
+          DisplayListOptimizer::Optimize(display_list);
+      EXPECT_LE(optimized->op_count(true), display_list->op_count(true))
+          << group.op_name;
+      EXPECT_EQ(optimized->GetBounds(), display_list->GetBounds())
+          << group.op_name;
+    }
+  }
+}
+
+}  // namespace testing
+}  // namespace flutter
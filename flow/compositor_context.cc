@@ -7,6 +7,7 @@
 #include <optional>
 #include <utility>
 #include "flutter/flow/layers/layer_tree.h"
+#include "flutter/fml/time/time_point.h"
 #include "third_party/skia/include/core/SkCanvas.h"
 
 namespace flutter {
@@ -35,8 +36,11 @@ std::optional<SkRect> FrameDamage::ComputeClipRect(
       } else {
         prev_root_layer = prev_layer_tree_->root_layer();
       }
+      fml::TimePoint diff_start = fml::TimePoint::Now();
       layer_tree.root_layer()->Diff(&context, prev_root_layer);
+      context.statistics().SetDiffTime(fml::TimePoint::Now() - diff_start);
     }
+    context.statistics().LogStatistics();
 
     damage_ =
         context.ComputeDamage(additional_damage_, horizontal_clip_alignment_,
@@ -120,6 +124,57 @@ RasterStatus CompositorContext::ScopedFrame::Raster(
     FrameDamage* frame_damage) {
   TRACE_EVENT0("flutter", "CompositorContext::ScopedFrame::Raster");
 
+  std::optional<SkRect> clip_rect =
+      ComputeClipRect(layer_tree, ignore_raster_cache, frame_damage);
+
+  bool root_needs_readback = layer_tree.Preroll(
+      *this, ignore_raster_cache, clip_rect ? *clip_rect : kGiantRect);
+  bool needs_save_layer = root_needs_readback && !surface_supports_readback();
+  RasterStatus post_preroll_status = PostPreroll();
+  if (post_preroll_status != RasterStatus::kSuccess) {
+    return post_preroll_status;
+  }
+
+  if (aiks_context_) {
+    PaintLayerTreeImpeller(layer_tree, clip_rect, ignore_raster_cache);
+  } else {
+    PaintLayerTreeSkia(layer_tree, clip_rect, needs_save_layer,
+                       ignore_raster_cache);
+  }
+  return RasterStatus::kSuccess;
+}
+
+RasterStatus CompositorContext::ScopedFrame::RasterRecording(
+    flutter::LayerTree& layer_tree,
+    const sk_sp<DisplayList>& recording,
+    FrameDamage* frame_damage) {
+  TRACE_EVENT0("flutter", "CompositorContext::ScopedFrame::RasterRecording");
+  FML_DCHECK(aiks_context_);
+
+  std::optional<SkRect> clip_rect =
+      ComputeClipRect(layer_tree, /*ignore_raster_cache=*/true, frame_damage);
+
+  RasterStatus post_preroll_status = PostPreroll();
+  if (post_preroll_status != RasterStatus::kSuccess) {
+    return post_preroll_status;
+  }
+
+  if (canvas()) {
+    // The recording covers the whole view, so it is clipped to the damage
+    // that the tree would have been culled to when prerolled.
+    if (clip_rect) {
+      canvas()->Translate(-clip_rect->x(), -clip_rect->y());
+      canvas()->ClipRect(*clip_rect);
+    }
+    canvas()->DrawDisplayList(recording);
+  }
+  return RasterStatus::kSuccess;
+}
+
+std::optional<SkRect> CompositorContext::ScopedFrame::ComputeClipRect(
+    flutter::LayerTree& layer_tree,
+    bool ignore_raster_cache,
+    FrameDamage* frame_damage) {
   std::optional<SkRect> clip_rect;
   if (frame_damage) {
     clip_rect = frame_damage->ComputeClipRect(layer_tree, !ignore_raster_cache,
@@ -131,10 +186,10 @@ RasterStatus CompositorContext::ScopedFrame::Raster(
       frame_damage->Reset();
     }
   }
+  return clip_rect;
+}
 
-  bool root_needs_readback = layer_tree.Preroll(
-      *this, ignore_raster_cache, clip_rect ? *clip_rect : kGiantRect);
-  bool needs_save_layer = root_needs_readback && !surface_supports_readback();
+RasterStatus CompositorContext::ScopedFrame::PostPreroll() {
   PostPrerollResult post_preroll_result = PostPrerollResult::kSuccess;
   if (view_embedder_ && raster_thread_merger_) {
     post_preroll_result =
@@ -147,13 +202,6 @@ RasterStatus CompositorContext::ScopedFrame::Raster(
   if (post_preroll_result == PostPrerollResult::kSkipAndRetryFrame) {
     return RasterStatus::kSkipAndRetry;
   }
-
-  if (aiks_context_) {
-    PaintLayerTreeImpeller(layer_tree, clip_rect, ignore_raster_cache);
-  } else {
-    PaintLayerTreeSkia(layer_tree, clip_rect, needs_save_layer,
-                       ignore_raster_cache);
-  }
   return RasterStatus::kSuccess;
 }
 
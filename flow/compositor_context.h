@@ -10,6 +10,7 @@
 
 #include "flutter/common/graphics/texture.h"
 #include "flutter/common/macros.h"
+#include "flutter/display_list/display_list.h"
 #include "flutter/flow/diff_context.h"
 #include "flutter/flow/embedded_views.h"
 #include "flutter/flow/raster_cache.h"
@@ -139,7 +140,22 @@ class CompositorContext {
                                 bool ignore_raster_cache,
                                 FrameDamage* frame_damage);
 
+    // Like |Raster|, but draws a |recording| of the layer tree made by
+    // |LayerTree::Record| instead of prerolling and painting the tree
+    // itself. The layer tree is still diffed to compute the frame damage.
+    //
+    // Only supported with Impeller and without the raster cache.
+    virtual RasterStatus RasterRecording(LayerTree& layer_tree,
+                                         const sk_sp<DisplayList>& recording,
+                                         FrameDamage* frame_damage);
+
    private:
+    std::optional<SkRect> ComputeClipRect(flutter::LayerTree& layer_tree,
+                                          bool ignore_raster_cache,
+                                          FrameDamage* frame_damage);
+
+    RasterStatus PostPreroll();
+
     void PaintLayerTreeSkia(flutter::LayerTree& layer_tree,
                             std::optional<SkRect> clip_rect,
                             bool needs_save_layer,
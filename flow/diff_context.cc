@@ -284,7 +284,9 @@ void DiffContext::Statistics::LogStatistics() {
                     deep_compare_pictures_, "SameInstancePictures",
                     same_instance_pictures_,
                     "DifferentInstanceButEqualPictures",
-                    different_instance_but_equal_pictures_);
+                    different_instance_but_equal_pictures_,
+                    "SameContentHashPictures", same_content_hash_pictures_,
+                    "DiffTimeMicros", diff_time_.ToMicroseconds());
 #endif  // !FLUTTER_RELEASE
 }
 
@@ -12,6 +12,7 @@
 #include "display_list/utils/dl_matrix_clip_tracker.h"
 #include "flutter/flow/paint_region.h"
 #include "flutter/fml/macros.h"
+#include "flutter/fml/time/time_delta.h"
 #include "third_party/skia/include/core/SkM44.h"
 #include "third_party/skia/include/core/SkMatrix.h"
 #include "third_party/skia/include/core/SkRect.h"
@@ -192,6 +193,13 @@ class DiffContext {
       ++different_instance_but_equal_pictures_;
     };
 
+    // Picture that is a different instance but has the same content hash, so
+    // was found to be equal in constant time
+    void AddSameContentHashPicture() { ++same_content_hash_pictures_; }
+
+    // Time spent diffing the layer tree for the frame
+    void SetDiffTime(fml::TimeDelta diff_time) { diff_time_ = diff_time; }
+
     // Logs the statistics to trace counter
     void LogStatistics();
 
@@ -201,6 +209,8 @@ class DiffContext {
     int same_instance_pictures_ = 0;
     int deep_compare_pictures_ = 0;
     int different_instance_but_equal_pictures_ = 0;
+    int same_content_hash_pictures_ = 0;
+    fml::TimeDelta diff_time_;
   };
 
   Statistics& statistics() { return statistics_; }
@@ -0,0 +1,406 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/benchmarking/benchmarking.h"
+
+#include <memory>
+#include <vector>
+
+#include "flutter/display_list/dl_builder.h"
+#include "flutter/flow/compositor_context.h"
+#include "flutter/flow/diff_context.h"
+#include "flutter/flow/layers/clip_rect_layer.h"
+#include "flutter/flow/layers/container_layer.h"
+#include "flutter/flow/layers/display_list_layer.h"
+#include "flutter/flow/layers/display_list_raster_cache_item.h"
+#include "flutter/flow/layers/layer_tree.h"
+#include "flutter/flow/layers/opacity_layer.h"
+#include "flutter/flow/layers/transform_layer.h"
+#include "flutter/flow/raster_cache.h"
+#include "flutter/flow/stopwatch.h"
+#include "flutter/fml/logging.h"
+
+namespace flutter {
+
+namespace {
+
+constexpr SkISize kFrameSize = SkISize::Make(1000, 1000);
+constexpr int kLeafSize = 60;
+
+// The shape of a synthetic layer tree. Every container holds a leaf
+// DisplayListLayer followed by |fanout| child containers, down to |depth|
+// levels of nesting. The innermost containers hold |fanout| leaves.
+struct LayerTreeShape {
+  int depth;
+  int fanout;
+};
+
+// A long chain of nested containers, as produced by deeply nested widgets.
+constexpr LayerTreeShape kDeepTree = {48, 1};
+// A flat list of pictures, as produced by a long list of repaint boundaries.
+constexpr LayerTreeShape kWideTree = {0, 2000};
+// A dashboard of cards with a few levels of nested panels.
+constexpr LayerTreeShape kDashboardTree = {3, 6};
+
+SkPoint LeafOffset(int index) {
+  return SkPoint::Make((index * 37) % (kFrameSize.width() - kLeafSize),
+                       (index * 61) % (kFrameSize.height() - kLeafSize));
+}
+
+sk_sp<DisplayList> MakeLeafDisplayList(int index) {
+  DisplayListBuilder builder;
+  uint32_t rgb = static_cast<uint32_t>(index) * 0x010307u;
+  DlPaint paint(DlColor(0xFF000000u | rgb));
+  builder.DrawRect(SkRect::MakeWH(kLeafSize, kLeafSize), paint);
+  paint.setColor(DlColor::kWhite().withAlpha(0x80));
+  builder.DrawRRect(SkRRect::MakeRectXY(SkRect::MakeLTRB(5, 5, 55, 55), 8, 8),
+                    paint);
+  paint.setDrawStyle(DlDrawStyle::kStroke).setStrokeWidth(3.0f);
+  builder.DrawCircle(SkPoint::Make(30, 30), 20, paint);
+  return builder.Build();
+}
+
+std::shared_ptr<Layer> MakeLeaf(int index) {
+  return std::make_shared<DisplayListLayer>(LeafOffset(index),
+                                            MakeLeafDisplayList(index),
+                                            /*is_complex=*/false,
+                                            /*will_change=*/false);
+}
+
+// Alternates between the container layers that are most common in
+// application scenes.
+std::shared_ptr<ContainerLayer> MakeContainer(int depth) {
+  switch (depth % 3) {
+    case 0:
+      return std::make_shared<OpacityLayer>(0xC0, SkPoint::Make(1, 1));
+    case 1:
+      return std::make_shared<TransformLayer>(
+          SkMatrix::Translate(2, 3).preScale(0.99f, 0.99f));
+    default:
+      return std::make_shared<ClipRectLayer>(
+          SkRect::MakeXYWH((depth * 13) % 100, (depth * 17) % 100, 900, 900),
+          Clip::kHardEdge);
+  }
+}
+
+void AddLayers(ContainerLayer* parent,
+               const LayerTreeShape& shape,
+               int depth,
+               int* index) {
+  if (depth == 0) {
+    for (int i = 0; i < shape.fanout; i++) {
+      parent->Add(MakeLeaf((*index)++));
+    }
+    return;
+  }
+  for (int i = 0; i < shape.fanout; i++) {
+    std::shared_ptr<ContainerLayer> container = MakeContainer(depth);
+    container->Add(MakeLeaf((*index)++));
+    AddLayers(container.get(), shape, depth - 1, index);
+    parent->Add(container);
+  }
+}
+
+std::shared_ptr<ContainerLayer> MakeRootLayer(const LayerTreeShape& shape) {
+  auto root = std::make_shared<ContainerLayer>();
+  int index = 0;
+  AddLayers(root.get(), shape, shape.depth, &index);
+  return root;
+}
+
+std::unique_ptr<CompositorContext::ScopedFrame> AcquireFrame(
+    CompositorContext& context,
+    DlCanvas* canvas) {
+  return context.AcquireFrame(/*gr_context=*/nullptr, canvas,
+                              /*view_embedder=*/nullptr, SkMatrix::I(),
+                              /*instrumentation_enabled=*/false,
+                              /*surface_supports_readback=*/true,
+                              /*raster_thread_merger=*/nullptr,
+                              /*aiks_context=*/nullptr);
+}
+
+// Fills |container| with the children of |old_container| made by
+// |AddLayers|, except for the last leaf in the tree, which is replaced with
+// new content. The containers on the way to that leaf are replaced too, the
+// way the framework does when a single picture of the scene changes.
+void RetainAllButLastLeaf(ContainerLayer* container,
+                          const ContainerLayer* old_container,
+                          int depth,
+                          int* index) {
+  const auto& old_layers = old_container->layers();
+  for (size_t i = 0; i + 1 < old_layers.size(); i++) {
+    container->Add(old_layers[i]);
+  }
+  if (depth == 0) {
+    container->Add(MakeLeaf((*index)++));
+    return;
+  }
+  auto* old_last = static_cast<ContainerLayer*>(old_layers.back().get());
+  std::shared_ptr<ContainerLayer> last = MakeContainer(depth);
+  last->AssignOldLayer(old_last);
+  RetainAllButLastLeaf(last.get(), old_last, depth - 1, index);
+  container->Add(last);
+}
+
+// Diffs |root| against an empty tree to record the paint regions of all of
+// its layers, as if it had been rendered in the previous frame.
+PaintRegionMap RecordPaintRegions(ContainerLayer* root) {
+  PaintRegionMap paint_region_map;
+  PaintRegionMap empty_paint_region_map;
+  ContainerLayer empty_root;
+  DiffContext context(kFrameSize, paint_region_map, empty_paint_region_map,
+                      /*has_raster_cache=*/false, /*impeller_enabled=*/false);
+  context.PushCullRect(SkRect::Make(kFrameSize));
+  root->Diff(&context, &empty_root);
+  return paint_region_map;
+}
+
+void DiffLayerTrees(benchmark::State& state,
+                    ContainerLayer* root,
+                    ContainerLayer* old_root,
+                    const PaintRegionMap& old_paint_region_map) {
+  while (state.KeepRunning()) {
+    PaintRegionMap paint_region_map;
+    DiffContext context(kFrameSize, paint_region_map, old_paint_region_map,
+                        /*has_raster_cache=*/false,
+                        /*impeller_enabled=*/false);
+    context.PushCullRect(SkRect::Make(kFrameSize));
+    root->Diff(&context, old_root);
+    Damage damage = context.ComputeDamage(SkIRect::MakeEmpty());
+    benchmark::DoNotOptimize(damage);
+  }
+}
+
+}  // namespace
+
+static void BM_LayerTreePreroll(benchmark::State& state,
+                                const LayerTreeShape& shape) {
+  LayerTree layer_tree(MakeRootLayer(shape), kFrameSize);
+  CompositorContext compositor_context;
+  DisplayListBuilder builder(SkRect::Make(kFrameSize));
+  auto frame = AcquireFrame(compositor_context, &builder);
+
+  while (state.KeepRunning()) {
+    layer_tree.Preroll(*frame, /*ignore_raster_cache=*/true);
+  }
+}
+
+static void BM_LayerTreePaint(benchmark::State& state,
+                              const LayerTreeShape& shape) {
+  LayerTree layer_tree(MakeRootLayer(shape), kFrameSize);
+  CompositorContext compositor_context;
+  {
+    DisplayListBuilder builder(SkRect::Make(kFrameSize));
+    auto frame = AcquireFrame(compositor_context, &builder);
+    layer_tree.Preroll(*frame, /*ignore_raster_cache=*/true);
+  }
+
+  while (state.KeepRunning()) {
+    DisplayListBuilder builder(SkRect::Make(kFrameSize));
+    auto frame = AcquireFrame(compositor_context, &builder);
+    layer_tree.Paint(*frame, /*ignore_raster_cache=*/true);
+    benchmark::DoNotOptimize(builder.Build());
+  }
+}
+
+// Diffs a frame in which a single leaf was replaced and all of the layers
+// that are not on the way to it were retained from the previous frame.
+static void BM_DiffContextRetainedTree(benchmark::State& state,
+                                       const LayerTreeShape& shape) {
+  std::shared_ptr<ContainerLayer> old_root = MakeRootLayer(shape);
+  PaintRegionMap old_paint_region_map = RecordPaintRegions(old_root.get());
+
+  auto root = std::make_shared<ContainerLayer>();
+  int index = 1 << 16;
+  RetainAllButLastLeaf(root.get(), old_root.get(), shape.depth, &index);
+
+  DiffLayerTrees(state, root.get(), old_root.get(), old_paint_region_map);
+}
+
+// Diffs a frame in which the whole tree was rebuilt with the same content,
+// which compares the display lists of all of the leaves.
+static void BM_DiffContextRebuiltTree(benchmark::State& state,
+                                      const LayerTreeShape& shape) {
+  std::shared_ptr<ContainerLayer> old_root = MakeRootLayer(shape);
+  PaintRegionMap old_paint_region_map = RecordPaintRegions(old_root.get());
+  std::shared_ptr<ContainerLayer> root = MakeRootLayer(shape);
+
+  DiffLayerTrees(state, root.get(), old_root.get(), old_paint_region_map);
+}
+
+#if !SLIMPELLER
+
+namespace {
+
+// Drives a raster cache through the frames of a list of display list layers
+// the same way |LayerTree| does, but without the limit on the number of
+// display lists that may be rasterized in a single frame.
+class RasterCacheFrames {
+ public:
+  explicit RasterCacheFrames(int item_count)
+      : raster_cache_(/*access_threshold=*/1,
+                      /*picture_and_display_list_cache_limit_per_frame=*/
+                      item_count) {
+    for (int i = 0; i < item_count; i++) {
+      items_.push_back(DisplayListRasterCacheItem::Make(
+          MakeLeafDisplayList(i), LeafOffset(i), /*is_complex=*/true,
+          /*will_change=*/false));
+    }
+  }
+
+  RasterCache& raster_cache() { return raster_cache_; }
+
+  // Starts a new frame in which every item is visible.
+  void Preroll() {
+    raster_cache_.BeginFrame();
+    raster_cache_items_.clear();
+
+    LayerStateStack state_stack;
+    state_stack.set_preroll_delegate(kGiantRect, SkMatrix::I());
+    PrerollContext context = {
+        // clang-format off
+        .raster_cache                  = &raster_cache_,
+        .gr_context                    = nullptr,
+        .view_embedder                 = nullptr,
+        .state_stack                   = state_stack,
+        .dst_color_space               = nullptr,
+        .surface_needs_readback        = false,
+        .raster_time                   = raster_time_,
+        .ui_time                       = ui_time_,
+        .texture_registry              = nullptr,
+        .raster_cached_entries         = &raster_cache_items_,
+        // clang-format on
+    };
+    for (const auto& item : items_) {
+      item->PrerollSetup(&context, SkMatrix::I());
+      item->PrerollFinalize(&context, SkMatrix::I());
+    }
+  }
+
+  // Evicts the entries that were not seen in this frame and rasterizes the
+  // entries that were seen often enough.
+  void Prepare() {
+    LayerStateStack state_stack;
+    PaintContext context = {
+        // clang-format off
+        .state_stack                   = state_stack,
+        .canvas                        = nullptr,
+        .gr_context                    = nullptr,
+        .dst_color_space               = nullptr,
+        .view_embedder                 = nullptr,
+        .raster_time                   = raster_time_,
+        .ui_time                       = ui_time_,
+        .texture_registry              = nullptr,
+        .raster_cache                  = &raster_cache_,
+        .aiks_context                  = nullptr,
+        // clang-format on
+    };
+    raster_cache_.EvictUnusedCacheEntries();
+    LayerTree::TryToRasterCache(raster_cache_items_, &context);
+  }
+
+  void EndFrame() { raster_cache_.EndFrame(); }
+
+  // Runs frames until every item has been rasterized.
+  void Fill() {
+    for (size_t i = 0; i <= raster_cache_.access_threshold(); i++) {
+      Preroll();
+      Prepare();
+      EndFrame();
+    }
+  }
+
+ private:
+  RasterCache raster_cache_;
+  std::vector<std::unique_ptr<DisplayListRasterCacheItem>> items_;
+  std::vector<RasterCacheItem*> raster_cache_items_;
+  FixedRefreshRateStopwatch raster_time_;
+  FixedRefreshRateStopwatch ui_time_;
+};
+
+}  // namespace
+
+static void BM_RasterCachePrepare(benchmark::State& state) {
+  RasterCacheFrames frames(state.range(0));
+
+  while (state.KeepRunning()) {
+    state.PauseTiming();
+    frames.raster_cache().Clear();
+    // The first sighting of an entry is below the access threshold.
+    frames.Preroll();
+    frames.Prepare();
+    frames.EndFrame();
+    frames.Preroll();
+    state.ResumeTiming();
+
+    frames.Prepare();
+
+    state.PauseTiming();
+    FML_CHECK(frames.raster_cache().GetPictureCachedEntriesCount() ==
+              static_cast<size_t>(state.range(0)));
+    frames.EndFrame();
+    state.ResumeTiming();
+  }
+}
+
+static void BM_RasterCacheEvict(benchmark::State& state) {
+  RasterCacheFrames frames(state.range(0));
+
+  while (state.KeepRunning()) {
+    state.PauseTiming();
+    frames.raster_cache().Clear();
+    frames.Fill();
+    FML_CHECK(frames.raster_cache().EstimatePictureCacheByteSize() > 0u);
+    // None of the items are seen in this frame.
+    frames.raster_cache().BeginFrame();
+    state.ResumeTiming();
+
+    frames.raster_cache().EvictUnusedCacheEntries();
+
+    state.PauseTiming();
+    frames.EndFrame();
+    state.ResumeTiming();
+  }
+}
+
+BENCHMARK(BM_RasterCachePrepare)
+    ->Arg(16)
+    ->Arg(128)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_RasterCacheEvict)
+    ->Arg(16)
+    ->Arg(128)
+    ->Unit(benchmark::kMicrosecond);
+
+#endif  //  !SLIMPELLER
+
+BENCHMARK_CAPTURE(BM_LayerTreePreroll, Deep, kDeepTree)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_LayerTreePreroll, Wide, kWideTree)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_LayerTreePreroll, Dashboard, kDashboardTree)
+    ->Unit(benchmark::kMicrosecond);
+
+BENCHMARK_CAPTURE(BM_LayerTreePaint, Deep, kDeepTree)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_LayerTreePaint, Wide, kWideTree)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_LayerTreePaint, Dashboard, kDashboardTree)
+    ->Unit(benchmark::kMicrosecond);
+
+BENCHMARK_CAPTURE(BM_DiffContextRetainedTree, Deep, kDeepTree)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_DiffContextRetainedTree, Wide, kWideTree)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_DiffContextRetainedTree, Dashboard, kDashboardTree)
+    ->Unit(benchmark::kMicrosecond);
+
+BENCHMARK_CAPTURE(BM_DiffContextRebuiltTree, Deep, kDeepTree)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_DiffContextRebuiltTree, Wide, kWideTree)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_DiffContextRebuiltTree, Dashboard, kDashboardTree)
+    ->Unit(benchmark::kMicrosecond);
+
+}  // namespace flutter
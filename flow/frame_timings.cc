@@ -236,6 +236,20 @@ FrameTiming FrameTimingsRecorder::GetRecordedTime() const {
   return timing_;
 }
 
+void FrameTimingsRecorder::RecordViewRasterDuration(
+    int64_t view_id,
+    fml::TimeDelta raster_duration) {
+  std::scoped_lock state_lock(state_mutex_);
+  FML_DCHECK(state_ == State::kRasterStart);
+  view_raster_durations_[view_id] = raster_duration;
+}
+
+std::map<int64_t, fml::TimeDelta>
+FrameTimingsRecorder::GetViewRasterDurations() const {
+  std::scoped_lock state_lock(state_mutex_);
+  return view_raster_durations_;
+}
+
 std::unique_ptr<FrameTimingsRecorder> FrameTimingsRecorder::CloneUntil(
     State state) {
   std::scoped_lock state_lock(state_mutex_);
@@ -259,6 +273,7 @@ std::unique_ptr<FrameTimingsRecorder> FrameTimingsRecorder::CloneUntil(
 
   if (state >= State::kRasterStart) {
     recorder->raster_start_ = raster_start_;
+    recorder->view_raster_durations_ = view_raster_durations_;
   }
 
   if (state >= State::kRasterEnd) {
@@ -5,6 +5,7 @@
 #ifndef FLUTTER_FLOW_FRAME_TIMINGS_H_
 #define FLUTTER_FLOW_FRAME_TIMINGS_H_
 
+#include <map>
 #include <mutex>
 
 #include "flutter/common/settings.h"
@@ -99,6 +100,16 @@ class FrameTimingsRecorder {
   /// Records a raster start event.
   void RecordRasterStart(fml::TimePoint raster_start);
 
+  /// Records the time spent on the rasterization of the view with the given
+  /// id alone, which excludes the time spent waiting for the other views of
+  /// the frame. Can be called from any thread after the raster start event
+  /// and before the raster end event.
+  void RecordViewRasterDuration(int64_t view_id,
+                                fml::TimeDelta raster_duration);
+
+  /// The raster durations recorded for each view of the frame.
+  std::map<int64_t, fml::TimeDelta> GetViewRasterDurations() const;
+
   /// Clones the recorder until (and including) the specified state.
   std::unique_ptr<FrameTimingsRecorder> CloneUntil(State state);
 
@@ -158,6 +169,8 @@ class FrameTimingsRecorder {
   size_t picture_cache_count_;
   size_t picture_cache_bytes_;
 
+  std::map<int64_t, fml::TimeDelta> view_raster_durations_;
+
   // Set when `RecordRasterEnd` is called. Cannot be reset once set.
   FrameTiming timing_;
 
@@ -75,6 +75,32 @@ TEST(FrameTimingsRecorderTest, RecordRasterTimes) {
   ASSERT_EQ(recorder->GetPictureCacheBytes(), 0u);
 }
 
+TEST(FrameTimingsRecorderTest, RecordViewRasterDurations) {
+  auto recorder = std::make_unique<FrameTimingsRecorder>();
+
+  const auto now = fml::TimePoint::Now();
+  recorder->RecordVsync(now, now + fml::TimeDelta::FromMilliseconds(16));
+  recorder->RecordBuildStart(fml::TimePoint::Now());
+  recorder->RecordBuildEnd(fml::TimePoint::Now());
+  recorder->RecordRasterStart(fml::TimePoint::Now());
+
+  const auto view_1_duration = fml::TimeDelta::FromMilliseconds(2);
+  const auto view_2_duration = fml::TimeDelta::FromMilliseconds(3);
+  recorder->RecordViewRasterDuration(1, view_1_duration);
+  recorder->RecordViewRasterDuration(2, view_2_duration);
+
+  // The durations recorded before the raster end are kept by clones.
+  const auto clone =
+      recorder->CloneUntil(FrameTimingsRecorder::State::kRasterStart);
+  recorder->RecordRasterEnd();
+
+  const auto durations = recorder->GetViewRasterDurations();
+  ASSERT_EQ(durations.size(), 2u);
+  EXPECT_EQ(durations.at(1), view_1_duration);
+  EXPECT_EQ(durations.at(2), view_2_duration);
+  EXPECT_EQ(clone->GetViewRasterDurations(), durations);
+}
+
 TEST(FrameTimingsRecorderTest, RecordRasterTimesWithCache) {
   auto recorder = std::make_unique<FrameTimingsRecorder>();
 
@@ -77,6 +77,15 @@ bool DisplayListLayer::Compare(DiffContext::Statistics& statistics,
     return false;
   }
 
+  // Identical records are found in constant time regardless of size.
+  if (dl1->content_hash() == dl2->content_hash()) {
+    statistics.AddSameContentHashPicture();
+    return true;
+  }
+
+  // The records differ, but possibly only in the identity of equivalent
+  // referenced objects (e.g. a path or filter recreated for every frame)
+  // which needs a deep comparison to detect.
   if (op_bytes_1 > kMaxBytesToCompare) {
     statistics.AddPictureTooComplexToCompare();
     return false;
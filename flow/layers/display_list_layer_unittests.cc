@@ -439,6 +439,38 @@ TEST_F(DisplayListLayerDiffTest, DisplayListCompare) {
   EXPECT_EQ(damage.frame_damage, SkIRect::MakeLTRB(20, 20, 70, 70));
 }
 
+TEST_F(DisplayListLayerDiffTest, LargeDisplayListCompare) {
+  auto build = [](DlColor last_color) {
+    DisplayListBuilder builder;
+    for (int i = 0; i < 500; i++) {
+      DlColor color = (i == 499) ? last_color : DlColor(0xFF000000 | i);
+      builder.DrawRect(DlRect::MakeLTRB(10, 10, 60, 60), DlPaint(color));
+    }
+    return builder.Build();
+  };
+
+  MockLayerTree tree1;
+  auto display_list1 = build(DlColor::kGreen());
+  ASSERT_GT(display_list1->bytes(), DisplayListLayer::kMaxBytesToCompare);
+  tree1.root()->Add(CreateDisplayListLayer(display_list1));
+
+  auto damage = DiffLayerTree(tree1, MockLayerTree());
+  EXPECT_EQ(damage.frame_damage, SkIRect::MakeLTRB(10, 10, 60, 60));
+
+  // Too large for a deep comparison, but the records are identical.
+  MockLayerTree tree2;
+  tree2.root()->Add(CreateDisplayListLayer(build(DlColor::kGreen())));
+
+  damage = DiffLayerTree(tree2, tree1);
+  EXPECT_EQ(damage.frame_damage, SkIRect::MakeEmpty());
+
+  MockLayerTree tree3;
+  tree3.root()->Add(CreateDisplayListLayer(build(DlColor::kRed())));
+
+  damage = DiffLayerTree(tree3, tree2);
+  EXPECT_EQ(damage.frame_damage, SkIRect::MakeLTRB(10, 10, 60, 60));
+}
+
 TEST_F(DisplayListLayerTest, DisplayListAccessCountDependsOnVisibility) {
   const SkPoint layer_offset = SkPoint::Make(1.5f, -0.5f);
   const SkRect picture_bounds = SkRect::MakeLTRB(5.0f, 6.0f, 20.5f, 21.5f);
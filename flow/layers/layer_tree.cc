@@ -7,6 +7,7 @@
 #include "flutter/display_list/skia/dl_sk_canvas.h"
 #include "flutter/flow/embedded_views.h"
 #include "flutter/flow/frame_timings.h"
+#include "flutter/flow/layers/container_layer.h"
 #include "flutter/flow/layers/layer.h"
 #include "flutter/flow/paint_utils.h"
 #include "flutter/flow/raster_cache.h"
@@ -205,4 +206,77 @@ sk_sp<DisplayList> LayerTree::Flatten(
   return builder.Build();
 }
 
+// Texture layers and platform views need the texture registry and the view
+// embedder, which may only be used on the raster thread.
+static bool NeedsRasterThread(const Layer* layer) {
+  if (layer->as_texture_layer() || layer->as_platform_view_layer()) {
+    return true;
+  }
+  if (const ContainerLayer* container = layer->as_container_layer()) {
+    for (const std::shared_ptr<Layer>& child : container->layers()) {
+      if (NeedsRasterThread(child.get())) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+sk_sp<DisplayList> LayerTree::Record(
+    const SkMatrix& root_surface_transformation,
+    const Stopwatch& raster_time,
+    const Stopwatch& ui_time,
+    bool impeller_enabled) {
+  TRACE_EVENT0("flutter", "LayerTree::Record");
+
+  if (!root_layer_ || NeedsRasterThread(root_layer_.get())) {
+    return nullptr;
+  }
+
+  LayerStateStack preroll_state_stack;
+  preroll_state_stack.set_preroll_delegate(kGiantRect,
+                                           root_surface_transformation);
+  PrerollContext preroll_context{
+      // clang-format off
+#if !SLIMPELLER
+      .raster_cache                  = nullptr,
+#endif  //  !SLIMPELLER
+      .gr_context                    = nullptr,
+      .view_embedder                 = nullptr,
+      .state_stack                   = preroll_state_stack,
+      .dst_color_space               = nullptr,
+      .surface_needs_readback        = false,
+      .raster_time                   = raster_time,
+      .ui_time                       = ui_time,
+      .texture_registry              = nullptr,
+      // clang-format on
+  };
+  root_layer_->Preroll(&preroll_context);
+
+  DisplayListBuilder builder(SkRect::Make(frame_size_));
+  LayerStateStack paint_state_stack;
+  paint_state_stack.set_delegate(&builder);
+  PaintContext paint_context = {
+      // clang-format off
+      .state_stack                   = paint_state_stack,
+      .canvas                        = &builder,
+      .gr_context                    = nullptr,
+      .dst_color_space               = nullptr,
+      .view_embedder                 = nullptr,
+      .raster_time                   = raster_time,
+      .ui_time                       = ui_time,
+      .texture_registry              = nullptr,
+#if !SLIMPELLER
+      .raster_cache                  = nullptr,
+#endif  //  !SLIMPELLER
+      .impeller_enabled              = impeller_enabled,
+      // clang-format on
+  };
+  if (root_layer_->needs_painting(paint_context)) {
+    root_layer_->Paint(paint_context);
+  }
+
+  return builder.Build();
+}
+
 }  // namespace flutter
@@ -50,6 +50,21 @@ class LayerTree {
       const std::shared_ptr<TextureRegistry>& texture_registry = nullptr,
       GrDirectContext* gr_context = nullptr);
 
+  // Preroll and paint the tree into a display list that can later be drawn
+  // into a frame of the surface of its view.
+  //
+  // Unlike |Preroll| and |Paint|, this uses neither the raster cache, a view
+  // embedder nor a GPU context, so the trees of different views can be
+  // recorded concurrently as long as they don't share any layers.
+  //
+  // Returns nullptr if the tree can't be recorded this way because it has
+  // no root layer or it contains texture layers or platform views, which
+  // need to be prerolled and painted on the raster thread.
+  sk_sp<DisplayList> Record(const SkMatrix& root_surface_transformation,
+                            const Stopwatch& raster_time,
+                            const Stopwatch& ui_time,
+                            bool impeller_enabled);
+
   Layer* root_layer() const { return root_layer_.get(); }
   const SkISize& frame_size() const { return frame_size_; }
 
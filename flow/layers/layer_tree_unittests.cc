@@ -7,6 +7,8 @@
 
 #include "flutter/flow/compositor_context.h"
 #include "flutter/flow/layers/container_layer.h"
+#include "flutter/flow/layers/platform_view_layer.h"
+#include "flutter/flow/layers/texture_layer.h"
 #include "flutter/flow/raster_cache.h"
 #include "flutter/flow/testing/mock_layer.h"
 #include "flutter/fml/macros.h"
@@ -174,6 +176,51 @@ TEST_F(LayerTreeTest, MultipleWithEmpty) {
   EXPECT_TRUE(DisplayListsEQ_Verbose(display_list(), expected_dl));
 }
 
+TEST_F(LayerTreeTest, Record) {
+  const SkPath child_path = SkPath().addRect(5.0f, 6.0f, 20.5f, 21.5f);
+  const DlPaint child_paint = DlPaint(DlColor::kCyan());
+  auto mock_layer = std::make_shared<MockLayer>(child_path, child_paint);
+  auto layer = std::make_shared<ContainerLayer>();
+  layer->Add(mock_layer);
+  FixedRefreshRateStopwatch raster_time;
+  FixedRefreshRateStopwatch ui_time;
+
+  auto layer_tree = BuildLayerTree(layer);
+  sk_sp<DisplayList> recording =
+      layer_tree->Record(root_transform(), raster_time, ui_time, true);
+  ASSERT_NE(recording, nullptr);
+  EXPECT_EQ(mock_layer->parent_matrix(), root_transform());
+
+  DisplayListBuilder expected_builder;
+  expected_builder.DrawPath(DlPath(child_path), child_paint);
+  EXPECT_TRUE(DisplayListsEQ_Verbose(recording, expected_builder.Build()));
+}
+
+TEST_F(LayerTreeTest, RecordRejectsTextureLayers) {
+  auto layer = std::make_shared<ContainerLayer>();
+  layer->Add(std::make_shared<TextureLayer>(
+      SkPoint::Make(0, 0), SkSize::Make(8, 8), 0, false,
+      DlImageSampling::kLinear));
+  FixedRefreshRateStopwatch raster_time;
+  FixedRefreshRateStopwatch ui_time;
+
+  auto layer_tree = BuildLayerTree(layer);
+  EXPECT_EQ(layer_tree->Record(root_transform(), raster_time, ui_time, true),
+            nullptr);
+}
+
+TEST_F(LayerTreeTest, RecordRejectsPlatformViews) {
+  auto layer = std::make_shared<ContainerLayer>();
+  layer->Add(std::make_shared<PlatformViewLayer>(SkPoint::Make(0, 0),
+                                                 SkSize::Make(8, 8), 0));
+  FixedRefreshRateStopwatch raster_time;
+  FixedRefreshRateStopwatch ui_time;
+
+  auto layer_tree = BuildLayerTree(layer);
+  EXPECT_EQ(layer_tree->Record(root_transform(), raster_time, ui_time, true),
+            nullptr);
+}
+
 TEST_F(LayerTreeTest, NeedsSystemComposite) {
   const SkPath child_path1 = SkPath().addRect(5.0f, 6.0f, 20.5f, 21.5f);
   const SkPath child_path2 = SkPath().addRect(8.0f, 2.0f, 16.5f, 14.5f);
@@ -16,6 +16,10 @@ class PlatformViewLayer : public Layer {
  public:
   PlatformViewLayer(const SkPoint& offset, const SkSize& size, int64_t view_id);
 
+  const PlatformViewLayer* as_platform_view_layer() const override {
+    return this;
+  }
+
   void Preroll(PrerollContext* context) override;
   void Paint(PaintContext& context) const override;
 
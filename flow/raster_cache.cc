@@ -6,7 +6,10 @@
 
 #include "flutter/flow/raster_cache.h"
 
+#include <algorithm>
+#include <cmath>
 #include <cstddef>
+#include <limits>
 #include <vector>
 
 #include "flutter/common/constants.h"
@@ -16,6 +19,7 @@
 #include "flutter/flow/paint_utils.h"
 #include "flutter/flow/raster_cache_util.h"
 #include "flutter/fml/logging.h"
+#include "flutter/fml/time/time_point.h"
 #include "flutter/fml/trace_event.h"
 #include "third_party/skia/include/core/SkCanvas.h"
 #include "third_party/skia/include/core/SkColorSpace.h"
@@ -71,9 +75,11 @@ void RasterCacheResult::draw(DlCanvas& canvas,
 }
 
 RasterCache::RasterCache(size_t access_threshold,
-                         size_t display_list_cache_limit_per_frame)
+                         size_t display_list_cache_limit_per_frame,
+                         size_t max_byte_size)
     : access_threshold_(access_threshold),
-      display_list_cache_limit_per_frame_(display_list_cache_limit_per_frame) {}
+      display_list_cache_limit_per_frame_(display_list_cache_limit_per_frame),
+      max_byte_size_(max_byte_size) {}
 
 /// @note Procedure doesn't copy all closures.
 std::unique_ptr<RasterCacheResult> RasterCache::Rasterize(
@@ -123,10 +129,51 @@ bool RasterCache::UpdateCacheEntry(
   RasterCacheKey key = RasterCacheKey(id, raster_cache_context.matrix);
   Entry& entry = cache_[key];
   if (!entry.image) {
+    if (max_byte_size_ > 0) {
+      // Don't rasterize an image that could never fit in the budget.
+      SkRect device_rect = RasterCacheUtil::GetRoundedOutDeviceBounds(
+          raster_cache_context.logical_rect,
+          RasterCacheUtil::GetIntegralTransCTM(raster_cache_context.matrix));
+      size_t estimated_byte_size =
+          SkImageInfo::MakeN32Premul(device_rect.width(), device_rect.height())
+              .computeMinByteSize();
+      if (estimated_byte_size > max_byte_size_) {
+        return false;
+      }
+      // Nor one that would not fit after evicting every image that it is
+      // allowed to replace. The cost of an entry is only known once it has
+      // been rasterized, until then it may replace any evictable image.
+      double estimated_value =
+          entry.rasterize_time > fml::TimeDelta::Zero()
+              ? GetValuePerByte(entry.rasterize_time,
+                                entry.accesses_since_visible,
+                                estimated_byte_size)
+              : std::numeric_limits<double>::infinity();
+      if (image_byte_size_ + estimated_byte_size >
+          max_byte_size_ + GetEvictableByteSize(estimated_value)) {
+        RejectEntry(entry);
+        return false;
+      }
+    }
     void (*func)(DlCanvas*, const SkRect& rect) = DrawCheckerboard;
+    fml::TimePoint rasterize_start = fml::TimePoint::Now();
     entry.image = Rasterize(raster_cache_context, std::move(rtree),
                             render_function, func);
+    entry.rasterize_time = fml::TimePoint::Now() - rasterize_start;
     if (entry.image != nullptr) {
+      entry.rasterized_this_frame = true;
+      image_byte_size_ += entry.image->image_bytes();
+      if (max_byte_size_ > 0 && image_byte_size_ > max_byte_size_) {
+        EvictImagesToFit(max_byte_size_, GetImageValuePerByte(entry));
+        if (image_byte_size_ > max_byte_size_) {
+          // The rest of the budget is used by images that were rasterized in
+          // this frame or that are worth more than this one.
+          image_byte_size_ -= entry.image->image_bytes();
+          entry.image.reset();
+          RejectEntry(entry);
+          return false;
+        }
+      }
       switch (id.type()) {
         case RasterCacheKeyType::kDisplayList: {
           display_list_cached_this_frame_++;
@@ -177,18 +224,23 @@ bool RasterCache::Draw(const RasterCacheKeyID& id,
                        DlCanvas& canvas,
                        const DlPaint* paint,
                        bool preserve_rtree) const {
-  auto it = cache_.find(RasterCacheKey(id, canvas.GetTransform()));
+  RasterCacheKey key = RasterCacheKey(id, canvas.GetTransform());
+  RasterCacheMetrics& metrics = GetMetricsForKind(key.kind());
+  auto it = cache_.find(key);
   if (it == cache_.end()) {
+    metrics.miss_count++;
     return false;
   }
 
   Entry& entry = it->second;
 
   if (entry.image) {
+    metrics.hit_count++;
     entry.image->draw(canvas, paint, preserve_rtree);
     return true;
   }
 
+  metrics.miss_count++;
   return false;
 }
 
@@ -208,6 +260,7 @@ void RasterCache::UpdateMetrics() {
       metrics.in_use_bytes += entry.image->image_bytes();
     }
     entry.encountered_this_frame = false;
+    entry.rasterized_this_frame = false;
   }
 }
 
@@ -226,9 +279,95 @@ void RasterCache::EvictUnusedCacheEntries() {
       RasterCacheMetrics& metrics = GetMetricsForKind(it->first.kind());
       metrics.eviction_count++;
       metrics.eviction_bytes += it->second.image->image_bytes();
+      image_byte_size_ -= it->second.image->image_bytes();
     }
     cache_.erase(it);
   }
+  if (max_byte_size_ > 0 && image_byte_size_ > max_byte_size_) {
+    // The budget was lowered since the images were added.
+    EvictImagesToFit(max_byte_size_, std::numeric_limits<double>::infinity());
+  }
+}
+
+double RasterCache::GetValuePerByte(fml::TimeDelta rasterize_time,
+                                    size_t accesses_since_visible,
+                                    size_t byte_size) {
+  // Rasterizing an entry always costs at least a render target allocation
+  // and a draw, which is what the constant term accounts for.
+  double cost = rasterize_time.ToMicrosecondsF() + 10.0;
+  double uses = std::log2(2.0 + accesses_since_visible);
+  double bytes = std::max<size_t>(byte_size, 1);
+  return cost * uses / bytes;
+}
+
+double RasterCache::GetImageValuePerByte(const Entry& entry) {
+  return GetValuePerByte(entry.rasterize_time, entry.accesses_since_visible,
+                         entry.image->image_bytes());
+}
+
+bool RasterCache::IsEvictable(const Entry& entry, double max_visible_value) {
+  if (!entry.image || entry.rasterized_this_frame) {
+    return false;
+  }
+  return !entry.visible_this_frame ||
+         GetImageValuePerByte(entry) < max_visible_value;
+}
+
+size_t RasterCache::GetEvictableByteSize(double max_visible_value) const {
+  size_t byte_size = 0;
+  for (const auto& [key, entry] : cache_) {
+    if (IsEvictable(entry, max_visible_value)) {
+      byte_size += entry.image->image_bytes();
+    }
+  }
+  return byte_size;
+}
+
+void RasterCache::RejectEntry(Entry& entry) {
+  // Like an evicted entry, a rejected entry has to reach the access
+  // threshold again before it is considered again.
+  entry.accesses_since_visible = 0;
+}
+
+void RasterCache::EvictImagesToFit(size_t max_byte_size,
+                                   double max_visible_value) const {
+  std::vector<EntryIterator> candidates;
+  for (auto it = cache_.begin(); it != cache_.end(); ++it) {
+    if (IsEvictable(it->second, max_visible_value)) {
+      candidates.push_back(it);
+    }
+  }
+  // Entries that are not visible in this frame go first, the least valuable
+  // images go first among those that are.
+  std::sort(candidates.begin(), candidates.end(),
+            [](const EntryIterator& a, const EntryIterator& b) {
+              if (a->second.visible_this_frame !=
+                  b->second.visible_this_frame) {
+                return !a->second.visible_this_frame;
+              }
+              return GetImageValuePerByte(a->second) <
+                     GetImageValuePerByte(b->second);
+            });
+  for (EntryIterator it : candidates) {
+    if (image_byte_size_ <= max_byte_size) {
+      break;
+    }
+    EvictImage(it);
+  }
+}
+
+void RasterCache::EvictImage(EntryIterator it) const {
+  Entry& entry = it->second;
+  size_t image_bytes = entry.image->image_bytes();
+  RasterCacheMetrics& metrics = GetMetricsForKind(it->first.kind());
+  metrics.eviction_count++;
+  metrics.eviction_bytes += image_bytes;
+  image_byte_size_ -= image_bytes;
+  entry.image.reset();
+  // The entry has to reach the access threshold again before it is
+  // rasterized again, so that entries competing for the budget do not evict
+  // each other on every frame.
+  entry.accesses_since_visible = 0;
 }
 
 void RasterCache::EndFrame() {
@@ -238,6 +377,7 @@ void RasterCache::EndFrame() {
 
 void RasterCache::Clear() {
   cache_.clear();
+  image_byte_size_ = 0;
   picture_metrics_ = {};
   layer_metrics_ = {};
 }
@@ -273,8 +413,12 @@ void RasterCache::TraceStatsToTimeline() const {
       "RasterCache", reinterpret_cast<int64_t>(this),                      //
       "LayerCount", layer_metrics_.total_count(),                          //
       "LayerMBytes", layer_metrics_.total_bytes() / kMegaByteSizeInBytes,  //
+      "LayerHits", layer_metrics_.hit_count,                               //
+      "LayerMisses", layer_metrics_.miss_count,                            //
       "PictureCount", picture_metrics_.total_count(),                      //
-      "PictureMBytes", picture_metrics_.total_bytes() / kMegaByteSizeInBytes);
+      "PictureMBytes", picture_metrics_.total_bytes() / kMegaByteSizeInBytes,
+      "PictureHits", picture_metrics_.hit_count,                           //
+      "PictureMisses", picture_metrics_.miss_count);
 
 #endif  // !FLUTTER_RELEASE
 }
@@ -301,7 +445,8 @@ size_t RasterCache::EstimatePictureCacheByteSize() const {
   return picture_cache_bytes;
 }
 
-RasterCacheMetrics& RasterCache::GetMetricsForKind(RasterCacheKeyKind kind) {
+RasterCacheMetrics& RasterCache::GetMetricsForKind(
+    RasterCacheKeyKind kind) const {
   switch (kind) {
     case RasterCacheKeyKind::kDisplayListMetrics:
       return picture_metrics_;
@@ -15,6 +15,7 @@
 #include "flutter/flow/raster_cache_util.h"
 #include "flutter/fml/macros.h"
 #include "flutter/fml/memory/weak_ptr.h"
+#include "flutter/fml/time/time_delta.h"
 #include "flutter/fml/trace_event.h"
 #include "third_party/skia/include/core/SkMatrix.h"
 #include "third_party/skia/include/core/SkRect.h"
@@ -70,6 +71,18 @@ struct RasterCacheMetrics {
    */
   size_t eviction_bytes = 0;
 
+  /**
+   * The number of draws in this frame that were served from a cached image.
+   */
+  size_t hit_count = 0;
+
+  /**
+   * The number of draws in this frame that asked for a cached image that
+   * was not available, for example because it was evicted to stay within
+   * the byte budget.
+   */
+  size_t miss_count = 0;
+
   /**
    * The number of cache entries with images used in this frame.
    */
@@ -89,6 +102,15 @@ struct RasterCacheMetrics {
    * The size of all of the cached images during this frame.
    */
   size_t total_bytes() const { return in_use_bytes; }
+
+  /**
+   * The fraction of draws in this frame that were served from a cached image,
+   * or 1 if no cached images were drawn.
+   */
+  double hit_rate() const {
+    size_t draw_count = hit_count + miss_count;
+    return draw_count == 0 ? 1.0 : static_cast<double>(hit_count) / draw_count;
+  }
 };
 
 /**
@@ -114,6 +136,14 @@ struct RasterCacheMetrics {
  *       `RasterCache::Draw` will be used to draw those cache images.
  *   - RasterCache::EndFrame:
  *       Computes used counts and memory then reports cache metrics.
+ *
+ * The images held by the cache can be limited to a byte budget. When a new
+ * image would exceed the budget, the images that are not visible in the
+ * current frame are evicted first, followed by the visible images that are
+ * worth less for their size than the new image, least valuable first. The
+ * value of an image grows with the time it took to rasterize and with how
+ * often its entry has been accessed since it became visible. If not enough
+ * space can be freed, the new image is not cached.
  */
 class RasterCache {
  public:
@@ -139,7 +169,8 @@ class RasterCache {
   explicit RasterCache(
       size_t access_threshold = 3,
       size_t picture_and_display_list_cache_limit_per_frame =
-          RasterCacheUtil::kDefaultPictureAndDisplayListCacheLimitPerFrame);
+          RasterCacheUtil::kDefaultPictureAndDisplayListCacheLimitPerFrame,
+      size_t max_byte_size = 0);
 
   virtual ~RasterCache() = default;
 
@@ -215,6 +246,18 @@ class RasterCache {
    */
   size_t access_threshold() const { return access_threshold_; }
 
+  /**
+   * @brief The maximum number of bytes of images held by the cache, or 0 if
+   * the cache is unbounded.
+   */
+  size_t max_byte_size() const { return max_byte_size_; }
+
+  /**
+   * @brief Change the byte budget of the cache. Images are evicted to fit
+   * the new budget by the next call to |EvictUnusedCacheEntries|.
+   */
+  void SetMaxByteSize(size_t max_byte_size) { max_byte_size_ = max_byte_size; }
+
   bool GenerateNewCacheInThisFrame() const {
     // Disabling caching when access_threshold is zero is historic behavior.
     return access_threshold_ != 0 && display_list_cached_this_frame_ <
@@ -250,19 +293,52 @@ class RasterCache {
   struct Entry {
     bool encountered_this_frame = false;
     bool visible_this_frame = false;
+    bool rasterized_this_frame = false;
     size_t accesses_since_visible = 0;
+    // How long it took to produce |image|.
+    fml::TimeDelta rasterize_time;
     std::unique_ptr<RasterCacheResult> image;
   };
 
+  using EntryIterator = RasterCacheKey::Map<Entry>::iterator;
+
   void UpdateMetrics();
 
-  RasterCacheMetrics& GetMetricsForKind(RasterCacheKeyKind kind);
+  RasterCacheMetrics& GetMetricsForKind(RasterCacheKeyKind kind) const;
+
+  // The value of keeping an image of |byte_size| bytes that took
+  // |rasterize_time| to produce, per byte that it uses.
+  static double GetValuePerByte(fml::TimeDelta rasterize_time,
+                                size_t accesses_since_visible,
+                                size_t byte_size);
+
+  // The value of keeping the image of an entry per byte that it uses.
+  static double GetImageValuePerByte(const Entry& entry);
+
+  // Whether |EvictImagesToFit| may evict the image of |entry|.
+  static bool IsEvictable(const Entry& entry, double max_visible_value);
+
+  // The number of bytes that |EvictImagesToFit| could free.
+  size_t GetEvictableByteSize(double max_visible_value) const;
+
+  // Called when the image of |entry| does not fit in the budget.
+  static void RejectEntry(Entry& entry);
+
+  // Evict images that were not rasterized in this frame until the images
+  // held by the cache fit in |max_byte_size|. Images that are visible in this
+  // frame are only evicted if they are worth less than |max_visible_value|
+  // per byte, so that they are not replaced by images of equal value.
+  void EvictImagesToFit(size_t max_byte_size, double max_visible_value) const;
+
+  void EvictImage(EntryIterator it) const;
 
   const size_t access_threshold_;
   const size_t display_list_cache_limit_per_frame_;
+  size_t max_byte_size_;
   mutable size_t display_list_cached_this_frame_ = 0;
-  RasterCacheMetrics layer_metrics_;
-  RasterCacheMetrics picture_metrics_;
+  mutable size_t image_byte_size_ = 0;
+  mutable RasterCacheMetrics layer_metrics_;
+  mutable RasterCacheMetrics picture_metrics_;
   mutable RasterCacheKey::Map<Entry> cache_;
   bool checkerboard_images_ = false;
 
@@ -320,6 +320,183 @@ TEST(RasterCache, EvictUnusedCacheEntries) {
   cache.EndFrame();
 }
 
+TEST(RasterCache, ByteBudgetLimitsCachedImages) {
+  size_t threshold = 1;
+  // Each sample display list rasterizes to a 25624 byte image.
+  size_t max_byte_size = 30000;
+  flutter::RasterCache cache(
+      threshold,
+      RasterCacheUtil::kDefaultPictureAndDisplayListCacheLimitPerFrame,
+      max_byte_size);
+  ASSERT_EQ(cache.max_byte_size(), max_byte_size);
+
+  SkMatrix matrix = SkMatrix::I();
+
+  auto display_list_1 = GetSampleDisplayList();
+  auto display_list_2 = GetSampleDisplayList();
+
+  DisplayListBuilder dummy_canvas(1000, 1000);
+  DlPaint paint;
+
+  LayerStateStack preroll_state_stack;
+  preroll_state_stack.set_preroll_delegate(kGiantRect, matrix);
+  LayerStateStack paint_state_stack;
+  preroll_state_stack.set_delegate(&dummy_canvas);
+
+  FixedRefreshRateStopwatch raster_time;
+  FixedRefreshRateStopwatch ui_time;
+  PrerollContextHolder preroll_context_holder = GetSamplePrerollContextHolder(
+      preroll_state_stack, &cache, &raster_time, &ui_time);
+  PaintContextHolder paint_context_holder = GetSamplePaintContextHolder(
+      paint_state_stack, &cache, &raster_time, &ui_time);
+  auto& preroll_context = preroll_context_holder.preroll_context;
+  auto& paint_context = paint_context_holder.paint_context;
+
+  DisplayListRasterCacheItem display_list_item_1(display_list_1, SkPoint(),
+                                                 true, false);
+  DisplayListRasterCacheItem display_list_item_2(display_list_2, SkPoint(),
+                                                 true, false);
+
+  cache.BeginFrame();
+  RasterCacheItemPreroll(display_list_item_1, preroll_context, matrix);
+  RasterCacheItemPreroll(display_list_item_2, preroll_context, matrix);
+  cache.EvictUnusedCacheEntries();
+  cache.EndFrame();
+
+  // Only one of the images fits in the budget.
+  cache.BeginFrame();
+  RasterCacheItemPreroll(display_list_item_1, preroll_context, matrix);
+  RasterCacheItemPreroll(display_list_item_2, preroll_context, matrix);
+  cache.EvictUnusedCacheEntries();
+  ASSERT_TRUE(
+      RasterCacheItemTryToRasterCache(display_list_item_1, paint_context));
+  ASSERT_FALSE(
+      RasterCacheItemTryToRasterCache(display_list_item_2, paint_context));
+  ASSERT_EQ(cache.EstimatePictureCacheByteSize(), 25624u);
+  ASSERT_TRUE(display_list_item_1.Draw(paint_context, &dummy_canvas, &paint));
+  ASSERT_FALSE(display_list_item_2.Draw(paint_context, &dummy_canvas, &paint));
+  // The rejected entry has to reach the access threshold again.
+  ASSERT_EQ(cache.GetAccessCount(display_list_item_2.GetId().value(), matrix),
+            0);
+  cache.EndFrame();
+
+  ASSERT_EQ(cache.picture_metrics().total_count(), 1u);
+  ASSERT_EQ(cache.picture_metrics().total_bytes(), 25624u);
+  ASSERT_EQ(cache.picture_metrics().hit_count, 1u);
+  ASSERT_EQ(cache.picture_metrics().miss_count, 1u);
+  ASSERT_DOUBLE_EQ(cache.picture_metrics().hit_rate(), 0.5);
+
+  // Whichever image is kept, the cache stays within the budget.
+  cache.BeginFrame();
+  RasterCacheItemPreroll(display_list_item_1, preroll_context, matrix);
+  RasterCacheItemPreroll(display_list_item_2, preroll_context, matrix);
+  cache.EvictUnusedCacheEntries();
+  RasterCacheItemTryToRasterCache(display_list_item_1, paint_context);
+  RasterCacheItemTryToRasterCache(display_list_item_2, paint_context);
+  ASSERT_EQ(cache.EstimatePictureCacheByteSize(), 25624u);
+  cache.EndFrame();
+
+  ASSERT_LE(cache.picture_metrics().total_bytes(), max_byte_size);
+  ASSERT_EQ(cache.picture_metrics().total_count(), 1u);
+}
+
+TEST(RasterCache, ImagesLargerThanByteBudgetAreNotCached) {
+  size_t threshold = 1;
+  flutter::RasterCache cache(
+      threshold,
+      RasterCacheUtil::kDefaultPictureAndDisplayListCacheLimitPerFrame, 1000);
+
+  SkMatrix matrix = SkMatrix::I();
+  auto display_list = GetSampleDisplayList();
+
+  DisplayListBuilder dummy_canvas(1000, 1000);
+  DlPaint paint;
+
+  LayerStateStack preroll_state_stack;
+  preroll_state_stack.set_preroll_delegate(kGiantRect, matrix);
+  LayerStateStack paint_state_stack;
+  preroll_state_stack.set_delegate(&dummy_canvas);
+
+  FixedRefreshRateStopwatch raster_time;
+  FixedRefreshRateStopwatch ui_time;
+  PrerollContextHolder preroll_context_holder = GetSamplePrerollContextHolder(
+      preroll_state_stack, &cache, &raster_time, &ui_time);
+  PaintContextHolder paint_context_holder = GetSamplePaintContextHolder(
+      paint_state_stack, &cache, &raster_time, &ui_time);
+  auto& preroll_context = preroll_context_holder.preroll_context;
+  auto& paint_context = paint_context_holder.paint_context;
+
+  DisplayListRasterCacheItem display_list_item(display_list, SkPoint(), true,
+                                               false);
+
+  for (int i = 0; i < 3; i++) {
+    cache.BeginFrame();
+    RasterCacheItemPreroll(display_list_item, preroll_context, matrix);
+    cache.EvictUnusedCacheEntries();
+    ASSERT_FALSE(
+        RasterCacheItemTryToRasterCache(display_list_item, paint_context));
+    ASSERT_EQ(cache.EstimatePictureCacheByteSize(), 0u);
+    cache.EndFrame();
+  }
+  ASSERT_EQ(cache.picture_metrics().total_bytes(), 0u);
+}
+
+TEST(RasterCache, LoweringByteBudgetEvictsImages) {
+  size_t threshold = 1;
+  flutter::RasterCache cache(threshold);
+  ASSERT_EQ(cache.max_byte_size(), 0u);
+
+  SkMatrix matrix = SkMatrix::I();
+
+  auto display_list_1 = GetSampleDisplayList();
+  auto display_list_2 = GetSampleDisplayList();
+
+  DisplayListBuilder dummy_canvas(1000, 1000);
+  DlPaint paint;
+
+  LayerStateStack preroll_state_stack;
+  preroll_state_stack.set_preroll_delegate(kGiantRect, matrix);
+  LayerStateStack paint_state_stack;
+  preroll_state_stack.set_delegate(&dummy_canvas);
+
+  FixedRefreshRateStopwatch raster_time;
+  FixedRefreshRateStopwatch ui_time;
+  PrerollContextHolder preroll_context_holder = GetSamplePrerollContextHolder(
+      preroll_state_stack, &cache, &raster_time, &ui_time);
+  PaintContextHolder paint_context_holder = GetSamplePaintContextHolder(
+      paint_state_stack, &cache, &raster_time, &ui_time);
+  auto& preroll_context = preroll_context_holder.preroll_context;
+  auto& paint_context = paint_context_holder.paint_context;
+
+  DisplayListRasterCacheItem display_list_item_1(display_list_1, SkPoint(),
+                                                 true, false);
+  DisplayListRasterCacheItem display_list_item_2(display_list_2, SkPoint(),
+                                                 true, false);
+
+  for (int i = 0; i < 2; i++) {
+    cache.BeginFrame();
+    RasterCacheItemPreroll(display_list_item_1, preroll_context, matrix);
+    RasterCacheItemPreroll(display_list_item_2, preroll_context, matrix);
+    cache.EvictUnusedCacheEntries();
+    RasterCacheItemTryToRasterCache(display_list_item_1, paint_context);
+    RasterCacheItemTryToRasterCache(display_list_item_2, paint_context);
+    cache.EndFrame();
+  }
+  ASSERT_EQ(cache.EstimatePictureCacheByteSize(), 51248u);
+
+  cache.SetMaxByteSize(30000);
+  cache.BeginFrame();
+  RasterCacheItemPreroll(display_list_item_1, preroll_context, matrix);
+  RasterCacheItemPreroll(display_list_item_2, preroll_context, matrix);
+  cache.EvictUnusedCacheEntries();
+  ASSERT_EQ(cache.EstimatePictureCacheByteSize(), 25624u);
+  ASSERT_EQ(cache.picture_metrics().eviction_count, 1u);
+  ASSERT_EQ(cache.picture_metrics().eviction_bytes, 25624u);
+  cache.EndFrame();
+
+  ASSERT_EQ(cache.picture_metrics().total_count(), 1u);
+}
+
 TEST(RasterCache, ComputeDeviceRectBasedOnFractionalTranslation) {
   SkRect logical_rect = SkRect::MakeLTRB(0, 0, 300.2, 300.3);
   SkMatrix ctm = SkMatrix::MakeAll(2.0, 0, 0, 0, 2.0, 0, 0, 0, 1);
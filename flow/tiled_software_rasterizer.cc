@@ -0,0 +1,201 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/flow/tiled_software_rasterizer.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "flutter/display_list/skia/dl_sk_dispatcher.h"
+#include "flutter/display_list/utils/dl_receiver_utils.h"
+#include "flutter/fml/logging.h"
+#include "flutter/fml/trace_event.h"
+#include "third_party/skia/include/core/SkCanvas.h"
+
+namespace flutter {
+
+namespace {
+
+// Looks for save layers with a backdrop filter anywhere in a DisplayList,
+// including inside of nested DisplayLists. A backdrop filter reads the
+// pixels around the area it draws into, which may belong to another tile
+// that is being rendered at the same time.
+class BackdropFilterFinder : public virtual DlOpReceiver,
+                             public IgnoreAttributeDispatchHelper,
+                             public IgnoreClipDispatchHelper,
+                             public IgnoreTransformDispatchHelper,
+                             public IgnoreDrawDispatchHelper {
+ public:
+  bool found() const { return found_; }
+
+  void saveLayer(const DlRect& bounds,
+                 const SaveLayerOptions options,
+                 const DlImageFilter* backdrop,
+                 std::optional<int64_t> backdrop_id) override {
+    if (backdrop != nullptr || options.contains_backdrop_filter()) {
+      found_ = true;
+    }
+  }
+
+  void drawDisplayList(const sk_sp<DisplayList> display_list,
+                       DlScalar opacity) override {
+    if (!found_) {
+      display_list->Dispatch(*this);
+    }
+  }
+
+ private:
+  bool found_ = false;
+};
+
+void RasterizeTile(const DisplayList& display_list,
+                   const SkPixmap& pixmap,
+                   const SkIRect& tile) {
+#if !SLIMPELLER
+  SkPixmap tile_pixmap;
+  if (!pixmap.extractSubset(&tile_pixmap, tile)) {
+    return;
+  }
+  std::unique_ptr<SkCanvas> canvas = SkCanvas::MakeRasterDirect(
+      tile_pixmap.info(), tile_pixmap.writable_addr(), tile_pixmap.rowBytes());
+  if (!canvas) {
+    return;
+  }
+  canvas->translate(-tile.left(), -tile.top());
+  canvas->clipRect(SkRect::Make(tile));
+
+  DlSkCanvasDispatcher dispatcher(canvas.get());
+  display_list.Dispatch(dispatcher, tile);
+#else   //  !SLIMPELLER
+  FML_LOG(FATAL) << "Impeller opt-out unavailable.";
+#endif  //  !SLIMPELLER
+}
+
+// The tiles of one frame, handed out one at a time to the workers and to the
+// calling thread so that a few expensive tiles do not hold up the others.
+//
+// The workers share ownership of the job so that the calling thread only
+// waits for the tiles that are being rendered, and not for workers that are
+// busy with other tasks and have not started yet. Those find that there are
+// no tiles left once they start.
+class TileJob {
+ public:
+  TileJob(sk_sp<DisplayList> display_list,
+          const SkPixmap& pixmap,
+          std::vector<SkIRect> tiles)
+      : display_list_(std::move(display_list)),
+        pixmap_(pixmap),
+        tiles_(std::move(tiles)) {}
+
+  size_t tile_count() const { return tiles_.size(); }
+
+  // Renders tiles until there are none left to claim.
+  void RasterizeTiles() {
+    for (size_t i = next_tile_.fetch_add(1u); i < tiles_.size();
+         i = next_tile_.fetch_add(1u)) {
+      RasterizeTile(*display_list_, pixmap_, tiles_[i]);
+      std::scoped_lock lock(mutex_);
+      if (++finished_tile_count_ == tiles_.size()) {
+        all_tiles_finished_.notify_all();
+      }
+    }
+  }
+
+  void WaitForAllTiles() {
+    std::unique_lock lock(mutex_);
+    all_tiles_finished_.wait(
+        lock, [this]() { return finished_tile_count_ == tiles_.size(); });
+  }
+
+ private:
+  const sk_sp<DisplayList> display_list_;
+  const SkPixmap pixmap_;
+  const std::vector<SkIRect> tiles_;
+  std::atomic_size_t next_tile_ = 0u;
+  std::mutex mutex_;
+  std::condition_variable all_tiles_finished_;
+  size_t finished_tile_count_ = 0u;
+
+  FML_DISALLOW_COPY_AND_ASSIGN(TileJob);
+};
+
+}  // namespace
+
+TiledSoftwareRasterizer::TiledSoftwareRasterizer(
+    std::shared_ptr<fml::ConcurrentTaskRunner> worker_task_runner,
+    int tile_size)
+    : worker_task_runner_(std::move(worker_task_runner)),
+      tile_size_(tile_size) {
+  FML_DCHECK(tile_size_ > 0);
+}
+
+TiledSoftwareRasterizer::~TiledSoftwareRasterizer() = default;
+
+// static
+bool TiledSoftwareRasterizer::CanRasterizeInTiles(
+    const DisplayList& display_list) {
+  if (display_list.root_has_backdrop_filter()) {
+    return false;
+  }
+  BackdropFilterFinder finder;
+  display_list.Dispatch(finder);
+  return !finder.found();
+}
+
+size_t TiledSoftwareRasterizer::Rasterize(
+    const sk_sp<DisplayList>& display_list,
+    const SkPixmap& pixmap,
+    const SkIRect& damage) const {
+  SkIRect area = damage;
+  if (!display_list || !area.intersect(pixmap.bounds())) {
+    return 0u;
+  }
+
+  // Tiles are aligned to a grid anchored at the origin of the buffer rather
+  // than at the damage so that the same pixels always end up in the same
+  // tile from frame to frame.
+  std::vector<SkIRect> tiles;
+  for (int top = area.top() - area.top() % tile_size_; top < area.bottom();
+       top += tile_size_) {
+    for (int left = area.left() - area.left() % tile_size_;
+         left < area.right(); left += tile_size_) {
+      SkIRect tile = SkIRect::MakeXYWH(left, top, tile_size_, tile_size_);
+      if (tile.intersect(area)) {
+        tiles.push_back(tile);
+      }
+    }
+  }
+
+  if (!worker_task_runner_ || tiles.size() < 2u ||
+      !CanRasterizeInTiles(*display_list)) {
+    TRACE_EVENT0("flutter", "TiledSoftwareRasterizer::RasterizeSingleTile");
+    RasterizeTile(*display_list, pixmap, area);
+    return 1u;
+  }
+
+  TRACE_EVENT1("flutter", "TiledSoftwareRasterizer::Rasterize", "tiles",
+               std::to_string(tiles.size()).c_str());
+
+  const size_t worker_count = std::min<size_t>(
+      tiles.size() - 1u, std::max(1u, std::thread::hardware_concurrency()));
+  auto job = std::make_shared<TileJob>(display_list, pixmap, std::move(tiles));
+  for (size_t i = 0; i < worker_count; i++) {
+    worker_task_runner_->PostTask([job]() {
+      TRACE_EVENT0("flutter", "TiledSoftwareRasterizer::RasterizeTiles");
+      job->RasterizeTiles();
+    });
+  }
+  // When the workers are busy, the calling thread renders all of the tiles.
+  job->RasterizeTiles();
+  job->WaitForAllTiles();
+
+  return job->tile_count();
+}
+
+}  // namespace flutter
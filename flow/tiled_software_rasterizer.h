@@ -0,0 +1,83 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_FLOW_TILED_SOFTWARE_RASTERIZER_H_
+#define FLUTTER_FLOW_TILED_SOFTWARE_RASTERIZER_H_
+
+#include <memory>
+
+#include "flutter/display_list/display_list.h"
+#include "flutter/fml/concurrent_message_loop.h"
+#include "flutter/fml/macros.h"
+
+#include "third_party/skia/include/core/SkPixmap.h"
+#include "third_party/skia/include/core/SkRect.h"
+
+namespace flutter {
+
+//------------------------------------------------------------------------------
+/// @brief      Rasterizes a |DisplayList| into a software pixel buffer by
+///             splitting the damaged area of the buffer into a grid of tiles
+///             and rendering the tiles in parallel on a concurrent task
+///             runner.
+///
+///             Each tile is rendered by its own raster canvas that is clipped
+///             to the tile, and only the operations whose bounds intersect
+///             the tile are dispatched to it when the |DisplayList| has an
+///             RTree. Tiles share no pixels, so the workers never write to
+///             the same memory. The calling thread renders tiles too, and
+///             only waits for the tiles that workers have started on, so a
+///             busy task runner does not hold up the frame.
+///
+///             DisplayLists that read back the destination outside of the
+///             area they draw into, i.e. those with backdrop filters, cannot
+///             be split and are rendered as a single tile on the calling
+///             thread.
+///
+class TiledSoftwareRasterizer {
+ public:
+  static constexpr int kDefaultTileSize = 256;
+
+  //----------------------------------------------------------------------------
+  /// @param[in]  worker_task_runner  The runner the tiles are rendered on. If
+  ///                                 null, all tiles are rendered on the
+  ///                                 calling thread.
+  /// @param[in]  tile_size           The width and height of the tiles in
+  ///                                 pixels.
+  ///
+  explicit TiledSoftwareRasterizer(
+      std::shared_ptr<fml::ConcurrentTaskRunner> worker_task_runner,
+      int tile_size = kDefaultTileSize);
+
+  ~TiledSoftwareRasterizer();
+
+  //----------------------------------------------------------------------------
+  /// @brief      Renders the part of |display_list| that intersects |damage|
+  ///             into |pixmap| and waits for all of the tiles to finish.
+  ///             Tiles that no worker has started on by the time the calling
+  ///             thread runs out of tiles are rendered on the calling thread.
+  ///             Pixels outside of |damage| are not touched.
+  ///
+  /// @return     The number of tiles that were rendered.
+  ///
+  size_t Rasterize(const sk_sp<DisplayList>& display_list,
+                   const SkPixmap& pixmap,
+                   const SkIRect& damage) const;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Whether rendering |display_list| one tile at a time produces
+  ///             the same pixels as rendering it all at once.
+  ///
+  static bool CanRasterizeInTiles(const DisplayList& display_list);
+
+ private:
+  std::shared_ptr<fml::ConcurrentTaskRunner> worker_task_runner_;
+  const int tile_size_;
+
+  FML_DISALLOW_COPY_AND_ASSIGN(TiledSoftwareRasterizer);
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_FLOW_TILED_SOFTWARE_RASTERIZER_H_
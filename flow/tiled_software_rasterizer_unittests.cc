@@ -0,0 +1,157 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/flow/tiled_software_rasterizer.h"
+
+#include <cstring>
+
+#include "flutter/display_list/dl_builder.h"
+#include "flutter/display_list/effects/image_filters/dl_blur_image_filter.h"
+#include "flutter/fml/concurrent_message_loop.h"
+#include "flutter/fml/synchronization/waitable_event.h"
+#include "flutter/testing/testing.h"
+#include "third_party/skia/include/core/SkBitmap.h"
+
+namespace flutter {
+namespace testing {
+
+namespace {
+
+constexpr int kWidth = 300;
+constexpr int kHeight = 200;
+constexpr int kTileSize = 64;
+
+sk_sp<DisplayList> MakeTestDisplayList(bool with_backdrop_filter = false) {
+  DisplayListBuilder builder(/*prepare_rtree=*/true);
+  builder.DrawColor(DlColor::kWhite(), DlBlendMode::kSrc);
+  builder.DrawCircle(DlPoint(100, 100), 80, DlPaint(DlColor::kBlue()));
+  builder.Rotate(15);
+  builder.DrawRect(DlRect::MakeLTRB(120, 20, 280, 90),
+                   DlPaint(DlColor::kRed().withAlpha(0x80)));
+  if (with_backdrop_filter) {
+    DlBlurImageFilter backdrop(5.0f, 5.0f, DlTileMode::kClamp);
+    builder.SaveLayer(std::nullopt, nullptr, &backdrop);
+    builder.Restore();
+  }
+  builder.DrawOval(DlRect::MakeLTRB(150, 100, 290, 190),
+                   DlPaint(DlColor::kGreen())
+                       .setDrawStyle(DlDrawStyle::kStroke)
+                       .setStrokeWidth(7.0f));
+  return builder.Build();
+}
+
+SkBitmap MakeBitmap(SkColor color) {
+  SkBitmap bitmap;
+  bitmap.allocN32Pixels(kWidth, kHeight);
+  bitmap.eraseColor(color);
+  return bitmap;
+}
+
+bool BitmapsAreEqual(const SkBitmap& a, const SkBitmap& b) {
+  for (int y = 0; y < kHeight; y++) {
+    if (std::memcmp(a.getAddr32(0, y), b.getAddr32(0, y),
+                    kWidth * sizeof(uint32_t)) != 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+}  // namespace
+
+TEST(TiledSoftwareRasterizerTest, TiledOutputMatchesSingleTileOutput) {
+  auto loop = fml::ConcurrentMessageLoop::Create(4u);
+  sk_sp<DisplayList> display_list = MakeTestDisplayList();
+  SkIRect bounds = SkIRect::MakeWH(kWidth, kHeight);
+
+  SkBitmap expected = MakeBitmap(SK_ColorTRANSPARENT);
+  TiledSoftwareRasterizer single(nullptr, kTileSize);
+  EXPECT_EQ(single.Rasterize(display_list, expected.pixmap(), bounds), 1u);
+
+  SkBitmap tiled = MakeBitmap(SK_ColorTRANSPARENT);
+  TiledSoftwareRasterizer rasterizer(loop->GetTaskRunner(), kTileSize);
+  // 300x200 pixels in 64x64 tiles is a 5x4 grid.
+  EXPECT_EQ(rasterizer.Rasterize(display_list, tiled.pixmap(), bounds), 20u);
+
+  EXPECT_TRUE(BitmapsAreEqual(expected, tiled));
+}
+
+TEST(TiledSoftwareRasterizerTest, DoesNotWaitForBusyWorkers) {
+  fml::AutoResetWaitableEvent release_worker;
+  auto loop = fml::ConcurrentMessageLoop::Create(1u);
+  sk_sp<DisplayList> display_list = MakeTestDisplayList();
+  SkIRect bounds = SkIRect::MakeWH(kWidth, kHeight);
+
+  SkBitmap expected = MakeBitmap(SK_ColorTRANSPARENT);
+  TiledSoftwareRasterizer single(nullptr, kTileSize);
+  single.Rasterize(display_list, expected.pixmap(), bounds);
+
+  // Keep the only worker busy until the frame has been rasterized.
+  loop->GetTaskRunner()->PostTask(
+      [&release_worker]() { release_worker.Wait(); });
+
+  SkBitmap tiled = MakeBitmap(SK_ColorTRANSPARENT);
+  TiledSoftwareRasterizer rasterizer(loop->GetTaskRunner(), kTileSize);
+  EXPECT_EQ(rasterizer.Rasterize(display_list, tiled.pixmap(), bounds), 20u);
+  EXPECT_TRUE(BitmapsAreEqual(expected, tiled));
+
+  release_worker.Signal();
+}
+
+TEST(TiledSoftwareRasterizerTest, OnlyRastersTilesInsideDamage) {
+  auto loop = fml::ConcurrentMessageLoop::Create(4u);
+  sk_sp<DisplayList> display_list = MakeTestDisplayList();
+  // Spans the tiles in columns 0..2 and rows 1..2 of the grid.
+  SkIRect damage = SkIRect::MakeLTRB(60, 70, 130, 150);
+
+  SkBitmap bitmap = MakeBitmap(SK_ColorBLACK);
+  TiledSoftwareRasterizer rasterizer(loop->GetTaskRunner(), kTileSize);
+  EXPECT_EQ(rasterizer.Rasterize(display_list, bitmap.pixmap(), damage), 6u);
+
+  for (int y = 0; y < kHeight; y++) {
+    for (int x = 0; x < kWidth; x++) {
+      if (!damage.contains(x, y)) {
+        ASSERT_EQ(bitmap.getColor(x, y), SK_ColorBLACK) << x << ", " << y;
+      }
+    }
+  }
+  // The opaque background was painted over the whole damage.
+  EXPECT_NE(bitmap.getColor(damage.left(), damage.top()), SK_ColorBLACK);
+  EXPECT_NE(bitmap.getColor(damage.right() - 1, damage.bottom() - 1),
+            SK_ColorBLACK);
+}
+
+TEST(TiledSoftwareRasterizerTest, DamageOutsideOfBufferIsIgnored) {
+  auto loop = fml::ConcurrentMessageLoop::Create(4u);
+  SkBitmap bitmap = MakeBitmap(SK_ColorBLACK);
+  TiledSoftwareRasterizer rasterizer(loop->GetTaskRunner(), kTileSize);
+  EXPECT_EQ(rasterizer.Rasterize(MakeTestDisplayList(), bitmap.pixmap(),
+                                 SkIRect::MakeLTRB(400, 0, 500, 100)),
+            0u);
+}
+
+TEST(TiledSoftwareRasterizerTest, BackdropFilterIsRasterizedAsSingleTile) {
+  sk_sp<DisplayList> display_list =
+      MakeTestDisplayList(/*with_backdrop_filter=*/true);
+  EXPECT_FALSE(TiledSoftwareRasterizer::CanRasterizeInTiles(*display_list));
+
+  auto loop = fml::ConcurrentMessageLoop::Create(4u);
+  SkBitmap bitmap = MakeBitmap(SK_ColorTRANSPARENT);
+  TiledSoftwareRasterizer rasterizer(loop->GetTaskRunner(), kTileSize);
+  EXPECT_EQ(rasterizer.Rasterize(display_list, bitmap.pixmap(),
+                                 SkIRect::MakeWH(kWidth, kHeight)),
+            1u);
+}
+
+TEST(TiledSoftwareRasterizerTest, NestedBackdropFilterIsDetected) {
+  DisplayListBuilder builder;
+  builder.DrawDisplayList(MakeTestDisplayList(/*with_backdrop_filter=*/true));
+  EXPECT_FALSE(TiledSoftwareRasterizer::CanRasterizeInTiles(*builder.Build()));
+
+  EXPECT_TRUE(
+      TiledSoftwareRasterizer::CanRasterizeInTiles(*MakeTestDisplayList()));
+}
+
+}  // namespace testing
+}  // namespace flutter
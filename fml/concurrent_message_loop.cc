@@ -11,19 +11,26 @@
 
 namespace fml {
 
+/// The loop the current thread is a worker of, if any, and the index of
+/// that worker.
+static thread_local const ConcurrentMessageLoop* tls_loop = nullptr;
+static thread_local size_t tls_worker_index = 0;
+
 ConcurrentMessageLoop::ConcurrentMessageLoop(size_t worker_count)
     : worker_count_(std::max<size_t>(worker_count, 1ul)) {
+  // The queues must all exist before any of the workers start stealing.
+  worker_queues_.reserve(worker_count_);
+  for (size_t i = 0; i < worker_count_; ++i) {
+    worker_queues_.emplace_back(std::make_unique<Worker>());
+  }
+
   for (size_t i = 0; i < worker_count_; ++i) {
     workers_.emplace_back([i, this]() {
       fml::Thread::SetCurrentThreadName(fml::Thread::ThreadConfig(
           std::string{"io.worker." + std::to_string(i + 1)}));
-      WorkerMain();
+      WorkerMain(i);
     });
   }
-
-  for (const auto& worker : workers_) {
-    worker_thread_ids_.emplace_back(worker.get_id());
-  }
 }
 
 ConcurrentMessageLoop::~ConcurrentMessageLoop() {
@@ -47,53 +54,76 @@ void ConcurrentMessageLoop::PostTask(const fml::closure& task) {
     return;
   }
 
-  std::unique_lock lock(tasks_mutex_);
-
   // Don't just drop tasks on the floor in case of shutdown.
   if (shutdown_) {
     FML_DLOG(WARNING)
         << "Tried to post a task to shutdown concurrent message "
            "loop. The task will be executed on the callers thread.";
-    lock.unlock();
     ExecuteTask(task);
     return;
   }
 
-  tasks_.push(task);
+  // Tasks posted by a worker are usually related to the task it is running,
+  // so keep them on that worker unless another worker is idle and steals
+  // them.
+  size_t worker_index =
+      tls_loop == this
+          ? tls_worker_index
+          : next_worker_.fetch_add(1u, std::memory_order_relaxed) %
+                worker_count_;
+  {
+    Worker& worker = *worker_queues_[worker_index];
+    std::scoped_lock lock(worker.mutex);
+    // Counted before the task becomes visible, and under the same lock that
+    // the workers hold while they take it, so the count never drops below
+    // the number of queued tasks.
+    pending_task_count_.fetch_add(1u);
+    worker.tasks.push_back(task);
+  }
 
-  // Unlock the mutex before notifying the condition variable because that mutex
-  // has to be acquired on the other thread anyway. Waiting in this scope till
-  // it is acquired there is a pessimization.
-  lock.unlock();
+  WakeIdleWorkers(/*all=*/false);
+}
 
-  tasks_condition_.notify_one();
+void ConcurrentMessageLoop::WakeIdleWorkers(bool all) {
+  // The task counts are updated before the idle worker count is read here
+  // and a worker becomes idle before it reads the task counts, so either the
+  // worker sees the new task or it is woken up.
+  if (idle_worker_count_ == 0u) {
+    return;
+  }
+  std::scoped_lock lock(idle_mutex_);
+  if (all) {
+    idle_condition_.notify_all();
+  } else {
+    idle_condition_.notify_one();
+  }
 }
 
-void ConcurrentMessageLoop::WorkerMain() {
-  while (true) {
-    std::unique_lock lock(tasks_mutex_);
-    tasks_condition_.wait(lock, [&]() {
-      return !tasks_.empty() || shutdown_ || HasThreadTasksLocked();
-    });
+void ConcurrentMessageLoop::WorkerMain(size_t worker_index) {
+  tls_loop = this;
+  tls_worker_index = worker_index;
+  Worker& worker = *worker_queues_[worker_index];
 
-    // Shutdown cannot be read with the task mutex unlocked.
-    bool shutdown_now = shutdown_;
+  while (true) {
     fml::closure task;
-    std::vector<fml::closure> thread_tasks;
-
-    if (!tasks_.empty()) {
-      task = tasks_.front();
-      tasks_.pop();
-    }
-
-    if (HasThreadTasksLocked()) {
-      thread_tasks = GetThreadTasksLocked();
-      FML_DCHECK(!HasThreadTasksLocked());
+    bool has_task =
+        PopTask(worker_index, &task) || StealTask(worker_index, &task);
+    bool has_thread_tasks = worker.has_thread_tasks;
+
+    if (!has_task && !has_thread_tasks) {
+      if (shutdown_) {
+        break;
+      }
+      std::unique_lock lock(idle_mutex_);
+      idle_worker_count_++;
+      idle_condition_.wait(lock, [&]() {
+        return pending_task_count_ > 0u || shutdown_ || worker.has_thread_tasks;
+      });
+      idle_worker_count_--;
+      continue;
     }
 
-    // Don't hold onto the mutex while tasks are being executed as they could
-    // themselves try to post more tasks to the message loop.
-    lock.unlock();
+    bool shutdown_now = shutdown_;
 
     TRACE_EVENT0("flutter", "ConcurrentWorkerWake");
     // Execute the primary task we woke up for.
@@ -102,8 +132,10 @@ void ConcurrentMessageLoop::WorkerMain() {
     }
 
     // Execute any thread tasks.
-    for (const auto& thread_task : thread_tasks) {
-      ExecuteTask(thread_task);
+    if (has_thread_tasks) {
+      for (const auto& thread_task : TakeThreadTasks(worker_index)) {
+        ExecuteTask(thread_task);
+      }
     }
 
     if (shutdown_now) {
@@ -112,14 +144,52 @@ void ConcurrentMessageLoop::WorkerMain() {
   }
 }
 
+bool ConcurrentMessageLoop::PopTask(size_t worker_index, fml::closure* task) {
+  Worker& worker = *worker_queues_[worker_index];
+  std::scoped_lock lock(worker.mutex);
+  if (worker.tasks.empty()) {
+    return false;
+  }
+  *task = std::move(worker.tasks.front());
+  worker.tasks.pop_front();
+  pending_task_count_--;
+  return true;
+}
+
+bool ConcurrentMessageLoop::StealTask(size_t worker_index,
+                                      fml::closure* task) {
+  for (size_t i = 1; i < worker_count_ && pending_task_count_ > 0u; i++) {
+    Worker& victim = *worker_queues_[(worker_index + i) % worker_count_];
+    std::scoped_lock lock(victim.mutex);
+    if (victim.tasks.empty()) {
+      continue;
+    }
+    *task = std::move(victim.tasks.back());
+    victim.tasks.pop_back();
+    pending_task_count_--;
+    return true;
+  }
+  return false;
+}
+
+std::vector<fml::closure> ConcurrentMessageLoop::TakeThreadTasks(
+    size_t worker_index) {
+  Worker& worker = *worker_queues_[worker_index];
+  std::scoped_lock lock(worker.mutex);
+  std::vector<fml::closure> pending_tasks;
+  std::swap(pending_tasks, worker.thread_tasks);
+  worker.has_thread_tasks = false;
+  return pending_tasks;
+}
+
 void ConcurrentMessageLoop::ExecuteTask(const fml::closure& task) {
   task();
 }
 
 void ConcurrentMessageLoop::Terminate() {
-  std::scoped_lock lock(tasks_mutex_);
+  std::scoped_lock lock(idle_mutex_);
   shutdown_ = true;
-  tasks_condition_.notify_all();
+  idle_condition_.notify_all();
 }
 
 void ConcurrentMessageLoop::PostTaskToAllWorkers(const fml::closure& task) {
@@ -127,24 +197,12 @@ void ConcurrentMessageLoop::PostTaskToAllWorkers(const fml::closure& task) {
     return;
   }
 
-  std::scoped_lock lock(tasks_mutex_);
-  for (const auto& worker_thread_id : worker_thread_ids_) {
-    thread_tasks_[worker_thread_id].emplace_back(task);
+  for (const auto& worker : worker_queues_) {
+    std::scoped_lock lock(worker->mutex);
+    worker->thread_tasks.emplace_back(task);
+    worker->has_thread_tasks = true;
   }
-  tasks_condition_.notify_all();
-}
-
-bool ConcurrentMessageLoop::HasThreadTasksLocked() const {
-  return thread_tasks_.count(std::this_thread::get_id()) > 0;
-}
-
-std::vector<fml::closure> ConcurrentMessageLoop::GetThreadTasksLocked() {
-  auto found = thread_tasks_.find(std::this_thread::get_id());
-  FML_DCHECK(found != thread_tasks_.end());
-  std::vector<fml::closure> pending_tasks;
-  std::swap(pending_tasks, found->second);
-  thread_tasks_.erase(found);
-  return pending_tasks;
+  WakeIdleWorkers(/*all=*/true);
 }
 
 ConcurrentTaskRunner::ConcurrentTaskRunner(
@@ -170,13 +228,7 @@ void ConcurrentTaskRunner::PostTask(const fml::closure& task) {
 }
 
 bool ConcurrentMessageLoop::RunsTasksOnCurrentThread() {
-  std::scoped_lock lock(tasks_mutex_);
-  for (const auto& worker_thread_id : worker_thread_ids_) {
-    if (worker_thread_id == std::this_thread::get_id()) {
-      return true;
-    }
-  }
-  return false;
+  return tls_loop == this;
 }
 
 }  // namespace fml
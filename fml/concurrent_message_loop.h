@@ -5,10 +5,13 @@
 #ifndef FLUTTER_FML_CONCURRENT_MESSAGE_LOOP_H_
 #define FLUTTER_FML_CONCURRENT_MESSAGE_LOOP_H_
 
+#include <atomic>
 #include <condition_variable>
-#include <map>
-#include <queue>
+#include <deque>
+#include <memory>
+#include <mutex>
 #include <thread>
+#include <vector>
 
 #include "flutter/fml/closure.h"
 #include "flutter/fml/macros.h"
@@ -18,6 +21,17 @@ namespace fml {
 
 class ConcurrentTaskRunner;
 
+//------------------------------------------------------------------------------
+/// @brief      A pool of worker threads that run tasks in no particular order.
+///
+///             Each worker owns a queue of tasks. Tasks posted from a worker
+///             are added to the queue of that worker, and tasks posted from
+///             any other thread are spread over the queues in turn. A worker
+///             whose queue is empty steals tasks from the queues of the other
+///             workers before going to sleep, so a burst of tasks is picked
+///             up by every idle worker without all of them contending on a
+///             single lock.
+///
 class ConcurrentMessageLoop
     : public std::enable_shared_from_this<ConcurrentMessageLoop> {
  public:
@@ -32,6 +46,10 @@ class ConcurrentMessageLoop
 
   void Terminate();
 
+  //----------------------------------------------------------------------------
+  /// @brief      Run the task once on each of the workers. These tasks are
+  ///             never stolen by another worker.
+  ///
   void PostTaskToAllWorkers(const fml::closure& task);
 
   bool RunsTasksOnCurrentThread();
@@ -43,22 +61,40 @@ class ConcurrentMessageLoop
  private:
   friend ConcurrentTaskRunner;
 
+  struct Worker {
+    std::mutex mutex;
+    /// The worker takes tasks from the front, other workers steal from the
+    /// back.
+    std::deque<fml::closure> tasks;
+    /// Tasks posted with |PostTaskToAllWorkers|.
+    std::vector<fml::closure> thread_tasks;
+    std::atomic<bool> has_thread_tasks = false;
+  };
+
   size_t worker_count_ = 0;
+  std::vector<std::unique_ptr<Worker>> worker_queues_;
   std::vector<std::thread> workers_;
-  std::mutex tasks_mutex_;
-  std::condition_variable tasks_condition_;
-  std::queue<fml::closure> tasks_;
-  std::vector<std::thread::id> worker_thread_ids_;
-  std::map<std::thread::id, std::vector<fml::closure>> thread_tasks_;
-  bool shutdown_ = false;
-
-  void WorkerMain();
+  /// The number of tasks in all of the worker queues.
+  std::atomic<size_t> pending_task_count_ = 0;
+  /// The queue that the next task posted from outside the loop is added to.
+  std::atomic<size_t> next_worker_ = 0;
+  std::atomic<size_t> idle_worker_count_ = 0;
+  std::atomic<bool> shutdown_ = false;
+  /// Only used to put idle workers to sleep and wake them up again.
+  std::mutex idle_mutex_;
+  std::condition_variable idle_condition_;
+
+  void WorkerMain(size_t worker_index);
 
   void PostTask(const fml::closure& task);
 
-  bool HasThreadTasksLocked() const;
+  void WakeIdleWorkers(bool all);
+
+  bool PopTask(size_t worker_index, fml::closure* task);
+
+  bool StealTask(size_t worker_index, fml::closure* task);
 
-  std::vector<fml::closure> GetThreadTasksLocked();
+  std::vector<fml::closure> TakeThreadTasks(size_t worker_index);
 
   FML_DISALLOW_COPY_AND_ASSIGN(ConcurrentMessageLoop);
 };
@@ -0,0 +1,82 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/fml/concurrent_message_loop.h"
+
+#include <algorithm>
+#include <thread>
+
+#include "flutter/benchmarking/benchmarking.h"
+#include "flutter/fml/synchronization/count_down_latch.h"
+
+namespace fml {
+namespace benchmarking {
+
+static constexpr size_t kTaskCount = 10000;
+
+/// A stand-in for a small unit of work such as decoding a tile of an image.
+static void DoWork() {
+  uint32_t value = 0;
+  for (uint32_t i = 0; i < 1000; i++) {
+    value = value * 31 + i;
+    benchmark::DoNotOptimize(value);
+  }
+}
+
+/// Run the benchmarks with 1, 2, 4... workers up to the number of cores.
+static void WorkerCounts(benchmark::internal::Benchmark* benchmark) {
+  size_t core_count = std::max(std::thread::hardware_concurrency(), 1u);
+  for (size_t count = 1; count < core_count; count *= 2) {
+    benchmark->Arg(count);
+  }
+  benchmark->Arg(core_count);
+}
+
+/// Tasks posted from outside of the loop, like image decodes posted from the
+/// UI thread.
+static void BM_ConcurrentMessageLoopPostTask(
+    benchmark::State& state) {  // NOLINT
+  auto loop = ConcurrentMessageLoop::Create(state.range(0));
+  auto task_runner = loop->GetTaskRunner();
+  while (state.KeepRunning()) {
+    CountDownLatch latch(kTaskCount);
+    for (size_t i = 0; i < kTaskCount; i++) {
+      task_runner->PostTask([&latch]() {
+        DoWork();
+        latch.CountDown();
+      });
+    }
+    latch.Wait();
+  }
+  state.SetItemsProcessed(state.iterations() * kTaskCount);
+}
+
+/// A single task that fans out into many tasks from a worker, which the
+/// other workers have to steal.
+static void BM_ConcurrentMessageLoopNestedPostTask(
+    benchmark::State& state) {  // NOLINT
+  auto loop = ConcurrentMessageLoop::Create(state.range(0));
+  auto task_runner = loop->GetTaskRunner();
+  while (state.KeepRunning()) {
+    CountDownLatch latch(kTaskCount);
+    task_runner->PostTask([&latch, &task_runner]() {
+      for (size_t i = 0; i < kTaskCount; i++) {
+        task_runner->PostTask([&latch]() {
+          DoWork();
+          latch.CountDown();
+        });
+      }
+    });
+    latch.Wait();
+  }
+  state.SetItemsProcessed(state.iterations() * kTaskCount);
+}
+
+BENCHMARK(BM_ConcurrentMessageLoopPostTask)->Apply(WorkerCounts)->UseRealTime();
+BENCHMARK(BM_ConcurrentMessageLoopNestedPostTask)
+    ->Apply(WorkerCounts)
+    ->UseRealTime();
+
+}  // namespace benchmarking
+}  // namespace fml
@@ -72,6 +72,22 @@ bool IsFile(const std::string& path);
 
 bool TruncateFile(const fml::UniqueFD& file, size_t size);
 
+/// Reads the current size of an open file from the file system, which
+/// includes data written to it by other processes.
+bool GetFileSize(const fml::UniqueFD& file, size_t* size);
+
+/// Writes all of `data` to the file starting at `offset`, extending the file
+/// if needed.
+bool WriteFileAt(const fml::UniqueFD& file,
+                 size_t offset,
+                 const uint8_t* data,
+                 size_t size);
+
+/// Blocks until this process holds an exclusive advisory lock on the file.
+/// The lock is only honored by other callers of this function, and is
+/// released when the file is closed.
+bool AcquireFileLock(const fml::UniqueFD& file);
+
 bool FileExists(const fml::UniqueFD& base_directory, const char* path);
 
 bool UnlinkDirectory(const char* path);
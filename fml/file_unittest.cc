@@ -4,6 +4,7 @@
 
 #include <cstring>
 #include <memory>
+#include <string>
 #include <vector>
 
 #include "flutter/fml/build_config.h"
@@ -109,6 +110,47 @@ TEST(FileTest, CanTruncateAndWrite) {
   fml::UnlinkFile(dir.fd(), "some.txt");
 }
 
+TEST(FileTest, CanWriteAtOffsetAndGetSize) {
+  fml::ScopedTemporaryDirectory dir;
+  ASSERT_TRUE(dir.fd().is_valid());
+
+  {
+    auto fd = fml::OpenFile(dir.fd(), "some.txt", true,
+                            fml::FilePermission::kReadWrite);
+    ASSERT_TRUE(fd.is_valid());
+    ASSERT_TRUE(fml::AcquireFileLock(fd));
+
+    size_t size = 1u;
+    ASSERT_TRUE(fml::GetFileSize(fd, &size));
+    ASSERT_EQ(size, 0u);
+
+    const std::string first = "hello";
+    const std::string second = "world";
+    ASSERT_TRUE(fml::WriteFileAt(
+        fd, 0u, reinterpret_cast<const uint8_t*>(first.data()), first.size()));
+    ASSERT_TRUE(fml::WriteFileAt(
+        fd, 6u, reinterpret_cast<const uint8_t*>(second.data()),
+        second.size()));
+    ASSERT_TRUE(fml::GetFileSize(fd, &size));
+    ASSERT_EQ(size, 11u);
+  }
+
+  {
+    // The lock was released when the file was closed.
+    auto fd = fml::OpenFile(dir.fd(), "some.txt", false,
+                            fml::FilePermission::kReadWrite);
+    ASSERT_TRUE(fd.is_valid());
+    ASSERT_TRUE(fml::AcquireFileLock(fd));
+
+    fml::FileMapping mapping(fd);
+    ASSERT_EQ(mapping.GetSize(), 11u);
+    ASSERT_EQ(0, ::memcmp(mapping.GetMapping(), "hello", 5u));
+    ASSERT_EQ(0, ::memcmp(mapping.GetMapping() + 6u, "world", 5u));
+  }
+
+  fml::UnlinkFile(dir.fd(), "some.txt");
+}
+
 TEST(FileTest, CreateDirectoryStructure) {
   fml::ScopedTemporaryDirectory dir;
 
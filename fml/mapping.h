@@ -143,6 +143,8 @@ class NonOwnedMapping final : public Mapping {
 /// A Mapping like NonOwnedMapping, but uses Free as its release proc.
 class MallocMapping final : public Mapping {
  public:
+  using ReleaseProc = std::function<void(uint8_t* data, size_t size)>;
+
   MallocMapping();
 
   /// Creates a MallocMapping for a region of memory (without copying it).
@@ -151,6 +153,14 @@ class MallocMapping final : public Mapping {
   /// @param size The size of the mapping in bytes.
   MallocMapping(uint8_t* data, size_t size);
 
+  /// Creates a MallocMapping that takes ownership of a region of memory that
+  /// was not allocated with `malloc` (without copying it).
+  /// @param data The starting address of the mapping.
+  /// @param size The size of the mapping in bytes.
+  /// @param release_proc Called instead of `free` once the mapping no longer
+  ///                     needs the memory.
+  MallocMapping(uint8_t* data, size_t size, ReleaseProc release_proc);
+
   MallocMapping(fml::MallocMapping&& mapping);
 
   ~MallocMapping() override;
@@ -182,11 +192,14 @@ class MallocMapping final : public Mapping {
 
   /// Removes ownership of the data buffer.
   /// After this is called; the mapping will point to nullptr.
+  /// The result must be released with `free`. If the mapping was created with
+  /// a release proc, the data is copied into a new buffer first.
   [[nodiscard]] uint8_t* Release();
 
  private:
   uint8_t* data_;
   size_t size_;
+  ReleaseProc release_proc_;
 
   FML_DISALLOW_COPY_AND_ASSIGN(MallocMapping);
 };
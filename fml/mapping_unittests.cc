@@ -54,6 +54,36 @@ TEST(MallocMapping, Release) {
   ASSERT_EQ(0u, mapping.GetSize());
 }
 
+TEST(MallocMapping, ReleaseProcIsCalledInsteadOfFree) {
+  uint8_t buffer[10] = {1, 2, 3};
+  int release_count = 0;
+  {
+    MallocMapping mapping(buffer, sizeof(buffer),
+                          [&](uint8_t* data, size_t size) {
+                            EXPECT_EQ(data, buffer);
+                            EXPECT_EQ(size, sizeof(buffer));
+                            release_count++;
+                          });
+    ASSERT_EQ(buffer, mapping.GetMapping());
+    MallocMapping moved = std::move(mapping);
+    ASSERT_EQ(buffer, moved.GetMapping());
+  }
+  ASSERT_EQ(1, release_count);
+}
+
+TEST(MallocMapping, ReleaseWithReleaseProcCopies) {
+  uint8_t buffer[10] = {1, 2, 3};
+  int release_count = 0;
+  MallocMapping mapping(buffer, sizeof(buffer),
+                        [&](uint8_t* data, size_t size) { release_count++; });
+  uint8_t* released = mapping.Release();
+  ASSERT_EQ(1, release_count);
+  ASSERT_NE(buffer, released);
+  ASSERT_EQ(0, memcmp(buffer, released, sizeof(buffer)));
+  ASSERT_EQ(nullptr, mapping.GetMapping());
+  free(released);
+}
+
 TEST(MallocMapping, IsDontNeedSafe) {
   size_t length = 10;
   MallocMapping mapping(reinterpret_cast<uint8_t*>(malloc(length)), length);
@@ -9,6 +9,7 @@
 #include <memory>
 #include <mutex>
 #include <set>
+#include <shared_mutex>
 #include <vector>
 
 #include "flutter/fml/closure.h"
@@ -45,6 +46,11 @@ class TaskQueueEntry {
 
   TaskQueueId created_for;
 
+  /// Guards the tasks, observers and wakeable of this TaskQueue. The merge
+  /// state above is instead only modified while no TaskQueue is in use.
+  /// \see fml::MessageLoopTaskQueues::Merge
+  mutable std::mutex mutex;
+
   explicit TaskQueueEntry(TaskQueueId created_for);
 
  private:
@@ -60,6 +66,12 @@ enum class FlushType {
 /// fml::MessageLoops.
 ///
 /// This also wakes up the loop at the required times.
+///
+/// Each TaskQueue has its own lock so that loops posting to and draining
+/// different queues don't contend with each other. Creating, disposing,
+/// merging and unmerging queues instead take an exclusive lock over all
+/// queues, which keeps the merge state stable while tasks are registered or
+/// run.
 /// \see fml::MessageLoop
 /// \see fml::Wakeable
 class MessageLoopTaskQueues {
@@ -139,10 +151,14 @@ class MessageLoopTaskQueues {
  private:
   class MergedQueuesRunner;
 
+  class QueueGroupLock;
+
   MessageLoopTaskQueues();
 
   ~MessageLoopTaskQueues();
 
+  TaskQueueEntry& GetEntryUnlocked(TaskQueueId queue_id) const;
+
   void WakeUpUnlocked(TaskQueueId queue_id, fml::TimePoint time) const;
 
   bool HasPendingTasksUnlocked(TaskQueueId queue_id) const;
@@ -151,10 +167,24 @@ class MessageLoopTaskQueues {
 
   fml::TimePoint GetNextWakeTimeUnlocked(TaskQueueId queue_id) const;
 
-  mutable std::mutex queue_mutex_;
-  std::map<TaskQueueId, std::unique_ptr<TaskQueueEntry>> queue_entries_;
+  // Acquires |coordination_mutex_| shared without overtaking a writer that
+  // is waiting for it.
+  std::shared_lock<std::shared_mutex> LockCoordinationShared() const;
+
+  // Held shared while operating on the tasks of a group of merged queues
+  // and exclusively while creating, disposing, merging or unmerging queues.
+  mutable std::shared_mutex coordination_mutex_;
+
+  // std::shared_mutex may keep granting shared ownership while a writer
+  // waits, as glibc's does, so a steady stream of posted tasks could starve
+  // merges. Writers hold this while they acquire and hold
+  // |coordination_mutex_| and readers pass through it first, so once a
+  // writer is waiting no new reader gets ahead of it.
+  mutable std::mutex coordination_turnstile_;
 
-  size_t task_queue_id_counter_ = 0;
+  // Indexed by TaskQueueId. Disposed queues leave a nullptr behind so that
+  // the ids are never reused.
+  std::vector<std::unique_ptr<TaskQueueEntry>> queue_entries_;
 
   std::atomic_int order_;
 
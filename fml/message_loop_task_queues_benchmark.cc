@@ -4,6 +4,7 @@
 
 #include "flutter/fml/message_loop_task_queues.h"
 
+#include <atomic>
 #include <cassert>
 #include <string>
 #include <thread>
@@ -11,6 +12,8 @@
 
 #include "flutter/benchmarking/benchmarking.h"
 #include "flutter/fml/synchronization/count_down_latch.h"
+#include "flutter/fml/synchronization/waitable_event.h"
+#include "flutter/fml/wakeable.h"
 
 namespace fml {
 namespace benchmarking {
@@ -66,5 +69,106 @@ static void BM_RegisterAndGetTasks(benchmark::State& state) {  // NOLINT
 
 BENCHMARK(BM_RegisterAndGetTasks);
 
+// Each benchmark thread posts to and drains its own queue, like the
+// platform, UI, raster and IO loops do. Ideally this scales with the number
+// of threads since the queues are independent.
+static void BM_RegisterAndGetTasksOnSeparateQueues(
+    benchmark::State& state) {  // NOLINT
+  auto task_queues = fml::MessageLoopTaskQueues::GetInstance();
+  const TaskQueueId queue_id = task_queues->CreateTaskQueue();
+  const fml::TimePoint past = fml::TimePoint::Now();
+
+  for (auto _ : state) {
+    task_queues->RegisterTask(queue_id, [] {}, past);
+    fml::closure invocation = task_queues->GetNextTaskToRun(queue_id, past);
+    benchmark::DoNotOptimize(invocation);
+  }
+
+  task_queues->Dispose(queue_id);
+}
+
+BENCHMARK(BM_RegisterAndGetTasksOnSeparateQueues)
+    ->ThreadRange(1, 8)
+    ->UseRealTime();
+
+namespace {
+
+class SignalingWakeable : public fml::Wakeable {
+ public:
+  void WakeUp(fml::TimePoint time_point) override {
+    if (time_point != fml::TimePoint::Max()) {
+      wake_up_.Signal();
+    }
+  }
+
+  void Wait() { wake_up_.Wait(); }
+
+ private:
+  fml::AutoResetWaitableEvent wake_up_;
+};
+
+}  // namespace
+
+// Measures the time from posting a task to another thread's queue until it
+// has run there, while |state.range(0)| other threads keep posting to and
+// draining queues of their own.
+static void BM_CrossThreadPostLatency(benchmark::State& state) {  // NOLINT
+  auto task_queues = fml::MessageLoopTaskQueues::GetInstance();
+  const int num_busy_queues = state.range(0);
+  std::atomic_bool done = false;
+
+  std::vector<std::thread> busy_threads;
+  busy_threads.reserve(num_busy_queues);
+  for (int i = 0; i < num_busy_queues; i++) {
+    busy_threads.emplace_back([task_queues, &done]() {
+      const TaskQueueId queue_id = task_queues->CreateTaskQueue();
+      const fml::TimePoint past = fml::TimePoint::Now();
+      while (!done) {
+        task_queues->RegisterTask(queue_id, [] {}, past);
+        task_queues->GetNextTaskToRun(queue_id, past);
+      }
+      task_queues->Dispose(queue_id);
+    });
+  }
+
+  SignalingWakeable wakeable;
+  const TaskQueueId target_queue_id = task_queues->CreateTaskQueue();
+  task_queues->SetWakeable(target_queue_id, &wakeable);
+  std::thread target_thread([task_queues, target_queue_id, &wakeable,
+                             &done]() {
+    while (!done) {
+      wakeable.Wait();
+      const auto now = fml::TimePoint::Now();
+      while (fml::closure invocation =
+                 task_queues->GetNextTaskToRun(target_queue_id, now)) {
+        invocation();
+      }
+    }
+  });
+
+  fml::AutoResetWaitableEvent task_ran;
+  for (auto _ : state) {
+    task_queues->RegisterTask(
+        target_queue_id, [&task_ran]() { task_ran.Signal(); },
+        fml::TimePoint::Now());
+    task_ran.Wait();
+  }
+
+  done = true;
+  task_queues->RegisterTask(target_queue_id, [] {}, fml::TimePoint::Now());
+  target_thread.join();
+  for (auto& thread : busy_threads) {
+    thread.join();
+  }
+  task_queues->Dispose(target_queue_id);
+}
+
+BENCHMARK(BM_CrossThreadPostLatency)
+    ->Arg(0)
+    ->Arg(1)
+    ->Arg(3)
+    ->Arg(7)
+    ->UseRealTime();
+
 }  // namespace benchmarking
 }  // namespace fml
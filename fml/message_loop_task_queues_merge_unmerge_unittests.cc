@@ -4,6 +4,7 @@
 
 #define FML_USED_ON_EMBEDDER
 
+#include <atomic>
 #include <thread>
 #include <utility>
 
@@ -277,6 +278,38 @@ TEST(MessageLoopTaskQueueMergeUnmerge, GetTasksToRunNowBlocksMerge) {
   merge_thread.join();
 }
 
+TEST(MessageLoopTaskQueueMergeUnmerge, TasksPreservedWhileMergingConcurrently) {
+  auto task_queue = fml::MessageLoopTaskQueues::GetInstance();
+
+  auto queue_id_1 = task_queue->CreateTaskQueue();
+  auto queue_id_2 = task_queue->CreateTaskQueue();
+  const int num_tasks = 1000;
+  std::atomic_int tasks_run = 0;
+  std::atomic_bool posting_done = false;
+
+  std::thread post_thread([&]() {
+    for (int i = 0; i < num_tasks; i++) {
+      task_queue->RegisterTask(
+          queue_id_2, [&tasks_run]() { tasks_run++; }, ChronoTicksSinceEpoch());
+      if (i % 4 == 0) {
+        CountRemainingTasks(task_queue, queue_id_2, true);
+      }
+    }
+    posting_done = true;
+  });
+
+  while (!posting_done) {
+    task_queue->Merge(queue_id_1, queue_id_2);
+    CountRemainingTasks(task_queue, queue_id_1, true);
+    task_queue->Unmerge(queue_id_1, queue_id_2);
+  }
+  post_thread.join();
+
+  CountRemainingTasks(task_queue, queue_id_1, true);
+  CountRemainingTasks(task_queue, queue_id_2, true);
+  ASSERT_EQ(tasks_run, num_tasks);
+}
+
 TEST(MessageLoopTaskQueueMergeUnmerge,
      FollowingTasksSwitchQueueIfFirstTaskMergesThreads) {
   auto task_queue = fml::MessageLoopTaskQueues::GetInstance();
@@ -6,6 +6,7 @@
 
 #include <dirent.h>
 #include <fcntl.h>
+#include <sys/file.h>
 #include <sys/mman.h>
 #include <sys/stat.h>
 #include <unistd.h>
@@ -160,6 +161,42 @@ bool TruncateFile(const fml::UniqueFD& file, size_t size) {
   return ::ftruncate(file.get(), size) == 0;
 }
 
+bool GetFileSize(const fml::UniqueFD& file, size_t* size) {
+  struct stat stat_buffer = {};
+  if (!file.is_valid() || ::fstat(file.get(), &stat_buffer) != 0) {
+    return false;
+  }
+  *size = static_cast<size_t>(stat_buffer.st_size);
+  return true;
+}
+
+bool WriteFileAt(const fml::UniqueFD& file,
+                 size_t offset,
+                 const uint8_t* data,
+                 size_t size) {
+  if (!file.is_valid()) {
+    return false;
+  }
+  while (size > 0) {
+    ssize_t written =
+        FML_HANDLE_EINTR(::pwrite(file.get(), data, size, offset));
+    if (written <= 0) {
+      return false;
+    }
+    data += written;
+    size -= written;
+    offset += written;
+  }
+  return true;
+}
+
+bool AcquireFileLock(const fml::UniqueFD& file) {
+  if (!file.is_valid()) {
+    return false;
+  }
+  return FML_HANDLE_EINTR(::flock(file.get(), LOCK_EX)) == 0;
+}
+
 bool UnlinkDirectory(const char* path) {
   return UnlinkDirectory(fml::UniqueFD{AT_FDCWD}, path);
 }
@@ -343,6 +343,49 @@ bool TruncateFile(const fml::UniqueFD& file, size_t size) {
   return true;
 }
 
+bool GetFileSize(const fml::UniqueFD& file, size_t* size) {
+  LARGE_INTEGER file_size;
+  if (!::GetFileSizeEx(file.get(), &file_size)) {
+    FML_DLOG(ERROR) << "Could not get file size. " << GetLastErrorMessage();
+    return false;
+  }
+  *size = static_cast<size_t>(file_size.QuadPart);
+  return true;
+}
+
+bool WriteFileAt(const fml::UniqueFD& file,
+                 size_t offset,
+                 const uint8_t* data,
+                 size_t size) {
+  while (size > 0) {
+    OVERLAPPED overlapped = {};
+    overlapped.Offset = static_cast<DWORD>(offset & 0xFFFFFFFF);
+    overlapped.OffsetHigh =
+        static_cast<DWORD>(static_cast<uint64_t>(offset) >> 32);
+    DWORD chunk = static_cast<DWORD>(std::min<size_t>(size, MAXDWORD));
+    DWORD written = 0;
+    if (!::WriteFile(file.get(), data, chunk, &written, &overlapped) ||
+        written == 0) {
+      FML_DLOG(ERROR) << "Could not write file. " << GetLastErrorMessage();
+      return false;
+    }
+    data += written;
+    size -= written;
+    offset += written;
+  }
+  return true;
+}
+
+bool AcquireFileLock(const fml::UniqueFD& file) {
+  OVERLAPPED overlapped = {};
+  if (!::LockFileEx(file.get(), LOCKFILE_EXCLUSIVE_LOCK, 0, MAXDWORD, MAXDWORD,
+                    &overlapped)) {
+    FML_DLOG(ERROR) << "Could not lock file. " << GetLastErrorMessage();
+    return false;
+  }
+  return true;
+}
+
 bool FileExists(const fml::UniqueFD& base_directory, const char* path) {
   return GetFileAttributesForUtf8Path(base_directory, path) !=
          INVALID_FILE_ATTRIBUTES;
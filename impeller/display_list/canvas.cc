@@ -6,6 +6,7 @@
 
 #include <memory>
 #include <optional>
+#include <string>
 #include <unordered_map>
 #include <utility>
 
@@ -24,6 +25,8 @@
 #include "impeller/entity/contents/content_context.h"
 #include "impeller/entity/contents/filters/filter_contents.h"
 #include "impeller/entity/contents/framebuffer_blend_contents.h"
+#include "impeller/entity/contents/gradient_cache.h"
+#include "impeller/entity/contents/solid_color_contents.h"
 #include "impeller/entity/contents/solid_rrect_blur_contents.h"
 #include "impeller/entity/contents/text_contents.h"
 #include "impeller/entity/contents/texture_contents.h"
@@ -39,6 +42,7 @@
 #include "impeller/entity/geometry/round_rect_geometry.h"
 #include "impeller/entity/geometry/round_superellipse_geometry.h"
 #include "impeller/entity/geometry/stroke_path_geometry.h"
+#include "impeller/entity/geometry/tessellation_cache.h"
 #include "impeller/entity/save_layer_utils.h"
 #include "impeller/geometry/color.h"
 #include "impeller/geometry/constants.h"
@@ -209,6 +213,7 @@ void Canvas::Initialize(std::optional<Rect> cull_rect) {
 
 void Canvas::Reset() {
   current_depth_ = 0u;
+  rect_batch_.Clear();
   transform_stack_ = {};
 }
 
@@ -562,6 +567,7 @@ void Canvas::ClipGeometry(const Geometry& geometry,
   if (IsSkipping()) {
     return;
   }
+  FlushRectBatch();
 
   // Ideally the clip depth would be greater than the current rendering
   // depth because any rendering calls that follow this clip operation will
@@ -963,6 +969,7 @@ void Canvas::SaveLayer(const Paint& paint,
   if (IsSkipping()) {
     return SkipUntilMatchingRestore(total_content_depth);
   }
+  FlushRectBatch();
 
   auto maybe_coverage_limit = GetLocalCoverageLimit();
   if (!maybe_coverage_limit.has_value()) {
@@ -1186,6 +1193,7 @@ bool Canvas::Restore() {
   if (transform_stack_.size() == 1) {
     return false;
   }
+  FlushRectBatch();
 
   // This check is important to make sure we didn't exceed the depth
   // that the clips were rendered at while rendering any of the
@@ -1528,9 +1536,70 @@ void Canvas::AddRenderEntityToCurrentPass(Entity& entity, bool reuse_depth) {
     return;
   }
 
+  if (AddToRectBatch(entity)) {
+    return;
+  }
+  FlushRectBatch();
   entity.Render(renderer_, *result);
 }
 
+bool Canvas::AddToRectBatch(const Entity& entity) {
+  if (entity.GetBlendMode() > Entity::kLastPipelineBlendMode ||
+      !RectBatchGeometry::CanAddRect(entity.GetTransform())) {
+    return false;
+  }
+  const SolidColorContents* contents =
+      dynamic_cast<const SolidColorContents*>(entity.GetContents().get());
+  if (!contents || !contents->GetGeometry()) {
+    return false;
+  }
+  // Lines and strokes may also be axis aligned rectangles, but their width
+  // depends on the transform, so only filled rectangles are batched.
+  std::optional<Rect> rect = contents->GetGeometry()->GetFilledRect();
+  if (!rect.has_value()) {
+    return false;
+  }
+
+  Color color = contents->GetColor();
+  if (!rect_batch_.IsEmpty() &&
+      (color != rect_batch_color_ ||
+       entity.GetBlendMode() != rect_batch_blend_mode_)) {
+    FlushRectBatch();
+  }
+  // Nothing else is drawn into the pass and no clip changes until the batch
+  // is flushed, so the whole batch can be drawn at the depth of its last
+  // rectangle.
+  rect_batch_color_ = color;
+  rect_batch_blend_mode_ = entity.GetBlendMode();
+  rect_batch_depth_ = entity.GetClipDepth();
+  rect_batch_.AddRect(rect.value(), entity.GetTransform());
+  return true;
+}
+
+void Canvas::FlushRectBatch() {
+  if (rect_batch_.IsEmpty()) {
+    return;
+  }
+  TRACE_EVENT1("flutter", "Canvas::FlushRectBatch", "rects",
+               std::to_string(rect_batch_.GetRectCount()).c_str());
+
+  auto contents = std::make_shared<SolidColorContents>();
+  contents->SetColor(rect_batch_color_);
+  contents->SetGeometry(&rect_batch_);
+
+  Entity entity;
+  entity.SetBlendMode(rect_batch_blend_mode_);
+  entity.SetClipDepth(rect_batch_depth_);
+  entity.SetContents(std::move(contents));
+
+  const std::shared_ptr<RenderPass>& result =
+      render_passes_.back().inline_pass_context->GetRenderPass();
+  if (result) {
+    entity.Render(renderer_, *result);
+  }
+  rect_batch_.Clear();
+}
+
 RenderPass& Canvas::GetCurrentRenderPass() const {
   return *render_passes_.back().inline_pass_context->GetRenderPass();
 }
@@ -1545,6 +1614,7 @@ void Canvas::SetBackdropData(
 std::shared_ptr<Texture> Canvas::FlipBackdrop(Point global_pass_position,
                                               bool should_remove_texture,
                                               bool should_use_onscreen) {
+  FlushRectBatch();
   LazyRenderingConfig rendering_config = std::move(render_passes_.back());
   render_passes_.pop_back();
 
@@ -1714,6 +1784,7 @@ bool Canvas::BlitToOnscreen() {
 
 void Canvas::EndReplay() {
   FML_DCHECK(render_passes_.size() == 1u);
+  FlushRectBatch();
   render_passes_.back().inline_pass_context->GetRenderPass();
   render_passes_.back().inline_pass_context->EndPass();
   backdrop_data_.clear();
@@ -1731,6 +1802,8 @@ void Canvas::EndReplay() {
   }
   render_passes_.clear();
   renderer_.GetRenderTargetCache()->End();
+  renderer_.GetTessellationCache().EndFrame();
+  renderer_.GetGradientCache().EndFrame();
   clip_geometry_.clear();
 
   Reset();
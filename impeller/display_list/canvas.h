@@ -20,6 +20,7 @@
 #include "impeller/entity/entity.h"
 #include "impeller/entity/entity_pass_clip_stack.h"
 #include "impeller/entity/geometry/geometry.h"
+#include "impeller/entity/geometry/rect_batch_geometry.h"
 #include "impeller/entity/geometry/vertices_geometry.h"
 #include "impeller/entity/inline_pass_context.h"
 #include "impeller/geometry/matrix.h"
@@ -248,6 +249,11 @@ class Canvas {
   // Visible for testing.
   bool RequiresReadback() const { return requires_readback_; }
 
+  // Visible for testing.
+  size_t GetPendingRectBatchCount() const {
+    return rect_batch_.GetRectCount();
+  }
+
  private:
   ContentContext& renderer_;
   RenderTarget render_target_;
@@ -283,6 +289,13 @@ class Canvas {
 
   uint64_t current_depth_ = 0u;
 
+  /// Solid color rectangle fills that are deferred so that consecutive ones
+  /// can be drawn with a single draw call. See |AddToRectBatch|.
+  RectBatchGeometry rect_batch_;
+  Color rect_batch_color_;
+  BlendMode rect_batch_blend_mode_ = BlendMode::kSourceOver;
+  uint32_t rect_batch_depth_ = 0u;
+
   Point GetGlobalPassPosition() const;
 
   // clip depth of the previous save or 0.
@@ -333,6 +346,21 @@ class Canvas {
 
   void AddRenderEntityToCurrentPass(Entity& entity, bool reuse_depth = false);
 
+  /// @brief  Defers drawing |entity| if it is a solid color rectangle fill
+  ///         with a transform that can be applied on the CPU. Rectangles
+  ///         with the same color and blend mode are added to the pending
+  ///         batch, others flush the batch first.
+  ///
+  /// @return Whether the entity was added to the batch.
+  bool AddToRectBatch(const Entity& entity);
+
+  /// @brief  Draws the pending rectangle batch, if any, into the current
+  ///         render pass.
+  ///
+  ///         This must be called before anything else is drawn into the
+  ///         current pass and before the pass or the clip changes.
+  void FlushRectBatch();
+
   bool AttemptDrawBlurredRRect(const Rect& rect,
                                Size corner_radii,
                                const Paint& paint);
@@ -132,6 +132,51 @@ TEST_P(AiksTest, CanvasCTMCanBeUpdated) {
                      Matrix::MakeTranslation({100.0, 100.0, 0.0}));
 }
 
+TEST_P(AiksTest, SolidFilledRectsAreBatched) {
+  ContentContext context(GetContext(), nullptr);
+  auto canvas = CreateTestCanvas(context);
+  Paint paint = {.color = Color::Red()};
+
+  canvas->DrawRect(Rect::MakeLTRB(0, 0, 10, 10), paint);
+  canvas->DrawRect(Rect::MakeLTRB(20, 0, 30, 10), paint);
+  EXPECT_EQ(canvas->GetPendingRectBatchCount(), 2u);
+
+  // A different color starts a new batch.
+  paint.color = Color::Blue();
+  canvas->DrawRect(Rect::MakeLTRB(40, 0, 50, 10), paint);
+  EXPECT_EQ(canvas->GetPendingRectBatchCount(), 1u);
+
+  // Stroked rects are not filled rects.
+  Paint stroke = {.color = Color::Blue(), .stroke_width = 2.0f};
+  stroke.style = Paint::Style::kStroke;
+  canvas->DrawRect(Rect::MakeLTRB(60, 0, 70, 10), stroke);
+  EXPECT_EQ(canvas->GetPendingRectBatchCount(), 0u);
+}
+
+TEST_P(AiksTest, AxisAlignedLinesAreNotBatched) {
+  ContentContext context(GetContext(), nullptr);
+  auto canvas = CreateTestCanvas(context);
+  // The minimum width of a hairline depends on the transform, which a batch
+  // of rects in local coordinates would not account for.
+  canvas->Scale(Vector2(3, 3));
+
+  Paint paint = {.color = Color::Red()};
+  canvas->DrawRect(Rect::MakeLTRB(0, 0, 10, 10), paint);
+  EXPECT_EQ(canvas->GetPendingRectBatchCount(), 1u);
+
+  for (Cap cap : {Cap::kButt, Cap::kSquare}) {
+    Paint line = {.color = Color::Red(), .stroke_width = 0.0f};
+    line.stroke_cap = cap;
+    canvas->DrawLine({0, 20}, {20, 20}, line);
+    EXPECT_EQ(canvas->GetPendingRectBatchCount(), 0u);
+    canvas->DrawLine({20, 0}, {20, 20}, line);
+    EXPECT_EQ(canvas->GetPendingRectBatchCount(), 0u);
+  }
+
+  canvas->DrawRect(Rect::MakeLTRB(0, 0, 10, 10), paint);
+  EXPECT_EQ(canvas->GetPendingRectBatchCount(), 1u);
+}
+
 TEST_P(AiksTest, BackdropCountDownNormal) {
   ContentContext context(GetContext(), nullptr);
   if (!context.GetDeviceCapabilities().SupportsFramebufferFetch()) {
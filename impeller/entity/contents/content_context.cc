@@ -12,7 +12,9 @@
 #include "impeller/core/formats.h"
 #include "impeller/core/texture_descriptor.h"
 #include "impeller/entity/contents/framebuffer_blend_contents.h"
+#include "impeller/entity/contents/gradient_cache.h"
 #include "impeller/entity/entity.h"
+#include "impeller/entity/geometry/tessellation_cache.h"
 #include "impeller/entity/render_target_cache.h"
 #include "impeller/renderer/command_buffer.h"
 #include "impeller/renderer/pipeline_descriptor.h"
@@ -220,6 +222,39 @@ void ContentContextOptions::ApplyToPipelineDescriptor(
   desc.SetPolygonMode(wireframe ? PolygonMode::kLine : PolygonMode::kFill);
 }
 
+std::optional<ContentContextOptions> ContentContextOptions::FromKey(
+    uint64_t key) {
+  auto field = [key](int shift) -> uint8_t { return (key >> shift) & 0xff; };
+  const uint8_t sample_count = field(48);
+  if ((sample_count != static_cast<uint8_t>(SampleCount::kCount1) &&
+       sample_count != static_cast<uint8_t>(SampleCount::kCount4)) ||
+      field(40) > static_cast<uint8_t>(BlendMode::kLast) ||
+      field(32) > static_cast<uint8_t>(CompareFunction::kGreaterEqual) ||
+      field(24) >
+          static_cast<uint8_t>(StencilMode::kOverdrawPreventionRestore) ||
+      field(16) > static_cast<uint8_t>(PrimitiveType::kTriangleFan) ||
+      field(8) > static_cast<uint8_t>(PixelFormat::kD32FloatS8UInt)) {
+    return std::nullopt;
+  }
+  ContentContextOptions options{
+      .sample_count = static_cast<SampleCount>(sample_count),
+      .blend_mode = static_cast<BlendMode>(field(40)),
+      .depth_compare = static_cast<CompareFunction>(field(32)),
+      .stencil_mode = static_cast<StencilMode>(field(24)),
+      .primitive_type = static_cast<PrimitiveType>(field(16)),
+      .color_attachment_pixel_format = static_cast<PixelFormat>(field(8)),
+      .has_depth_stencil_attachments = (key & (1llu << 2)) != 0,
+      .depth_write_enabled = (key & (1llu << 3)) != 0,
+      .wireframe = (key & (1llu << 1)) != 0,
+      .is_for_rrect_blur_clear = (key & (1llu << 0)) != 0,
+  };
+  // Rejects keys with bits set that |ToKey| never sets.
+  if (options.ToKey() != key) {
+    return std::nullopt;
+  }
+  return options;
+}
+
 template <typename PipelineT>
 static std::unique_ptr<PipelineT> CreateDefaultPipeline(
     const Context& context) {
@@ -245,6 +280,9 @@ ContentContext::ContentContext(
       lazy_glyph_atlas_(
           std::make_shared<LazyGlyphAtlas>(std::move(typographer_context))),
       tessellator_(std::make_shared<Tessellator>()),
+      tessellation_cache_(std::make_unique<TessellationCache>(
+          context_->GetResourceAllocator())),
+      gradient_cache_(std::make_unique<GradientCache>()),
       render_target_cache_(render_target_allocator == nullptr
                                ? std::make_shared<RenderTargetCache>(
                                      context_->GetResourceAllocator())
@@ -294,30 +332,29 @@ ContentContext::ContentContext(
   // likely to be used first.
   {
     glyph_atlas_pipelines_.CreateDefault(
-        *context_, options,
+        *this, options,
         {static_cast<Scalar>(
             GetContext()->GetCapabilities()->GetDefaultGlyphAtlasFormat() ==
             PixelFormat::kA8UNormInt)});
-    solid_fill_pipelines_.CreateDefault(*context_, options);
-    texture_pipelines_.CreateDefault(*context_, options);
-    fast_gradient_pipelines_.CreateDefault(*context_, options);
+    solid_fill_pipelines_.CreateDefault(*this, options);
+    texture_pipelines_.CreateDefault(*this, options);
+    fast_gradient_pipelines_.CreateDefault(*this, options);
 
     if (context_->GetCapabilities()->SupportsSSBO()) {
-      linear_gradient_ssbo_fill_pipelines_.CreateDefault(*context_, options);
-      radial_gradient_ssbo_fill_pipelines_.CreateDefault(*context_, options);
-      conical_gradient_ssbo_fill_pipelines_.CreateDefault(*context_, options);
-      sweep_gradient_ssbo_fill_pipelines_.CreateDefault(*context_, options);
+      linear_gradient_ssbo_fill_pipelines_.CreateDefault(*this, options);
+      radial_gradient_ssbo_fill_pipelines_.CreateDefault(*this, options);
+      conical_gradient_ssbo_fill_pipelines_.CreateDefault(*this, options);
+      sweep_gradient_ssbo_fill_pipelines_.CreateDefault(*this, options);
     } else {
-      linear_gradient_uniform_fill_pipelines_.CreateDefault(*context_, options);
-      radial_gradient_uniform_fill_pipelines_.CreateDefault(*context_, options);
-      conical_gradient_uniform_fill_pipelines_.CreateDefault(*context_,
-                                                             options);
-      sweep_gradient_uniform_fill_pipelines_.CreateDefault(*context_, options);
-
-      linear_gradient_fill_pipelines_.CreateDefault(*context_, options);
-      radial_gradient_fill_pipelines_.CreateDefault(*context_, options);
-      conical_gradient_fill_pipelines_.CreateDefault(*context_, options);
-      sweep_gradient_fill_pipelines_.CreateDefault(*context_, options);
+      linear_gradient_uniform_fill_pipelines_.CreateDefault(*this, options);
+      radial_gradient_uniform_fill_pipelines_.CreateDefault(*this, options);
+      conical_gradient_uniform_fill_pipelines_.CreateDefault(*this, options);
+      sweep_gradient_uniform_fill_pipelines_.CreateDefault(*this, options);
+
+      linear_gradient_fill_pipelines_.CreateDefault(*this, options);
+      radial_gradient_fill_pipelines_.CreateDefault(*this, options);
+      conical_gradient_fill_pipelines_.CreateDefault(*this, options);
+      sweep_gradient_fill_pipelines_.CreateDefault(*this, options);
     }
 
     /// Setup default clip pipeline.
@@ -340,133 +377,129 @@ ContentContext::ContentContext(
     clip_pipeline_descriptor->SetColorAttachmentDescriptors(
         std::move(clip_color_attachments));
     clip_pipelines_.SetDefault(
-        options,
+        *this, options,
         std::make_unique<ClipPipeline>(*context_, clip_pipeline_descriptor));
-    texture_downsample_pipelines_.CreateDefault(*context_,
-                                                options_trianglestrip);
-    rrect_blur_pipelines_.CreateDefault(*context_, options_trianglestrip);
-    texture_strict_src_pipelines_.CreateDefault(*context_, options);
-    tiled_texture_pipelines_.CreateDefault(*context_, options,
+    texture_downsample_pipelines_.CreateDefault(*this, options_trianglestrip);
+    rrect_blur_pipelines_.CreateDefault(*this, options_trianglestrip);
+    texture_strict_src_pipelines_.CreateDefault(*this, options);
+    tiled_texture_pipelines_.CreateDefault(*this, options, {supports_decal});
+    gaussian_blur_pipelines_.CreateDefault(*this, options_trianglestrip,
                                            {supports_decal});
-    gaussian_blur_pipelines_.CreateDefault(*context_, options_trianglestrip,
-                                           {supports_decal});
-    border_mask_blur_pipelines_.CreateDefault(*context_, options_trianglestrip);
-    color_matrix_color_filter_pipelines_.CreateDefault(*context_,
+    border_mask_blur_pipelines_.CreateDefault(*this, options_trianglestrip);
+    color_matrix_color_filter_pipelines_.CreateDefault(*this,
                                                        options_trianglestrip);
-    porter_duff_blend_pipelines_.CreateDefault(*context_, options_trianglestrip,
+    porter_duff_blend_pipelines_.CreateDefault(*this, options_trianglestrip,
                                                {supports_decal});
-    vertices_uber_shader_.CreateDefault(*context_, options, {supports_decal});
+    vertices_uber_shader_.CreateDefault(*this, options, {supports_decal});
   }
 
   if (context_->GetCapabilities()->SupportsFramebufferFetch()) {
     framebuffer_blend_color_pipelines_.CreateDefault(
-        *context_, options_trianglestrip,
+        *this, options_trianglestrip,
         {static_cast<Scalar>(BlendSelectValues::kColor), supports_decal});
     framebuffer_blend_colorburn_pipelines_.CreateDefault(
-        *context_, options_trianglestrip,
+        *this, options_trianglestrip,
         {static_cast<Scalar>(BlendSelectValues::kColorBurn), supports_decal});
     framebuffer_blend_colordodge_pipelines_.CreateDefault(
-        *context_, options_trianglestrip,
+        *this, options_trianglestrip,
         {static_cast<Scalar>(BlendSelectValues::kColorDodge), supports_decal});
     framebuffer_blend_darken_pipelines_.CreateDefault(
-        *context_, options_trianglestrip,
+        *this, options_trianglestrip,
         {static_cast<Scalar>(BlendSelectValues::kDarken), supports_decal});
     framebuffer_blend_difference_pipelines_.CreateDefault(
-        *context_, options_trianglestrip,
+        *this, options_trianglestrip,
         {static_cast<Scalar>(BlendSelectValues::kDifference), supports_decal});
     framebuffer_blend_exclusion_pipelines_.CreateDefault(
-        *context_, options_trianglestrip,
+        *this, options_trianglestrip,
         {static_cast<Scalar>(BlendSelectValues::kExclusion), supports_decal});
     framebuffer_blend_hardlight_pipelines_.CreateDefault(
-        *context_, options_trianglestrip,
+        *this, options_trianglestrip,
         {static_cast<Scalar>(BlendSelectValues::kHardLight), supports_decal});
     framebuffer_blend_hue_pipelines_.CreateDefault(
-        *context_, options_trianglestrip,
+        *this, options_trianglestrip,
         {static_cast<Scalar>(BlendSelectValues::kHue), supports_decal});
     framebuffer_blend_lighten_pipelines_.CreateDefault(
-        *context_, options_trianglestrip,
+        *this, options_trianglestrip,
         {static_cast<Scalar>(BlendSelectValues::kLighten), supports_decal});
     framebuffer_blend_luminosity_pipelines_.CreateDefault(
-        *context_, options_trianglestrip,
+        *this, options_trianglestrip,
         {static_cast<Scalar>(BlendSelectValues::kLuminosity), supports_decal});
     framebuffer_blend_multiply_pipelines_.CreateDefault(
-        *context_, options_trianglestrip,
+        *this, options_trianglestrip,
         {static_cast<Scalar>(BlendSelectValues::kMultiply), supports_decal});
     framebuffer_blend_overlay_pipelines_.CreateDefault(
-        *context_, options_trianglestrip,
+        *this, options_trianglestrip,
         {static_cast<Scalar>(BlendSelectValues::kOverlay), supports_decal});
     framebuffer_blend_saturation_pipelines_.CreateDefault(
-        *context_, options_trianglestrip,
+        *this, options_trianglestrip,
         {static_cast<Scalar>(BlendSelectValues::kSaturation), supports_decal});
     framebuffer_blend_screen_pipelines_.CreateDefault(
-        *context_, options_trianglestrip,
+        *this, options_trianglestrip,
         {static_cast<Scalar>(BlendSelectValues::kScreen), supports_decal});
     framebuffer_blend_softlight_pipelines_.CreateDefault(
-        *context_, options_trianglestrip,
+        *this, options_trianglestrip,
         {static_cast<Scalar>(BlendSelectValues::kSoftLight), supports_decal});
   } else {
     blend_color_pipelines_.CreateDefault(
-        *context_, options_trianglestrip,
+        *this, options_trianglestrip,
         {static_cast<Scalar>(BlendSelectValues::kColor), supports_decal});
     blend_colorburn_pipelines_.CreateDefault(
-        *context_, options_trianglestrip,
+        *this, options_trianglestrip,
         {static_cast<Scalar>(BlendSelectValues::kColorBurn), supports_decal});
     blend_colordodge_pipelines_.CreateDefault(
-        *context_, options_trianglestrip,
+        *this, options_trianglestrip,
         {static_cast<Scalar>(BlendSelectValues::kColorDodge), supports_decal});
     blend_darken_pipelines_.CreateDefault(
-        *context_, options_trianglestrip,
+        *this, options_trianglestrip,
         {static_cast<Scalar>(BlendSelectValues::kDarken), supports_decal});
     blend_difference_pipelines_.CreateDefault(
-        *context_, options_trianglestrip,
+        *this, options_trianglestrip,
         {static_cast<Scalar>(BlendSelectValues::kDifference), supports_decal});
     blend_exclusion_pipelines_.CreateDefault(
-        *context_, options_trianglestrip,
+        *this, options_trianglestrip,
         {static_cast<Scalar>(BlendSelectValues::kExclusion), supports_decal});
     blend_hardlight_pipelines_.CreateDefault(
-        *context_, options_trianglestrip,
+        *this, options_trianglestrip,
         {static_cast<Scalar>(BlendSelectValues::kHardLight), supports_decal});
     blend_hue_pipelines_.CreateDefault(
-        *context_, options_trianglestrip,
+        *this, options_trianglestrip,
         {static_cast<Scalar>(BlendSelectValues::kHue), supports_decal});
     blend_lighten_pipelines_.CreateDefault(
-        *context_, options_trianglestrip,
+        *this, options_trianglestrip,
         {static_cast<Scalar>(BlendSelectValues::kLighten), supports_decal});
     blend_luminosity_pipelines_.CreateDefault(
-        *context_, options_trianglestrip,
+        *this, options_trianglestrip,
         {static_cast<Scalar>(BlendSelectValues::kLuminosity), supports_decal});
     blend_multiply_pipelines_.CreateDefault(
-        *context_, options_trianglestrip,
+        *this, options_trianglestrip,
         {static_cast<Scalar>(BlendSelectValues::kMultiply), supports_decal});
     blend_overlay_pipelines_.CreateDefault(
-        *context_, options_trianglestrip,
+        *this, options_trianglestrip,
         {static_cast<Scalar>(BlendSelectValues::kOverlay), supports_decal});
     blend_saturation_pipelines_.CreateDefault(
-        *context_, options_trianglestrip,
+        *this, options_trianglestrip,
         {static_cast<Scalar>(BlendSelectValues::kSaturation), supports_decal});
     blend_screen_pipelines_.CreateDefault(
-        *context_, options_trianglestrip,
+        *this, options_trianglestrip,
         {static_cast<Scalar>(BlendSelectValues::kScreen), supports_decal});
     blend_softlight_pipelines_.CreateDefault(
-        *context_, options_trianglestrip,
+        *this, options_trianglestrip,
         {static_cast<Scalar>(BlendSelectValues::kSoftLight), supports_decal});
   }
 
-  morphology_filter_pipelines_.CreateDefault(*context_, options_trianglestrip,
+  morphology_filter_pipelines_.CreateDefault(*this, options_trianglestrip,
                                              {supports_decal});
-  linear_to_srgb_filter_pipelines_.CreateDefault(*context_,
-                                                 options_trianglestrip);
-  srgb_to_linear_filter_pipelines_.CreateDefault(*context_,
-                                                 options_trianglestrip);
-  yuv_to_rgb_filter_pipelines_.CreateDefault(*context_, options_trianglestrip);
+  linear_to_srgb_filter_pipelines_.CreateDefault(*this, options_trianglestrip);
+  srgb_to_linear_filter_pipelines_.CreateDefault(*this, options_trianglestrip);
+  yuv_to_rgb_filter_pipelines_.CreateDefault(*this, options_trianglestrip);
 
 #if defined(IMPELLER_ENABLE_OPENGLES)
   if (GetContext()->GetBackendType() == Context::BackendType::kOpenGLES) {
 #if !defined(FML_OS_MACOSX)
     // GLES only shader that is unsupported on macOS.
-    tiled_texture_external_pipelines_.CreateDefault(*context_, options);
+    tiled_texture_external_pipelines_.CreateDefault(*this, options);
 #endif  // !defined(FML_OS_MACOSX)
-    texture_downsample_gles_pipelines_.CreateDefault(*context_,
+    texture_downsample_gles_pipelines_.CreateDefault(*this,
                                                      options_trianglestrip);
   }
 #endif  // IMPELLER_ENABLE_OPENGLES
@@ -557,6 +590,14 @@ Tessellator& ContentContext::GetTessellator() const {
   return *tessellator_;
 }
 
+TessellationCache& ContentContext::GetTessellationCache() const {
+  return *tessellation_cache_;
+}
+
+GradientCache& ContentContext::GetGradientCache() const {
+  return *gradient_cache_;
+}
+
 std::shared_ptr<Context> ContentContext::GetContext() const {
   return context_;
 }
@@ -595,6 +636,40 @@ void ContentContext::ClearCachedRuntimeEffectPipeline(
   }
 }
 
+size_t ContentContext::PrewarmPipelineVariants(
+    const PipelineVariantProfile& profile) const {
+  TRACE_EVENT0("impeller", "ContentContext::PrewarmPipelineVariants");
+  if (!IsValid()) {
+    return 0u;
+  }
+  size_t count = 0u;
+  for (const PipelineVariantProfile::Entry& entry : profile.GetEntries()) {
+    // The profile may have been recorded by a build with different pipelines
+    // or on a device with different capabilities.
+    auto creator = variant_creators_.find(entry.pipeline_name);
+    std::optional<ContentContextOptions> options =
+        ContentContextOptions::FromKey(entry.options_key);
+    if (creator == variant_creators_.end() || !options.has_value()) {
+      continue;
+    }
+    creator->second(options.value());
+    pipeline_variant_profile_.Add(entry.pipeline_name, entry.options_key);
+    count++;
+  }
+  return count;
+}
+
+void ContentContext::RecordVariantStall(
+    const PipelineDescriptor& default_desc,
+    const ContentContextOptions& opts) const {
+  pipeline_variant_stall_count_++;
+  pipeline_variant_profile_.Add(
+      PipelineVariantProfile::GetPipelineName(default_desc), opts.ToKey());
+  FML_TRACE_COUNTER("impeller", "PipelineVariants",
+                    reinterpret_cast<int64_t>(this),  // Trace Counter ID
+                    "Stalls", pipeline_variant_stall_count_);
+}
+
 void ContentContext::InitializeCommonlyUsedShadersIfNeeded() const {
   TRACE_EVENT0("flutter", "InitializeCommonlyUsedShadersIfNeeded");
   GetContext()->InitializeCommonlyUsedShadersIfNeeded();
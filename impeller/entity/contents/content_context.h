@@ -6,8 +6,10 @@
 #define FLUTTER_IMPELLER_ENTITY_CONTENTS_CONTENT_CONTEXT_H_
 
 #include <initializer_list>
+#include <functional>
 #include <memory>
 #include <optional>
+#include <string>
 #include <unordered_map>
 
 #include "flutter/fml/logging.h"
@@ -15,6 +17,7 @@
 #include "impeller/base/validation.h"
 #include "impeller/core/formats.h"
 #include "impeller/core/host_buffer.h"
+#include "impeller/entity/contents/pipeline_variant_profile.h"
 #include "impeller/renderer/capabilities.h"
 #include "impeller/renderer/command_buffer.h"
 #include "impeller/renderer/pipeline.h"
@@ -358,10 +361,18 @@ struct ContentContextOptions {
            static_cast<uint64_t>(sample_count) << 48;
   }
 
+  /// @brief  The inverse of |ToKey|.
+  ///
+  /// @return The options, or std::nullopt if |key| was not produced by
+  ///         |ToKey|.
+  static std::optional<ContentContextOptions> FromKey(uint64_t key);
+
   void ApplyToPipelineDescriptor(PipelineDescriptor& desc) const;
 };
 
 class Tessellator;
+class GradientCache;
+class TessellationCache;
 class RenderTargetCache;
 
 class ContentContext {
@@ -377,6 +388,14 @@ class ContentContext {
 
   Tessellator& GetTessellator() const;
 
+  /// @brief  The cache of path vertices that is shared across frames by the
+  ///         fill and stroke path geometries.
+  TessellationCache& GetTessellationCache() const;
+
+  /// @brief  The cache of gradient color ramp textures that is shared across
+  ///         frames by the gradient contents.
+  GradientCache& GetGradientCache() const;
+
   std::shared_ptr<Pipeline<PipelineDescriptor>> GetFastGradientPipeline(
       ContentContextOptions opts) const {
     return GetPipeline(fast_gradient_pipelines_, opts);
@@ -778,6 +797,34 @@ class ContentContext {
   /// allocate their own device buffers.
   HostBuffer& GetTransientsBuffer() const { return *host_buffer_; }
 
+  //----------------------------------------------------------------------------
+  /// @brief      Start creating the pipeline variants recorded in |profile|
+  ///             on the pipeline library's workers so that they are ready, or
+  ///             at least in flight, by the time the first frames use them.
+  ///
+  ///             The variants are also added to the profile of this context
+  ///             so that they are kept in the next saved profile.
+  ///
+  /// @return     The number of variants that were scheduled.
+  ///
+  size_t PrewarmPipelineVariants(const PipelineVariantProfile& profile) const;
+
+  //----------------------------------------------------------------------------
+  /// @brief      The pipeline variants that this context created, either ahead
+  ///             of time by |PrewarmPipelineVariants| or on demand.
+  ///
+  const PipelineVariantProfile& GetPipelineVariantProfile() const {
+    return pipeline_variant_profile_;
+  }
+
+  //----------------------------------------------------------------------------
+  /// @brief      The number of pipeline variants that were not created ahead
+  ///             of time and had to be created synchronously while drawing.
+  ///
+  size_t GetPipelineVariantStallCount() const {
+    return pipeline_variant_stall_count_;
+  }
+
  private:
   std::shared_ptr<Context> context_;
   std::shared_ptr<LazyGlyphAtlas> lazy_glyph_atlas_;
@@ -845,15 +892,18 @@ class ContentContext {
       pipelines_.push_back(std::make_pair(p_key, std::move(pipeline)));
     }
 
-    void SetDefault(const ContentContextOptions& options,
+    void SetDefault(ContentContext& content_context,
+                    const ContentContextOptions& options,
                     std::unique_ptr<PipelineHandleT> pipeline) {
       default_options_ = options;
       Set(options, std::move(pipeline));
+      content_context.RegisterVariants(*this);
     }
 
-    void CreateDefault(const Context& context,
+    void CreateDefault(ContentContext& content_context,
                        const ContentContextOptions& options,
                        const std::initializer_list<Scalar>& constants = {}) {
+      const Context& context = *content_context.context_;
       auto desc = PipelineHandleT::Builder::MakeDefaultPipelineDescriptor(
           context, constants);
       if (!desc.has_value()) {
@@ -861,7 +911,8 @@ class ContentContext {
         return;
       }
       options.ApplyToPipelineDescriptor(*desc);
-      SetDefault(options, std::make_unique<PipelineHandleT>(context, desc));
+      SetDefault(content_context, options,
+                 std::make_unique<PipelineHandleT>(context, desc));
     }
 
     PipelineHandleT* Get(const ContentContextOptions& options) const {
@@ -1039,16 +1090,67 @@ class ContentContext {
     std::unique_ptr<RenderPipelineHandleT> variant =
         std::make_unique<RenderPipelineHandleT>(std::move(variant_future));
     container.Set(opts, std::move(variant));
+    RecordVariantStall(*default_handle->GetDescriptor(), opts);
     return container.Get(opts);
   }
 
+  /// @brief  Creates the variant for |opts| on the pipeline library's
+  ///         workers without waiting for the default pipeline.
+  template <class RenderPipelineHandleT>
+  void CreateVariantAsync(Variants<RenderPipelineHandleT>& container,
+                          const ContentContextOptions& opts) const {
+    if (container.Get(opts)) {
+      return;
+    }
+    RenderPipelineHandleT* default_handle = container.GetDefault();
+    FML_CHECK(default_handle != nullptr);
+    std::optional<PipelineDescriptor> desc = default_handle->GetDescriptor();
+    if (!desc.has_value()) {
+      return;
+    }
+    opts.ApplyToPipelineDescriptor(*desc);
+    desc->SetLabel(SPrintF("%s V#%zu", desc->GetLabel().data(),
+                           container.GetPipelineCount()));
+    container.Set(opts, std::make_unique<RenderPipelineHandleT>(
+                            context_->GetPipelineLibrary()->GetPipeline(
+                                std::move(desc.value()), /*async=*/true)));
+  }
+
+  /// @brief  Makes the variants in |container| available to
+  ///         |PrewarmPipelineVariants|.
+  template <class RenderPipelineHandleT>
+  void RegisterVariants(Variants<RenderPipelineHandleT>& container) {
+    std::optional<PipelineDescriptor> desc =
+        container.GetDefault()->GetDescriptor();
+    if (!desc.has_value()) {
+      return;
+    }
+    variant_creators_[PipelineVariantProfile::GetPipelineName(*desc)] =
+        [this, &container](const ContentContextOptions& opts) {
+          CreateVariantAsync(container, opts);
+        };
+  }
+
+  void RecordVariantStall(const PipelineDescriptor& default_desc,
+                          const ContentContextOptions& opts) const;
+
   bool is_valid_ = false;
   std::shared_ptr<Tessellator> tessellator_;
+  std::unique_ptr<TessellationCache> tessellation_cache_;
+  std::unique_ptr<GradientCache> gradient_cache_;
   std::shared_ptr<RenderTargetAllocator> render_target_cache_;
   std::shared_ptr<HostBuffer> host_buffer_;
   std::shared_ptr<Texture> empty_texture_;
   bool wireframe_ = false;
 
+  /// Creates a variant of a registered pipeline, keyed by the name of the
+  /// pipeline in a |PipelineVariantProfile|.
+  std::unordered_map<std::string,
+                     std::function<void(const ContentContextOptions&)>>
+      variant_creators_;
+  mutable PipelineVariantProfile pipeline_variant_profile_;
+  mutable size_t pipeline_variant_stall_count_ = 0u;
+
   ContentContext(const ContentContext&) = delete;
 
   ContentContext& operator=(const ContentContext&) = delete;
@@ -0,0 +1,79 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "impeller/entity/contents/gradient_cache.h"
+
+#include "flutter/fml/hash_combine.h"
+#include "flutter/fml/trace_event.h"
+
+namespace impeller {
+
+GradientCache::GradientCache(size_t max_entry_count)
+    : max_entry_count_(max_entry_count) {}
+
+GradientCache::~GradientCache() = default;
+
+size_t GradientCache::ComputeHash(const std::vector<Color>& colors,
+                                  const std::vector<Scalar>& stops) {
+  size_t hash = fml::HashCombine(colors.size(), stops.size());
+  for (const Color& color : colors) {
+    fml::HashCombineSeed(hash, color.red, color.green, color.blue,
+                         color.alpha);
+  }
+  for (Scalar stop : stops) {
+    fml::HashCombineSeed(hash, stop);
+  }
+  return hash;
+}
+
+std::shared_ptr<Texture> GradientCache::GetOrCreateTexture(
+    const std::vector<Color>& colors,
+    const std::vector<Scalar>& stops,
+    const CreateTextureProc& create_texture) {
+  Key key{
+      .colors = colors,
+      .stops = stops,
+      .hash = ComputeHash(colors, stops),
+  };
+
+  auto found = index_.find(key);
+  if (found != index_.end()) {
+    EntryList::iterator entry = found->second;
+    entries_.splice(entries_.begin(), entries_, entry);
+    frame_hits_++;
+    total_hits_++;
+    return entry->texture;
+  }
+
+  frame_misses_++;
+  total_misses_++;
+  std::shared_ptr<Texture> texture =
+      create_texture(CreateGradientBuffer(colors, stops));
+  if (!texture || max_entry_count_ == 0u) {
+    return texture;
+  }
+
+  entries_.push_front(Entry{
+      .key = std::move(key),
+      .texture = texture,
+  });
+  index_[entries_.front().key] = entries_.begin();
+  while (entries_.size() > max_entry_count_) {
+    index_.erase(entries_.back().key);
+    entries_.pop_back();
+  }
+  return texture;
+}
+
+void GradientCache::EndFrame() {
+  FML_TRACE_COUNTER("impeller", "GradientCache",
+                    reinterpret_cast<int64_t>(this),  // Trace Counter ID
+                    "Hits", frame_hits_,              //
+                    "Misses", frame_misses_,          //
+                    "Entries", entries_.size());
+  frame_hits_ = 0u;
+  frame_misses_ = 0u;
+}
+
+}  // namespace impeller
@@ -0,0 +1,118 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_IMPELLER_ENTITY_CONTENTS_GRADIENT_CACHE_H_
+#define FLUTTER_IMPELLER_ENTITY_CONTENTS_GRADIENT_CACHE_H_
+
+#include <functional>
+#include <list>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "impeller/core/texture.h"
+#include "impeller/geometry/color.h"
+#include "impeller/geometry/gradient.h"
+
+namespace impeller {
+
+//------------------------------------------------------------------------------
+/// @brief      A bounded LRU cache of the color ramp textures used by the
+///             gradient contents on backends that can't read the stops from
+///             a storage buffer, keyed on the colors and stops of the
+///             gradient.
+///
+///             Gradients usually keep the same colors and stops from frame
+///             to frame, so the ramp is only interpolated and uploaded the
+///             first time it is drawn and later draws sample the same
+///             texture.
+///
+///             This object is not thread safe, and its methods must only be
+///             called from the raster thread.
+///
+class GradientCache {
+ public:
+  /// @brief  Produces the texture for a cache miss.
+  using CreateTextureProc =
+      std::function<std::shared_ptr<Texture>(const GradientData& data)>;
+
+  static constexpr size_t kDefaultMaxEntryCount = 128u;
+
+  explicit GradientCache(size_t max_entry_count = kDefaultMaxEntryCount);
+
+  ~GradientCache();
+
+  //----------------------------------------------------------------------------
+  /// @brief      Return the cached ramp texture for the colors and stops, or
+  ///             interpolate the ramp and invoke |create_texture| to upload
+  ///             it.
+  ///
+  ///             Textures that fail to be created are not cached.
+  ///
+  std::shared_ptr<Texture> GetOrCreateTexture(
+      const std::vector<Color>& colors,
+      const std::vector<Scalar>& stops,
+      const CreateTextureProc& create_texture);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Report the hit and miss counters for the frame that was
+  ///             just rendered to the timeline and reset them.
+  ///
+  void EndFrame();
+
+  /// Visible for testing.
+  size_t GetEntryCount() const { return entries_.size(); }
+
+  /// Visible for testing.
+  size_t GetHitCount() const { return total_hits_; }
+
+  /// Visible for testing.
+  size_t GetMissCount() const { return total_misses_; }
+
+ private:
+  struct Key {
+    std::vector<Color> colors;
+    std::vector<Scalar> stops;
+    /// Precomputed since the colors and stops may be long.
+    size_t hash;
+
+    bool operator==(const Key& other) const {
+      return hash == other.hash && colors == other.colors &&
+             stops == other.stops;
+    }
+
+    struct Hash {
+      std::size_t operator()(const Key& key) const { return key.hash; }
+    };
+  };
+
+  struct Entry {
+    Key key;
+    std::shared_ptr<Texture> texture;
+  };
+
+  using EntryList = std::list<Entry>;
+
+  const size_t max_entry_count_;
+
+  /// Most recently used entries are at the front.
+  EntryList entries_;
+  std::unordered_map<Key, EntryList::iterator, Key::Hash> index_;
+
+  size_t frame_hits_ = 0u;
+  size_t frame_misses_ = 0u;
+  size_t total_hits_ = 0u;
+  size_t total_misses_ = 0u;
+
+  static size_t ComputeHash(const std::vector<Color>& colors,
+                            const std::vector<Scalar>& stops);
+
+  GradientCache(const GradientCache&) = delete;
+
+  GradientCache& operator=(const GradientCache&) = delete;
+};
+
+}  // namespace impeller
+
+#endif  // FLUTTER_IMPELLER_ENTITY_CONTENTS_GRADIENT_CACHE_H_
@@ -0,0 +1,107 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <memory>
+#include <vector>
+
+#include "flutter/testing/testing.h"
+#include "impeller/entity/contents/gradient_cache.h"
+#include "impeller/renderer/testing/mocks.h"
+
+namespace impeller {
+namespace testing {
+
+namespace {
+
+/// Creates a mock texture that is as wide as the gradient ramp and counts
+/// how often it was called.
+struct FakeTextureCreator {
+  size_t calls = 0u;
+
+  std::shared_ptr<Texture> operator()(const GradientData& data) {
+    calls++;
+    TextureDescriptor desc;
+    desc.format = PixelFormat::kR8G8B8A8UNormInt;
+    desc.size = {static_cast<int64_t>(data.texture_size), 1};
+    return std::make_shared<MockTexture>(desc);
+  }
+};
+
+}  // namespace
+
+TEST(GradientCacheTest, ReusesTextureForSameColorsAndStops) {
+  GradientCache cache;
+  FakeTextureCreator creator;
+  auto create = [&creator](const GradientData& data) { return creator(data); };
+
+  std::vector<Color> colors = {Color::Red(), Color::Blue()};
+  std::vector<Scalar> stops = {0.0f, 1.0f};
+  std::shared_ptr<Texture> first =
+      cache.GetOrCreateTexture(colors, stops, create);
+  std::shared_ptr<Texture> second =
+      cache.GetOrCreateTexture(colors, stops, create);
+
+  ASSERT_NE(first, nullptr);
+  EXPECT_EQ(first, second);
+  EXPECT_EQ(creator.calls, 1u);
+  EXPECT_EQ(cache.GetHitCount(), 1u);
+  EXPECT_EQ(cache.GetMissCount(), 1u);
+
+  // A different stop produces a different ramp.
+  std::shared_ptr<Texture> third =
+      cache.GetOrCreateTexture(colors, {0.0f, 0.5f}, create);
+  EXPECT_NE(third, first);
+  EXPECT_EQ(creator.calls, 2u);
+  EXPECT_EQ(cache.GetEntryCount(), 2u);
+
+  // As does a different color.
+  std::shared_ptr<Texture> fourth =
+      cache.GetOrCreateTexture({Color::Red(), Color::Green()}, stops, create);
+  EXPECT_NE(fourth, first);
+  EXPECT_EQ(creator.calls, 3u);
+  EXPECT_EQ(cache.GetEntryCount(), 3u);
+}
+
+TEST(GradientCacheTest, EvictsLeastRecentlyUsedTexture) {
+  GradientCache cache(/*max_entry_count=*/2u);
+  FakeTextureCreator creator;
+  auto create = [&creator](const GradientData& data) { return creator(data); };
+
+  std::vector<Scalar> stops = {0.0f, 1.0f};
+  std::vector<Color> a = {Color::Red(), Color::Blue()};
+  std::vector<Color> b = {Color::Green(), Color::Blue()};
+  std::vector<Color> c = {Color::White(), Color::Blue()};
+
+  cache.GetOrCreateTexture(a, stops, create);
+  cache.GetOrCreateTexture(b, stops, create);
+  // Touch |a| so that |b| is the least recently used entry.
+  cache.GetOrCreateTexture(a, stops, create);
+  cache.GetOrCreateTexture(c, stops, create);
+  EXPECT_EQ(cache.GetEntryCount(), 2u);
+  EXPECT_EQ(creator.calls, 3u);
+
+  cache.GetOrCreateTexture(a, stops, create);
+  EXPECT_EQ(creator.calls, 3u);
+  cache.GetOrCreateTexture(b, stops, create);
+  EXPECT_EQ(creator.calls, 4u);
+}
+
+TEST(GradientCacheTest, DoesNotCacheFailedTextures) {
+  GradientCache cache;
+  size_t calls = 0u;
+  auto fail = [&calls](const GradientData& data) {
+    calls++;
+    return std::shared_ptr<Texture>();
+  };
+
+  std::vector<Color> colors = {Color::Red(), Color::Blue()};
+  std::vector<Scalar> stops = {0.0f, 1.0f};
+  EXPECT_EQ(cache.GetOrCreateTexture(colors, stops, fail), nullptr);
+  EXPECT_EQ(cache.GetOrCreateTexture(colors, stops, fail), nullptr);
+  EXPECT_EQ(calls, 2u);
+  EXPECT_EQ(cache.GetEntryCount(), 0u);
+}
+
+}  // namespace testing
+}  // namespace impeller
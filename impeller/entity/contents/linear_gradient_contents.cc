@@ -6,6 +6,7 @@
 
 #include "impeller/core/formats.h"
 #include "impeller/entity/contents/content_context.h"
+#include "impeller/entity/contents/gradient_cache.h"
 #include "impeller/entity/contents/gradient_generator.h"
 #include "impeller/entity/entity.h"
 #include "impeller/entity/geometry/geometry.h"
@@ -229,9 +230,11 @@ bool LinearGradientContents::RenderTexture(const ContentContext& renderer,
   return ColorSourceContents::DrawGeometry<VS>(
       renderer, entity, pass, pipeline_callback, frame_info,
       [this, &renderer, &entity](RenderPass& pass) {
-        auto gradient_data = CreateGradientBuffer(colors_, stops_);
-        auto gradient_texture =
-            CreateGradientTexture(gradient_data, renderer.GetContext());
+        auto gradient_texture = renderer.GetGradientCache().GetOrCreateTexture(
+            colors_, stops_, [&renderer](const GradientData& gradient_data) {
+              return CreateGradientTexture(gradient_data,
+                                           renderer.GetContext());
+            });
         if (gradient_texture == nullptr) {
           return false;
         }
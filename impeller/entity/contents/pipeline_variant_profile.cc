@@ -0,0 +1,113 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "impeller/entity/contents/pipeline_variant_profile.h"
+
+#include <algorithm>
+#include <cinttypes>
+#include <cstdio>
+
+#include "flutter/fml/file.h"
+#include "impeller/base/strings.h"
+
+namespace impeller {
+
+static constexpr const char* kPipelineVariantProfileFileName =
+    "flutter.impeller.variants";
+
+// Bump the version whenever the layout of |ContentContextOptions::ToKey|
+// changes so that older profiles are ignored.
+static constexpr std::string_view kPipelineVariantProfileHeader =
+    "impeller-pipeline-variants 1\n";
+
+PipelineVariantProfile::PipelineVariantProfile() = default;
+
+PipelineVariantProfile::~PipelineVariantProfile() = default;
+
+std::string PipelineVariantProfile::GetPipelineName(
+    const PipelineDescriptor& desc) {
+  std::string name(desc.GetLabel());
+  for (Scalar constant : desc.GetSpecializationConstants()) {
+    name += SPrintF(":%g", constant);
+  }
+  return name;
+}
+
+bool PipelineVariantProfile::Add(std::string_view pipeline_name,
+                                 uint64_t options_key) {
+  Entry entry{
+      .pipeline_name = std::string(pipeline_name),
+      .options_key = options_key,
+  };
+  if (std::find(entries_.begin(), entries_.end(), entry) != entries_.end()) {
+    return false;
+  }
+  entries_.push_back(std::move(entry));
+  return true;
+}
+
+std::unique_ptr<fml::Mapping> PipelineVariantProfile::Serialize() const {
+  std::string manifest(kPipelineVariantProfileHeader);
+  for (const Entry& entry : entries_) {
+    manifest += SPrintF("%016" PRIx64 " %s\n", entry.options_key,
+                        entry.pipeline_name.c_str());
+  }
+  return std::make_unique<fml::DataMapping>(manifest);
+}
+
+std::optional<PipelineVariantProfile> PipelineVariantProfile::Parse(
+    const fml::Mapping& mapping) {
+  std::string_view manifest(reinterpret_cast<const char*>(mapping.GetMapping()),
+                            mapping.GetSize());
+  if (manifest.substr(0, kPipelineVariantProfileHeader.size()) !=
+      kPipelineVariantProfileHeader) {
+    return std::nullopt;
+  }
+  manifest.remove_prefix(kPipelineVariantProfileHeader.size());
+
+  PipelineVariantProfile profile;
+  while (!manifest.empty()) {
+    size_t line_end = manifest.find('\n');
+    if (line_end == std::string_view::npos) {
+      // The last line was cut short.
+      break;
+    }
+    std::string line(manifest.substr(0, line_end));
+    manifest.remove_prefix(line_end + 1);
+
+    uint64_t options_key = 0u;
+    int name_offset = 0;
+    if (std::sscanf(line.c_str(), "%16" SCNx64 " %n", &options_key,
+                    &name_offset) != 1 ||
+        name_offset <= 0 || static_cast<size_t>(name_offset) >= line.size()) {
+      continue;
+    }
+    profile.Add(std::string_view(line).substr(name_offset), options_key);
+  }
+  return profile;
+}
+
+bool PipelineVariantProfile::Persist(
+    const fml::UniqueFD& cache_directory) const {
+  if (!cache_directory.is_valid()) {
+    return false;
+  }
+  return fml::WriteAtomically(cache_directory, kPipelineVariantProfileFileName,
+                              *Serialize());
+}
+
+std::optional<PipelineVariantProfile> PipelineVariantProfile::Retrieve(
+    const fml::UniqueFD& cache_directory) {
+  if (!cache_directory.is_valid()) {
+    return std::nullopt;
+  }
+  std::unique_ptr<fml::FileMapping> mapping = fml::FileMapping::CreateReadOnly(
+      cache_directory, kPipelineVariantProfileFileName);
+  if (!mapping) {
+    return std::nullopt;
+  }
+  return Parse(*mapping);
+}
+
+}  // namespace impeller
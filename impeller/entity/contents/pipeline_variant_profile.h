@@ -0,0 +1,103 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_IMPELLER_ENTITY_CONTENTS_PIPELINE_VARIANT_PROFILE_H_
+#define FLUTTER_IMPELLER_ENTITY_CONTENTS_PIPELINE_VARIANT_PROFILE_H_
+
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "flutter/fml/mapping.h"
+#include "flutter/fml/unique_fd.h"
+#include "impeller/renderer/pipeline_descriptor.h"
+
+namespace impeller {
+
+//------------------------------------------------------------------------------
+/// @brief      The list of pipeline variants, i.e. the combinations of a
+///             pipeline and the |ContentContextOptions| it is drawn with,
+///             that a run of the engine created.
+///
+///             The profile is written to disk so that the next launch can
+///             create the same variants ahead of time with
+///             |ContentContext::PrewarmPipelineVariants| instead of creating
+///             each of them synchronously the first time it is drawn.
+///
+///             The manifest is a small text file. Its first line identifies
+///             the format, and each following line holds the options key of
+///             one variant in hexadecimal, followed by a space and the name
+///             of the pipeline.
+///
+class PipelineVariantProfile {
+ public:
+  struct Entry {
+    std::string pipeline_name;
+    uint64_t options_key = 0u;
+
+    bool operator==(const Entry& other) const {
+      return options_key == other.options_key &&
+             pipeline_name == other.pipeline_name;
+    }
+  };
+
+  PipelineVariantProfile();
+
+  ~PipelineVariantProfile();
+
+  //----------------------------------------------------------------------------
+  /// @brief      The name that identifies the variants of the pipeline with
+  ///             the given default descriptor across launches.
+  ///
+  ///             Some pipelines share their shaders and only differ in their
+  ///             specialization constants, so those are part of the name.
+  ///
+  static std::string GetPipelineName(const PipelineDescriptor& desc);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Add a variant to the profile.
+  ///
+  /// @return     Whether the variant was not in the profile yet.
+  ///
+  bool Add(std::string_view pipeline_name, uint64_t options_key);
+
+  const std::vector<Entry>& GetEntries() const { return entries_; }
+
+  size_t GetSize() const { return entries_.size(); }
+
+  bool IsEmpty() const { return entries_.empty(); }
+
+  std::unique_ptr<fml::Mapping> Serialize() const;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Parse a manifest produced by |Serialize|.
+  ///
+  /// @return     The profile, or std::nullopt if the manifest was written in
+  ///             a different format.
+  ///
+  static std::optional<PipelineVariantProfile> Parse(
+      const fml::Mapping& mapping);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Write the profile into |cache_directory|, replacing the one
+  ///             that was there.
+  ///
+  bool Persist(const fml::UniqueFD& cache_directory) const;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Read the profile written by |Persist| from
+  ///             |cache_directory|.
+  ///
+  static std::optional<PipelineVariantProfile> Retrieve(
+      const fml::UniqueFD& cache_directory);
+
+ private:
+  std::vector<Entry> entries_;
+};
+
+}  // namespace impeller
+
+#endif  // FLUTTER_IMPELLER_ENTITY_CONTENTS_PIPELINE_VARIANT_PROFILE_H_
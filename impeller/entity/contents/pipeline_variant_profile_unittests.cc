@@ -0,0 +1,84 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <string>
+
+#include "flutter/testing/testing.h"
+#include "impeller/entity/contents/content_context.h"
+#include "impeller/entity/contents/pipeline_variant_profile.h"
+
+namespace impeller {
+namespace testing {
+
+TEST(PipelineVariantProfileTest, SerializedProfileCanBeParsed) {
+  PipelineVariantProfile profile;
+  EXPECT_TRUE(profile.Add("SolidFill Pipeline", 0x0001000300010201u));
+  EXPECT_TRUE(profile.Add("Blend Pipeline:3:1", 0x0004000700010001u));
+
+  std::optional<PipelineVariantProfile> parsed =
+      PipelineVariantProfile::Parse(*profile.Serialize());
+  ASSERT_TRUE(parsed.has_value());
+  EXPECT_EQ(parsed->GetEntries(), profile.GetEntries());
+}
+
+TEST(PipelineVariantProfileTest, IgnoresDuplicateVariants) {
+  PipelineVariantProfile profile;
+  EXPECT_TRUE(profile.Add("SolidFill Pipeline", 1u));
+  EXPECT_FALSE(profile.Add("SolidFill Pipeline", 1u));
+  EXPECT_TRUE(profile.Add("SolidFill Pipeline", 2u));
+  EXPECT_TRUE(profile.Add("Texture Pipeline", 1u));
+  EXPECT_EQ(profile.GetSize(), 3u);
+}
+
+TEST(PipelineVariantProfileTest, RejectsUnknownFormat) {
+  fml::DataMapping old_version(
+      "impeller-pipeline-variants 0\n"
+      "0000000000000001 SolidFill Pipeline\n");
+  EXPECT_FALSE(PipelineVariantProfile::Parse(old_version).has_value());
+
+  fml::DataMapping empty("");
+  EXPECT_FALSE(PipelineVariantProfile::Parse(empty).has_value());
+}
+
+TEST(PipelineVariantProfileTest, SkipsMalformedAndTruncatedLines) {
+  fml::DataMapping manifest(
+      "impeller-pipeline-variants 1\n"
+      "not-a-key SolidFill Pipeline\n"
+      "0000000000000002\n"
+      "0000000000000003 Texture Pipeline\n"
+      "0000000000000004 Glyph");
+  std::optional<PipelineVariantProfile> profile =
+      PipelineVariantProfile::Parse(manifest);
+  ASSERT_TRUE(profile.has_value());
+  ASSERT_EQ(profile->GetSize(), 1u);
+  EXPECT_EQ(profile->GetEntries()[0].pipeline_name, "Texture Pipeline");
+  EXPECT_EQ(profile->GetEntries()[0].options_key, 3u);
+}
+
+TEST(PipelineVariantProfileTest, OptionsKeyRoundTrips) {
+  ContentContextOptions options{
+      .sample_count = SampleCount::kCount4,
+      .blend_mode = BlendMode::kMultiply,
+      .depth_compare = CompareFunction::kGreaterEqual,
+      .stencil_mode = ContentContextOptions::StencilMode::kCoverCompare,
+      .primitive_type = PrimitiveType::kTriangleStrip,
+      .color_attachment_pixel_format = PixelFormat::kB8G8R8A8UNormInt,
+      .has_depth_stencil_attachments = false,
+      .depth_write_enabled = true,
+      .is_for_rrect_blur_clear = true,
+  };
+  std::optional<ContentContextOptions> decoded =
+      ContentContextOptions::FromKey(options.ToKey());
+  ASSERT_TRUE(decoded.has_value());
+  EXPECT_EQ(decoded->ToKey(), options.ToKey());
+
+  // Unknown bits and out of range enums are rejected.
+  uint64_t unknown_bits = options.ToKey() | (1llu << 60);
+  EXPECT_FALSE(ContentContextOptions::FromKey(unknown_bits).has_value());
+  uint64_t unknown_blend_mode = options.ToKey() | (0xffllu << 40);
+  EXPECT_FALSE(ContentContextOptions::FromKey(unknown_blend_mode).has_value());
+}
+
+}  // namespace testing
+}  // namespace impeller
@@ -7,6 +7,7 @@
 #include "flutter/fml/logging.h"
 #include "impeller/entity/contents/clip_contents.h"
 #include "impeller/entity/contents/content_context.h"
+#include "impeller/entity/contents/gradient_cache.h"
 #include "impeller/entity/contents/gradient_generator.h"
 #include "impeller/entity/entity.h"
 #include "impeller/geometry/gradient.h"
@@ -174,9 +175,10 @@ bool SweepGradientContents::RenderTexture(const ContentContext& renderer,
   using VS = SweepGradientFillPipeline::VertexShader;
   using FS = SweepGradientFillPipeline::FragmentShader;
 
-  auto gradient_data = CreateGradientBuffer(colors_, stops_);
-  auto gradient_texture =
-      CreateGradientTexture(gradient_data, renderer.GetContext());
+  auto gradient_texture = renderer.GetGradientCache().GetOrCreateTexture(
+      colors_, stops_, [&renderer](const GradientData& gradient_data) {
+        return CreateGradientTexture(gradient_data, renderer.GetContext());
+      });
   if (gradient_texture == nullptr) {
     return false;
   }
@@ -9,6 +9,7 @@
 #include "impeller/core/vertex_buffer.h"
 #include "impeller/entity/contents/content_context.h"
 #include "impeller/entity/geometry/geometry.h"
+#include "impeller/entity/geometry/tessellation_cache.h"
 
 namespace impeller {
 
@@ -43,10 +44,19 @@ GeometryResult FillPathGeometry::GetPositionBuffer(
   bool supports_triangle_fan =
       renderer.GetDeviceCapabilities().SupportsTriangleFan() &&
       supports_primitive_restart;
-  VertexBuffer vertex_buffer = renderer.GetTessellator().TessellateConvex(
-      path_, host_buffer, entity.GetTransform().GetMaxBasisLengthXY(),
-      /*supports_primitive_restart=*/supports_primitive_restart,
-      /*supports_triangle_fan=*/supports_triangle_fan);
+  TessellationCache::Parameters parameters{
+      .kind = TessellationCache::Kind::kFill,
+      .supports_primitive_restart = supports_primitive_restart,
+      .supports_triangle_fan = supports_triangle_fan,
+  };
+  VertexBuffer vertex_buffer = renderer.GetTessellationCache().GetOrTessellate(
+      path_, entity.GetTransform().GetMaxBasisLengthXY(), parameters,
+      [&](Scalar scale) {
+        return renderer.GetTessellator().TessellateConvex(
+            path_, host_buffer, scale,
+            /*supports_primitive_restart=*/supports_primitive_restart,
+            /*supports_triangle_fan=*/supports_triangle_fan);
+      });
 
   return GeometryResult{
       .type = supports_triangle_fan ? PrimitiveType::kTriangleFan
@@ -26,6 +26,7 @@ GeometryResult Geometry::ComputePositionGeometry(
     const Entity& entity,
     RenderPass& pass) {
   using VT = SolidFillVertexShader::PerVertexData;
+  static_assert(sizeof(VT) == sizeof(Point));
 
   size_t count = generator.GetVertexCount();
 
@@ -36,14 +37,10 @@ GeometryResult Geometry::ComputePositionGeometry(
               .vertex_buffer = renderer.GetTransientsBuffer().Emplace(
                   count * sizeof(VT), alignof(VT),
                   [&generator](uint8_t* buffer) {
-                    auto vertices = reinterpret_cast<VT*>(buffer);
-                    generator.GenerateVertices([&vertices](const Point& p) {
-                      *vertices++ = {
-                          .position = p,
-                      };
-                    });
-                    FML_DCHECK(vertices == reinterpret_cast<VT*>(buffer) +
-                                               generator.GetVertexCount());
+                    [[maybe_unused]] size_t written =
+                        generator.GenerateVerticesInto(
+                            reinterpret_cast<Point*>(buffer));
+                    FML_DCHECK(written == generator.GetVertexCount());
                   }),
               .vertex_count = count,
               .index_type = IndexType::kNone,
@@ -118,6 +115,10 @@ bool Geometry::IsAxisAlignedRect() const {
   return false;
 }
 
+std::optional<Rect> Geometry::GetFilledRect() const {
+  return std::nullopt;
+}
+
 bool Geometry::CanApplyMaskFilter() const {
   return true;
 }
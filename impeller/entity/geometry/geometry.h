@@ -110,6 +110,15 @@ class Geometry {
 
   virtual bool IsAxisAlignedRect() const;
 
+  /// @brief    Returns the rectangle that this geometry fills, if it is a
+  ///           filled rectangle.
+  ///
+  ///           Unlike `IsAxisAlignedRect`, this is only true for geometries
+  ///           whose area is exactly the returned rectangle under any
+  ///           transform, which excludes strokes and lines whose width
+  ///           depends on the transform.
+  virtual std::optional<Rect> GetFilledRect() const;
+
   virtual bool CanApplyMaskFilter() const;
 
   virtual Scalar ComputeAlphaCoverage(const Matrix& transform) const {
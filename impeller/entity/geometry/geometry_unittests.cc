@@ -7,6 +7,7 @@
 #include "gtest/gtest.h"
 #include "impeller/entity/contents/content_context.h"
 #include "impeller/entity/geometry/geometry.h"
+#include "impeller/entity/geometry/rect_batch_geometry.h"
 #include "impeller/entity/geometry/stroke_path_geometry.h"
 #include "impeller/geometry/constants.h"
 #include "impeller/geometry/geometry_asserts.h"
@@ -129,6 +130,51 @@ TEST(EntityGeometryTest, RoundRectGeometryCoversArea) {
   EXPECT_TRUE(geometry->CoversArea({}, Rect::MakeLTRB(1, 30, 99, 70)));
 }
 
+TEST(EntityGeometryTest, RectBatchGeometryTransformsRectsOnTheCpu) {
+  RectBatchGeometry geometry;
+  EXPECT_TRUE(geometry.IsEmpty());
+  EXPECT_EQ(geometry.GetCoverage({}), std::nullopt);
+
+  geometry.AddRect(Rect::MakeLTRB(0, 0, 10, 10),
+                   Matrix::MakeTranslation({100, 0}));
+  geometry.AddRect(Rect::MakeLTRB(0, 0, 10, 10),
+                   Matrix::MakeRotationZ(Degrees(90)));
+  EXPECT_EQ(geometry.GetRectCount(), 2u);
+  EXPECT_RECT_NEAR(geometry.GetCoverage({}).value(),
+                   Rect::MakeLTRB(-10, 0, 110, 10));
+  EXPECT_RECT_NEAR(geometry.GetCoverage(Matrix::MakeScale({2, 2, 1})).value(),
+                   Rect::MakeLTRB(-20, 0, 220, 20));
+
+  geometry.Clear();
+  EXPECT_TRUE(geometry.IsEmpty());
+  EXPECT_EQ(geometry.GetCoverage({}), std::nullopt);
+}
+
+TEST(EntityGeometryTest, RectBatchGeometryRejectsPerspective) {
+  EXPECT_TRUE(RectBatchGeometry::CanAddRect(Matrix()));
+  EXPECT_TRUE(RectBatchGeometry::CanAddRect(Matrix::MakeSkew(0.5, 0)));
+  EXPECT_FALSE(RectBatchGeometry::CanAddRect(
+      Matrix::MakePerspective(Degrees(60), 1.0, 0.1, 100.0)));
+  EXPECT_FALSE(
+      RectBatchGeometry::CanAddRect(Matrix::MakeRotationX(Degrees(10))));
+}
+
+TEST(EntityGeometryTest, OnlyRectGeometryIsAFilledRect) {
+  EXPECT_EQ(Geometry::MakeRect(Rect::MakeLTRB(0, 0, 10, 10))->GetFilledRect(),
+            Rect::MakeLTRB(0, 0, 10, 10));
+
+  // Axis aligned lines cover rectangles too, but their width depends on the
+  // transform.
+  auto line = Geometry::MakeLine({0, 0}, {10, 0}, 0.0f, Cap::kButt);
+  EXPECT_TRUE(line->IsAxisAlignedRect());
+  EXPECT_EQ(line->GetFilledRect(), std::nullopt);
+  EXPECT_EQ(Geometry::MakeFillPath(PathBuilder{}
+                                       .AddRect(Rect::MakeLTRB(0, 0, 10, 10))
+                                       .TakePath())
+                ->GetFilledRect(),
+            std::nullopt);
+}
+
 TEST(EntityGeometryTest, GeometryResultHasReasonableDefaults) {
   GeometryResult result;
   EXPECT_EQ(result.type, PrimitiveType::kTriangleStrip);
@@ -49,11 +49,9 @@ GeometryResult PointFieldGeometry::GetPositionBuffer(
         renderer.GetTessellator().FilledCircle(transform, {}, radius);
     FML_DCHECK(generator.GetTriangleType() == PrimitiveType::kTriangleStrip);
 
-    std::vector<Point> circle_vertices;
-    circle_vertices.reserve(generator.GetVertexCount());
-    generator.GenerateVertices([&circle_vertices](const Point& p) {  //
-      circle_vertices.push_back(p);
-    });
+    std::vector<Point> circle_vertices(generator.GetVertexCount());
+    circle_vertices.resize(
+        generator.GenerateVerticesInto(circle_vertices.data()));
     FML_DCHECK(circle_vertices.size() == generator.GetVertexCount());
 
     vertex_count = (circle_vertices.size() + 2) * point_count_ - 2;
@@ -0,0 +1,66 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "impeller/entity/geometry/rect_batch_geometry.h"
+
+#include "impeller/entity/contents/content_context.h"
+#include "impeller/entity/entity.h"
+
+namespace impeller {
+
+RectBatchGeometry::RectBatchGeometry() = default;
+
+RectBatchGeometry::~RectBatchGeometry() = default;
+
+// static
+bool RectBatchGeometry::CanAddRect(const Matrix& transform) {
+  return transform.IsAffine();
+}
+
+void RectBatchGeometry::AddRect(const Rect& rect, const Matrix& transform) {
+  FML_DCHECK(CanAddRect(transform));
+  std::array<Point, 4> points = rect.GetTransformedPoints(transform);
+  // The points are in triangle strip order, split them into two triangles.
+  vertices_.insert(vertices_.end(), {points[0], points[1], points[2],  //
+                                     points[1], points[2], points[3]});
+  Rect bounds = Rect::MakePointBounds(points.begin(), points.end()).value();
+  bounds_ = bounds_.has_value() ? bounds_->Union(bounds) : bounds;
+}
+
+void RectBatchGeometry::Clear() {
+  vertices_.clear();
+  bounds_ = std::nullopt;
+}
+
+GeometryResult RectBatchGeometry::GetPositionBuffer(
+    const ContentContext& renderer,
+    const Entity& entity,
+    RenderPass& pass) const {
+  if (vertices_.empty()) {
+    return {};
+  }
+  auto& host_buffer = renderer.GetTransientsBuffer();
+  return GeometryResult{
+      .type = PrimitiveType::kTriangle,
+      .vertex_buffer =
+          {
+              .vertex_buffer = host_buffer.Emplace(
+                  vertices_.data(), vertices_.size() * sizeof(Point),
+                  alignof(Point)),
+              .vertex_count = vertices_.size(),
+              .index_type = IndexType::kNone,
+          },
+      .transform = entity.GetShaderTransform(pass),
+  };
+}
+
+std::optional<Rect> RectBatchGeometry::GetCoverage(
+    const Matrix& transform) const {
+  if (!bounds_.has_value()) {
+    return std::nullopt;
+  }
+  return bounds_->TransformBounds(transform);
+}
+
+}  // namespace impeller
@@ -0,0 +1,58 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_IMPELLER_ENTITY_GEOMETRY_RECT_BATCH_GEOMETRY_H_
+#define FLUTTER_IMPELLER_ENTITY_GEOMETRY_RECT_BATCH_GEOMETRY_H_
+
+#include <vector>
+
+#include "impeller/entity/geometry/geometry.h"
+
+namespace impeller {
+
+/// @brief  A list of rectangles, each with its own transform, that are drawn
+///         as a single triangle list.
+///
+///         The rectangles are transformed on the CPU as they are added, so
+///         the geometry itself should be rendered with an entity whose
+///         transform is the identity. Only transforms without perspective can
+///         be applied on the CPU, see |CanAddRect|.
+class RectBatchGeometry final : public Geometry {
+ public:
+  RectBatchGeometry();
+
+  ~RectBatchGeometry() override;
+
+  /// @brief  Whether a rectangle drawn with |transform| produces the same
+  ///         pixels when it is transformed on the CPU.
+  static bool CanAddRect(const Matrix& transform);
+
+  void AddRect(const Rect& rect, const Matrix& transform);
+
+  size_t GetRectCount() const { return vertices_.size() / 6u; }
+
+  bool IsEmpty() const { return vertices_.empty(); }
+
+  void Clear();
+
+  // |Geometry|
+  GeometryResult GetPositionBuffer(const ContentContext& renderer,
+                                   const Entity& entity,
+                                   RenderPass& pass) const override;
+
+  // |Geometry|
+  std::optional<Rect> GetCoverage(const Matrix& transform) const override;
+
+ private:
+  std::vector<Point> vertices_;
+  std::optional<Rect> bounds_;
+
+  RectBatchGeometry(const RectBatchGeometry&) = delete;
+
+  RectBatchGeometry& operator=(const RectBatchGeometry&) = delete;
+};
+
+}  // namespace impeller
+
+#endif  // FLUTTER_IMPELLER_ENTITY_GEOMETRY_RECT_BATCH_GEOMETRY_H_
@@ -43,4 +43,8 @@ bool RectGeometry::IsAxisAlignedRect() const {
   return true;
 }
 
+std::optional<Rect> RectGeometry::GetFilledRect() const {
+  return rect_;
+}
+
 }  // namespace impeller
@@ -8,6 +8,7 @@
 #include "impeller/core/formats.h"
 #include "impeller/core/host_buffer.h"
 #include "impeller/entity/geometry/geometry.h"
+#include "impeller/entity/geometry/tessellation_cache.h"
 #include "impeller/geometry/constants.h"
 #include "impeller/geometry/path_builder.h"
 #include "impeller/geometry/path_component.h"
@@ -589,62 +590,70 @@ GeometryResult StrokePathGeometry::GetPositionBuffer(
   Scalar stroke_width = std::max(stroke_width_, min_size);
 
   auto& host_buffer = renderer.GetTransientsBuffer();
-  auto scale = entity.GetTransform().GetMaxBasisLengthXY();
-
-  PositionWriter position_writer(
-      renderer.GetTessellator().GetStrokePointCache());
-  Path::Polyline polyline =
-      renderer.GetTessellator().CreateTempPolyline(path_, scale);
-
-  CreateSolidStrokeVertices(position_writer, polyline, stroke_width,
-                            miter_limit_ * stroke_width_ * 0.5f,
-                            GetJoinProc(stroke_join_), GetCapProc(stroke_cap_),
-                            scale);
-
-  const auto [arena_length, oversized_length] = position_writer.GetUsedSize();
-  if (!position_writer.HasOversizedBuffer()) {
+  auto tessellate = [&](Scalar scale) -> VertexBuffer {
+    PositionWriter position_writer(
+        renderer.GetTessellator().GetStrokePointCache());
+    Path::Polyline polyline =
+        renderer.GetTessellator().CreateTempPolyline(path_, scale);
+
+    CreateSolidStrokeVertices(
+        position_writer, polyline, stroke_width,
+        miter_limit_ * stroke_width_ * 0.5f, GetJoinProc(stroke_join_),
+        GetCapProc(stroke_cap_), scale);
+
+    const auto [arena_length, oversized_length] =
+        position_writer.GetUsedSize();
+    if (!position_writer.HasOversizedBuffer()) {
+      BufferView buffer_view = host_buffer.Emplace(
+          renderer.GetTessellator().GetStrokePointCache().data(),
+          arena_length * sizeof(Point), alignof(Point));
+
+      return VertexBuffer{
+          .vertex_buffer = buffer_view,
+          .vertex_count = arena_length,
+          .index_type = IndexType::kNone,
+      };
+    }
+    const std::vector<Point>& oversized_data =
+        position_writer.GetOversizedBuffer();
     BufferView buffer_view = host_buffer.Emplace(
-        renderer.GetTessellator().GetStrokePointCache().data(),
-        arena_length * sizeof(Point), alignof(Point));
-
-    return GeometryResult{.type = PrimitiveType::kTriangleStrip,
-                          .vertex_buffer =
-                              {
-                                  .vertex_buffer = buffer_view,
-                                  .vertex_count = arena_length,
-                                  .index_type = IndexType::kNone,
-                              },
-                          .transform = entity.GetShaderTransform(pass),
-                          .mode = GeometryResult::Mode::kPreventOverdraw};
-  }
-  const std::vector<Point>& oversized_data =
-      position_writer.GetOversizedBuffer();
-  BufferView buffer_view = host_buffer.Emplace(
-      /*buffer=*/nullptr,                                 //
-      (arena_length + oversized_length) * sizeof(Point),  //
-      alignof(Point)                                      //
-  );
-  memcpy(buffer_view.GetBuffer()->OnGetContents() +
-             buffer_view.GetRange().offset,                       //
-         renderer.GetTessellator().GetStrokePointCache().data(),  //
-         arena_length * sizeof(Point)                             //
-  );
-  memcpy(buffer_view.GetBuffer()->OnGetContents() +
-             buffer_view.GetRange().offset + arena_length * sizeof(Point),  //
-         oversized_data.data(),                                             //
-         oversized_data.size() * sizeof(Point)                              //
-  );
-  buffer_view.GetBuffer()->Flush(buffer_view.GetRange());
-
-  return GeometryResult{.type = PrimitiveType::kTriangleStrip,
-                        .vertex_buffer =
-                            {
-                                .vertex_buffer = buffer_view,
-                                .vertex_count = arena_length + oversized_length,
-                                .index_type = IndexType::kNone,
-                            },
-                        .transform = entity.GetShaderTransform(pass),
-                        .mode = GeometryResult::Mode::kPreventOverdraw};
+        /*buffer=*/nullptr,                                 //
+        (arena_length + oversized_length) * sizeof(Point),  //
+        alignof(Point)                                      //
+    );
+    memcpy(buffer_view.GetBuffer()->OnGetContents() +
+               buffer_view.GetRange().offset,                       //
+           renderer.GetTessellator().GetStrokePointCache().data(),  //
+           arena_length * sizeof(Point)                             //
+    );
+    memcpy(buffer_view.GetBuffer()->OnGetContents() +
+               buffer_view.GetRange().offset +
+               arena_length * sizeof(Point),       //
+           oversized_data.data(),                  //
+           oversized_data.size() * sizeof(Point)  //
+    );
+    buffer_view.GetBuffer()->Flush(buffer_view.GetRange());
+
+    return VertexBuffer{
+        .vertex_buffer = buffer_view,
+        .vertex_count = arena_length + oversized_length,
+        .index_type = IndexType::kNone,
+    };
+  };
+
+  TessellationCache::Parameters parameters{
+      .kind = TessellationCache::Kind::kStroke,
+      .stroke_width = stroke_width,
+      .miter_limit = miter_limit_,
+      .stroke_cap = stroke_cap_,
+      .stroke_join = stroke_join_,
+  };
+  return GeometryResult{
+      .type = PrimitiveType::kTriangleStrip,
+      .vertex_buffer = renderer.GetTessellationCache().GetOrTessellate(
+          path_, max_basis, parameters, tessellate),
+      .transform = entity.GetShaderTransform(pass),
+      .mode = GeometryResult::Mode::kPreventOverdraw};
 }
 
 GeometryResult::Mode StrokePathGeometry::GetResultMode() const {
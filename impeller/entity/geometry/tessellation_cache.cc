@@ -0,0 +1,187 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "impeller/entity/geometry/tessellation_cache.h"
+
+#include <cmath>
+#include <limits>
+
+#include "flutter/fml/hash_combine.h"
+#include "flutter/fml/trace_event.h"
+
+namespace impeller {
+
+// The index data is placed after the vertex data in the same buffer at an
+// offset that satisfies the alignment requirements of every backend.
+static constexpr size_t kIndexDataAlignment = 16u;
+
+std::size_t TessellationCache::Key::Hash::operator()(const Key& key) const {
+  return fml::HashCombine(key.path_identity, key.scale_bucket,
+                          key.parameters.kind,
+                          key.parameters.supports_primitive_restart,
+                          key.parameters.supports_triangle_fan,
+                          key.parameters.stroke_width,
+                          key.parameters.miter_limit,
+                          key.parameters.stroke_cap,
+                          key.parameters.stroke_join);
+}
+
+TessellationCache::TessellationCache(std::shared_ptr<Allocator> allocator,
+                                     size_t max_entry_count,
+                                     size_t max_byte_size)
+    : allocator_(std::move(allocator)),
+      max_entry_count_(max_entry_count),
+      max_byte_size_(max_byte_size) {}
+
+TessellationCache::~TessellationCache() = default;
+
+int32_t TessellationCache::QuantizeScale(Scalar scale, Scalar* bucket_scale) {
+  if (!(scale > 0.0f) || !std::isfinite(scale)) {
+    *bucket_scale = scale;
+    return std::numeric_limits<int32_t>::min();
+  }
+  int32_t bucket = static_cast<int32_t>(
+      std::ceil(std::log2(scale) * kScaleBucketsPerOctave));
+  *bucket_scale = std::exp2(bucket / kScaleBucketsPerOctave);
+  // Guard against the round trip through log2/exp2 losing precision.
+  if (*bucket_scale < scale) {
+    *bucket_scale = scale;
+  }
+  return bucket;
+}
+
+VertexBuffer TessellationCache::GetOrTessellate(
+    const Path& path,
+    Scalar scale,
+    const Parameters& parameters,
+    const TessellateProc& tessellate) {
+  Scalar bucket_scale;
+  int32_t bucket = QuantizeScale(scale, &bucket_scale);
+  Key key{
+      .path_identity = path.GetIdentity(),
+      .scale_bucket = bucket,
+      .parameters = parameters,
+  };
+
+  auto found = index_.find(key);
+  if (found != index_.end()) {
+    EntryList::iterator entry = found->second;
+    entries_.splice(entries_.begin(), entries_, entry);
+    if (entry->buffer) {
+      frame_hits_++;
+      total_hits_++;
+      return MakeVertexBuffer(*entry);
+    }
+
+    // Second sighting, promote the entry to a device buffer.
+    frame_misses_++;
+    total_misses_++;
+    VertexBuffer vertices = tessellate(bucket_scale);
+    if (Upload(*entry, vertices)) {
+      cached_byte_size_ += entry->buffer->GetDeviceBufferDescriptor().size;
+      EvictIfNeeded();
+    }
+    return vertices;
+  }
+
+  frame_misses_++;
+  total_misses_++;
+  VertexBuffer vertices = tessellate(bucket_scale);
+  if (vertices.vertex_count < kMinCachedVertexCount) {
+    return vertices;
+  }
+  entries_.push_front(Entry{
+      .key = key,
+      .path = path,
+  });
+  index_[key] = entries_.begin();
+  EvictIfNeeded();
+  return vertices;
+}
+
+bool TessellationCache::Upload(Entry& entry, const VertexBuffer& vertices) {
+  if (!vertices.vertex_buffer || vertices.vertex_count == 0u) {
+    return false;
+  }
+  size_t vertex_byte_size = vertices.vertex_buffer.GetRange().length;
+  size_t index_byte_size = vertices.index_type == IndexType::kNone
+                               ? 0u
+                               : vertices.index_buffer.GetRange().length;
+  size_t index_offset =
+      (vertex_byte_size + kIndexDataAlignment - 1) & ~(kIndexDataAlignment - 1);
+
+  DeviceBufferDescriptor desc;
+  desc.storage_mode = StorageMode::kHostVisible;
+  desc.size = index_offset + index_byte_size;
+  if (desc.size > max_byte_size_) {
+    return false;
+  }
+  std::shared_ptr<DeviceBuffer> buffer = allocator_->CreateBuffer(desc);
+  if (!buffer) {
+    return false;
+  }
+  const uint8_t* vertex_data =
+      vertices.vertex_buffer.GetBuffer()->OnGetContents();
+  if (!buffer->CopyHostBuffer(vertex_data, vertices.vertex_buffer.GetRange(),
+                              0u)) {
+    return false;
+  }
+  if (index_byte_size > 0u) {
+    const uint8_t* index_data =
+        vertices.index_buffer.GetBuffer()->OnGetContents();
+    if (!buffer->CopyHostBuffer(index_data, vertices.index_buffer.GetRange(),
+                                index_offset)) {
+      return false;
+    }
+  }
+  buffer->SetLabel("TessellationCache");
+
+  entry.buffer = std::move(buffer);
+  entry.vertex_byte_size = vertex_byte_size;
+  entry.index_byte_size = index_byte_size;
+  entry.vertex_count = vertices.vertex_count;
+  entry.index_type = vertices.index_type;
+  return true;
+}
+
+VertexBuffer TessellationCache::MakeVertexBuffer(const Entry& entry) {
+  size_t index_offset = (entry.vertex_byte_size + kIndexDataAlignment - 1) &
+                        ~(kIndexDataAlignment - 1);
+  return VertexBuffer{
+      .vertex_buffer = BufferView(entry.buffer,
+                                  Range{0u, entry.vertex_byte_size}),
+      .index_buffer =
+          entry.index_byte_size > 0u
+              ? BufferView(entry.buffer,
+                           Range{index_offset, entry.index_byte_size})
+              : BufferView(),
+      .vertex_count = entry.vertex_count,
+      .index_type = entry.index_type,
+  };
+}
+
+void TessellationCache::EvictIfNeeded() {
+  while (!entries_.empty() && (entries_.size() > max_entry_count_ ||
+                               cached_byte_size_ > max_byte_size_)) {
+    const Entry& victim = entries_.back();
+    if (victim.buffer) {
+      cached_byte_size_ -= victim.buffer->GetDeviceBufferDescriptor().size;
+    }
+    index_.erase(victim.key);
+    entries_.pop_back();
+  }
+}
+
+void TessellationCache::EndFrame() {
+  FML_TRACE_COUNTER("impeller", "TessellationCache",
+                    reinterpret_cast<int64_t>(this),  // Trace Counter ID
+                    "Hits", frame_hits_,              //
+                    "Misses", frame_misses_,          //
+                    "Entries", entries_.size(),       //
+                    "CachedKB", cached_byte_size_ / 1024u);
+  frame_hits_ = 0u;
+  frame_misses_ = 0u;
+}
+
+}  // namespace impeller
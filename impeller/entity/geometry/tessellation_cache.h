@@ -0,0 +1,189 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_IMPELLER_ENTITY_GEOMETRY_TESSELLATION_CACHE_H_
+#define FLUTTER_IMPELLER_ENTITY_GEOMETRY_TESSELLATION_CACHE_H_
+
+#include <functional>
+#include <list>
+#include <memory>
+#include <unordered_map>
+
+#include "impeller/core/allocator.h"
+#include "impeller/core/device_buffer.h"
+#include "impeller/core/vertex_buffer.h"
+#include "impeller/geometry/path.h"
+
+namespace impeller {
+
+//------------------------------------------------------------------------------
+/// @brief      A bounded LRU cache of the vertices generated for filled and
+///             stroked paths, keyed on the identity of the path, the
+///             tessellation parameters and a quantized scale.
+///
+///             A path is only cached the second time it is tessellated with
+///             the same parameters so that paths that change every frame
+///             (animations, text input, etc.) do not churn device memory.
+///             Once cached, the vertices live in a persistent |DeviceBuffer|
+///             instead of the per-frame |HostBuffer| and subsequent frames
+///             skip both the CPU tessellation and the upload.
+///
+///             The cache holds a copy of each cached path, which keeps the
+///             path's identity from being reused by a different path while
+///             its entry is alive.
+///
+///             This object is not thread safe, and its methods must only be
+///             called from the raster thread.
+///
+class TessellationCache {
+ public:
+  enum class Kind {
+    kFill,
+    kStroke,
+  };
+
+  /// The parameters, other than the path and the scale, that affect the
+  /// generated vertices.
+  struct Parameters {
+    Kind kind = Kind::kFill;
+    /// Only used by |Kind::kFill|.
+    bool supports_primitive_restart = false;
+    bool supports_triangle_fan = false;
+    /// Only used by |Kind::kStroke|.
+    Scalar stroke_width = 0.0f;
+    Scalar miter_limit = 0.0f;
+    Cap stroke_cap = Cap::kButt;
+    Join stroke_join = Join::kMiter;
+
+    bool operator==(const Parameters& other) const {
+      return kind == other.kind &&
+             supports_primitive_restart == other.supports_primitive_restart &&
+             supports_triangle_fan == other.supports_triangle_fan &&
+             stroke_width == other.stroke_width &&
+             miter_limit == other.miter_limit &&
+             stroke_cap == other.stroke_cap && stroke_join == other.stroke_join;
+    }
+  };
+
+  /// @brief  Produces the vertices for a cache miss. The vertices are
+  ///         expected to be allocated from the per-frame host buffer.
+  using TessellateProc = std::function<VertexBuffer(Scalar scale)>;
+
+  /// The number of scale buckets per doubling of the scale.
+  static constexpr Scalar kScaleBucketsPerOctave = 4.0f;
+
+  /// Results with fewer vertices than this are cheaper to regenerate than
+  /// to keep in a dedicated device buffer and are never cached.
+  static constexpr size_t kMinCachedVertexCount = 32u;
+
+  static constexpr size_t kDefaultMaxEntryCount = 256u;
+  static constexpr size_t kDefaultMaxByteSize = 4u * 1024u * 1024u;
+
+  explicit TessellationCache(std::shared_ptr<Allocator> allocator,
+                             size_t max_entry_count = kDefaultMaxEntryCount,
+                             size_t max_byte_size = kDefaultMaxByteSize);
+
+  ~TessellationCache();
+
+  //----------------------------------------------------------------------------
+  /// @brief      Map a transform scale onto a bucket so that small changes
+  ///             in scale (e.g. during an animation) reuse the same entry.
+  ///
+  ///             The bucket's scale, which is returned through
+  ///             |bucket_scale|, is never smaller than the given scale so
+  ///             that the cached tessellation is at least as fine as the
+  ///             one that would have been generated for the exact scale.
+  ///
+  static int32_t QuantizeScale(Scalar scale, Scalar* bucket_scale);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Return the cached vertices for the path and parameters, or
+  ///             invoke |tessellate| to produce them.
+  ///
+  ///             |tessellate| is called with the quantized scale that should
+  ///             be used in place of the scale of the transform.
+  ///
+  VertexBuffer GetOrTessellate(const Path& path,
+                               Scalar scale,
+                               const Parameters& parameters,
+                               const TessellateProc& tessellate);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Report the hit and miss counters for the frame that was
+  ///             just rendered to the timeline and reset them.
+  ///
+  void EndFrame();
+
+  /// Visible for testing.
+  size_t GetEntryCount() const { return entries_.size(); }
+
+  /// Visible for testing.
+  size_t GetCachedByteSize() const { return cached_byte_size_; }
+
+  /// Visible for testing.
+  size_t GetHitCount() const { return total_hits_; }
+
+  /// Visible for testing.
+  size_t GetMissCount() const { return total_misses_; }
+
+ private:
+  struct Key {
+    const void* path_identity;
+    int32_t scale_bucket;
+    Parameters parameters;
+
+    bool operator==(const Key& other) const {
+      return path_identity == other.path_identity &&
+             scale_bucket == other.scale_bucket &&
+             parameters == other.parameters;
+    }
+
+    struct Hash {
+      std::size_t operator()(const Key& key) const;
+    };
+  };
+
+  struct Entry {
+    Key key;
+    /// Retained so that the path identity cannot be reused while the entry
+    /// is alive.
+    Path path;
+    /// nullptr until the entry has been seen twice.
+    std::shared_ptr<DeviceBuffer> buffer;
+    size_t vertex_byte_size = 0u;
+    size_t index_byte_size = 0u;
+    size_t vertex_count = 0u;
+    IndexType index_type = IndexType::kNone;
+  };
+
+  using EntryList = std::list<Entry>;
+
+  std::shared_ptr<Allocator> allocator_;
+  const size_t max_entry_count_;
+  const size_t max_byte_size_;
+
+  /// Most recently used entries are at the front.
+  EntryList entries_;
+  std::unordered_map<Key, EntryList::iterator, Key::Hash> index_;
+  size_t cached_byte_size_ = 0u;
+
+  size_t frame_hits_ = 0u;
+  size_t frame_misses_ = 0u;
+  size_t total_hits_ = 0u;
+  size_t total_misses_ = 0u;
+
+  static VertexBuffer MakeVertexBuffer(const Entry& entry);
+
+  bool Upload(Entry& entry, const VertexBuffer& vertices);
+
+  void EvictIfNeeded();
+
+  TessellationCache(const TessellationCache&) = delete;
+
+  TessellationCache& operator=(const TessellationCache&) = delete;
+};
+
+}  // namespace impeller
+
+#endif  // FLUTTER_IMPELLER_ENTITY_GEOMETRY_TESSELLATION_CACHE_H_
@@ -0,0 +1,197 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <vector>
+
+#include "flutter/testing/testing.h"
+#include "impeller/core/host_buffer.h"
+#include "impeller/entity/entity_playground.h"
+#include "impeller/entity/geometry/tessellation_cache.h"
+#include "impeller/geometry/path_builder.h"
+#include "impeller/playground/playground_test.h"
+
+namespace impeller {
+namespace testing {
+
+using TessellationCacheTest = EntityPlayground;
+INSTANTIATE_PLAYGROUND_SUITE(TessellationCacheTest);
+
+namespace {
+
+Path MakePath(Scalar size) {
+  return PathBuilder{}.AddCircle({size, size}, size).TakePath();
+}
+
+/// A stand-in for the tessellator that writes |vertex_count| points into
+/// the host buffer and counts how often it was called.
+struct FakeTessellator {
+  HostBuffer& host_buffer;
+  size_t vertex_count;
+  size_t calls = 0u;
+
+  VertexBuffer operator()(Scalar scale) {
+    calls++;
+    std::vector<Point> points(vertex_count);
+    for (size_t i = 0; i < vertex_count; i++) {
+      points[i] = Point(static_cast<Scalar>(i), scale);
+    }
+    return VertexBuffer{
+        .vertex_buffer = host_buffer.Emplace(
+            points.data(), points.size() * sizeof(Point), alignof(Point)),
+        .vertex_count = vertex_count,
+        .index_type = IndexType::kNone,
+    };
+  }
+};
+
+}  // namespace
+
+TEST(TessellationCache, QuantizeScaleRoundsUp) {
+  Scalar bucket_scale;
+  EXPECT_EQ(TessellationCache::QuantizeScale(1.0f, &bucket_scale), 0);
+  EXPECT_FLOAT_EQ(bucket_scale, 1.0f);
+
+  EXPECT_EQ(TessellationCache::QuantizeScale(2.0f, &bucket_scale), 4);
+  EXPECT_FLOAT_EQ(bucket_scale, 2.0f);
+
+  for (Scalar scale = 0.05f; scale < 20.0f; scale *= 1.07f) {
+    TessellationCache::QuantizeScale(scale, &bucket_scale);
+    EXPECT_GE(bucket_scale, scale);
+    EXPECT_LT(bucket_scale, scale * 1.19f);
+  }
+
+  // Small changes in scale share a bucket.
+  EXPECT_EQ(TessellationCache::QuantizeScale(1.01f, &bucket_scale),
+            TessellationCache::QuantizeScale(1.1f, &bucket_scale));
+}
+
+TEST_P(TessellationCacheTest, CachesPathAfterSecondUse) {
+  auto host_buffer = HostBuffer::Create(GetContext()->GetResourceAllocator(),
+                                        GetContext()->GetIdleWaiter());
+  TessellationCache cache(GetContext()->GetResourceAllocator());
+  FakeTessellator tessellator{.host_buffer = *host_buffer, .vertex_count = 64};
+  Path path = MakePath(10);
+  TessellationCache::Parameters parameters;
+  auto proc = [&tessellator](Scalar scale) { return tessellator(scale); };
+
+  cache.GetOrTessellate(path, 1.0f, parameters, proc);
+  EXPECT_EQ(tessellator.calls, 1u);
+  EXPECT_EQ(cache.GetCachedByteSize(), 0u);
+
+  VertexBuffer second = cache.GetOrTessellate(path, 1.0f, parameters, proc);
+  EXPECT_EQ(tessellator.calls, 2u);
+  EXPECT_GE(cache.GetCachedByteSize(), 64u * sizeof(Point));
+
+  // A copy of the path shares its identity.
+  Path copy = path;
+  VertexBuffer third = cache.GetOrTessellate(copy, 1.0f, parameters, proc);
+  EXPECT_EQ(tessellator.calls, 2u);
+  EXPECT_EQ(cache.GetHitCount(), 1u);
+  EXPECT_EQ(cache.GetMissCount(), 2u);
+
+  ASSERT_EQ(third.vertex_count, 64u);
+  EXPECT_NE(third.vertex_buffer.GetBuffer(), second.vertex_buffer.GetBuffer());
+  ASSERT_EQ(third.vertex_buffer.GetRange().length, 64u * sizeof(Point));
+  EXPECT_EQ(memcmp(third.vertex_buffer.GetBuffer()->OnGetContents() +
+                       third.vertex_buffer.GetRange().offset,
+                   second.vertex_buffer.GetBuffer()->OnGetContents() +
+                       second.vertex_buffer.GetRange().offset,
+                   64u * sizeof(Point)),
+            0);
+}
+
+TEST_P(TessellationCacheTest, DoesNotCacheSmallPaths) {
+  auto host_buffer = HostBuffer::Create(GetContext()->GetResourceAllocator(),
+                                        GetContext()->GetIdleWaiter());
+  TessellationCache cache(GetContext()->GetResourceAllocator());
+  FakeTessellator tessellator{
+      .host_buffer = *host_buffer,
+      .vertex_count = TessellationCache::kMinCachedVertexCount - 1};
+  Path path = MakePath(10);
+  auto proc = [&tessellator](Scalar scale) { return tessellator(scale); };
+
+  for (int i = 0; i < 3; i++) {
+    cache.GetOrTessellate(path, 1.0f, {}, proc);
+  }
+  EXPECT_EQ(tessellator.calls, 3u);
+  EXPECT_EQ(cache.GetEntryCount(), 0u);
+  EXPECT_EQ(cache.GetHitCount(), 0u);
+}
+
+TEST_P(TessellationCacheTest, DistinguishesScaleAndParameters) {
+  auto host_buffer = HostBuffer::Create(GetContext()->GetResourceAllocator(),
+                                        GetContext()->GetIdleWaiter());
+  TessellationCache cache(GetContext()->GetResourceAllocator());
+  FakeTessellator tessellator{.host_buffer = *host_buffer, .vertex_count = 64};
+  Path path = MakePath(10);
+  auto proc = [&tessellator](Scalar scale) { return tessellator(scale); };
+  TessellationCache::Parameters fill;
+  TessellationCache::Parameters stroke{
+      .kind = TessellationCache::Kind::kStroke,
+      .stroke_width = 2.0f,
+  };
+
+  for (int i = 0; i < 2; i++) {
+    cache.GetOrTessellate(path, 1.0f, fill, proc);
+    cache.GetOrTessellate(path, 4.0f, fill, proc);
+    cache.GetOrTessellate(path, 1.0f, stroke, proc);
+  }
+  EXPECT_EQ(cache.GetEntryCount(), 3u);
+  EXPECT_EQ(cache.GetHitCount(), 0u);
+
+  cache.GetOrTessellate(path, 1.0f, fill, proc);
+  cache.GetOrTessellate(path, 4.0f, fill, proc);
+  cache.GetOrTessellate(path, 1.0f, stroke, proc);
+  EXPECT_EQ(cache.GetHitCount(), 3u);
+  EXPECT_EQ(tessellator.calls, 6u);
+}
+
+TEST_P(TessellationCacheTest, EvictsLeastRecentlyUsedEntries) {
+  auto host_buffer = HostBuffer::Create(GetContext()->GetResourceAllocator(),
+                                        GetContext()->GetIdleWaiter());
+  TessellationCache cache(GetContext()->GetResourceAllocator(),
+                          /*max_entry_count=*/2);
+  FakeTessellator tessellator{.host_buffer = *host_buffer, .vertex_count = 64};
+  auto proc = [&tessellator](Scalar scale) { return tessellator(scale); };
+  Path a = MakePath(10);
+  Path b = MakePath(20);
+  Path c = MakePath(30);
+
+  for (int i = 0; i < 2; i++) {
+    cache.GetOrTessellate(a, 1.0f, {}, proc);
+    cache.GetOrTessellate(b, 1.0f, {}, proc);
+  }
+  // Touch |a| so that |b| is the least recently used entry.
+  cache.GetOrTessellate(a, 1.0f, {}, proc);
+  cache.GetOrTessellate(c, 1.0f, {}, proc);
+  EXPECT_EQ(cache.GetEntryCount(), 2u);
+
+  size_t calls = tessellator.calls;
+  cache.GetOrTessellate(a, 1.0f, {}, proc);
+  EXPECT_EQ(tessellator.calls, calls);
+  cache.GetOrTessellate(b, 1.0f, {}, proc);
+  EXPECT_EQ(tessellator.calls, calls + 1);
+}
+
+TEST_P(TessellationCacheTest, EvictsWhenOverByteBudget) {
+  auto host_buffer = HostBuffer::Create(GetContext()->GetResourceAllocator(),
+                                        GetContext()->GetIdleWaiter());
+  TessellationCache cache(GetContext()->GetResourceAllocator(),
+                          /*max_entry_count=*/16,
+                          /*max_byte_size=*/100u * sizeof(Point));
+  FakeTessellator tessellator{.host_buffer = *host_buffer, .vertex_count = 64};
+  auto proc = [&tessellator](Scalar scale) { return tessellator(scale); };
+  Path a = MakePath(10);
+  Path b = MakePath(20);
+
+  for (int i = 0; i < 2; i++) {
+    cache.GetOrTessellate(a, 1.0f, {}, proc);
+    cache.GetOrTessellate(b, 1.0f, {}, proc);
+  }
+  EXPECT_LE(cache.GetCachedByteSize(), 100u * sizeof(Point));
+  EXPECT_EQ(cache.GetEntryCount(), 1u);
+}
+
+}  // namespace testing
+}  // namespace impeller
@@ -3,34 +3,138 @@
 // found in the LICENSE file.
 
 #include "impeller/entity/render_target_cache.h"
+#include "flutter/fml/trace_event.h"
 #include "impeller/core/formats.h"
+#include "impeller/renderer/capabilities.h"
+#include "impeller/renderer/context.h"
 #include "impeller/renderer/render_target.h"
 
 namespace impeller {
 
+namespace {
+
+size_t GetTextureByteSize(const std::shared_ptr<Texture>& texture) {
+  if (!texture) {
+    return 0u;
+  }
+  const TextureDescriptor& desc = texture->GetTextureDescriptor();
+  return desc.GetByteSizeOfAllMipLevels() *
+         static_cast<size_t>(desc.sample_count);
+}
+
+// Whether the only reference to |texture| is the one held by the cache.
+bool IsOnlyReferencedByCache(const std::shared_ptr<Texture>& texture) {
+  return !texture || texture.use_count() == 1;
+}
+
+}  // namespace
+
 RenderTargetCache::RenderTargetCache(std::shared_ptr<Allocator> allocator,
                                      uint32_t keep_alive_frame_count)
     : RenderTargetAllocator(std::move(allocator)),
       keep_alive_frame_count_(keep_alive_frame_count) {}
 
+bool RenderTargetCache::RenderTargetData::IsIdle() const {
+  // The render targets handed out by the cache, the render passes that draw
+  // into them and the commands that sample from them all hold references to
+  // the textures until the GPU no longer needs them.
+  return IsOnlyReferencedByCache(color_texture) &&
+         IsOnlyReferencedByCache(color_resolve_texture) &&
+         IsOnlyReferencedByCache(depth_stencil_texture);
+}
+
 void RenderTargetCache::Start() {
-  for (auto& td : render_target_data_) {
-    td.used_this_frame = false;
+  for (auto& [key, bucket] : render_target_data_) {
+    for (RenderTargetData& td : bucket) {
+      td.used_this_frame = false;
+    }
   }
+  frame_byte_size_ = 0u;
+  frame_allocation_count_ = 0u;
+  frame_alias_count_ = 0u;
 }
 
 void RenderTargetCache::End() {
-  std::vector<RenderTargetData> retain;
-
-  for (RenderTargetData& td : render_target_data_) {
-    if (td.used_this_frame) {
-      retain.push_back(td);
-    } else if (td.keep_alive_frame_count > 0) {
-      td.keep_alive_frame_count--;
-      retain.push_back(td);
+  for (auto it = render_target_data_.begin();
+       it != render_target_data_.end();) {
+    std::vector<RenderTargetData> retain;
+    for (RenderTargetData& td : it->second) {
+      if (td.used_this_frame) {
+        retain.push_back(td);
+      } else if (td.keep_alive_frame_count > 0) {
+        td.keep_alive_frame_count--;
+        retain.push_back(td);
+      } else {
+        cached_byte_size_ -= td.byte_size;
+      }
+    }
+    if (retain.empty()) {
+      it = render_target_data_.erase(it);
+    } else {
+      it->second.swap(retain);
+      ++it;
     }
   }
-  render_target_data_.swap(retain);
+
+  FML_TRACE_COUNTER("impeller", "RenderTargetCache",
+                    reinterpret_cast<int64_t>(this),         // Trace Counter ID
+                    "FrameKB", frame_byte_size_ / 1024u,     //
+                    "CachedKB", cached_byte_size_ / 1024u,   //
+                    "Allocations", frame_allocation_count_,  //
+                    "Aliased", frame_alias_count_);
+}
+
+RenderTargetCache::RenderTargetData* RenderTargetCache::FindReusableTarget(
+    const RenderTargetKey& key) {
+  auto bucket = render_target_data_.find(key);
+  if (bucket == render_target_data_.end()) {
+    return nullptr;
+  }
+  RenderTargetData* result = nullptr;
+  for (RenderTargetData& render_target_data : bucket->second) {
+    if (!render_target_data.used_this_frame) {
+      result = &render_target_data;
+      frame_byte_size_ += result->byte_size;
+      break;
+    }
+  }
+  if (!result) {
+    for (RenderTargetData& render_target_data : bucket->second) {
+      if (render_target_data.IsIdle()) {
+        result = &render_target_data;
+        frame_alias_count_++;
+        break;
+      }
+    }
+  }
+  if (result) {
+    result->used_this_frame = true;
+    result->keep_alive_frame_count = keep_alive_frame_count_;
+  }
+  return result;
+}
+
+void RenderTargetCache::AddTarget(const RenderTargetKey& key,
+                                  const RenderTarget& target) {
+  ColorAttachment color0 = target.GetColorAttachment(0);
+  std::optional<DepthAttachment> depth = target.GetDepthAttachment();
+  RenderTargetData render_target_data{
+      .used_this_frame = true,                            //
+      .keep_alive_frame_count = keep_alive_frame_count_,  //
+      .byte_size = 0u,                                    //
+      .color_texture = color0.texture,                    //
+      .color_resolve_texture = color0.resolve_texture,    //
+      .depth_stencil_texture = depth ? depth->texture : nullptr,
+  };
+  render_target_data.byte_size =
+      GetTextureByteSize(render_target_data.color_texture) +
+      GetTextureByteSize(render_target_data.color_resolve_texture) +
+      GetTextureByteSize(render_target_data.depth_stencil_texture);
+
+  cached_byte_size_ += render_target_data.byte_size;
+  frame_byte_size_ += render_target_data.byte_size;
+  frame_allocation_count_++;
+  render_target_data_[key].push_back(std::move(render_target_data));
 }
 
 RenderTarget RenderTargetCache::CreateOffscreen(
@@ -48,26 +152,23 @@ RenderTarget RenderTargetCache::CreateOffscreen(
 
   FML_DCHECK(existing_color_texture == nullptr &&
              existing_depth_stencil_texture == nullptr);
-  auto config = RenderTargetConfig{
-      .size = size,
-      .mip_count = static_cast<size_t>(mip_count),
-      .has_msaa = false,
-      .has_depth_stencil = stencil_attachment_config.has_value(),
+  auto key = RenderTargetKey{
+      .config =
+          RenderTargetConfig{
+              .size = size,
+              .mip_count = static_cast<size_t>(mip_count),
+              .has_msaa = false,
+              .has_depth_stencil = stencil_attachment_config.has_value(),
+          },
+      .color_format = context.GetCapabilities()->GetDefaultColorFormat(),
+      .color_storage_mode = color_attachment_config.storage_mode,
+      .resolve_storage_mode = color_attachment_config.storage_mode,
   };
-  for (RenderTargetData& render_target_data : render_target_data_) {
-    const RenderTargetConfig other_config = render_target_data.config;
-    if (!render_target_data.used_this_frame && other_config == config) {
-      render_target_data.used_this_frame = true;
-      render_target_data.keep_alive_frame_count = keep_alive_frame_count_;
-      ColorAttachment color0 =
-          render_target_data.render_target.GetColorAttachment(0);
-      std::optional<DepthAttachment> depth =
-          render_target_data.render_target.GetDepthAttachment();
-      std::shared_ptr<Texture> depth_tex = depth ? depth->texture : nullptr;
-      return RenderTargetAllocator::CreateOffscreen(
-          context, size, mip_count, label, color_attachment_config,
-          stencil_attachment_config, color0.texture, depth_tex);
-    }
+  if (RenderTargetData* render_target_data = FindReusableTarget(key)) {
+    return RenderTargetAllocator::CreateOffscreen(
+        context, size, mip_count, label, color_attachment_config,
+        stencil_attachment_config, render_target_data->color_texture,
+        render_target_data->depth_stencil_texture);
   }
   RenderTarget created_target = RenderTargetAllocator::CreateOffscreen(
       context, size, mip_count, label, color_attachment_config,
@@ -75,12 +176,7 @@ RenderTarget RenderTargetCache::CreateOffscreen(
   if (!created_target.IsValid()) {
     return created_target;
   }
-  render_target_data_.push_back(RenderTargetData{
-      .used_this_frame = true,                            //
-      .keep_alive_frame_count = keep_alive_frame_count_,  //
-      .config = config,                                   //
-      .render_target = created_target                     //
-  });
+  AddTarget(key, created_target);
   return created_target;
 }
 
@@ -101,27 +197,24 @@ RenderTarget RenderTargetCache::CreateOffscreenMSAA(
   FML_DCHECK(existing_color_msaa_texture == nullptr &&
              existing_color_resolve_texture == nullptr &&
              existing_depth_stencil_texture == nullptr);
-  auto config = RenderTargetConfig{
-      .size = size,
-      .mip_count = static_cast<size_t>(mip_count),
-      .has_msaa = true,
-      .has_depth_stencil = stencil_attachment_config.has_value(),
+  auto key = RenderTargetKey{
+      .config =
+          RenderTargetConfig{
+              .size = size,
+              .mip_count = static_cast<size_t>(mip_count),
+              .has_msaa = true,
+              .has_depth_stencil = stencil_attachment_config.has_value(),
+          },
+      .color_format = context.GetCapabilities()->GetDefaultColorFormat(),
+      .color_storage_mode = color_attachment_config.storage_mode,
+      .resolve_storage_mode = color_attachment_config.resolve_storage_mode,
   };
-  for (RenderTargetData& render_target_data : render_target_data_) {
-    const RenderTargetConfig other_config = render_target_data.config;
-    if (!render_target_data.used_this_frame && other_config == config) {
-      render_target_data.used_this_frame = true;
-      render_target_data.keep_alive_frame_count = keep_alive_frame_count_;
-      ColorAttachment color0 =
-          render_target_data.render_target.GetColorAttachment(0);
-      std::optional<DepthAttachment> depth =
-          render_target_data.render_target.GetDepthAttachment();
-      std::shared_ptr<Texture> depth_tex = depth ? depth->texture : nullptr;
-      return RenderTargetAllocator::CreateOffscreenMSAA(
-          context, size, mip_count, label, color_attachment_config,
-          stencil_attachment_config, color0.texture, color0.resolve_texture,
-          depth_tex);
-    }
+  if (RenderTargetData* render_target_data = FindReusableTarget(key)) {
+    return RenderTargetAllocator::CreateOffscreenMSAA(
+        context, size, mip_count, label, color_attachment_config,
+        stencil_attachment_config, render_target_data->color_texture,
+        render_target_data->color_resolve_texture,
+        render_target_data->depth_stencil_texture);
   }
   RenderTarget created_target = RenderTargetAllocator::CreateOffscreenMSAA(
       context, size, mip_count, label, color_attachment_config,
@@ -129,17 +222,16 @@ RenderTarget RenderTargetCache::CreateOffscreenMSAA(
   if (!created_target.IsValid()) {
     return created_target;
   }
-  render_target_data_.push_back(RenderTargetData{
-      .used_this_frame = true,                            //
-      .keep_alive_frame_count = keep_alive_frame_count_,  //
-      .config = config,                                   //
-      .render_target = created_target                     //
-  });
+  AddTarget(key, created_target);
   return created_target;
 }
 
 size_t RenderTargetCache::CachedTextureCount() const {
-  return render_target_data_.size();
+  size_t count = 0u;
+  for (const auto& [key, bucket] : render_target_data_) {
+    count += bucket.size();
+  }
+  return count;
 }
 
 }  // namespace impeller
@@ -6,6 +6,9 @@
 #define FLUTTER_IMPELLER_ENTITY_RENDER_TARGET_CACHE_H_
 
 #include <string_view>
+#include <unordered_map>
+#include <vector>
+
 #include "impeller/renderer/render_target.h"
 
 namespace impeller {
@@ -13,6 +16,16 @@ namespace impeller {
 /// @brief An implementation of the [RenderTargetAllocator] that caches all
 ///        allocated texture data for one frame.
 ///
+///        Cached textures are bucketed by their size, mip count, sample
+///        count, pixel format and storage modes, so a lookup only visits
+///        textures that are compatible with the request.
+///
+///        A texture is handed out at most once per frame while something
+///        still refers to it. Once all of the render targets and commands
+///        that used a texture are gone, the texture may be handed out again
+///        in the same frame, so offscreens whose lifetimes do not overlap,
+///        like the passes of nested filters, share memory.
+///
 ///        Any textures unused after a frame are immediately discarded.
 class RenderTargetCache : public RenderTargetAllocator {
  public:
@@ -57,32 +70,66 @@ class RenderTargetCache : public RenderTargetAllocator {
   // visible for testing.
   size_t CachedTextureCount() const;
 
+  /// @brief The size in bytes of the distinct textures handed out since the
+  ///        last call to |Start|. Textures that were shared by offscreens
+  ///        with disjoint lifetimes are only counted once.
+  size_t GetFrameByteSize() const { return frame_byte_size_; }
+
  private:
+  struct RenderTargetKey {
+    RenderTargetConfig config;
+    PixelFormat color_format;
+    StorageMode color_storage_mode;
+    // Only meaningful if |config.has_msaa| is true.
+    StorageMode resolve_storage_mode;
+
+    constexpr bool operator==(const RenderTargetKey& o) const {
+      return config == o.config && color_format == o.color_format &&
+             color_storage_mode == o.color_storage_mode &&
+             resolve_storage_mode == o.resolve_storage_mode;
+    }
+
+    struct Hash {
+      constexpr std::size_t operator()(const RenderTargetKey& key) const {
+        return fml::HashCombine(key.config.Hash(), key.color_format,
+                                key.color_storage_mode,
+                                key.resolve_storage_mode);
+      }
+    };
+  };
+
   struct RenderTargetData {
     bool used_this_frame;
     uint32_t keep_alive_frame_count;
-    RenderTargetConfig config;
-    RenderTarget render_target;
+    size_t byte_size;
+    std::shared_ptr<Texture> color_texture;
+    std::shared_ptr<Texture> color_resolve_texture;
+    std::shared_ptr<Texture> depth_stencil_texture;
+
+    /// Whether the textures are only referenced by the cache.
+    bool IsIdle() const;
   };
 
-  std::vector<RenderTargetData> render_target_data_;
+  std::unordered_map<RenderTargetKey,
+                     std::vector<RenderTargetData>,
+                     RenderTargetKey::Hash>
+      render_target_data_;
   uint32_t keep_alive_frame_count_;
+  size_t cached_byte_size_ = 0u;
+  size_t frame_byte_size_ = 0u;
+  size_t frame_allocation_count_ = 0u;
+  size_t frame_alias_count_ = 0u;
+
+  /// Finds a cached entry for |key| that may be handed out, preferring the
+  /// entries that were not used in this frame over the ones whose earlier
+  /// users in this frame are done with them, and marks it as used.
+  RenderTargetData* FindReusableTarget(const RenderTargetKey& key);
+
+  void AddTarget(const RenderTargetKey& key, const RenderTarget& target);
 
   RenderTargetCache(const RenderTargetCache&) = delete;
 
   RenderTargetCache& operator=(const RenderTargetCache&) = delete;
-
- public:
-  /// Visible for testing.
-  std::vector<RenderTargetData>::const_iterator GetRenderTargetDataBegin()
-      const {
-    return render_target_data_.begin();
-  }
-
-  /// Visible for testing.
-  std::vector<RenderTargetData>::const_iterator GetRenderTargetDataEnd() const {
-    return render_target_data_.end();
-  }
 };
 
 }  // namespace impeller
@@ -54,10 +54,13 @@ TEST_P(RenderTargetCacheTest, CachesUsedTexturesAcrossFrames) {
       GetContext()->GetResourceAllocator(), /*keep_alive_frame_count=*/0);
 
   render_target_cache.Start();
-  // Create two render targets of the same exact size/shape. Both should be
-  // marked as used this frame, so the cached data set will contain two.
-  render_target_cache.CreateOffscreen(*GetContext(), {100, 100}, 1);
-  render_target_cache.CreateOffscreen(*GetContext(), {100, 100}, 1);
+  // Create two render targets of the same exact size/shape that are both in
+  // use. Both should be marked as used this frame, so the cached data set
+  // will contain two.
+  RenderTarget target1 =
+      render_target_cache.CreateOffscreen(*GetContext(), {100, 100}, 1);
+  RenderTarget target2 =
+      render_target_cache.CreateOffscreen(*GetContext(), {100, 100}, 1);
 
   EXPECT_EQ(render_target_cache.CachedTextureCount(), 2u);
 
@@ -78,10 +81,13 @@ TEST_P(RenderTargetCacheTest, CachesUsedTexturesAcrossFramesWithKeepAlive) {
       GetContext()->GetResourceAllocator(), /*keep_alive_frame_count=*/3);
 
   render_target_cache.Start();
-  // Create two render targets of the same exact size/shape. Both should be
-  // marked as used this frame, so the cached data set will contain two.
-  render_target_cache.CreateOffscreen(*GetContext(), {100, 100}, 1);
-  render_target_cache.CreateOffscreen(*GetContext(), {100, 100}, 1);
+  // Create two render targets of the same exact size/shape that are both in
+  // use. Both should be marked as used this frame, so the cached data set
+  // will contain two.
+  RenderTarget target1 =
+      render_target_cache.CreateOffscreen(*GetContext(), {100, 100}, 1);
+  RenderTarget target2 =
+      render_target_cache.CreateOffscreen(*GetContext(), {100, 100}, 1);
 
   EXPECT_EQ(render_target_cache.CachedTextureCount(), 2u);
 
@@ -103,6 +109,66 @@ TEST_P(RenderTargetCacheTest, CachesUsedTexturesAcrossFramesWithKeepAlive) {
   EXPECT_EQ(render_target_cache.CachedTextureCount(), 0u);
 }
 
+TEST_P(RenderTargetCacheTest, ReusesReleasedTexturesWithinFrame) {
+  auto render_target_cache = RenderTargetCache(
+      std::make_shared<TestAllocator>(), /*keep_alive_frame_count=*/0);
+
+  render_target_cache.Start();
+  std::shared_ptr<Texture> texture;
+  {
+    RenderTarget target1 =
+        render_target_cache.CreateOffscreen(*GetContext(), {100, 100}, 1);
+    texture = target1.GetRenderTargetTexture();
+  }
+  // The first texture is still referenced, so it cannot be handed out again.
+  RenderTarget target2 =
+      render_target_cache.CreateOffscreen(*GetContext(), {100, 100}, 1);
+  EXPECT_NE(target2.GetRenderTargetTexture(), texture);
+  EXPECT_EQ(render_target_cache.CachedTextureCount(), 2u);
+
+  // Once nothing refers to the first texture, it is shared by the next
+  // offscreen of the same shape.
+  const Texture* released_texture = texture.get();
+  texture.reset();
+  RenderTarget target3 =
+      render_target_cache.CreateOffscreen(*GetContext(), {100, 100}, 1);
+  EXPECT_EQ(target3.GetRenderTargetTexture().get(), released_texture);
+  EXPECT_EQ(render_target_cache.CachedTextureCount(), 2u);
+
+  size_t texture_size = target2.GetRenderTargetTexture()
+                            ->GetTextureDescriptor()
+                            .GetByteSizeOfAllMipLevels();
+  EXPECT_GE(render_target_cache.GetFrameByteSize(), 2 * texture_size);
+
+  render_target_cache.End();
+  EXPECT_EQ(render_target_cache.CachedTextureCount(), 2u);
+}
+
+TEST_P(RenderTargetCacheTest, BucketsTexturesByStorageMode) {
+  auto render_target_cache = RenderTargetCache(
+      std::make_shared<TestAllocator>(), /*keep_alive_frame_count=*/0);
+
+  render_target_cache.Start();
+  RenderTarget::AttachmentConfig color_attachment_config =
+      RenderTarget::kDefaultColorAttachmentConfig;
+  RenderTarget target1 = render_target_cache.CreateOffscreen(
+      *GetContext(), {100, 100}, 1, "Offscreen1", color_attachment_config);
+  render_target_cache.End();
+
+  render_target_cache.Start();
+  color_attachment_config.storage_mode = StorageMode::kHostVisible;
+  RenderTarget target2 = render_target_cache.CreateOffscreen(
+      *GetContext(), {100, 100}, 1, "Offscreen2", color_attachment_config);
+  render_target_cache.End();
+
+  // The texture of the first frame has a different storage mode and is not
+  // reused.
+  EXPECT_NE(target2.GetRenderTargetTexture(), target1.GetRenderTargetTexture());
+  EXPECT_EQ(target2.GetRenderTargetTexture()->GetTextureDescriptor()
+                .storage_mode,
+            StorageMode::kHostVisible);
+}
+
 TEST_P(RenderTargetCacheTest, DoesNotPersistFailedAllocations) {
   ScopedValidationDisable disable;
   auto allocator = std::make_shared<TestAllocator>();
@@ -7,6 +7,7 @@
 #include "impeller/entity/geometry/stroke_path_geometry.h"
 #include "impeller/geometry/path.h"
 #include "impeller/geometry/path_builder.h"
+#include "impeller/tessellator/tessellator.h"
 #include "impeller/tessellator/tessellator_libtess.h"
 
 namespace impeller {
@@ -33,6 +34,18 @@ Path CreateCubic(bool closed);
 Path CreateQuadratic(bool closed);
 /// Create a rounded rect.
 Path CreateRRect();
+
+enum class EllipticalShape {
+  kFilledCircle,
+  kStrokedCircle,
+  kRoundCapLine,
+  kFilledRoundRect,
+};
+
+Tessellator::EllipticalVertexGenerator CreateEllipticalGenerator(
+    Tessellator& tessellator,
+    EllipticalShape shape,
+    Scalar radius);
 }  // namespace
 
 static TessellatorLibtess tess;
@@ -114,6 +127,45 @@ static void BM_Convex(benchmark::State& state, Args&&... args) {
   state.counters["TotalPointCount"] = point_count;
 }
 
+/// Measures the per-vertex cost of the elliptical vertex generators when
+/// the vertices are delivered one at a time through the
+/// |TessellatedVertexProc| callback compared to when the single pass writers
+/// write them directly into a buffer.
+template <class... Args>
+static void BM_EllipticalVertices(benchmark::State& state, Args&&... args) {
+  auto args_tuple = std::make_tuple(std::move(args)...);
+  auto shape = std::get<EllipticalShape>(args_tuple);
+  auto radius = std::get<Scalar>(args_tuple);
+  auto bulk = std::get<bool>(args_tuple);
+
+  Tessellator tessellator;
+  auto generator = CreateEllipticalGenerator(tessellator, shape, radius);
+  std::vector<Point> vertices(generator.GetVertexCount());
+
+  size_t vertex_count = 0u;
+  while (state.KeepRunning()) {
+    if (bulk) {
+      vertex_count = generator.GenerateVerticesInto(vertices.data());
+    } else {
+      Point* output = vertices.data();
+      generator.GenerateVertices([&output](const Point& p) {  //
+        *output++ = p;
+      });
+      vertex_count = output - vertices.data();
+    }
+    benchmark::DoNotOptimize(vertices.data());
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * vertex_count);
+  state.counters["VertexCount"] = vertex_count;
+}
+
+#define MAKE_ELLIPTICAL_BENCHMARK_CAPTURE(shape, radius)                    \
+  BENCHMARK_CAPTURE(BM_EllipticalVertices, shape##_##radius##_callback,     \
+                    EllipticalShape::k##shape, Scalar(radius), false);      \
+  BENCHMARK_CAPTURE(BM_EllipticalVertices, shape##_##radius##_bulk,         \
+                    EllipticalShape::k##shape, Scalar(radius), true)
+
 #define MAKE_STROKE_BENCHMARK_CAPTURE(path, cap, join, closed)         \
   BENCHMARK_CAPTURE(BM_StrokePolyline, stroke_##path##_##cap##_##join, \
                     Create##path(closed), Cap::k##cap, Join::k##join)
@@ -141,8 +193,37 @@ MAKE_STROKE_BENCHMARK_CAPTURE(RRect, Butt, Bevel, );
 MAKE_STROKE_BENCHMARK_CAPTURE(RRect, Butt, Miter, );
 MAKE_STROKE_BENCHMARK_CAPTURE(RRect, Butt, Round, );
 
+MAKE_ELLIPTICAL_BENCHMARK_CAPTURE(FilledCircle, 10);
+MAKE_ELLIPTICAL_BENCHMARK_CAPTURE(FilledCircle, 500);
+MAKE_ELLIPTICAL_BENCHMARK_CAPTURE(StrokedCircle, 10);
+MAKE_ELLIPTICAL_BENCHMARK_CAPTURE(StrokedCircle, 500);
+MAKE_ELLIPTICAL_BENCHMARK_CAPTURE(RoundCapLine, 10);
+MAKE_ELLIPTICAL_BENCHMARK_CAPTURE(FilledRoundRect, 10);
+MAKE_ELLIPTICAL_BENCHMARK_CAPTURE(FilledRoundRect, 500);
+
 namespace {
 
+Tessellator::EllipticalVertexGenerator CreateEllipticalGenerator(
+    Tessellator& tessellator,
+    EllipticalShape shape,
+    Scalar radius) {
+  Matrix transform;
+  switch (shape) {
+    case EllipticalShape::kFilledCircle:
+      return tessellator.FilledCircle(transform, {0, 0}, radius);
+    case EllipticalShape::kStrokedCircle:
+      return tessellator.StrokedCircle(transform, {0, 0}, radius,
+                                       radius * 0.25f);
+    case EllipticalShape::kRoundCapLine:
+      return tessellator.RoundCapLine(transform, {0, 0}, {100, 100}, radius);
+    case EllipticalShape::kFilledRoundRect:
+      return tessellator.FilledRoundRect(
+          transform, Rect::MakeXYWH(0, 0, radius * 4, radius * 4),
+          Size(radius, radius));
+  }
+  FML_UNREACHABLE();
+}
+
 Path CreateRRect() {
   return PathBuilder{}
       .AddRoundRect(
@@ -59,6 +59,15 @@ bool Path::IsEmpty() const {
           data_->components[0] == ComponentType::kContour);
 }
 
+bool Path::operator==(const Path& other) const {
+  if (data_ == other.data_) {
+    return true;
+  }
+  return data_->fill == other.data_->fill &&
+         data_->components == other.data_->components &&
+         data_->points == other.data_->points;
+}
+
 bool Path::IsSingleContour() const {
   return data_->single_countour;
 }
@@ -170,6 +179,44 @@ void Path::WritePolyline(Scalar scale, VertexWriter& writer) const {
   }
 }
 
+void Path::EnumerateComponents(
+    const Applier<LinearPathComponent>& linear_applier,
+    const Applier<QuadraticPathComponent>& quad_applier,
+    const Applier<CubicPathComponent>& cubic_applier,
+    const Applier<ContourComponent>& contour_applier) const {
+  auto& points = data_->points;
+  size_t storage_offset = 0u;
+  for (const auto& component : data_->components) {
+    switch (component) {
+      case ComponentType::kLinear:
+        if (linear_applier) {
+          linear_applier(*reinterpret_cast<const LinearPathComponent*>(
+              &points[storage_offset]));
+        }
+        break;
+      case ComponentType::kQuadratic:
+        if (quad_applier) {
+          quad_applier(*reinterpret_cast<const QuadraticPathComponent*>(
+              &points[storage_offset]));
+        }
+        break;
+      case ComponentType::kCubic:
+        if (cubic_applier) {
+          cubic_applier(*reinterpret_cast<const CubicPathComponent*>(
+              &points[storage_offset]));
+        }
+        break;
+      case ComponentType::kContour:
+        if (contour_applier) {
+          contour_applier(ContourComponent(points[storage_offset],
+                                           points[storage_offset + 1]));
+        }
+        break;
+    }
+    storage_offset += VerbToOffset(component);
+  }
+}
+
 bool Path::GetLinearComponentAtIndex(size_t index,
                                      LinearPathComponent& linear) const {
   auto& components = data_->components;
@@ -154,9 +154,23 @@ class Path {
 
   bool IsEmpty() const;
 
+  /// @brief Whether the paths have the same fill type and components, which
+  ///        compares the contents of paths that do not share their data.
+  bool operator==(const Path& other) const;
+  bool operator!=(const Path& other) const { return !(*this == other); }
+
   /// @brief Whether the line contains a single contour.
   bool IsSingleContour() const;
 
+  /// @brief An opaque value that is shared by all copies of this path and
+  ///        that no other live path has.
+  ///
+  ///        Copies of a path share their underlying data, so this can be
+  ///        used to recognize the same path being drawn again without
+  ///        comparing its contents. The value may be reused by a new path
+  ///        once every copy of this one has been destroyed.
+  const void* GetIdentity() const { return data_.get(); }
+
   bool GetLinearComponentAtIndex(size_t index,
                                  LinearPathComponent& linear) const;
 
@@ -168,6 +182,21 @@ class Path {
   bool GetContourComponentAtIndex(size_t index,
                                   ContourComponent& contour) const;
 
+  template <class T>
+  using Applier = std::function<void(const T&)>;
+
+  /// @brief Visits every component of the path in order.
+  ///
+  ///        Unlike the |Get*ComponentAtIndex| accessors, which locate the
+  ///        storage of a component from the start of the path on every call,
+  ///        this walks the storage of the path once. Appliers may be empty
+  ///        to skip the components of that type.
+  void EnumerateComponents(
+      const Applier<LinearPathComponent>& linear_applier,
+      const Applier<QuadraticPathComponent>& quad_applier,
+      const Applier<CubicPathComponent>& cubic_applier,
+      const Applier<ContourComponent>& contour_applier) const;
+
   /// Callers must provide the scale factor for how this path will be
   /// transformed.
   ///
@@ -18,6 +18,7 @@ PathBuilder::~PathBuilder() = default;
 
 Path PathBuilder::CopyPath(FillType fill) {
   prototype_.fill = fill;
+  UpdateBounds();
   prototype_.single_countour =
       current_contour_location_ == 0u ||
       (contour_count_ == 2 &&
@@ -433,6 +433,24 @@ TEST(PathTest, PathBuilderWillComputeBounds) {
             Rect::MakeLTRB(0, 0, 100, 100));
 }
 
+TEST(PathTest, CopyPathWillComputeBounds) {
+  PathBuilder builder;
+  builder.AddLine({0, 0}, {1, 1});
+  auto path_1 = builder.CopyPath();
+
+  ASSERT_EQ(path_1.GetBoundingBox().value_or(Rect::MakeMaximum()),
+            Rect::MakeLTRB(0, 0, 1, 1));
+
+  builder.LineTo({-1, 2});
+  auto path_2 = builder.CopyPath();
+
+  // Copies made before the mutation keep their bounds.
+  ASSERT_EQ(path_1.GetBoundingBox().value_or(Rect::MakeMaximum()),
+            Rect::MakeLTRB(0, 0, 1, 1));
+  ASSERT_EQ(path_2.GetBoundingBox().value_or(Rect::MakeMaximum()),
+            Rect::MakeLTRB(-1, 0, 1, 2));
+}
+
 TEST(PathTest, PathHorizontalLine) {
   PathBuilder builder;
   auto path = builder.HorizontalLineTo(10).TakePath();
@@ -1017,5 +1035,54 @@ TEST(PathTest, PathBuilderDoesNotMutateCopiedPaths) {
       false, {23, 42}, "Shift");
 }
 
+TEST(PathTest, EnumerateComponentsVisitsComponentsInOrder) {
+  Path path = PathBuilder{}
+                  .MoveTo({10, 10})
+                  .LineTo({20, 10})
+                  .QuadraticCurveTo({30, 10}, {30, 20})
+                  .CubicCurveTo({30, 30}, {20, 30}, {10, 30})
+                  .Close()
+                  .MoveTo({50, 50})
+                  .LineTo({60, 60})
+                  .TakePath();
+
+  std::vector<std::string> visited;
+  path.EnumerateComponents(
+      [&visited](const LinearPathComponent& linear) {
+        visited.push_back("line to " + std::to_string(linear.p2.x));
+      },
+      [&visited](const QuadraticPathComponent& quad) {
+        EXPECT_EQ(quad.cp, Point(30, 10));
+        visited.push_back("quad to " + std::to_string(quad.p2.y));
+      },
+      [&visited](const CubicPathComponent& cubic) {
+        EXPECT_EQ(cubic.cp1, Point(30, 30));
+        EXPECT_EQ(cubic.cp2, Point(20, 30));
+        visited.push_back("cubic to " + std::to_string(cubic.p2.x));
+      },
+      [&visited](const ContourComponent& contour) {
+        visited.push_back(std::string(contour.IsClosed() ? "closed" : "open") +
+                          " contour at " +
+                          std::to_string(contour.destination.x));
+      });
+
+  std::vector<std::string> expected = {
+      "closed contour at " + std::to_string(10.0f),
+      "line to " + std::to_string(20.0f),
+      "quad to " + std::to_string(20.0f),
+      "cubic to " + std::to_string(10.0f),
+      "line to " + std::to_string(10.0f),
+      "open contour at " + std::to_string(50.0f),
+      "line to " + std::to_string(60.0f),
+  };
+  EXPECT_EQ(visited, expected);
+
+  size_t line_count = 0u;
+  path.EnumerateComponents(
+      [&line_count](const LinearPathComponent& linear) { line_count++; }, {},
+      {}, {});
+  EXPECT_EQ(line_count, 3u);
+}
+
 }  // namespace testing
 }  // namespace impeller
@@ -219,6 +219,7 @@ bool BufferBindingsGLES::BindVertexAttributes(const ProcTableGLES& gl,
 
 bool BufferBindingsGLES::BindUniformData(
     const ProcTableGLES& gl,
+    StateTrackerGLES& state,
     const std::vector<TextureAndSampler>& bound_textures,
     const std::vector<BufferResource>& bound_buffers,
     Range texture_range,
@@ -228,13 +229,13 @@ bool BufferBindingsGLES::BindUniformData(
       return false;
     }
   }
-  std::optional<size_t> next_unit_index =
-      BindTextures(gl, bound_textures, texture_range, ShaderStage::kVertex);
+  std::optional<size_t> next_unit_index = BindTextures(
+      gl, state, bound_textures, texture_range, ShaderStage::kVertex);
   if (!next_unit_index.has_value()) {
     return false;
   }
-  if (!BindTextures(gl, bound_textures, texture_range, ShaderStage::kFragment,
-                    *next_unit_index)
+  if (!BindTextures(gl, state, bound_textures, texture_range,
+                    ShaderStage::kFragment, *next_unit_index)
            .has_value()) {
     return false;
   }
@@ -444,6 +445,7 @@ bool BufferBindingsGLES::BindUniformBufferV2(
 
 std::optional<size_t> BufferBindingsGLES::BindTextures(
     const ProcTableGLES& gl,
+    StateTrackerGLES& state,
     const std::vector<TextureAndSampler>& bound_textures,
     Range texture_range,
     ShaderStage stage,
@@ -473,7 +475,7 @@ std::optional<size_t> BufferBindingsGLES::BindTextures(
                         "this shader stage.";
       return std::nullopt;
     }
-    gl.ActiveTexture(GL_TEXTURE0 + active_index);
+    state.ActiveTexture(GL_TEXTURE0 + active_index);
 
     //--------------------------------------------------------------------------
     /// Bind the texture.
@@ -13,6 +13,7 @@
 #include "impeller/renderer/backend/gles/device_buffer_gles.h"
 #include "impeller/renderer/backend/gles/gles.h"
 #include "impeller/renderer/backend/gles/proc_table_gles.h"
+#include "impeller/renderer/backend/gles/state_tracker_gles.h"
 #include "impeller/renderer/command.h"
 
 namespace impeller {
@@ -43,6 +44,7 @@ class BufferBindingsGLES {
                             size_t vertex_offset);
 
   bool BindUniformData(const ProcTableGLES& gl,
+                       StateTrackerGLES& state,
                        const std::vector<TextureAndSampler>& bound_textures,
                        const std::vector<BufferResource>& bound_buffers,
                        Range texture_range,
@@ -97,6 +99,7 @@ class BufferBindingsGLES {
 
   std::optional<size_t> BindTextures(
       const ProcTableGLES& gl,
+      StateTrackerGLES& state,
       const std::vector<TextureAndSampler>& bound_textures,
       Range texture_range,
       ShaderStage stage,
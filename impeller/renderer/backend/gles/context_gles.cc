@@ -157,7 +157,7 @@ void ContextGLES::ResetThreadLocalState() const {
   }
   [[maybe_unused]] auto result =
       reactor_->AddOperation([](const ReactorGLES& reactor) {
-        RenderPassGLES::ResetGLState(reactor.GetProcTable());
+        RenderPassGLES::ResetGLState(reactor.GetStateTracker());
       });
 }
 
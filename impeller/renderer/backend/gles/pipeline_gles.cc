@@ -57,7 +57,7 @@ bool PipelineGLES::BuildVertexDescriptor(const ProcTableGLES& gl,
   return true;
 }
 
-[[nodiscard]] bool PipelineGLES::BindProgram() const {
+[[nodiscard]] bool PipelineGLES::BindProgram(StateTrackerGLES& state) const {
   if (!handle_->IsValid()) {
     return false;
   }
@@ -65,14 +65,12 @@ bool PipelineGLES::BuildVertexDescriptor(const ProcTableGLES& gl,
   if (!handle.has_value()) {
     return false;
   }
-  reactor_->GetProcTable().UseProgram(handle.value());
+  state.UseProgram(handle.value());
   return true;
 }
 
-[[nodiscard]] bool PipelineGLES::UnbindProgram() const {
-  if (reactor_) {
-    reactor_->GetProcTable().UseProgram(0u);
-  }
+[[nodiscard]] bool PipelineGLES::UnbindProgram(StateTrackerGLES& state) const {
+  state.UseProgram(0u);
   return true;
 }
 
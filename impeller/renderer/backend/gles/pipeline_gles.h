@@ -26,9 +26,9 @@ class PipelineGLES final
 
   const std::shared_ptr<UniqueHandleGLES> GetSharedHandle() const;
 
-  [[nodiscard]] bool BindProgram() const;
+  [[nodiscard]] bool BindProgram(StateTrackerGLES& state) const;
 
-  [[nodiscard]] bool UnbindProgram() const;
+  [[nodiscard]] bool UnbindProgram(StateTrackerGLES& state) const;
 
   BufferBindingsGLES* GetBufferBindings() const;
 
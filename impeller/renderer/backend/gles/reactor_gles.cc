@@ -124,6 +124,17 @@ const ProcTableGLES& ReactorGLES::GetProcTable() const {
   return *proc_table_;
 }
 
+StateTrackerGLES& ReactorGLES::GetStateTracker() const {
+  FML_DCHECK(IsValid());
+  Lock lock(state_trackers_mutex_);
+  std::unique_ptr<StateTrackerGLES>& tracker =
+      state_trackers_[std::this_thread::get_id()];
+  if (!tracker) {
+    tracker = std::make_unique<StateTrackerGLES>(*proc_table_);
+  }
+  return *tracker;
+}
+
 std::optional<ReactorGLES::GLStorage> ReactorGLES::GetHandle(
     const HandleGLES& handle) const {
   if (handle.untracked_id_.has_value()) {
@@ -14,6 +14,7 @@
 #include "impeller/base/thread.h"
 #include "impeller/renderer/backend/gles/handle_gles.h"
 #include "impeller/renderer/backend/gles/proc_table_gles.h"
+#include "impeller/renderer/backend/gles/state_tracker_gles.h"
 
 namespace impeller {
 
@@ -138,6 +139,19 @@ class ReactorGLES {
   ///
   const ProcTableGLES& GetProcTable() const;
 
+  //----------------------------------------------------------------------------
+  /// @brief      Get the tracker that shadows the state of the OpenGL context
+  ///             that is current on the calling thread. Each thread the
+  ///             reactor reacts on gets its own tracker.
+  ///
+  ///             This is only safe to use within a reaction. The state must be
+  ///             invalidated at the start of each reaction that relies on it
+  ///             since the context may have been used outside the reactor.
+  ///
+  /// @return     The state tracker for the calling thread.
+  ///
+  StateTrackerGLES& GetStateTracker() const;
+
   //----------------------------------------------------------------------------
   /// @brief      Returns the OpenGL handle for a reactor handle if one is
   ///             available. This is typically only safe to call within a
@@ -295,6 +309,10 @@ class ReactorGLES {
   LiveHandles handles_ IPLR_GUARDED_BY(handles_mutex_);
   int32_t handles_to_collect_count_ IPLR_GUARDED_BY(handles_mutex_) = 0;
 
+  mutable Mutex state_trackers_mutex_;
+  mutable std::map<std::thread::id, std::unique_ptr<StateTrackerGLES>>
+      state_trackers_ IPLR_GUARDED_BY(state_trackers_mutex_);
+
   mutable Mutex workers_mutex_;
   mutable std::map<WorkerID, std::weak_ptr<Worker>> workers_ IPLR_GUARDED_BY(
       workers_mutex_);
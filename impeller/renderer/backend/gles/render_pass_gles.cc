@@ -43,22 +43,22 @@ void RenderPassGLES::OnSetLabel(std::string_view label) {
   label_ = label;
 }
 
-void ConfigureBlending(const ProcTableGLES& gl,
+void ConfigureBlending(StateTrackerGLES& state,
                        const ColorAttachmentDescriptor* color) {
   if (color->blending_enabled) {
-    gl.Enable(GL_BLEND);
-    gl.BlendFuncSeparate(
+    state.SetCapability(GL_BLEND, true);
+    state.BlendFuncSeparate(
         ToBlendFactor(color->src_color_blend_factor),  // src color
         ToBlendFactor(color->dst_color_blend_factor),  // dst color
         ToBlendFactor(color->src_alpha_blend_factor),  // src alpha
         ToBlendFactor(color->dst_alpha_blend_factor)   // dst alpha
     );
-    gl.BlendEquationSeparate(
+    state.BlendEquationSeparate(
         ToBlendOperation(color->color_blend_op),  // mode color
         ToBlendOperation(color->alpha_blend_op)   // mode alpha
     );
   } else {
-    gl.Disable(GL_BLEND);
+    state.SetCapability(GL_BLEND, false);
   }
 
   {
@@ -67,7 +67,7 @@ void ConfigureBlending(const ProcTableGLES& gl,
       return (mask & check) ? GL_TRUE : GL_FALSE;
     };
 
-    gl.ColorMask(
+    state.ColorMask(
         is_set(color->write_mask, ColorWriteMaskBits::kRed),    // red
         is_set(color->write_mask, ColorWriteMaskBits::kGreen),  // green
         is_set(color->write_mask, ColorWriteMaskBits::kBlue),   // blue
@@ -77,44 +77,45 @@ void ConfigureBlending(const ProcTableGLES& gl,
 }
 
 void ConfigureStencil(GLenum face,
-                      const ProcTableGLES& gl,
+                      StateTrackerGLES& state,
                       const StencilAttachmentDescriptor& stencil,
                       uint32_t stencil_reference) {
-  gl.StencilOpSeparate(
+  state.StencilOpSeparate(
       face,                                    // face
       ToStencilOp(stencil.stencil_failure),    // stencil fail
       ToStencilOp(stencil.depth_failure),      // depth fail
       ToStencilOp(stencil.depth_stencil_pass)  // depth stencil pass
   );
-  gl.StencilFuncSeparate(face,                                        // face
-                         ToCompareFunction(stencil.stencil_compare),  // func
-                         stencil_reference,                           // ref
-                         stencil.read_mask                            // mask
+  state.StencilFuncSeparate(
+      face,                                        // face
+      ToCompareFunction(stencil.stencil_compare),  // func
+      stencil_reference,                           // ref
+      stencil.read_mask                            // mask
   );
-  gl.StencilMaskSeparate(face, stencil.write_mask);
+  state.StencilMaskSeparate(face, stencil.write_mask);
 }
 
-void ConfigureStencil(const ProcTableGLES& gl,
+void ConfigureStencil(StateTrackerGLES& state,
                       const PipelineDescriptor& pipeline,
                       uint32_t stencil_reference) {
   if (!pipeline.HasStencilAttachmentDescriptors()) {
-    gl.Disable(GL_STENCIL_TEST);
+    state.SetCapability(GL_STENCIL_TEST, false);
     return;
   }
 
-  gl.Enable(GL_STENCIL_TEST);
+  state.SetCapability(GL_STENCIL_TEST, true);
   const auto& front = pipeline.GetFrontStencilAttachmentDescriptor();
   const auto& back = pipeline.GetBackStencilAttachmentDescriptor();
 
   if (front.has_value() && back.has_value() && front == back) {
-    ConfigureStencil(GL_FRONT_AND_BACK, gl, *front, stencil_reference);
+    ConfigureStencil(GL_FRONT_AND_BACK, state, *front, stencil_reference);
     return;
   }
   if (front.has_value()) {
-    ConfigureStencil(GL_FRONT, gl, *front, stencil_reference);
+    ConfigureStencil(GL_FRONT, state, *front, stencil_reference);
   }
   if (back.has_value()) {
-    ConfigureStencil(GL_BACK, gl, *back, stencil_reference);
+    ConfigureStencil(GL_BACK, state, *back, stencil_reference);
   }
 }
 
@@ -175,17 +176,20 @@ static bool BindVertexBuffer(const ProcTableGLES& gl,
   return true;
 }
 
-void RenderPassGLES::ResetGLState(const ProcTableGLES& gl) {
-  gl.Disable(GL_SCISSOR_TEST);
-  gl.Disable(GL_DEPTH_TEST);
-  gl.Disable(GL_STENCIL_TEST);
-  gl.Disable(GL_CULL_FACE);
-  gl.Disable(GL_BLEND);
-  gl.Disable(GL_DITHER);
-  gl.ColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
-  gl.DepthMask(GL_TRUE);
-  gl.StencilMaskSeparate(GL_FRONT, 0xFFFFFFFF);
-  gl.StencilMaskSeparate(GL_BACK, 0xFFFFFFFF);
+void RenderPassGLES::ResetGLState(StateTrackerGLES& state) {
+  // The context may have been used outside of Impeller since the state was
+  // last tracked.
+  state.Invalidate();
+  state.SetCapability(GL_SCISSOR_TEST, false);
+  state.SetCapability(GL_DEPTH_TEST, false);
+  state.SetCapability(GL_STENCIL_TEST, false);
+  state.SetCapability(GL_CULL_FACE, false);
+  state.SetCapability(GL_BLEND, false);
+  state.SetCapability(GL_DITHER, false);
+  state.ColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+  state.DepthMask(GL_TRUE);
+  state.StencilMaskSeparate(GL_FRONT, 0xFFFFFFFF);
+  state.StencilMaskSeparate(GL_BACK, 0xFFFFFFFF);
 }
 
 [[nodiscard]] bool EncodeCommandsInReactor(
@@ -199,6 +203,7 @@ void RenderPassGLES::ResetGLState(const ProcTableGLES& gl) {
   TRACE_EVENT0("impeller", "RenderPassGLES::EncodeCommandsInReactor");
 
   const auto& gl = reactor.GetProcTable();
+  StateTrackerGLES& state = reactor.GetStateTracker();
 #ifdef IMPELLER_DEBUG
   tracer->MarkFrameStart(gl);
 
@@ -286,7 +291,7 @@ void RenderPassGLES::ResetGLState(const ProcTableGLES& gl) {
     clear_bits |= GL_STENCIL_BUFFER_BIT;
   }
 
-  RenderPassGLES::ResetGLState(gl);
+  RenderPassGLES::ResetGLState(state);
 
   gl.Clear(clear_bits);
 
@@ -299,11 +304,11 @@ void RenderPassGLES::ResetGLState(const ProcTableGLES& gl) {
   /// Setup the viewport.
   ///
   const auto& viewport = pass_data.viewport;
-  gl.Viewport(viewport.rect.GetX(),  // x
-              target_size.height - viewport.rect.GetY() -
-                  viewport.rect.GetHeight(),  // y
-              viewport.rect.GetWidth(),       // width
-              viewport.rect.GetHeight()       // height
+  state.Viewport(viewport.rect.GetX(),  // x
+                 target_size.height - viewport.rect.GetY() -
+                     viewport.rect.GetHeight(),  // y
+                 viewport.rect.GetWidth(),       // width
+                 viewport.rect.GetHeight()       // height
   );
   if (pass_data.depth_attachment) {
     if (gl.DepthRangef.IsAvailable()) {
@@ -313,9 +318,7 @@ void RenderPassGLES::ResetGLState(const ProcTableGLES& gl) {
     }
   }
 
-  CullMode current_cull_mode = CullMode::kNone;
-  WindingOrder current_winding_order = WindingOrder::kClockwise;
-  gl.FrontFace(GL_CW);
+  state.FrontFace(GL_CW);
 
   for (const auto& command : commands) {
 #ifdef IMPELLER_DEBUG
@@ -341,12 +344,13 @@ void RenderPassGLES::ResetGLState(const ProcTableGLES& gl) {
     //--------------------------------------------------------------------------
     /// Configure blending.
     ///
-    ConfigureBlending(gl, color_attachment);
+    ConfigureBlending(state, color_attachment);
 
     //--------------------------------------------------------------------------
     /// Setup stencil.
     ///
-    ConfigureStencil(gl, pipeline.GetDescriptor(), command.stencil_reference);
+    ConfigureStencil(state, pipeline.GetDescriptor(),
+                     command.stencil_reference);
 
     //--------------------------------------------------------------------------
     /// Configure depth.
@@ -354,22 +358,22 @@ void RenderPassGLES::ResetGLState(const ProcTableGLES& gl) {
     if (auto depth =
             pipeline.GetDescriptor().GetDepthStencilAttachmentDescriptor();
         depth.has_value()) {
-      gl.Enable(GL_DEPTH_TEST);
-      gl.DepthFunc(ToCompareFunction(depth->depth_compare));
-      gl.DepthMask(depth->depth_write_enabled ? GL_TRUE : GL_FALSE);
+      state.SetCapability(GL_DEPTH_TEST, true);
+      state.DepthFunc(ToCompareFunction(depth->depth_compare));
+      state.DepthMask(depth->depth_write_enabled ? GL_TRUE : GL_FALSE);
     } else {
-      gl.Disable(GL_DEPTH_TEST);
+      state.SetCapability(GL_DEPTH_TEST, false);
     }
 
     //--------------------------------------------------------------------------
     /// Setup the viewport.
     ///
     if (command.viewport.has_value()) {
-      gl.Viewport(viewport.rect.GetX(),  // x
-                  target_size.height - viewport.rect.GetY() -
-                      viewport.rect.GetHeight(),  // y
-                  viewport.rect.GetWidth(),       // width
-                  viewport.rect.GetHeight()       // height
+      state.Viewport(viewport.rect.GetX(),  // x
+                     target_size.height - viewport.rect.GetY() -
+                         viewport.rect.GetHeight(),  // y
+                     viewport.rect.GetWidth(),       // width
+                     viewport.rect.GetHeight()       // height
       );
       if (pass_data.depth_attachment) {
         if (gl.DepthRangef.IsAvailable()) {
@@ -387,8 +391,8 @@ void RenderPassGLES::ResetGLState(const ProcTableGLES& gl) {
     ///
     if (command.scissor.has_value()) {
       const auto& scissor = command.scissor.value();
-      gl.Enable(GL_SCISSOR_TEST);
-      gl.Scissor(
+      state.SetCapability(GL_SCISSOR_TEST, true);
+      state.Scissor(
           scissor.GetX(),                                             // x
           target_size.height - scissor.GetY() - scissor.GetHeight(),  // y
           scissor.GetWidth(),                                         // width
@@ -399,39 +403,30 @@ void RenderPassGLES::ResetGLState(const ProcTableGLES& gl) {
     //--------------------------------------------------------------------------
     /// Setup culling.
     ///
-    CullMode pipeline_cull_mode = pipeline.GetDescriptor().GetCullMode();
-    if (current_cull_mode != pipeline_cull_mode) {
-      switch (pipeline_cull_mode) {
-        case CullMode::kNone:
-          gl.Disable(GL_CULL_FACE);
-          break;
-        case CullMode::kFrontFace:
-          gl.Enable(GL_CULL_FACE);
-          gl.CullFace(GL_FRONT);
-          break;
-        case CullMode::kBackFace:
-          gl.Enable(GL_CULL_FACE);
-          gl.CullFace(GL_BACK);
-          break;
-      }
-      current_cull_mode = pipeline_cull_mode;
+    switch (pipeline.GetDescriptor().GetCullMode()) {
+      case CullMode::kNone:
+        state.SetCapability(GL_CULL_FACE, false);
+        break;
+      case CullMode::kFrontFace:
+        state.SetCapability(GL_CULL_FACE, true);
+        state.CullFace(GL_FRONT);
+        break;
+      case CullMode::kBackFace:
+        state.SetCapability(GL_CULL_FACE, true);
+        state.CullFace(GL_BACK);
+        break;
     }
 
     //--------------------------------------------------------------------------
     /// Setup winding order.
     ///
-    WindingOrder pipeline_winding_order =
-        pipeline.GetDescriptor().GetWindingOrder();
-    if (current_winding_order != pipeline_winding_order) {
-      switch (pipeline.GetDescriptor().GetWindingOrder()) {
-        case WindingOrder::kClockwise:
-          gl.FrontFace(GL_CW);
-          break;
-        case WindingOrder::kCounterClockwise:
-          gl.FrontFace(GL_CCW);
-          break;
-      }
-      current_winding_order = pipeline_winding_order;
+    switch (pipeline.GetDescriptor().GetWindingOrder()) {
+      case WindingOrder::kClockwise:
+        state.FrontFace(GL_CW);
+        break;
+      case WindingOrder::kCounterClockwise:
+        state.FrontFace(GL_CCW);
+        break;
     }
 
     BufferBindingsGLES* vertex_desc_gles = pipeline.GetBufferBindings();
@@ -454,7 +449,7 @@ void RenderPassGLES::ResetGLState(const ProcTableGLES& gl) {
     //--------------------------------------------------------------------------
     /// Bind the pipeline program.
     ///
-    if (!pipeline.BindProgram()) {
+    if (!pipeline.BindProgram(state)) {
       return false;
     }
 
@@ -463,6 +458,7 @@ void RenderPassGLES::ResetGLState(const ProcTableGLES& gl) {
     ///
     if (!vertex_desc_gles->BindUniformData(
             gl,                                        //
+            state,                                     //
             bound_textures,                            //
             bound_buffers,                             //
             /*texture_range=*/command.bound_textures,  //
@@ -19,7 +19,11 @@ class RenderPassGLES final
   // |RenderPass|
   ~RenderPassGLES() override;
 
-  static void ResetGLState(const ProcTableGLES& gl);
+  //----------------------------------------------------------------------------
+  /// @brief      Forget the tracked state of the context and put it in the
+  ///             state that render passes start from.
+  ///
+  static void ResetGLState(StateTrackerGLES& state);
 
  private:
   friend class CommandBufferGLES;
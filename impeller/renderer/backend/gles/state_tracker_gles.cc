@@ -0,0 +1,211 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "impeller/renderer/backend/gles/state_tracker_gles.h"
+
+namespace impeller {
+
+StateTrackerGLES::StateTrackerGLES(const ProcTableGLES& gl) : gl_(gl) {}
+
+StateTrackerGLES::~StateTrackerGLES() = default;
+
+void StateTrackerGLES::Invalidate() {
+  capabilities_ = {};
+  blend_func_.reset();
+  blend_equation_.reset();
+  color_mask_.reset();
+  depth_func_.reset();
+  depth_mask_.reset();
+  front_stencil_ = {};
+  back_stencil_ = {};
+  viewport_.reset();
+  scissor_.reset();
+  cull_face_.reset();
+  front_face_.reset();
+  program_.reset();
+  active_texture_.reset();
+}
+
+// static
+std::optional<StateTrackerGLES::Capability> StateTrackerGLES::ToCapability(
+    GLenum capability) {
+  switch (capability) {
+    case GL_BLEND:
+      return kBlend;
+    case GL_CULL_FACE:
+      return kCullFace;
+    case GL_DEPTH_TEST:
+      return kDepthTest;
+    case GL_DITHER:
+      return kDither;
+    case GL_SCISSOR_TEST:
+      return kScissorTest;
+    case GL_STENCIL_TEST:
+      return kStencilTest;
+    default:
+      return std::nullopt;
+  }
+}
+
+template <class T>
+bool StateTrackerGLES::Update(std::optional<T>& state, const T& value) {
+  if (state == value) {
+    stats_.elided_calls++;
+    return false;
+  }
+  state = value;
+  stats_.issued_calls++;
+  return true;
+}
+
+template <class T>
+bool StateTrackerGLES::UpdateStencil(GLenum face,
+                                     std::optional<T> StencilState::*state,
+                                     const T& value) {
+  std::optional<T>& front = front_stencil_.*state;
+  std::optional<T>& back = back_stencil_.*state;
+  switch (face) {
+    case GL_FRONT:
+      return Update(front, value);
+    case GL_BACK:
+      return Update(back, value);
+    case GL_FRONT_AND_BACK:
+      if (front == value && back == value) {
+        stats_.elided_calls++;
+        return false;
+      }
+      front = value;
+      back = value;
+      stats_.issued_calls++;
+      return true;
+    default:
+      stats_.issued_calls++;
+      return true;
+  }
+}
+
+void StateTrackerGLES::SetCapability(GLenum capability, bool enabled) {
+  std::optional<Capability> tracked = ToCapability(capability);
+  if (tracked.has_value()) {
+    if (!Update(capabilities_[*tracked], enabled)) {
+      return;
+    }
+  } else {
+    stats_.issued_calls++;
+  }
+  if (enabled) {
+    gl_.Enable(capability);
+  } else {
+    gl_.Disable(capability);
+  }
+}
+
+void StateTrackerGLES::BlendFuncSeparate(GLenum src_color,
+                                         GLenum dst_color,
+                                         GLenum src_alpha,
+                                         GLenum dst_alpha) {
+  if (Update(blend_func_, {src_color, dst_color, src_alpha, dst_alpha})) {
+    gl_.BlendFuncSeparate(src_color, dst_color, src_alpha, dst_alpha);
+  }
+}
+
+void StateTrackerGLES::BlendEquationSeparate(GLenum mode_color,
+                                             GLenum mode_alpha) {
+  if (Update(blend_equation_, {mode_color, mode_alpha})) {
+    gl_.BlendEquationSeparate(mode_color, mode_alpha);
+  }
+}
+
+void StateTrackerGLES::ColorMask(GLboolean red,
+                                 GLboolean green,
+                                 GLboolean blue,
+                                 GLboolean alpha) {
+  if (Update(color_mask_, {red, green, blue, alpha})) {
+    gl_.ColorMask(red, green, blue, alpha);
+  }
+}
+
+void StateTrackerGLES::DepthFunc(GLenum func) {
+  if (Update(depth_func_, func)) {
+    gl_.DepthFunc(func);
+  }
+}
+
+void StateTrackerGLES::DepthMask(GLboolean flag) {
+  if (Update(depth_mask_, flag)) {
+    gl_.DepthMask(flag);
+  }
+}
+
+void StateTrackerGLES::StencilOpSeparate(GLenum face,
+                                         GLenum stencil_fail,
+                                         GLenum depth_fail,
+                                         GLenum depth_stencil_pass) {
+  if (UpdateStencil<std::array<GLenum, 3>>(
+          face, &StencilState::op,
+          {stencil_fail, depth_fail, depth_stencil_pass})) {
+    gl_.StencilOpSeparate(face, stencil_fail, depth_fail, depth_stencil_pass);
+  }
+}
+
+void StateTrackerGLES::StencilFuncSeparate(GLenum face,
+                                           GLenum func,
+                                           GLint ref,
+                                           GLuint mask) {
+  if (UpdateStencil<std::array<GLuint, 3>>(
+          face, &StencilState::func,
+          {func, static_cast<GLuint>(ref), mask})) {
+    gl_.StencilFuncSeparate(face, func, ref, mask);
+  }
+}
+
+void StateTrackerGLES::StencilMaskSeparate(GLenum face, GLuint mask) {
+  if (UpdateStencil<GLuint>(face, &StencilState::write_mask, mask)) {
+    gl_.StencilMaskSeparate(face, mask);
+  }
+}
+
+void StateTrackerGLES::Viewport(GLint x,
+                                GLint y,
+                                GLsizei width,
+                                GLsizei height) {
+  if (Update(viewport_, {x, y, width, height})) {
+    gl_.Viewport(x, y, width, height);
+  }
+}
+
+void StateTrackerGLES::Scissor(GLint x,
+                               GLint y,
+                               GLsizei width,
+                               GLsizei height) {
+  if (Update(scissor_, {x, y, width, height})) {
+    gl_.Scissor(x, y, width, height);
+  }
+}
+
+void StateTrackerGLES::CullFace(GLenum mode) {
+  if (Update(cull_face_, mode)) {
+    gl_.CullFace(mode);
+  }
+}
+
+void StateTrackerGLES::FrontFace(GLenum mode) {
+  if (Update(front_face_, mode)) {
+    gl_.FrontFace(mode);
+  }
+}
+
+void StateTrackerGLES::UseProgram(GLuint program) {
+  if (Update(program_, program)) {
+    gl_.UseProgram(program);
+  }
+}
+
+void StateTrackerGLES::ActiveTexture(GLenum texture_unit) {
+  if (Update(active_texture_, texture_unit)) {
+    gl_.ActiveTexture(texture_unit);
+  }
+}
+
+}  // namespace impeller
@@ -0,0 +1,160 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_IMPELLER_RENDERER_BACKEND_GLES_STATE_TRACKER_GLES_H_
+#define FLUTTER_IMPELLER_RENDERER_BACKEND_GLES_STATE_TRACKER_GLES_H_
+
+#include <array>
+#include <cstddef>
+#include <optional>
+
+#include "impeller/renderer/backend/gles/proc_table_gles.h"
+
+namespace impeller {
+
+//------------------------------------------------------------------------------
+/// @brief      Shadows the fixed function and binding state of an OpenGL
+///             context so that calls that would not change that state can be
+///             skipped.
+///
+///             Each of the setters forwards to the GL call of the same name
+///             unless the tracker knows that the context is already in the
+///             requested state. State is unknown until it is first set after
+///             construction or a call to |Invalidate|.
+///
+///             The tracker only sees the calls that are made through it. Any
+///             code that changes the same state by calling the proc table
+///             directly, and any code outside of Impeller that shares the
+///             context, must be followed by a call to |Invalidate|.
+///
+///             Trackers are not thread safe. The reactor hands out one per
+///             thread it reacts on, see |ReactorGLES::GetStateTracker|.
+///
+class StateTrackerGLES {
+ public:
+  struct Stats {
+    /// The number of calls that were forwarded to GL.
+    size_t issued_calls = 0u;
+    /// The number of calls that were skipped because they would not have
+    /// changed the state of the context.
+    size_t elided_calls = 0u;
+  };
+
+  explicit StateTrackerGLES(const ProcTableGLES& gl);
+
+  ~StateTrackerGLES();
+
+  const ProcTableGLES& GetProcTable() const { return gl_; }
+
+  //----------------------------------------------------------------------------
+  /// @brief      Forget all of the shadowed state. The next call to each of
+  ///             the setters is always forwarded to GL.
+  ///
+  void Invalidate();
+
+  const Stats& GetStats() const { return stats_; }
+
+  void ResetStats() { stats_ = {}; }
+
+  //----------------------------------------------------------------------------
+  /// @brief      glEnable or glDisable. Only the capabilities used by the
+  ///             render pass are tracked, others are always forwarded.
+  ///
+  void SetCapability(GLenum capability, bool enabled);
+
+  void BlendFuncSeparate(GLenum src_color,
+                         GLenum dst_color,
+                         GLenum src_alpha,
+                         GLenum dst_alpha);
+
+  void BlendEquationSeparate(GLenum mode_color, GLenum mode_alpha);
+
+  void ColorMask(GLboolean red,
+                 GLboolean green,
+                 GLboolean blue,
+                 GLboolean alpha);
+
+  void DepthFunc(GLenum func);
+
+  void DepthMask(GLboolean flag);
+
+  void StencilOpSeparate(GLenum face,
+                         GLenum stencil_fail,
+                         GLenum depth_fail,
+                         GLenum depth_stencil_pass);
+
+  void StencilFuncSeparate(GLenum face, GLenum func, GLint ref, GLuint mask);
+
+  void StencilMaskSeparate(GLenum face, GLuint mask);
+
+  void Viewport(GLint x, GLint y, GLsizei width, GLsizei height);
+
+  void Scissor(GLint x, GLint y, GLsizei width, GLsizei height);
+
+  void CullFace(GLenum mode);
+
+  void FrontFace(GLenum mode);
+
+  void UseProgram(GLuint program);
+
+  void ActiveTexture(GLenum texture_unit);
+
+ private:
+  enum Capability : size_t {
+    kBlend,
+    kCullFace,
+    kDepthTest,
+    kDither,
+    kScissorTest,
+    kStencilTest,
+    kCapabilityCount,
+  };
+
+  // Per face stencil state. Each array holds the arguments of the GL call
+  // that follow the face.
+  struct StencilState {
+    std::optional<std::array<GLenum, 3>> op;
+    std::optional<std::array<GLuint, 3>> func;
+    std::optional<GLuint> write_mask;
+  };
+
+  const ProcTableGLES& gl_;
+  Stats stats_;
+
+  std::array<std::optional<bool>, kCapabilityCount> capabilities_;
+  std::optional<std::array<GLenum, 4>> blend_func_;
+  std::optional<std::array<GLenum, 2>> blend_equation_;
+  std::optional<std::array<GLboolean, 4>> color_mask_;
+  std::optional<GLenum> depth_func_;
+  std::optional<GLboolean> depth_mask_;
+  StencilState front_stencil_;
+  StencilState back_stencil_;
+  std::optional<std::array<GLint, 4>> viewport_;
+  std::optional<std::array<GLint, 4>> scissor_;
+  std::optional<GLenum> cull_face_;
+  std::optional<GLenum> front_face_;
+  std::optional<GLuint> program_;
+  std::optional<GLenum> active_texture_;
+
+  static std::optional<Capability> ToCapability(GLenum capability);
+
+  // Records |value| as the new state and returns whether the GL call needs
+  // to be made.
+  template <class T>
+  bool Update(std::optional<T>& state, const T& value);
+
+  // Like |Update| for state that is set per stencil face.
+  template <class T>
+  bool UpdateStencil(GLenum face,
+                     std::optional<T> StencilState::*state,
+                     const T& value);
+
+  StateTrackerGLES(const StateTrackerGLES&) = delete;
+
+  StateTrackerGLES& operator=(const StateTrackerGLES&) = delete;
+};
+
+}  // namespace impeller
+
+#endif  // FLUTTER_IMPELLER_RENDERER_BACKEND_GLES_STATE_TRACKER_GLES_H_
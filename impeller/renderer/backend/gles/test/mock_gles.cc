@@ -184,6 +184,41 @@ void mockGenBuffers(GLsizei n, GLuint* buffers) {
 static_assert(CheckSameSignature<decltype(mockGenTextures),  //
                                  decltype(glGenTextures)>::value);
 
+void mockEnable(GLenum cap) {
+  CallMockMethod(&IMockGLESImpl::Enable, cap);
+}
+
+static_assert(CheckSameSignature<decltype(mockEnable),  //
+                                 decltype(glEnable)>::value);
+
+void mockDisable(GLenum cap) {
+  CallMockMethod(&IMockGLESImpl::Disable, cap);
+}
+
+static_assert(CheckSameSignature<decltype(mockDisable),  //
+                                 decltype(glDisable)>::value);
+
+void mockStencilMaskSeparate(GLenum face, GLuint mask) {
+  CallMockMethod(&IMockGLESImpl::StencilMaskSeparate, face, mask);
+}
+
+static_assert(CheckSameSignature<decltype(mockStencilMaskSeparate),  //
+                                 decltype(glStencilMaskSeparate)>::value);
+
+void mockUseProgram(GLuint program) {
+  CallMockMethod(&IMockGLESImpl::UseProgram, program);
+}
+
+static_assert(CheckSameSignature<decltype(mockUseProgram),  //
+                                 decltype(glUseProgram)>::value);
+
+void mockActiveTexture(GLenum texture) {
+  CallMockMethod(&IMockGLESImpl::ActiveTexture, texture);
+}
+
+static_assert(CheckSameSignature<decltype(mockActiveTexture),  //
+                                 decltype(glActiveTexture)>::value);
+
 void mockObjectLabelKHR(GLenum identifier,
                         GLuint name,
                         GLsizei length,
@@ -257,6 +292,16 @@ const ProcTableGLES::Resolver kMockResolverGLES = [](const char* name) {
     return reinterpret_cast<void*>(mockObjectLabelKHR);
   } else if (strcmp(name, "glGenBuffers") == 0) {
     return reinterpret_cast<void*>(mockGenBuffers);
+  } else if (strcmp(name, "glEnable") == 0) {
+    return reinterpret_cast<void*>(mockEnable);
+  } else if (strcmp(name, "glDisable") == 0) {
+    return reinterpret_cast<void*>(mockDisable);
+  } else if (strcmp(name, "glStencilMaskSeparate") == 0) {
+    return reinterpret_cast<void*>(mockStencilMaskSeparate);
+  } else if (strcmp(name, "glUseProgram") == 0) {
+    return reinterpret_cast<void*>(mockUseProgram);
+  } else if (strcmp(name, "glActiveTexture") == 0) {
+    return reinterpret_cast<void*>(mockActiveTexture);
   } else {
     return reinterpret_cast<void*>(&doNothing);
   }
@@ -36,6 +36,11 @@ class IMockGLESImpl {
                                       GLuint64* result) {}
   virtual void DeleteQueriesEXT(GLsizei size, const GLuint* queries) {}
   virtual void GenBuffers(GLsizei n, GLuint* buffers) {}
+  virtual void Enable(GLenum cap) {}
+  virtual void Disable(GLenum cap) {}
+  virtual void StencilMaskSeparate(GLenum face, GLuint mask) {}
+  virtual void UseProgram(GLuint program) {}
+  virtual void ActiveTexture(GLenum texture) {}
 };
 
 class MockGLESImpl : public IMockGLESImpl {
@@ -70,6 +75,14 @@ class MockGLESImpl : public IMockGLESImpl {
               (GLsizei size, const GLuint* queries),
               (override));
   MOCK_METHOD(void, GenBuffers, (GLsizei n, GLuint* buffers), (override));
+  MOCK_METHOD(void, Enable, (GLenum cap), (override));
+  MOCK_METHOD(void, Disable, (GLenum cap), (override));
+  MOCK_METHOD(void,
+              StencilMaskSeparate,
+              (GLenum face, GLuint mask),
+              (override));
+  MOCK_METHOD(void, UseProgram, (GLuint program), (override));
+  MOCK_METHOD(void, ActiveTexture, (GLenum texture), (override));
 };
 
 /// @brief      Provides a mocked version of the |ProcTableGLES| class.
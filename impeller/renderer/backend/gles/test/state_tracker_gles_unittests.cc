@@ -0,0 +1,138 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <memory>
+#include <thread>
+
+#include "flutter/testing/testing.h"  // IWYU pragma: keep
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "impeller/renderer/backend/gles/reactor_gles.h"
+#include "impeller/renderer/backend/gles/render_pass_gles.h"
+#include "impeller/renderer/backend/gles/state_tracker_gles.h"
+#include "impeller/renderer/backend/gles/test/mock_gles.h"
+
+namespace impeller {
+namespace testing {
+
+using ::testing::_;
+
+TEST(StateTrackerGLES, ElidesCallsThatDoNotChangeState) {
+  auto mock_gles_impl = std::make_unique<MockGLESImpl>();
+  EXPECT_CALL(*mock_gles_impl, Enable(GL_BLEND)).Times(1);
+  EXPECT_CALL(*mock_gles_impl, UseProgram(7u)).Times(1);
+  EXPECT_CALL(*mock_gles_impl, ActiveTexture(GL_TEXTURE0)).Times(1);
+  auto mock_gles = MockGLES::Init(std::move(mock_gles_impl));
+
+  StateTrackerGLES state(mock_gles->GetProcTable());
+  for (int i = 0; i < 3; i++) {
+    state.SetCapability(GL_BLEND, true);
+    state.UseProgram(7u);
+    state.ActiveTexture(GL_TEXTURE0);
+  }
+  EXPECT_EQ(state.GetStats().issued_calls, 3u);
+  EXPECT_EQ(state.GetStats().elided_calls, 6u);
+
+  state.ResetStats();
+  EXPECT_EQ(state.GetStats().issued_calls, 0u);
+  EXPECT_EQ(state.GetStats().elided_calls, 0u);
+}
+
+TEST(StateTrackerGLES, ForwardsChangesAndUntrackedCapabilities) {
+  auto mock_gles_impl = std::make_unique<MockGLESImpl>();
+  EXPECT_CALL(*mock_gles_impl, Enable(GL_BLEND)).Times(2);
+  EXPECT_CALL(*mock_gles_impl, Disable(GL_BLEND)).Times(1);
+  // Capabilities that the tracker does not know about are always forwarded.
+  EXPECT_CALL(*mock_gles_impl, Enable(GL_POLYGON_OFFSET_FILL)).Times(2);
+  EXPECT_CALL(*mock_gles_impl, UseProgram(_)).Times(2);
+  auto mock_gles = MockGLES::Init(std::move(mock_gles_impl));
+
+  StateTrackerGLES state(mock_gles->GetProcTable());
+  state.SetCapability(GL_BLEND, true);
+  state.SetCapability(GL_BLEND, false);
+  state.SetCapability(GL_BLEND, true);
+  state.SetCapability(GL_POLYGON_OFFSET_FILL, true);
+  state.SetCapability(GL_POLYGON_OFFSET_FILL, true);
+  state.UseProgram(1u);
+  state.UseProgram(2u);
+  EXPECT_EQ(state.GetStats().issued_calls, 7u);
+  EXPECT_EQ(state.GetStats().elided_calls, 0u);
+}
+
+TEST(StateTrackerGLES, InvalidateForwardsTheNextCall) {
+  auto mock_gles_impl = std::make_unique<MockGLESImpl>();
+  EXPECT_CALL(*mock_gles_impl, Disable(GL_SCISSOR_TEST)).Times(2);
+  auto mock_gles = MockGLES::Init(std::move(mock_gles_impl));
+
+  StateTrackerGLES state(mock_gles->GetProcTable());
+  state.SetCapability(GL_SCISSOR_TEST, false);
+  state.SetCapability(GL_SCISSOR_TEST, false);
+  state.Invalidate();
+  state.SetCapability(GL_SCISSOR_TEST, false);
+  EXPECT_EQ(state.GetStats().issued_calls, 2u);
+  EXPECT_EQ(state.GetStats().elided_calls, 1u);
+}
+
+TEST(StateTrackerGLES, TracksStencilFacesSeparately) {
+  auto mock_gles_impl = std::make_unique<MockGLESImpl>();
+  EXPECT_CALL(*mock_gles_impl, StencilMaskSeparate(GL_FRONT, 0xFFu)).Times(1);
+  EXPECT_CALL(*mock_gles_impl, StencilMaskSeparate(GL_BACK, 0x0Fu)).Times(1);
+  EXPECT_CALL(*mock_gles_impl, StencilMaskSeparate(GL_FRONT_AND_BACK, 0xFFu))
+      .Times(1);
+  auto mock_gles = MockGLES::Init(std::move(mock_gles_impl));
+
+  StateTrackerGLES state(mock_gles->GetProcTable());
+  state.StencilMaskSeparate(GL_FRONT, 0xFFu);
+  state.StencilMaskSeparate(GL_BACK, 0x0Fu);
+  // Only the back face needs to change.
+  state.StencilMaskSeparate(GL_FRONT_AND_BACK, 0xFFu);
+  // Both faces are now known to match.
+  state.StencilMaskSeparate(GL_FRONT_AND_BACK, 0xFFu);
+  state.StencilMaskSeparate(GL_FRONT, 0xFFu);
+  state.StencilMaskSeparate(GL_BACK, 0xFFu);
+  EXPECT_EQ(state.GetStats().issued_calls, 3u);
+  EXPECT_EQ(state.GetStats().elided_calls, 3u);
+}
+
+TEST(StateTrackerGLES, ResetGLStateAlwaysReachesTheContext) {
+  auto mock_gles_impl = std::make_unique<MockGLESImpl>();
+  EXPECT_CALL(*mock_gles_impl, Disable(GL_BLEND)).Times(2);
+  EXPECT_CALL(*mock_gles_impl, Disable(GL_SCISSOR_TEST)).Times(2);
+  EXPECT_CALL(*mock_gles_impl, Disable(GL_DEPTH_TEST)).Times(2);
+  EXPECT_CALL(*mock_gles_impl, Disable(GL_STENCIL_TEST)).Times(2);
+  EXPECT_CALL(*mock_gles_impl, Disable(GL_CULL_FACE)).Times(2);
+  EXPECT_CALL(*mock_gles_impl, Disable(GL_DITHER)).Times(2);
+  EXPECT_CALL(*mock_gles_impl, StencilMaskSeparate(_, _)).Times(4);
+  auto mock_gles = MockGLES::Init(std::move(mock_gles_impl));
+
+  StateTrackerGLES state(mock_gles->GetProcTable());
+  // The context may have been changed outside of Impeller between passes, so
+  // resetting it must not rely on the tracked state.
+  RenderPassGLES::ResetGLState(state);
+  RenderPassGLES::ResetGLState(state);
+  EXPECT_EQ(state.GetStats().elided_calls, 0u);
+
+  // Within a pass, setting the state again is elided.
+  state.SetCapability(GL_BLEND, false);
+  EXPECT_EQ(state.GetStats().elided_calls, 1u);
+}
+
+TEST(StateTrackerGLES, ReactorHasATrackerPerThread) {
+  auto mock_gles = MockGLES::Init();
+  ProcTableGLES::Resolver resolver = kMockResolverGLES;
+  auto reactor = std::make_shared<ReactorGLES>(
+      std::make_unique<ProcTableGLES>(resolver));
+
+  StateTrackerGLES* main_tracker = &reactor->GetStateTracker();
+  EXPECT_EQ(main_tracker, &reactor->GetStateTracker());
+
+  StateTrackerGLES* thread_tracker = nullptr;
+  std::thread thread([&] { thread_tracker = &reactor->GetStateTracker(); });
+  thread.join();
+  EXPECT_NE(thread_tracker, nullptr);
+  EXPECT_NE(thread_tracker, main_tracker);
+}
+
+}  // namespace testing
+}  // namespace impeller
@@ -164,6 +164,20 @@ fml::StatusOr<vk::DescriptorSet> CommandBufferVK::AllocateDescriptorSets(
                                                                       context);
 }
 
+fml::StatusOr<vk::DescriptorSet> CommandBufferVK::GetDescriptorSet(
+    const vk::DescriptorSetLayout& layout,
+    vk::WriteDescriptorSet* writes,
+    size_t write_count,
+    const ContextVK& context) {
+  if (!IsValid()) {
+    return fml::Status(fml::StatusCode::kUnknown, "command encoder invalid");
+  }
+
+  return tracked_objects_->GetDescriptorPool().GetDescriptorSet(
+      layout, writes, write_count, tracked_objects_->GetDescriptorSetCache(),
+      context);
+}
+
 void CommandBufferVK::PushDebugGroup(std::string_view label) const {
   if (!HasValidationLayers()) {
     return;
@@ -76,6 +76,17 @@ class CommandBufferVK final
       const vk::DescriptorSetLayout& layout,
       const ContextVK& context);
 
+  /// @brief Get a descriptor set for the given [layout] that holds the given
+  ///        [writes], updating their destination set.
+  ///
+  /// Sets written earlier in this command buffer with exactly the same
+  /// resources are reused instead of allocating and writing a new set.
+  fml::StatusOr<vk::DescriptorSet> GetDescriptorSet(
+      const vk::DescriptorSetLayout& layout,
+      vk::WriteDescriptorSet* writes,
+      size_t write_count,
+      const ContextVK& context);
+
   // Visible for testing.
   DescriptorPoolVK& GetDescriptorPool() const;
 
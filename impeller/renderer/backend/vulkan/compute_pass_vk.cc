@@ -56,13 +56,7 @@ void ComputePassVK::SetPipeline(
   command_buffer_vk.bindPipeline(vk::PipelineBindPoint::eCompute,
                                  pipeline_vk.GetPipeline());
   pipeline_layout_ = pipeline_vk.GetPipelineLayout();
-
-  auto descriptor_result = command_buffer_->AllocateDescriptorSets(
-      pipeline_vk.GetDescriptorSetLayout(), ContextVK::Cast(*context_));
-  if (!descriptor_result.ok()) {
-    return;
-  }
-  descriptor_set_ = descriptor_result.value();
+  descriptor_set_layout_ = pipeline_vk.GetDescriptorSetLayout();
   pipeline_valid_ = true;
 }
 
@@ -72,6 +66,7 @@ fml::Status ComputePassVK::Compute(const ISize& grid_size) {
     bound_image_offset_ = 0u;
     bound_buffer_offset_ = 0u;
     descriptor_write_offset_ = 0u;
+    dynamic_offsets_.Reset();
     has_label_ = false;
     pipeline_valid_ = false;
     return fml::Status(fml::StatusCode::kCancelled,
@@ -79,12 +74,20 @@ fml::Status ComputePassVK::Compute(const ISize& grid_size) {
   }
 
   const ContextVK& context_vk = ContextVK::Cast(*context_);
-  for (auto i = 0u; i < descriptor_write_offset_; i++) {
-    write_workspace_[i].dstSet = descriptor_set_;
+  auto descriptor_result = command_buffer_->GetDescriptorSet(
+      descriptor_set_layout_, write_workspace_.data(), descriptor_write_offset_,
+      context_vk);
+  if (!descriptor_result.ok()) {
+    bound_image_offset_ = 0u;
+    bound_buffer_offset_ = 0u;
+    descriptor_write_offset_ = 0u;
+    dynamic_offsets_.Reset();
+    has_label_ = false;
+    pipeline_valid_ = false;
+    return fml::Status(fml::StatusCode::kAborted,
+                       "Could not allocate descriptor sets.");
   }
-
-  context_vk.GetDevice().updateDescriptorSets(descriptor_write_offset_,
-                                              write_workspace_.data(), 0u, {});
+  const vk::DescriptorSet descriptor_set = descriptor_result.value();
   const vk::CommandBuffer& command_buffer_vk =
       command_buffer_->GetCommandBuffer();
 
@@ -93,9 +96,9 @@ fml::Status ComputePassVK::Compute(const ISize& grid_size) {
       pipeline_layout_,                 // layout
       0,                                // first set
       1,                                // set count
-      &descriptor_set_,                 // sets
-      0,                                // offset count
-      nullptr                           // offsets
+      &descriptor_set,                  // sets
+      dynamic_offsets_.GetCount(),      // offset count
+      dynamic_offsets_.GetOffsets()     // offsets
   );
 
   int64_t width = grid_size.width;
@@ -124,6 +127,7 @@ fml::Status ComputePassVK::Compute(const ISize& grid_size) {
   bound_image_offset_ = 0u;
   bound_buffer_offset_ = 0u;
   descriptor_write_offset_ = 0u;
+  dynamic_offsets_.Reset();
   has_label_ = false;
   pipeline_valid_ = false;
 
@@ -169,7 +173,7 @@ bool ComputePassVK::BindResource(
   vk::WriteDescriptorSet write_set;
   write_set.dstBinding = slot.binding;
   write_set.descriptorCount = 1u;
-  write_set.descriptorType = ToVKDescriptorType(type);
+  write_set.descriptorType = ToVKDescriptorBindingType(type);
   write_set.pImageInfo = &image_workspace_[bound_image_offset_ - 1];
 
   write_workspace_[descriptor_write_offset_++] = write_set;
@@ -194,6 +198,14 @@ bool ComputePassVK::BindResource(size_t binding,
   }
 
   uint32_t offset = view.GetRange().offset;
+  if (type == DescriptorType::kUniformBuffer) {
+    // The offset is passed when the set is bound, so draws with uniforms
+    // elsewhere in the same buffer can share the set.
+    if (!dynamic_offsets_.Add(binding, offset)) {
+      return false;
+    }
+    offset = 0u;
+  }
 
   vk::DescriptorBufferInfo buffer_info;
   buffer_info.buffer = buffer;
@@ -204,7 +216,7 @@ bool ComputePassVK::BindResource(size_t binding,
   vk::WriteDescriptorSet write_set;
   write_set.dstBinding = binding;
   write_set.descriptorCount = 1u;
-  write_set.descriptorType = ToVKDescriptorType(type);
+  write_set.descriptorType = ToVKDescriptorBindingType(type);
   write_set.pBufferInfo = &buffer_workspace_[bound_buffer_offset_ - 1];
 
   write_workspace_[descriptor_write_offset_++] = write_set;
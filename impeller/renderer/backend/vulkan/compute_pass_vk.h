@@ -5,6 +5,7 @@
 #ifndef FLUTTER_IMPELLER_RENDERER_BACKEND_VULKAN_COMPUTE_PASS_VK_H_
 #define FLUTTER_IMPELLER_RENDERER_BACKEND_VULKAN_COMPUTE_PASS_VK_H_
 
+#include "impeller/renderer/backend/vulkan/descriptor_set_cache_vk.h"
 #include "impeller/renderer/backend/vulkan/pipeline_vk.h"
 #include "impeller/renderer/backend/vulkan/vk.h"
 #include "impeller/renderer/compute_pass.h"
@@ -34,9 +35,10 @@ class ComputePassVK final : public ComputePass {
   size_t bound_image_offset_ = 0u;
   size_t bound_buffer_offset_ = 0u;
   size_t descriptor_write_offset_ = 0u;
+  DynamicOffsetsVK dynamic_offsets_;
   bool has_label_ = false;
   bool pipeline_valid_ = false;
-  vk::DescriptorSet descriptor_set_ = {};
+  vk::DescriptorSetLayout descriptor_set_layout_ = {};
   vk::PipelineLayout pipeline_layout_ = {};
 
   ComputePassVK(std::shared_ptr<const Context> context,
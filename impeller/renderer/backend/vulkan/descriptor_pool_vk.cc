@@ -6,6 +6,7 @@
 
 #include <optional>
 
+#include "flutter/fml/trace_event.h"
 #include "impeller/base/validation.h"
 #include "impeller/renderer/backend/vulkan/resource_manager_vk.h"
 #include "vulkan/vulkan_enums.hpp"
@@ -68,6 +69,14 @@ DescriptorPoolVK::DescriptorPoolVK(std::weak_ptr<const ContextVK> context)
     : context_(std::move(context)) {}
 
 DescriptorPoolVK::~DescriptorPoolVK() {
+  // The pool is dropped at the end of the frame it was used for.
+  FML_TRACE_COUNTER("impeller",                                     //
+                    "DescriptorPoolVK",                             //
+                    reinterpret_cast<int64_t>(this),                //
+                    "AllocatedSets", stats_.allocated_sets,         //
+                    "DescriptorWrites", stats_.descriptor_writes,   //
+                    "ReusedSets", stats_.reused_sets                //
+  );
   if (pools_.empty()) {
     return;
   }
@@ -117,6 +126,34 @@ fml::StatusOr<vk::DescriptorSet> DescriptorPoolVK::AllocateDescriptorSets(
                    << vk::to_string(result);
     return fml::Status(fml::StatusCode::kUnknown, "");
   }
+  stats_.allocated_sets++;
+  return set;
+}
+
+fml::StatusOr<vk::DescriptorSet> DescriptorPoolVK::GetDescriptorSet(
+    const vk::DescriptorSetLayout& layout,
+    vk::WriteDescriptorSet* writes,
+    size_t write_count,
+    DescriptorSetCacheVK& cache,
+    const ContextVK& context_vk) {
+  std::optional<vk::DescriptorSet> cached =
+      cache.Find(layout, writes, write_count);
+  if (cached.has_value()) {
+    stats_.reused_sets++;
+    return cached.value();
+  }
+
+  auto result = AllocateDescriptorSets(layout, context_vk);
+  if (!result.ok()) {
+    return result;
+  }
+  const vk::DescriptorSet set = result.value();
+  for (size_t i = 0; i < write_count; i++) {
+    writes[i].dstSet = set;
+  }
+  context_vk.GetDevice().updateDescriptorSets(write_count, writes, 0u, {});
+  stats_.descriptor_writes += write_count;
+  cache.Insert(layout, writes, write_count, set);
   return set;
 }
 
@@ -167,7 +204,7 @@ vk::UniqueDescriptorPool DescriptorPoolRecyclerVK::Create() {
   std::vector<vk::DescriptorPoolSize> pools = {
       vk::DescriptorPoolSize{vk::DescriptorType::eCombinedImageSampler,
                              kDefaultBindingSize.texture_bindings},
-      vk::DescriptorPoolSize{vk::DescriptorType::eUniformBuffer,
+      vk::DescriptorPoolSize{vk::DescriptorType::eUniformBufferDynamic,
                              kDefaultBindingSize.buffer_bindings},
       vk::DescriptorPoolSize{vk::DescriptorType::eStorageBuffer,
                              kDefaultBindingSize.storage_bindings},
@@ -9,6 +9,7 @@
 
 #include "fml/status_or.h"
 #include "impeller/renderer/backend/vulkan/context_vk.h"
+#include "impeller/renderer/backend/vulkan/descriptor_set_cache_vk.h"
 #include "vulkan/vulkan_handles.hpp"
 
 namespace impeller {
@@ -26,6 +27,18 @@ namespace impeller {
 ///             threading and lifecycle restrictions.
 class DescriptorPoolVK {
  public:
+  /// Counts of the work done by this pool. As the pool is per-frame, these
+  /// are the counts for one frame on one thread.
+  struct Stats {
+    /// The number of descriptor sets allocated from this pool.
+    size_t allocated_sets = 0u;
+    /// The number of descriptor writes made to sets from this pool.
+    size_t descriptor_writes = 0u;
+    /// The number of times an already written set was reused instead of
+    /// allocating and writing a new one.
+    size_t reused_sets = 0u;
+  };
+
   explicit DescriptorPoolVK(std::weak_ptr<const ContextVK> context);
 
   ~DescriptorPoolVK();
@@ -34,9 +47,26 @@ class DescriptorPoolVK {
       const vk::DescriptorSetLayout& layout,
       const ContextVK& context_vk);
 
+  //----------------------------------------------------------------------------
+  /// @brief      Get a descriptor set for |layout| that holds the given
+  ///             writes. If |cache| already has a set that was written with
+  ///             the same resources, it is returned as is. Otherwise a new
+  ///             set is allocated, |writes| are updated to target it and
+  ///             written to the device, and the set is added to |cache|.
+  ///
+  fml::StatusOr<vk::DescriptorSet> GetDescriptorSet(
+      const vk::DescriptorSetLayout& layout,
+      vk::WriteDescriptorSet* writes,
+      size_t write_count,
+      DescriptorSetCacheVK& cache,
+      const ContextVK& context_vk);
+
+  const Stats& GetStats() const { return stats_; }
+
  private:
   std::weak_ptr<const ContextVK> context_;
   std::vector<vk::UniqueDescriptorPool> pools_;
+  Stats stats_;
 
   fml::Status CreateNewPool(const ContextVK& context_vk);
 
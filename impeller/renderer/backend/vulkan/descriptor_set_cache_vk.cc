@@ -0,0 +1,114 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "impeller/renderer/backend/vulkan/descriptor_set_cache_vk.h"
+
+#include "flutter/fml/hash_combine.h"
+#include "flutter/fml/logging.h"
+
+namespace impeller {
+
+DescriptorSetCacheVK::WriteKey::WriteKey(const vk::WriteDescriptorSet& write)
+    : binding(write.dstBinding), type(write.descriptorType) {
+  // Impeller only ever writes a single descriptor per binding.
+  FML_DCHECK(write.descriptorCount == 1u);
+  if (write.pBufferInfo) {
+    buffer = write.pBufferInfo->buffer;
+    offset = write.pBufferInfo->offset;
+    range = write.pBufferInfo->range;
+  }
+  if (write.pImageInfo) {
+    image_view = write.pImageInfo->imageView;
+    sampler = write.pImageInfo->sampler;
+    image_layout = write.pImageInfo->imageLayout;
+  }
+}
+
+bool DescriptorSetCacheVK::WriteKey::operator==(const WriteKey& other) const {
+  return binding == other.binding && type == other.type &&
+         buffer == other.buffer && offset == other.offset &&
+         range == other.range && image_view == other.image_view &&
+         sampler == other.sampler && image_layout == other.image_layout;
+}
+
+DescriptorSetCacheVK::DescriptorSetCacheVK() = default;
+
+DescriptorSetCacheVK::~DescriptorSetCacheVK() = default;
+
+// static
+size_t DescriptorSetCacheVK::Hash(const vk::DescriptorSetLayout& layout,
+                                  const vk::WriteDescriptorSet* writes,
+                                  size_t write_count) {
+  size_t hash = fml::HashCombine(static_cast<VkDescriptorSetLayout>(layout),
+                                 write_count);
+  for (size_t i = 0; i < write_count; i++) {
+    const vk::WriteDescriptorSet& write = writes[i];
+    fml::HashCombineSeed(hash, write.dstBinding, write.descriptorType);
+    if (write.pBufferInfo) {
+      fml::HashCombineSeed(hash,
+                           static_cast<VkBuffer>(write.pBufferInfo->buffer),
+                           write.pBufferInfo->offset);
+    }
+    if (write.pImageInfo) {
+      fml::HashCombineSeed(
+          hash, static_cast<VkImageView>(write.pImageInfo->imageView),
+          static_cast<VkSampler>(write.pImageInfo->sampler));
+    }
+  }
+  return hash;
+}
+
+std::optional<vk::DescriptorSet> DescriptorSetCacheVK::Find(
+    const vk::DescriptorSetLayout& layout,
+    const vk::WriteDescriptorSet* writes,
+    size_t write_count) const {
+  auto [begin, end] = sets_.equal_range(Hash(layout, writes, write_count));
+  for (auto it = begin; it != end; ++it) {
+    const Entry& entry = it->second;
+    if (entry.layout != layout || entry.writes.size() != write_count) {
+      continue;
+    }
+    bool matches = true;
+    for (size_t i = 0; i < write_count && matches; i++) {
+      matches = entry.writes[i] == WriteKey(writes[i]);
+    }
+    if (matches) {
+      return entry.set;
+    }
+  }
+  return std::nullopt;
+}
+
+void DescriptorSetCacheVK::Insert(const vk::DescriptorSetLayout& layout,
+                                  const vk::WriteDescriptorSet* writes,
+                                  size_t write_count,
+                                  vk::DescriptorSet set) {
+  if (sets_.size() >= kMaxCachedSets) {
+    return;
+  }
+  Entry entry{.layout = layout, .set = set};
+  entry.writes.reserve(write_count);
+  for (size_t i = 0; i < write_count; i++) {
+    entry.writes.emplace_back(writes[i]);
+  }
+  sets_.emplace(Hash(layout, writes, write_count), std::move(entry));
+}
+
+bool DynamicOffsetsVK::Add(uint32_t binding, uint32_t offset) {
+  if (count_ >= kMaxOffsets) {
+    return false;
+  }
+  // Draws bind a handful of uniform buffers, mostly in binding order, so an
+  // insertion keeps the offsets sorted cheaply.
+  uint32_t index = count_++;
+  for (; index > 0u && bindings_[index - 1] > binding; index--) {
+    bindings_[index] = bindings_[index - 1];
+    offsets_[index] = offsets_[index - 1];
+  }
+  bindings_[index] = binding;
+  offsets_[index] = offset;
+  return true;
+}
+
+}  // namespace impeller
@@ -0,0 +1,133 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_IMPELLER_RENDERER_BACKEND_VULKAN_DESCRIPTOR_SET_CACHE_VK_H_
+#define FLUTTER_IMPELLER_RENDERER_BACKEND_VULKAN_DESCRIPTOR_SET_CACHE_VK_H_
+
+#include <array>
+#include <cstddef>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+#include "impeller/renderer/backend/vulkan/vk.h"
+
+namespace impeller {
+
+//------------------------------------------------------------------------------
+/// @brief      Remembers the descriptor sets that were written while encoding
+///             a single command buffer, keyed on the set layout and the
+///             resources that were written to each binding.
+///
+///             Draws and dispatches that bind exactly the same resources as
+///             an earlier one in the same command buffer can bind the set
+///             that was already written instead of allocating and updating a
+///             new one. Uniform buffers are bound with dynamic offsets, see
+///             |DynamicOffsetsVK|, so draws whose uniforms were written to
+///             different parts of the same host buffer share a set.
+///
+///             The keys hold raw Vulkan handles. This is only safe because
+///             every resource bound while encoding a command buffer is
+///             tracked by it, so none of those handles can be destroyed and
+///             reused while the command buffer, and therefore this cache,
+///             is alive. The cache must not outlive the command buffer.
+///
+///             Not thread safe, like the command buffer it belongs to.
+///
+class DescriptorSetCacheVK {
+ public:
+  /// The maximum number of sets remembered for a single command buffer.
+  /// Writes after the cache is full are not cached.
+  static constexpr size_t kMaxCachedSets = 1024u;
+
+  DescriptorSetCacheVK();
+
+  ~DescriptorSetCacheVK();
+
+  //----------------------------------------------------------------------------
+  /// @brief      Find a set with the given layout that was written with
+  ///             exactly the given writes, ignoring their |dstSet|.
+  ///
+  std::optional<vk::DescriptorSet> Find(const vk::DescriptorSetLayout& layout,
+                                        const vk::WriteDescriptorSet* writes,
+                                        size_t write_count) const;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Remember that |set| was written with the given writes.
+  ///
+  void Insert(const vk::DescriptorSetLayout& layout,
+              const vk::WriteDescriptorSet* writes,
+              size_t write_count,
+              vk::DescriptorSet set);
+
+  size_t GetSize() const { return sets_.size(); }
+
+ private:
+  // The parts of a single descriptor write that identify what was bound.
+  struct WriteKey {
+    uint32_t binding = 0u;
+    vk::DescriptorType type = vk::DescriptorType::eUniformBuffer;
+    vk::Buffer buffer;
+    vk::DeviceSize offset = 0u;
+    vk::DeviceSize range = 0u;
+    vk::ImageView image_view;
+    vk::Sampler sampler;
+    vk::ImageLayout image_layout = vk::ImageLayout::eUndefined;
+
+    explicit WriteKey(const vk::WriteDescriptorSet& write);
+
+    bool operator==(const WriteKey& other) const;
+  };
+
+  struct Entry {
+    vk::DescriptorSetLayout layout;
+    std::vector<WriteKey> writes;
+    vk::DescriptorSet set;
+  };
+
+  std::unordered_multimap<size_t, Entry> sets_;
+
+  static size_t Hash(const vk::DescriptorSetLayout& layout,
+                     const vk::WriteDescriptorSet* writes,
+                     size_t write_count);
+
+  DescriptorSetCacheVK(const DescriptorSetCacheVK&) = delete;
+
+  DescriptorSetCacheVK& operator=(const DescriptorSetCacheVK&) = delete;
+};
+
+//------------------------------------------------------------------------------
+/// @brief      The offsets of the uniform buffers bound for one draw or
+///             dispatch.
+///
+///             Uniform buffers are written to descriptor sets at offset zero
+///             and their actual offsets are passed to
+///             vkCmdBindDescriptorSets, which expects them in binding order.
+///
+class DynamicOffsetsVK {
+ public:
+  static constexpr size_t kMaxOffsets = 32u;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Record the offset of the uniform buffer bound to |binding|.
+  ///
+  /// @return     false if |kMaxOffsets| offsets were already recorded.
+  ///
+  bool Add(uint32_t binding, uint32_t offset);
+
+  const uint32_t* GetOffsets() const { return offsets_.data(); }
+
+  uint32_t GetCount() const { return count_; }
+
+  void Reset() { count_ = 0u; }
+
+ private:
+  std::array<uint32_t, kMaxOffsets> bindings_;
+  std::array<uint32_t, kMaxOffsets> offsets_;
+  uint32_t count_ = 0u;
+};
+
+}  // namespace impeller
+
+#endif  // FLUTTER_IMPELLER_RENDERER_BACKEND_VULKAN_DESCRIPTOR_SET_CACHE_VK_H_
@@ -0,0 +1,184 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/testing/testing.h"  // IWYU pragma: keep.
+#include "impeller/renderer/backend/vulkan/command_buffer_vk.h"
+#include "impeller/renderer/backend/vulkan/descriptor_set_cache_vk.h"
+#include "impeller/renderer/backend/vulkan/test/mock_vulkan.h"
+
+namespace impeller {
+namespace testing {
+
+namespace {
+
+// The cache never dereferences the handles, so these are never created.
+template <class T>
+T FakeHandle(uintptr_t value) {
+  return T(reinterpret_cast<typename T::CType>(value));
+}
+
+// A uniform buffer binding followed by a texture binding.
+struct TestBindings {
+  vk::DescriptorBufferInfo buffer_info;
+  vk::DescriptorImageInfo image_info;
+  std::array<vk::WriteDescriptorSet, 2> writes;
+
+  TestBindings(uintptr_t buffer, vk::DeviceSize offset, uintptr_t image_view) {
+    buffer_info.buffer = FakeHandle<vk::Buffer>(buffer);
+    buffer_info.offset = offset;
+    buffer_info.range = 64u;
+    image_info.imageView = FakeHandle<vk::ImageView>(image_view);
+    image_info.sampler = FakeHandle<vk::Sampler>(0x100);
+    image_info.imageLayout = vk::ImageLayout::eShaderReadOnlyOptimal;
+
+    writes[0].dstBinding = 0u;
+    writes[0].descriptorCount = 1u;
+    writes[0].descriptorType = vk::DescriptorType::eUniformBuffer;
+    writes[0].pBufferInfo = &buffer_info;
+    writes[1].dstBinding = 1u;
+    writes[1].descriptorCount = 1u;
+    writes[1].descriptorType = vk::DescriptorType::eCombinedImageSampler;
+    writes[1].pImageInfo = &image_info;
+  }
+};
+
+size_t CountCalls(const std::shared_ptr<std::vector<std::string>>& called,
+                  const std::string& name) {
+  return std::count(called->begin(), called->end(), name);
+}
+
+}  // namespace
+
+TEST(DescriptorSetCacheVKTest, FindsSetsWrittenWithTheSameResources) {
+  DescriptorSetCacheVK cache;
+  auto layout = FakeHandle<vk::DescriptorSetLayout>(0x1);
+  auto set = FakeHandle<vk::DescriptorSet>(0x2);
+
+  TestBindings bindings(0x10, 0u, 0x20);
+  EXPECT_FALSE(cache.Find(layout, bindings.writes.data(), 2u).has_value());
+  cache.Insert(layout, bindings.writes.data(), 2u, set);
+  EXPECT_EQ(cache.GetSize(), 1u);
+
+  // The destination set and the location of the infos do not matter.
+  TestBindings same(0x10, 0u, 0x20);
+  same.writes[0].dstSet = FakeHandle<vk::DescriptorSet>(0x3);
+  EXPECT_EQ(cache.Find(layout, same.writes.data(), 2u), set);
+}
+
+TEST(DescriptorSetCacheVKTest, DoesNotFindSetsWithDifferentResources) {
+  DescriptorSetCacheVK cache;
+  auto layout = FakeHandle<vk::DescriptorSetLayout>(0x1);
+  TestBindings bindings(0x10, 0u, 0x20);
+  cache.Insert(layout, bindings.writes.data(), 2u,
+               FakeHandle<vk::DescriptorSet>(0x2));
+
+  EXPECT_FALSE(cache.Find(FakeHandle<vk::DescriptorSetLayout>(0x4),
+                          bindings.writes.data(), 2u));
+  EXPECT_FALSE(cache.Find(layout, bindings.writes.data(), 1u));
+
+  TestBindings other_buffer(0x11, 0u, 0x20);
+  EXPECT_FALSE(cache.Find(layout, other_buffer.writes.data(), 2u));
+  TestBindings other_offset(0x10, 256u, 0x20);
+  EXPECT_FALSE(cache.Find(layout, other_offset.writes.data(), 2u));
+  TestBindings other_image(0x10, 0u, 0x21);
+  EXPECT_FALSE(cache.Find(layout, other_image.writes.data(), 2u));
+  TestBindings other_binding(0x10, 0u, 0x20);
+  other_binding.writes[1].dstBinding = 2u;
+  EXPECT_FALSE(cache.Find(layout, other_binding.writes.data(), 2u));
+}
+
+TEST(DescriptorSetCacheVKTest, StopsCachingWhenFull) {
+  DescriptorSetCacheVK cache;
+  auto layout = FakeHandle<vk::DescriptorSetLayout>(0x1);
+  for (size_t i = 0; i <= DescriptorSetCacheVK::kMaxCachedSets; i++) {
+    TestBindings bindings(0x10, i * 256u, 0x20);
+    cache.Insert(layout, bindings.writes.data(), 2u,
+                 FakeHandle<vk::DescriptorSet>(0x2));
+  }
+  EXPECT_EQ(cache.GetSize(), DescriptorSetCacheVK::kMaxCachedSets);
+}
+
+TEST(DescriptorSetCacheVKTest, DynamicOffsetsAreInBindingOrder) {
+  DynamicOffsetsVK offsets;
+  EXPECT_EQ(offsets.GetCount(), 0u);
+  EXPECT_TRUE(offsets.Add(2u, 512u));
+  EXPECT_TRUE(offsets.Add(0u, 256u));
+  EXPECT_TRUE(offsets.Add(1u, 768u));
+  ASSERT_EQ(offsets.GetCount(), 3u);
+  EXPECT_EQ(offsets.GetOffsets()[0], 256u);
+  EXPECT_EQ(offsets.GetOffsets()[1], 768u);
+  EXPECT_EQ(offsets.GetOffsets()[2], 512u);
+
+  offsets.Reset();
+  EXPECT_EQ(offsets.GetCount(), 0u);
+  for (uint32_t i = 0; i < DynamicOffsetsVK::kMaxOffsets; i++) {
+    EXPECT_TRUE(offsets.Add(i, i * 256u));
+  }
+  EXPECT_FALSE(offsets.Add(DynamicOffsetsVK::kMaxOffsets, 0u));
+}
+
+TEST(DescriptorSetCacheVKTest, CommandBufferReusesWrittenSets) {
+  auto const context = MockVulkanContextBuilder().Build();
+  auto cmd_buffer = context->CreateCommandBuffer();
+  CommandBufferVK& cmd_buffer_vk = CommandBufferVK::Cast(*cmd_buffer);
+  auto layout = FakeHandle<vk::DescriptorSetLayout>(0x1);
+
+  for (int i = 0; i < 3; i++) {
+    TestBindings bindings(0x10, 0u, 0x20);
+    EXPECT_TRUE(cmd_buffer_vk
+                    .GetDescriptorSet(layout, bindings.writes.data(), 2u,
+                                      *context)
+                    .ok());
+  }
+  TestBindings other(0x10, 256u, 0x20);
+  EXPECT_TRUE(
+      cmd_buffer_vk.GetDescriptorSet(layout, other.writes.data(), 2u, *context)
+          .ok());
+
+  auto const called = GetMockVulkanFunctions(context->GetDevice());
+  EXPECT_EQ(CountCalls(called, "vkAllocateDescriptorSets"), 2u);
+  EXPECT_EQ(CountCalls(called, "vkUpdateDescriptorSets"), 2u);
+
+  const DescriptorPoolVK::Stats& stats =
+      cmd_buffer_vk.GetDescriptorPool().GetStats();
+  EXPECT_EQ(stats.allocated_sets, 2u);
+  EXPECT_EQ(stats.descriptor_writes, 4u);
+  EXPECT_EQ(stats.reused_sets, 2u);
+
+  context->Shutdown();
+}
+
+TEST(DescriptorSetCacheVKTest, SetsAreNotReusedAcrossCommandBuffers) {
+  auto const context = MockVulkanContextBuilder().Build();
+  auto cmd_buffer_1 = context->CreateCommandBuffer();
+  auto cmd_buffer_2 = context->CreateCommandBuffer();
+  auto layout = FakeHandle<vk::DescriptorSetLayout>(0x1);
+
+  // Resources bound in one command buffer are not tracked by the other, so
+  // their handles may have been reused by the time it binds them.
+  TestBindings bindings(0x10, 0u, 0x20);
+  EXPECT_TRUE(CommandBufferVK::Cast(*cmd_buffer_1)
+                  .GetDescriptorSet(layout, bindings.writes.data(), 2u,
+                                    *context)
+                  .ok());
+  EXPECT_TRUE(CommandBufferVK::Cast(*cmd_buffer_2)
+                  .GetDescriptorSet(layout, bindings.writes.data(), 2u,
+                                    *context)
+                  .ok());
+
+  auto const called = GetMockVulkanFunctions(context->GetDevice());
+  EXPECT_EQ(CountCalls(called, "vkAllocateDescriptorSets"), 2u);
+  EXPECT_EQ(CountCalls(called, "vkUpdateDescriptorSets"), 2u);
+
+  // Both command buffers share the pool of the current frame.
+  const DescriptorPoolVK::Stats& stats =
+      CommandBufferVK::Cast(*cmd_buffer_1).GetDescriptorPool().GetStats();
+  EXPECT_EQ(stats.allocated_sets, 2u);
+  EXPECT_EQ(stats.reused_sets, 0u);
+
+  context->Shutdown();
+}
+
+}  // namespace testing
+}  // namespace impeller
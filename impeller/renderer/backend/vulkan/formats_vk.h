@@ -293,12 +293,23 @@ constexpr vk::DescriptorType ToVKDescriptorType(DescriptorType type) {
   return static_cast<vk::DescriptorType>(type);
 }
 
+/// The descriptor type that set layouts and descriptor writes use for
+/// resources of the given type. Uniform buffers are bound with dynamic
+/// offsets so that a descriptor set does not depend on where in a host
+/// buffer the uniforms of a draw were written. See |DynamicOffsetsVK|.
+constexpr vk::DescriptorType ToVKDescriptorBindingType(DescriptorType type) {
+  if (type == DescriptorType::kUniformBuffer) {
+    return vk::DescriptorType::eUniformBufferDynamic;
+  }
+  return ToVKDescriptorType(type);
+}
+
 constexpr vk::DescriptorSetLayoutBinding ToVKDescriptorSetLayoutBinding(
     const DescriptorSetLayout& layout) {
   vk::DescriptorSetLayoutBinding binding;
   binding.binding = layout.binding;
   binding.descriptorCount = 1u;
-  binding.descriptorType = ToVKDescriptorType(layout.descriptor_type);
+  binding.descriptorType = ToVKDescriptorBindingType(layout.descriptor_type);
   binding.stageFlags = ToVkShaderStage(layout.shader_stage);
   return binding;
 }
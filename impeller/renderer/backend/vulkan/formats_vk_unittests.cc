@@ -23,5 +23,14 @@ TEST(FormatsVKTest, DescriptorMapping) {
             vk::DescriptorType::eInputAttachment);
 }
 
+TEST(FormatsVKTest, UniformBuffersAreBoundWithDynamicOffsets) {
+  EXPECT_EQ(ToVKDescriptorBindingType(DescriptorType::kUniformBuffer),
+            vk::DescriptorType::eUniformBufferDynamic);
+  EXPECT_EQ(ToVKDescriptorBindingType(DescriptorType::kStorageBuffer),
+            vk::DescriptorType::eStorageBuffer);
+  EXPECT_EQ(ToVKDescriptorBindingType(DescriptorType::kSampledImage),
+            vk::DescriptorType::eCombinedImageSampler);
+}
+
 }  // namespace testing
 }  // namespace impeller
@@ -184,7 +184,8 @@ fml::StatusOr<vk::UniqueDescriptorSetLayout> MakeDescriptorSetLayout(
     vk::DescriptorSetLayoutBinding set_binding;
     set_binding.binding = layout.binding;
     set_binding.descriptorCount = 1u;
-    set_binding.descriptorType = ToVKDescriptorType(layout.descriptor_type);
+    set_binding.descriptorType =
+        ToVKDescriptorBindingType(layout.descriptor_type);
     set_binding.stageFlags = ToVkShaderStage(layout.shader_stage);
     // TODO(143719): This specifies the immutable sampler for all sampled
     // images. This is incorrect. In cases where the shader samples from the
@@ -478,8 +478,9 @@ fml::Status RenderPassVK::Draw() {
   const auto& context_vk = ContextVK::Cast(*context_);
   const auto& pipeline_vk = PipelineVK::Cast(*pipeline_);
 
-  auto descriptor_result = command_buffer_->AllocateDescriptorSets(
-      pipeline_vk.GetDescriptorSetLayout(), context_vk);
+  auto descriptor_result = command_buffer_->GetDescriptorSet(
+      pipeline_vk.GetDescriptorSetLayout(), write_workspace_.data(),
+      descriptor_write_offset_, context_vk);
   if (!descriptor_result.ok()) {
     return fml::Status(fml::StatusCode::kAborted,
                        "Could not allocate descriptor sets.");
@@ -489,21 +490,14 @@ fml::Status RenderPassVK::Draw() {
   command_buffer_vk_.bindPipeline(vk::PipelineBindPoint::eGraphics,
                                   pipeline_vk.GetPipeline());
 
-  for (auto i = 0u; i < descriptor_write_offset_; i++) {
-    write_workspace_[i].dstSet = descriptor_set;
-  }
-
-  context_vk.GetDevice().updateDescriptorSets(descriptor_write_offset_,
-                                              write_workspace_.data(), 0u, {});
-
   command_buffer_vk_.bindDescriptorSets(
       vk::PipelineBindPoint::eGraphics,  // bind point
       pipeline_layout,                   // layout
       0,                                 // first set
       1,                                 // set count
       &descriptor_set,                   // sets
-      0,                                 // offset count
-      nullptr                            // offsets
+      dynamic_offsets_.GetCount(),       // offset count
+      dynamic_offsets_.GetOffsets()      // offsets
   );
 
   if (pipeline_uses_input_attachments_) {
@@ -536,6 +530,7 @@ fml::Status RenderPassVK::Draw() {
   bound_image_offset_ = 0u;
   bound_buffer_offset_ = 0u;
   descriptor_write_offset_ = 0u;
+  dynamic_offsets_.Reset();
   instance_count_ = 1u;
   base_vertex_ = 0u;
   element_count_ = 0u;
@@ -581,6 +576,14 @@ bool RenderPassVK::BindResource(size_t binding,
   }
 
   uint32_t offset = view.GetRange().offset;
+  if (type == DescriptorType::kUniformBuffer) {
+    // The offset is passed when the set is bound, so draws with uniforms
+    // elsewhere in the same buffer can share the set.
+    if (!dynamic_offsets_.Add(binding, offset)) {
+      return false;
+    }
+    offset = 0u;
+  }
 
   vk::DescriptorBufferInfo buffer_info;
   buffer_info.buffer = buffer;
@@ -591,7 +594,7 @@ bool RenderPassVK::BindResource(size_t binding,
   vk::WriteDescriptorSet write_set;
   write_set.dstBinding = binding;
   write_set.descriptorCount = 1u;
-  write_set.descriptorType = ToVKDescriptorType(type);
+  write_set.descriptorType = ToVKDescriptorBindingType(type);
   write_set.pBufferInfo = &buffer_workspace_[bound_buffer_offset_ - 1];
 
   write_workspace_[descriptor_write_offset_++] = write_set;
@@ -7,6 +7,7 @@
 
 #include "impeller/core/buffer_view.h"
 #include "impeller/renderer/backend/vulkan/context_vk.h"
+#include "impeller/renderer/backend/vulkan/descriptor_set_cache_vk.h"
 #include "impeller/renderer/backend/vulkan/pipeline_vk.h"
 #include "impeller/renderer/backend/vulkan/shared_object_vk.h"
 #include "impeller/renderer/command_buffer.h"
@@ -44,6 +45,7 @@ class RenderPassVK final : public RenderPass {
   size_t bound_image_offset_ = 0u;
   size_t bound_buffer_offset_ = 0u;
   size_t descriptor_write_offset_ = 0u;
+  DynamicOffsetsVK dynamic_offsets_;
   size_t instance_count_ = 1u;
   size_t base_vertex_ = 0u;
   size_t element_count_ = 0u;
@@ -625,6 +625,15 @@ VkResult vkAllocateDescriptorSets(
   return VK_SUCCESS;
 }
 
+void vkUpdateDescriptorSets(VkDevice device,
+                            uint32_t descriptorWriteCount,
+                            const VkWriteDescriptorSet* pDescriptorWrites,
+                            uint32_t descriptorCopyCount,
+                            const VkCopyDescriptorSet* pDescriptorCopies) {
+  MockDevice* mock_device = reinterpret_cast<MockDevice*>(device);
+  mock_device->AddCalledFunction("vkUpdateDescriptorSets");
+}
+
 VkResult vkGetPhysicalDeviceSurfaceFormatsKHR(
     VkPhysicalDevice physicalDevice,
     VkSurfaceKHR surface,
@@ -867,6 +876,8 @@ PFN_vkVoidFunction GetMockVulkanProcAddress(VkInstance instance,
     return (PFN_vkVoidFunction)vkResetDescriptorPool;
   } else if (strcmp("vkAllocateDescriptorSets", pName) == 0) {
     return (PFN_vkVoidFunction)vkAllocateDescriptorSets;
+  } else if (strcmp("vkUpdateDescriptorSets", pName) == 0) {
+    return (PFN_vkVoidFunction)vkUpdateDescriptorSets;
   } else if (strcmp("vkGetPhysicalDeviceSurfaceFormatsKHR", pName) == 0) {
     return (PFN_vkVoidFunction)vkGetPhysicalDeviceSurfaceFormatsKHR;
   } else if (strcmp("vkGetPhysicalDeviceSurfaceCapabilitiesKHR", pName) == 0) {
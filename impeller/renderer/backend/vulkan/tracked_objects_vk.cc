@@ -77,6 +77,10 @@ DescriptorPoolVK& TrackedObjectsVK::GetDescriptorPool() {
   return *desc_pool_;
 }
 
+DescriptorSetCacheVK& TrackedObjectsVK::GetDescriptorSetCache() {
+  return descriptor_set_cache_;
+}
+
 GPUProbe& TrackedObjectsVK::GetGPUProbe() const {
   return *probe_.get();
 }
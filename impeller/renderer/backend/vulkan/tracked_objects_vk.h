@@ -9,6 +9,7 @@
 
 #include "impeller/renderer/backend/vulkan/context_vk.h"
 #include "impeller/renderer/backend/vulkan/descriptor_pool_vk.h"
+#include "impeller/renderer/backend/vulkan/descriptor_set_cache_vk.h"
 #include "impeller/renderer/backend/vulkan/gpu_tracer_vk.h"
 #include "impeller/renderer/backend/vulkan/texture_source_vk.h"
 
@@ -37,6 +38,8 @@ class TrackedObjectsVK {
 
   DescriptorPoolVK& GetDescriptorPool();
 
+  DescriptorSetCacheVK& GetDescriptorSetCache();
+
   GPUProbe& GetGPUProbe() const;
 
  private:
@@ -47,6 +50,8 @@ class TrackedObjectsVK {
   std::vector<std::shared_ptr<SharedObjectVK>> tracked_objects_;
   std::vector<std::shared_ptr<const DeviceBuffer>> tracked_buffers_;
   std::vector<std::shared_ptr<const TextureSourceVK>> tracked_textures_;
+  // Only valid as long as the resources above are tracked.
+  DescriptorSetCacheVK descriptor_set_cache_;
   std::unique_ptr<GPUProbe> probe_;
   bool is_valid_ = false;
 
@@ -327,11 +327,13 @@ using EllipticalVertexGenerator = Tessellator::EllipticalVertexGenerator;
 
 EllipticalVertexGenerator::EllipticalVertexGenerator(
     EllipticalVertexGenerator::GeneratorProc& generator,
+    EllipticalVertexGenerator::WriterProc& writer,
     Trigs&& trigs,
     PrimitiveType triangle_type,
     size_t vertices_per_trig,
     Data&& data)
     : impl_(generator),
+      writer_(writer),
       trigs_(std::move(trigs)),
       data_(data),
       vertices_per_trig_(vertices_per_trig) {}
@@ -343,6 +345,7 @@ EllipticalVertexGenerator Tessellator::FilledCircle(
   size_t divisions =
       ComputeQuadrantDivisions(view_transform.GetMaxBasisLengthXY() * radius);
   return EllipticalVertexGenerator(Tessellator::GenerateFilledCircle,
+                                   Tessellator::WriteFilledCircle,
                                    GetTrigsForDivisions(divisions),
                                    PrimitiveType::kTriangleStrip, 4,
                                    {
@@ -361,6 +364,7 @@ EllipticalVertexGenerator Tessellator::StrokedCircle(
     auto divisions = ComputeQuadrantDivisions(
         view_transform.GetMaxBasisLengthXY() * radius + half_width);
     return EllipticalVertexGenerator(Tessellator::GenerateStrokedCircle,
+                                     Tessellator::WriteStrokedCircle,
                                      GetTrigsForDivisions(divisions),
                                      PrimitiveType::kTriangleStrip, 8,
                                      {
@@ -384,6 +388,7 @@ EllipticalVertexGenerator Tessellator::RoundCapLine(
     auto divisions =
         ComputeQuadrantDivisions(view_transform.GetMaxBasisLengthXY() * radius);
     return EllipticalVertexGenerator(Tessellator::GenerateRoundCapLine,
+                                     Tessellator::WriteRoundCapLine,
                                      GetTrigsForDivisions(divisions),
                                      PrimitiveType::kTriangleStrip, 4,
                                      {
@@ -408,6 +413,7 @@ EllipticalVertexGenerator Tessellator::FilledEllipse(
       view_transform.GetMaxBasisLengthXY() * max_radius);
   auto center = bounds.GetCenter();
   return EllipticalVertexGenerator(Tessellator::GenerateFilledEllipse,
+                                   Tessellator::WriteFilledEllipse,
                                    GetTrigsForDivisions(divisions),
                                    PrimitiveType::kTriangleStrip, 4,
                                    {
@@ -429,6 +435,7 @@ EllipticalVertexGenerator Tessellator::FilledRoundRect(
     auto upper_left = bounds.GetLeftTop() + radii;
     auto lower_right = bounds.GetRightBottom() - radii;
     return EllipticalVertexGenerator(Tessellator::GenerateFilledRoundRect,
+                                     Tessellator::WriteFilledRoundRect,
                                      GetTrigsForDivisions(divisions),
                                      PrimitiveType::kTriangleStrip, 4,
                                      {
@@ -623,4 +630,165 @@ void Tessellator::GenerateFilledRoundRect(
   }
 }
 
+// The generators below write each vertex straight into the destination
+// buffer. Shapes whose second half mirrors the first evaluate both halves
+// in a single pass over the trigs so that each scaled trig is computed
+// once and the loop bodies are free of calls and branches.
+
+void Tessellator::WriteFilledCircle(
+    const Trigs& trigs,
+    const EllipticalVertexGenerator::Data& data,
+    Point* vertices) {
+  auto center = data.reference_centers[0];
+  auto radius = data.radii.width;
+
+  FML_DCHECK(center == data.reference_centers[1]);
+  FML_DCHECK(radius == data.radii.height);
+  FML_DCHECK(data.half_width < 0);
+
+  // The second half of the circle should be iterated in reverse, but
+  // we can instead iterate forward and swap the x/y values of the
+  // offset as the angles should be symmetric and thus should generate
+  // symmetrically reversed trig vectors.
+  Point* second_half = vertices + trigs.size() * 2;
+  for (auto& trig : trigs) {
+    auto offset = trig * radius;
+    // Quadrant 1 connecting with Quadrant 4:
+    *vertices++ = {center.x - offset.x, center.y + offset.y};
+    *vertices++ = {center.x - offset.x, center.y - offset.y};
+    // Quadrant 2 connecting with Quadrant 3:
+    *second_half++ = {center.x + offset.y, center.y + offset.x};
+    *second_half++ = {center.x + offset.y, center.y - offset.x};
+  }
+}
+
+void Tessellator::WriteStrokedCircle(
+    const Trigs& trigs,
+    const EllipticalVertexGenerator::Data& data,
+    Point* vertices) {
+  auto center = data.reference_centers[0];
+
+  FML_DCHECK(center == data.reference_centers[1]);
+  FML_DCHECK(data.radii.IsSquare());
+  FML_DCHECK(data.half_width > 0 && data.half_width < data.radii.width);
+
+  auto outer_radius = data.radii.width + data.half_width;
+  auto inner_radius = data.radii.width - data.half_width;
+
+  // Zig-zag back and forth between points on the outer circle and the
+  // inner circle. Both circles are evaluated at the same number of
+  // quadrant divisions so the points for a given division should match
+  // 1 for 1 other than their applied radius.
+  //
+  // The even quadrants of the circle should be iterated in reverse, but
+  // we can instead iterate forward and swap the x/y values of the
+  // offset as the angles should be symmetric and thus should generate
+  // symmetrically reversed trig vectors.
+  size_t quadrant_size = trigs.size() * 2;
+  Point* quadrant_1 = vertices;
+  Point* quadrant_2 = quadrant_1 + quadrant_size;
+  Point* quadrant_3 = quadrant_2 + quadrant_size;
+  Point* quadrant_4 = quadrant_3 + quadrant_size;
+  for (auto& trig : trigs) {
+    auto outer = trig * outer_radius;
+    auto inner = trig * inner_radius;
+    *quadrant_1++ = {center.x - outer.x, center.y - outer.y};
+    *quadrant_1++ = {center.x - inner.x, center.y - inner.y};
+    *quadrant_2++ = {center.x + outer.y, center.y - outer.x};
+    *quadrant_2++ = {center.x + inner.y, center.y - inner.x};
+    *quadrant_3++ = {center.x + outer.x, center.y + outer.y};
+    *quadrant_3++ = {center.x + inner.x, center.y + inner.y};
+    *quadrant_4++ = {center.x - outer.y, center.y + outer.x};
+    *quadrant_4++ = {center.x - inner.y, center.y + inner.x};
+  }
+}
+
+void Tessellator::WriteRoundCapLine(
+    const Trigs& trigs,
+    const EllipticalVertexGenerator::Data& data,
+    Point* vertices) {
+  auto p0 = data.reference_centers[0];
+  auto p1 = data.reference_centers[1];
+  auto radius = data.radii.width;
+
+  FML_DCHECK(radius == data.radii.height);
+  FML_DCHECK(data.half_width < 0);
+
+  auto along = p1 - p0;
+  along *= radius / along.GetLength();
+  auto across = Point(-along.y, along.x);
+
+  // The second half of the round caps should be iterated in reverse, but
+  // we can instead iterate forward and swap the sin/cos values as they
+  // should be symmetric.
+  Point* second_half = vertices + trigs.size() * 2;
+  for (auto& trig : trigs) {
+    auto relative_along = along * trig.cos;
+    auto relative_across = across * trig.sin;
+    *vertices++ = p0 - relative_along + relative_across;
+    *vertices++ = p0 - relative_along - relative_across;
+
+    relative_along = along * trig.sin;
+    relative_across = across * trig.cos;
+    *second_half++ = p1 + relative_along + relative_across;
+    *second_half++ = p1 + relative_along - relative_across;
+  }
+}
+
+void Tessellator::WriteFilledEllipse(
+    const Trigs& trigs,
+    const EllipticalVertexGenerator::Data& data,
+    Point* vertices) {
+  auto center = data.reference_centers[0];
+  auto radii = data.radii;
+
+  FML_DCHECK(center == data.reference_centers[1]);
+  FML_DCHECK(data.half_width < 0);
+
+  // The second half of the ellipse should be iterated in reverse, but
+  // we can instead iterate forward and swap the sin/cos values of the
+  // trig as the angles should be symmetric.
+  Point* second_half = vertices + trigs.size() * 2;
+  for (auto& trig : trigs) {
+    // Quadrant 1 connecting with Quadrant 4:
+    auto offset = trig * radii;
+    *vertices++ = {center.x - offset.x, center.y + offset.y};
+    *vertices++ = {center.x - offset.x, center.y - offset.y};
+
+    // Quadrant 2 connecting with Quadrant 3:
+    offset = Point(trig.sin * radii.width, trig.cos * radii.height);
+    *second_half++ = {center.x + offset.x, center.y + offset.y};
+    *second_half++ = {center.x + offset.x, center.y - offset.y};
+  }
+}
+
+void Tessellator::WriteFilledRoundRect(
+    const Trigs& trigs,
+    const EllipticalVertexGenerator::Data& data,
+    Point* vertices) {
+  Scalar left = data.reference_centers[0].x;
+  Scalar top = data.reference_centers[0].y;
+  Scalar right = data.reference_centers[1].x;
+  Scalar bottom = data.reference_centers[1].y;
+  auto radii = data.radii;
+
+  FML_DCHECK(data.half_width < 0);
+
+  // The second half of the round rect should be iterated in reverse, but
+  // we can instead iterate forward and swap the sin/cos values of the
+  // trig as the angles should be symmetric.
+  Point* second_half = vertices + trigs.size() * 2;
+  for (auto& trig : trigs) {
+    // Quadrant 1 connecting with Quadrant 4:
+    auto offset = trig * radii;
+    *vertices++ = {left - offset.x, bottom + offset.y};
+    *vertices++ = {left - offset.x, top - offset.y};
+
+    // Quadrant 2 connecting with Quadrant 3:
+    offset = Point(trig.sin * radii.width, trig.cos * radii.height);
+    *second_half++ = {right + offset.x, bottom + offset.y};
+    *second_half++ = {right + offset.x, top - offset.y};
+  }
+}
+
 }  // namespace impeller
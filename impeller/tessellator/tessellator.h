@@ -81,8 +81,9 @@ class Tessellator {
   using TessellatedVertexProc = std::function<void(const Point& p)>;
 
   /// @brief  An object which produces a list of vertices as |Point|s that
-  ///         tessellate a previously provided shape and delivers the vertices
-  ///         through a |TessellatedVertexProc| callback.
+  ///         tessellate a previously provided shape and either writes them
+  ///         directly into a caller supplied buffer or delivers them through
+  ///         a |TessellatedVertexProc| callback.
   ///
   ///         The object can also provide advance information on how many
   ///         vertices it will generate.
@@ -116,7 +117,19 @@ class Tessellator {
     /// @brief  Generate the vertices and deliver them in the necessary
     ///         order (as required by the PrimitiveType) to the given
     ///         callback function.
+    ///
+    ///         This invokes the callback once per vertex, prefer
+    ///         |GenerateVerticesInto| when the vertices are being written
+    ///         to a buffer.
     virtual void GenerateVertices(const TessellatedVertexProc& proc) const = 0;
+
+    /// @brief  Generate the vertices in the necessary order (as required by
+    ///         the PrimitiveType) directly into the indicated buffer, which
+    ///         must have room for |GetVertexCount| points.
+    ///
+    /// @return The number of vertices written, which may be less than
+    ///         |GetVertexCount|.
+    virtual size_t GenerateVerticesInto(Point* vertices) const = 0;
   };
 
   /// @brief  The |VertexGenerator| implementation common to all shapes
@@ -138,6 +151,12 @@ class Tessellator {
       impl_(trigs_, data_, proc);
     }
 
+    /// |VertexGenerator|
+    size_t GenerateVerticesInto(Point* vertices) const override {
+      writer_(trigs_, data_, vertices);
+      return GetVertexCount();
+    }
+
    private:
     friend class Tessellator;
 
@@ -158,12 +177,19 @@ class Tessellator {
                                const Data& data,
                                const TessellatedVertexProc& proc);
 
+    /// Writes exactly |trigs.size() * vertices_per_trig| vertices.
+    typedef void WriterProc(const Trigs& trigs,
+                            const Data& data,
+                            Point* vertices);
+
     GeneratorProc& impl_;
+    WriterProc& writer_;
     const Trigs trigs_;
     const Data data_;
     const size_t vertices_per_trig_;
 
     EllipticalVertexGenerator(GeneratorProc& generator,
+                              WriterProc& writer,
                               Trigs&& trigs,
                               PrimitiveType triangle_type,
                               size_t vertices_per_trig,
@@ -346,6 +372,26 @@ class Tessellator {
       const EllipticalVertexGenerator::Data& data,
       const TessellatedVertexProc& proc);
 
+  static void WriteFilledCircle(const Trigs& trigs,
+                                const EllipticalVertexGenerator::Data& data,
+                                Point* vertices);
+
+  static void WriteStrokedCircle(const Trigs& trigs,
+                                 const EllipticalVertexGenerator::Data& data,
+                                 Point* vertices);
+
+  static void WriteRoundCapLine(const Trigs& trigs,
+                                const EllipticalVertexGenerator::Data& data,
+                                Point* vertices);
+
+  static void WriteFilledEllipse(const Trigs& trigs,
+                                 const EllipticalVertexGenerator::Data& data,
+                                 Point* vertices);
+
+  static void WriteFilledRoundRect(const Trigs& trigs,
+                                   const EllipticalVertexGenerator::Data& data,
+                                   Point* vertices);
+
   Tessellator(const Tessellator&) = delete;
 
   Tessellator& operator=(const Tessellator&) = delete;
@@ -496,6 +496,41 @@ TEST(TessellatorTest, FilledRoundRectTessellationVertices) {
        Rect::MakeXYWH(5000, 10000, 2000, 3000), {50, 70});
 }
 
+TEST(TessellatorTest, GenerateVerticesIntoMatchesCallbackVertices) {
+  auto tessellator = std::make_shared<Tessellator>();
+  Matrix transform = Matrix::MakeScale({3.0, 3.0, 1.0});
+
+  // The callback path generates each quadrant in order, one vertex at a
+  // time, independently of the single pass writers.
+  auto test = [](const Tessellator::VertexGenerator& generator) {
+    std::vector<Point> callback_vertices;
+    generator.GenerateVertices([&callback_vertices](const Point& p) {  //
+      callback_vertices.push_back(p);
+    });
+
+    // Leave room past the end to catch writes beyond the vertex count.
+    std::vector<Point> bulk_vertices(generator.GetVertexCount() + 1,
+                                     Point(-1, -1));
+    size_t count = generator.GenerateVerticesInto(bulk_vertices.data());
+    EXPECT_EQ(count, generator.GetVertexCount());
+    EXPECT_EQ(bulk_vertices.back(), Point(-1, -1));
+    ASSERT_EQ(callback_vertices.size(), count);
+    for (size_t i = 0; i < count; i++) {
+      EXPECT_EQ(bulk_vertices[i], callback_vertices[i]) << "vertex " << i;
+    }
+  };
+
+  test(tessellator->FilledCircle(transform, {10, 10}, 20));
+  test(tessellator->StrokedCircle(transform, {10, 10}, 20, 4));
+  test(tessellator->RoundCapLine(transform, {10, 10}, {50, 30}, 5));
+  test(tessellator->FilledEllipse(transform,
+                                  Rect::MakeLTRB(10, 10, 100, 50)));
+  test(tessellator->FilledRoundRect(
+      transform, Rect::MakeLTRB(10, 10, 100, 50), Size(10, 5)));
+  // Large enough to require divisions beyond the precomputed trigs.
+  test(tessellator->FilledCircle(transform, {0, 0}, 5000));
+}
+
 TEST(TessellatorTest, EarlyReturnEmptyConvexShape) {
   // This path is not technically empty (it has a size in one dimension),
   // but is otherwise completely flat.
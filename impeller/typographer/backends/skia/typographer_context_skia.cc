@@ -4,9 +4,15 @@
 
 #include "impeller/typographer/backends/skia/typographer_context_skia.h"
 
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <condition_variable>
 #include <cstddef>
 #include <cstdint>
+#include <functional>
 #include <memory>
+#include <mutex>
 #include <numeric>
 #include <utility>
 #include <vector>
@@ -74,11 +80,15 @@ SkPaint::Join ToSkiaJoin(Join join) {
 }
 }  // namespace
 
-std::shared_ptr<TypographerContext> TypographerContextSkia::Make() {
-  return std::make_shared<TypographerContextSkia>();
+std::shared_ptr<TypographerContext> TypographerContextSkia::Make(
+    std::shared_ptr<fml::ConcurrentTaskRunner> worker_task_runner) {
+  return std::make_shared<TypographerContextSkia>(
+      std::move(worker_task_runner));
 }
 
-TypographerContextSkia::TypographerContextSkia() = default;
+TypographerContextSkia::TypographerContextSkia(
+    std::shared_ptr<fml::ConcurrentTaskRunner> worker_task_runner)
+    : worker_task_runner_(std::move(worker_task_runner)) {}
 
 TypographerContextSkia::~TypographerContextSkia() = default;
 
@@ -171,6 +181,7 @@ static ISize ComputeNextAtlasSize(
     const std::vector<Rect>& glyph_sizes,
     size_t glyph_index_start,
     int64_t max_texture_height) {
+  TRACE_EVENT0("impeller", __FUNCTION__);
   // Because we can't grow the skyline packer horizontally, pick a reasonable
   // large width for all atlases.
   static constexpr int64_t kAtlasWidth = 4096;
@@ -205,6 +216,151 @@ static ISize ComputeNextAtlasSize(
   return {};
 }
 
+/// The size of the pages that a full atlas is divided into. Once the atlas
+/// cannot grow any further, space for new glyphs is made by evicting all of
+/// the glyphs in the least recently used page.
+static constexpr int kAtlasPageSize = 512;
+
+/// Append the glyphs of [extra_pairs] from [start_index] to an atlas that
+/// cannot grow any further, evicting the glyphs in the least recently used
+/// pages of the atlas to make room for them. Pages used by the current frame
+/// are never evicted.
+///
+/// Returns the first index of [extra_pairs] that could not be placed.
+static size_t EvictAndAppendToExistingAtlas(
+    GlyphAtlasContext& atlas_context,
+    GlyphAtlas& atlas,
+    const std::vector<FontGlyphPair>& extra_pairs,
+    std::vector<Rect>& glyph_positions,
+    const std::vector<Rect>& glyph_sizes,
+    size_t start_index) {
+  TRACE_EVENT0("impeller", __FUNCTION__);
+  const std::shared_ptr<PagedRectanglePacker>& rect_packer =
+      atlas_context.GetPagedRectPacker();
+  FML_DCHECK(!!rect_packer);
+  // The glyphs that were just appended are used by the current frame too.
+  for (size_t i = 0u; i < start_index; i++) {
+    atlas_context.MarkAtlasRegionUsed(glyph_positions[i]);
+  }
+
+  size_t evicted_count = 0u;
+  size_t index = start_index;
+  while (index < extra_pairs.size()) {
+    size_t next_index = PairsFitInAtlasOfSize(
+        extra_pairs, atlas_context.GetAtlasSize(), glyph_positions,
+        glyph_sizes, /*height_adjustment=*/0, rect_packer, index);
+    for (size_t i = index; i < next_index; i++) {
+      atlas.AddTypefaceGlyphPositionAndBounds(
+          extra_pairs[i], glyph_positions[i], glyph_sizes[i]);
+      atlas_context.MarkAtlasRegionUsed(glyph_positions[i]);
+    }
+    index = next_index;
+    if (index == extra_pairs.size()) {
+      break;
+    }
+
+    ISize glyph_size = ISize::Ceil(glyph_sizes[index].GetSize());
+    if (glyph_size.width + kPadding > kAtlasPageSize ||
+        glyph_size.height + kPadding > kAtlasPageSize) {
+      break;
+    }
+    std::optional<size_t> page = atlas_context.FindLeastRecentlyUsedPage();
+    if (!page.has_value()) {
+      break;
+    }
+    evicted_count += atlas.RemoveGlyphsInRegion(
+        Rect::Make(rect_packer->GetPageBounds(page.value())));
+    rect_packer->ResetPage(page.value());
+  }
+
+  if (evicted_count > 0u) {
+    // Text frames may still refer to the locations of the evicted glyphs.
+    atlas.SetAtlasGeneration(atlas.GetAtlasGeneration() + 1);
+    atlas_context.RecordEvictedGlyphs(evicted_count);
+  }
+  return index;
+}
+
+/// The maximum number of partitions the new glyphs are split into for
+/// rasterization.
+static constexpr size_t kMaxGlyphRasterPartitions = 4u;
+
+/// Below this many glyphs per partition the cost of handing the work to
+/// the workers outweighs rasterizing on the calling thread.
+static constexpr size_t kMinGlyphsPerRasterPartition = 32u;
+
+static size_t ComputeGlyphRasterPartitionCount(
+    const std::shared_ptr<fml::ConcurrentTaskRunner>& worker_task_runner,
+    size_t glyph_count) {
+  if (!worker_task_runner) {
+    return 1u;
+  }
+  return std::clamp<size_t>(glyph_count / kMinGlyphsPerRasterPartition, 1u,
+                            kMaxGlyphRasterPartitions);
+}
+
+/// @brief Invoke |rasterize| once for each partition in
+///        [0, partition_count) and return once all of them have completed.
+///
+/// The calling thread claims partitions alongside the workers, so all of
+/// the work is still done (serially) if the workers are busy or the task
+/// runner has been shut down. Worker tasks that start after every
+/// partition has been claimed return without touching |rasterize|.
+static void RasterizePartitions(
+    const std::shared_ptr<fml::ConcurrentTaskRunner>& worker_task_runner,
+    size_t partition_count,
+    const std::function<void(size_t partition)>& rasterize) {
+  if (partition_count <= 1u || !worker_task_runner) {
+    for (size_t i = 0; i < partition_count; i++) {
+      rasterize(i);
+    }
+    return;
+  }
+
+  struct State {
+    State(const std::function<void(size_t)>& rasterize, size_t count)
+        : rasterize(rasterize), partition_count(count) {}
+
+    const std::function<void(size_t)>& rasterize;
+    const size_t partition_count;
+    std::atomic<size_t> next_partition = 0u;
+    std::mutex mutex;
+    std::condition_variable completed_condition;
+    size_t completed_count = 0u;
+
+    void RunAvailablePartitions() {
+      size_t completed = 0u;
+      while (true) {
+        size_t partition = next_partition.fetch_add(1u);
+        if (partition >= partition_count) {
+          break;
+        }
+        rasterize(partition);
+        completed++;
+      }
+      if (completed > 0u) {
+        std::scoped_lock lock(mutex);
+        completed_count += completed;
+        if (completed_count == partition_count) {
+          completed_condition.notify_all();
+        }
+      }
+    }
+  };
+
+  auto state = std::make_shared<State>(rasterize, partition_count);
+  for (size_t i = 1; i < partition_count; i++) {
+    worker_task_runner->PostTask(
+        [state]() { state->RunAvailablePartitions(); });
+  }
+  state->RunAvailablePartitions();
+
+  std::unique_lock lock(state->mutex);
+  state->completed_condition.wait(lock, [&state]() {
+    return state->completed_count == state->partition_count;
+  });
+}
+
 static void DrawGlyph(SkCanvas* canvas,
                       const SkPoint position,
                       const ScaledFont& scaled_font,
@@ -252,13 +408,21 @@ static void DrawGlyph(SkCanvas* canvas,
 /// @brief Batch render to a single surface.
 ///
 /// This is only safe for use when updating a fresh texture.
-static bool BulkUpdateAtlasBitmap(const GlyphAtlas& atlas,
-                                  std::shared_ptr<BlitPass>& blit_pass,
-                                  HostBuffer& host_buffer,
-                                  const std::shared_ptr<Texture>& texture,
-                                  const std::vector<FontGlyphPair>& new_pairs,
-                                  size_t start_index,
-                                  size_t end_index) {
+///
+/// When there are enough glyphs, the bitmap is split into horizontal bands
+/// that are rasterized concurrently. Each band is drawn through its own
+/// surface that wraps only the rows of that band, so the partitions write
+/// to disjoint memory. Glyphs that straddle a band boundary are drawn by
+/// both bands, each clipped to its own rows.
+static bool BulkUpdateAtlasBitmap(
+    const GlyphAtlas& atlas,
+    std::shared_ptr<BlitPass>& blit_pass,
+    HostBuffer& host_buffer,
+    const std::shared_ptr<Texture>& texture,
+    const std::vector<FontGlyphPair>& new_pairs,
+    size_t start_index,
+    size_t end_index,
+    const std::shared_ptr<fml::ConcurrentTaskRunner>& worker_task_runner) {
   TRACE_EVENT0("impeller", __FUNCTION__);
 
   bool has_color = atlas.GetType() == GlyphAtlas::Type::kColorBitmap;
@@ -269,15 +433,14 @@ static bool BulkUpdateAtlasBitmap(const GlyphAtlas& atlas,
     return false;
   }
 
-  auto surface = SkSurfaces::WrapPixels(bitmap.pixmap());
-  if (!surface) {
-    return false;
-  }
-  auto canvas = surface->getCanvas();
-  if (!canvas) {
-    return false;
-  }
-
+  struct GlyphDraw {
+    const FontGlyphPair* pair;
+    Rect position;
+    Rect bounds;
+  };
+  std::vector<GlyphDraw> draws;
+  draws.reserve(end_index - start_index);
+  int32_t used_height = 0;
   for (size_t i = start_index; i < end_index; i++) {
     const FontGlyphPair& pair = new_pairs[i];
     auto data = atlas.FindFontGlyphBounds(pair);
@@ -290,12 +453,71 @@ static bool BulkUpdateAtlasBitmap(const GlyphAtlas& atlas,
     if (size.IsEmpty()) {
       continue;
     }
-
-    DrawGlyph(canvas, SkPoint::Make(pos.GetLeft(), pos.GetTop()),
-              pair.scaled_font, pair.glyph, bounds, pair.glyph.properties,
-              has_color);
+    draws.push_back({.pair = &pair, .position = pos, .bounds = bounds});
+    used_height =
+        std::max(used_height, static_cast<int32_t>(std::ceil(pos.GetBottom())));
+  }
+  used_height = std::min(used_height + 1, bitmap.height());
+
+  size_t partition_count =
+      ComputeGlyphRasterPartitionCount(worker_task_runner, draws.size());
+  int32_t band_height =
+      (used_height + static_cast<int32_t>(partition_count) - 1) /
+      static_cast<int32_t>(partition_count);
+
+  std::atomic<bool> rasterized = true;
+  {
+    TRACE_EVENT1("impeller", "RasterizeGlyphs", "partitions",
+                 std::to_string(partition_count).c_str());
+    RasterizePartitions(
+        worker_task_runner, partition_count, [&](size_t partition) {
+          int32_t top = static_cast<int32_t>(partition) * band_height;
+          int32_t bottom = std::min(top + band_height, bitmap.height());
+          if (partition_count == 1u) {
+            // A single partition covers the whole bitmap.
+            top = 0;
+            bottom = bitmap.height();
+          }
+          if (top >= bottom) {
+            return;
+          }
+          SkPixmap band;
+          if (!bitmap.pixmap().extractSubset(
+                  &band, SkIRect::MakeLTRB(0, top, bitmap.width(), bottom))) {
+            rasterized = false;
+            return;
+          }
+          auto surface = SkSurfaces::WrapPixels(band);
+          if (!surface) {
+            rasterized = false;
+            return;
+          }
+          auto canvas = surface->getCanvas();
+          if (!canvas) {
+            rasterized = false;
+            return;
+          }
+          canvas->translate(0, -top);
+          for (const GlyphDraw& draw : draws) {
+            // Include the 1px of padding around the glyph so that any
+            // coverage that lands in it is drawn by the owning band.
+            if (draw.position.GetBottom() + 1 <= top ||
+                draw.position.GetTop() - 1 >= bottom) {
+              continue;
+            }
+            DrawGlyph(canvas,
+                      SkPoint::Make(draw.position.GetLeft(),
+                                    draw.position.GetTop()),
+                      draw.pair->scaled_font, draw.pair->glyph, draw.bounds,
+                      draw.pair->glyph.properties, has_color);
+          }
+        });
+  }
+  if (!rasterized) {
+    return false;
   }
 
+  TRACE_EVENT0("impeller", "UploadGlyphAtlas");
   // Writing to a malloc'd buffer and then copying to the staging buffers
   // benchmarks as substantially faster on a number of Android devices.
   BufferView buffer_view = host_buffer.Emplace(
@@ -311,17 +533,32 @@ static bool BulkUpdateAtlasBitmap(const GlyphAtlas& atlas,
                                             texture->GetSize().height));
 }
 
-static bool UpdateAtlasBitmap(const GlyphAtlas& atlas,
-                              std::shared_ptr<BlitPass>& blit_pass,
-                              HostBuffer& host_buffer,
-                              const std::shared_ptr<Texture>& texture,
-                              const std::vector<FontGlyphPair>& new_pairs,
-                              size_t start_index,
-                              size_t end_index) {
+/// @brief Render each new glyph into its own bitmap and upload it into its
+///        position in an existing texture.
+///
+/// The glyphs are rasterized (in parallel when there are enough of them)
+/// before any of them are uploaded.
+static bool UpdateAtlasBitmap(
+    const GlyphAtlas& atlas,
+    std::shared_ptr<BlitPass>& blit_pass,
+    HostBuffer& host_buffer,
+    const std::shared_ptr<Texture>& texture,
+    const std::vector<FontGlyphPair>& new_pairs,
+    size_t start_index,
+    size_t end_index,
+    const std::shared_ptr<fml::ConcurrentTaskRunner>& worker_task_runner) {
   TRACE_EVENT0("impeller", __FUNCTION__);
 
   bool has_color = atlas.GetType() == GlyphAtlas::Type::kColorBitmap;
 
+  struct GlyphDraw {
+    const FontGlyphPair* pair;
+    Rect position;
+    Rect bounds;
+    SkBitmap bitmap;
+  };
+  std::vector<GlyphDraw> draws;
+  draws.reserve(end_index - start_index);
   for (size_t i = start_index; i < end_index; i++) {
     const FontGlyphPair& pair = new_pairs[i];
     auto data = atlas.FindFontGlyphBounds(pair);
@@ -331,37 +568,67 @@ static bool UpdateAtlasBitmap(const GlyphAtlas& atlas,
     auto [pos, bounds, placeholder] = data.value();
     FML_DCHECK(!placeholder);
 
-    Size size = pos.GetSize();
-    if (size.IsEmpty()) {
+    if (pos.GetSize().IsEmpty()) {
       continue;
     }
-    // The uploaded bitmap is expanded by 1px of padding
-    // on each side.
-    size.width += 2;
-    size.height += 2;
-
-    SkBitmap bitmap;
-    bitmap.setInfo(GetImageInfo(atlas, size));
-    if (!bitmap.tryAllocPixels()) {
-      return false;
-    }
+    draws.push_back({.pair = &pair, .position = pos, .bounds = bounds});
+  }
 
-    auto surface = SkSurfaces::WrapPixels(bitmap.pixmap());
-    if (!surface) {
-      return false;
-    }
-    auto canvas = surface->getCanvas();
-    if (!canvas) {
-      return false;
-    }
+  size_t partition_count =
+      ComputeGlyphRasterPartitionCount(worker_task_runner, draws.size());
+  size_t glyphs_per_partition =
+      (draws.size() + partition_count - 1) / partition_count;
+
+  std::atomic<bool> rasterized = true;
+  {
+    TRACE_EVENT1("impeller", "RasterizeGlyphs", "partitions",
+                 std::to_string(partition_count).c_str());
+    RasterizePartitions(
+        worker_task_runner, partition_count, [&](size_t partition) {
+          size_t begin = partition * glyphs_per_partition;
+          size_t end = std::min(begin + glyphs_per_partition, draws.size());
+          for (size_t i = begin; i < end; i++) {
+            GlyphDraw& draw = draws[i];
+            // The uploaded bitmap is expanded by 1px of padding
+            // on each side.
+            Size size = draw.position.GetSize() + Size(2, 2);
+
+            draw.bitmap.setInfo(GetImageInfo(atlas, size));
+            if (!draw.bitmap.tryAllocPixels()) {
+              rasterized = false;
+              return;
+            }
+
+            auto surface = SkSurfaces::WrapPixels(draw.bitmap.pixmap());
+            if (!surface) {
+              rasterized = false;
+              return;
+            }
+            auto canvas = surface->getCanvas();
+            if (!canvas) {
+              rasterized = false;
+              return;
+            }
+
+            DrawGlyph(canvas, SkPoint::Make(1, 1), draw.pair->scaled_font,
+                      draw.pair->glyph, draw.bounds,
+                      draw.pair->glyph.properties, has_color);
+          }
+        });
+  }
+  if (!rasterized) {
+    return false;
+  }
 
-    DrawGlyph(canvas, SkPoint::Make(1, 1), pair.scaled_font, pair.glyph, bounds,
-              pair.glyph.properties, has_color);
+  TRACE_EVENT0("impeller", "UploadGlyphAtlas");
+  for (const GlyphDraw& draw : draws) {
+    const Rect& pos = draw.position;
+    Size size = pos.GetSize() + Size(2, 2);
 
     // Writing to a malloc'd buffer and then copying to the staging buffers
     // benchmarks as substantially faster on a number of Android devices.
     BufferView buffer_view = host_buffer.Emplace(
-        bitmap.getAddr(0, 0),
+        draw.bitmap.getAddr(0, 0),
         size.Area() * BytesPerPixelForPixelFormat(
                           atlas.GetTexture()->GetTextureDescriptor().format),
         DefaultUniformAlignment());
@@ -412,6 +679,7 @@ std::pair<std::vector<FontGlyphPair>, std::vector<Rect>>
 TypographerContextSkia::CollectNewGlyphs(
     const std::shared_ptr<GlyphAtlas>& atlas,
     const std::vector<std::shared_ptr<TextFrame>>& text_frames) {
+  TRACE_EVENT0("impeller", __FUNCTION__);
   std::vector<FontGlyphPair> new_glyphs;
   std::vector<Rect> glyph_sizes;
   size_t generation_id = atlas->GetAtlasGeneration();
@@ -481,6 +749,40 @@ TypographerContextSkia::CollectNewGlyphs(
   return {std::move(new_glyphs), std::move(glyph_sizes)};
 }
 
+void TypographerContextSkia::MarkUsedAtlasPages(
+    const GlyphAtlas& atlas,
+    GlyphAtlasContext& atlas_context,
+    const std::vector<std::shared_ptr<TextFrame>>& text_frames) {
+  TRACE_EVENT0("impeller", __FUNCTION__);
+  for (const auto& frame : text_frames) {
+    size_t bounds_index = 0u;
+    for (const auto& run : frame->GetRuns()) {
+      ScaledFont scaled_font{
+          .font = run.GetFont(),
+          .scale = TextFrame::RoundScaledFontSize(frame->GetScale())};
+      for (const auto& glyph_position : run.GetGlyphPositions()) {
+        const FrameBounds& bounds = frame->GetFrameBounds(bounds_index++);
+        if (!bounds.is_placeholder) {
+          atlas_context.MarkAtlasRegionUsed(bounds.atlas_bounds);
+          continue;
+        }
+        // The glyph may have been placed after the frame was collected, in
+        // which case the frame is drawn using the location in the atlas.
+        Point subpixel = TextFrame::ComputeSubpixelPosition(
+            glyph_position, scaled_font.font.GetAxisAlignment(),
+            frame->GetOffset(), frame->GetScale());
+        std::optional<FrameBounds> atlas_bounds =
+            atlas.FindFontGlyphBounds(FontGlyphPair{
+                scaled_font, SubpixelGlyph(glyph_position.glyph, subpixel,
+                                           frame->GetProperties())});
+        if (atlas_bounds.has_value() && !atlas_bounds->is_placeholder) {
+          atlas_context.MarkAtlasRegionUsed(atlas_bounds->atlas_bounds);
+        }
+      }
+    }
+  }
+}
+
 std::shared_ptr<GlyphAtlas> TypographerContextSkia::CreateGlyphAtlas(
     Context& context,
     GlyphAtlas::Type type,
@@ -498,16 +800,31 @@ std::shared_ptr<GlyphAtlas> TypographerContextSkia::CreateGlyphAtlas(
     return last_atlas;
   }
 
+  atlas_context->BeginFrame();
+  fml::ScopedCleanupClosure report_statistics([&atlas_context]() {
+    FML_TRACE_COUNTER(
+        "impeller", "GlyphAtlas",
+        reinterpret_cast<int64_t>(atlas_context.get()),  // Trace Counter ID
+        "Rasterized", atlas_context->GetFrameRasterizedGlyphCount(),  //
+        "Evicted", atlas_context->GetFrameEvictedGlyphCount());
+  });
+
   // ---------------------------------------------------------------------------
   // Step 1: Determine if the atlas type and font glyph pairs are compatible
   //         with the current atlas and reuse if possible. For each new font and
   //         glyph pair, compute the glyph size at scale.
   // ---------------------------------------------------------------------------
   auto [new_glyphs, glyph_sizes] = CollectNewGlyphs(last_atlas, text_frames);
+  if (atlas_context->GetPagedRectPacker()) {
+    MarkUsedAtlasPages(*last_atlas, *atlas_context, text_frames);
+  }
   if (new_glyphs.size() == 0) {
     return last_atlas;
   }
 
+  const int64_t max_texture_height =
+      context.GetResourceAllocator()->GetMaxTextureSizeSupported().height;
+
   // ---------------------------------------------------------------------------
   // Step 2: Determine if the additional missing glyphs can be appended to the
   //         existing bitmap without recreating the atlas.
@@ -532,6 +849,29 @@ std::shared_ptr<GlyphAtlas> TypographerContextSkia::CreateGlyphAtlas(
           new_glyphs[i], glyph_positions[i], glyph_sizes[i]);
     }
 
+    // ---------------------------------------------------------------------------
+    // Step 3b: If the atlas is as big as it can get, make room for the
+    //          remaining glyphs by evicting the glyphs that have gone the
+    //          longest without being used.
+    // ---------------------------------------------------------------------------
+    if (first_missing_index < new_glyphs.size() &&
+        atlas_context->GetAtlasSize().height >= max_texture_height) {
+      if (!atlas_context->GetPagedRectPacker()) {
+        // The pages start out closed as the glyphs already in the atlas
+        // may straddle them. Evicting a page removes every glyph that
+        // overlaps it.
+        const ISize& atlas_size = atlas_context->GetAtlasSize();
+        atlas_context->UpdatePagedRectPacker(
+            std::make_shared<PagedRectanglePacker>(
+                atlas_size.width, atlas_size.height, kAtlasPageSize,
+                kAtlasPageSize));
+        MarkUsedAtlasPages(*last_atlas, *atlas_context, text_frames);
+      }
+      first_missing_index = EvictAndAppendToExistingAtlas(
+          *atlas_context, *last_atlas, new_glyphs, glyph_positions,
+          glyph_sizes, first_missing_index);
+    }
+
     std::shared_ptr<CommandBuffer> cmd_buffer = context.CreateCommandBuffer();
     std::shared_ptr<BlitPass> blit_pass = cmd_buffer->CreateBlitPass();
 
@@ -548,9 +888,10 @@ std::shared_ptr<GlyphAtlas> TypographerContextSkia::CreateGlyphAtlas(
     // ---------------------------------------------------------------------------
     if (!UpdateAtlasBitmap(*last_atlas, blit_pass, host_buffer,
                            last_atlas->GetTexture(), new_glyphs, 0,
-                           first_missing_index)) {
+                           first_missing_index, worker_task_runner_)) {
       return nullptr;
     }
+    atlas_context->RecordRasterizedGlyphs(first_missing_index);
 
     // If all glyphs fit, just return the old atlas.
     if (first_missing_index == new_glyphs.size()) {
@@ -559,10 +900,9 @@ std::shared_ptr<GlyphAtlas> TypographerContextSkia::CreateGlyphAtlas(
   }
 
   int64_t height_adjustment = atlas_context->GetAtlasSize().height;
-  const int64_t max_texture_height =
-      context.GetResourceAllocator()->GetMaxTextureSizeSupported().height;
 
-  // IF the current atlas size is as big as it can get, then "GC" and create an
+  // IF the current atlas size is as big as it can get and evicting the least
+  // recently used glyphs did not make enough room, then "GC" and create an
   // atlas with only the required glyphs. OpenGLES cannot reliably perform the
   // blit required here, as 1) it requires attaching textures as read and write
   // framebuffers which has substantially smaller size limits that max textures
@@ -654,9 +994,12 @@ std::shared_ptr<GlyphAtlas> TypographerContextSkia::CreateGlyphAtlas(
   // ---------------------------------------------------------------------------
   if (!BulkUpdateAtlasBitmap(*new_atlas, blit_pass, host_buffer,
                              new_atlas->GetTexture(), new_glyphs,
-                             first_missing_index, new_glyphs.size())) {
+                             first_missing_index, new_glyphs.size(),
+                             worker_task_runner_)) {
     return nullptr;
   }
+  atlas_context->RecordRasterizedGlyphs(new_glyphs.size() -
+                                        first_missing_index);
 
   // Blit the old texture to the top left of the new atlas.
   if (blit_old_atlas && old_texture) {
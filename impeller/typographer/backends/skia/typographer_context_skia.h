@@ -5,15 +5,29 @@
 #ifndef FLUTTER_IMPELLER_TYPOGRAPHER_BACKENDS_SKIA_TYPOGRAPHER_CONTEXT_SKIA_H_
 #define FLUTTER_IMPELLER_TYPOGRAPHER_BACKENDS_SKIA_TYPOGRAPHER_CONTEXT_SKIA_H_
 
+#include <memory>
+
+#include "flutter/fml/concurrent_message_loop.h"
 #include "impeller/typographer/typographer_context.h"
 
 namespace impeller {
 
 class TypographerContextSkia : public TypographerContext {
  public:
-  static std::shared_ptr<TypographerContext> Make();
+  //----------------------------------------------------------------------------
+  /// @brief      Create a typographer context.
+  ///
+  /// @param[in]  worker_task_runner  If not null, the task runner whose
+  ///                                 workers are used to rasterize new
+  ///                                 glyphs in parallel. Glyphs are
+  ///                                 rasterized on the calling thread
+  ///                                 otherwise.
+  ///
+  static std::shared_ptr<TypographerContext> Make(
+      std::shared_ptr<fml::ConcurrentTaskRunner> worker_task_runner = nullptr);
 
-  TypographerContextSkia();
+  explicit TypographerContextSkia(
+      std::shared_ptr<fml::ConcurrentTaskRunner> worker_task_runner = nullptr);
 
   ~TypographerContextSkia() override;
 
@@ -31,10 +45,20 @@ class TypographerContextSkia : public TypographerContext {
       const override;
 
  private:
+  std::shared_ptr<fml::ConcurrentTaskRunner> worker_task_runner_;
+
   static std::pair<std::vector<FontGlyphPair>, std::vector<Rect>>
   CollectNewGlyphs(const std::shared_ptr<GlyphAtlas>& atlas,
                    const std::vector<std::shared_ptr<TextFrame>>& text_frames);
 
+  /// Record that the pages of a full atlas that hold the glyphs of
+  /// |text_frames| are used by the current frame so that they are not
+  /// evicted.
+  static void MarkUsedAtlasPages(
+      const GlyphAtlas& atlas,
+      GlyphAtlasContext& atlas_context,
+      const std::vector<std::shared_ptr<TextFrame>>& text_frames);
+
   TypographerContextSkia(const TypographerContextSkia&) = delete;
 
   TypographerContextSkia& operator=(const TypographerContextSkia&) = delete;
@@ -44,6 +44,69 @@ void GlyphAtlasContext::UpdateGlyphAtlas(std::shared_ptr<GlyphAtlas> atlas,
 void GlyphAtlasContext::UpdateRectPacker(
     std::shared_ptr<RectanglePacker> rect_packer) {
   rect_packer_ = std::move(rect_packer);
+  paged_rect_packer_.reset();
+  page_last_used_.clear();
+}
+
+const std::shared_ptr<PagedRectanglePacker>&
+GlyphAtlasContext::GetPagedRectPacker() const {
+  return paged_rect_packer_;
+}
+
+void GlyphAtlasContext::UpdatePagedRectPacker(
+    std::shared_ptr<PagedRectanglePacker> packer) {
+  UpdateRectPacker(packer);
+  height_adjustment_ = 0;
+  if (packer) {
+    page_last_used_.assign(packer->GetPageCount(), 0u);
+  }
+  paged_rect_packer_ = std::move(packer);
+}
+
+void GlyphAtlasContext::BeginFrame() {
+  frame_++;
+  frame_rasterized_glyph_count_ = 0u;
+  frame_evicted_glyph_count_ = 0u;
+}
+
+void GlyphAtlasContext::MarkAtlasRegionUsed(const Rect& region) {
+  if (!paged_rect_packer_) {
+    return;
+  }
+  // Include the 1px of padding around the glyph.
+  paged_rect_packer_->VisitPagesInRect(
+      IRect::RoundOut(region).Expand(1),
+      [this](size_t page) { page_last_used_[page] = frame_; });
+}
+
+std::optional<size_t> GlyphAtlasContext::FindLeastRecentlyUsedPage() const {
+  std::optional<size_t> result;
+  for (size_t i = 0u; i < page_last_used_.size(); i++) {
+    if (page_last_used_[i] >= frame_) {
+      continue;
+    }
+    if (!result.has_value() ||
+        page_last_used_[i] < page_last_used_[result.value()]) {
+      result = i;
+    }
+  }
+  return result;
+}
+
+void GlyphAtlasContext::RecordRasterizedGlyphs(size_t count) {
+  frame_rasterized_glyph_count_ += count;
+}
+
+void GlyphAtlasContext::RecordEvictedGlyphs(size_t count) {
+  frame_evicted_glyph_count_ += count;
+}
+
+size_t GlyphAtlasContext::GetFrameRasterizedGlyphCount() const {
+  return frame_rasterized_glyph_count_;
+}
+
+size_t GlyphAtlasContext::GetFrameEvictedGlyphCount() const {
+  return frame_evicted_glyph_count_;
 }
 
 GlyphAtlas::GlyphAtlas(Type type, size_t initial_generation)
@@ -100,6 +163,31 @@ FontGlyphAtlas* GlyphAtlas::GetOrCreateFontGlyphAtlas(
   return &iter->second;
 }
 
+size_t GlyphAtlas::RemoveGlyphsInRegion(const Rect& region) {
+  size_t count = 0u;
+  for (auto font_it = font_atlas_map_.begin();
+       font_it != font_atlas_map_.end();) {
+    FontGlyphAtlas::PositionsMap& positions = font_it->second.positions_;
+    for (auto glyph_it = positions.begin(); glyph_it != positions.end();) {
+      const FrameBounds& bounds = glyph_it->second;
+      // Include the 1px of padding around the glyph.
+      if (!bounds.is_placeholder &&
+          bounds.atlas_bounds.Expand(1).IntersectsWithRect(region)) {
+        positions.erase(glyph_it++);
+        count++;
+      } else {
+        ++glyph_it;
+      }
+    }
+    if (positions.empty()) {
+      font_atlas_map_.erase(font_it++);
+    } else {
+      ++font_it;
+    }
+  }
+  return count;
+}
+
 size_t GlyphAtlas::GetGlyphCount() const {
   return std::accumulate(font_atlas_map_.begin(), font_atlas_map_.end(), 0,
                          [](const int a, const auto& b) {
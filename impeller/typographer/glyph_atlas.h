@@ -8,6 +8,7 @@
 #include <functional>
 #include <memory>
 #include <optional>
+#include <vector>
 
 #include "flutter/fml/build_config.h"
 
@@ -176,6 +177,19 @@ class GlyphAtlas {
   ///
   FontGlyphAtlas* GetOrCreateFontGlyphAtlas(const ScaledFont& scaled_font);
 
+  //----------------------------------------------------------------------------
+  /// @brief      Remove every glyph whose location in the atlas, including
+  ///             the padding around it, overlaps the given region.
+  ///
+  ///             Placeholders for glyphs that have not been placed in the
+  ///             atlas yet are kept.
+  ///
+  /// @param[in]  region  The region of the atlas to clear.
+  ///
+  /// @return     The number of glyphs that were removed.
+  ///
+  size_t RemoveGlyphsInRegion(const Rect& region);
+
   //----------------------------------------------------------------------------
   /// @brief      Retrieve the generation id for this glyph atlas.
   ///
@@ -251,11 +265,66 @@ class GlyphAtlasContext {
 
   void UpdateRectPacker(std::shared_ptr<RectanglePacker> rect_packer);
 
+  //----------------------------------------------------------------------------
+  /// @brief      Retrieve the paged rect packer, if the atlas has stopped
+  ///             growing and space is reclaimed by evicting pages instead.
+  const std::shared_ptr<PagedRectanglePacker>& GetPagedRectPacker() const;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Switch the context to a packer that covers the whole atlas
+  ///             and whose least recently used pages can be evicted.
+  ///
+  ///             This also becomes the rect packer and resets the height
+  ///             adjustment, as the packer is not offset from the origin.
+  void UpdatePagedRectPacker(std::shared_ptr<PagedRectanglePacker> packer);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Start tracking page usage and statistics for a new frame.
+  void BeginFrame();
+
+  //----------------------------------------------------------------------------
+  /// @brief      Record that the glyph at the given location, and so every
+  ///             page it overlaps, is used by the current frame.
+  ///
+  ///             Does nothing unless there is a paged rect packer.
+  void MarkAtlasRegionUsed(const Rect& region);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Find the page that has gone the longest without being used.
+  ///
+  /// @return     The page, or `std::nullopt` if there is no paged rect
+  ///             packer or every page is used by the current frame.
+  std::optional<size_t> FindLeastRecentlyUsedPage() const;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Record that glyphs were rasterized into the atlas.
+  void RecordRasterizedGlyphs(size_t count);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Record that glyphs were evicted from the atlas.
+  void RecordEvictedGlyphs(size_t count);
+
+  //----------------------------------------------------------------------------
+  /// @brief      The number of glyphs rasterized since |BeginFrame|,
+  ///             including glyphs that were re-rasterized because the atlas
+  ///             was rebuilt.
+  size_t GetFrameRasterizedGlyphCount() const;
+
+  //----------------------------------------------------------------------------
+  /// @brief      The number of glyphs evicted since |BeginFrame|.
+  size_t GetFrameEvictedGlyphCount() const;
+
  private:
   std::shared_ptr<GlyphAtlas> atlas_;
   ISize atlas_size_;
   std::shared_ptr<RectanglePacker> rect_packer_;
   int64_t height_adjustment_;
+  std::shared_ptr<PagedRectanglePacker> paged_rect_packer_;
+  /// The frame each page of the paged rect packer was last used in.
+  std::vector<uint64_t> page_last_used_;
+  uint64_t frame_ = 0u;
+  size_t frame_rasterized_glyph_count_ = 0u;
+  size_t frame_evicted_glyph_count_ = 0u;
 
   GlyphAtlasContext(const GlyphAtlasContext&) = delete;
 
@@ -177,4 +177,88 @@ std::shared_ptr<RectanglePacker> RectanglePacker::Factory(int width,
   return std::make_shared<SkylineRectanglePacker>(width, height);
 }
 
+PagedRectanglePacker::PagedRectanglePacker(int width,
+                                           int height,
+                                           int page_width,
+                                           int page_height)
+    : RectanglePacker(width, height),
+      page_width_(page_width),
+      page_height_(page_height),
+      columns_(page_width > 0 ? width / page_width : 0),
+      rows_(page_height > 0 ? height / page_height : 0),
+      pages_(static_cast<size_t>(columns_) * rows_) {
+  FML_DCHECK(page_width > 0);
+  FML_DCHECK(page_height > 0);
+}
+
+PagedRectanglePacker::~PagedRectanglePacker() = default;
+
+bool PagedRectanglePacker::AddRect(int p_width, int p_height, IPoint16* loc) {
+  if (p_width > page_width_ || p_height > page_height_) {
+    loc->x_ = 0;
+    loc->y_ = 0;
+    return false;
+  }
+  for (size_t i = 0u; i < pages_.size(); i++) {
+    if (!pages_[i]) {
+      continue;
+    }
+    IPoint16 page_loc;
+    if (pages_[i]->AddRect(p_width, p_height, &page_loc)) {
+      IRect bounds = GetPageBounds(i);
+      loc->x_ = static_cast<int16_t>(bounds.GetLeft() + page_loc.x());
+      loc->y_ = static_cast<int16_t>(bounds.GetTop() + page_loc.y());
+      return true;
+    }
+  }
+  loc->x_ = 0;
+  loc->y_ = 0;
+  return false;
+}
+
+Scalar PagedRectanglePacker::PercentFull() const {
+  if (width() == 0 || height() == 0) {
+    return 0;
+  }
+  Scalar page_area = static_cast<Scalar>(page_width_) * page_height_;
+  Scalar area_so_far = 0;
+  for (const auto& page : pages_) {
+    if (page) {
+      area_so_far += page->PercentFull() * page_area;
+    }
+  }
+  return area_so_far / (static_cast<Scalar>(width()) * height());
+}
+
+void PagedRectanglePacker::Reset() {
+  for (size_t i = 0u; i < pages_.size(); i++) {
+    ResetPage(i);
+  }
+}
+
+size_t PagedRectanglePacker::GetPageCount() const {
+  return pages_.size();
+}
+
+IRect PagedRectanglePacker::GetPageBounds(size_t page) const {
+  FML_DCHECK(page < pages_.size());
+  return IRect::MakeXYWH((page % columns_) * page_width_,
+                         (page / columns_) * page_height_,  //
+                         page_width_, page_height_);
+}
+
+bool PagedRectanglePacker::IsPageOpen(size_t page) const {
+  FML_DCHECK(page < pages_.size());
+  return !!pages_[page];
+}
+
+void PagedRectanglePacker::ResetPage(size_t page) {
+  FML_DCHECK(page < pages_.size());
+  if (pages_[page]) {
+    pages_[page]->Reset();
+  } else {
+    pages_[page] = RectanglePacker::Factory(page_width_, page_height_);
+  }
+}
+
 }  // namespace impeller
@@ -6,10 +6,13 @@
 #define FLUTTER_IMPELLER_TYPOGRAPHER_RECTANGLE_PACKER_H_
 
 #include "flutter/fml/logging.h"
+#include "impeller/geometry/rect.h"
 #include "impeller/geometry/scalar.h"
 
 #include <cstdint>
 #include <memory>
+#include <optional>
+#include <vector>
 
 namespace impeller {
 
@@ -71,6 +74,93 @@ class RectanglePacker {
   const int height_;
 };
 
+//------------------------------------------------------------------------------
+/// @brief      Packs rectangles into an area that is divided into a grid of
+///             equally sized pages, each of which is packed independently.
+///
+///             The space used by a single page can be reclaimed with
+///             |ResetPage| without disturbing the rectangles placed in the
+///             other pages. Rectangles never straddle a page boundary, so
+///             rectangles larger than a page cannot be added.
+///
+///             Pages start out closed and are only packed once they have
+///             been reset. This allows the packer to take over an area that
+///             has already been filled by some other packer.
+///
+class PagedRectanglePacker final : public RectanglePacker {
+ public:
+  PagedRectanglePacker(int width, int height, int page_width, int page_height);
+
+  ~PagedRectanglePacker() final;
+
+  // |RectanglePacker|
+  bool AddRect(int width, int height, IPoint16* loc) final;
+
+  // |RectanglePacker|
+  Scalar PercentFull() const final;
+
+  //----------------------------------------------------------------------------
+  /// @brief     Open every page and empty out all previously added
+  ///            rectangles.
+  ///
+  void Reset() final;
+
+  //----------------------------------------------------------------------------
+  /// @brief     The number of pages the area is divided into.
+  ///
+  size_t GetPageCount() const;
+
+  //----------------------------------------------------------------------------
+  /// @brief     The area covered by |page|.
+  ///
+  IRect GetPageBounds(size_t page) const;
+
+  //----------------------------------------------------------------------------
+  /// @brief     Whether rectangles can be added to |page|.
+  ///
+  bool IsPageOpen(size_t page) const;
+
+  //----------------------------------------------------------------------------
+  /// @brief     Open |page| and empty out all of the rectangles added to it.
+  ///
+  void ResetPage(size_t page);
+
+  //----------------------------------------------------------------------------
+  /// @brief     Invoke |visitor| with the index of every page that overlaps
+  ///            |rect|.
+  ///
+  template <typename Visitor>
+  void VisitPagesInRect(const IRect& rect, const Visitor& visitor) const {
+    IRect area = IRect::MakeXYWH(0, 0, columns_ * page_width_,
+                                 rows_ * page_height_);
+    std::optional<IRect> clipped = rect.Intersection(area);
+    if (!clipped.has_value()) {
+      return;
+    }
+    int64_t first_column = clipped->GetLeft() / page_width_;
+    int64_t last_column = (clipped->GetRight() - 1) / page_width_;
+    int64_t first_row = clipped->GetTop() / page_height_;
+    int64_t last_row = (clipped->GetBottom() - 1) / page_height_;
+    for (int64_t row = first_row; row <= last_row; row++) {
+      for (int64_t column = first_column; column <= last_column; column++) {
+        visitor(static_cast<size_t>(row * columns_ + column));
+      }
+    }
+  }
+
+ private:
+  const int page_width_;
+  const int page_height_;
+  const int columns_;
+  const int rows_;
+  /// nullptr for closed pages.
+  std::vector<std::shared_ptr<RectanglePacker>> pages_;
+
+  PagedRectanglePacker(const PagedRectanglePacker&) = delete;
+
+  PagedRectanglePacker& operator=(const PagedRectanglePacker&) = delete;
+};
+
 }  // namespace impeller
 
 #endif  // FLUTTER_IMPELLER_TYPOGRAPHER_RECTANGLE_PACKER_H_
@@ -3,6 +3,7 @@
 // found in the LICENSE file.
 
 #include "flutter/display_list/testing/dl_test_snippets.h"
+#include "flutter/fml/concurrent_message_loop.h"
 #include "flutter/testing/testing.h"
 #include "gtest/gtest.h"
 #include "impeller/core/host_buffer.h"
@@ -253,6 +254,51 @@ TEST_P(TypographerTest, GlyphAtlasWithLotsOfdUniqueGlyphSize) {
   EXPECT_TRUE(atlas->GetTexture()->GetSize().height > 0);
 }
 
+TEST_P(TypographerTest, GlyphAtlasCanBeRasterizedInParallel) {
+  auto host_buffer = HostBuffer::Create(GetContext()->GetResourceAllocator(),
+                                        GetContext()->GetIdleWaiter());
+  auto loop = fml::ConcurrentMessageLoop::Create(4u);
+  auto serial_context = TypographerContextSkia::Make();
+  auto parallel_context = TypographerContextSkia::Make(loop->GetTaskRunner());
+  ASSERT_TRUE(parallel_context && parallel_context->IsValid());
+  auto serial_atlas_context =
+      serial_context->CreateGlyphAtlasContext(GlyphAtlas::Type::kAlphaBitmap);
+  auto parallel_atlas_context = parallel_context->CreateGlyphAtlasContext(
+      GlyphAtlas::Type::kAlphaBitmap);
+
+  SkFont sk_font = flutter::testing::CreateTestFontOfSize(12);
+  auto blob = SkTextBlob::MakeFromString(
+      "QWERTYUIOPASDFGHJKLZXCVBNMqewrtyuiopasdfghjklzxcvbnm,.<>[]{};':"
+      "2134567890-=!@#$%^&*()_+",
+      sk_font);
+  ASSERT_TRUE(blob);
+
+  // The first batch creates a fresh atlas and the second batch is appended
+  // to it, which covers both of the rasterization paths.
+  for (size_t batch = 0; batch < 2; batch++) {
+    std::vector<std::shared_ptr<TextFrame>> frames;
+    for (size_t index = 0; index < 4; index++) {
+      frames.push_back(MakeTextFrameFromTextBlobSkia(blob));
+      frames.back()->SetPerFrameData(1.0 + batch * 4 + index, {0, 0}, {});
+    }
+    auto serial_atlas = serial_context->CreateGlyphAtlas(
+        *GetContext(), GlyphAtlas::Type::kAlphaBitmap, *host_buffer,
+        serial_atlas_context, frames);
+    auto parallel_atlas = parallel_context->CreateGlyphAtlas(
+        *GetContext(), GlyphAtlas::Type::kAlphaBitmap, *host_buffer,
+        parallel_atlas_context, frames);
+
+    ASSERT_NE(serial_atlas, nullptr);
+    ASSERT_NE(parallel_atlas, nullptr);
+    ASSERT_NE(parallel_atlas->GetTexture(), nullptr);
+    EXPECT_EQ(parallel_atlas->GetGlyphCount(), serial_atlas->GetGlyphCount());
+    EXPECT_EQ(parallel_atlas->GetTexture()->GetSize(),
+              serial_atlas->GetTexture()->GetSize());
+  }
+
+  loop->Terminate();
+}
+
 TEST_P(TypographerTest, GlyphAtlasTextureIsRecycledIfUnchanged) {
   auto host_buffer = HostBuffer::Create(GetContext()->GetResourceAllocator(),
                                         GetContext()->GetIdleWaiter());
@@ -422,6 +468,45 @@ TEST(TypographerTest, RectanglePackerFillsRows) {
   EXPECT_EQ(loc.y(), 16);
 }
 
+TEST(TypographerTest, PagedRectanglePackerReusesResetPages) {
+  PagedRectanglePacker packer(256, 128, 128, 64);
+  ASSERT_EQ(packer.GetPageCount(), 4u);
+  EXPECT_EQ(packer.GetPageBounds(3), IRect::MakeXYWH(128, 64, 128, 64));
+
+  // Pages start out closed.
+  IPoint16 loc;
+  EXPECT_FALSE(packer.AddRect(16, 16, &loc));
+
+  packer.ResetPage(3);
+  EXPECT_TRUE(packer.IsPageOpen(3));
+  EXPECT_FALSE(packer.IsPageOpen(0));
+  ASSERT_TRUE(packer.AddRect(128, 64, &loc));
+  EXPECT_EQ(loc.x(), 128);
+  EXPECT_EQ(loc.y(), 64);
+  EXPECT_TRUE(flutter::testing::NumberNear(packer.PercentFull(), 0.25));
+
+  // Rectangles never straddle pages.
+  EXPECT_FALSE(packer.AddRect(16, 16, &loc));
+  EXPECT_FALSE(packer.AddRect(129, 16, &loc));
+
+  // Resetting the page reclaims its space without touching the others.
+  packer.ResetPage(3);
+  ASSERT_TRUE(packer.AddRect(16, 16, &loc));
+  EXPECT_EQ(loc.x(), 128);
+  EXPECT_EQ(loc.y(), 64);
+
+  std::vector<size_t> pages;
+  packer.VisitPagesInRect(IRect::MakeLTRB(100, 10, 140, 70),
+                          [&pages](size_t page) { pages.push_back(page); });
+  EXPECT_EQ(pages, std::vector<size_t>({0u, 1u, 2u, 3u}));
+
+  packer.Reset();
+  for (size_t i = 0; i < packer.GetPageCount(); i++) {
+    EXPECT_TRUE(packer.IsPageOpen(i));
+  }
+  EXPECT_EQ(packer.PercentFull(), 0);
+}
+
 TEST_P(TypographerTest, GlyphAtlasTextureWillGrowTilMaxTextureSize) {
   if (GetBackend() == PlaygroundBackend::kOpenGLES) {
     GTEST_SKIP() << "Atlas growth isn't supported for OpenGLES currently.";
@@ -492,6 +577,132 @@ TEST_P(TypographerTest, GlyphAtlasTextureWillGrowTilMaxTextureSize) {
   ASSERT_EQ(atlas->GetGlyphCount(), 2u);
 }
 
+namespace {
+
+/// Text that is drawn every frame, such as a toolbar, along with text that is
+/// drawn at a different scale every frame, such as a document being zoomed.
+struct ZoomingTextFrames {
+  std::shared_ptr<TextFrame> hot;
+  std::shared_ptr<TextFrame> zoomed;
+  size_t zoomed_glyph_count = 0u;
+};
+
+ZoomingTextFrames MakeZoomingTextFrames(Scalar zoomed_scale) {
+  SkFont hot_font = flutter::testing::CreateTestFontOfSize(12);
+  SkFont zoomed_font = flutter::testing::CreateTestFontOfSize(100);
+  ZoomingTextFrames frames;
+  frames.hot = MakeTextFrameFromTextBlobSkia(
+      SkTextBlob::MakeFromString("Hot", hot_font));
+  frames.zoomed = MakeTextFrameFromTextBlobSkia(SkTextBlob::MakeFromString(
+      "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz", zoomed_font));
+  frames.hot->SetPerFrameData(1.0f, {0, 0}, std::nullopt);
+  frames.zoomed->SetPerFrameData(zoomed_scale, {0, 0}, std::nullopt);
+  for (const auto& run : frames.zoomed->GetRuns()) {
+    frames.zoomed_glyph_count += run.GetGlyphCount();
+  }
+  return frames;
+}
+
+}  // namespace
+
+TEST_P(TypographerTest, FullGlyphAtlasEvictsLeastRecentlyUsedGlyphs) {
+  if (GetBackend() == PlaygroundBackend::kOpenGLES) {
+    GTEST_SKIP() << "Atlas growth isn't supported for OpenGLES currently.";
+  }
+
+  auto host_buffer = HostBuffer::Create(GetContext()->GetResourceAllocator(),
+                                        GetContext()->GetIdleWaiter());
+  auto context = TypographerContextSkia::Make();
+  auto atlas_context =
+      context->CreateGlyphAtlasContext(GlyphAtlas::Type::kAlphaBitmap);
+  const ISize max_size =
+      GetContext()->GetResourceAllocator()->GetMaxTextureSizeSupported();
+
+  std::optional<Rect> hot_bounds;
+  size_t frames_since_eviction = 0u;
+  for (size_t i = 0; i < 200u && frames_since_eviction < 10u; i++) {
+    host_buffer->Reset();
+    ZoomingTextFrames frames = MakeZoomingTextFrames(2.0f + i * 0.01f);
+    auto atlas = context->CreateGlyphAtlas(
+        *GetContext(), GlyphAtlas::Type::kAlphaBitmap, *host_buffer,
+        atlas_context, {frames.hot, frames.zoomed});
+    ASSERT_NE(atlas, nullptr);
+
+    if (i > 0u) {
+      // Only the glyphs of the new zoom level are rasterized, even when the
+      // atlas is full.
+      EXPECT_EQ(atlas_context->GetFrameRasterizedGlyphCount(),
+                frames.zoomed_glyph_count);
+    }
+    // The hot glyphs keep their location in the atlas.
+    if (!frames.hot->GetFrameBounds(0).is_placeholder) {
+      Rect bounds = frames.hot->GetFrameBounds(0).atlas_bounds;
+      if (!hot_bounds.has_value()) {
+        hot_bounds = bounds;
+      }
+      EXPECT_EQ(bounds, hot_bounds.value());
+    }
+
+    if (atlas_context->GetFrameEvictedGlyphCount() > 0u ||
+        frames_since_eviction > 0u) {
+      frames_since_eviction++;
+      // The atlas stays at the maximum size rather than being rebuilt.
+      EXPECT_EQ(atlas->GetTexture()->GetSize().height, max_size.height);
+    }
+  }
+  EXPECT_GT(frames_since_eviction, 0u);
+}
+
+// Cycles through more zoom levels than fit in the atlas at once, which is
+// the worst case for glyph atlas churn. The number of glyphs rasterized per
+// frame is recorded as test properties.
+TEST_P(TypographerTest, GlyphAtlasZoomStress) {
+  if (GetBackend() == PlaygroundBackend::kOpenGLES) {
+    GTEST_SKIP() << "Atlas growth isn't supported for OpenGLES currently.";
+  }
+
+  auto host_buffer = HostBuffer::Create(GetContext()->GetResourceAllocator(),
+                                        GetContext()->GetIdleWaiter());
+  auto context = TypographerContextSkia::Make();
+  auto atlas_context =
+      context->CreateGlyphAtlasContext(GlyphAtlas::Type::kAlphaBitmap);
+
+  constexpr size_t kZoomLevels = 40u;
+  constexpr size_t kCycles = 3u;
+  size_t total_rasterized = 0u;
+  size_t max_rasterized = 0u;
+  size_t total_evicted = 0u;
+  size_t frame_count = 0u;
+  for (size_t cycle = 0; cycle < kCycles; cycle++) {
+    for (size_t level = 0; level < kZoomLevels; level++) {
+      host_buffer->Reset();
+      ZoomingTextFrames frames = MakeZoomingTextFrames(2.0f + level * 0.05f);
+      auto atlas = context->CreateGlyphAtlas(
+          *GetContext(), GlyphAtlas::Type::kAlphaBitmap, *host_buffer,
+          atlas_context, {frames.hot, frames.zoomed});
+      ASSERT_NE(atlas, nullptr);
+
+      size_t rasterized = atlas_context->GetFrameRasterizedGlyphCount();
+      if (frame_count > 0u) {
+        // At most the glyphs of the new zoom level are rasterized.
+        EXPECT_LE(rasterized, frames.zoomed_glyph_count);
+      }
+      total_rasterized += rasterized;
+      max_rasterized = std::max(max_rasterized, rasterized);
+      total_evicted += atlas_context->GetFrameEvictedGlyphCount();
+      frame_count++;
+    }
+  }
+
+  RecordProperty("frames", std::to_string(frame_count));
+  RecordProperty("rasterized_glyphs_per_frame",
+                 std::to_string(static_cast<double>(total_rasterized) /
+                                frame_count));
+  RecordProperty("max_rasterized_glyphs_per_frame",
+                 std::to_string(max_rasterized));
+  RecordProperty("evicted_glyphs", std::to_string(total_evicted));
+}
+
 TEST_P(TypographerTest, TextFrameInitialBoundsArePlaceholder) {
   SkFont font = flutter::testing::CreateTestFontOfSize(12);
   auto blob = SkTextBlob::MakeFromString(
@@ -142,6 +142,7 @@ typedef CanvasPath Path;
   V(Canvas, drawAtlas)                           \
   V(Canvas, drawCircle)                          \
   V(Canvas, drawColor)                           \
+  V(Canvas, drawCommands)                        \
   V(Canvas, drawDRRect)                          \
   V(Canvas, drawImage)                           \
   V(Canvas, drawImageNine)                       \
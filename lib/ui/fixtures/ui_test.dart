@@ -1252,3 +1252,19 @@ external void _callHook(
   Object? arg20,
   Object? arg21,
 ]);
+
+@pragma('vm:entry-point')
+void drawCanvasCommands() {
+  final PictureRecorder recorder = PictureRecorder();
+  final Canvas canvas = Canvas(recorder);
+  final Path path = Path()..addRect(const Rect.fromLTWH(0, 0, 10, 10));
+  final PictureRecorder pictureRecorder = PictureRecorder();
+  Canvas(pictureRecorder).drawPaint(Paint());
+  final Picture picture = pictureRecorder.endRecording();
+  _validateCanvasCommands(canvas, path, picture);
+  recorder.endRecording().dispose();
+  picture.dispose();
+}
+
+@pragma('vm:external-name', 'ValidateCanvasCommands')
+external void _validateCanvasCommands(Canvas canvas, Path path, Picture picture);
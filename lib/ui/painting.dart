@@ -6698,10 +6698,354 @@ base class _NativeCanvas extends NativeFieldWrapperClass1 implements Canvas {
   @Native<Void Function(Pointer<Void>, Pointer<Void>, Uint32, Double, Bool)>(symbol: 'Canvas::drawShadow')
   external void _drawShadow(_NativePath path, int color, double elevation, bool transparentOccluder);
 
+  @Native<Handle Function(Pointer<Void>, Handle, Handle)>(symbol: 'Canvas::drawCommands')
+  external String? _drawCommands(List<Object?> objects, ByteData commands);
+
   @override
   String toString() => 'Canvas(recording: ${_recorder != null})';
 }
 
+/// A sequence of canvas operations that is drawn into a [Canvas] with a
+/// single call into the engine.
+///
+/// Every call on a [Canvas] crosses into the engine and passes its [Paint]
+/// along separately. Drawing many small primitives one call at a time is
+/// dominated by that overhead. A [CanvasCommandBatch] encodes the same
+/// operations into a single buffer instead, and [drawInto] records all of
+/// them with one call.
+///
+/// The state of each [Paint] is captured when an operation is added, so a
+/// paint can be changed and reused for the next operation. A paint is only
+/// encoded again when it differs from the one used by the previous
+/// operation that took a paint. The paths,
+/// images and pictures that operations refer to are retained until the
+/// batch is [clear]ed, and images must not be disposed before the batch is
+/// drawn.
+class CanvasCommandBatch {
+  /// Creates an empty batch.
+  CanvasCommandBatch();
+
+  // These must be kept in sync with CanvasCommand in canvas.h.
+  static const int _kSave = 0;
+  static const int _kSaveLayer = 1;
+  static const int _kSaveLayerWithoutBounds = 2;
+  static const int _kRestore = 3;
+  static const int _kTranslate = 4;
+  static const int _kScale = 5;
+  static const int _kRotate = 6;
+  static const int _kClipRect = 7;
+  static const int _kClipRRect = 8;
+  static const int _kClipPath = 9;
+  static const int _kSetPaint = 10;
+  static const int _kDrawColor = 11;
+  static const int _kDrawLine = 12;
+  static const int _kDrawPaint = 13;
+  static const int _kDrawRect = 14;
+  static const int _kDrawRRect = 15;
+  static const int _kDrawOval = 16;
+  static const int _kDrawCircle = 17;
+  static const int _kDrawPath = 18;
+  static const int _kDrawImage = 19;
+  static const int _kDrawPicture = 20;
+
+  static const int _kInitialByteCount = 1024;
+
+  ByteData _data = ByteData(_kInitialByteCount);
+  int _byteCount = 0;
+  final List<Object?> _objects = <Object?>[];
+
+  // The byte offset of the paint data that was written by the most recent
+  // set paint command, or -1 if there is none, and the paint objects that
+  // were written along with it.
+  int _paintDataOffset = -1;
+  Object? _paintShader;
+  Object? _paintColorFilter;
+  Object? _paintImageFilter;
+
+  /// Whether no operations were added since the batch was created or last
+  /// [clear]ed.
+  bool get isEmpty => _byteCount == 0;
+
+  /// Removes all of the operations and releases the objects they refer to.
+  void clear() {
+    _byteCount = 0;
+    _objects.clear();
+    _paintDataOffset = -1;
+    _paintShader = null;
+    _paintColorFilter = null;
+    _paintImageFilter = null;
+  }
+
+  /// Records all of the operations in this batch into `canvas`, in the order
+  /// in which they were added.
+  ///
+  /// The batch is left unchanged and can be drawn again. The `canvas` must
+  /// have been created by this library, and not be an implementation of
+  /// [Canvas] provided by another library.
+  void drawInto(Canvas canvas) {
+    if (canvas is! _NativeCanvas) {
+      throw ArgumentError.value(canvas, 'canvas', 'must be created with the Canvas constructor');
+    }
+    if (isEmpty) {
+      return;
+    }
+    final String? error = canvas._drawCommands(_objects, ByteData.sublistView(_data, 0, _byteCount));
+    if (error != null) {
+      throw Exception(error);
+    }
+  }
+
+  /// Adds a [Canvas.save] operation.
+  void save() {
+    _beginCommand(_kSave, 0);
+  }
+
+  /// Adds a [Canvas.saveLayer] operation.
+  void saveLayer(Rect? bounds, Paint paint) {
+    _setPaint(paint);
+    if (bounds == null) {
+      _beginCommand(_kSaveLayerWithoutBounds, 0);
+    } else {
+      assert(_rectIsValid(bounds));
+      _beginCommand(_kSaveLayer, 4);
+      _writeRect(bounds);
+    }
+  }
+
+  /// Adds a [Canvas.restore] operation.
+  void restore() {
+    _beginCommand(_kRestore, 0);
+  }
+
+  /// Adds a [Canvas.translate] operation.
+  void translate(double dx, double dy) {
+    _beginCommand(_kTranslate, 2);
+    _writeFloat(dx);
+    _writeFloat(dy);
+  }
+
+  /// Adds a [Canvas.scale] operation.
+  void scale(double sx, [double? sy]) {
+    _beginCommand(_kScale, 2);
+    _writeFloat(sx);
+    _writeFloat(sy ?? sx);
+  }
+
+  /// Adds a [Canvas.rotate] operation.
+  void rotate(double radians) {
+    _beginCommand(_kRotate, 1);
+    _writeFloat(radians);
+  }
+
+  /// Adds a [Canvas.clipRect] operation.
+  void clipRect(Rect rect, { ClipOp clipOp = ClipOp.intersect, bool doAntiAlias = true }) {
+    assert(_rectIsValid(rect));
+    _beginCommand(_kClipRect, 6);
+    _writeRect(_NativeCanvas._sorted(rect));
+    _writeUint(clipOp.index);
+    _writeBool(doAntiAlias);
+  }
+
+  /// Adds a [Canvas.clipRRect] operation.
+  void clipRRect(RRect rrect, {bool doAntiAlias = true}) {
+    assert(_rrectIsValid(rrect));
+    _beginCommand(_kClipRRect, 13);
+    _writeRRect(rrect);
+    _writeBool(doAntiAlias);
+  }
+
+  /// Adds a [Canvas.clipPath] operation.
+  void clipPath(Path path, {bool doAntiAlias = true}) {
+    _beginCommand(_kClipPath, 2);
+    _writeObject(path as _NativePath);
+    _writeBool(doAntiAlias);
+  }
+
+  /// Adds a [Canvas.drawColor] operation.
+  void drawColor(Color color, BlendMode blendMode) {
+    _beginCommand(_kDrawColor, 2);
+    _writeUint(color.value);
+    _writeUint(blendMode.index);
+  }
+
+  /// Adds a [Canvas.drawLine] operation.
+  void drawLine(Offset p1, Offset p2, Paint paint) {
+    assert(_offsetIsValid(p1));
+    assert(_offsetIsValid(p2));
+    _setPaint(paint);
+    _beginCommand(_kDrawLine, 4);
+    _writeFloat(p1.dx);
+    _writeFloat(p1.dy);
+    _writeFloat(p2.dx);
+    _writeFloat(p2.dy);
+  }
+
+  /// Adds a [Canvas.drawPaint] operation.
+  void drawPaint(Paint paint) {
+    _setPaint(paint);
+    _beginCommand(_kDrawPaint, 0);
+  }
+
+  /// Adds a [Canvas.drawRect] operation.
+  void drawRect(Rect rect, Paint paint) {
+    assert(_rectIsValid(rect));
+    rect = _NativeCanvas._sorted(rect);
+    if (paint.style != PaintingStyle.fill || !rect.isEmpty) {
+      _setPaint(paint);
+      _beginCommand(_kDrawRect, 4);
+      _writeRect(rect);
+    }
+  }
+
+  /// Adds a [Canvas.drawRRect] operation.
+  void drawRRect(RRect rrect, Paint paint) {
+    assert(_rrectIsValid(rrect));
+    _setPaint(paint);
+    _beginCommand(_kDrawRRect, 12);
+    _writeRRect(rrect);
+  }
+
+  /// Adds a [Canvas.drawOval] operation.
+  void drawOval(Rect rect, Paint paint) {
+    assert(_rectIsValid(rect));
+    _setPaint(paint);
+    _beginCommand(_kDrawOval, 4);
+    _writeRect(_NativeCanvas._sorted(rect));
+  }
+
+  /// Adds a [Canvas.drawCircle] operation.
+  void drawCircle(Offset c, double radius, Paint paint) {
+    assert(_offsetIsValid(c));
+    _setPaint(paint);
+    _beginCommand(_kDrawCircle, 3);
+    _writeFloat(c.dx);
+    _writeFloat(c.dy);
+    _writeFloat(radius);
+  }
+
+  /// Adds a [Canvas.drawPath] operation.
+  void drawPath(Path path, Paint paint) {
+    _setPaint(paint);
+    _beginCommand(_kDrawPath, 1);
+    _writeObject(path as _NativePath);
+  }
+
+  /// Adds a [Canvas.drawImage] operation.
+  void drawImage(Image image, Offset offset, Paint paint) {
+    assert(!image.debugDisposed);
+    assert(_offsetIsValid(offset));
+    _setPaint(paint);
+    _beginCommand(_kDrawImage, 4);
+    _writeObject(image._image);
+    _writeFloat(offset.dx);
+    _writeFloat(offset.dy);
+    _writeUint(paint.filterQuality.index);
+  }
+
+  /// Adds a [Canvas.drawPicture] operation.
+  void drawPicture(Picture picture) {
+    _beginCommand(_kDrawPicture, 1);
+    _writeObject(picture as _NativePicture);
+  }
+
+  // Writes a set paint command for `paint`, unless the paint that is already
+  // set is equal to it.
+  void _setPaint(Paint paint) {
+    final List<Object?>? paintObjects = paint._objects;
+    final Object? shader = paintObjects?[Paint._kShaderIndex];
+    final Object? colorFilter = paintObjects?[Paint._kColorFilterIndex];
+    final Object? imageFilter = paintObjects?[Paint._kImageFilterIndex];
+    if (_paintDataOffset >= 0 &&
+        identical(shader, _paintShader) &&
+        identical(colorFilter, _paintColorFilter) &&
+        identical(imageFilter, _paintImageFilter) &&
+        _paintDataEquals(paint._data)) {
+      return;
+    }
+    _beginCommand(_kSetPaint, 3 + Paint._kDataByteCount ~/ 4);
+    _writeObject(shader);
+    _writeObject(colorFilter);
+    _writeObject(imageFilter);
+    _paintDataOffset = _byteCount;
+    _paintShader = shader;
+    _paintColorFilter = colorFilter;
+    _paintImageFilter = imageFilter;
+    _data.buffer.asUint8List().setRange(
+      _byteCount,
+      _byteCount + Paint._kDataByteCount,
+      paint._data.buffer.asUint8List(paint._data.offsetInBytes, Paint._kDataByteCount),
+    );
+    _byteCount += Paint._kDataByteCount;
+  }
+
+  bool _paintDataEquals(ByteData data) {
+    for (int i = 0; i < Paint._kDataByteCount; i += 4) {
+      if (data.getUint32(i, _kFakeHostEndian) !=
+          _data.getUint32(_paintDataOffset + i, _kFakeHostEndian)) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  // Makes room for an opcode followed by `argumentCount` 32-bit arguments
+  // and writes the opcode.
+  void _beginCommand(int opcode, int argumentCount) {
+    final int requiredByteCount = _byteCount + 4 * (1 + argumentCount);
+    if (requiredByteCount > _data.lengthInBytes) {
+      int newByteCount = _data.lengthInBytes * 2;
+      while (newByteCount < requiredByteCount) {
+        newByteCount *= 2;
+      }
+      final ByteData newData = ByteData(newByteCount);
+      newData.buffer.asUint8List().setRange(0, _byteCount, _data.buffer.asUint8List());
+      _data = newData;
+    }
+    _writeUint(opcode);
+  }
+
+  void _writeUint(int value) {
+    _data.setUint32(_byteCount, value, _kFakeHostEndian);
+    _byteCount += 4;
+  }
+
+  void _writeBool(bool value) {
+    _writeUint(value ? 1 : 0);
+  }
+
+  void _writeFloat(double value) {
+    _data.setFloat32(_byteCount, value, _kFakeHostEndian);
+    _byteCount += 4;
+  }
+
+  void _writeRect(Rect rect) {
+    _writeFloat(rect.left);
+    _writeFloat(rect.top);
+    _writeFloat(rect.right);
+    _writeFloat(rect.bottom);
+  }
+
+  void _writeRRect(RRect rrect) {
+    final Float32List values = rrect._getValue32();
+    for (int i = 0; i < values.length; i++) {
+      _writeFloat(values[i]);
+    }
+  }
+
+  // Writes the index of `object` in the list passed along with the
+  // commands, or -1 for null.
+  void _writeObject(Object? object) {
+    if (object == null) {
+      _data.setInt32(_byteCount, -1, _kFakeHostEndian);
+      _byteCount += 4;
+      return;
+    }
+    _data.setInt32(_byteCount, _objects.length, _kFakeHostEndian);
+    _byteCount += 4;
+    _objects.add(object);
+  }
+}
+
 /// Signature for [Picture] lifecycle events.
 typedef PictureEventCallback = void Function(Picture picture);
 
@@ -0,0 +1,374 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/lib/ui/painting/animated_image_frames.h"
+
+#include <algorithm>
+#include <deque>
+#include <map>
+#include <sstream>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "flutter/fml/hash_combine.h"
+#include "flutter/fml/logging.h"
+#include "flutter/fml/trace_event.h"
+#include "third_party/skia/include/codec/SkCodec.h"
+#include "third_party/skia/include/codec/SkCodecAnimation.h"
+
+namespace flutter {
+
+namespace {
+
+SkImageInfo GetDecodedInfo(ImageGenerator& generator) {
+  SkImageInfo info = generator.GetInfo().makeColorType(kN32_SkColorType);
+  if (info.alphaType() == kUnpremul_SkAlphaType) {
+    info = info.makeAlphaType(kPremul_SkAlphaType);
+  }
+  return info;
+}
+
+}  // namespace
+
+// The decoded frames of an animated image, shared by the instances that
+// display it, along with what is known about the frames before decoding.
+class AnimatedImageFrames::FrameCache {
+ public:
+  FrameCache(ImageGenerator& generator,
+             size_t max_cached_frame_bytes,
+             sk_sp<SkData> encoded_data)
+      : info(GetDecodedInfo(generator)),
+        frame_count(generator.GetFrameCount()),
+        data(std::move(encoded_data)),
+        max_frame_count_(std::clamp<size_t>(
+            max_cached_frame_bytes /
+                std::max<size_t>(info.computeMinByteSize(), 1u),
+            kDecodeAheadFrameCount + 1,
+            std::max(frame_count, kDecodeAheadFrameCount + 1))) {
+    frame_durations.reserve(frame_count);
+    restart_frames.reserve(frame_count);
+    for (int i = 0; i < frame_count; i++) {
+      ImageGenerator::FrameInfo frame_info = generator.GetFrameInfo(i);
+      frame_durations.push_back(frame_info.duration);
+      // Decoding a frame that does not depend on any other frame and that is
+      // kept as the backdrop of the next frame leaves the decoder in the same
+      // state as decoding all the frames up to it.
+      if (i == 0 || (!frame_info.required_frame.has_value() &&
+                     frame_info.disposal_method ==
+                         SkCodecAnimation::DisposalMethod::kKeep)) {
+        restart_frames.push_back(i);
+      } else {
+        restart_frames.push_back(restart_frames.back());
+      }
+    }
+  }
+
+  static std::shared_ptr<FrameCache> GetShared(
+      const sk_sp<SkData>& data,
+      ImageGenerator& generator,
+      size_t max_cached_frame_bytes) {
+    // Keyed on the hash of the encoded data and of the decoded size.
+    static std::mutex shared_mutex;
+    static auto* shared_caches =
+        new std::unordered_multimap<size_t, std::weak_ptr<FrameCache>>();
+
+    const SkISize size = generator.GetInfo().dimensions();
+    const size_t hash = fml::HashCombine(
+        std::string_view(static_cast<const char*>(data->data()), data->size()),
+        size.width(), size.height());
+
+    std::scoped_lock lock(shared_mutex);
+    auto [begin, end] = shared_caches->equal_range(hash);
+    for (auto it = begin; it != end; ++it) {
+      std::shared_ptr<FrameCache> cache = it->second.lock();
+      if (cache && cache->info.dimensions() == size &&
+          cache->data->equals(data.get())) {
+        return cache;
+      }
+    }
+
+    for (auto it = shared_caches->begin(); it != shared_caches->end();) {
+      if (it->second.expired()) {
+        it = shared_caches->erase(it);
+      } else {
+        ++it;
+      }
+    }
+    auto cache =
+        std::make_shared<FrameCache>(generator, max_cached_frame_bytes, data);
+    shared_caches->emplace(hash, cache);
+    return cache;
+  }
+
+  std::optional<DecodedFrame> Find(int index) const {
+    std::scoped_lock lock(mutex_);
+    auto frame = frames_.find(index);
+    if (frame == frames_.end()) {
+      return std::nullopt;
+    }
+    return frame->second;
+  }
+
+  void Insert(int index, DecodedFrame frame) {
+    std::scoped_lock lock(mutex_);
+    auto [cached_frame, inserted] = frames_.emplace(index, frame);
+    if (!inserted) {
+      cached_frame->second = std::move(frame);
+      return;
+    }
+    frame_order_.push_back(index);
+    while (frame_order_.size() > max_frame_count_) {
+      frames_.erase(frame_order_.front());
+      frame_order_.pop_front();
+    }
+  }
+
+  const SkImageInfo info;
+  const int frame_count;
+  // The duration of each frame, and the frame that decoding can restart from
+  // to decode each frame without decoding all the frames before it.
+  std::vector<int> frame_durations;
+  std::vector<int> restart_frames;
+  // The encoded data that the cache is shared for, if shared.
+  const sk_sp<SkData> data;
+  // Held while decoding, so that instances that display the same frames at
+  // the same time find the frames that the others decoded instead of
+  // decoding them too.
+  std::mutex decode_mutex;
+
+ private:
+  const size_t max_frame_count_;
+  mutable std::mutex mutex_;
+  // The cached frames, and their indices in the order they were decoded in
+  // for eviction.
+  std::map<int, DecodedFrame> frames_;
+  std::deque<int> frame_order_;
+
+  FML_DISALLOW_COPY_AND_ASSIGN(FrameCache);
+};
+
+// static
+std::shared_ptr<AnimatedImageFrames> AnimatedImageFrames::GetShared(
+    const sk_sp<SkData>& data,
+    std::shared_ptr<ImageGenerator> generator,
+    size_t max_cached_frame_bytes) {
+  if (!data) {
+    return std::make_shared<AnimatedImageFrames>(std::move(generator),
+                                                 max_cached_frame_bytes);
+  }
+  std::shared_ptr<FrameCache> cache =
+      FrameCache::GetShared(data, *generator, max_cached_frame_bytes);
+  return std::shared_ptr<AnimatedImageFrames>(
+      new AnimatedImageFrames(std::move(generator), std::move(cache)));
+}
+
+AnimatedImageFrames::AnimatedImageFrames(
+    std::shared_ptr<ImageGenerator> generator,
+    size_t max_cached_frame_bytes)
+    : AnimatedImageFrames(generator,
+                          std::make_shared<FrameCache>(
+                              *generator, max_cached_frame_bytes, nullptr)) {}
+
+AnimatedImageFrames::AnimatedImageFrames(
+    std::shared_ptr<ImageGenerator> generator,
+    std::shared_ptr<FrameCache> cache)
+    : generator_(std::move(generator)),
+      cache_(std::move(cache)),
+      frame_count_(cache_->frame_count) {}
+
+AnimatedImageFrames::~AnimatedImageFrames() = default;
+
+int AnimatedImageFrames::GetFrameDuration(int index) const {
+  if (index < 0 || index >= frame_count_) {
+    return 0;
+  }
+  return cache_->frame_durations[index];
+}
+
+size_t AnimatedImageFrames::GetDecodedFrameCount() const {
+  std::scoped_lock lock(mutex_);
+  return decoded_frame_count_;
+}
+
+bool AnimatedImageFrames::SharesFramesWith(
+    const AnimatedImageFrames& other) const {
+  return cache_ == other.cache_;
+}
+
+std::pair<std::shared_ptr<SkBitmap>, std::string> AnimatedImageFrames::GetFrame(
+    int index) {
+  std::scoped_lock lock(mutex_);
+  return GetFrameLocked(index);
+}
+
+void AnimatedImageFrames::DecodeAhead(
+    const std::shared_ptr<fml::ConcurrentTaskRunner>& task_runner,
+    int index) {
+  if (!task_runner || frame_count_ <= 1 ||
+      decode_ahead_pending_.exchange(true)) {
+    return;
+  }
+  task_runner->PostTask([weak_frames = weak_from_this(), index]() {
+    std::shared_ptr<AnimatedImageFrames> frames = weak_frames.lock();
+    if (!frames) {
+      return;
+    }
+    TRACE_EVENT0("flutter", "AnimatedImageFrames::DecodeAhead");
+    for (int i = 1; i <= kDecodeAheadFrameCount; i++) {
+      // The lock is released between frames so that the frames that are
+      // already decoded can be handed out in the meantime.
+      std::scoped_lock lock(frames->mutex_);
+      frames->GetFrameLocked((index + i) % frames->frame_count_);
+    }
+    frames->decode_ahead_pending_ = false;
+  });
+}
+
+std::pair<std::shared_ptr<SkBitmap>, std::string>
+AnimatedImageFrames::GetFrameLocked(int index) {
+  if (index < 0 || index >= frame_count_) {
+    std::ostringstream ostr;
+    ostr << "Frame " << index << " is out of range";
+    return std::make_pair(nullptr, ostr.str());
+  }
+
+  std::optional<DecodedFrame> cached_frame = cache_->Find(index);
+  if (cached_frame.has_value()) {
+    // Following the frames that are handed out keeps the next frame one
+    // decode away when it is no longer cached.
+    SkipToFrameLocked(index, *cached_frame);
+    return std::make_pair(cached_frame->bitmap, std::string());
+  }
+
+  std::scoped_lock decode_lock(cache_->decode_mutex);
+  // Frames are decoded on top of the frames before them, so the decoder goes
+  // through all the frames from where it is to |index|, unless it is past
+  // |index| or can skip ahead to a frame that does not depend on the others.
+  const int restart_frame = cache_->restart_frames[index];
+  if (index < next_decode_index_ || restart_frame > next_decode_index_) {
+    next_decode_index_ = restart_frame;
+    last_required_frame_.reset();
+    restore_bg_color_rect_.reset();
+  }
+  while (true) {
+    const int decode_index = next_decode_index_;
+    std::pair<std::shared_ptr<SkBitmap>, std::string> result;
+    // The frames on the way may have been decoded by another instance,
+    // including while this one waited for |decode_mutex|.
+    cached_frame = cache_->Find(decode_index);
+    if (cached_frame.has_value()) {
+      SkipToFrameLocked(decode_index, *cached_frame);
+      result = std::make_pair(cached_frame->bitmap, std::string());
+    } else {
+      result = DecodeNextFrameLocked();
+    }
+    if (decode_index == index) {
+      return result;
+    }
+  }
+}
+
+void AnimatedImageFrames::SkipToFrameLocked(int index,
+                                            const DecodedFrame& frame) {
+  next_decode_index_ = (index + 1) % frame_count_;
+  last_required_frame_ = frame.last_required_frame;
+  restore_bg_color_rect_ = frame.restore_bg_color_rect;
+}
+
+std::pair<std::shared_ptr<SkBitmap>, std::string>
+AnimatedImageFrames::DecodeNextFrameLocked() {
+  const int index = next_decode_index_;
+  next_decode_index_ = (index + 1) % frame_count_;
+  decoded_frame_count_++;
+  TRACE_EVENT0("flutter", "AnimatedImageFrames::DecodeFrame");
+
+  const SkImageInfo& info = cache_->info;
+  auto bitmap = std::make_shared<SkBitmap>();
+  if (!bitmap->tryAllocPixels(info)) {
+    std::ostringstream ostr;
+    ostr << "Failed to allocate memory for bitmap of size "
+         << info.computeMinByteSize() << "B";
+    std::string decode_error = ostr.str();
+    FML_LOG(ERROR) << decode_error;
+    return std::make_pair(nullptr, decode_error);
+  }
+
+  ImageGenerator::FrameInfo frameInfo = generator_->GetFrameInfo(index);
+
+  const int requiredFrameIndex =
+      frameInfo.required_frame.value_or(SkCodec::kNoFrame);
+
+  if (requiredFrameIndex != SkCodec::kNoFrame) {
+    // We are here when the frame said |disposal_method| is
+    // `DisposalMethod::kKeep` or `DisposalMethod::kRestorePrevious` and
+    // |requiredFrameIndex| is set to ex-frame or ex-ex-frame.
+    if (!last_required_frame_.has_value()) {
+      FML_DLOG(INFO)
+          << "Frame " << index << " depends on frame " << requiredFrameIndex
+          << " and no required frames are cached. Using blank slate instead.";
+    } else {
+      // Copy the previous frame's output buffer into the current frame as the
+      // starting point.
+      bitmap->writePixels(last_required_frame_->pixmap());
+      if (restore_bg_color_rect_.has_value()) {
+        bitmap->erase(SK_ColorTRANSPARENT, restore_bg_color_rect_.value());
+      }
+    }
+  }
+
+  // Write the new frame to the output buffer. The bitmap pixels as supplied
+  // are already set in accordance with the previous frame's disposal policy.
+  if (!generator_->GetPixels(info, bitmap->getPixels(), bitmap->rowBytes(),
+                             index, requiredFrameIndex)) {
+    std::ostringstream ostr;
+    ostr << "Could not getPixels for frame " << index;
+    std::string decode_error = ostr.str();
+    FML_LOG(ERROR) << decode_error;
+    return std::make_pair(nullptr, decode_error);
+  }
+  // The pixels are shared with every image that is made from this frame from
+  // now on.
+  bitmap->setImmutable();
+
+  const bool keep_current_frame =
+      frameInfo.disposal_method == SkCodecAnimation::DisposalMethod::kKeep;
+  const bool restore_previous_frame =
+      frameInfo.disposal_method ==
+      SkCodecAnimation::DisposalMethod::kRestorePrevious;
+  const bool previous_frame_available = last_required_frame_.has_value();
+
+  // Store the current frame in `last_required_frame_` if the frame's disposal
+  // method indicates we should do so.
+  // * When the disposal method is "Keep", the stored frame should always be
+  //   overwritten with the new frame we just crafted.
+  // * When the disposal method is "RestorePrevious", the previously stored
+  //   frame should be retained and used as the backdrop for the next frame
+  //   again. If there isn't already a stored frame, that means we haven't
+  //   rendered any frames yet! When this happens, we just fall back to "Keep"
+  //   behavior and store the current frame as the backdrop of the next frame.
+
+  if (keep_current_frame ||
+      (previous_frame_available && !restore_previous_frame)) {
+    // Replace the stored frame. The `last_required_frame_` will get used as
+    // the starting backdrop for the next frame.
+    last_required_frame_ = *bitmap;
+  }
+
+  if (frameInfo.disposal_method ==
+      SkCodecAnimation::DisposalMethod::kRestoreBGColor) {
+    restore_bg_color_rect_ = frameInfo.disposal_rect;
+  } else {
+    restore_bg_color_rect_.reset();
+  }
+
+  cache_->Insert(index, DecodedFrame{
+                           .bitmap = bitmap,
+                           .last_required_frame = last_required_frame_,
+                           .restore_bg_color_rect = restore_bg_color_rect_,
+                       });
+  return std::make_pair(std::move(bitmap), std::string());
+}
+
+}  // namespace flutter
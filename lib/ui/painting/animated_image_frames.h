@@ -0,0 +1,138 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_LIB_UI_PAINTING_ANIMATED_IMAGE_FRAMES_H_
+#define FLUTTER_LIB_UI_PAINTING_ANIMATED_IMAGE_FRAMES_H_
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <utility>
+
+#include "flutter/fml/concurrent_message_loop.h"
+#include "flutter/fml/macros.h"
+#include "flutter/lib/ui/painting/image_generator.h"
+#include "third_party/skia/include/core/SkBitmap.h"
+#include "third_party/skia/include/core/SkData.h"
+#include "third_party/skia/include/core/SkRect.h"
+
+namespace flutter {
+
+/// @brief  Decodes the frames of an animated image and keeps the decoded
+///         frames around so that they can be handed out again without being
+///         decoded a second time.
+///
+///         Frames are decoded in order because each frame may be drawn on top
+///         of the frames before it. To hide the decode time, the frames that
+///         follow the displayed frame are decoded ahead of time on a
+///         concurrent task runner while it is displayed.
+///
+///         Codecs that display the same encoded image at the same size get
+///         instances from `GetShared` that share one cache of decoded frames,
+///         so an animated image that is on screen many times at once is only
+///         decoded once as long as its frames stay in the cache. Each
+///         instance decodes from its own position in the animation, so codecs
+///         that display different frames do not make each other decode the
+///         animation from the start when the frames do not fit in the cache.
+///
+///         All methods are thread safe.
+///
+class AnimatedImageFrames
+    : public std::enable_shared_from_this<AnimatedImageFrames> {
+ public:
+  /// The number of frames after the displayed frame that are decoded ahead of
+  /// time.
+  static constexpr int kDecodeAheadFrameCount = 2;
+
+  /// The number of bytes of decoded frames kept per animated image. The
+  /// displayed frame and the frames decoded ahead of it are always kept, even
+  /// if they take more than this.
+  static constexpr size_t kMaxCachedFrameBytes = 8u << 20;
+
+  /// @brief  Returns frames of the image encoded in `data` that are decoded by
+  ///         `generator`, and that share their cache with the frames returned
+  ///         to the other callers that pass the same encoded bytes and a
+  ///         generator of the same size. If `data` is null, the cache is not
+  ///         shared. `max_cached_frame_bytes` only applies to a new cache.
+  static std::shared_ptr<AnimatedImageFrames> GetShared(
+      const sk_sp<SkData>& data,
+      std::shared_ptr<ImageGenerator> generator,
+      size_t max_cached_frame_bytes = kMaxCachedFrameBytes);
+
+  explicit AnimatedImageFrames(
+      std::shared_ptr<ImageGenerator> generator,
+      size_t max_cached_frame_bytes = kMaxCachedFrameBytes);
+
+  ~AnimatedImageFrames();
+
+  int GetFrameCount() const { return frame_count_; }
+
+  /// @brief  The number of milliseconds to show the frame at `index` for.
+  int GetFrameDuration(int index) const;
+
+  /// @brief  Returns the pixels of the frame at `index`, decoding it and the
+  ///         frames it depends on if it is not cached. The returned bitmap is
+  ///         immutable. On failure, the bitmap is null and the string
+  ///         describes the error.
+  std::pair<std::shared_ptr<SkBitmap>, std::string> GetFrame(int index);
+
+  /// @brief  Decodes the frames that follow the frame at `index` on
+  ///         `task_runner`, unless a decode ahead is already in progress.
+  void DecodeAhead(
+      const std::shared_ptr<fml::ConcurrentTaskRunner>& task_runner,
+      int index);
+
+  /// @brief  The number of frames decoded by this instance so far, including
+  ///         the frames that were decoded again after having been evicted
+  ///         from the cache.
+  size_t GetDecodedFrameCount() const;
+
+  /// @brief  Whether this instance and `other` share their decoded frames.
+  bool SharesFramesWith(const AnimatedImageFrames& other) const;
+
+ private:
+  class FrameCache;
+
+  // A decoded frame, and the state that the decoder is left in after
+  // decoding it.
+  struct DecodedFrame {
+    std::shared_ptr<SkBitmap> bitmap;
+    std::optional<SkBitmap> last_required_frame;
+    std::optional<SkIRect> restore_bg_color_rect;
+  };
+
+  AnimatedImageFrames(std::shared_ptr<ImageGenerator> generator,
+                      std::shared_ptr<FrameCache> cache);
+
+  const std::shared_ptr<ImageGenerator> generator_;
+  const std::shared_ptr<FrameCache> cache_;
+  const int frame_count_;
+  std::atomic_bool decode_ahead_pending_ = false;
+
+  mutable std::mutex mutex_;
+  // The members below are guarded by |mutex_|.
+  int next_decode_index_ = 0;
+  // The last decoded frame that's required to decode any subsequent frames.
+  std::optional<SkBitmap> last_required_frame_;
+  // The rectangle that should be cleared if the previous frame's disposal
+  // method was kRestoreBGColor.
+  std::optional<SkIRect> restore_bg_color_rect_;
+  size_t decoded_frame_count_ = 0;
+
+  std::pair<std::shared_ptr<SkBitmap>, std::string> GetFrameLocked(int index);
+
+  std::pair<std::shared_ptr<SkBitmap>, std::string> DecodeNextFrameLocked();
+
+  // Continues decoding after |frame|, which is at |index|, as if this
+  // instance had decoded it.
+  void SkipToFrameLocked(int index, const DecodedFrame& frame);
+
+  FML_DISALLOW_COPY_AND_ASSIGN(AnimatedImageFrames);
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_LIB_UI_PAINTING_ANIMATED_IMAGE_FRAMES_H_
@@ -0,0 +1,160 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/lib/ui/painting/animated_image_frames.h"
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+
+#include "flutter/fml/concurrent_message_loop.h"
+#include "flutter/fml/synchronization/waitable_event.h"
+#include "flutter/lib/ui/painting/image_generator_registry.h"
+#include "flutter/testing/testing.h"
+
+namespace flutter {
+namespace testing {
+
+namespace {
+
+std::shared_ptr<ImageGenerator> CreateGenerator(const sk_sp<SkData>& data) {
+  ImageGeneratorRegistry registry;
+  return registry.CreateCompatibleGenerator(data);
+}
+
+bool PixelsEqual(const SkBitmap& a, const SkBitmap& b) {
+  if (a.info() != b.info()) {
+    return false;
+  }
+  for (int y = 0; y < a.height(); y++) {
+    if (std::memcmp(a.getAddr(0, y), b.getAddr(0, y),
+                    a.info().minRowBytes()) != 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+}  // namespace
+
+TEST(AnimatedImageFramesTest, SharesFramesOfIdenticalImages) {
+  sk_sp<SkData> gif = OpenFixtureAsSkData("hello_loop_2.gif");
+  ASSERT_TRUE(gif);
+  sk_sp<SkData> gif_copy = SkData::MakeWithCopy(gif->data(), gif->size());
+  sk_sp<SkData> webp = OpenFixtureAsSkData("hello_loop_2.webp");
+  ASSERT_TRUE(webp);
+
+  auto frames = AnimatedImageFrames::GetShared(gif, CreateGenerator(gif));
+  EXPECT_TRUE(
+      AnimatedImageFrames::GetShared(gif_copy, CreateGenerator(gif_copy))
+          ->SharesFramesWith(*frames));
+  EXPECT_FALSE(AnimatedImageFrames::GetShared(webp, CreateGenerator(webp))
+                   ->SharesFramesWith(*frames));
+  EXPECT_FALSE(AnimatedImageFrames::GetShared(nullptr, CreateGenerator(gif))
+                   ->SharesFramesWith(*frames));
+}
+
+TEST(AnimatedImageFramesTest, OutOfPhaseCodecsDecodeFromTheirOwnPosition) {
+  sk_sp<SkData> gif = OpenFixtureAsSkData("hello_loop_2.gif");
+  ASSERT_TRUE(gif);
+  // Only the minimum number of frames is cached, so the frames that one
+  // codec decodes are evicted before the other codec displays them.
+  auto first = AnimatedImageFrames::GetShared(gif, CreateGenerator(gif), 0u);
+  auto second = AnimatedImageFrames::GetShared(gif, CreateGenerator(gif), 0u);
+  ASSERT_TRUE(first->SharesFramesWith(*second));
+  AnimatedImageFrames expected_frames(CreateGenerator(gif));
+  const int frame_count = first->GetFrameCount();
+  ASSERT_GT(frame_count, 2 * (AnimatedImageFrames::kDecodeAheadFrameCount + 1));
+
+  const int offset = frame_count / 2;
+  for (int i = 0; i < frame_count * 2; i++) {
+    for (auto [codec, index] :
+         {std::make_pair(first.get(), i % frame_count),
+          std::make_pair(second.get(), (i + offset) % frame_count)}) {
+      auto [expected, expected_error] = expected_frames.GetFrame(index);
+      auto [actual, actual_error] = codec->GetFrame(index);
+      ASSERT_TRUE(expected) << expected_error;
+      ASSERT_TRUE(actual) << actual_error;
+      EXPECT_TRUE(PixelsEqual(*expected, *actual)) << "Frame " << index;
+    }
+  }
+
+  // Each codec decodes every frame it displays once, plus the frames that
+  // the second one goes through to reach its first frame.
+  EXPECT_LE(first->GetDecodedFrameCount(),
+            static_cast<size_t>(frame_count * 2));
+  EXPECT_LE(second->GetDecodedFrameCount(),
+            static_cast<size_t>(frame_count * 2 + offset));
+}
+
+TEST(AnimatedImageFramesTest, DecodesEachFrameOnce) {
+  sk_sp<SkData> gif = OpenFixtureAsSkData("hello_loop_2.gif");
+  ASSERT_TRUE(gif);
+  AnimatedImageFrames frames(CreateGenerator(gif));
+  ASSERT_GT(frames.GetFrameCount(), 1);
+
+  for (int pass = 0; pass < 2; pass++) {
+    for (int i = 0; i < frames.GetFrameCount(); i++) {
+      auto [bitmap, error] = frames.GetFrame(i);
+      ASSERT_TRUE(bitmap) << error;
+      EXPECT_TRUE(bitmap->isImmutable());
+    }
+  }
+  EXPECT_EQ(frames.GetDecodedFrameCount(),
+            static_cast<size_t>(frames.GetFrameCount()));
+}
+
+TEST(AnimatedImageFramesTest, DecodesFramesOutOfOrder) {
+  sk_sp<SkData> gif = OpenFixtureAsSkData("hello_loop_2.gif");
+  ASSERT_TRUE(gif);
+  AnimatedImageFrames sequential(CreateGenerator(gif));
+  AnimatedImageFrames out_of_order(CreateGenerator(gif));
+  const int frame_count = sequential.GetFrameCount();
+  ASSERT_GT(frame_count, 1);
+
+  for (int i = 0; i < frame_count; i++) {
+    auto [expected, expected_error] = sequential.GetFrame(i);
+    ASSERT_TRUE(expected) << expected_error;
+  }
+  for (int i = frame_count - 1; i >= 0; i--) {
+    auto [expected, expected_error] = sequential.GetFrame(i);
+    auto [actual, actual_error] = out_of_order.GetFrame(i);
+    ASSERT_TRUE(expected) << expected_error;
+    ASSERT_TRUE(actual) << actual_error;
+    EXPECT_TRUE(PixelsEqual(*expected, *actual)) << "Frame " << i;
+  }
+  EXPECT_FALSE(out_of_order.GetFrame(frame_count).first);
+}
+
+TEST(AnimatedImageFramesTest, DecodesAheadOfDisplayedFrame) {
+  sk_sp<SkData> gif = OpenFixtureAsSkData("hello_loop_2.gif");
+  ASSERT_TRUE(gif);
+  auto frames = std::make_shared<AnimatedImageFrames>(CreateGenerator(gif));
+  ASSERT_GT(frames->GetFrameCount(), 1);
+  auto loop = fml::ConcurrentMessageLoop::Create(1);
+  auto task_runner = loop->GetTaskRunner();
+
+  ASSERT_TRUE(frames->GetFrame(0).first);
+  EXPECT_EQ(frames->GetDecodedFrameCount(), 1u);
+  frames->DecodeAhead(task_runner, 0);
+
+  // The loop has a single worker, so its tasks run in the order they were
+  // posted in.
+  fml::AutoResetWaitableEvent latch;
+  task_runner->PostTask([&latch]() { latch.Signal(); });
+  latch.Wait();
+
+  const int expected_count = std::min(
+      AnimatedImageFrames::kDecodeAheadFrameCount + 1, frames->GetFrameCount());
+  EXPECT_EQ(frames->GetDecodedFrameCount(),
+            static_cast<size_t>(expected_count));
+  for (int i = 0; i < expected_count; i++) {
+    ASSERT_TRUE(frames->GetFrame(i).first);
+  }
+  EXPECT_EQ(frames->GetDecodedFrameCount(),
+            static_cast<size_t>(expected_count));
+}
+
+}  // namespace testing
+}  // namespace flutter
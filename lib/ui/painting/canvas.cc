@@ -5,14 +5,22 @@
 #include "flutter/lib/ui/painting/canvas.h"
 
 #include <cmath>
+#include <cstring>
+#include <iterator>
+#include <optional>
+#include <string>
+#include <vector>
 
 #include "flutter/display_list/dl_builder.h"
 #include "flutter/lib/ui/floating_point.h"
+#include "flutter/lib/ui/painting/color_filter.h"
 #include "flutter/lib/ui/painting/image.h"
 #include "flutter/lib/ui/painting/image_filter.h"
 #include "flutter/lib/ui/painting/paint.h"
+#include "flutter/lib/ui/painting/shader.h"
 #include "flutter/lib/ui/ui_dart_state.h"
 #include "flutter/lib/ui/window/platform_configuration.h"
+#include "third_party/tonic/typed_data/dart_byte_data.h"
 
 using tonic::ToDart;
 
@@ -20,6 +28,489 @@ namespace flutter {
 
 IMPLEMENT_WRAPPERTYPEINFO(ui, Canvas);
 
+namespace {
+
+constexpr size_t kPaintDataWordCount = Paint::kDataByteCount / sizeof(uint32_t);
+
+// The number of 32-bit arguments that follow each |CanvasCommand|.
+constexpr size_t kCanvasCommandArgumentCounts[] = {
+    0,                        // kSave
+    4,                        // kSaveLayer
+    0,                        // kSaveLayerWithoutBounds
+    0,                        // kRestore
+    2,                        // kTranslate
+    2,                        // kScale
+    1,                        // kRotate
+    6,                        // kClipRect
+    13,                       // kClipRRect
+    2,                        // kClipPath
+    3 + kPaintDataWordCount,  // kSetPaint
+    2,                        // kDrawColor
+    4,                        // kDrawLine
+    0,                        // kDrawPaint
+    4,                        // kDrawRect
+    12,                       // kDrawRRect
+    4,                        // kDrawOval
+    3,                        // kDrawCircle
+    1,                        // kDrawPath
+    4,                        // kDrawImage
+    1,                        // kDrawPicture
+};
+static_assert(std::size(kCanvasCommandArgumentCounts) ==
+                  static_cast<size_t>(CanvasCommand::kDrawPicture) + 1,
+              "Every CanvasCommand must have an argument count.");
+
+// Reads the arguments of a single command. The caller checks that all of
+// the arguments are within the command data before reading them.
+class CanvasCommandArguments {
+ public:
+  explicit CanvasCommandArguments(const uint32_t* words) : words_(words) {}
+
+  uint32_t ReadUint() { return *words_++; }
+
+  int32_t ReadInt() { return static_cast<int32_t>(*words_++); }
+
+  bool ReadBool() { return *words_++ != 0u; }
+
+  float ReadFloat() {
+    float value;
+    std::memcpy(&value, words_++, sizeof(value));
+    return value;
+  }
+
+  SkPoint ReadPoint() {
+    float x = ReadFloat();
+    float y = ReadFloat();
+    return SkPoint::Make(x, y);
+  }
+
+  SkRect ReadRect() {
+    float left = ReadFloat();
+    float top = ReadFloat();
+    float right = ReadFloat();
+    float bottom = ReadFloat();
+    return SkRect::MakeLTRB(left, top, right, bottom);
+  }
+
+  // Same layout as the Float32List of a Dart RRect.
+  SkRRect ReadRRect() {
+    SkRect rect = ReadRect();
+    SkVector radii[4];
+    for (SkVector& radius : radii) {
+      radius = ReadPoint();
+    }
+    SkRRect rrect;
+    rrect.setRectRadii(rect, radii);
+    return rrect;
+  }
+
+  const uint32_t* Skip(size_t count) {
+    const uint32_t* skipped = words_;
+    words_ += count;
+    return skipped;
+  }
+
+ private:
+  const uint32_t* words_;
+};
+
+// The dart:ui classes that wrap the native objects that commands can refer
+// to. A DartWrappable carries no type information of its own, so objects
+// are checked against these classes before they are unwrapped.
+constexpr const char* kCanvasCommandObjectClasses[] = {
+    "_NativePath",     //
+    "_Image",          //
+    "_NativePicture",  //
+    "Shader",          //
+    "_ColorFilter",    //
+    "_ImageFilter",    //
+};
+
+// The index into |kCanvasCommandObjectClasses| of the class that wraps a T.
+template <typename T>
+struct CanvasCommandObjectClass;
+
+template <>
+struct CanvasCommandObjectClass<CanvasPath> {
+  static constexpr int kIndex = 0;
+};
+
+template <>
+struct CanvasCommandObjectClass<CanvasImage> {
+  static constexpr int kIndex = 1;
+};
+
+template <>
+struct CanvasCommandObjectClass<Picture> {
+  static constexpr int kIndex = 2;
+};
+
+template <>
+struct CanvasCommandObjectClass<Shader> {
+  static constexpr int kIndex = 3;
+};
+
+template <>
+struct CanvasCommandObjectClass<ColorFilter> {
+  static constexpr int kIndex = 4;
+};
+
+template <>
+struct CanvasCommandObjectClass<ImageFilter> {
+  static constexpr int kIndex = 5;
+};
+
+// The objects that commands refer to by index. The list is read from Dart
+// and every object in it is type checked and unwrapped once for the whole
+// batch of commands, before the command data is acquired.
+class CanvasCommandObjects {
+ public:
+  explicit CanvasCommandObjects(Dart_Handle objects) {
+    intptr_t length = 0;
+    if (Dart_IsNull(objects) ||
+        Dart_IsError(Dart_ListLength(objects, &length)) || length <= 0) {
+      return;
+    }
+    std::vector<Dart_Handle> handles(length);
+    if (Dart_IsError(Dart_ListGetRange(objects, 0, length, handles.data()))) {
+      return;
+    }
+    auto& class_library = tonic::DartState::Current()->class_library();
+    entries_.resize(length);
+    for (intptr_t i = 0; i < length; i++) {
+      if (Dart_IsNull(handles[i])) {
+        continue;
+      }
+      for (size_t c = 0; c < std::size(kCanvasCommandObjectClasses); c++) {
+        bool is_instance = false;
+        Dart_Handle type =
+            class_library.GetClass("ui", kCanvasCommandObjectClasses[c]);
+        if (!Dart_IsError(Dart_ObjectIsType(handles[i], type, &is_instance)) &&
+            is_instance) {
+          entries_[i].class_index = static_cast<int>(c);
+          entries_[i].wrappable =
+              tonic::DartConverterWrappable::FromDart(handles[i]);
+          break;
+        }
+      }
+      if (!entries_[i].wrappable) {
+        entries_[i].class_index = kNotWrapped;
+      }
+    }
+  }
+
+  // Whether |index| refers to a T. An index of -1 or a null entry in the
+  // list is only accepted if |nullable| is set.
+  template <typename T>
+  bool Is(int32_t index, bool nullable) const {
+    if (index == -1) {
+      return nullable;
+    }
+    if (index < 0 || static_cast<size_t>(index) >= entries_.size()) {
+      return false;
+    }
+    const Entry& entry = entries_[index];
+    if (entry.class_index == kNull) {
+      return nullable;
+    }
+    return entry.class_index == CanvasCommandObjectClass<T>::kIndex;
+  }
+
+  // Returns the object at |index|, which must have been checked with
+  // |Is<T>| first, or null for an index of -1 or a null entry.
+  template <typename T>
+  T* Get(int32_t index) const {
+    FML_DCHECK(Is<T>(index, true));
+    if (index < 0) {
+      return nullptr;
+    }
+    return static_cast<T*>(entries_[index].wrappable);
+  }
+
+ private:
+  static constexpr int kNull = -1;
+  static constexpr int kNotWrapped = -2;
+
+  struct Entry {
+    int class_index = kNull;
+    tonic::DartWrappable* wrappable = nullptr;
+  };
+
+  std::vector<Entry> entries_;
+};
+
+// Whether |command| draws with, or saves a layer with, the current paint.
+bool CanvasCommandUsesPaint(CanvasCommand command) {
+  return (command >= CanvasCommand::kDrawLine &&
+          command != CanvasCommand::kDrawPicture) ||
+         command == CanvasCommand::kSaveLayer ||
+         command == CanvasCommand::kSaveLayerWithoutBounds;
+}
+
+// Checks every command in the batch before any of them are recorded, so
+// that malformed data, objects of the wrong type and images that cannot be
+// drawn fail the whole call.
+// Returns an error message, or an empty string if the commands are valid.
+std::string ValidateCanvasCommands(const uint32_t* words,
+                                   size_t word_count,
+                                   const CanvasCommandObjects& objects) {
+  bool has_paint = false;
+  for (size_t i = 0; i < word_count;) {
+    const uint32_t opcode = words[i++];
+    if (opcode >= std::size(kCanvasCommandArgumentCounts)) {
+      return "Unknown canvas command " + std::to_string(opcode) + ".";
+    }
+    const size_t argument_count = kCanvasCommandArgumentCounts[opcode];
+    if (argument_count > word_count - i) {
+      return "Truncated canvas command " + std::to_string(opcode) + ".";
+    }
+    const uint32_t* args = words + i;
+    i += argument_count;
+
+    const CanvasCommand command = static_cast<CanvasCommand>(opcode);
+    if (CanvasCommandUsesPaint(command) && !has_paint) {
+      return "Canvas command " + std::to_string(opcode) +
+             " requires a paint.";
+    }
+    const int32_t object_index = static_cast<int32_t>(args[0]);
+    switch (command) {
+      case CanvasCommand::kClipRect:
+        if (args[4] > static_cast<uint32_t>(DlCanvas::ClipOp::kIntersect)) {
+          return "Unknown clip op " + std::to_string(args[4]) + ".";
+        }
+        break;
+      case CanvasCommand::kClipPath:
+        if (!objects.Is<CanvasPath>(object_index, false)) {
+          return "Canvas.clipPath called with non-genuine Path.";
+        }
+        break;
+      case CanvasCommand::kSetPaint:
+        if (!objects.Is<Shader>(object_index, true) ||
+            !objects.Is<ColorFilter>(static_cast<int32_t>(args[1]), true) ||
+            !objects.Is<ImageFilter>(static_cast<int32_t>(args[2]), true)) {
+          return "Canvas paint set with non-genuine Shader, ColorFilter or "
+                 "ImageFilter.";
+        }
+        has_paint = true;
+        break;
+      case CanvasCommand::kDrawColor:
+        if (args[1] > static_cast<uint32_t>(DlBlendMode::kLastMode)) {
+          return "Unknown blend mode " + std::to_string(args[1]) + ".";
+        }
+        break;
+      case CanvasCommand::kDrawPath:
+        if (!objects.Is<CanvasPath>(object_index, false)) {
+          return "Canvas.drawPath called with non-genuine Path.";
+        }
+        break;
+      case CanvasCommand::kDrawImage: {
+        if (!objects.Is<CanvasImage>(object_index, false)) {
+          return "Canvas.drawImage called with non-genuine Image.";
+        }
+        auto dl_image = objects.Get<CanvasImage>(object_index)->image();
+        if (dl_image) {
+          auto image_error = dl_image->get_error();
+          if (image_error) {
+            return image_error.value();
+          }
+        }
+        break;
+      }
+      case CanvasCommand::kDrawPicture:
+        if (!objects.Is<Picture>(object_index, false)) {
+          return "Canvas.drawPicture called with non-genuine Picture.";
+        }
+        break;
+      default:
+        break;
+    }
+  }
+  return std::string();
+}
+
+// Records the commands into |canvas| and returns an error message, or an
+// empty string if all of the commands were recorded. Nothing is recorded if
+// any of the commands is invalid. Does not allocate any Dart objects, as the
+// command data is acquired while this runs.
+std::string RecordCanvasCommands(DlCanvas& canvas,
+                                 const CanvasCommandObjects& objects,
+                                 const void* data,
+                                 size_t length) {
+  if (length % sizeof(uint32_t) != 0 ||
+      reinterpret_cast<uintptr_t>(data) % alignof(uint32_t) != 0) {
+    return "Canvas commands must be a whole number of aligned 32-bit words.";
+  }
+  const uint32_t* words = static_cast<const uint32_t*>(data);
+  const size_t word_count = length / sizeof(uint32_t);
+
+  std::string error = ValidateCanvasCommands(words, word_count, objects);
+  if (!error.empty()) {
+    return error;
+  }
+
+  const uint32_t* paint_data = nullptr;
+  Paint::Objects paint_objects;
+  // The paint that was last decoded, and the paint data and command it was
+  // decoded for. A run of the same command that shares a |kSetPaint| reuses
+  // it instead of decoding the paint data again.
+  DlPaint dl_paint;
+  const uint32_t* decoded_paint_data = nullptr;
+  CanvasCommand decoded_command = CanvasCommand::kSave;
+  auto decode_paint = [&paint_data, &paint_objects, &dl_paint,
+                       &decoded_paint_data, &decoded_command](
+                          CanvasCommand command,
+                          const DisplayListAttributeFlags& flags,
+                          DlTileMode tile_mode) -> const DlPaint* {
+    FML_DCHECK(paint_data);
+    if (paint_data != decoded_paint_data || command != decoded_command) {
+      dl_paint = DlPaint();
+      Paint::Decode(dl_paint, flags, tile_mode, paint_data, paint_objects);
+      decoded_paint_data = paint_data;
+      decoded_command = command;
+    }
+    return &dl_paint;
+  };
+
+  for (size_t i = 0; i < word_count;) {
+    const uint32_t opcode = words[i++];
+    CanvasCommandArguments args(words + i);
+    i += kCanvasCommandArgumentCounts[opcode];
+
+    const CanvasCommand command = static_cast<CanvasCommand>(opcode);
+    switch (command) {
+      case CanvasCommand::kSave:
+        canvas.Save();
+        break;
+      case CanvasCommand::kSaveLayer:
+      case CanvasCommand::kSaveLayerWithoutBounds: {
+        std::optional<SkRect> bounds;
+        if (command == CanvasCommand::kSaveLayer) {
+          bounds = args.ReadRect();
+        }
+        const DlPaint* save_paint = decode_paint(
+            command, DisplayListOpFlags::kSaveLayerWithPaintFlags,
+            DlTileMode::kDecal);
+        TRACE_EVENT0("flutter", "ui.Canvas::saveLayer (Recorded)");
+        canvas.SaveLayer(bounds ? &bounds.value() : nullptr, save_paint);
+        break;
+      }
+      case CanvasCommand::kRestore:
+        canvas.Restore();
+        break;
+      case CanvasCommand::kTranslate: {
+        SkPoint offset = args.ReadPoint();
+        canvas.Translate(offset.fX, offset.fY);
+        break;
+      }
+      case CanvasCommand::kScale: {
+        SkPoint scale = args.ReadPoint();
+        canvas.Scale(scale.fX, scale.fY);
+        break;
+      }
+      case CanvasCommand::kRotate:
+        canvas.Rotate(args.ReadFloat() * 180.0f / static_cast<float>(M_PI));
+        break;
+      case CanvasCommand::kClipRect: {
+        SkRect rect = args.ReadRect();
+        uint32_t clip_op = args.ReadUint();
+        bool is_aa = args.ReadBool();
+        canvas.ClipRect(rect, static_cast<DlCanvas::ClipOp>(clip_op), is_aa);
+        break;
+      }
+      case CanvasCommand::kClipRRect: {
+        SkRRect rrect = args.ReadRRect();
+        canvas.ClipRRect(rrect, DlCanvas::ClipOp::kIntersect, args.ReadBool());
+        break;
+      }
+      case CanvasCommand::kClipPath: {
+        CanvasPath* path = objects.Get<CanvasPath>(args.ReadInt());
+        canvas.ClipPath(path->path(), DlCanvas::ClipOp::kIntersect,
+                        args.ReadBool());
+        break;
+      }
+      case CanvasCommand::kSetPaint:
+        paint_objects.shader = objects.Get<Shader>(args.ReadInt());
+        paint_objects.color_filter = objects.Get<ColorFilter>(args.ReadInt());
+        paint_objects.image_filter = objects.Get<ImageFilter>(args.ReadInt());
+        paint_data = args.Skip(kPaintDataWordCount);
+        break;
+      case CanvasCommand::kDrawColor: {
+        uint32_t color = args.ReadUint();
+        uint32_t blend_mode = args.ReadUint();
+        canvas.DrawColor(DlColor(color), static_cast<DlBlendMode>(blend_mode));
+        break;
+      }
+      case CanvasCommand::kDrawLine: {
+        SkPoint p0 = args.ReadPoint();
+        SkPoint p1 = args.ReadPoint();
+        decode_paint(command, DisplayListOpFlags::kDrawLineFlags,
+                     DlTileMode::kDecal);
+        canvas.DrawLine(p0, p1, dl_paint);
+        break;
+      }
+      case CanvasCommand::kDrawPaint:
+        decode_paint(command, DisplayListOpFlags::kDrawPaintFlags,
+                     DlTileMode::kClamp);
+        canvas.DrawPaint(dl_paint);
+        break;
+      case CanvasCommand::kDrawRect:
+        decode_paint(command, DisplayListOpFlags::kDrawRectFlags,
+                     DlTileMode::kDecal);
+        canvas.DrawRect(args.ReadRect(), dl_paint);
+        break;
+      case CanvasCommand::kDrawRRect:
+        decode_paint(command, DisplayListOpFlags::kDrawRRectFlags,
+                     DlTileMode::kDecal);
+        canvas.DrawRRect(args.ReadRRect(), dl_paint);
+        break;
+      case CanvasCommand::kDrawOval:
+        decode_paint(command, DisplayListOpFlags::kDrawOvalFlags,
+                     DlTileMode::kDecal);
+        canvas.DrawOval(args.ReadRect(), dl_paint);
+        break;
+      case CanvasCommand::kDrawCircle: {
+        SkPoint center = args.ReadPoint();
+        float radius = args.ReadFloat();
+        decode_paint(command, DisplayListOpFlags::kDrawCircleFlags,
+                     DlTileMode::kDecal);
+        canvas.DrawCircle(center, radius, dl_paint);
+        break;
+      }
+      case CanvasCommand::kDrawPath: {
+        CanvasPath* path = objects.Get<CanvasPath>(args.ReadInt());
+        decode_paint(command, DisplayListOpFlags::kDrawPathFlags,
+                     DlTileMode::kDecal);
+        canvas.DrawPath(path->path(), dl_paint);
+        break;
+      }
+      case CanvasCommand::kDrawImage: {
+        CanvasImage* image = objects.Get<CanvasImage>(args.ReadInt());
+        SkPoint point = args.ReadPoint();
+        auto sampling = ImageFilter::SamplingFromIndex(args.ReadInt());
+        auto dl_image = image->image();
+        if (!dl_image) {
+          break;
+        }
+        canvas.DrawImage(
+            dl_image, point, sampling,
+            decode_paint(command, DisplayListOpFlags::kDrawImageWithPaintFlags,
+                         DlTileMode::kClamp));
+        break;
+      }
+      case CanvasCommand::kDrawPicture: {
+        Picture* picture = objects.Get<Picture>(args.ReadInt());
+        if (picture->display_list()) {
+          canvas.DrawDisplayList(picture->display_list());
+        }
+        break;
+      }
+    }
+  }
+  return std::string();
+}
+
+}  // namespace
+
 void Canvas::Create(Dart_Handle wrapper,
                     PictureRecorder* recorder,
                     double left,
@@ -652,6 +1143,27 @@ void Canvas::drawShadow(const CanvasPath* path,
   }
 }
 
+Dart_Handle Canvas::drawCommands(Dart_Handle objects, Dart_Handle commands) {
+  if (!display_list_builder_) {
+    return Dart_Null();
+  }
+  TRACE_EVENT0("flutter", "ui.Canvas::drawCommands");
+
+  CanvasCommandObjects command_objects(objects);
+  std::string error;
+  {
+    // The objects were unwrapped above, as the Dart API may not be used
+    // while the command data is acquired.
+    tonic::DartByteData data(commands);
+    error = RecordCanvasCommands(*builder(), command_objects, data.data(),
+                                 data.length_in_bytes());
+  }
+  if (!error.empty()) {
+    return ToDart(error);
+  }
+  return Dart_Null();
+}
+
 void Canvas::Invalidate() {
   display_list_builder_ = nullptr;
   if (dart_wrapper()) {
@@ -18,6 +18,40 @@
 namespace flutter {
 class CanvasImage;
 
+// The commands that can be packed into the data passed to
+// |Canvas::drawCommands|. Every command is a 32-bit opcode followed by a
+// fixed number of 32-bit arguments, listed next to each command. Floats are
+// IEEE 754 single precision values, booleans are 0 or 1 and object indices
+// refer to the objects list passed along with the commands, or are -1 for
+// null.
+//
+// The draw commands and save layers use the paint that was set by the most
+// recent |kSetPaint| command in the same batch.
+enum class CanvasCommand : uint32_t {
+  kSave,                    // -
+  kSaveLayer,               // left, top, right, bottom
+  kSaveLayerWithoutBounds,  // -
+  kRestore,                 // -
+  kTranslate,               // dx, dy
+  kScale,                   // sx, sy
+  kRotate,                  // radians
+  kClipRect,                // left, top, right, bottom, clip op, anti alias
+  kClipRRect,               // 12 rrect floats, anti alias
+  kClipPath,                // path index, anti alias
+  kSetPaint,                // shader, color filter and image filter indices,
+                            // followed by the 17 words of paint data
+  kDrawColor,               // color, blend mode
+  kDrawLine,                // x1, y1, x2, y2
+  kDrawPaint,               // -
+  kDrawRect,                // left, top, right, bottom
+  kDrawRRect,               // 12 rrect floats
+  kDrawOval,                // left, top, right, bottom
+  kDrawCircle,              // x, y, radius
+  kDrawPath,                // path index
+  kDrawImage,               // image index, x, y, filter quality
+  kDrawPicture,             // picture index
+};
+
 class Canvas : public RefCountedDartWrappable<Canvas>, DisplayListOpFlags {
   DEFINE_WRAPPERTYPEINFO();
   FML_FRIEND_MAKE_REF_COUNTED(Canvas);
@@ -184,6 +218,18 @@ class Canvas : public RefCountedDartWrappable<Canvas>, DisplayListOpFlags {
                   double elevation,
                   bool transparentOccluder);
 
+  // Records a batch of |CanvasCommand|s packed into the |commands| ByteData
+  // with a single call from Dart. Paints are decoded straight from the
+  // command data and the |objects| List is only read once per batch, which
+  // amortizes the cost of the native call and of unwrapping the paint over
+  // all of the commands in the batch.
+  //
+  // Returns null, or an error message if the commands are malformed, refer
+  // to objects of the wrong type or draw an image that cannot be drawn. All
+  // of the commands are checked first, and none of them are recorded if any
+  // of them is invalid.
+  Dart_Handle drawCommands(Dart_Handle objects, Dart_Handle commands);
+
   void Invalidate();
 
   DisplayListBuilder* builder() { return display_list_builder_.get(); }
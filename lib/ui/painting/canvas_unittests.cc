@@ -0,0 +1,231 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/lib/ui/painting/canvas.h"
+
+#include <cstring>
+#include <memory>
+#include <vector>
+
+#include "flutter/common/task_runners.h"
+#include "flutter/display_list/dl_builder.h"
+#include "flutter/fml/synchronization/waitable_event.h"
+#include "flutter/lib/ui/painting/paint.h"
+#include "flutter/runtime/dart_vm.h"
+#include "flutter/shell/common/shell_test.h"
+#include "flutter/shell/common/thread_host.h"
+#include "flutter/testing/testing.h"
+#include "third_party/tonic/typed_data/dart_byte_data.h"
+
+namespace flutter {
+namespace testing {
+
+namespace {
+
+uint32_t Word(CanvasCommand command) {
+  return static_cast<uint32_t>(command);
+}
+
+uint32_t Word(float value) {
+  uint32_t word;
+  std::memcpy(&word, &value, sizeof(word));
+  return word;
+}
+
+Dart_Handle MakeCommands(const std::vector<uint32_t>& words) {
+  return tonic::DartByteData::Create(words.data(),
+                                     words.size() * sizeof(uint32_t));
+}
+
+Dart_Handle MakeObjects(const std::vector<Dart_Handle>& objects) {
+  Dart_Handle list = Dart_NewListOfType(Dart_TypeDynamic(), objects.size());
+  for (size_t i = 0; i < objects.size(); i++) {
+    Dart_ListSetAt(list, i, objects[i]);
+  }
+  return list;
+}
+
+// A kSetPaint command for an opaque black fill without any objects.
+std::vector<uint32_t> SetPaint() {
+  std::vector<uint32_t> words = {Word(CanvasCommand::kSetPaint),
+                                 static_cast<uint32_t>(-1),
+                                 static_cast<uint32_t>(-1),
+                                 static_cast<uint32_t>(-1)};
+  words.resize(words.size() + Paint::kDataByteCount / sizeof(uint32_t), 0u);
+  return words;
+}
+
+std::vector<uint32_t> DrawRect() {
+  return {Word(CanvasCommand::kDrawRect), Word(0.0f), Word(0.0f),
+          Word(10.0f), Word(10.0f)};
+}
+
+std::vector<uint32_t> Concat(
+    std::initializer_list<std::vector<uint32_t>> parts) {
+  std::vector<uint32_t> words;
+  for (const auto& part : parts) {
+    words.insert(words.end(), part.begin(), part.end());
+  }
+  return words;
+}
+
+}  // namespace
+
+TEST_F(ShellTest, CanvasDrawCommandsValidatesTheWholeBatch) {
+  auto message_latch = std::make_shared<fml::AutoResetWaitableEvent>();
+
+  auto native_validate_canvas_commands = [message_latch](
+                                             Dart_NativeArguments args) {
+    intptr_t peer = 0;
+    Dart_Handle result = Dart_GetNativeInstanceField(
+        Dart_GetNativeArgument(args, 0), tonic::DartWrappable::kPeerIndex,
+        &peer);
+    ASSERT_FALSE(Dart_IsError(result));
+    Canvas* canvas = reinterpret_cast<Canvas*>(peer);
+    ASSERT_TRUE(canvas);
+    Dart_Handle path = Dart_GetNativeArgument(args, 1);
+    Dart_Handle picture = Dart_GetNativeArgument(args, 2);
+
+    // Returns the number of ops that were recorded by the call, which
+    // includes the attribute ops that the paint is recorded with.
+    auto draw = [canvas](Dart_Handle objects,
+                         const std::vector<uint32_t>& commands,
+                         bool expect_error) {
+      Dart_Handle error =
+          canvas->drawCommands(objects, MakeCommands(commands));
+      EXPECT_EQ(Dart_IsString(error), expect_error);
+      EXPECT_EQ(Dart_IsNull(error), !expect_error);
+      return canvas->builder()->Build()->op_count();
+    };
+
+    // A valid batch records every command.
+    EXPECT_GE(draw(MakeObjects({path, picture}),
+                   Concat({SetPaint(),
+                           DrawRect(),
+                           {Word(CanvasCommand::kDrawPath), 0u},
+                           {Word(CanvasCommand::kDrawPicture), 1u}}),
+                   false),
+              3u);
+
+    // Draws keep using the most recent paint, so setting an equal paint
+    // again records the same ops and a different paint adds its attributes.
+    const size_t shared_paint_op_count =
+        draw(Dart_Null(), Concat({SetPaint(), DrawRect(), DrawRect()}), false);
+    EXPECT_GE(shared_paint_op_count, 2u);
+    EXPECT_EQ(draw(Dart_Null(),
+                   Concat({SetPaint(), DrawRect(), SetPaint(), DrawRect()}),
+                   false),
+              shared_paint_op_count);
+    // The red channel is the second word of the paint data, which follows
+    // the opcode and the three object indices.
+    std::vector<uint32_t> set_red_paint = SetPaint();
+    set_red_paint[5] = Word(1.0f);
+    EXPECT_GT(draw(Dart_Null(),
+                   Concat({SetPaint(), DrawRect(), set_red_paint, DrawRect()}),
+                   false),
+              shared_paint_op_count);
+
+    // An object of the wrong type fails the whole call, including the
+    // valid commands before it.
+    EXPECT_EQ(draw(MakeObjects({picture}),
+                   Concat({SetPaint(),
+                           DrawRect(),
+                           {Word(CanvasCommand::kDrawPath), 0u}}),
+                   true),
+              0u);
+    EXPECT_EQ(draw(MakeObjects({path}),
+                   Concat({SetPaint(),
+                           DrawRect(),
+                           {Word(CanvasCommand::kDrawPicture), 0u}}),
+                   true),
+              0u);
+    EXPECT_EQ(draw(MakeObjects({Dart_True()}),
+                   {Word(CanvasCommand::kDrawPicture), 0u}, true),
+              0u);
+
+    // So does a paint object of the wrong type.
+    std::vector<uint32_t> set_paint_with_shader = SetPaint();
+    set_paint_with_shader[1] = 0u;
+    EXPECT_EQ(draw(MakeObjects({path}),
+                   Concat({set_paint_with_shader, DrawRect()}), true),
+              0u);
+
+    // Out of range indices and null objects where one is required.
+    EXPECT_EQ(draw(MakeObjects({path}),
+                   Concat({SetPaint(), {Word(CanvasCommand::kDrawPath), 1u}}),
+                   true),
+              0u);
+    EXPECT_EQ(draw(MakeObjects({path}),
+                   Concat({SetPaint(),
+                           {Word(CanvasCommand::kDrawPath),
+                            static_cast<uint32_t>(-2)}}),
+                   true),
+              0u);
+    EXPECT_EQ(draw(Dart_Null(),
+                   Concat({SetPaint(),
+                           {Word(CanvasCommand::kDrawPath),
+                            static_cast<uint32_t>(-1)}}),
+                   true),
+              0u);
+    EXPECT_EQ(draw(MakeObjects({Dart_Null()}),
+                   {Word(CanvasCommand::kDrawPicture), 0u}, true),
+              0u);
+
+    // Truncated command streams, unknown commands and missing paints.
+    std::vector<uint32_t> truncated = Concat({SetPaint(), DrawRect()});
+    truncated.pop_back();
+    EXPECT_EQ(draw(Dart_Null(), truncated, true), 0u);
+    std::vector<uint32_t> truncated_paint = SetPaint();
+    truncated_paint.pop_back();
+    EXPECT_EQ(draw(Dart_Null(), truncated_paint, true), 0u);
+    EXPECT_EQ(draw(Dart_Null(),
+                   Concat({SetPaint(),
+                           DrawRect(),
+                           {Word(CanvasCommand::kDrawPicture) + 1u}}),
+                   true),
+              0u);
+    EXPECT_EQ(draw(Dart_Null(), DrawRect(), true), 0u);
+
+    // Out of range enum values.
+    EXPECT_EQ(draw(Dart_Null(),
+                   {Word(CanvasCommand::kDrawColor), 0xFF000000u, 1000u},
+                   true),
+              0u);
+    EXPECT_EQ(draw(Dart_Null(),
+                   {Word(CanvasCommand::kClipRect), Word(0.0f), Word(0.0f),
+                    Word(10.0f), Word(10.0f), 2u, 1u},
+                   true),
+              0u);
+
+    message_latch->Signal();
+  };
+
+  Settings settings = CreateSettingsForFixture();
+  TaskRunners task_runners("test",                  // label
+                           GetCurrentTaskRunner(),  // platform
+                           CreateNewThread(),       // raster
+                           CreateNewThread(),       // ui
+                           CreateNewThread()        // io
+  );
+
+  AddNativeCallback("ValidateCanvasCommands",
+                    CREATE_NATIVE_ENTRY(native_validate_canvas_commands));
+
+  std::unique_ptr<Shell> shell = CreateShell(settings, task_runners);
+
+  ASSERT_TRUE(shell->IsSetup());
+  auto configuration = RunConfiguration::InferFromSettings(settings);
+  configuration.SetEntrypoint("drawCanvasCommands");
+
+  shell->RunEngine(std::move(configuration), [](auto result) {
+    ASSERT_EQ(result, Engine::RunStatus::Success);
+  });
+
+  message_latch->Wait();
+
+  DestroyShell(std::move(shell), task_runners);
+}
+
+}  // namespace testing
+}  // namespace flutter
@@ -116,7 +116,7 @@ void ImageDescriptor::instantiateCodec(Dart_Handle codec_handle,
         static_cast<fml::RefPtr<ImageDescriptor>>(this), target_width,
         target_height);
   } else {
-    ui_codec = fml::MakeRefCounted<MultiFrameCodec>(generator_);
+    ui_codec = fml::MakeRefCounted<MultiFrameCodec>(generator_, buffer_);
   }
   ui_codec->AssociateWithDartWrapper(codec_handle);
 }
@@ -13,7 +13,6 @@
 #include "flutter/lib/ui/painting/image_decoder_impeller.h"
 #endif  // IMPELLER_SUPPORTS_RENDERING
 #include "third_party/dart/runtime/include/dart_api.h"
-#include "third_party/skia/include/codec/SkCodecAnimation.h"
 #include "third_party/skia/include/core/SkImage.h"
 #include "third_party/skia/include/core/SkPixelRef.h"
 #include "third_party/skia/include/gpu/ganesh/SkImageGanesh.h"
@@ -21,13 +20,16 @@
 
 namespace flutter {
 
-MultiFrameCodec::MultiFrameCodec(std::shared_ptr<ImageGenerator> generator)
-    : state_(new State(std::move(generator))) {}
+MultiFrameCodec::MultiFrameCodec(std::shared_ptr<ImageGenerator> generator,
+                                 sk_sp<SkData> data)
+    : state_(new State(std::move(generator), std::move(data))) {}
 
 MultiFrameCodec::~MultiFrameCodec() = default;
 
-MultiFrameCodec::State::State(std::shared_ptr<ImageGenerator> generator)
+MultiFrameCodec::State::State(std::shared_ptr<ImageGenerator> generator,
+                              sk_sp<SkData> data)
     : generator_(std::move(generator)),
+      data_(std::move(data)),
       frameCount_(generator_->GetFrameCount()),
       repetitionCount_(generator_->GetPlayCount() ==
                                ImageGenerator::kInfinitePlayCount
@@ -58,100 +60,29 @@ MultiFrameCodec::State::GetNextFrameImage(
     fml::WeakPtr<GrDirectContext> resourceContext,
     const std::shared_ptr<const fml::SyncSwitch>& gpu_disable_sync_switch,
     const std::shared_ptr<impeller::Context>& impeller_context,
-    fml::RefPtr<flutter::SkiaUnrefQueue> unref_queue) {
-  SkBitmap bitmap = SkBitmap();
-  SkImageInfo info = generator_->GetInfo().makeColorType(kN32_SkColorType);
-  if (info.alphaType() == kUnpremul_SkAlphaType) {
-    SkImageInfo updated = info.makeAlphaType(kPremul_SkAlphaType);
-    info = updated;
-  }
-  if (!bitmap.tryAllocPixels(info)) {
-    std::ostringstream ostr;
-    ostr << "Failed to allocate memory for bitmap of size "
-         << info.computeMinByteSize() << "B";
-    std::string decode_error = ostr.str();
-    FML_LOG(ERROR) << decode_error;
-    return std::make_pair(nullptr, decode_error);
-  }
-
-  ImageGenerator::FrameInfo frameInfo =
-      generator_->GetFrameInfo(nextFrameIndex_);
-
-  const int requiredFrameIndex =
-      frameInfo.required_frame.value_or(SkCodec::kNoFrame);
-
-  if (requiredFrameIndex != SkCodec::kNoFrame) {
-    // We are here when the frame said |disposal_method| is
-    // `DisposalMethod::kKeep` or `DisposalMethod::kRestorePrevious` and
-    // |requiredFrameIndex| is set to ex-frame or ex-ex-frame.
-    if (!lastRequiredFrame_.has_value()) {
-      FML_DLOG(INFO)
-          << "Frame " << nextFrameIndex_ << " depends on frame "
-          << requiredFrameIndex
-          << " and no required frames are cached. Using blank slate instead.";
-    } else {
-      // Copy the previous frame's output buffer into the current frame as the
-      // starting point.
-      bitmap.writePixels(lastRequiredFrame_->pixmap());
-      if (restoreBGColorRect_.has_value()) {
-        bitmap.erase(SK_ColorTRANSPARENT, restoreBGColorRect_.value());
-      }
-    }
-  }
-
-  // Write the new frame to the output buffer. The bitmap pixels as supplied
-  // are already set in accordance with the previous frame's disposal policy.
-  if (!generator_->GetPixels(info, bitmap.getPixels(), bitmap.rowBytes(),
-                             nextFrameIndex_, requiredFrameIndex)) {
-    std::ostringstream ostr;
-    ostr << "Could not getPixels for frame " << nextFrameIndex_;
-    std::string decode_error = ostr.str();
-    FML_LOG(ERROR) << decode_error;
-    return std::make_pair(nullptr, decode_error);
-  }
-
-  const bool keep_current_frame =
-      frameInfo.disposal_method == SkCodecAnimation::DisposalMethod::kKeep;
-  const bool restore_previous_frame =
-      frameInfo.disposal_method ==
-      SkCodecAnimation::DisposalMethod::kRestorePrevious;
-  const bool previous_frame_available = lastRequiredFrame_.has_value();
-
-  // Store the current frame in `lastRequiredFrame_` if the frame's disposal
-  // method indicates we should do so.
-  // * When the disposal method is "Keep", the stored frame should always be
-  //   overwritten with the new frame we just crafted.
-  // * When the disposal method is "RestorePrevious", the previously stored
-  //   frame should be retained and used as the backdrop for the next frame
-  //   again. If there isn't already a stored frame, that means we haven't
-  //   rendered any frames yet! When this happens, we just fall back to "Keep"
-  //   behavior and store the current frame as the backdrop of the next frame.
-
-  if (keep_current_frame ||
-      (previous_frame_available && !restore_previous_frame)) {
-    // Replace the stored frame. The `lastRequiredFrame_` will get used as the
-    // starting backdrop for the next frame.
-    lastRequiredFrame_ = bitmap;
-    lastRequiredFrameIndex_ = nextFrameIndex_;
+    fml::RefPtr<flutter::SkiaUnrefQueue> unref_queue,
+    const std::shared_ptr<fml::ConcurrentTaskRunner>& concurrent_runner) {
+  if (!frames_) {
+    frames_ = AnimatedImageFrames::GetShared(data_, generator_);
   }
-
-  if (frameInfo.disposal_method ==
-      SkCodecAnimation::DisposalMethod::kRestoreBGColor) {
-    restoreBGColorRect_ = frameInfo.disposal_rect;
-  } else {
-    restoreBGColorRect_.reset();
+  auto [decoded, decode_error] = frames_->GetFrame(nextFrameIndex_);
+  // Decode the next frames while this one is displayed.
+  frames_->DecodeAhead(concurrent_runner, nextFrameIndex_);
+  if (!decoded) {
+    return std::make_pair(nullptr, std::move(decode_error));
   }
 
 #if IMPELLER_SUPPORTS_RENDERING
   if (is_impeller_enabled_) {
     // This is safe regardless of whether the GPU is available or not because
     // without mipmap creation there is no command buffer encoding done.
-    return ImageDecoderImpeller::UploadTextureToStorage(
-        impeller_context, std::make_shared<SkBitmap>(bitmap));
+    return ImageDecoderImpeller::UploadTextureToStorage(impeller_context,
+                                                        decoded);
   }
 #endif  // IMPELLER_SUPPORTS_RENDERING
 
 #if !SLIMPELLER
+  const SkBitmap& bitmap = *decoded;
   sk_sp<SkImage> skImage;
   gpu_disable_sync_switch->Execute(
       fml::SyncSwitch::Handlers()
@@ -189,7 +120,8 @@ void MultiFrameCodec::State::GetNextFrameAndInvokeCallback(
     fml::RefPtr<flutter::SkiaUnrefQueue> unref_queue,
     const std::shared_ptr<const fml::SyncSwitch>& gpu_disable_sync_switch,
     size_t trace_id,
-    const std::shared_ptr<impeller::Context>& impeller_context) {
+    const std::shared_ptr<impeller::Context>& impeller_context,
+    const std::shared_ptr<fml::ConcurrentTaskRunner>& concurrent_runner) {
 #if FML_OS_IOS_SIMULATOR
   // Noop backend.
   if (!resourceContext && !impeller_context) {
@@ -207,13 +139,12 @@ void MultiFrameCodec::State::GetNextFrameAndInvokeCallback(
   std::string decode_error;
   std::tie(dlImage, decode_error) =
       GetNextFrameImage(std::move(resourceContext), gpu_disable_sync_switch,
-                        impeller_context, std::move(unref_queue));
+                        impeller_context, std::move(unref_queue),
+                        concurrent_runner);
   if (dlImage) {
     image = CanvasImage::Create();
     image->set_image(dlImage);
-    ImageGenerator::FrameInfo frameInfo =
-        generator_->GetFrameInfo(nextFrameIndex_);
-    duration = frameInfo.duration;
+    duration = frames_->GetFrameDuration(nextFrameIndex_);
   }
   nextFrameIndex_ = (nextFrameIndex_ + 1) % frameCount_;
 
@@ -257,7 +188,8 @@ Dart_Handle MultiFrameCodec::getNextFrame(Dart_Handle callback_handle) {
            tonic::DartState::Current(), callback_handle),
        weak_state = std::weak_ptr<MultiFrameCodec::State>(state_), trace_id,
        ui_task_runner = task_runners.GetUITaskRunner(),
-       io_manager = dart_state->GetIOManager()]() mutable {
+       io_manager = dart_state->GetIOManager(),
+       concurrent_runner = dart_state->GetConcurrentTaskRunner()]() mutable {
         auto state = weak_state.lock();
         if (!state) {
           ui_task_runner->PostTask(fml::MakeCopyable(
@@ -268,7 +200,7 @@ Dart_Handle MultiFrameCodec::getNextFrame(Dart_Handle callback_handle) {
             std::move(callback), ui_task_runner,
             io_manager->GetResourceContext(), io_manager->GetSkiaUnrefQueue(),
             io_manager->GetIsGpuDisabledSyncSwitch(), trace_id,
-            io_manager->GetImpellerContext());
+            io_manager->GetImpellerContext(), concurrent_runner);
       }));
 
   return Dart_Null();
@@ -6,6 +6,7 @@
 #define FLUTTER_LIB_UI_PAINTING_MULTI_FRAME_CODEC_H_
 
 #include "flutter/fml/macros.h"
+#include "flutter/lib/ui/painting/animated_image_frames.h"
 #include "flutter/lib/ui/painting/codec.h"
 #include "flutter/lib/ui/painting/image_generator.h"
 
@@ -15,7 +16,10 @@ namespace flutter {
 
 class MultiFrameCodec : public Codec {
  public:
-  explicit MultiFrameCodec(std::shared_ptr<ImageGenerator> generator);
+  // If |data| is the encoded image that |generator| decodes, the decoded
+  // frames are shared with the other codecs for the same image.
+  explicit MultiFrameCodec(std::shared_ptr<ImageGenerator> generator,
+                           sk_sp<SkData> data = nullptr);
 
   ~MultiFrameCodec() override;
 
@@ -39,9 +43,10 @@ class MultiFrameCodec : public Codec {
   // shares it with the IO task runner's decoding work, and sets the live_
   // member to false when it is destructed.
   struct State {
-    explicit State(std::shared_ptr<ImageGenerator> generator);
+    State(std::shared_ptr<ImageGenerator> generator, sk_sp<SkData> data);
 
     const std::shared_ptr<ImageGenerator> generator_;
+    const sk_sp<SkData> data_;
     const int frameCount_;
     const int repetitionCount_;
     bool is_impeller_enabled_ = false;
@@ -50,20 +55,16 @@ class MultiFrameCodec : public Codec {
     // to on the IO thread. They are not safe to access or write on the UI
     // thread.
     int nextFrameIndex_ = 0;
-    // The last decoded frame that's required to decode any subsequent frames.
-    std::optional<SkBitmap> lastRequiredFrame_;
-    // The index of the last decoded required frame.
-    int lastRequiredFrameIndex_ = -1;
-
-    // The rectangle that should be cleared if the previous frame's disposal
-    // method was kRestoreBGColor.
-    std::optional<SkIRect> restoreBGColorRect_;
+    // The decoded frames, created on the IO thread when the first frame is
+    // requested.
+    std::shared_ptr<AnimatedImageFrames> frames_;
 
     std::pair<sk_sp<DlImage>, std::string> GetNextFrameImage(
         fml::WeakPtr<GrDirectContext> resourceContext,
         const std::shared_ptr<const fml::SyncSwitch>& gpu_disable_sync_switch,
         const std::shared_ptr<impeller::Context>& impeller_context,
-        fml::RefPtr<flutter::SkiaUnrefQueue> unref_queue);
+        fml::RefPtr<flutter::SkiaUnrefQueue> unref_queue,
+        const std::shared_ptr<fml::ConcurrentTaskRunner>& concurrent_runner);
 
     void GetNextFrameAndInvokeCallback(
         std::unique_ptr<tonic::DartPersistentValue> callback,
@@ -72,7 +73,8 @@ class MultiFrameCodec : public Codec {
         fml::RefPtr<flutter::SkiaUnrefQueue> unref_queue,
         const std::shared_ptr<const fml::SyncSwitch>& gpu_disable_sync_switch,
         size_t trace_id,
-        const std::shared_ptr<impeller::Context>& impeller_context);
+        const std::shared_ptr<impeller::Context>& impeller_context,
+        const std::shared_ptr<fml::ConcurrentTaskRunner>& concurrent_runner);
   };
 
   // Shared across the UI and IO task runners.
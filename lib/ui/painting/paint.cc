@@ -39,8 +39,8 @@ constexpr int kMaskFilterIndex = 13;
 constexpr int kMaskFilterBlurStyleIndex = 14;
 constexpr int kMaskFilterSigmaIndex = 15;
 constexpr int kInvertColorIndex = 16;
-constexpr size_t kDataByteCount = 68;  // 4 * (last index + 1)
-static_assert(kDataByteCount == sizeof(uint32_t) * (kInvertColorIndex + 1),
+static_assert(Paint::kDataByteCount ==
+                  sizeof(uint32_t) * (kInvertColorIndex + 1),
               "kDataByteCount must match the size of the data array.");
 
 // Indices for objects.
@@ -61,9 +61,9 @@ constexpr float kStrokeMiterLimitDefault = 4.0f;
 enum MaskFilterType { kNull, kBlur };
 
 namespace {
-DlColor ReadColor(const tonic::DartByteData& byte_data) {
-  const uint32_t* uint_data = static_cast<const uint32_t*>(byte_data.data());
-  const float* float_data = static_cast<const float*>(byte_data.data());
+DlColor ReadColor(const void* data) {
+  const uint32_t* uint_data = static_cast<const uint32_t*>(data);
+  const float* float_data = static_cast<const float*>(data);
 
   float red = float_data[kColorRedIndex];
   float green = float_data[kColorGreenIndex];
@@ -91,75 +91,75 @@ const DlPaint* Paint::paint(DlPaint& paint,
   tonic::DartByteData byte_data(paint_data_);
   FML_CHECK(byte_data.length_in_bytes() == kDataByteCount);
 
-  const uint32_t* uint_data = static_cast<const uint32_t*>(byte_data.data());
-  const float* float_data = static_cast<const float*>(byte_data.data());
-
-  Dart_Handle values[kObjectCount];
-  if (Dart_IsNull(paint_objects_)) {
-    if (flags.applies_shader()) {
-      paint.setColorSource(nullptr);
-    }
-    if (flags.applies_color_filter()) {
-      paint.setColorFilter(nullptr);
-    }
-    if (flags.applies_image_filter()) {
-      paint.setImageFilter(nullptr);
-    }
-  } else {
+  Objects objects;
+  if (!Dart_IsNull(paint_objects_)) {
     FML_DCHECK(Dart_IsList(paint_objects_));
     intptr_t length = 0;
     Dart_ListLength(paint_objects_, &length);
 
     FML_CHECK(length == kObjectCount);
+    Dart_Handle values[kObjectCount];
     if (Dart_IsError(
             Dart_ListGetRange(paint_objects_, 0, kObjectCount, values))) {
       return nullptr;
     }
 
-    if (flags.applies_shader()) {
-      Dart_Handle shader = values[kShaderIndex];
-      if (Dart_IsNull(shader)) {
-        paint.setColorSource(nullptr);
-      } else {
-        if (Shader* decoded = tonic::DartConverter<Shader*>::FromDart(shader)) {
-          auto sampling =
-              ImageFilter::SamplingFromIndex(uint_data[kFilterQualityIndex]);
-          paint.setColorSource(decoded->shader(sampling));
-        } else {
-          paint.setColorSource(nullptr);
-        }
-      }
+    if (flags.applies_shader() && !Dart_IsNull(values[kShaderIndex])) {
+      objects.shader =
+          tonic::DartConverter<Shader*>::FromDart(values[kShaderIndex]);
     }
-
-    if (flags.applies_color_filter()) {
-      Dart_Handle color_filter = values[kColorFilterIndex];
-      if (Dart_IsNull(color_filter)) {
-        paint.setColorFilter(nullptr);
-      } else {
-        ColorFilter* decoded =
-            tonic::DartConverter<ColorFilter*>::FromDart(color_filter);
-        paint.setColorFilter(decoded->filter());
-      }
+    if (flags.applies_color_filter() &&
+        !Dart_IsNull(values[kColorFilterIndex])) {
+      objects.color_filter = tonic::DartConverter<ColorFilter*>::FromDart(
+          values[kColorFilterIndex]);
     }
+    if (flags.applies_image_filter() &&
+        !Dart_IsNull(values[kImageFilterIndex])) {
+      objects.image_filter = tonic::DartConverter<ImageFilter*>::FromDart(
+          values[kImageFilterIndex]);
+    }
+  }
 
-    if (flags.applies_image_filter()) {
-      Dart_Handle image_filter = values[kImageFilterIndex];
-      if (Dart_IsNull(image_filter)) {
-        paint.setImageFilter(nullptr);
-      } else {
-        ImageFilter* decoded =
-            tonic::DartConverter<ImageFilter*>::FromDart(image_filter);
-        paint.setImageFilter(decoded->filter(tile_mode));
-      }
+  Decode(paint, flags, tile_mode, byte_data.data(), objects);
+  return &paint;
+}
+
+// static
+void Paint::Decode(DlPaint& paint,
+                   const DisplayListAttributeFlags& flags,
+                   DlTileMode tile_mode,
+                   const void* data,
+                   const Objects& objects) {
+  const uint32_t* uint_data = static_cast<const uint32_t*>(data);
+  const float* float_data = static_cast<const float*>(data);
+
+  if (flags.applies_shader()) {
+    if (objects.shader) {
+      auto sampling =
+          ImageFilter::SamplingFromIndex(uint_data[kFilterQualityIndex]);
+      paint.setColorSource(objects.shader->shader(sampling));
+    } else {
+      paint.setColorSource(nullptr);
     }
   }
 
+  if (flags.applies_color_filter()) {
+    paint.setColorFilter(objects.color_filter ? objects.color_filter->filter()
+                                              : nullptr);
+  }
+
+  if (flags.applies_image_filter()) {
+    paint.setImageFilter(
+        objects.image_filter ? objects.image_filter->filter(tile_mode)
+                             : nullptr);
+  }
+
   if (flags.applies_anti_alias()) {
     paint.setAntiAlias(uint_data[kIsAntiAliasIndex] == 0);
   }
 
   if (flags.applies_alpha_or_color()) {
-    paint.setColor(ReadColor(byte_data));
+    paint.setColor(ReadColor(data));
   }
 
   if (flags.applies_blend()) {
@@ -205,8 +205,6 @@ const DlPaint* Paint::paint(DlPaint& paint,
         break;
     }
   }
-
-  return &paint;
 }
 
 void Paint::toDlPaint(DlPaint& paint, DlTileMode tile_mode) const {
@@ -259,7 +257,7 @@ void Paint::toDlPaint(DlPaint& paint, DlTileMode tile_mode) const {
 
   paint.setAntiAlias(uint_data[kIsAntiAliasIndex] == 0);
 
-  paint.setColor(ReadColor(byte_data));
+  paint.setColor(ReadColor(byte_data.data()));
 
   uint32_t encoded_blend_mode = uint_data[kBlendModeIndex];
   uint32_t blend_mode = encoded_blend_mode ^ kBlendModeDefault;
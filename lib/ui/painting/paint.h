@@ -12,8 +12,23 @@
 
 namespace flutter {
 
+class ColorFilter;
+class ImageFilter;
+class Shader;
+
 class Paint {
  public:
+  // The size of the paint data ByteData.
+  // Must match //lib/ui/painting.dart.
+  static constexpr size_t kDataByteCount = 68;
+
+  // The native objects that a paint refers to, any of which may be null.
+  struct Objects {
+    Shader* shader = nullptr;
+    ColorFilter* color_filter = nullptr;
+    ImageFilter* image_filter = nullptr;
+  };
+
   Paint() = default;
   Paint(Dart_Handle paint_objects, Dart_Handle paint_data);
 
@@ -21,6 +36,16 @@ class Paint {
                        const DisplayListAttributeFlags& flags,
                        DlTileMode tile_mode) const;
 
+  // Decodes the attributes selected by |flags| into |paint| from |data|,
+  // which holds |kDataByteCount| bytes laid out like the paint data
+  // ByteData, and from |objects| that were already unwrapped by the caller.
+  // Does not call into the Dart VM.
+  static void Decode(DlPaint& paint,
+                     const DisplayListAttributeFlags& flags,
+                     DlTileMode tile_mode,
+                     const void* data,
+                     const Objects& objects);
+
   void toDlPaint(DlPaint& paint, DlTileMode tile_mode) const;
 
   bool isNull() const { return Dart_IsNull(paint_data_); }
@@ -22,7 +22,11 @@ typedef CanvasPath Path;
 
 IMPLEMENT_WRAPPERTYPEINFO(ui, Path);
 
-CanvasPath::CanvasPath() {
+CanvasPath::CanvasPath()
+    : build_impeller_path_(UIDartState::Current()->IsImpellerEnabled()) {
+  if (build_impeller_path_) {
+    path_builder_ = std::make_unique<impeller::PathBuilder>();
+  }
   sk_path_.setIsVolatile(
       !UIDartState::Current()->IsDeterministicRenderingEnabled());
   resetVolatility();
@@ -34,6 +38,23 @@ void CanvasPath::resetVolatility() {
   dl_path_.reset();
 }
 
+SkPath& CanvasPath::mutable_sk_path() {
+  if (path_builder_) {
+    SkPathFillType fill_type = sk_path_.getFillType();
+    bool is_volatile = sk_path_.isVolatile();
+    // Reuse the SkPath that rendering the path with Skia may have generated.
+    if (dl_path_.has_value()) {
+      sk_path_ = dl_path_->GetSkPath();
+    } else {
+      sk_path_ = DlPath(path_builder_->TakePath(), is_volatile).GetSkPath();
+    }
+    sk_path_.setFillType(fill_type);
+    sk_path_.setIsVolatile(is_volatile);
+    path_builder_.reset();
+  }
+  return sk_path_;
+}
+
 int CanvasPath::getFillType() {
   return static_cast<int>(sk_path_.getFillType());
 }
@@ -44,28 +65,54 @@ void CanvasPath::setFillType(int fill_type) {
 }
 
 void CanvasPath::moveTo(double x, double y) {
-  sk_path_.moveTo(SafeNarrow(x), SafeNarrow(y));
+  if (path_builder_) {
+    path_builder_->MoveTo(DlPoint(SafeNarrow(x), SafeNarrow(y)));
+    path_builder_closed_ = false;
+  } else {
+    sk_path_.moveTo(SafeNarrow(x), SafeNarrow(y));
+  }
   resetVolatility();
 }
 
 void CanvasPath::relativeMoveTo(double x, double y) {
-  sk_path_.rMoveTo(SafeNarrow(x), SafeNarrow(y));
+  if (path_builder_ && !path_builder_closed_) {
+    path_builder_->MoveTo(DlPoint(SafeNarrow(x), SafeNarrow(y)),
+                          /*relative=*/true);
+  } else {
+    mutable_sk_path().rMoveTo(SafeNarrow(x), SafeNarrow(y));
+  }
   resetVolatility();
 }
 
 void CanvasPath::lineTo(double x, double y) {
-  sk_path_.lineTo(SafeNarrow(x), SafeNarrow(y));
+  if (path_builder_) {
+    path_builder_->LineTo(DlPoint(SafeNarrow(x), SafeNarrow(y)));
+    path_builder_closed_ = false;
+  } else {
+    sk_path_.lineTo(SafeNarrow(x), SafeNarrow(y));
+  }
   resetVolatility();
 }
 
 void CanvasPath::relativeLineTo(double x, double y) {
-  sk_path_.rLineTo(SafeNarrow(x), SafeNarrow(y));
+  if (path_builder_ && !path_builder_closed_) {
+    path_builder_->LineTo(DlPoint(SafeNarrow(x), SafeNarrow(y)),
+                          /*relative=*/true);
+  } else {
+    mutable_sk_path().rLineTo(SafeNarrow(x), SafeNarrow(y));
+  }
   resetVolatility();
 }
 
 void CanvasPath::quadraticBezierTo(double x1, double y1, double x2, double y2) {
-  sk_path_.quadTo(SafeNarrow(x1), SafeNarrow(y1), SafeNarrow(x2),
-                  SafeNarrow(y2));
+  if (path_builder_) {
+    path_builder_->QuadraticCurveTo(DlPoint(SafeNarrow(x1), SafeNarrow(y1)),
+                                    DlPoint(SafeNarrow(x2), SafeNarrow(y2)));
+    path_builder_closed_ = false;
+  } else {
+    sk_path_.quadTo(SafeNarrow(x1), SafeNarrow(y1), SafeNarrow(x2),
+                    SafeNarrow(y2));
+  }
   resetVolatility();
 }
 
@@ -73,8 +120,14 @@ void CanvasPath::relativeQuadraticBezierTo(double x1,
                                            double y1,
                                            double x2,
                                            double y2) {
-  sk_path_.rQuadTo(SafeNarrow(x1), SafeNarrow(y1), SafeNarrow(x2),
-                   SafeNarrow(y2));
+  if (path_builder_ && !path_builder_closed_) {
+    path_builder_->QuadraticCurveTo(DlPoint(SafeNarrow(x1), SafeNarrow(y1)),
+                                    DlPoint(SafeNarrow(x2), SafeNarrow(y2)),
+                                    /*relative=*/true);
+  } else {
+    mutable_sk_path().rQuadTo(SafeNarrow(x1), SafeNarrow(y1), SafeNarrow(x2),
+                              SafeNarrow(y2));
+  }
   resetVolatility();
 }
 
@@ -84,8 +137,15 @@ void CanvasPath::cubicTo(double x1,
                          double y2,
                          double x3,
                          double y3) {
-  sk_path_.cubicTo(SafeNarrow(x1), SafeNarrow(y1), SafeNarrow(x2),
-                   SafeNarrow(y2), SafeNarrow(x3), SafeNarrow(y3));
+  if (path_builder_) {
+    path_builder_->CubicCurveTo(DlPoint(SafeNarrow(x1), SafeNarrow(y1)),
+                                DlPoint(SafeNarrow(x2), SafeNarrow(y2)),
+                                DlPoint(SafeNarrow(x3), SafeNarrow(y3)));
+    path_builder_closed_ = false;
+  } else {
+    sk_path_.cubicTo(SafeNarrow(x1), SafeNarrow(y1), SafeNarrow(x2),
+                     SafeNarrow(y2), SafeNarrow(x3), SafeNarrow(y3));
+  }
   resetVolatility();
 }
 
@@ -95,14 +155,21 @@ void CanvasPath::relativeCubicTo(double x1,
                                  double y2,
                                  double x3,
                                  double y3) {
-  sk_path_.rCubicTo(SafeNarrow(x1), SafeNarrow(y1), SafeNarrow(x2),
-                    SafeNarrow(y2), SafeNarrow(x3), SafeNarrow(y3));
+  if (path_builder_ && !path_builder_closed_) {
+    path_builder_->CubicCurveTo(DlPoint(SafeNarrow(x1), SafeNarrow(y1)),
+                                DlPoint(SafeNarrow(x2), SafeNarrow(y2)),
+                                DlPoint(SafeNarrow(x3), SafeNarrow(y3)),
+                                /*relative=*/true);
+  } else {
+    mutable_sk_path().rCubicTo(SafeNarrow(x1), SafeNarrow(y1), SafeNarrow(x2),
+                               SafeNarrow(y2), SafeNarrow(x3), SafeNarrow(y3));
+  }
   resetVolatility();
 }
 
 void CanvasPath::conicTo(double x1, double y1, double x2, double y2, double w) {
-  sk_path_.conicTo(SafeNarrow(x1), SafeNarrow(y1), SafeNarrow(x2),
-                   SafeNarrow(y2), SafeNarrow(w));
+  mutable_sk_path().conicTo(SafeNarrow(x1), SafeNarrow(y1), SafeNarrow(x2),
+                            SafeNarrow(y2), SafeNarrow(w));
   resetVolatility();
 }
 
@@ -111,8 +178,8 @@ void CanvasPath::relativeConicTo(double x1,
                                  double x2,
                                  double y2,
                                  double w) {
-  sk_path_.rConicTo(SafeNarrow(x1), SafeNarrow(y1), SafeNarrow(x2),
-                    SafeNarrow(y2), SafeNarrow(w));
+  mutable_sk_path().rConicTo(SafeNarrow(x1), SafeNarrow(y1), SafeNarrow(x2),
+                             SafeNarrow(y2), SafeNarrow(w));
   resetVolatility();
 }
 
@@ -123,11 +190,11 @@ void CanvasPath::arcTo(double left,
                        double startAngle,
                        double sweepAngle,
                        bool forceMoveTo) {
-  sk_path_.arcTo(SkRect::MakeLTRB(SafeNarrow(left), SafeNarrow(top),
-                                  SafeNarrow(right), SafeNarrow(bottom)),
-                 SafeNarrow(startAngle) * 180.0f / static_cast<float>(M_PI),
-                 SafeNarrow(sweepAngle) * 180.0f / static_cast<float>(M_PI),
-                 forceMoveTo);
+  mutable_sk_path().arcTo(
+      SkRect::MakeLTRB(SafeNarrow(left), SafeNarrow(top), SafeNarrow(right),
+                       SafeNarrow(bottom)),
+      SafeNarrow(startAngle) * 180.0f / static_cast<float>(M_PI),
+      SafeNarrow(sweepAngle) * 180.0f / static_cast<float>(M_PI), forceMoveTo);
   resetVolatility();
 }
 
@@ -143,9 +210,9 @@ void CanvasPath::arcToPoint(double arcEndX,
   const auto direction =
       isClockwiseDirection ? SkPathDirection::kCW : SkPathDirection::kCCW;
 
-  sk_path_.arcTo(SafeNarrow(radiusX), SafeNarrow(radiusY),
-                 SafeNarrow(xAxisRotation), arcSize, direction,
-                 SafeNarrow(arcEndX), SafeNarrow(arcEndY));
+  mutable_sk_path().arcTo(SafeNarrow(radiusX), SafeNarrow(radiusY),
+                          SafeNarrow(xAxisRotation), arcSize, direction,
+                          SafeNarrow(arcEndX), SafeNarrow(arcEndY));
   resetVolatility();
 }
 
@@ -160,21 +227,23 @@ void CanvasPath::relativeArcToPoint(double arcEndDeltaX,
                                   : SkPath::ArcSize::kSmall_ArcSize;
   const auto direction =
       isClockwiseDirection ? SkPathDirection::kCW : SkPathDirection::kCCW;
-  sk_path_.rArcTo(SafeNarrow(radiusX), SafeNarrow(radiusY),
-                  SafeNarrow(xAxisRotation), arcSize, direction,
-                  SafeNarrow(arcEndDeltaX), SafeNarrow(arcEndDeltaY));
+  mutable_sk_path().rArcTo(SafeNarrow(radiusX), SafeNarrow(radiusY),
+                           SafeNarrow(xAxisRotation), arcSize, direction,
+                           SafeNarrow(arcEndDeltaX), SafeNarrow(arcEndDeltaY));
   resetVolatility();
 }
 
 void CanvasPath::addRect(double left, double top, double right, double bottom) {
-  sk_path_.addRect(SkRect::MakeLTRB(SafeNarrow(left), SafeNarrow(top),
-                                    SafeNarrow(right), SafeNarrow(bottom)));
+  mutable_sk_path().addRect(SkRect::MakeLTRB(SafeNarrow(left), SafeNarrow(top),
+                                             SafeNarrow(right),
+                                             SafeNarrow(bottom)));
   resetVolatility();
 }
 
 void CanvasPath::addOval(double left, double top, double right, double bottom) {
-  sk_path_.addOval(SkRect::MakeLTRB(SafeNarrow(left), SafeNarrow(top),
-                                    SafeNarrow(right), SafeNarrow(bottom)));
+  mutable_sk_path().addOval(SkRect::MakeLTRB(SafeNarrow(left), SafeNarrow(top),
+                                             SafeNarrow(right),
+                                             SafeNarrow(bottom)));
   resetVolatility();
 }
 
@@ -184,21 +253,38 @@ void CanvasPath::addArc(double left,
                         double bottom,
                         double startAngle,
                         double sweepAngle) {
-  sk_path_.addArc(SkRect::MakeLTRB(SafeNarrow(left), SafeNarrow(top),
-                                   SafeNarrow(right), SafeNarrow(bottom)),
-                  SafeNarrow(startAngle) * 180.0f / static_cast<float>(M_PI),
-                  SafeNarrow(sweepAngle) * 180.0f / static_cast<float>(M_PI));
+  mutable_sk_path().addArc(
+      SkRect::MakeLTRB(SafeNarrow(left), SafeNarrow(top), SafeNarrow(right),
+                       SafeNarrow(bottom)),
+      SafeNarrow(startAngle) * 180.0f / static_cast<float>(M_PI),
+      SafeNarrow(sweepAngle) * 180.0f / static_cast<float>(M_PI));
   resetVolatility();
 }
 
 void CanvasPath::addPolygon(const tonic::Float32List& points, bool close) {
+  if (path_builder_) {
+    const DlPoint* dl_points = reinterpret_cast<const DlPoint*>(points.data());
+    size_t count = points.num_elements() / 2;
+    if (count > 0u) {
+      path_builder_->MoveTo(dl_points[0]);
+      for (size_t i = 1u; i < count; i++) {
+        path_builder_->LineTo(dl_points[i]);
+      }
+      if (close) {
+        path_builder_->Close();
+      }
+      path_builder_closed_ = close;
+    }
+    resetVolatility();
+    return;
+  }
   sk_path_.addPoly(reinterpret_cast<const SkPoint*>(points.data()),
                    points.num_elements() / 2, close);
   resetVolatility();
 }
 
 void CanvasPath::addRRect(const RRect& rrect) {
-  sk_path_.addRRect(rrect.sk_rrect);
+  mutable_sk_path().addRRect(rrect.sk_rrect);
   resetVolatility();
 }
 
@@ -207,8 +293,8 @@ void CanvasPath::addPath(CanvasPath* path, double dx, double dy) {
     Dart_ThrowException(ToDart("Path.addPath called with non-genuine Path."));
     return;
   }
-  sk_path_.addPath(path->sk_path_, SafeNarrow(dx), SafeNarrow(dy),
-                   SkPath::kAppend_AddPathMode);
+  mutable_sk_path().addPath(path->mutable_sk_path(), SafeNarrow(dx),
+                            SafeNarrow(dy), SkPath::kAppend_AddPathMode);
   resetVolatility();
 }
 
@@ -229,7 +315,8 @@ void CanvasPath::addPathWithMatrix(CanvasPath* path,
   matrix4.Release();
   matrix.setTranslateX(matrix.getTranslateX() + SafeNarrow(dx));
   matrix.setTranslateY(matrix.getTranslateY() + SafeNarrow(dy));
-  sk_path_.addPath(path->sk_path_, matrix, SkPath::kAppend_AddPathMode);
+  mutable_sk_path().addPath(path->mutable_sk_path(), matrix,
+                            SkPath::kAppend_AddPathMode);
   resetVolatility();
 }
 
@@ -239,8 +326,8 @@ void CanvasPath::extendWithPath(CanvasPath* path, double dx, double dy) {
         ToDart("Path.extendWithPath called with non-genuine Path."));
     return;
   }
-  sk_path_.addPath(path->sk_path_, SafeNarrow(dx), SafeNarrow(dy),
-                   SkPath::kExtend_AddPathMode);
+  mutable_sk_path().addPath(path->mutable_sk_path(), SafeNarrow(dx),
+                            SafeNarrow(dy), SkPath::kExtend_AddPathMode);
   resetVolatility();
 }
 
@@ -261,28 +348,39 @@ void CanvasPath::extendWithPathAndMatrix(CanvasPath* path,
   matrix4.Release();
   matrix.setTranslateX(matrix.getTranslateX() + SafeNarrow(dx));
   matrix.setTranslateY(matrix.getTranslateY() + SafeNarrow(dy));
-  sk_path_.addPath(path->sk_path_, matrix, SkPath::kExtend_AddPathMode);
+  mutable_sk_path().addPath(path->mutable_sk_path(), matrix,
+                            SkPath::kExtend_AddPathMode);
   resetVolatility();
 }
 
 void CanvasPath::close() {
-  sk_path_.close();
+  if (path_builder_) {
+    path_builder_->Close();
+    path_builder_closed_ = true;
+  } else {
+    sk_path_.close();
+  }
   resetVolatility();
 }
 
 void CanvasPath::reset() {
   sk_path_.reset();
+  if (build_impeller_path_) {
+    path_builder_ = std::make_unique<impeller::PathBuilder>();
+    path_builder_closed_ = false;
+  }
   resetVolatility();
 }
 
 bool CanvasPath::contains(double x, double y) {
-  return sk_path_.contains(SafeNarrow(x), SafeNarrow(y));
+  return mutable_sk_path().contains(SafeNarrow(x), SafeNarrow(y));
 }
 
 void CanvasPath::shift(Dart_Handle path_handle, double dx, double dy) {
   fml::RefPtr<CanvasPath> path = Create(path_handle);
+  path->path_builder_.reset();
   auto& other_mutable_path = path->sk_path_;
-  sk_path_.offset(SafeNarrow(dx), SafeNarrow(dy), &other_mutable_path);
+  mutable_sk_path().offset(SafeNarrow(dx), SafeNarrow(dy), &other_mutable_path);
   resetVolatility();
 }
 
@@ -292,13 +390,14 @@ void CanvasPath::transform(Dart_Handle path_handle,
   auto sk_matrix = ToSkMatrix(matrix4);
   matrix4.Release();
   fml::RefPtr<CanvasPath> path = Create(path_handle);
+  path->path_builder_.reset();
   auto& other_mutable_path = path->sk_path_;
-  sk_path_.transform(sk_matrix, &other_mutable_path);
+  mutable_sk_path().transform(sk_matrix, &other_mutable_path);
 }
 
 tonic::Float32List CanvasPath::getBounds() {
   tonic::Float32List rect(Dart_NewTypedData(Dart_TypedData_kFloat32, 4));
-  const SkRect& bounds = sk_path_.getBounds();
+  const SkRect& bounds = mutable_sk_path().getBounds();
   rect[0] = bounds.left();
   rect[1] = bounds.top();
   rect[2] = bounds.right();
@@ -307,22 +406,32 @@ tonic::Float32List CanvasPath::getBounds() {
 }
 
 bool CanvasPath::op(CanvasPath* path1, CanvasPath* path2, int operation) {
-  bool result = Op(path1->sk_path_, path2->sk_path_,
-                   static_cast<SkPathOp>(operation), &sk_path_);
+  bool result = Op(path1->mutable_sk_path(), path2->mutable_sk_path(),
+                   static_cast<SkPathOp>(operation), &mutable_sk_path());
   resetVolatility();
   return result;
 }
 
 void CanvasPath::clone(Dart_Handle path_handle) {
   fml::RefPtr<CanvasPath> path = Create(path_handle);
+  path->path_builder_.reset();
   // per Skia docs, this will create a fast copy
   // data is shared until the source path or dest path are mutated
-  path->sk_path_ = this->sk_path_;
+  path->sk_path_ = mutable_sk_path();
 }
 
 const DlPath& CanvasPath::path() const {
   if (!dl_path_.has_value()) {
-    dl_path_.emplace(sk_path_);
+    if (path_builder_) {
+      impeller::FillType fill_type =
+          sk_path_.getFillType() == SkPathFillType::kEvenOdd
+              ? impeller::FillType::kOdd
+              : impeller::FillType::kNonZero;
+      dl_path_.emplace(path_builder_->CopyPath(fill_type),
+                       sk_path_.isVolatile());
+    } else {
+      dl_path_.emplace(sk_path_);
+    }
   }
   return dl_path_.value();
 }
@@ -5,6 +5,9 @@
 #ifndef FLUTTER_LIB_UI_PAINTING_PATH_H_
 #define FLUTTER_LIB_UI_PAINTING_PATH_H_
 
+#include <memory>
+
+#include "flutter/impeller/geometry/path_builder.h"
 #include "flutter/lib/ui/dart_wrapper.h"
 #include "flutter/lib/ui/painting/rrect.h"
 #include "flutter/lib/ui/ui_dart_state.h"
@@ -24,6 +27,7 @@ class CanvasPath : public RefCountedDartWrappable<CanvasPath> {
   static void CreateFrom(Dart_Handle path_handle, const SkPath& src) {
     auto path = fml::MakeRefCounted<CanvasPath>();
     path->AssociateWithDartWrapper(path_handle);
+    path->path_builder_.reset();
     path->sk_path_ = src;
   }
 
@@ -118,11 +122,27 @@ class CanvasPath : public RefCountedDartWrappable<CanvasPath> {
  private:
   CanvasPath();
 
+  // Whether new contents are built directly into an |impeller::Path|.
+  const bool build_impeller_path_;
+
+  // When Impeller is enabled, the verbs that Skia and Impeller interpret
+  // identically are recorded into |path_builder_|. The first operation that
+  // only Skia supports moves the path into |sk_path_|, where it stays until
+  // the path is reset. While |path_builder_| is in use, |sk_path_| is empty
+  // and only holds the fill type and volatility of the path.
+  std::unique_ptr<impeller::PathBuilder> path_builder_;
+  // Whether the last verb recorded into |path_builder_| was a close, after
+  // which Skia and Impeller disagree on the origin of relative verbs.
+  bool path_builder_closed_ = false;
   SkPath sk_path_;
   mutable std::optional<const DlPath> dl_path_;
 
   // Must be called whenever the path is created or mutated.
   void resetVolatility();
+
+  // Returns the |SkPath| for operations that only Skia supports, moving the
+  // path out of |path_builder_| first if needed.
+  SkPath& mutable_sk_path();
 };
 
 }  // namespace flutter
@@ -4,13 +4,22 @@
 
 #include "flutter/benchmarking/benchmarking.h"
 #include "flutter/common/settings.h"
+#include "flutter/lib/ui/painting/animated_image_frames.h"
+#include "flutter/lib/ui/painting/canvas.h"
+#include "flutter/lib/ui/painting/image_generator_registry.h"
+#include "flutter/lib/ui/painting/paint.h"
 #include "flutter/lib/ui/window/platform_message_response_dart.h"
 #include "flutter/runtime/dart_vm_lifecycle.h"
 #include "flutter/shell/common/thread_host.h"
 #include "flutter/testing/dart_isolate_runner.h"
 #include "flutter/testing/fixture_test.h"
+#include "flutter/testing/testing.h"
+#include "third_party/tonic/scopes/dart_api_scope.h"
+#include "third_party/tonic/typed_data/dart_byte_data.h"
 
+#include <cstring>
 #include <future>
+#include <vector>
 
 namespace flutter {
 
@@ -69,4 +78,248 @@ static void BM_PlatformMessageResponseDartComplete(benchmark::State& state) {
 BENCHMARK(BM_PlatformMessageResponseDartComplete)
     ->Unit(benchmark::kMicrosecond);
 
+// Measures how quickly platform message responses of different sizes reach
+// Dart when the data is either copied first, like
+// |FlutterEngineSendPlatformMessageResponse| does, or handed over as is, like
+// |FlutterEngineSendPlatformMessageResponseNoCopy| does.
+static void RunPlatformMessageResponseThroughputBenchmark(
+    benchmark::State& state,
+    bool copy) {
+  const size_t payload_size = state.range(0);
+  std::vector<uint8_t> payload(payload_size, 0);
+
+  ThreadHost thread_host(ThreadHost::ThreadHostConfig(
+      "test", ThreadHost::Type::kPlatform | ThreadHost::Type::kRaster |
+                  ThreadHost::Type::kIo | ThreadHost::Type::kUi));
+  TaskRunners task_runners("test", thread_host.platform_thread->GetTaskRunner(),
+                           thread_host.raster_thread->GetTaskRunner(),
+                           thread_host.ui_thread->GetTaskRunner(),
+                           thread_host.io_thread->GetTaskRunner());
+  Fixture fixture;
+  auto settings = fixture.CreateSettingsForFixture();
+  auto vm_ref = DartVMRef::Create(settings);
+  auto isolate =
+      testing::RunDartCodeInIsolate(vm_ref, settings, task_runners, "main", {},
+                                    testing::GetDefaultKernelFilePath(), {});
+
+  while (state.KeepRunning()) {
+    bool successful = isolate->RunInIsolateScope([&]() -> bool {
+      std::unique_ptr<fml::Mapping> mapping;
+      if (copy) {
+        mapping = std::make_unique<fml::DataMapping>(payload);
+      } else {
+        mapping = std::make_unique<fml::NonOwnedMapping>(payload.data(),
+                                                         payload.size());
+      }
+
+      Dart_Handle library = Dart_RootLibrary();
+      Dart_Handle closure =
+          Dart_GetField(library, Dart_NewStringFromCString("messageCallback"));
+
+      auto message = fml::MakeRefCounted<PlatformMessageResponseDart>(
+          tonic::DartPersistentValue(isolate->get(), closure),
+          thread_host.ui_thread->GetTaskRunner(), "");
+
+      message->Complete(std::move(mapping));
+
+      return true;
+    });
+    FML_CHECK(successful);
+
+    // Waits for the task that hands the response to Dart.
+    std::promise<bool> completed;
+    task_runners.GetUITaskRunner()->PostTask(
+        [&completed] { completed.set_value(true); });
+    completed.get_future().wait();
+  }
+  state.SetBytesProcessed(state.iterations() * payload_size);
+}
+
+static void BM_PlatformMessageResponseCopied(benchmark::State& state) {
+  RunPlatformMessageResponseThroughputBenchmark(state, /*copy=*/true);
+}
+
+static void BM_PlatformMessageResponseNoCopy(benchmark::State& state) {
+  RunPlatformMessageResponseThroughputBenchmark(state, /*copy=*/false);
+}
+
+BENCHMARK(BM_PlatformMessageResponseCopied)
+    ->Arg(1 << 10)
+    ->Arg(64 << 10)
+    ->Arg(1 << 20)
+    ->Arg(16 << 20)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_PlatformMessageResponseNoCopy)
+    ->Arg(1 << 10)
+    ->Arg(64 << 10)
+    ->Arg(1 << 20)
+    ->Arg(16 << 20)
+    ->Unit(benchmark::kMicrosecond);
+
+// Runs |draw| against a new canvas on every iteration. The isolate is only
+// needed to create the Dart handles that the canvas methods take.
+template <typename Draw>
+static void RunCanvasBenchmark(benchmark::State& state, const Draw& draw) {
+  ThreadHost thread_host(ThreadHost::ThreadHostConfig(
+      "test", ThreadHost::Type::kPlatform | ThreadHost::Type::kRaster |
+                  ThreadHost::Type::kIo | ThreadHost::Type::kUi));
+  TaskRunners task_runners("test", thread_host.platform_thread->GetTaskRunner(),
+                           thread_host.raster_thread->GetTaskRunner(),
+                           thread_host.ui_thread->GetTaskRunner(),
+                           thread_host.io_thread->GetTaskRunner());
+  Fixture fixture;
+  auto settings = fixture.CreateSettingsForFixture();
+  auto vm_ref = DartVMRef::Create(settings);
+  auto isolate =
+      testing::RunDartCodeInIsolate(vm_ref, settings, task_runners, "main", {},
+                                    testing::GetDefaultKernelFilePath(), {});
+
+  bool successful = isolate->RunInIsolateScope([&]() -> bool {
+    while (state.KeepRunning()) {
+      state.PauseTiming();
+      auto canvas =
+          fml::MakeRefCounted<Canvas>(sk_make_sp<DisplayListBuilder>());
+      state.ResumeTiming();
+
+      tonic::DartApiScope api_scope;
+      draw(*canvas);
+    }
+    return true;
+  });
+  FML_CHECK(successful);
+}
+
+static Dart_Handle NewByteData(const void* data, size_t length) {
+  Dart_Handle byte_data = Dart_NewTypedData(Dart_TypedData_kByteData, length);
+  tonic::DartByteData view(byte_data);
+  std::memcpy(view.data(), data, length);
+  return byte_data;
+}
+
+static void BM_CanvasDrawRect(benchmark::State& state) {
+  const int64_t rect_count = state.range(0);
+  RunCanvasBenchmark(state, [rect_count](Canvas& canvas) {
+    uint8_t paint_bytes[Paint::kDataByteCount] = {};
+    Dart_Handle paint_data = NewByteData(paint_bytes, sizeof(paint_bytes));
+    for (int64_t i = 0; i < rect_count; i++) {
+      canvas.drawRect(i, i, i + 10, i + 10, Dart_Null(), paint_data);
+    }
+  });
+}
+
+static void BM_CanvasDrawCommandsRect(benchmark::State& state) {
+  const int64_t rect_count = state.range(0);
+  RunCanvasBenchmark(state, [rect_count](Canvas& canvas) {
+    std::vector<uint32_t> commands;
+    commands.push_back(static_cast<uint32_t>(CanvasCommand::kSetPaint));
+    commands.insert(commands.end(), 3, static_cast<uint32_t>(-1));
+    commands.insert(commands.end(), Paint::kDataByteCount / sizeof(uint32_t),
+                    0u);
+    for (int64_t i = 0; i < rect_count; i++) {
+      float rect[] = {static_cast<float>(i), static_cast<float>(i),
+                      static_cast<float>(i + 10), static_cast<float>(i + 10)};
+      commands.push_back(static_cast<uint32_t>(CanvasCommand::kDrawRect));
+      for (float value : rect) {
+        uint32_t word;
+        std::memcpy(&word, &value, sizeof(word));
+        commands.push_back(word);
+      }
+    }
+    Dart_Handle command_data =
+        NewByteData(commands.data(), commands.size() * sizeof(uint32_t));
+    FML_CHECK(Dart_IsNull(canvas.drawCommands(Dart_Null(), command_data)));
+  });
+}
+
+BENCHMARK(BM_CanvasDrawRect)
+    ->Arg(100)
+    ->Arg(1000)
+    ->Arg(10000)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_CanvasDrawCommandsRect)
+    ->Arg(100)
+    ->Arg(1000)
+    ->Arg(10000)
+    ->Unit(benchmark::kMicrosecond);
+
+// Plays an animated image that is on screen |state.range(0)| times at once
+// through twice, the way each of its codecs would, and reports the number of
+// frames decoded per displayed frame. When |out_of_phase| is set, each codec
+// starts at a different frame and only the minimum number of frames is
+// cached, so that codecs sharing their frames rarely find the frames that
+// the others decoded.
+static void RunAnimatedImageDecodeBenchmark(benchmark::State& state,
+                                            bool shared,
+                                            bool out_of_phase) {
+  const int64_t copy_count = state.range(0);
+  sk_sp<SkData> gif = testing::OpenFixtureAsSkData("hello_loop_2.gif");
+  FML_CHECK(gif);
+  ImageGeneratorRegistry registry;
+  // Every codec gets its own copy of the encoded bytes, as it would when the
+  // image is loaded once per widget.
+  std::vector<sk_sp<SkData>> copies;
+  for (int64_t i = 0; i < copy_count; i++) {
+    copies.push_back(SkData::MakeWithCopy(gif->data(), gif->size()));
+  }
+  const size_t max_cached_frame_bytes =
+      out_of_phase ? 0u : AnimatedImageFrames::kMaxCachedFrameBytes;
+
+  int64_t displayed_frame_count = 0;
+  size_t decoded_frame_count = 0;
+  while (state.KeepRunning()) {
+    std::vector<std::shared_ptr<AnimatedImageFrames>> codecs;
+    for (const sk_sp<SkData>& copy : copies) {
+      codecs.push_back(AnimatedImageFrames::GetShared(
+          shared ? copy : nullptr, registry.CreateCompatibleGenerator(copy),
+          max_cached_frame_bytes));
+    }
+    const int frame_count = codecs.front()->GetFrameCount();
+    for (int i = 0; i < frame_count * 2; i++) {
+      for (size_t c = 0; c < codecs.size(); c++) {
+        const int phase =
+            out_of_phase ? static_cast<int>(c * frame_count / codecs.size())
+                         : 0;
+        FML_CHECK(codecs[c]->GetFrame((i + phase) % frame_count).first);
+        displayed_frame_count++;
+      }
+    }
+    for (const auto& codec : codecs) {
+      decoded_frame_count += codec->GetDecodedFrameCount();
+    }
+  }
+  state.SetItemsProcessed(displayed_frame_count);
+  state.counters["DecodesPerFrame"] =
+      static_cast<double>(decoded_frame_count) / displayed_frame_count;
+}
+
+static void BM_AnimatedImageDecodeIndependent(benchmark::State& state) {
+  RunAnimatedImageDecodeBenchmark(state, /*shared=*/false,
+                                  /*out_of_phase=*/false);
+}
+
+static void BM_AnimatedImageDecodeShared(benchmark::State& state) {
+  RunAnimatedImageDecodeBenchmark(state, /*shared=*/true,
+                                  /*out_of_phase=*/false);
+}
+
+static void BM_AnimatedImageDecodeSharedOutOfPhase(benchmark::State& state) {
+  RunAnimatedImageDecodeBenchmark(state, /*shared=*/true,
+                                  /*out_of_phase=*/true);
+}
+
+BENCHMARK(BM_AnimatedImageDecodeIndependent)
+    ->Arg(1)
+    ->Arg(8)
+    ->Arg(32)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_AnimatedImageDecodeShared)
+    ->Arg(1)
+    ->Arg(8)
+    ->Arg(32)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_AnimatedImageDecodeSharedOutOfPhase)
+    ->Arg(2)
+    ->Arg(8)
+    ->Unit(benchmark::kMicrosecond);
+
 }  // namespace flutter
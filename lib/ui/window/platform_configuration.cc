@@ -23,8 +23,30 @@
 namespace flutter {
 namespace {
 
-Dart_Handle ToByteData(const fml::Mapping& buffer) {
-  return tonic::DartByteData::Create(buffer.GetMapping(), buffer.GetSize());
+void MallocMappingFinalizer(void* isolate_callback_data, void* peer) {
+  delete static_cast<fml::MallocMapping*>(peer);
+}
+
+// Hands |buffer| over to Dart. Large buffers are not copied into the Dart
+// heap, the Dart object takes ownership of the mapping instead.
+Dart_Handle ToByteData(fml::MallocMapping buffer) {
+  const size_t size = buffer.GetSize();
+  if (size < tonic::DartByteData::kExternalSizeThreshold) {
+    return tonic::DartByteData::Create(buffer.GetMapping(), size);
+  }
+  uint8_t* data = const_cast<uint8_t*>(buffer.GetMapping());
+  auto* peer = new fml::MallocMapping(std::move(buffer));
+  Dart_Handle byte_data = Dart_NewExternalTypedDataWithFinalizer(
+      /*type=*/Dart_TypedData_kByteData,
+      /*data=*/data,
+      /*length=*/size,
+      /*peer=*/peer,
+      /*external_allocation_size=*/size,
+      /*callback=*/MallocMappingFinalizer);
+  if (Dart_IsError(byte_data)) {
+    delete peer;
+  }
+  return byte_data;
 }
 
 }  // namespace
@@ -305,7 +327,7 @@ void PlatformConfiguration::DispatchPlatformMessage(
   }
   tonic::DartState::Scope scope(dart_state);
   Dart_Handle data_handle =
-      (message->hasData()) ? ToByteData(message->data()) : Dart_Null();
+      (message->hasData()) ? ToByteData(message->releaseData()) : Dart_Null();
   if (Dart_IsError(data_handle)) {
     FML_DLOG(WARNING)
         << "Dropping platform message because of a Dart error on channel: "
@@ -356,7 +378,7 @@ void PlatformConfiguration::DispatchSemanticsAction(int32_t node_id,
   tonic::DartState::Scope scope(dart_state);
 
   Dart_Handle args_handle =
-      (args.GetSize() <= 0) ? Dart_Null() : ToByteData(args);
+      (args.GetSize() <= 0) ? Dart_Null() : ToByteData(std::move(args));
 
   if (Dart_IsError(args_handle)) {
     return;
@@ -125,6 +125,100 @@ abstract class Canvas {
   );
 }
 
+// There is no per-call overhead to amortize on the web, so the batch simply
+// replays the operations on the canvas.
+class CanvasCommandBatch {
+  CanvasCommandBatch();
+
+  final List<void Function(Canvas canvas)> _commands =
+      <void Function(Canvas canvas)>[];
+
+  bool get isEmpty => _commands.isEmpty;
+
+  void clear() => _commands.clear();
+
+  void drawInto(Canvas canvas) {
+    for (final void Function(Canvas canvas) command in _commands) {
+      command(canvas);
+    }
+  }
+
+  void save() => _commands.add((Canvas canvas) => canvas.save());
+
+  void saveLayer(Rect? bounds, Paint paint) {
+    final Paint copy = Paint.from(paint);
+    _commands.add((Canvas canvas) => canvas.saveLayer(bounds, copy));
+  }
+
+  void restore() => _commands.add((Canvas canvas) => canvas.restore());
+
+  void translate(double dx, double dy) =>
+      _commands.add((Canvas canvas) => canvas.translate(dx, dy));
+
+  void scale(double sx, [double? sy]) =>
+      _commands.add((Canvas canvas) => canvas.scale(sx, sy));
+
+  void rotate(double radians) =>
+      _commands.add((Canvas canvas) => canvas.rotate(radians));
+
+  void clipRect(Rect rect,
+          {ClipOp clipOp = ClipOp.intersect, bool doAntiAlias = true}) =>
+      _commands.add((Canvas canvas) =>
+          canvas.clipRect(rect, clipOp: clipOp, doAntiAlias: doAntiAlias));
+
+  void clipRRect(RRect rrect, {bool doAntiAlias = true}) => _commands.add(
+      (Canvas canvas) => canvas.clipRRect(rrect, doAntiAlias: doAntiAlias));
+
+  void clipPath(Path path, {bool doAntiAlias = true}) => _commands.add(
+      (Canvas canvas) => canvas.clipPath(path, doAntiAlias: doAntiAlias));
+
+  void drawColor(Color color, BlendMode blendMode) =>
+      _commands.add((Canvas canvas) => canvas.drawColor(color, blendMode));
+
+  void drawLine(Offset p1, Offset p2, Paint paint) {
+    final Paint copy = Paint.from(paint);
+    _commands.add((Canvas canvas) => canvas.drawLine(p1, p2, copy));
+  }
+
+  void drawPaint(Paint paint) {
+    final Paint copy = Paint.from(paint);
+    _commands.add((Canvas canvas) => canvas.drawPaint(copy));
+  }
+
+  void drawRect(Rect rect, Paint paint) {
+    final Paint copy = Paint.from(paint);
+    _commands.add((Canvas canvas) => canvas.drawRect(rect, copy));
+  }
+
+  void drawRRect(RRect rrect, Paint paint) {
+    final Paint copy = Paint.from(paint);
+    _commands.add((Canvas canvas) => canvas.drawRRect(rrect, copy));
+  }
+
+  void drawOval(Rect rect, Paint paint) {
+    final Paint copy = Paint.from(paint);
+    _commands.add((Canvas canvas) => canvas.drawOval(rect, copy));
+  }
+
+  void drawCircle(Offset c, double radius, Paint paint) {
+    final Paint copy = Paint.from(paint);
+    _commands.add((Canvas canvas) => canvas.drawCircle(c, radius, copy));
+  }
+
+  void drawPath(Path path, Paint paint) {
+    final Paint copy = Paint.from(paint);
+    _commands.add((Canvas canvas) => canvas.drawPath(path, copy));
+  }
+
+  void drawImage(Image image, Offset offset, Paint paint) {
+    final Paint copy = Paint.from(paint);
+    _commands.add((Canvas canvas) => canvas.drawImage(image, offset, copy));
+  }
+
+  void drawPicture(Picture picture) =>
+      _commands.add((Canvas canvas) => canvas.drawPicture(picture));
+}
+
 typedef PictureEventCallback = void Function(Picture picture);
 
 abstract class Picture {
@@ -199,5 +199,76 @@ TEST_F(PersistentCacheTest, PurgeAllowsFutureSkSLCache) {
   DestroyShell(std::move(shell));
 }
 
+TEST_F(PersistentCacheTest, MovesSkSLFilesIntoPack) {
+  sk_sp<SkData> shader_key = SkData::MakeWithCString("key");
+  sk_sp<SkData> shader_value = SkData::MakeWithCString("value");
+
+  fml::ScopedTemporaryDirectory base_dir;
+  ASSERT_TRUE(base_dir.fd().is_valid());
+  PersistentCache::SetCacheDirectoryPath(base_dir.path());
+  PersistentCache::ResetCacheForProcess();
+
+  // Write the shader the way earlier versions did, as an individual file.
+  auto sksl_dir = fml::CreateDirectory(
+      base_dir.fd(),
+      {"flutter_engine", GetFlutterEngineVersion(), "skia", GetSkiaVersion(),
+       PersistentCache::kSkSLSubdirName},
+      fml::FilePermission::kReadWrite);
+  std::string shader_filename = PersistentCache::SkKeyToFilePath(*shader_key);
+  ASSERT_TRUE(fml::WriteAtomically(
+      sksl_dir, shader_filename.c_str(),
+      *PersistentCache::BuildCacheObject(*shader_key, *shader_value)));
+
+  auto settings = CreateSettingsForFixture();
+  settings.cache_sksl = true;
+  auto config = RunConfiguration::InferFromSettings(settings);
+  std::unique_ptr<Shell> shell = CreateShell(settings);
+  RunEngine(shell.get(), std::move(config));
+  std::promise<bool> io_flushed;
+  shell->GetTaskRunners().GetIOTaskRunner()->PostTask(
+      [&io_flushed]() { io_flushed.set_value(true); });
+  io_flushed.get_future().get();  // Wait for the IO thread to move the file.
+
+  EXPECT_FALSE(fml::FileExists(sksl_dir, shader_filename.c_str()));
+  EXPECT_TRUE(fml::FileExists(sksl_dir, ShaderCachePack::kFileName));
+  auto shaders = PersistentCache::GetCacheForProcess()->LoadSkSLs();
+  ASSERT_EQ(shaders.size(), 1u);
+  EXPECT_TRUE(shaders[0].key->equals(shader_key.get()));
+  EXPECT_TRUE(shaders[0].value->equals(shader_value.get()));
+
+  // Cleanup
+  fml::RemoveFilesInDirectory(base_dir.fd());
+  DestroyShell(std::move(shell));
+}
+
+TEST_F(PersistentCacheTest, CacheDirectoryIsVersionedUnderConfiguredPath) {
+  fml::ScopedTemporaryDirectory base_dir;
+  ASSERT_TRUE(base_dir.fd().is_valid());
+  PersistentCache::SetCacheDirectoryPath(base_dir.path());
+  PersistentCache::ResetCacheForProcess();
+
+  PersistentCache* cache = PersistentCache::GetCacheForProcess();
+  ASSERT_TRUE(cache->GetCacheDirectory()->is_valid());
+  EXPECT_FALSE(cache->IsReadOnly());
+  // Files written to the cache directory, such as the pipeline variant
+  // profile, land in the directory of this engine version.
+  ASSERT_TRUE(fml::WriteAtomically(*cache->GetCacheDirectory(), "entry",
+                                   fml::DataMapping(std::string("value"))));
+  auto engine_dir = fml::CreateDirectory(
+      base_dir.fd(),
+      {"flutter_engine", GetFlutterEngineVersion(), "skia", GetSkiaVersion()},
+      fml::FilePermission::kRead);
+  EXPECT_TRUE(fml::FileExists(engine_dir, "entry"));
+
+  PersistentCache::gIsReadOnly = true;
+  PersistentCache::ResetCacheForProcess();
+  EXPECT_TRUE(PersistentCache::GetCacheForProcess()->IsReadOnly());
+  PersistentCache::gIsReadOnly = false;
+  PersistentCache::ResetCacheForProcess();
+
+  // Cleanup
+  fml::RemoveFilesInDirectory(base_dir.fd());
+}
+
 }  // namespace testing
 }  // namespace flutter
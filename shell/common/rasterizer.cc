@@ -5,20 +5,25 @@
 #include "flutter/shell/common/rasterizer.h"
 
 #include <algorithm>
+#include <atomic>
 #include <memory>
+#include <unordered_map>
 #include <utility>
 
 #include "display_list/dl_builder.h"
 #include "flow/frame_timings.h"
 #include "flutter/common/constants.h"
 #include "flutter/common/graphics/persistent_cache.h"
+#include "flutter/flow/layers/container_layer.h"
 #include "flutter/flow/layers/offscreen_surface.h"
 #include "flutter/fml/time/time_delta.h"
 #include "flutter/fml/time/time_point.h"
+#include "flutter/fml/trace_event.h"
 #include "flutter/shell/common/base64.h"
 #include "flutter/shell/common/serialization_callbacks.h"
 #include "fml/closure.h"
 #include "fml/make_copyable.h"
+#include "fml/synchronization/count_down_latch.h"
 #include "fml/synchronization/waitable_event.h"
 #include "third_party/skia/include/core/SkColorSpace.h"
 #include "third_party/skia/include/core/SkData.h"
@@ -41,6 +46,7 @@
 #include "impeller/core/formats.h"                // nogncheck
 #include "impeller/display_list/aiks_context.h"   // nogncheck
 #include "impeller/display_list/dl_dispatcher.h"  // nogncheck
+#include "impeller/entity/contents/pipeline_variant_profile.h"  // nogncheck
 #endif
 
 namespace flutter {
@@ -50,6 +56,32 @@ namespace flutter {
 [[maybe_unused]] static constexpr std::chrono::milliseconds
     kSkiaCleanupExpiration(15000);
 
+// The number of frames between writes of the pipeline variants that were
+// created to the persistent cache directory.
+[[maybe_unused]] static constexpr size_t kPipelineVariantPersistInterval = 60u;
+
+// Maps the layers of the tree with the given index to that index, and marks
+// both trees in |shares_layers| when a layer also belongs to another tree.
+static void MarkSharedLayers(
+    const Layer* layer,
+    size_t tree_index,
+    std::unordered_map<const Layer*, size_t>& layer_owners,
+    std::vector<bool>& shares_layers) {
+  auto [owner, inserted] = layer_owners.try_emplace(layer, tree_index);
+  if (!inserted) {
+    if (owner->second != tree_index) {
+      shares_layers[owner->second] = true;
+      shares_layers[tree_index] = true;
+    }
+    return;
+  }
+  if (const ContainerLayer* container = layer->as_container_layer()) {
+    for (const std::shared_ptr<Layer>& child : container->layers()) {
+      MarkSharedLayers(child.get(), tree_index, layer_owners, shares_layers);
+    }
+  }
+}
+
 Rasterizer::Rasterizer(Delegate& delegate,
                        MakeGpuImageBehavior gpu_image_behavior)
     : delegate_(delegate),
@@ -90,6 +122,10 @@ void Rasterizer::Setup(std::unique_ptr<Surface> surface) {
     compositor_context_->OnGrContextCreated();
   }
 
+#if IMPELLER_SUPPORTS_RENDERING && !SLIMPELLER
+  PrewarmPipelineVariants();
+#endif  // IMPELLER_SUPPORTS_RENDERING && !SLIMPELLER
+
   if (external_view_embedder_ &&
       external_view_embedder_->SupportsDynamicThreadMerging() &&
       !raster_thread_merger_) {
@@ -648,16 +684,36 @@ std::unique_ptr<FrameItem> Rasterizer::DrawToSurfacesUnsafe(
 
   frame_timings_recorder.RecordRasterStart(fml::TimePoint::Now());
 
+  // Optionally record the layer trees on the worker threads so that only the
+  // submission to the surface below happens one view at a time.
+  std::vector<fml::TimeDelta> record_durations;
+  std::vector<sk_sp<DisplayList>> recordings =
+      RecordLayerTreesConcurrently(tasks, record_durations);
+
   // Second traverse: draw all layer trees.
   std::vector<std::unique_ptr<LayerTreeTask>> resubmitted_tasks;
-  for (std::unique_ptr<LayerTreeTask>& task : tasks) {
+  for (size_t i = 0; i < tasks.size(); i++) {
+    std::unique_ptr<LayerTreeTask>& task = tasks[i];
     int64_t view_id = task->view_id;
     std::unique_ptr<LayerTree> layer_tree = std::move(task->layer_tree);
     float device_pixel_ratio = task->device_pixel_ratio;
 
+    // Only the work done for this view counts towards its raster duration,
+    // not the time spent recording or drawing the views before it.
+    const fml::TimePoint view_draw_start = fml::TimePoint::Now();
+    fml::TimeDelta view_raster_duration;
+    sk_sp<DisplayList> recording;
+    if (!recordings.empty() && recordings[i]) {
+      view_raster_duration = record_durations[i];
+      recording = std::move(recordings[i]);
+    }
     DrawSurfaceStatus status = DrawToSurfaceUnsafe(
-        view_id, *layer_tree, device_pixel_ratio, presentation_time);
+        view_id, *layer_tree, device_pixel_ratio, presentation_time, recording);
     FML_DCHECK(status != DrawSurfaceStatus::kDiscarded);
+    view_raster_duration =
+        view_raster_duration + (fml::TimePoint::Now() - view_draw_start);
+    frame_timings_recorder.RecordViewRasterDuration(view_id,
+                                                    view_raster_duration);
 
     auto& view_record = EnsureViewRecord(task->view_id);
     view_record.last_draw_status = status;
@@ -669,6 +725,13 @@ std::unique_ptr<FrameItem> Rasterizer::DrawToSurfacesUnsafe(
           view_id, std::move(layer_tree), device_pixel_ratio));
     }
   }
+#if !FLUTTER_RELEASE
+  for (const auto& [view_id, raster_duration] :
+       frame_timings_recorder.GetViewRasterDurations()) {
+    FML_TRACE_COUNTER("flutter", "ViewRasterTime", view_id,
+                      "RasterTimeMicros", raster_duration.ToMicroseconds());
+  }
+#endif  // !FLUTTER_RELEASE
   // TODO(dkwingsmt): Pass in raster cache(s) for all views.
   // See https://github.com/flutter/flutter/issues/135530, item 4.
   frame_timings_recorder.RecordRasterEnd(
@@ -676,6 +739,10 @@ std::unique_ptr<FrameItem> Rasterizer::DrawToSurfacesUnsafe(
 
   FireNextFrameCallbackIfPresent();
 
+#if IMPELLER_SUPPORTS_RENDERING && !SLIMPELLER
+  PersistPipelineVariantsIfNeeded();
+#endif  // IMPELLER_SUPPORTS_RENDERING && !SLIMPELLER
+
 #if !SLIMPELLER
   if (surface_->GetContext()) {
     surface_->GetContext()->performDeferredCleanup(kSkiaCleanupExpiration);
@@ -697,7 +764,8 @@ DrawSurfaceStatus Rasterizer::DrawToSurfaceUnsafe(
     int64_t view_id,
     flutter::LayerTree& layer_tree,
     float device_pixel_ratio,
-    std::optional<fml::TimePoint> presentation_time) {
+    std::optional<fml::TimePoint> presentation_time,
+    const sk_sp<DisplayList>& recording) {
   FML_DCHECK(surface_);
 
   DlCanvas* embedder_root_canvas = nullptr;
@@ -767,11 +835,20 @@ DrawSurfaceStatus Rasterizer::DrawToSurfaceUnsafe(
       ignore_raster_cache = false;
     }
 
-    RasterStatus frame_status =
-        compositor_frame->Raster(layer_tree,           // layer tree
-                                 ignore_raster_cache,  // ignore raster cache
-                                 damage.get()          // frame damage
-        );
+    RasterStatus frame_status;
+    if (recording) {
+      frame_status =
+          compositor_frame->RasterRecording(layer_tree,   // layer tree
+                                            recording,    // recording
+                                            damage.get()  // frame damage
+          );
+    } else {
+      frame_status =
+          compositor_frame->Raster(layer_tree,           // layer tree
+                                   ignore_raster_cache,  // ignore raster cache
+                                   damage.get()          // frame damage
+          );
+    }
     if (frame_status == RasterStatus::kSkipAndRetry) {
       return DrawSurfaceStatus::kRetry;
     }
@@ -814,6 +891,96 @@ DrawSurfaceStatus Rasterizer::DrawToSurfaceUnsafe(
   return DrawSurfaceStatus::kFailed;
 }
 
+std::vector<sk_sp<DisplayList>> Rasterizer::RecordLayerTreesConcurrently(
+    const std::vector<std::unique_ptr<LayerTreeTask>>& tasks,
+    std::vector<fml::TimeDelta>& record_durations) {
+  // The raster cache and Skia's GPU context may only be used on the raster
+  // thread.
+  if (tasks.size() < 2 || !surface_->GetAiksContext() ||
+      surface_->EnableRasterCache() ||
+      !delegate_.GetSettings().enable_concurrent_view_rasterization) {
+    return {};
+  }
+  std::shared_ptr<fml::ConcurrentTaskRunner> worker_task_runner =
+      delegate_.GetConcurrentWorkerTaskRunner();
+  if (!worker_task_runner) {
+    return {};
+  }
+  TRACE_EVENT0("flutter", "Rasterizer::RecordLayerTreesConcurrently");
+
+  // Prerolling mutates the layers, so the trees that share a layer with the
+  // tree of another view are drawn on the raster thread one after another.
+  std::vector<bool> shares_layers(tasks.size(), false);
+  std::unordered_map<const Layer*, size_t> layer_owners;
+  for (size_t i = 0; i < tasks.size(); i++) {
+    if (const Layer* root_layer = tasks[i]->layer_tree->root_layer()) {
+      MarkSharedLayers(root_layer, i, layer_owners, shares_layers);
+    }
+  }
+
+  // Shared with the workers, which claim the layer trees one at a time. A
+  // worker that only starts once every layer tree has been claimed returns
+  // without touching anything but this state.
+  struct RecordingState {
+    explicit RecordingState(size_t count)
+        : recordings(count), durations(count), done(count) {}
+
+    std::vector<LayerTree*> layer_trees;
+    std::vector<sk_sp<DisplayList>> recordings;
+    std::vector<fml::TimeDelta> durations;
+    SkMatrix root_surface_transformation;
+    const Stopwatch* raster_time = nullptr;
+    const Stopwatch* ui_time = nullptr;
+    std::atomic_size_t next_index = 0;
+    fml::CountDownLatch done;
+  };
+  std::vector<size_t> task_indices;
+  for (size_t i = 0; i < tasks.size(); i++) {
+    if (!shares_layers[i]) {
+      task_indices.push_back(i);
+    }
+  }
+  if (task_indices.size() < 2) {
+    return {};
+  }
+  auto state = std::make_shared<RecordingState>(task_indices.size());
+  for (size_t index : task_indices) {
+    state->layer_trees.push_back(tasks[index]->layer_tree.get());
+  }
+  // The root canvas of an external view embedder already applies the root
+  // surface transformation, see |DrawToSurfaceUnsafe|.
+  state->root_surface_transformation = external_view_embedder_
+                                           ? SkMatrix{}
+                                           : surface_->GetRootTransformation();
+  state->raster_time = &compositor_context_->raster_time();
+  state->ui_time = &compositor_context_->ui_time();
+
+  auto record = [](RecordingState& state) {
+    for (size_t i = state.next_index++; i < state.layer_trees.size();
+         i = state.next_index++) {
+      const fml::TimePoint start = fml::TimePoint::Now();
+      state.recordings[i] = state.layer_trees[i]->Record(
+          state.root_surface_transformation, *state.raster_time,
+          *state.ui_time, /*impeller_enabled=*/true);
+      state.durations[i] = fml::TimePoint::Now() - start;
+      state.done.CountDown();
+    }
+  };
+  for (size_t i = 1; i < task_indices.size(); i++) {
+    worker_task_runner->PostTask([state, record]() { record(*state); });
+  }
+  record(*state);
+  state->done.Wait();
+
+  std::vector<sk_sp<DisplayList>> recordings(tasks.size());
+  record_durations.assign(tasks.size(), fml::TimeDelta());
+  for (size_t i = 0; i < task_indices.size(); i++) {
+    recordings[task_indices[i]] = std::move(state->recordings[i]);
+    record_durations[task_indices[i]] = state->durations[i];
+  }
+  return recordings;
+}
+
 Rasterizer::ViewRecord& Rasterizer::EnsureViewRecord(int64_t view_id) {
   return view_records_[view_id];
 }
@@ -1110,6 +1277,71 @@ void Rasterizer::FireNextFrameCallbackIfPresent() {
   callback();
 }
 
+#if IMPELLER_SUPPORTS_RENDERING && !SLIMPELLER
+void Rasterizer::PrewarmPipelineVariants() {
+  pipeline_variants_prewarmed_ = false;
+  persisted_pipeline_variant_count_ = 0u;
+  frames_since_pipeline_variants_persisted_ = 0u;
+  if (!surface_) {
+    return;
+  }
+  std::shared_ptr<impeller::AiksContext> aiks_context =
+      surface_->GetAiksContext();
+  if (!aiks_context) {
+    return;
+  }
+  // The manifest is a short text file. Reading it here rather than on the IO
+  // thread makes sure that the variants are being created before the first
+  // frame is drawn.
+  std::optional<impeller::PipelineVariantProfile> profile =
+      impeller::PipelineVariantProfile::Retrieve(
+          *PersistentCache::GetCacheForProcess()->GetCacheDirectory());
+  if (profile.has_value()) {
+    aiks_context->GetContentContext().PrewarmPipelineVariants(profile.value());
+  }
+  pipeline_variants_prewarmed_ = true;
+}
+
+void Rasterizer::PersistPipelineVariantsIfNeeded() {
+  // Until the previous profile has been merged into the one of the context,
+  // writing the profile would drop the variants of the previous launch.
+  if (!pipeline_variants_prewarmed_ || !surface_ ||
+      ++frames_since_pipeline_variants_persisted_ <
+          kPipelineVariantPersistInterval) {
+    return;
+  }
+  frames_since_pipeline_variants_persisted_ = 0u;
+  PersistentCache* persistent_cache = PersistentCache::GetCacheForProcess();
+  if (persistent_cache->IsReadOnly()) {
+    return;
+  }
+  std::shared_ptr<impeller::AiksContext> aiks_context =
+      surface_->GetAiksContext();
+  if (!aiks_context) {
+    return;
+  }
+  const impeller::ContentContext& content_context =
+      aiks_context->GetContentContext();
+  const impeller::PipelineVariantProfile& profile =
+      content_context.GetPipelineVariantProfile();
+  if (profile.GetSize() <= persisted_pipeline_variant_count_) {
+    return;
+  }
+  TRACE_EVENT2("flutter", "Rasterizer::PersistPipelineVariants", "variants",
+               std::to_string(profile.GetSize()).c_str(), "stalls",
+               std::to_string(content_context.GetPipelineVariantStallCount())
+                   .c_str());
+  persisted_pipeline_variant_count_ = profile.GetSize();
+  delegate_.GetTaskRunners().GetIOTaskRunner()->PostTask(
+      [profile, cache_directory = persistent_cache->GetCacheDirectory()]() {
+        if (!profile.Persist(*cache_directory)) {
+          FML_DLOG(WARNING)
+              << "Could not persist the pipeline variant profile.";
+        }
+      });
+}
+#endif  // IMPELLER_SUPPORTS_RENDERING && !SLIMPELLER
+
 void Rasterizer::SetResourceCacheMaxBytes(size_t max_bytes, bool from_user) {
 #if !SLIMPELLER
   user_override_resource_cache_bytes_ |= from_user;
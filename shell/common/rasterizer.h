@@ -18,6 +18,7 @@
 #include "flutter/flow/layers/layer_tree.h"
 #include "flutter/flow/surface.h"
 #include "flutter/fml/closure.h"
+#include "flutter/fml/concurrent_message_loop.h"
 #include "flutter/fml/memory/weak_ptr.h"
 #include "flutter/fml/raster_thread_merger.h"
 #include "flutter/fml/synchronization/sync_switch.h"
@@ -169,6 +170,13 @@ class Rasterizer final : public SnapshotDelegate,
 
     virtual const Settings& GetSettings() const = 0;
 
+    /// The worker task runner used to record the layer trees of multiple
+    /// views concurrently.
+    ///
+    /// @see `Settings::enable_concurrent_view_rasterization`
+    virtual const std::shared_ptr<fml::ConcurrentTaskRunner>
+    GetConcurrentWorkerTaskRunner() const = 0;
+
     virtual bool ShouldDiscardLayerTree(int64_t view_id,
                                         const flutter::LayerTree& tree) = 0;
   };
@@ -732,16 +740,47 @@ class Rasterizer final : public SnapshotDelegate,
   //
   // This method is not affiliated with the frame timing recorder, but must be
   // included between the RasterStart and RasterEnd.
+  //
+  // If |recording| is set, it is a recording of the layer tree made by
+  // |RecordLayerTreesConcurrently| that is drawn instead of prerolling and
+  // painting the layer tree again.
   DrawSurfaceStatus DrawToSurfaceUnsafe(
       int64_t view_id,
       flutter::LayerTree& layer_tree,
       float device_pixel_ratio,
-      std::optional<fml::TimePoint> presentation_time);
+      std::optional<fml::TimePoint> presentation_time,
+      const sk_sp<DisplayList>& recording = nullptr);
+
+  // Records the layer trees of the tasks concurrently on the worker threads
+  // and the calling thread, if that is enabled and supported by the surface.
+  // Layer trees that share layers with the tree of another view, or that
+  // contain texture layers or platform views, are not recorded.
+  //
+  // Returns a recording for each task, which is nullptr for the layer trees
+  // that |DrawToSurfaceUnsafe| has to preroll and paint itself, or an empty
+  // vector if nothing was recorded. The time spent recording each layer tree,
+  // excluding any time its worker spent waiting, is written to
+  // |record_durations|.
+  std::vector<sk_sp<DisplayList>> RecordLayerTreesConcurrently(
+      const std::vector<std::unique_ptr<LayerTreeTask>>& tasks,
+      std::vector<fml::TimeDelta>& record_durations);
 
   ViewRecord& EnsureViewRecord(int64_t view_id);
 
   void FireNextFrameCallbackIfPresent();
 
+#if IMPELLER_SUPPORTS_RENDERING && !SLIMPELLER
+  // Reads the pipeline variants recorded by the previous launch from the
+  // persistent cache directory and starts creating them on the surface's
+  // Impeller context.
+  void PrewarmPipelineVariants();
+
+  // Writes the pipeline variants created so far to the persistent cache
+  // directory on the IO thread if new ones were created since the last write
+  // and the cache is not read-only.
+  void PersistPipelineVariantsIfNeeded();
+#endif  // IMPELLER_SUPPORTS_RENDERING && !SLIMPELLER
+
   static bool ShouldResubmitFrame(const DoDrawResult& result);
   static DrawStatus ToDrawStatus(DoDrawStatus status);
 
@@ -759,6 +798,11 @@ class Rasterizer final : public SnapshotDelegate,
   fml::RefPtr<fml::RasterThreadMerger> raster_thread_merger_;
   std::shared_ptr<ExternalViewEmbedder> external_view_embedder_;
   std::unique_ptr<SnapshotController> snapshot_controller_;
+#if IMPELLER_SUPPORTS_RENDERING && !SLIMPELLER
+  bool pipeline_variants_prewarmed_ = false;
+  size_t persisted_pipeline_variant_count_ = 0u;
+  size_t frames_since_pipeline_variants_persisted_ = 0u;
+#endif  // IMPELLER_SUPPORTS_RENDERING && !SLIMPELLER
 
   // WeakPtrFactory must be the last member.
   fml::TaskRunnerAffineWeakPtrFactory<Rasterizer> weak_factory_;
@@ -63,6 +63,10 @@ class MockDelegate : public Rasterizer::Delegate {
               (),
               (const, override));
   MOCK_METHOD(const Settings&, GetSettings, (), (const, override));
+  MOCK_METHOD(const std::shared_ptr<fml::ConcurrentTaskRunner>,
+              GetConcurrentWorkerTaskRunner,
+              (),
+              (const, override));
   MOCK_METHOD(bool,
               ShouldDiscardLayerTree,
               (int64_t, const flutter::LayerTree&),
@@ -0,0 +1,390 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/common/graphics/shader_cache_pack.h"
+
+#include <map>
+#include <memory>
+#include <string>
+
+#include "flutter/fml/file.h"
+#include "flutter/fml/mapping.h"
+#include "gtest/gtest.h"
+
+namespace flutter {
+namespace testing {
+
+namespace {
+
+std::shared_ptr<fml::UniqueFD> DuplicateDirectory(
+    fml::ScopedTemporaryDirectory& directory) {
+  return std::make_shared<fml::UniqueFD>(
+      fml::Duplicate(directory.fd().get()));
+}
+
+std::shared_ptr<const fml::Mapping> MakeRecord(const std::string& key,
+                                               const std::string& value) {
+  return ShaderCachePack::BuildRecord(
+      key, reinterpret_cast<const uint8_t*>(value.data()), value.size());
+}
+
+std::string FindString(const ShaderCachePack& pack, const std::string& key) {
+  std::unique_ptr<fml::Mapping> value = pack.Find(key);
+  if (!value) {
+    return "<missing>";
+  }
+  return std::string(reinterpret_cast<const char*>(value->GetMapping()),
+                     value->GetSize());
+}
+
+size_t GetPackFileSize(fml::ScopedTemporaryDirectory& directory) {
+  auto mapping = fml::FileMapping::CreateReadOnly(directory.fd(),
+                                                  ShaderCachePack::kFileName);
+  return mapping ? mapping->GetSize() : 0u;
+}
+
+// The legacy format used by these tests is a single byte holding the size
+// of the key, followed by the key and the value.
+bool ParseTestFile(const fml::Mapping& contents,
+                   size_t* key_offset,
+                   size_t* key_size) {
+  if (contents.GetSize() < 1u ||
+      contents.GetSize() < 1u + contents.GetMapping()[0]) {
+    return false;
+  }
+  *key_offset = 1u;
+  *key_size = contents.GetMapping()[0];
+  return true;
+}
+
+}  // namespace
+
+TEST(ShaderCachePackTest, AppendedEntriesAreFoundAfterReopening) {
+  fml::ScopedTemporaryDirectory directory;
+  {
+    ShaderCachePack pack(DuplicateDirectory(directory), false);
+    ASSERT_TRUE(pack.IsValid());
+    EXPECT_EQ(pack.GetEntryCount(), 0u);
+    EXPECT_EQ(pack.Find("a"), nullptr);
+
+    ASSERT_TRUE(pack.Append({MakeRecord("a", "apple")}));
+    ASSERT_TRUE(pack.Append({MakeRecord("b", "banana"), MakeRecord("c", "")}));
+    EXPECT_EQ(pack.GetEntryCount(), 3u);
+    EXPECT_EQ(FindString(pack, "a"), "apple");
+    EXPECT_EQ(FindString(pack, "b"), "banana");
+    EXPECT_EQ(FindString(pack, "c"), "");
+  }
+
+  ShaderCachePack reopened(DuplicateDirectory(directory), false);
+  EXPECT_EQ(reopened.GetEntryCount(), 3u);
+  EXPECT_EQ(FindString(reopened, "a"), "apple");
+  EXPECT_EQ(FindString(reopened, "b"), "banana");
+  EXPECT_EQ(FindString(reopened, "c"), "");
+
+  std::map<std::string, std::string> visited;
+  reopened.VisitEntries(
+      [&visited](std::string_view key, const uint8_t* value, size_t size) {
+        visited[std::string(key)] =
+            std::string(reinterpret_cast<const char*>(value), size);
+      });
+  EXPECT_EQ(visited, (std::map<std::string, std::string>{
+                         {"a", "apple"}, {"b", "banana"}, {"c", ""}}));
+}
+
+TEST(ShaderCachePackTest, LaterEntriesReplaceEarlierOnes) {
+  fml::ScopedTemporaryDirectory directory;
+  {
+    ShaderCachePack pack(DuplicateDirectory(directory), false);
+    ASSERT_TRUE(pack.Append({MakeRecord("a", "first")}));
+    std::unique_ptr<fml::Mapping> first = pack.Find("a");
+    ASSERT_TRUE(pack.Append({MakeRecord("a", "second")}));
+    EXPECT_EQ(pack.GetEntryCount(), 1u);
+    EXPECT_EQ(FindString(pack, "a"), "second");
+    // Values that were already returned remain valid.
+    EXPECT_EQ(std::string(reinterpret_cast<const char*>(first->GetMapping()),
+                          first->GetSize()),
+              "first");
+  }
+  ShaderCachePack reopened(DuplicateDirectory(directory), false);
+  EXPECT_EQ(FindString(reopened, "a"), "second");
+}
+
+TEST(ShaderCachePackTest, DiscardsIncompleteRecords) {
+  fml::ScopedTemporaryDirectory directory;
+  {
+    ShaderCachePack pack(DuplicateDirectory(directory), false);
+    ASSERT_TRUE(pack.Append({MakeRecord("a", "apple")}));
+    ASSERT_TRUE(pack.Append({MakeRecord("b", "banana")}));
+  }
+  // Simulate a process that was killed while appending "b".
+  {
+    fml::UniqueFD file =
+        fml::OpenFile(directory.fd(), ShaderCachePack::kFileName, false,
+                      fml::FilePermission::kReadWrite);
+    ASSERT_TRUE(fml::TruncateFile(file, GetPackFileSize(directory) - 3u));
+  }
+
+  ShaderCachePack pack(DuplicateDirectory(directory), false);
+  EXPECT_EQ(pack.GetEntryCount(), 1u);
+  EXPECT_EQ(FindString(pack, "a"), "apple");
+  EXPECT_EQ(pack.Find("b"), nullptr);
+
+  // The next append overwrites the incomplete record.
+  ASSERT_TRUE(pack.Append({MakeRecord("c", "cherry")}));
+  ShaderCachePack reopened(DuplicateDirectory(directory), false);
+  EXPECT_EQ(reopened.GetEntryCount(), 2u);
+  EXPECT_EQ(FindString(reopened, "a"), "apple");
+  EXPECT_EQ(FindString(reopened, "c"), "cherry");
+}
+
+TEST(ShaderCachePackTest, DiscardsRecordsWithBadChecksums) {
+  fml::ScopedTemporaryDirectory directory;
+  {
+    ShaderCachePack pack(DuplicateDirectory(directory), false);
+    ASSERT_TRUE(pack.Append({MakeRecord("a", "apple")}));
+    ASSERT_TRUE(pack.Append({MakeRecord("b", "banana")}));
+  }
+  // Flip a byte in the value of "b", the last record in the file.
+  {
+    fml::UniqueFD file =
+        fml::OpenFile(directory.fd(), ShaderCachePack::kFileName, false,
+                      fml::FilePermission::kReadWrite);
+    const uint8_t corrupt = 'B';
+    ASSERT_TRUE(fml::WriteFileAt(file, GetPackFileSize(directory) - 4u,
+                                 &corrupt, sizeof(corrupt)));
+  }
+
+  ShaderCachePack pack(DuplicateDirectory(directory), false);
+  EXPECT_EQ(pack.GetEntryCount(), 1u);
+  EXPECT_EQ(FindString(pack, "a"), "apple");
+  EXPECT_EQ(pack.Find("b"), nullptr);
+
+  // The next append overwrites the corrupt record.
+  ASSERT_TRUE(pack.Append({MakeRecord("c", "cherry")}));
+  ShaderCachePack reopened(DuplicateDirectory(directory), false);
+  EXPECT_EQ(reopened.GetEntryCount(), 2u);
+  EXPECT_EQ(FindString(reopened, "a"), "apple");
+  EXPECT_EQ(FindString(reopened, "c"), "cherry");
+}
+
+TEST(ShaderCachePackTest, ReindexesRecordsLeftIncompleteByAnotherPack) {
+  fml::ScopedTemporaryDirectory directory;
+  ShaderCachePack first(DuplicateDirectory(directory), false);
+  ASSERT_TRUE(first.Append({MakeRecord("a", "apple")}));
+  std::unique_ptr<fml::Mapping> apple = first.Find("a");
+
+  // Another process appends one complete record and is killed while
+  // appending the next one.
+  {
+    ShaderCachePack second(DuplicateDirectory(directory), false);
+    ASSERT_TRUE(second.Append({MakeRecord("b", "banana")}));
+    ASSERT_TRUE(second.Append({MakeRecord("c", "cherry")}));
+  }
+  {
+    fml::UniqueFD file =
+        fml::OpenFile(directory.fd(), ShaderCachePack::kFileName, false,
+                      fml::FilePermission::kReadWrite);
+    ASSERT_TRUE(fml::TruncateFile(file, GetPackFileSize(directory) - 3u));
+  }
+
+  // The append picks up the other process's records, drops the incomplete
+  // one and writes after the last complete one.
+  ASSERT_TRUE(first.Append({MakeRecord("d", "date")}));
+  EXPECT_EQ(first.GetEntryCount(), 3u);
+  EXPECT_EQ(FindString(first, "b"), "banana");
+  EXPECT_EQ(first.Find("c"), nullptr);
+  EXPECT_EQ(FindString(first, "d"), "date");
+  EXPECT_EQ(std::string(reinterpret_cast<const char*>(apple->GetMapping()),
+                        apple->GetSize()),
+            "apple");
+
+  ShaderCachePack reopened(DuplicateDirectory(directory), false);
+  EXPECT_EQ(reopened.GetEntryCount(), 3u);
+  EXPECT_EQ(FindString(reopened, "a"), "apple");
+  EXPECT_EQ(FindString(reopened, "b"), "banana");
+  EXPECT_EQ(FindString(reopened, "d"), "date");
+}
+
+TEST(ShaderCachePackTest, RecreatesPackRemovedFromDisk) {
+  fml::ScopedTemporaryDirectory directory;
+  ShaderCachePack pack(DuplicateDirectory(directory), false);
+  ASSERT_TRUE(pack.Append({MakeRecord("a", "apple")}));
+  std::unique_ptr<fml::Mapping> apple = pack.Find("a");
+
+  // Purge the cache the way |PersistentCache::Purge| does.
+  ASSERT_TRUE(fml::UnlinkFile(directory.fd(), ShaderCachePack::kFileName));
+  ASSERT_TRUE(fml::UnlinkFile(directory.fd(), ShaderCachePack::kLockFileName));
+  pack.Reset();
+  EXPECT_EQ(pack.GetEntryCount(), 0u);
+  EXPECT_EQ(pack.Find("a"), nullptr);
+  EXPECT_FALSE(pack.NeedsCompaction());
+  // Values that were already returned remain valid.
+  EXPECT_EQ(std::string(reinterpret_cast<const char*>(apple->GetMapping()),
+                        apple->GetSize()),
+            "apple");
+
+  ASSERT_TRUE(pack.Append({MakeRecord("b", "banana")}));
+  ShaderCachePack reopened(DuplicateDirectory(directory), false);
+  EXPECT_EQ(reopened.GetEntryCount(), 1u);
+  EXPECT_EQ(FindString(reopened, "b"), "banana");
+}
+
+TEST(ShaderCachePackTest, MigratesLegacyFiles) {
+  fml::ScopedTemporaryDirectory directory;
+  ASSERT_TRUE(fml::WriteAtomically(directory.fd(), "entry_a",
+                                   fml::DataMapping(std::string("\1aapple"))));
+  ASSERT_TRUE(fml::WriteAtomically(directory.fd(), "entry_b",
+                                   fml::DataMapping(std::string("\1bbanana"))));
+  ASSERT_TRUE(fml::WriteAtomically(directory.fd(), "not_an_entry",
+                                   fml::DataMapping(std::string("\7short"))));
+
+  ShaderCachePack pack(DuplicateDirectory(directory), false);
+  EXPECT_FALSE(pack.HasMigratedLegacyFiles());
+  EXPECT_EQ(pack.MigrateLegacyFiles(ParseTestFile), 2u);
+  EXPECT_TRUE(pack.HasMigratedLegacyFiles());
+  EXPECT_EQ(FindString(pack, "a"), "apple");
+  EXPECT_EQ(FindString(pack, "b"), "banana");
+
+  EXPECT_FALSE(fml::FileExists(directory.fd(), "entry_a"));
+  EXPECT_FALSE(fml::FileExists(directory.fd(), "entry_b"));
+  EXPECT_TRUE(fml::FileExists(directory.fd(), "not_an_entry"));
+
+  // Migrating again finds nothing new.
+  EXPECT_EQ(pack.MigrateLegacyFiles(ParseTestFile), 0u);
+  ShaderCachePack reopened(DuplicateDirectory(directory), false);
+  EXPECT_EQ(reopened.GetEntryCount(), 2u);
+}
+
+TEST(ShaderCachePackTest, CompactionDropsReplacedRecords) {
+  fml::ScopedTemporaryDirectory directory;
+  ShaderCachePack pack(DuplicateDirectory(directory), false);
+  std::string value(ShaderCachePack::kMinCompactionByteSize, 'x');
+  for (int i = 0; i < 4; i++) {
+    ASSERT_TRUE(pack.Append({MakeRecord("a", value + std::to_string(i))}));
+  }
+  ASSERT_TRUE(pack.Append({MakeRecord("b", "banana")}));
+  EXPECT_TRUE(pack.NeedsCompaction());
+  size_t uncompacted_size = GetPackFileSize(directory);
+
+  ASSERT_TRUE(pack.Compact());
+  EXPECT_FALSE(pack.NeedsCompaction());
+  EXPECT_LT(GetPackFileSize(directory), uncompacted_size / 3u);
+  EXPECT_EQ(FindString(pack, "a"), value + "3");
+  EXPECT_EQ(FindString(pack, "b"), "banana");
+
+  // Appends continue after the compacted records.
+  ASSERT_TRUE(pack.Append({MakeRecord("c", "cherry")}));
+  ShaderCachePack reopened(DuplicateDirectory(directory), false);
+  EXPECT_EQ(reopened.GetEntryCount(), 3u);
+  EXPECT_EQ(FindString(reopened, "a"), value + "3");
+  EXPECT_EQ(FindString(reopened, "c"), "cherry");
+}
+
+TEST(ShaderCachePackTest, CompactionMapsEntriesHeldInMemory) {
+  fml::ScopedTemporaryDirectory directory;
+  ShaderCachePack pack(DuplicateDirectory(directory), false);
+  std::string value(ShaderCachePack::kMaxUnmappedByteSize / 4u, 'x');
+  for (int i = 0; i < 5; i++) {
+    std::string key = std::to_string(i);
+    ASSERT_TRUE(pack.Append({MakeRecord(key, value + key)}));
+  }
+  std::unique_ptr<fml::Mapping> first = pack.Find("0");
+  EXPECT_TRUE(pack.NeedsCompaction());
+  size_t uncompacted_size = GetPackFileSize(directory);
+
+  // Nothing was replaced, so the file keeps its size, but the entries are
+  // now served from the mapping of the pack.
+  ASSERT_TRUE(pack.Compact());
+  EXPECT_FALSE(pack.NeedsCompaction());
+  EXPECT_EQ(GetPackFileSize(directory), uncompacted_size);
+  EXPECT_EQ(pack.GetEntryCount(), 5u);
+  EXPECT_EQ(FindString(pack, "4"), value + "4");
+  EXPECT_EQ(std::string(reinterpret_cast<const char*>(first->GetMapping()),
+                        first->GetSize()),
+            value + "0");
+
+  // The pack can be compacted again, which also replaces the file that the
+  // previous compaction mapped.
+  ASSERT_TRUE(pack.Append({MakeRecord("4", "four")}));
+  ASSERT_TRUE(pack.Compact());
+  EXPECT_LT(GetPackFileSize(directory), uncompacted_size);
+  EXPECT_EQ(FindString(pack, "4"), "four");
+}
+
+TEST(ShaderCachePackTest, CompactionDropsIncompleteRecords) {
+  fml::ScopedTemporaryDirectory directory;
+  ShaderCachePack pack(DuplicateDirectory(directory), false);
+  ASSERT_TRUE(pack.Append({MakeRecord("a", "apple")}));
+  ASSERT_TRUE(pack.Append({MakeRecord("b", "banana")}));
+  {
+    fml::UniqueFD file =
+        fml::OpenFile(directory.fd(), ShaderCachePack::kFileName, false,
+                      fml::FilePermission::kReadWrite);
+    ASSERT_TRUE(fml::TruncateFile(file, GetPackFileSize(directory) - 3u));
+  }
+
+  ASSERT_TRUE(pack.Compact());
+  EXPECT_EQ(pack.GetEntryCount(), 1u);
+  EXPECT_EQ(FindString(pack, "a"), "apple");
+  EXPECT_EQ(pack.Find("b"), nullptr);
+
+  ASSERT_TRUE(pack.Append({MakeRecord("c", "cherry")}));
+  ShaderCachePack reopened(DuplicateDirectory(directory), false);
+  EXPECT_EQ(reopened.GetEntryCount(), 2u);
+  EXPECT_EQ(FindString(reopened, "c"), "cherry");
+}
+
+TEST(ShaderCachePackTest, ReadOnlyPackIsNotModified) {
+  fml::ScopedTemporaryDirectory directory;
+  {
+    ShaderCachePack pack(DuplicateDirectory(directory), false);
+    ASSERT_TRUE(pack.Append({MakeRecord("a", "apple")}));
+  }
+  ASSERT_TRUE(fml::WriteAtomically(directory.fd(), "entry_b",
+                                   fml::DataMapping(std::string("\1bbanana"))));
+
+  ShaderCachePack pack(DuplicateDirectory(directory), true);
+  EXPECT_EQ(FindString(pack, "a"), "apple");
+  EXPECT_FALSE(pack.Append({MakeRecord("c", "cherry")}));
+  EXPECT_EQ(pack.MigrateLegacyFiles(ParseTestFile), 0u);
+  EXPECT_FALSE(pack.HasMigratedLegacyFiles());
+  EXPECT_TRUE(fml::FileExists(directory.fd(), "entry_b"));
+  EXPECT_FALSE(pack.Compact());
+}
+
+TEST(ShaderCachePackTest, PacksSharingADirectoryKeepEachOthersRecords) {
+  // Each pack stands in for a different process using the same cache.
+  fml::ScopedTemporaryDirectory directory;
+  ShaderCachePack first(DuplicateDirectory(directory), false);
+  ShaderCachePack second(DuplicateDirectory(directory), false);
+
+  ASSERT_TRUE(first.Append({MakeRecord("a", "apple")}));
+  ASSERT_TRUE(second.Append({MakeRecord("b", "banana")}));
+  ASSERT_TRUE(first.Append({MakeRecord("c", "cherry")}));
+  EXPECT_EQ(FindString(first, "b"), "banana");
+
+  {
+    ShaderCachePack reopened(DuplicateDirectory(directory), false);
+    EXPECT_EQ(reopened.GetEntryCount(), 3u);
+    EXPECT_EQ(FindString(reopened, "a"), "apple");
+    EXPECT_EQ(FindString(reopened, "b"), "banana");
+    EXPECT_EQ(FindString(reopened, "c"), "cherry");
+  }
+
+  // Compaction keeps the records that were appended by the other pack.
+  ASSERT_TRUE(second.Append({MakeRecord("d", "date")}));
+  ASSERT_TRUE(first.Compact());
+  EXPECT_EQ(first.GetEntryCount(), 4u);
+  EXPECT_EQ(FindString(first, "d"), "date");
+  ASSERT_TRUE(second.Append({MakeRecord("e", "elderberry")}));
+
+  ShaderCachePack reopened(DuplicateDirectory(directory), false);
+  EXPECT_EQ(reopened.GetEntryCount(), 5u);
+  EXPECT_EQ(FindString(reopened, "c"), "cherry");
+  EXPECT_EQ(FindString(reopened, "d"), "date");
+  EXPECT_EQ(FindString(reopened, "e"), "elderberry");
+}
+
+}  // namespace testing
+}  // namespace flutter
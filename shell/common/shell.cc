@@ -248,6 +248,10 @@ std::unique_ptr<Shell> Shell::CreateShellOnPlatformThread(
         TRACE_EVENT0("flutter", "ShellSetupGPUSubsystem");
         std::unique_ptr<Rasterizer> rasterizer(on_create_rasterizer(*shell));
         rasterizer->SetImpellerContext(impeller_context);
+#if !SLIMPELLER
+        rasterizer->compositor_context()->raster_cache().SetMaxByteSize(
+            shell->GetSettings().raster_cache_max_bytes);
+#endif  //  !SLIMPELLER
         snapshot_delegate_promise.set_value(rasterizer->GetSnapshotDelegate());
         rasterizer_promise.set_value(std::move(rasterizer));
       });
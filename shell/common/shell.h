@@ -418,8 +418,9 @@ class Shell final : public PlatformView::Delegate,
 
   const std::weak_ptr<VsyncWaiter> GetVsyncWaiter() const;
 
+  // |Rasterizer::Delegate|
   const std::shared_ptr<fml::ConcurrentTaskRunner>
-  GetConcurrentWorkerTaskRunner() const;
+  GetConcurrentWorkerTaskRunner() const override;
 
   // Infer the VM ref and the isolate snapshot based on the settings.
   //
@@ -523,6 +523,23 @@ Settings SettingsFromCommandLine(const fml::CommandLine& command_line) {
         std::stoi(resource_cache_max_bytes_threshold);
   }
 
+  if (command_line.HasOption(FlagForSwitch(Switch::RasterCacheMaxBytes))) {
+    std::string raster_cache_max_bytes;
+    command_line.GetOptionValue(FlagForSwitch(Switch::RasterCacheMaxBytes),
+                                &raster_cache_max_bytes);
+    settings.raster_cache_max_bytes = std::stoull(raster_cache_max_bytes);
+  }
+
+  if (command_line.HasOption(FlagForSwitch(Switch::ProfilerSamplesPerSecond))) {
+    if (!GetSwitchValue(command_line, Switch::ProfilerSamplesPerSecond,
+                        &settings.profiler_samples_per_second) ||
+        settings.profiler_samples_per_second < 0) {
+      FML_LOG(INFO) << "Profiler samples per second specified was malformed. "
+                       "Will not sample the CPU and memory usage.";
+      settings.profiler_samples_per_second = 0;
+    }
+  }
+
   settings.enable_platform_isolates =
       command_line.HasOption(FlagForSwitch(Switch::EnablePlatformIsolates));
 
@@ -532,6 +549,9 @@ Settings SettingsFromCommandLine(const fml::CommandLine& command_line) {
   settings.merged_platform_ui_thread = !command_line.HasOption(
       FlagForSwitch(Switch::DisableMergedPlatformUIThread));
 
+  settings.enable_concurrent_view_rasterization = command_line.HasOption(
+      FlagForSwitch(Switch::EnableConcurrentViewRasterization));
+
   return settings;
 }
 
@@ -262,6 +262,16 @@ DEF_SWITCH(OldGenHeapSize,
 DEF_SWITCH(ResourceCacheMaxBytesThreshold,
            "resource-cache-max-bytes-threshold",
            "The max bytes threshold of resource cache, or 0 for unlimited.")
+DEF_SWITCH(RasterCacheMaxBytes,
+           "raster-cache-max-bytes",
+           "The max bytes of images held by the raster cache, or 0 for "
+           "unlimited.")
+DEF_SWITCH(ProfilerSamplesPerSecond,
+           "profiler-samples-per-second",
+           "The number of times per second the CPU usage of the threads of "
+           "the engine and the memory usage of the process are added to the "
+           "timeline. Disabled by default. Only used by the embedder on Linux "
+           "in debug and profile modes.")
 DEF_SWITCH(EnableImpeller,
            "enable-impeller",
            "Enable the Impeller renderer on supported platforms. Ignored if "
@@ -300,6 +310,11 @@ DEF_SWITCH(DisableMergedPlatformUIThread,
 DEF_SWITCH(DisableAndroidSurfaceControl,
            "disable-surface-control",
            "Disable the SurfaceControl backed swapchain even when supported.")
+DEF_SWITCH(EnableConcurrentViewRasterization,
+           "enable-concurrent-view-rasterization",
+           "Record the layer trees of multiple views concurrently on the "
+           "worker threads. Only supported by Impeller. Views with platform "
+           "views are still recorded on the raster thread.")
 DEF_SWITCHES_END
 
 void PrintUsage(const std::string& executable_name);
@@ -105,6 +105,29 @@ TEST(SwitchesTest, NoEnableImpeller) {
   }
 }
 
+TEST(SwitchesTest, ProfilerSamplesPerSecond) {
+  {
+    fml::CommandLine command_line = fml::CommandLineFromInitializerList(
+        {"command", "--profiler-samples-per-second=4"});
+    Settings settings = SettingsFromCommandLine(command_line);
+    EXPECT_EQ(settings.profiler_samples_per_second, 4);
+  }
+  {
+    // malformed
+    fml::CommandLine command_line = fml::CommandLineFromInitializerList(
+        {"command", "--profiler-samples-per-second=-1"});
+    Settings settings = SettingsFromCommandLine(command_line);
+    EXPECT_EQ(settings.profiler_samples_per_second, 0);
+  }
+  {
+    // default
+    fml::CommandLine command_line =
+        fml::CommandLineFromInitializerList({"command"});
+    Settings settings = SettingsFromCommandLine(command_line);
+    EXPECT_EQ(settings.profiler_samples_per_second, 0);
+  }
+}
+
 #if !FLUTTER_RELEASE
 TEST(SwitchesTest, EnableAsserts) {
   fml::CommandLine command_line = fml::CommandLineFromInitializerList(
@@ -5,18 +5,26 @@
 #include "flutter/shell/gpu/gpu_surface_software.h"
 
 #include <memory>
+#include <vector>
 
 #include "flow/surface_frame.h"
 #include "flutter/fml/logging.h"
 
+#include "third_party/skia/include/core/SkPixmap.h"
 #include "third_party/skia/include/core/SkSurface.h"
 
 namespace flutter {
 
-GPUSurfaceSoftware::GPUSurfaceSoftware(GPUSurfaceSoftwareDelegate* delegate,
-                                       bool render_to_surface)
+GPUSurfaceSoftware::GPUSurfaceSoftware(
+    GPUSurfaceSoftwareDelegate* delegate,
+    bool render_to_surface,
+    std::shared_ptr<fml::ConcurrentTaskRunner> worker_task_runner)
     : delegate_(delegate),
       render_to_surface_(render_to_surface),
+      tiled_rasterizer_(worker_task_runner
+                            ? std::make_unique<TiledSoftwareRasterizer>(
+                                  std::move(worker_task_runner))
+                            : nullptr),
       weak_factory_(this) {}
 
 GPUSurfaceSoftware::~GPUSurfaceSoftware() = default;
@@ -59,6 +67,10 @@ std::unique_ptr<SurfaceFrame> GPUSurfaceSoftware::AcquireFrame(
     return nullptr;
   }
 
+  if (tiled_rasterizer_) {
+    return AcquireTiledFrame(std::move(backing_store), logical_size);
+  }
+
   // If the surface has been scaled, we need to apply the inverse scaling to the
   // underlying canvas so that coordinates are mapped to the same spot
   // irrespective of surface scaling.
@@ -91,6 +103,67 @@ std::unique_ptr<SurfaceFrame> GPUSurfaceSoftware::AcquireFrame(
                                         logical_size);
 }
 
+std::unique_ptr<SurfaceFrame> GPUSurfaceSoftware::AcquireTiledFrame(
+    sk_sp<SkSurface> backing_store,
+    const SkISize& logical_size) {
+  SurfaceFrame::FramebufferInfo framebuffer_info;
+  framebuffer_info.supports_readback = true;
+  framebuffer_info.supports_partial_repaint = true;
+  // If the delegate hands back the buffer that the last frame was rasterized
+  // into, it still holds that frame and only the area that changed since
+  // needs to be repainted. Any other buffer is repainted entirely.
+  if (backing_store == last_backing_store_) {
+    framebuffer_info.existing_damage = SkIRect::MakeEmpty();
+  }
+  // Forget the buffer until this frame is rasterized in case it is dropped.
+  last_backing_store_ = nullptr;
+
+  SurfaceFrame::EncodeCallback encode_callback =
+      [self = weak_factory_.GetWeakPtr(), backing_store](
+          SurfaceFrame& surface_frame, DlCanvas* canvas) -> bool {
+    // If the surface itself went away, there is nothing more to do.
+    if (!self || !self->IsValid() || canvas == nullptr) {
+      return false;
+    }
+
+    sk_sp<DisplayList> display_list = surface_frame.BuildDisplayList();
+    SkPixmap pixmap;
+    if (!display_list || !backing_store->peekPixels(&pixmap)) {
+      return false;
+    }
+    SkIRect damage = surface_frame.submit_info().buffer_damage.value_or(
+        SkIRect::MakeSize(pixmap.dimensions()));
+    self->tiled_rasterizer_->Rasterize(display_list, pixmap, damage);
+    self->last_backing_store_ = backing_store;
+    return true;
+  };
+  SurfaceFrame::SubmitCallback submit_callback =
+      [self = weak_factory_.GetWeakPtr(),
+       backing_store](SurfaceFrame& surface_frame) {
+        // If the surface itself went away, there is nothing more to do.
+        if (!self || !self->IsValid()) {
+          return false;
+        }
+        SkIRect bounds =
+            SkIRect::MakeWH(backing_store->width(), backing_store->height());
+        SkIRect dirty_rect =
+            surface_frame.submit_info().buffer_damage.value_or(bounds);
+        std::vector<SkIRect> dirty_rects;
+        if (dirty_rect.intersect(bounds)) {
+          dirty_rects.push_back(dirty_rect);
+        }
+        return self->delegate_->PresentBackingStoreWithDamage(backing_store,
+                                                              dirty_rects);
+      };
+
+  // The layer tree is recorded into a DisplayList with an rtree so that every
+  // tile can be rasterized without dispatching the operations outside of it.
+  return std::make_unique<SurfaceFrame>(
+      nullptr, framebuffer_info, encode_callback, submit_callback, logical_size,
+      /*context_result=*/nullptr, /*display_list_fallback=*/true,
+      /*display_list_rtree=*/true);
+}
+
 // |Surface|
 SkMatrix GPUSurfaceSoftware::GetRootTransformation() const {
   // This backend does not currently support root surface transformations. Just
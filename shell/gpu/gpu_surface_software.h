@@ -5,7 +5,11 @@
 #ifndef FLUTTER_SHELL_GPU_GPU_SURFACE_SOFTWARE_H_
 #define FLUTTER_SHELL_GPU_GPU_SURFACE_SOFTWARE_H_
 
+#include <memory>
+
 #include "flutter/flow/surface.h"
+#include "flutter/flow/tiled_software_rasterizer.h"
+#include "flutter/fml/concurrent_message_loop.h"
 #include "flutter/fml/macros.h"
 #include "flutter/fml/memory/weak_ptr.h"
 #include "flutter/shell/gpu/gpu_surface_software_delegate.h"
@@ -14,8 +18,22 @@ namespace flutter {
 
 class GPUSurfaceSoftware : public Surface {
  public:
-  GPUSurfaceSoftware(GPUSurfaceSoftwareDelegate* delegate,
-                     bool render_to_surface);
+  //----------------------------------------------------------------------------
+  /// @param[in]  delegate            The platform surface that provides and
+  ///                                 presents the backing stores.
+  /// @param[in]  render_to_surface   Whether frames are rendered into the
+  ///                                 backing store at all.
+  /// @param[in]  worker_task_runner  If not null, frames are recorded into a
+  ///                                 DisplayList that is rasterized in tiles
+  ///                                 on this runner, only the damaged part of
+  ///                                 a retained backing store is repainted
+  ///                                 and it is presented with
+  ///                                 |PresentBackingStoreWithDamage|.
+  ///
+  GPUSurfaceSoftware(
+      GPUSurfaceSoftwareDelegate* delegate,
+      bool render_to_surface,
+      std::shared_ptr<fml::ConcurrentTaskRunner> worker_task_runner = nullptr);
 
   ~GPUSurfaceSoftware() override;
 
@@ -32,12 +50,20 @@ class GPUSurfaceSoftware : public Surface {
   GrDirectContext* GetContext() override;
 
  private:
+  std::unique_ptr<SurfaceFrame> AcquireTiledFrame(
+      sk_sp<SkSurface> backing_store,
+      const SkISize& logical_size);
+
   GPUSurfaceSoftwareDelegate* delegate_;
   // TODO(38466): Refactor GPU surface APIs take into account the fact that an
   // external view embedder may want to render to the root surface. This is a
   // hack to make avoid allocating resources for the root surface when an
   // external view embedder is present.
   const bool render_to_surface_;
+  const std::unique_ptr<TiledSoftwareRasterizer> tiled_rasterizer_;
+  // The backing store that the last tiled frame was rasterized into. Only the
+  // damage needs to be repainted if the delegate returns it again.
+  sk_sp<SkSurface> last_backing_store_;
   fml::TaskRunnerAffineWeakPtrFactory<GPUSurfaceSoftware> weak_factory_;
   FML_DISALLOW_COPY_AND_ASSIGN(GPUSurfaceSoftware);
 };
@@ -8,4 +8,10 @@ namespace flutter {
 
 GPUSurfaceSoftwareDelegate::~GPUSurfaceSoftwareDelegate() = default;
 
+bool GPUSurfaceSoftwareDelegate::PresentBackingStoreWithDamage(
+    sk_sp<SkSurface> backing_store,
+    const std::vector<SkIRect>& dirty_rects) {
+  return PresentBackingStore(std::move(backing_store));
+}
+
 }  // namespace flutter
@@ -5,6 +5,8 @@
 #ifndef FLUTTER_SHELL_GPU_GPU_SURFACE_SOFTWARE_DELEGATE_H_
 #define FLUTTER_SHELL_GPU_GPU_SURFACE_SOFTWARE_DELEGATE_H_
 
+#include <vector>
+
 #include "flutter/flow/embedded_views.h"
 #include "flutter/fml/macros.h"
 #include "third_party/skia/include/core/SkSurface.h"
@@ -48,6 +50,26 @@ class GPUSurfaceSoftwareDelegate {
   ///             the screen.
   ///
   virtual bool PresentBackingStore(sk_sp<SkSurface> backing_store) = 0;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Called instead of |PresentBackingStore| by GPU surfaces that
+  ///             only repaint the parts of the backing store that changed
+  ///             since it was last presented. Platforms that can update just
+  ///             those parts of the "screen" may override this, the default
+  ///             presents the entire backing store.
+  ///
+  /// @param[in]  backing_store  The software backing store to present.
+  /// @param[in]  dirty_rects    The areas of the backing store, in pixels,
+  ///                            that were repainted for this frame. The rest
+  ///                            of the backing store still holds the
+  ///                            previously presented frame.
+  ///
+  /// @return     Returns if the platform could present the backing store onto
+  ///             the screen.
+  ///
+  virtual bool PresentBackingStoreWithDamage(
+      sk_sp<SkSurface> backing_store,
+      const std::vector<SkIRect>& dirty_rects);
 };
 
 }  // namespace flutter
@@ -48,14 +48,29 @@ class WrappedTextureSourceVK : public impeller::TextureSourceVK {
 
 GPUSurfaceVulkanImpeller::GPUSurfaceVulkanImpeller(
     GPUSurfaceVulkanDelegate* delegate,
-    std::shared_ptr<impeller::Context> context)
-    : delegate_(delegate) {
-  if (!context || !context->IsValid()) {
+    std::shared_ptr<impeller::ContextVK> context)
+    : GPUSurfaceVulkanImpeller(delegate, context, context, nullptr) {}
+
+GPUSurfaceVulkanImpeller::GPUSurfaceVulkanImpeller(
+    std::shared_ptr<impeller::SurfaceContextVK> context)
+    : GPUSurfaceVulkanImpeller(nullptr,
+                               context,
+                               context ? context->GetParent() : nullptr,
+                               context) {}
+
+GPUSurfaceVulkanImpeller::GPUSurfaceVulkanImpeller(
+    GPUSurfaceVulkanDelegate* delegate,
+    std::shared_ptr<impeller::Context> context,
+    const std::shared_ptr<impeller::ContextVK>& context_vk,
+    std::shared_ptr<impeller::SurfaceContextVK> surface_context_vk)
+    : delegate_(delegate), surface_context_vk_(std::move(surface_context_vk)) {
+  if (!context || !context->IsValid() || !context_vk) {
     return;
   }
 
   auto aiks_context = std::make_shared<impeller::AiksContext>(
-      context, impeller::TypographerContextSkia::Make());
+      context, impeller::TypographerContextSkia::Make(
+                   context_vk->GetConcurrentWorkerTaskRunner()));
   if (!aiks_context->IsValid()) {
     return;
   }
@@ -86,10 +101,9 @@ std::unique_ptr<SurfaceFrame> GPUSurfaceVulkanImpeller::AcquireFrame(
     return nullptr;
   }
 
-  if (delegate_ == nullptr) {
-    auto& context_vk = impeller::SurfaceContextVK::Cast(*impeller_context_);
+  if (surface_context_vk_) {
     std::unique_ptr<impeller::Surface> surface =
-        context_vk.AcquireNextSurface();
+        surface_context_vk_->AcquireNextSurface();
 
     if (!surface) {
       FML_LOG(ERROR) << "No surface available.";
@@ -12,14 +12,22 @@
 #include "flutter/impeller/display_list/aiks_context.h"
 #include "flutter/impeller/renderer/context.h"
 #include "flutter/shell/gpu/gpu_surface_vulkan_delegate.h"
+#include "impeller/renderer/backend/vulkan/context_vk.h"
+#include "impeller/renderer/backend/vulkan/surface_context_vk.h"
 #include "impeller/renderer/backend/vulkan/swapchain/swapchain_transients_vk.h"
 
 namespace flutter {
 
 class GPUSurfaceVulkanImpeller final : public Surface {
  public:
-  explicit GPUSurfaceVulkanImpeller(GPUSurfaceVulkanDelegate* delegate,
-                                    std::shared_ptr<impeller::Context> context);
+  /// Creates a surface that renders to the images acquired from the
+  /// delegate.
+  GPUSurfaceVulkanImpeller(GPUSurfaceVulkanDelegate* delegate,
+                           std::shared_ptr<impeller::ContextVK> context);
+
+  /// Creates a surface that renders to the swapchain of the surface context.
+  explicit GPUSurfaceVulkanImpeller(
+      std::shared_ptr<impeller::SurfaceContextVK> context);
 
   // |Surface|
   ~GPUSurfaceVulkanImpeller() override;
@@ -30,10 +38,18 @@ class GPUSurfaceVulkanImpeller final : public Surface {
  private:
   GPUSurfaceVulkanDelegate* delegate_;
   std::shared_ptr<impeller::Context> impeller_context_;
+  // Only set for the surfaces that render to a swapchain.
+  std::shared_ptr<impeller::SurfaceContextVK> surface_context_vk_;
   std::shared_ptr<impeller::AiksContext> aiks_context_;
   std::shared_ptr<impeller::SwapchainTransientsVK> transients_;
   bool is_valid_ = false;
 
+  GPUSurfaceVulkanImpeller(
+      GPUSurfaceVulkanDelegate* delegate,
+      std::shared_ptr<impeller::Context> context,
+      const std::shared_ptr<impeller::ContextVK>& context_vk,
+      std::shared_ptr<impeller::SurfaceContextVK> surface_context_vk);
+
   // |Surface|
   std::unique_ptr<SurfaceFrame> AcquireFrame(const SkISize& size) override;
 
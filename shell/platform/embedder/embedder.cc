@@ -180,7 +180,9 @@ static bool IsSoftwareRendererConfigValid(const FlutterRendererConfig* config) {
   const FlutterSoftwareRendererConfig* software_config = &config->software;
 
   if (SAFE_ACCESS(software_config, surface_present_callback, nullptr) ==
-      nullptr) {
+          nullptr &&
+      SAFE_ACCESS(software_config, surface_present_with_damage_callback,
+                  nullptr) == nullptr) {
     return false;
   }
 
@@ -783,27 +785,60 @@ InferSoftwarePlatformViewCreationCallback(
     return nullptr;
   }
 
-  auto software_present_backing_store =
-      [ptr = config->software.surface_present_callback, user_data](
-          const void* allocation, size_t row_bytes, size_t height) -> bool {
-    return ptr(user_data, allocation, row_bytes, height);
-  };
+  const FlutterSoftwareRendererConfig* software_config = &config->software;
+
+  std::function<bool(const void*, size_t, size_t)>
+      software_present_backing_store;
+  if (auto ptr =
+          SAFE_ACCESS(software_config, surface_present_callback, nullptr)) {
+    software_present_backing_store =
+        [ptr, user_data](const void* allocation, size_t row_bytes,
+                         size_t height) -> bool {
+      return ptr(user_data, allocation, row_bytes, height);
+    };
+  }
+
+  std::function<bool(const void*, size_t, size_t, const std::vector<SkIRect>&)>
+      software_present_backing_store_with_damage;
+  if (auto ptr = SAFE_ACCESS(software_config,
+                             surface_present_with_damage_callback, nullptr)) {
+    software_present_backing_store_with_damage =
+        [ptr, user_data](const void* allocation, size_t row_bytes,
+                         size_t height,
+                         const std::vector<SkIRect>& dirty_rects) -> bool {
+      std::vector<FlutterRect> rects;
+      rects.reserve(dirty_rects.size());
+      for (const SkIRect& dirty_rect : dirty_rects) {
+        rects.push_back(SkIRectToFlutterRect(dirty_rect));
+      }
+      FlutterDamage damage{
+          .struct_size = sizeof(FlutterDamage),
+          .num_rects = rects.size(),
+          .damage = rects.data(),
+      };
+      return ptr(user_data, allocation, row_bytes, height, &damage);
+    };
+  }
 
   flutter::EmbedderSurfaceSoftware::SoftwareDispatchTable
       software_dispatch_table = {
-          software_present_backing_store,  // required
+          software_present_backing_store,              // optional
+          software_present_backing_store_with_damage,  // optional
       };
 
   return fml::MakeCopyable(
       [software_dispatch_table, platform_dispatch_table,
        external_view_embedder =
            std::move(external_view_embedder)](flutter::Shell& shell) mutable {
+        auto worker_task_runner =
+            shell.GetDartVM()->GetConcurrentWorkerTaskRunner();
         return std::make_unique<flutter::PlatformViewEmbedder>(
-            shell,                             // delegate
-            shell.GetTaskRunners(),            // task runners
-            software_dispatch_table,           // software dispatch table
-            platform_dispatch_table,           // platform dispatch table
-            std::move(external_view_embedder)  // external view embedder
+            shell,                              // delegate
+            shell.GetTaskRunners(),             // task runners
+            software_dispatch_table,            // software dispatch table
+            platform_dispatch_table,            // platform dispatch table
+            std::move(external_view_embedder),  // external view embedder
+            std::move(worker_task_runner)       // worker task runner
         );
       });
 }
@@ -2887,14 +2922,27 @@ FlutterEngineResult FlutterEngineSendKeyEvent(FLUTTER_API_SYMBOL(FlutterEngine)
 FlutterEngineResult FlutterEngineSendPlatformMessage(
     FLUTTER_API_SYMBOL(FlutterEngine) engine,
     const FlutterPlatformMessage* flutter_message) {
-  if (engine == nullptr) {
-    return LOG_EMBEDDER_ERROR(kInvalidArguments, "Invalid engine handle.");
-  }
-
   if (flutter_message == nullptr) {
     return LOG_EMBEDDER_ERROR(kInvalidArguments, "Invalid message argument.");
   }
 
+  // The embedder hands over the ownership of the message data with the
+  // release callback, so it must be invoked on every error path as well.
+  VoidCallback release_callback =
+      SAFE_ACCESS(flutter_message, release_callback, nullptr);
+  void* release_user_data =
+      SAFE_ACCESS(flutter_message, release_user_data, nullptr);
+  fml::ScopedCleanupClosure release_message_data(
+      [release_callback, release_user_data]() {
+        if (release_callback) {
+          release_callback(release_user_data);
+        }
+      });
+
+  if (engine == nullptr) {
+    return LOG_EMBEDDER_ERROR(kInvalidArguments, "Invalid engine handle.");
+  }
+
   if (SAFE_ACCESS(flutter_message, channel, nullptr) == nullptr) {
     return LOG_EMBEDDER_ERROR(
         kInvalidArguments, "Message argument did not specify a valid channel.");
@@ -2921,6 +2969,15 @@ FlutterEngineResult FlutterEngineSendPlatformMessage(
   if (message_size == 0) {
     message = std::make_unique<flutter::PlatformMessage>(
         flutter_message->channel, response);
+  } else if (release_callback) {
+    message = std::make_unique<flutter::PlatformMessage>(
+        flutter_message->channel,
+        fml::MallocMapping(
+            const_cast<uint8_t*>(message_data), message_size,
+            [release = release_message_data.Release()](uint8_t*, size_t) {
+              release();
+            }),
+        response);
   } else {
     message = std::make_unique<flutter::PlatformMessage>(
         flutter_message->channel,
@@ -3012,6 +3069,50 @@ FlutterEngineResult FlutterEngineSendPlatformMessageResponse(
   return kSuccess;
 }
 
+// Note: This can execute on any thread.
+FlutterEngineResult FlutterEngineSendPlatformMessageResponseNoCopy(
+    FLUTTER_API_SYMBOL(FlutterEngine) engine,
+    const FlutterPlatformMessageResponseHandle* handle,
+    const uint8_t* data,
+    size_t data_length,
+    VoidCallback release_callback,
+    void* release_user_data) {
+  fml::ScopedCleanupClosure release_data(
+      [release_callback, release_user_data]() {
+        if (release_callback) {
+          release_callback(release_user_data);
+        }
+      });
+
+  if (data_length != 0 && data == nullptr) {
+    return LOG_EMBEDDER_ERROR(
+        kInvalidArguments,
+        "Data size was non zero but the pointer to the data was null.");
+  }
+
+  if (handle == nullptr) {
+    return LOG_EMBEDDER_ERROR(kInvalidArguments, "Invalid response handle.");
+  }
+
+  auto response = handle->message->response();
+
+  if (response) {
+    if (data_length == 0) {
+      response->CompleteEmpty();
+    } else {
+      response->Complete(std::make_unique<fml::NonOwnedMapping>(
+          data, data_length,
+          [release = release_data.Release()](const uint8_t*, size_t) {
+            release();
+          }));
+    }
+  }
+
+  delete handle;
+
+  return kSuccess;
+}
+
 FlutterEngineResult __FlutterEngineFlushPendingTasksNow() {
   fml::MessageLoop::GetCurrent().RunExpiredTasksNow();
   return kSuccess;
@@ -3637,6 +3738,8 @@ FlutterEngineResult FlutterEngineGetProcAddresses(
   SET_PROC(SetNextFrameCallback, FlutterEngineSetNextFrameCallback);
   SET_PROC(AddView, FlutterEngineAddView);
   SET_PROC(RemoveView, FlutterEngineRemoveView);
+  SET_PROC(SendPlatformMessageResponseNoCopy,
+           FlutterEngineSendPlatformMessageResponseNoCopy);
 #undef SET_PROC
 
   return kSuccess;
@@ -580,6 +580,17 @@ typedef bool (*BoolPresentInfoCallback)(
     void* /* user data */,
     const FlutterPresentInfo* /* present info */);
 
+/// Callback for when a software buffer is presented along with the areas of
+/// it that were repainted.
+///
+/// See: \ref FlutterSoftwareRendererConfig.
+typedef bool (*SoftwareSurfacePresentWithDamageCallback)(
+    void* /* user data */,
+    const void* /* allocation */,
+    size_t /* row bytes */,
+    size_t /* height */,
+    const FlutterDamage* /* damage */);
+
 typedef struct {
   /// The size of this struct. Must be sizeof(FlutterOpenGLRendererConfig).
   size_t struct_size;
@@ -891,6 +902,18 @@ typedef struct {
   /// format. The buffer is owned by the Flutter engine and must be copied in
   /// this callback if needed.
   SoftwareSurfacePresentCallback surface_present_callback;
+  /// Optional callback that is invoked instead of `surface_present_callback`
+  /// when it is specified. At least one of the two callbacks must be
+  /// specified.
+  ///
+  /// Specifying it opts in to a software renderer that keeps a single buffer
+  /// from frame to frame, only repaints the areas of it that changed and
+  /// splits that work across the engine's worker threads. The buffer passed
+  /// to this callback is the same as long as the size of the surface doesn't
+  /// change and only the pixels in the areas listed in the damage were
+  /// modified since it was last presented. The damage is only valid for the
+  /// duration of the callback.
+  SoftwareSurfacePresentWithDamageCallback surface_present_with_damage_callback;
 } FlutterSoftwareRendererConfig;
 
 typedef struct {
@@ -1242,6 +1265,19 @@ typedef struct {
   /// `FlutterEngineSendPlatformMessageResponse` will cause a memory leak. It is
   /// not safe to send multiple responses on a single response object.
   const FlutterPlatformMessageResponseHandle* response_handle;
+  /// Optional. If set, `FlutterEngineSendPlatformMessage` takes ownership of
+  /// `message` instead of copying it, which avoids copying large payloads.
+  /// The buffer may be handed to the Dart application as is and must be
+  /// writable. The engine invokes this callback with `release_user_data` on
+  /// an arbitrary thread once it no longer needs the buffer. If
+  /// `FlutterEngineSendPlatformMessage` does not return `kSuccess`, the
+  /// callback has been invoked before it returns. This field is ignored on
+  /// the messages that the engine passes to the embedder, whose buffers are
+  /// owned by the engine and only valid for the duration of the
+  /// `FlutterPlatformMessageCallback`.
+  VoidCallback release_callback;
+  /// The user data passed to `release_callback`.
+  void* release_user_data;
 } FlutterPlatformMessage;
 
 typedef void (*FlutterPlatformMessageCallback)(
@@ -2830,6 +2866,40 @@ FlutterEngineResult FlutterEngineSendPlatformMessageResponse(
     const uint8_t* data,
     size_t data_length);
 
+//------------------------------------------------------------------------------
+/// @brief      Send a response from the native side to a platform message from
+///             the Dart Flutter application without copying the response
+///             data.
+///
+///             The engine takes ownership of `data`, hands it to the Dart
+///             application as is, and invokes `release_callback` on an
+///             arbitrary thread once it is no longer needed. This is useful
+///             for large responses such as file contents or camera frames.
+///             The callback is invoked even if the call fails.
+///
+/// @see        FlutterEngineSendPlatformMessageResponse()
+///
+/// @param[in]  engine             The running engine instance.
+/// @param[in]  handle             The platform message response handle.
+/// @param[in]  data               The data to associate with the platform
+///                                message response.
+/// @param[in]  data_length        The length of the platform message response
+///                                data.
+/// @param[in]  release_callback   Invoked once the engine no longer needs
+///                                `data`.
+/// @param[in]  release_user_data  The user data passed to `release_callback`.
+///
+/// @return     The result of the call.
+///
+FLUTTER_EXPORT
+FlutterEngineResult FlutterEngineSendPlatformMessageResponseNoCopy(
+    FLUTTER_API_SYMBOL(FlutterEngine) engine,
+    const FlutterPlatformMessageResponseHandle* handle,
+    const uint8_t* data,
+    size_t data_length,
+    VoidCallback release_callback,
+    void* release_user_data);
+
 //------------------------------------------------------------------------------
 /// @brief      This API is only meant to be used by platforms that need to
 ///             flush tasks on a message loop not controlled by the Flutter
@@ -3391,6 +3461,14 @@ typedef FlutterEngineResult (*FlutterEngineAddViewFnPtr)(
 typedef FlutterEngineResult (*FlutterEngineRemoveViewFnPtr)(
     FLUTTER_API_SYMBOL(FlutterEngine) engine,
     const FlutterRemoveViewInfo* info);
+typedef FlutterEngineResult (
+    *FlutterEngineSendPlatformMessageResponseNoCopyFnPtr)(
+    FLUTTER_API_SYMBOL(FlutterEngine) engine,
+    const FlutterPlatformMessageResponseHandle* handle,
+    const uint8_t* data,
+    size_t data_length,
+    VoidCallback release_callback,
+    void* release_user_data);
 
 /// Function-pointer-based versions of the APIs above.
 typedef struct {
@@ -3439,6 +3517,8 @@ typedef struct {
   FlutterEngineSetNextFrameCallbackFnPtr SetNextFrameCallback;
   FlutterEngineAddViewFnPtr AddView;
   FlutterEngineRemoveViewFnPtr RemoveView;
+  FlutterEngineSendPlatformMessageResponseNoCopyFnPtr
+      SendPlatformMessageResponseNoCopy;
 } FlutterEngineProcTable;
 
 //------------------------------------------------------------------------------
@@ -4,9 +4,14 @@
 
 #include "flutter/shell/platform/embedder/embedder_engine.h"
 
+#include "flutter/fml/build_config.h"
 #include "flutter/fml/make_copyable.h"
 #include "flutter/shell/platform/embedder/vsync_waiter_embedder.h"
 
+#if defined(FML_OS_LINUX)
+#include "flutter/shell/profiling/profiler_metrics_linux.h"
+#endif  // defined(FML_OS_LINUX)
+
 namespace flutter {
 
 struct ShellArgs {
@@ -53,6 +58,10 @@ bool EmbedderEngine::LaunchShell() {
       flutter::PlatformData(), task_runners_, shell_args_->settings,
       shell_args_->on_create_platform_view, shell_args_->on_create_rasterizer);
 
+  if (shell_) {
+    StartProfiler(shell_args_->settings.profiler_samples_per_second);
+  }
+
   // Reset the args no matter what. They will never be used to initialize a
   // shell again.
   shell_args_.reset();
@@ -60,6 +69,46 @@ bool EmbedderEngine::LaunchShell() {
   return IsValid();
 }
 
+void EmbedderEngine::StartProfiler(int samples_per_second) {
+  if (samples_per_second <= 0) {
+    return;
+  }
+#if defined(FML_OS_LINUX) &&                               \
+    (FLUTTER_RUNTIME_MODE == FLUTTER_RUNTIME_MODE_DEBUG || \
+     FLUTTER_RUNTIME_MODE == FLUTTER_RUNTIME_MODE_PROFILE)
+  const std::string thread_label = "io.flutter";
+  profiler_thread_ = std::make_unique<fml::Thread>(
+      ThreadHost::ThreadHostConfig::MakeThreadName(ThreadHost::Type::kProfiler,
+                                                   thread_label));
+  auto metrics = std::make_shared<ProfilerMetricsLinux>();
+
+  // The kernel truncates the names of the threads of the engine, so they
+  // register themselves instead. When the UI thread is the platform thread,
+  // its CPU time is attributed to the UI thread.
+  using ThreadRole = ProfilerMetricsLinux::ThreadRole;
+  const std::pair<fml::RefPtr<fml::TaskRunner>, ThreadRole> threads[] = {
+      {task_runners_.GetPlatformTaskRunner(), ThreadRole::kPlatform},
+      {task_runners_.GetUITaskRunner(), ThreadRole::kUI},
+      {task_runners_.GetRasterTaskRunner(), ThreadRole::kRaster},
+      {task_runners_.GetIOTaskRunner(), ThreadRole::kIO},
+  };
+  for (const auto& [task_runner, role] : threads) {
+    if (task_runner) {
+      task_runner->PostTask(
+          [metrics, role = role]() { metrics->RegisterCurrentThread(role); });
+    }
+  }
+
+  profiler_ = std::make_unique<SamplingProfiler>(
+      thread_label.c_str(), profiler_thread_->GetTaskRunner(),
+      [metrics]() { return metrics->GenerateSample(); }, samples_per_second);
+  profiler_->Start();
+#else
+  FML_DLOG(WARNING) << "Sampling the CPU and memory usage is not supported "
+                       "on this platform or in this runtime mode.";
+#endif
+}
+
 bool EmbedderEngine::CollectShell() {
   shell_.reset();
   return IsValid();
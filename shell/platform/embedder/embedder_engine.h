@@ -9,11 +9,13 @@
 #include <unordered_map>
 
 #include "flutter/fml/macros.h"
+#include "flutter/fml/thread.h"
 #include "flutter/shell/common/shell.h"
 #include "flutter/shell/common/thread_host.h"
 #include "flutter/shell/platform/embedder/embedder.h"
 #include "flutter/shell/platform/embedder/embedder_external_texture_resolver.h"
 #include "flutter/shell/platform/embedder/embedder_thread_host.h"
+#include "flutter/shell/profiling/sampling_profiler.h"
 namespace flutter {
 
 struct ShellArgs;
@@ -94,6 +96,12 @@ class EmbedderEngine {
   std::unique_ptr<ShellArgs> shell_args_;
   std::unique_ptr<Shell> shell_;
   std::unique_ptr<EmbedderExternalTextureResolver> external_texture_resolver_;
+  // The profiler is declared after its thread so that it is stopped while the
+  // thread is still running.
+  std::unique_ptr<fml::Thread> profiler_thread_;
+  std::unique_ptr<SamplingProfiler> profiler_;
+
+  void StartProfiler(int samples_per_second);
 
   FML_DISALLOW_COPY_AND_ASSIGN(EmbedderEngine);
 };
@@ -17,10 +17,13 @@ namespace flutter {
 
 EmbedderSurfaceSoftware::EmbedderSurfaceSoftware(
     SoftwareDispatchTable software_dispatch_table,
-    std::shared_ptr<EmbedderExternalViewEmbedder> external_view_embedder)
+    std::shared_ptr<EmbedderExternalViewEmbedder> external_view_embedder,
+    std::shared_ptr<fml::ConcurrentTaskRunner> worker_task_runner)
     : software_dispatch_table_(std::move(software_dispatch_table)),
-      external_view_embedder_(std::move(external_view_embedder)) {
-  if (!software_dispatch_table_.software_present_backing_store) {
+      external_view_embedder_(std::move(external_view_embedder)),
+      worker_task_runner_(std::move(worker_task_runner)) {
+  if (!software_dispatch_table_.software_present_backing_store &&
+      !software_dispatch_table_.software_present_backing_store_with_damage) {
     return;
   }
   valid_ = true;
@@ -39,7 +42,14 @@ std::unique_ptr<Surface> EmbedderSurfaceSoftware::CreateGPUSurface() {
     return nullptr;
   }
   const bool render_to_surface = !external_view_embedder_;
-  auto surface = std::make_unique<GPUSurfaceSoftware>(this, render_to_surface);
+  // Frames are only rasterized in tiles into a retained backing store when
+  // the embedder can be told which parts of it changed.
+  std::shared_ptr<fml::ConcurrentTaskRunner> worker_task_runner =
+      software_dispatch_table_.software_present_backing_store_with_damage
+          ? worker_task_runner_
+          : nullptr;
+  auto surface = std::make_unique<GPUSurfaceSoftware>(
+      this, render_to_surface, std::move(worker_task_runner));
 
   if (!surface->IsValid()) {
     return nullptr;
@@ -84,32 +94,70 @@ sk_sp<SkSurface> EmbedderSurfaceSoftware::AcquireBackingStore(
 // |GPUSurfaceSoftwareDelegate|
 bool EmbedderSurfaceSoftware::PresentBackingStore(
     sk_sp<SkSurface> backing_store) {
+  if (!software_dispatch_table_.software_present_backing_store) {
+    // The whole backing store was repainted.
+    return PresentBackingStoreWithDamage(
+        backing_store,
+        {SkIRect::MakeWH(backing_store->width(), backing_store->height())});
+  }
+
+  SkPixmap pixmap;
+  if (!GetBackingStorePixels(backing_store, &pixmap)) {
+    return false;
+  }
+
+  return software_dispatch_table_.software_present_backing_store(
+      pixmap.addr(),      //
+      pixmap.rowBytes(),  //
+      pixmap.height()     //
+  );
+}
+
+// |GPUSurfaceSoftwareDelegate|
+bool EmbedderSurfaceSoftware::PresentBackingStoreWithDamage(
+    sk_sp<SkSurface> backing_store,
+    const std::vector<SkIRect>& dirty_rects) {
+  if (!software_dispatch_table_.software_present_backing_store_with_damage) {
+    return PresentBackingStore(std::move(backing_store));
+  }
+
+  SkPixmap pixmap;
+  if (!GetBackingStorePixels(backing_store, &pixmap)) {
+    return false;
+  }
+
+  return software_dispatch_table_.software_present_backing_store_with_damage(
+      pixmap.addr(),      //
+      pixmap.rowBytes(),  //
+      pixmap.height(),    //
+      dirty_rects         //
+  );
+}
+
+bool EmbedderSurfaceSoftware::GetBackingStorePixels(
+    const sk_sp<SkSurface>& backing_store,
+    SkPixmap* pixmap) const {
   if (!IsValid()) {
     FML_LOG(ERROR) << "Tried to present an invalid software surface.";
     return false;
   }
 
-  SkPixmap pixmap;
-  if (!backing_store->peekPixels(&pixmap)) {
+  if (!backing_store->peekPixels(pixmap)) {
     FML_LOG(ERROR) << "Could not peek the pixels of the backing store.";
     return false;
   }
 
   // Some basic sanity checking.
-  uint64_t expected_pixmap_data_size = pixmap.width() * pixmap.height() * 4;
+  uint64_t expected_pixmap_data_size = pixmap->width() * pixmap->height() * 4;
 
-  const size_t pixmap_size = pixmap.computeByteSize();
+  const size_t pixmap_size = pixmap->computeByteSize();
 
   if (expected_pixmap_data_size != pixmap_size) {
     FML_LOG(ERROR) << "Software backing store had unexpected size.";
     return false;
   }
 
-  return software_dispatch_table_.software_present_backing_store(
-      pixmap.addr(),      //
-      pixmap.rowBytes(),  //
-      pixmap.height()     //
-  );
+  return true;
 }
 
 }  // namespace flutter
@@ -5,6 +5,9 @@
 #ifndef FLUTTER_SHELL_PLATFORM_EMBEDDER_EMBEDDER_SURFACE_SOFTWARE_H_
 #define FLUTTER_SHELL_PLATFORM_EMBEDDER_EMBEDDER_SURFACE_SOFTWARE_H_
 
+#include <vector>
+
+#include "flutter/fml/concurrent_message_loop.h"
 #include "flutter/fml/macros.h"
 #include "flutter/shell/gpu/gpu_surface_software.h"
 #include "flutter/shell/platform/embedder/embedder_external_view_embedder.h"
@@ -18,13 +21,20 @@ class EmbedderSurfaceSoftware final : public EmbedderSurface,
                                       public GPUSurfaceSoftwareDelegate {
  public:
   struct SoftwareDispatchTable {
+    // At least one of the two callbacks is required.
     std::function<bool(const void* allocation, size_t row_bytes, size_t height)>
-        software_present_backing_store;  // required
+        software_present_backing_store;  // optional
+    std::function<bool(const void* allocation,
+                       size_t row_bytes,
+                       size_t height,
+                       const std::vector<SkIRect>& dirty_rects)>
+        software_present_backing_store_with_damage;  // optional
   };
 
   EmbedderSurfaceSoftware(
       SoftwareDispatchTable software_dispatch_table,
-      std::shared_ptr<EmbedderExternalViewEmbedder> external_view_embedder);
+      std::shared_ptr<EmbedderExternalViewEmbedder> external_view_embedder,
+      std::shared_ptr<fml::ConcurrentTaskRunner> worker_task_runner = nullptr);
 
   ~EmbedderSurfaceSoftware() override;
 
@@ -33,6 +43,7 @@ class EmbedderSurfaceSoftware final : public EmbedderSurface,
   SoftwareDispatchTable software_dispatch_table_;
   sk_sp<SkSurface> sk_surface_;
   std::shared_ptr<EmbedderExternalViewEmbedder> external_view_embedder_;
+  std::shared_ptr<fml::ConcurrentTaskRunner> worker_task_runner_;
 
   // |EmbedderSurface|
   bool IsValid() const override;
@@ -49,6 +60,14 @@ class EmbedderSurfaceSoftware final : public EmbedderSurface,
   // |GPUSurfaceSoftwareDelegate|
   bool PresentBackingStore(sk_sp<SkSurface> backing_store) override;
 
+  // |GPUSurfaceSoftwareDelegate|
+  bool PresentBackingStoreWithDamage(
+      sk_sp<SkSurface> backing_store,
+      const std::vector<SkIRect>& dirty_rects) override;
+
+  bool GetBackingStorePixels(const sk_sp<SkSurface>& backing_store,
+                             SkPixmap* pixmap) const;
+
   FML_DISALLOW_COPY_AND_ASSIGN(EmbedderSurfaceSoftware);
 };
 
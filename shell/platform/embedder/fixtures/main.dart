@@ -400,6 +400,21 @@ void platform_messages_response() {
   signalNativeTest();
 }
 
+@pragma('vm:entry-point')
+// ignore: non_constant_identifier_names
+void platform_messages_receive_response() {
+  PlatformDispatcher.instance.sendPlatformMessage('test/response', null,
+      (ByteData? data) {
+    final Uint8List list =
+        data!.buffer.asUint8List(data.offsetInBytes, data.lengthInBytes);
+    int checksum = 0;
+    for (final int byte in list) {
+      checksum = (checksum + byte) & 0xffffffff;
+    }
+    signalNativeMessage('${list.length}:$checksum');
+  });
+}
+
 @pragma('vm:entry-point')
 // ignore: non_constant_identifier_names
 void platform_messages_no_response() {
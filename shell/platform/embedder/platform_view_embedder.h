@@ -57,14 +57,17 @@ class PlatformViewEmbedder final : public PlatformView {
     ChanneUpdateCallback on_channel_update;                     // optional
   };
 
-  // Create a platform view that sets up a software rasterizer.
+  // Create a platform view that sets up a software rasterizer. The
+  // |worker_task_runner| is used to rasterize frames in tiles if the
+  // embedder presents them with damage.
   PlatformViewEmbedder(
       PlatformView::Delegate& delegate,
       const flutter::TaskRunners& task_runners,
       const EmbedderSurfaceSoftware::SoftwareDispatchTable&
           software_dispatch_table,
       PlatformDispatchTable platform_dispatch_table,
-      std::shared_ptr<EmbedderExternalViewEmbedder> external_view_embedder);
+      std::shared_ptr<EmbedderExternalViewEmbedder> external_view_embedder,
+      std::shared_ptr<fml::ConcurrentTaskRunner> worker_task_runner = nullptr);
 
 #ifdef SHELL_ENABLE_GL
   // Creates a platform view that sets up an OpenGL rasterizer.
@@ -68,4 +68,43 @@ bool EmbedderTestContextSoftware::Present(const sk_sp<SkImage>& image) {
   return true;
 }
 
+void EmbedderTestContextSoftware::SetPresentWithDamageCallback(
+    PresentWithDamageCallback callback) {
+  present_with_damage_callback_ = std::move(callback);
+  renderer_config_.software.surface_present_callback = nullptr;
+  renderer_config_.software.surface_present_with_damage_callback =
+      [](void* context, const void* allocation, size_t row_bytes,
+         size_t height, const FlutterDamage* damage) {
+        return reinterpret_cast<EmbedderTestContextSoftware*>(context)
+            ->PresentWithDamage(allocation, row_bytes, height, damage);
+      };
+}
+
+bool EmbedderTestContextSoftware::PresentWithDamage(
+    const void* allocation,
+    size_t row_bytes,
+    size_t height,
+    const FlutterDamage* damage) {
+  if (damage == nullptr || damage->struct_size != sizeof(FlutterDamage)) {
+    FML_LOG(ERROR) << "Invalid damage for the presented software buffer.";
+    return false;
+  }
+  // The buffer is retained by the engine and drawn into again for the next
+  // frame, so its pixels are copied.
+  auto image_info =
+      SkImageInfo::MakeN32Premul(SkISize::Make(row_bytes / 4, height));
+  sk_sp<SkImage> image = SkImages::RasterFromPixmapCopy(
+      SkPixmap(image_info, allocation, row_bytes));
+  if (!image) {
+    FML_LOG(ERROR) << "Could not copy pixels for the software composition "
+                      "from the engine.";
+    return false;
+  }
+  if (present_with_damage_callback_) {
+    present_with_damage_callback_(std::vector<FlutterRect>(
+        damage->damage, damage->damage + damage->num_rects));
+  }
+  return Present(image);
+}
+
 }  // namespace flutter::testing
@@ -5,6 +5,9 @@
 #ifndef FLUTTER_SHELL_PLATFORM_EMBEDDER_TESTS_EMBEDDER_TEST_CONTEXT_SOFTWARE_H_
 #define FLUTTER_SHELL_PLATFORM_EMBEDDER_TESTS_EMBEDDER_TEST_CONTEXT_SOFTWARE_H_
 
+#include <functional>
+#include <vector>
+
 #include "flutter/shell/platform/embedder/tests/embedder_test_context.h"
 
 #include "third_party/skia/include/core/SkSurface.h"
@@ -26,13 +29,32 @@ class EmbedderTestContextSoftware : public EmbedderTestContext {
 
   bool Present(const sk_sp<SkImage>& image);
 
+  using PresentWithDamageCallback =
+      std::function<void(const std::vector<FlutterRect>& damage)>;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Presents frames through
+  ///             `FlutterSoftwareRendererConfig.surface_present_with_damage_callback`
+  ///             instead of `surface_present_callback`, and passes the damage
+  ///             of each presented frame to `callback`. Must be called before
+  ///             the engine is launched.
+  ///
+  void SetPresentWithDamageCallback(PresentWithDamageCallback callback);
+
  private:
+  PresentWithDamageCallback present_with_damage_callback_;
+
   // |EmbedderTestContext|
   void SetSurface(SkISize surface_size) override;
 
   // |EmbedderTestContext|
   void SetupCompositor() override;
 
+  bool PresentWithDamage(const void* allocation,
+                         size_t row_bytes,
+                         size_t height,
+                         const FlutterDamage* damage);
+
   sk_sp<SkSurface> surface_;
   SkISize surface_size_;
   size_t software_surface_present_count_ = 0;
@@ -4,6 +4,7 @@
 
 #define FML_USED_ON_EMBEDDER
 
+#include <future>
 #include <string>
 #include <utility>
 #include <vector>
@@ -470,6 +471,187 @@ TEST_F(EmbedderTest, PlatformMessagesCanBeSentWithoutResponseHandles) {
   message.Wait();
 }
 
+//------------------------------------------------------------------------------
+/// Tests that the engine adopts the data of a platform message that is sent
+/// with a release callback and releases it once it is no longer needed.
+///
+TEST_F(EmbedderTest, PlatformMessagesCanBeSentWithoutCopies) {
+  struct Captures {
+    // Large enough to be handed to Dart without a copy.
+    std::vector<uint8_t> message_data = std::vector<uint8_t>(1 << 20, 0xab);
+    fml::AutoResetWaitableEvent response_latch;
+    fml::AutoResetWaitableEvent release_latch;
+  };
+  Captures captures;
+
+  // The responses are delivered on the platform thread, which must keep
+  // pumping its event loop while the test waits for them.
+  auto platform_task_runner = CreateNewThread("test_platform_thread");
+  UniqueEngine engine;
+
+  platform_task_runner->PostTask([&]() {
+    auto& context = GetEmbedderContext<EmbedderTestContextSoftware>();
+    EmbedderConfigBuilder builder(context);
+    builder.SetSurface(SkISize::Make(1, 1));
+    builder.SetDartEntrypoint("platform_messages_response");
+
+    fml::AutoResetWaitableEvent ready;
+    context.AddNativeCallback(
+        "SignalNativeTest",
+        CREATE_NATIVE_ENTRY(
+            [&ready](Dart_NativeArguments args) { ready.Signal(); }));
+
+    engine = builder.LaunchEngine();
+    ASSERT_TRUE(engine.is_valid());
+
+    FlutterPlatformMessageResponseHandle* response_handle = nullptr;
+    auto callback = [](const uint8_t* data, size_t size,
+                       void* user_data) -> void {
+      auto captures = reinterpret_cast<Captures*>(user_data);
+      ASSERT_EQ(size, captures->message_data.size());
+      ASSERT_EQ(memcmp(captures->message_data.data(), data, size), 0);
+      captures->response_latch.Signal();
+    };
+    auto result = FlutterPlatformMessageCreateResponseHandle(
+        engine.get(), callback, &captures, &response_handle);
+    ASSERT_EQ(result, kSuccess);
+
+    FlutterPlatformMessage message = {};
+    message.struct_size = sizeof(FlutterPlatformMessage);
+    message.channel = "test_channel";
+    message.message = captures.message_data.data();
+    message.message_size = captures.message_data.size();
+    message.response_handle = response_handle;
+    message.release_callback = [](void* user_data) {
+      reinterpret_cast<Captures*>(user_data)->release_latch.Signal();
+    };
+    message.release_user_data = &captures;
+
+    ready.Wait();
+    result = FlutterEngineSendPlatformMessage(engine.get(), &message);
+    ASSERT_EQ(result, kSuccess);
+    result = FlutterPlatformMessageReleaseResponseHandle(engine.get(),
+                                                         response_handle);
+    ASSERT_EQ(result, kSuccess);
+  });
+
+  captures.response_latch.Wait();
+
+  // Dart holds on to the message until it is collected, at the latest when
+  // the isolate shuts down.
+  fml::AutoResetWaitableEvent kill_latch;
+  platform_task_runner->PostTask([&]() {
+    engine.reset();
+    kill_latch.Signal();
+  });
+  kill_latch.Wait();
+  captures.release_latch.Wait();
+}
+
+TEST_F(EmbedderTest, PlatformMessageDataIsReleasedWhenSendingFails) {
+  bool released = false;
+  const uint8_t message_data[] = {1, 2, 3};
+  FlutterPlatformMessage message = {};
+  message.struct_size = sizeof(FlutterPlatformMessage);
+  message.channel = "test_channel";
+  message.message = message_data;
+  message.message_size = sizeof(message_data);
+  message.release_callback = [](void* user_data) {
+    *reinterpret_cast<bool*>(user_data) = true;
+  };
+  message.release_user_data = &released;
+
+  ASSERT_EQ(FlutterEngineSendPlatformMessage(nullptr, &message),
+            kInvalidArguments);
+  ASSERT_TRUE(released);
+}
+
+TEST_F(EmbedderTest, PlatformMessageResponsesCanBeSentWithoutCopies) {
+  struct Captures {
+    // Large enough to be handed to Dart without a copy.
+    std::vector<uint8_t> response_data = std::vector<uint8_t>(1 << 20);
+    std::string received_response;
+    fml::AutoResetWaitableEvent response_latch;
+    fml::AutoResetWaitableEvent release_latch;
+  };
+  Captures captures;
+  uint64_t checksum = 0;
+  for (size_t i = 0; i < captures.response_data.size(); i++) {
+    captures.response_data[i] = static_cast<uint8_t>(i * 7);
+    checksum = (checksum + captures.response_data[i]) & 0xffffffff;
+  }
+
+  auto platform_task_runner = CreateNewThread("test_platform_thread");
+  UniqueEngine engine;
+
+  platform_task_runner->PostTask([&]() {
+    auto& context = GetEmbedderContext<EmbedderTestContextSoftware>();
+    EmbedderConfigBuilder builder(context);
+    builder.SetSurface(SkISize::Make(1, 1));
+    builder.SetDartEntrypoint("platform_messages_receive_response");
+    builder.SetPlatformMessageCallback(
+        [&](const FlutterPlatformMessage* message) {
+          if (strcmp(message->channel, "test/response") != 0) {
+            return;
+          }
+          auto result = FlutterEngineSendPlatformMessageResponseNoCopy(
+              engine.get(), message->response_handle,
+              captures.response_data.data(), captures.response_data.size(),
+              [](void* user_data) {
+                reinterpret_cast<Captures*>(user_data)->release_latch.Signal();
+              },
+              &captures);
+          ASSERT_EQ(result, kSuccess);
+        });
+    context.AddNativeCallback(
+        "SignalNativeMessage",
+        CREATE_NATIVE_ENTRY([&captures](Dart_NativeArguments args) {
+          captures.received_response =
+              tonic::DartConverter<std::string>::FromDart(
+                  Dart_GetNativeArgument(args, 0));
+          captures.response_latch.Signal();
+        }));
+
+    engine = builder.LaunchEngine();
+    ASSERT_TRUE(engine.is_valid());
+  });
+
+  captures.response_latch.Wait();
+  ASSERT_EQ(captures.received_response,
+            std::to_string(captures.response_data.size()) + ":" +
+                std::to_string(checksum));
+
+  // Dart holds on to the response until it is collected, at the latest when
+  // the isolate shuts down.
+  fml::AutoResetWaitableEvent kill_latch;
+  platform_task_runner->PostTask([&]() {
+    engine.reset();
+    kill_latch.Signal();
+  });
+  kill_latch.Wait();
+  captures.release_latch.Wait();
+}
+
+TEST_F(EmbedderTest, PlatformMessageResponseDataIsReleasedOnInvalidArguments) {
+  int release_count = 0;
+  const uint8_t response_data[] = {1, 2, 3};
+  VoidCallback release_callback = [](void* user_data) {
+    (*reinterpret_cast<int*>(user_data))++;
+  };
+
+  ASSERT_EQ(FlutterEngineSendPlatformMessageResponseNoCopy(
+                nullptr, nullptr, response_data, sizeof(response_data),
+                release_callback, &release_count),
+            kInvalidArguments);
+  ASSERT_EQ(release_count, 1);
+
+  ASSERT_EQ(FlutterEngineSendPlatformMessageResponseNoCopy(
+                nullptr, nullptr, nullptr, sizeof(response_data),
+                release_callback, &release_count),
+            kInvalidArguments);
+  ASSERT_EQ(release_count, 2);
+}
+
 //------------------------------------------------------------------------------
 /// Tests that a null platform message can be sent.
 ///
@@ -939,6 +1121,62 @@ TEST_F(EmbedderTest,
   ASSERT_EQ(context.GetSurfacePresentCount(), 0u);
 }
 
+//------------------------------------------------------------------------------
+/// Test that a software renderer that presents with damage receives the
+/// repainted areas of the buffer, and that the buffer, which is rasterized in
+/// tiles in this mode, holds the same pixels as without damage.
+///
+TEST_F(EmbedderTest, SoftwarePresentWithDamageReceivesDamageAndPixels) {
+  FlutterWindowMetricsEvent event = {};
+  event.struct_size = sizeof(event);
+  event.width = 800;
+  event.height = 600;
+  event.pixel_ratio = 1.0;
+
+  sk_sp<SkImage> expected_image;
+  {
+    EmbedderTestContextSoftware reference_context(GetFixturesDirectory());
+    EmbedderConfigBuilder builder(reference_context);
+    builder.SetSurface(SkISize::Make(800, 600));
+    builder.SetDartEntrypoint("render_gradient");
+    auto rendered_scene = reference_context.GetNextSceneImage();
+    auto engine = builder.LaunchEngine();
+    ASSERT_TRUE(engine.is_valid());
+    ASSERT_EQ(FlutterEngineSendWindowMetricsEvent(engine.get(), &event),
+              kSuccess);
+    expected_image = rendered_scene.get();
+  }
+
+  auto& context = GetEmbedderContext<EmbedderTestContextSoftware>();
+  std::promise<std::vector<FlutterRect>> damage_promise;
+  auto first_damage = damage_promise.get_future();
+  bool damage_reported = false;
+  // Called on the raster thread.
+  context.SetPresentWithDamageCallback(
+      [&damage_promise,
+       &damage_reported](const std::vector<FlutterRect>& damage) {
+        if (!damage_reported) {
+          damage_reported = true;
+          damage_promise.set_value(damage);
+        }
+      });
+
+  EmbedderConfigBuilder builder(context);
+  builder.SetSurface(SkISize::Make(800, 600));
+  builder.SetDartEntrypoint("render_gradient");
+  auto rendered_scene = context.GetNextSceneImage();
+  auto engine = builder.LaunchEngine();
+  ASSERT_TRUE(engine.is_valid());
+  ASSERT_EQ(FlutterEngineSendWindowMetricsEvent(engine.get(), &event),
+            kSuccess);
+
+  // Nothing was presented before the first frame, so all of it is damaged.
+  std::vector<FlutterRect> damage = first_damage.get();
+  ASSERT_EQ(damage.size(), 1u);
+  EXPECT_EQ(damage[0], FlutterRectMakeLTRB(0, 0, 800, 600));
+  EXPECT_TRUE(RasterImagesAreSame(rendered_scene.get(), expected_image));
+}
+
 //------------------------------------------------------------------------------
 /// Test the layer structure and pixels rendered when using a custom software
 /// compositor, with a transparent overlay
@@ -0,0 +1,297 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/shell/profiling/profiler_metrics_linux.h"
+
+#include <fcntl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <sstream>
+#include <utility>
+
+#include "flutter/fml/eintr_wrapper.h"
+#include "flutter/fml/file.h"
+#include "flutter/fml/unique_fd.h"
+
+namespace flutter {
+
+namespace {
+
+using ThreadRole = ProfilerMetricsLinux::ThreadRole;
+
+constexpr double kKilobytesPerMegabyte = 1024.0;
+constexpr double kBytesPerMegabyte = 1024.0 * 1024.0;
+
+struct ProcStat {
+  std::string name;
+  uint64_t cpu_ticks = 0;
+};
+
+// procfs files report a size of zero, so they are read until the end instead
+// of being mapped.
+std::optional<std::string> ReadProcFile(const std::string& path) {
+  fml::UniqueFD fd(
+      FML_HANDLE_EINTR(::open(path.c_str(), O_RDONLY | O_CLOEXEC)));
+  if (!fd.is_valid()) {
+    return std::nullopt;
+  }
+  std::string contents;
+  char buffer[4096];
+  while (true) {
+    ssize_t read_size =
+        FML_HANDLE_EINTR(::read(fd.get(), buffer, sizeof(buffer)));
+    if (read_size < 0) {
+      return std::nullopt;
+    }
+    if (read_size == 0) {
+      return contents;
+    }
+    contents.append(buffer, read_size);
+  }
+}
+
+// Parses the `stat` file of a process or of a thread. The name is in
+// parentheses and may itself contain spaces and parentheses, so the fields
+// that follow it are counted from the last parenthesis.
+std::optional<ProcStat> ParseStat(const std::string& stat) {
+  size_t name_begin = stat.find('(');
+  size_t name_end = stat.rfind(')');
+  if (name_begin == std::string::npos || name_end == std::string::npos ||
+      name_end < name_begin) {
+    return std::nullopt;
+  }
+  std::istringstream fields(stat.substr(name_end + 1));
+  // Skip the 3rd (state) to the 13th (cmajflt) fields to get to utime and
+  // stime, the 14th and 15th fields.
+  std::string skipped;
+  for (int field = 3; field <= 13; field++) {
+    if (!(fields >> skipped)) {
+      return std::nullopt;
+    }
+  }
+  uint64_t user_ticks = 0;
+  uint64_t system_ticks = 0;
+  if (!(fields >> user_ticks >> system_ticks)) {
+    return std::nullopt;
+  }
+  return ProcStat{
+      .name = stat.substr(name_begin + 1, name_end - name_begin - 1),
+      .cpu_ticks = user_ticks + system_ticks,
+  };
+}
+
+// Parses the "Name:   1234 kB" lines of `smaps_rollup`.
+std::unordered_map<std::string, double> ParseKilobyteFields(
+    const std::string& contents) {
+  std::unordered_map<std::string, double> fields;
+  std::istringstream lines(contents);
+  std::string line;
+  while (std::getline(lines, line)) {
+    std::istringstream tokens(line);
+    std::string name;
+    double kilobytes = 0;
+    if (tokens >> name >> kilobytes && name.size() > 1 && name.back() == ':') {
+      name.pop_back();
+      fields[name] = kilobytes;
+    }
+  }
+  return fields;
+}
+
+bool EndsWith(const std::string& name, const std::string& suffix) {
+  return name.size() >= suffix.size() &&
+         name.compare(name.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+// Threads that were not registered are attributed by name. The kernel
+// truncates thread names to 15 characters, which usually leaves the names of
+// the workers intact but not always those of the other threads of the engine.
+std::optional<ThreadRole> GetThreadRole(
+    const std::unordered_map<pid_t, ThreadRole>& thread_roles,
+    pid_t tid,
+    const std::string& name) {
+  auto found = thread_roles.find(tid);
+  if (found != thread_roles.end()) {
+    return found->second;
+  }
+  if (name.rfind("io.worker.", 0) == 0) {
+    return ThreadRole::kWorker;
+  }
+  if (EndsWith(name, ".platform")) {
+    return ThreadRole::kPlatform;
+  }
+  if (EndsWith(name, ".ui")) {
+    return ThreadRole::kUI;
+  }
+  if (EndsWith(name, ".raster")) {
+    return ThreadRole::kRaster;
+  }
+  if (EndsWith(name, ".io")) {
+    return ThreadRole::kIO;
+  }
+  return std::nullopt;
+}
+
+double* GetRoleCpuUsage(ThreadCpuUsageInfo& usage,
+                        std::optional<ThreadRole> role) {
+  if (!role) {
+    return &usage.other_cpu_usage;
+  }
+  switch (*role) {
+    case ThreadRole::kPlatform:
+      return &usage.platform_cpu_usage;
+    case ThreadRole::kUI:
+      return &usage.ui_cpu_usage;
+    case ThreadRole::kRaster:
+      return &usage.raster_cpu_usage;
+    case ThreadRole::kIO:
+      return &usage.io_cpu_usage;
+    case ThreadRole::kWorker:
+      return &usage.worker_cpu_usage;
+  }
+  return &usage.other_cpu_usage;
+}
+
+}  // namespace
+
+ProfilerMetricsLinux::ProfilerMetricsLinux(std::string proc_self_path)
+    : proc_self_path_(std::move(proc_self_path)),
+      clock_ticks_per_second_(::sysconf(_SC_CLK_TCK)),
+      num_cpus_(std::max<int64_t>(1, ::sysconf(_SC_NPROCESSORS_ONLN))) {}
+
+ProfilerMetricsLinux::~ProfilerMetricsLinux() = default;
+
+void ProfilerMetricsLinux::RegisterThread(pid_t tid, ThreadRole role) {
+  std::scoped_lock lock(thread_roles_mutex_);
+  thread_roles_[tid] = role;
+}
+
+void ProfilerMetricsLinux::RegisterCurrentThread(ThreadRole role) {
+  RegisterThread(static_cast<pid_t>(::syscall(SYS_gettid)), role);
+}
+
+ProfileSample ProfilerMetricsLinux::GenerateSample() {
+  ProfileSample sample;
+  SampleCpuUsage(&sample);
+  sample.memory_usage = MemoryUsage();
+  return sample;
+}
+
+void ProfilerMetricsLinux::SampleCpuUsage(ProfileSample* sample) {
+  std::optional<std::string> process_stat =
+      ReadProcFile(proc_self_path_ + "/stat");
+  std::optional<ProcStat> process =
+      process_stat ? ParseStat(*process_stat) : std::nullopt;
+  fml::UniqueFD task_directory =
+      fml::OpenDirectory((proc_self_path_ + "/task").c_str(), false,
+                         fml::FilePermission::kRead);
+  if (!process || !task_directory.is_valid() || clock_ticks_per_second_ <= 0) {
+    return;
+  }
+
+  std::unordered_map<pid_t, ThreadRole> thread_roles;
+  {
+    std::scoped_lock lock(thread_roles_mutex_);
+    thread_roles = thread_roles_;
+  }
+
+  const fml::TimePoint now = fml::TimePoint::Now();
+  const double elapsed_ticks =
+      last_sample_time_
+          ? (now - *last_sample_time_).ToSecondsF() * clock_ticks_per_second_
+          : 0.0;
+  ThreadCpuUsageInfo thread_cpu_usage = {};
+  std::unordered_map<pid_t, uint64_t> thread_ticks;
+  fml::VisitFiles(task_directory, [&](const fml::UniqueFD& directory,
+                                      const std::string& filename) {
+    char* filename_end = nullptr;
+    pid_t tid =
+        static_cast<pid_t>(std::strtol(filename.c_str(), &filename_end, 10));
+    if (filename_end == filename.c_str() || *filename_end != '\0') {
+      return true;
+    }
+    // The thread may have exited since the directory was listed.
+    std::optional<std::string> stat =
+        ReadProcFile(proc_self_path_ + "/task/" + filename + "/stat");
+    std::optional<ProcStat> thread = stat ? ParseStat(*stat) : std::nullopt;
+    if (!thread) {
+      return true;
+    }
+    thread_ticks[tid] = thread->cpu_ticks;
+    if (elapsed_ticks <= 0.0) {
+      return true;
+    }
+    // Threads that started after the last sample used all of their CPU time
+    // since then.
+    auto last_ticks = last_thread_ticks_.find(tid);
+    uint64_t since_ticks =
+        last_ticks == last_thread_ticks_.end() ? 0u : last_ticks->second;
+    if (thread->cpu_ticks >= since_ticks) {
+      *GetRoleCpuUsage(thread_cpu_usage,
+                       GetThreadRole(thread_roles, tid, thread->name)) +=
+          (thread->cpu_ticks - since_ticks) * 100.0 / elapsed_ticks;
+    }
+    return true;
+  });
+
+  if (elapsed_ticks > 0.0 && process->cpu_ticks >= last_process_ticks_) {
+    // The process ticks also include the threads that exited since the last
+    // sample, which the per thread ticks miss.
+    sample->cpu_usage = CpuUsageInfo{
+        .num_threads = static_cast<uint32_t>(thread_ticks.size()),
+        .total_cpu_usage = (process->cpu_ticks - last_process_ticks_) *
+                           100.0 / (elapsed_ticks * num_cpus_),
+    };
+    sample->thread_cpu_usage = thread_cpu_usage;
+  }
+  last_sample_time_ = now;
+  last_process_ticks_ = process->cpu_ticks;
+  last_thread_ticks_ = std::move(thread_ticks);
+}
+
+std::optional<MemoryUsageInfo> ProfilerMetricsLinux::MemoryUsage() {
+  if (std::optional<std::string> smaps_rollup =
+          ReadProcFile(proc_self_path_ + "/smaps_rollup")) {
+    std::unordered_map<std::string, double> fields =
+        ParseKilobyteFields(*smaps_rollup);
+    auto rss = fields.find("Rss");
+    auto pss = fields.find("Pss");
+    if (rss != fields.end() && pss != fields.end()) {
+      double dirty = fields["Private_Dirty"] + fields["Shared_Dirty"];
+      return MemoryUsageInfo{
+          .dirty_memory_usage = dirty / kKilobytesPerMegabyte,
+          .owned_shared_memory_usage =
+              (rss->second - dirty) / kKilobytesPerMegabyte,
+          .resident_memory_usage = rss->second / kKilobytesPerMegabyte,
+          .proportional_memory_usage = pss->second / kKilobytesPerMegabyte,
+      };
+    }
+  }
+
+  // statm reports the size, resident and shared memory of the process in
+  // pages. It has no dirty page count, the closest are the anonymous pages.
+  std::optional<std::string> statm = ReadProcFile(proc_self_path_ + "/statm");
+  if (!statm) {
+    return std::nullopt;
+  }
+  std::istringstream fields(*statm);
+  uint64_t size = 0;
+  uint64_t resident = 0;
+  uint64_t shared = 0;
+  if (!(fields >> size >> resident >> shared) || shared > resident) {
+    return std::nullopt;
+  }
+  const double megabytes_per_page = ::sysconf(_SC_PAGESIZE) / kBytesPerMegabyte;
+  return MemoryUsageInfo{
+      .dirty_memory_usage = (resident - shared) * megabytes_per_page,
+      .owned_shared_memory_usage = shared * megabytes_per_page,
+      .resident_memory_usage = resident * megabytes_per_page,
+      .proportional_memory_usage = std::nullopt,
+  };
+}
+
+}  // namespace flutter
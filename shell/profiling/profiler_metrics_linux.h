@@ -0,0 +1,94 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_SHELL_PROFILING_PROFILER_METRICS_LINUX_H_
+#define FLUTTER_SHELL_PROFILING_PROFILER_METRICS_LINUX_H_
+
+#include <sys/types.h>
+
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+
+#include "flutter/fml/macros.h"
+#include "flutter/fml/time/time_point.h"
+#include "flutter/shell/profiling/sampling_profiler.h"
+
+namespace flutter {
+
+/**
+ * @brief Utility class that gathers profiling metrics used by
+ * `flutter::SamplingProfiler` from procfs on Linux and Android.
+ *
+ * CPU usage is the CPU time used between two consecutive samples, so the
+ * first sample only records a baseline and has no CPU usage. The CPU time of
+ * each thread is attributed to the role the thread was registered with, or to
+ * the worker threads if it has the name of a worker of the engine's
+ * concurrent message loop.
+ *
+ * Memory usage comes from `smaps_rollup`, which also reports the PSS of the
+ * process, and falls back to `statm` on kernels that do not have it. The
+ * kernel walks all the mappings of the process to report them, so the
+ * sampling rate should be kept to a few samples per second.
+ *
+ * @see flutter::SamplingProfiler
+ */
+class ProfilerMetricsLinux {
+ public:
+  enum class ThreadRole {
+    kPlatform,
+    kUI,
+    kRaster,
+    kIO,
+    kWorker,
+  };
+
+  /**
+   * @brief Construct a new ProfilerMetricsLinux object.
+   *
+   * @param proc_self_path the procfs directory of the process. Tests point
+   * this to a fake directory.
+   */
+  explicit ProfilerMetricsLinux(std::string proc_self_path = "/proc/self");
+
+  ~ProfilerMetricsLinux();
+
+  /**
+   * @brief Attributes the CPU time of the thread `tid` to `role` in the
+   * following samples. Can be called from any thread.
+   */
+  void RegisterThread(pid_t tid, ThreadRole role);
+
+  /**
+   * @brief Attributes the CPU time of the calling thread to `role`. This is
+   * meant to be posted to the task runners of the engine.
+   */
+  void RegisterCurrentThread(ThreadRole role);
+
+  ProfileSample GenerateSample();
+
+ private:
+  const std::string proc_self_path_;
+  const int64_t clock_ticks_per_second_;
+  const int64_t num_cpus_;
+  std::mutex thread_roles_mutex_;
+  std::unordered_map<pid_t, ThreadRole> thread_roles_;
+  // The CPU time in clock ticks of the process and of each of its threads
+  // when the last sample was generated.
+  std::optional<fml::TimePoint> last_sample_time_;
+  uint64_t last_process_ticks_ = 0;
+  std::unordered_map<pid_t, uint64_t> last_thread_ticks_;
+
+  void SampleCpuUsage(ProfileSample* sample);
+
+  std::optional<MemoryUsageInfo> MemoryUsage();
+
+  FML_DISALLOW_COPY_AND_ASSIGN(ProfilerMetricsLinux);
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_SHELL_PROFILING_PROFILER_METRICS_LINUX_H_
@@ -0,0 +1,160 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <string>
+#include <thread>
+
+#include "flutter/fml/file.h"
+#include "flutter/fml/mapping.h"
+#include "flutter/shell/profiling/profiler_metrics_linux.h"
+#include "flutter/testing/testing.h"
+
+namespace flutter {
+namespace testing {
+
+namespace {
+
+// A procfs directory of a process with three threads: one named after a
+// truncated engine thread name, a worker and a thread that does not belong to
+// the engine.
+class FakeProcSelf {
+ public:
+  FakeProcSelf() {
+    task_ = fml::CreateDirectory(directory_.fd(), {"task"},
+                                 fml::FilePermission::kReadWrite);
+    SetThreadTicks(0u, 0u, 0u);
+  }
+
+  const std::string& path() const { return directory_.path(); }
+
+  void SetThreadTicks(uint64_t raster_ticks,
+                      uint64_t worker_ticks,
+                      uint64_t other_ticks) {
+    WriteStat("101", "io.flutter.1.ra", raster_ticks);
+    WriteStat("102", "io.worker.1", worker_ticks);
+    WriteStat("103", "other (thread)", other_ticks);
+    WriteFile(directory_.fd(), "stat",
+              MakeStat("100", "flutter_tester",
+                       raster_ticks + worker_ticks + other_ticks));
+  }
+
+  void WriteFile(const fml::UniqueFD& directory,
+                 const char* name,
+                 const std::string& contents) {
+    ASSERT_TRUE(fml::WriteAtomically(directory, name,
+                                     fml::DataMapping(contents)));
+  }
+
+  void WriteProcFile(const char* name, const std::string& contents) {
+    WriteFile(directory_.fd(), name, contents);
+  }
+
+ private:
+  fml::ScopedTemporaryDirectory directory_;
+  fml::UniqueFD task_;
+
+  // The user and system time are the 14th and 15th fields of `stat`. The
+  // ticks are split evenly between the two.
+  static std::string MakeStat(const std::string& tid,
+                              const std::string& name,
+                              uint64_t ticks) {
+    return tid + " (" + name + ") S 1 100 100 0 -1 4194304 10 0 0 0 " +
+           std::to_string(ticks / 2) + " " + std::to_string(ticks - ticks / 2) +
+           " 0 0 20 0 3 0 100 0 0\n";
+  }
+
+  void WriteStat(const std::string& tid,
+                 const std::string& name,
+                 uint64_t ticks) {
+    fml::UniqueFD thread = fml::CreateDirectory(
+        task_, {tid}, fml::FilePermission::kReadWrite);
+    WriteFile(thread, "stat", MakeStat(tid, name, ticks));
+  }
+};
+
+}  // namespace
+
+TEST(ProfilerMetricsLinuxTest, AttributesThreadCpuTimeToRoles) {
+  FakeProcSelf proc_self;
+  ProfilerMetricsLinux metrics(proc_self.path());
+  metrics.RegisterThread(101, ProfilerMetricsLinux::ThreadRole::kRaster);
+
+  // The first sample only records the CPU time used so far.
+  ProfileSample first_sample = metrics.GenerateSample();
+  EXPECT_FALSE(first_sample.cpu_usage.has_value());
+  EXPECT_FALSE(first_sample.thread_cpu_usage.has_value());
+
+  proc_self.SetThreadTicks(10u, 4u, 0u);
+  std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  ProfileSample second_sample = metrics.GenerateSample();
+  ASSERT_TRUE(second_sample.cpu_usage.has_value());
+  EXPECT_EQ(second_sample.cpu_usage->num_threads, 3u);
+  EXPECT_GT(second_sample.cpu_usage->total_cpu_usage, 0.0);
+  ASSERT_TRUE(second_sample.thread_cpu_usage.has_value());
+  const ThreadCpuUsageInfo& usage = *second_sample.thread_cpu_usage;
+  EXPECT_GT(usage.raster_cpu_usage, usage.worker_cpu_usage);
+  EXPECT_GT(usage.worker_cpu_usage, 0.0);
+  EXPECT_EQ(usage.platform_cpu_usage, 0.0);
+  EXPECT_EQ(usage.ui_cpu_usage, 0.0);
+  EXPECT_EQ(usage.io_cpu_usage, 0.0);
+  EXPECT_EQ(usage.other_cpu_usage, 0.0);
+}
+
+TEST(ProfilerMetricsLinuxTest, ReadsMemoryUsageFromSmapsRollup) {
+  FakeProcSelf proc_self;
+  proc_self.WriteProcFile("smaps_rollup",
+                          "00400000-7ffd00000000 ---p 00000000 00:00 0 "
+                          "[rollup]\n"
+                          "Rss:              204800 kB\n"
+                          "Pss:              102400 kB\n"
+                          "Shared_Clean:      81920 kB\n"
+                          "Shared_Dirty:       1024 kB\n"
+                          "Private_Clean:     20480 kB\n"
+                          "Private_Dirty:    101376 kB\n");
+  proc_self.WriteProcFile("statm", "1000 10 5 1 0 5 0\n");
+  ProfilerMetricsLinux metrics(proc_self.path());
+
+  std::optional<MemoryUsageInfo> memory_usage =
+      metrics.GenerateSample().memory_usage;
+  ASSERT_TRUE(memory_usage.has_value());
+  EXPECT_DOUBLE_EQ(memory_usage->dirty_memory_usage, 100.0);
+  EXPECT_DOUBLE_EQ(memory_usage->owned_shared_memory_usage, 100.0);
+  EXPECT_EQ(memory_usage->resident_memory_usage, 200.0);
+  EXPECT_EQ(memory_usage->proportional_memory_usage, 100.0);
+}
+
+TEST(ProfilerMetricsLinuxTest, FallsBackToStatmWithoutSmapsRollup) {
+  FakeProcSelf proc_self;
+  proc_self.WriteProcFile("statm", "1000 300 100 1 0 200 0\n");
+  ProfilerMetricsLinux metrics(proc_self.path());
+
+  std::optional<MemoryUsageInfo> memory_usage =
+      metrics.GenerateSample().memory_usage;
+  ASSERT_TRUE(memory_usage.has_value());
+  EXPECT_GT(memory_usage->dirty_memory_usage,
+            memory_usage->owned_shared_memory_usage);
+  ASSERT_TRUE(memory_usage->resident_memory_usage.has_value());
+  EXPECT_DOUBLE_EQ(*memory_usage->resident_memory_usage,
+                   memory_usage->dirty_memory_usage +
+                       memory_usage->owned_shared_memory_usage);
+  EXPECT_FALSE(memory_usage->proportional_memory_usage.has_value());
+}
+
+TEST(ProfilerMetricsLinuxTest, SamplesCurrentProcess) {
+  ProfilerMetricsLinux metrics;
+  metrics.RegisterCurrentThread(ProfilerMetricsLinux::ThreadRole::kUI);
+  metrics.GenerateSample();
+  std::this_thread::sleep_for(std::chrono::milliseconds(10));
+
+  ProfileSample sample = metrics.GenerateSample();
+  ASSERT_TRUE(sample.cpu_usage.has_value());
+  EXPECT_GE(sample.cpu_usage->num_threads, 1u);
+  ASSERT_TRUE(sample.thread_cpu_usage.has_value());
+  ASSERT_TRUE(sample.memory_usage.has_value());
+  ASSERT_TRUE(sample.memory_usage->resident_memory_usage.has_value());
+  EXPECT_GT(*sample.memory_usage->resident_memory_usage, 0.0);
+}
+
+}  // namespace testing
+}  // namespace flutter
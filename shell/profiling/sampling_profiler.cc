@@ -63,6 +63,18 @@ void SamplingProfiler::SampleRepeatedly(fml::TimeDelta task_delay) const {
                                "total_cpu_usage", total_cpu_usage.c_str(),
                                "num_threads", num_threads.c_str());
         }
+        if (usage.thread_cpu_usage) {
+          const ThreadCpuUsageInfo& thread_cpu_usage = *usage.thread_cpu_usage;
+          FML_TRACE_COUNTER(
+              "flutter::profiling", "ThreadCpuUsage",
+              reinterpret_cast<int64_t>(profiler),              //
+              "platform", thread_cpu_usage.platform_cpu_usage,  //
+              "ui", thread_cpu_usage.ui_cpu_usage,              //
+              "raster", thread_cpu_usage.raster_cpu_usage,      //
+              "io", thread_cpu_usage.io_cpu_usage,              //
+              "worker", thread_cpu_usage.worker_cpu_usage,      //
+              "other", thread_cpu_usage.other_cpu_usage);
+        }
         if (usage.memory_usage) {
           std::string dirty_memory_usage =
               std::to_string(usage.memory_usage->dirty_memory_usage);
@@ -72,6 +84,22 @@ void SamplingProfiler::SampleRepeatedly(fml::TimeDelta task_delay) const {
                                "dirty_memory_usage", dirty_memory_usage.c_str(),
                                "owned_shared_memory_usage",
                                owned_shared_memory_usage.c_str());
+          const MemoryUsageInfo& memory_usage = *usage.memory_usage;
+          if (memory_usage.resident_memory_usage &&
+              memory_usage.proportional_memory_usage) {
+            FML_TRACE_COUNTER(
+                "flutter::profiling", "ResidentMemoryUsage",
+                reinterpret_cast<int64_t>(profiler),             //
+                "rss", *memory_usage.resident_memory_usage,      //
+                "pss", *memory_usage.proportional_memory_usage,  //
+                "dirty", memory_usage.dirty_memory_usage);
+          } else if (memory_usage.resident_memory_usage) {
+            FML_TRACE_COUNTER(
+                "flutter::profiling", "ResidentMemoryUsage",
+                reinterpret_cast<int64_t>(profiler),         //
+                "rss", *memory_usage.resident_memory_usage,  //
+                "dirty", memory_usage.dirty_memory_usage);
+          }
         }
         if (usage.gpu_usage) {
           std::string gpu_usage =
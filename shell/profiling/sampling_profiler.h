@@ -30,17 +30,39 @@ struct CpuUsageInfo {
   double total_cpu_usage;
 };
 
+/**
+ * @brief CPU usage of the threads of the engine. Unlike `total_cpu_usage`,
+ * each value is the percentage of a single core used by the thread, such that a
+ * thread that is never idle reports `100` regardless of the number of cores.
+ * `worker_cpu_usage` is the sum over all of the worker threads of the engine,
+ * and `other_cpu_usage` the sum over all the threads of the process that do not
+ * belong to the engine.
+ */
+struct ThreadCpuUsageInfo {
+  double platform_cpu_usage;
+  double ui_cpu_usage;
+  double raster_cpu_usage;
+  double io_cpu_usage;
+  double worker_cpu_usage;
+  double other_cpu_usage;
+};
+
 /**
  * @brief Memory usage stats. `dirty_memory_usage` is the memory usage (in
  * MB) such that the app uses its physical memory for dirty memory. Dirty memory
  * is the memory data that cannot be paged to disk. `owned_shared_memory_usage`
  * is the memory usage (in MB) such that the app uses its physical memory for
  * shared memory, including loaded frameworks and executables. On iOS, it's
- * `physical memory - dirty memory`.
+ * `physical memory - dirty memory`. `resident_memory_usage` (RSS) and
+ * `proportional_memory_usage` (PSS) are the physical memory of the app and
+ * its share of the physical memory shared with other processes (in MB), on
+ * the platforms that report them.
  */
 struct MemoryUsageInfo {
   double dirty_memory_usage;
   double owned_shared_memory_usage;
+  std::optional<double> resident_memory_usage;
+  std::optional<double> proportional_memory_usage;
 };
 
 /**
@@ -59,6 +81,7 @@ struct GpuUsageInfo {
  */
 struct ProfileSample {
   std::optional<CpuUsageInfo> cpu_usage;
+  std::optional<ThreadCpuUsageInfo> thread_cpu_usage;
   std::optional<MemoryUsageInfo> memory_usage;
   std::optional<GpuUsageInfo> gpu_usage;
 };
@@ -577,6 +577,89 @@ void main() async {
     expect(data.buffer.asUint8List(), equals(dataSync.buffer.asUint8List()));
   });
 
+  test('CanvasCommandBatch draws the same pixels as direct canvas calls', () async {
+    final Image image = await createImage(4, 4);
+    final PictureRecorder pictureRecorder = PictureRecorder();
+    Canvas(pictureRecorder).drawCircle(const Offset(5, 5), 5, Paint()..color = const Color(0xFF00FF00));
+    final Picture picture = pictureRecorder.endRecording();
+    final Path path = Path()..addOval(const Rect.fromLTWH(40, 40, 20, 10));
+    final Paint paint = Paint()..color = const Color(0xFF2196F3);
+
+    void drawDirect(Canvas canvas) {
+      canvas.save();
+      canvas.translate(5, 5);
+      canvas.scale(1.5);
+      canvas.clipRect(const Rect.fromLTWH(0, 0, 60, 60));
+      canvas.drawRect(const Rect.fromLTWH(10, 10, 20, 20), paint);
+      paint.color = const Color(0xFFFF5722);
+      canvas.drawCircle(const Offset(30, 30), 8, paint);
+      canvas.drawPath(path, paint);
+      canvas.drawImage(image, const Offset(2, 40), paint);
+      canvas.drawPicture(picture);
+      canvas.restore();
+      paint.color = const Color(0xFF2196F3);
+    }
+
+    void drawBatched(Canvas canvas) {
+      final CanvasCommandBatch batch = CanvasCommandBatch();
+      batch.save();
+      batch.translate(5, 5);
+      batch.scale(1.5);
+      batch.clipRect(const Rect.fromLTWH(0, 0, 60, 60));
+      batch.drawRect(const Rect.fromLTWH(10, 10, 20, 20), paint);
+      paint.color = const Color(0xFFFF5722);
+      batch.drawCircle(const Offset(30, 30), 8, paint);
+      batch.drawPath(path, paint);
+      batch.drawImage(image, const Offset(2, 40), paint);
+      batch.drawPicture(picture);
+      batch.restore();
+      paint.color = const Color(0xFF2196F3);
+      expect(batch.isEmpty, false);
+      batch.drawInto(canvas);
+    }
+
+    final Image direct = await toImage(drawDirect, 100, 100);
+    final Image batched = await toImage(drawBatched, 100, 100);
+    final ByteData directData = (await direct.toByteData())!;
+    final ByteData batchedData = (await batched.toByteData())!;
+    expect(batchedData.buffer.asUint8List(), equals(directData.buffer.asUint8List()));
+  });
+
+  test('CanvasCommandBatch can be drawn again until it is cleared', () async {
+    final CanvasCommandBatch batch = CanvasCommandBatch();
+    expect(batch.isEmpty, true);
+    batch.drawPaint(Paint()..color = const Color(0xFFFF0000));
+
+    final Image first = await toImage(batch.drawInto, 1, 1);
+    final Image second = await toImage(batch.drawInto, 1, 1);
+    expect((await first.toByteData())!.getUint32(0), 0xFF0000FF);
+    expect((await second.toByteData())!.getUint32(0), 0xFF0000FF);
+
+    batch.clear();
+    expect(batch.isEmpty, true);
+    final Image cleared = await toImage(batch.drawInto, 1, 1);
+    expect((await cleared.toByteData())!.getUint32(0), 0);
+  });
+
+  test('CanvasCommandBatch only reuses a paint while it is unchanged', () async {
+    final CanvasCommandBatch batch = CanvasCommandBatch();
+    final Paint paint = Paint()..color = const Color(0xFFFF0000);
+    batch.drawRect(const Rect.fromLTWH(0, 0, 1, 1), paint);
+    batch.drawRect(const Rect.fromLTWH(1, 0, 1, 1), Paint()..color = const Color(0xFFFF0000));
+    paint.color = const Color(0xFF00FF00);
+    batch.drawRect(const Rect.fromLTWH(2, 0, 1, 1), paint);
+
+    final ByteData data = (await (await toImage(batch.drawInto, 3, 1)).toByteData())!;
+    expect(data.getUint32(0), 0xFF0000FF);
+    expect(data.getUint32(4), 0xFF0000FF);
+    expect(data.getUint32(8), 0x00FF00FF);
+
+    batch.clear();
+    batch.drawPaint(paint);
+    final ByteData cleared = (await (await toImage(batch.drawInto, 1, 1)).toByteData())!;
+    expect(cleared.getUint32(0), 0x00FF00FF);
+  });
+
   test('Canvas.drawParagraph throws when Paragraph.layout was not called',
       () async {
     // Regression test for https://github.com/flutter/flutter/issues/97172